@@ -0,0 +1,76 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Memory allocator policies used by arrays and memory buffers
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class Allocator
+{
+public:
+
+	virtual ~Allocator() {}
+
+	// Allocates the specified number of bytes
+	virtual void* Allocate (uint bytes, uint alignment = 16)=0;
+
+	// Returns memory previously obtained from Allocate(). 'bytes' must match the size that was requested.
+	virtual void Free (void* ptr, uint bytes)=0;
+};
+
+//============================================================================================================
+// Pool allocator: hands out fixed-size chunks from large blocks, recycling freed chunks.
+// Requests larger than the chunk size fall through to the heap. Thread-safe.
+//============================================================================================================
+
+class Pool : public Allocator
+{
+private:
+
+	struct Chunk { Chunk* mNext; };
+	struct Block { Block* mNext; };
+
+	Block*				mBlocks;		// Linked list of allocated blocks
+	Chunk*				mFree;			// Linked list of available chunks
+	uint				mChunkSize;		// Size of each chunk, in bytes
+	uint				mChunksPerBlock;// Number of chunks allocated at once
+	uint				mAlignment;		// Alignment of every chunk, such as 64 for cache line alignment
+	uint				mUsed;			// Number of chunks currently in use
+	uint				mCapacity;		// Total number of allocated chunks
+	uint				mAllocations;	// Total number of allocation calls served by the pool
+	mutable Thread::Lockable mLock;
+
+public:
+
+	Pool (uint chunkSize, uint chunksPerBlock = 64, uint alignment = 16);
+	virtual ~Pool() { Release(); }
+
+private:
+
+	// Pools can't be copied
+	Pool (const Pool&);
+	void operator = (const Pool&);
+
+public:
+
+	void Lock()		const { mLock.Lock();	}
+	void Unlock()	const { mLock.Unlock();	}
+
+	uint GetChunkSize()		const { return mChunkSize;		}
+	uint GetAlignment()		const { return mAlignment;		}
+	uint GetUsed()			const { return mUsed;			}
+	uint GetCapacity()		const { return mCapacity;		}
+	uint GetAllocations()	const { return mAllocations;	}
+
+	// Allocates a chunk of memory (or falls back to the heap if the request doesn't fit into one)
+	virtual void* Allocate (uint bytes, uint alignment = 16);
+
+	// Returns the memory back to the pool
+	virtual void Free (void* ptr, uint bytes);
+
+	// Releases all blocks. Any memory handed out by the pool becomes invalid.
+	void Release();
+};
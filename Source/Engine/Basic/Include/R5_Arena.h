@@ -0,0 +1,129 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Linear arena allocator -- memory is handed out sequentially and released all at once
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class Arena : public Allocator
+{
+public:
+
+	// Saved state of the arena, used to roll it back to an earlier point
+	struct Marker
+	{
+		void*	mBlock;
+		uint	mUsed;
+	};
+
+	// Rolls the arena back to where it was when the scope was created. Useful for threads
+	// that are not tied to the frame, such as resource loading threads.
+	class Scope
+	{
+		Arena&	mArena;
+		Marker	mMarker;
+
+	public:
+
+		Scope (Arena& arena) : mArena(arena), mMarker(arena.GetMarker()) { ++arena.mScopes; }
+		~Scope() { mArena.Rewind(mMarker); --mArena.mScopes; }
+	};
+
+private:
+
+	// Blocks are allocated with a header that's followed by the usable memory
+	struct Block
+	{
+		Block*	mNext;
+		uint	mSize;
+	};
+
+	Block*	mFirst;			// First allocated block
+	Block*	mCurrent;		// Block memory is currently being handed out from
+	uint	mUsed;			// Bytes used in the current block
+	uint	mBlockSize;		// Minimum size of newly allocated blocks
+	uint	mBytes;			// Bytes handed out since the last reset
+	uint	mAllocations;	// Number of allocation calls since the last reset
+	uint	mFrame;			// Frame the arena was last reset on -- used by FrameArena
+	uint	mScopes;		// Number of active scopes -- FrameArena won't reset the arena while there are any
+
+	friend class Scope;
+	friend class FrameArena;
+
+public:
+
+	Arena (uint blockSize = 65536);
+	virtual ~Arena() { Release(); }
+
+private:
+
+	// Arenas can't be copied
+	Arena (const Arena&);
+	void operator = (const Arena&);
+
+public:
+
+	uint GetBytes()			const { return mBytes;			}
+	uint GetAllocations()	const { return mAllocations;	}
+
+	// Total amount of memory allocated by the arena's blocks
+	uint GetCapacity() const;
+
+	// Allocates the specified number of bytes. The memory remains valid until the arena gets reset or rewound.
+	virtual void* Allocate (uint bytes, uint alignment = 16);
+
+	// Individual allocations are never freed -- the memory is reclaimed when the arena gets reset or rewound
+	virtual void Free (void* ptr, uint bytes) {}
+
+	// Convenience function: allocates memory for the specified number of elements (constructors are not called)
+	template <typename Type> Type* Allocate (uint count) { return (Type*)Allocate(count * sizeof(Type)); }
+
+	// Saves the current state of the arena
+	Marker GetMarker() const { Marker m = { mCurrent, mUsed }; return m; }
+
+	// Rolls the arena back to the specified state, invalidating everything allocated since then
+	void Rewind (const Marker& marker);
+
+	// Invalidates all allocations. If more than one block was needed, they get merged into one.
+	void Reset();
+
+	// Releases all memory used by the arena
+	void Release();
+};
+
+//============================================================================================================
+// Per-frame arena: each thread gets its own arena that gets reset in bulk at the end of every frame.
+// Anything allocated from it must not outlive the frame -- use Arena::Scope for longer-running threads.
+//============================================================================================================
+
+class FrameArena
+{
+public:
+
+	// Retrieves the calling thread's arena, resetting it first if a new frame has started since it was last used
+	static Arena& Get();
+
+	// Convenience function: allocates memory from the calling thread's arena
+	static void* Allocate (uint bytes, uint alignment = 16) { return Get().Allocate(bytes, alignment); }
+
+	// Returns the calling thread's arena to the pool so that it can be reused -- call before the thread exits
+	static void Detach();
+
+	// Marks the end of the frame, invalidating all memory handed out by every thread's arena. Called by the Core.
+	static void NextFrame();
+
+	// Current frame number
+	static uint GetFrame();
+
+	// Bytes allocated from all threads' arenas during the last complete frame
+	static uint GetBytes();
+
+	// Number of allocation calls made during the last complete frame
+	static uint GetAllocations();
+
+	// Highest number of bytes allocated within a single frame so far
+	static uint GetPeakBytes();
+};
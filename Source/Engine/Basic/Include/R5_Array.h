@@ -18,6 +18,11 @@ public:
 	Array()				: BASE() {}
 	Array(uint reserve)	: BASE(reserve) {}
 
+	// Arrays can take their memory from a custom allocator, such as a Pool or an Arena.
+	// Arena-based arrays leave their old buffer behind when they grow, so they are best
+	// suited for short-lived temporary data.
+	Array(Allocator& allocator) : BASE(allocator) {}
+
 	inline void Clear()
 	{
 		if (BASE::mArray != 0)
@@ -28,13 +33,7 @@ public:
 
 	inline void Release()
 	{
-		if (BASE::mArray != 0)
-		{
-			delete [] BASE::mArray;
-			BASE::mArray = 0;
-		}
-		BASE::mAllocated = 0;
-		BASE::mSize = 0;
+		BASE::_Release();
 	}
 
 	inline Type* ExpandTo(uint count, bool clearMemory = false)
@@ -43,6 +42,8 @@ public:
 
 		if (BASE::mSize < count)
 		{
+			BASE::_Construct(count);
+
 			if (clearMemory)
 			{
 				memset(BASE::mArray + BASE::mSize, 0, sizeof(Type) * (count - BASE::mSize));
@@ -145,7 +146,7 @@ public:
 			BASE::Expand();
 
 			// Run through all remaining entries, shifting them over by one
-			for (uint i = BASE::mSize; i > index; ) { --i; BASE::mArray[i + 1] = BASE::mArray[i]; }
+			for (uint i = BASE::mSize - 1; i > index; --i) BASE::mArray[i] = BASE::mArray[i - 1];
 
 			// Assign the value
 			BASE::mArray[index] = val;
@@ -8,6 +8,15 @@
 // Author: Michael Lyashenko
 //============================================================================================================
 
+// Whether entries can be moved to a new location with a plain memcpy when the array grows. Nearly
+// everything stored in R5's arrays can (Remove() and RemoveAt() rely on it as well), but types that
+// keep pointers into themselves can't -- specialize this template with 'Value = 0' for such types,
+// and they will be copy-constructed into the new buffer and destroyed in the old one instead.
+
+template <typename Type> struct IsRelocatable { enum { Value = 1 }; };
+
+//============================================================================================================
+
 namespace Unfinished
 {
 	template <typename Type>
@@ -15,21 +24,91 @@ namespace Unfinished
 	{
 	protected:
 
-		Type*	mArray;
-		uint	mSize;
-		uint	mAllocated;
+		Type*		mArray;
+		uint		mSize;
+		uint		mAllocated;
+		uint		mConstructed;	// Entries that have been constructed -- can exceed 'mSize' as cleared entries get reused
+		Allocator*	mAllocator;		// Allocator the memory comes from, if any (otherwise it's allocated on the heap)
 	
 	private:
 		mutable Thread::Lockable	mLock;
 
 	protected:
 
-		BaseArray()				: mArray(0), mSize(0), mAllocated(0) {}
-		BaseArray(uint reserve)	: mArray(0), mSize(0), mAllocated(0) { Reserve(reserve); }
+		BaseArray()						: mArray(0), mSize(0), mAllocated(0), mConstructed(0), mAllocator(0) {}
+		BaseArray(uint reserve)			: mArray(0), mSize(0), mAllocated(0), mConstructed(0), mAllocator(0) { Reserve(reserve); }
+		BaseArray(Allocator& allocator)	: mArray(0), mSize(0), mAllocated(0), mConstructed(0), mAllocator(&allocator) {}
+
+		// Allocates uninitialized memory for the specified number of entries
+		inline Type* _Allocate (uint count)
+		{
+			uint bytes = count * sizeof(Type);
+			return (Type*)((mAllocator == 0) ? ::operator new(bytes) : mAllocator->Allocate(bytes));
+		}
+
+		// Returns memory previously obtained from _Allocate()
+		inline void _Free (Type* ptr, uint count)
+		{
+			if (mAllocator == 0) ::operator delete(ptr);
+			else mAllocator->Free(ptr, count * sizeof(Type));
+		}
+
+		// Constructs all entries up to the specified count that haven't been constructed yet
+		inline void _Construct (uint count)
+		{
+			for (; mConstructed < count; ++mConstructed) new (mArray + mConstructed) Type;
+		}
+
+		// Destroys all constructed entries past the specified count
+		inline void _Destroy (uint count = 0)
+		{
+			while (mConstructed > count) mArray[--mConstructed].~Type();
+		}
+
+		// Moves all constructed entries into a newly allocated buffer of the specified size
+		void _Relocate (uint count)
+		{
+			Type* newArray = _Allocate(count);
+
+			if (mArray != 0)
+			{
+				if (IsRelocatable<Type>::Value)
+				{
+					memcpy(newArray, mArray, mConstructed * sizeof(Type));
+				}
+				else
+				{
+					for (uint i = 0; i < mConstructed; ++i)
+					{
+						new (newArray + i) Type(mArray[i]);
+						mArray[i].~Type();
+					}
+				}
+				_Free(mArray, mAllocated);
+			}
+			mArray = newArray;
+			mAllocated = count;
+		}
+
+		// Destroys all entries and releases the memory
+		void _Release()
+		{
+			if (mArray != 0)
+			{
+				_Destroy();
+				_Free(mArray, mAllocated);
+				mArray = 0;
+			}
+			mAllocated = 0;
+			mSize = 0;
+		}
 
 	public:
 	
-		virtual ~BaseArray() { if (mArray != 0) { delete [] mArray; mArray = 0; } }
+		virtual ~BaseArray() { _Release(); }
+
+		// Allocator the array's memory comes from, or '0' if it's allocated on the heap
+		inline Allocator*		GetAllocator()		const	{ return mAllocator;	}
 
 		inline void				Lock()				const	{ mLock.Lock();			}
 		inline void				Unlock()			const	{ mLock.Unlock();		}
@@ -73,36 +152,44 @@ namespace Unfinished
 		inline Type& Expand()
 		{
 			if (mSize == mAllocated) Reserve(mSize + 8);
+			if (mSize == mConstructed) new (mArray + mConstructed++) Type;
 			return mArray[mSize++];
 		}
 
+		// Makes sure that the array can hold at least the specified number of entries, growing geometrically
 		void Reserve (uint count)
 		{
 			if (count > mAllocated)
 			{
-				mAllocated = ((mAllocated << 1) > count) ? (mAllocated << 1) : count;
-				if (mAllocated < 8) mAllocated = 8;
-				
-				if (mArray == 0)
-				{
-					mArray = new Type[mAllocated];
-				}
-				else
-				{
-					Type* newArray = new Type[mAllocated];
-					uint current = mSize * sizeof(Type);
-					memcpy(newArray, mArray, current);
-					memset(mArray, 0, current);
-					delete [] mArray;
-					mArray = newArray;
-				}
+				uint size = ((mAllocated << 1) > count) ? (mAllocated << 1) : count;
+				_Relocate(size < 8 ? 8 : size);
+			}
+		}
+
+		// Makes sure that the array can hold at least the specified number of entries without over-allocating
+		void ReserveExact (uint count)
+		{
+			if (count > mAllocated) _Relocate(count);
+		}
+
+		// Destroys unused entries and reallocates the array so that it's no larger than it needs to be
+		void ShrinkToFit()
+		{
+			_Destroy(mSize);
+
+			if (mSize == 0)
+			{
+				_Release();
+			}
+			else if (mSize < mAllocated)
+			{
+				_Relocate(mSize);
 			}
 		}
 
 		BaseArray& operator << (const Type& in)
 		{
-			if (mSize == mAllocated) Reserve(mSize + 8);
-			mArray[mSize++] = in;
+			Expand() = in;
 			return *this;
 		}
 
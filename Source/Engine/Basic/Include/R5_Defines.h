@@ -22,6 +22,10 @@
 	#define R5_THREAD_FUNCTION(name, ptr)	ulong __stdcall name(void* ptr)
 	#endif
 
+	#ifndef R5_THREAD_LOCAL
+	#define R5_THREAD_LOCAL __declspec(thread)
+	#endif
+
 	#ifndef int32
 	#define int32 __int32
 	#endif
@@ -54,6 +58,10 @@
 	#define R5_THREAD_FUNCTION(name, ptr)	void* name(void* ptr)
 	#endif
 
+	#ifndef R5_THREAD_LOCAL
+	#define R5_THREAD_LOCAL __thread
+	#endif
+
 	#ifndef int32
 	#define int32 __int32_t
 	#endif
@@ -75,6 +83,16 @@ namespace R5
 #define FOREACH(var, array) for (uint var = 0; var < array.GetSize(); ++var)
 #endif
 
+// SIMD instruction set used by performance-critical code: SSE2 on x86 or NEON on ARM.
+// Define R5_NO_SIMD to use the scalar code everywhere.
+#if !defined(R5_NO_SIMD) && !defined(R5_SSE) && !defined(R5_NEON)
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define R5_SSE
+	#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define R5_NEON
+	#endif
+#endif
+
 #ifndef _R5_MATH_DEFINES
 #define _R5_MATH_DEFINES
 
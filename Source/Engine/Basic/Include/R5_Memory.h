@@ -15,13 +15,23 @@ protected:
 	byte*				mBuffer;	// Allocated memory buffer
 	uint				mAllocated;	// Actual amount of memory allocated
 	uint				mSize;		// Memory that's actually "used" by the buffer
+	Allocator*			mAllocator;	// Allocator the memory comes from, if any (otherwise it's allocated on the heap)
 	Thread::Lockable	mLock;
 
 public:
 
-	Memory() : mBuffer(0), mAllocated(0), mSize(0) {}
-	Memory(uint size) : mBuffer(0), mAllocated(0), mSize(0) { Resize(size); mSize = 0; }
-	~Memory() { if (mBuffer != 0) delete [] mBuffer; }
+	Memory() : mBuffer(0), mAllocated(0), mSize(0), mAllocator(0) {}
+	Memory(uint size) : mBuffer(0), mAllocated(0), mSize(0), mAllocator(0) { Resize(size); mSize = 0; }
+	Memory(Allocator& alloc) : mBuffer(0), mAllocated(0), mSize(0), mAllocator(&alloc) {}
+	~Memory() { Release(); }
+
+private:
+
+	// Allocates a new buffer either on the heap or using the allocator
+	byte* _Allocate (uint size);
+
+	// Releases a buffer previously created by _Allocate()
+	void _Free (byte* buffer, uint size);
 
 public:
 
@@ -38,6 +48,7 @@ public:
 	bool		IsValid()		const	{ return mSize != 0;	}
 	uint		GetSize()		const	{ return mSize;			}
 	uint		GetAllocated()	const	{ return mAllocated;	}
+	Allocator*	GetAllocator()	const	{ return mAllocator;	}
 	void		Clear()					{ mSize = 0;			}
 
 	// Always useful to have
@@ -36,14 +36,8 @@ public:
 
 	void Release()
 	{
-		if (BASE::mArray != 0)
-		{
-			Clear();
-			delete [] BASE::mArray;
-			BASE::mArray = 0;
-		}
-
-		BASE::mAllocated = 0;
+		Clear();
+		BASE::_Release();
 	}
 
 	void ExpandTo(uint count)
@@ -51,6 +45,7 @@ public:
 		BASE::Reserve(count);
 		if (BASE::mSize < count)
 		{
+			BASE::_Construct(count);
 			memset(BASE::mArray + BASE::mSize, 0, (count - BASE::mSize) * sizeof(Type*));
 			BASE::mSize = count;
 		}
@@ -95,11 +90,8 @@ public:
 
 		if (in.IsValid())
 		{
-			if ( (BASE::mSize = in.GetSize()) > BASE::mAllocated )
-			{
-				if (BASE::mArray != 0) delete [] BASE::mArray;
-				BASE::mArray = new Type*[BASE::mAllocated = BASE::mSize];
-			}
+			BASE::ReserveExact(in.GetSize());
+			BASE::_Construct(BASE::mSize = in.GetSize());
 
 			uint memory = BASE::mSize * sizeof(Type*);
 			memcpy(BASE::mArray, in.BASE::mArray, memory);
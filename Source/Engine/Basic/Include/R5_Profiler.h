@@ -0,0 +1,129 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Hierarchical scoped CPU profiler. Every thread records completed zones into its own ring buffer that
+// gets drained once per frame by Profiler::NextFrame(), which is called by the Core. Zones are added
+// using the R5_PROFILE macro and cost a single branch until the profiler gets enabled at run time.
+// Defining R5_NO_PROFILER removes all zones at compile time.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+#ifndef R5_NO_PROFILER
+	#define R5_PROFILE_JOIN2(a, b)	a##b
+	#define R5_PROFILE_JOIN(a, b)	R5_PROFILE_JOIN2(a, b)
+	#define R5_PROFILE(name)		R5::Profiler::Scope R5_PROFILE_JOIN(_profilerScope, __LINE__) (name)
+#else
+	#define R5_PROFILE(name)
+#endif
+
+//============================================================================================================
+
+class Profiler
+{
+public:
+
+	typedef unsigned long long Ticks;
+
+	// Completed zone, as recorded by the thread that executed it
+	struct Event
+	{
+		const char*	mName;		// Name of the zone -- expected to be a string literal
+		Ticks		mStart;		// Timestamp of when the zone was entered
+		Ticks		mEnd;		// Timestamp of when the zone was exited
+		uint		mDepth;		// Nesting depth of the zone within its thread
+	};
+
+	// Statistics gathered for each zone
+	struct ZoneStats
+	{
+		const char*	mName;		// Name of the zone
+		uint		mCalls;		// Number of times the zone was entered during the last frame
+		float		mTime;		// Total time spent in the zone during the last frame, in milliseconds
+		float		mSelf;		// Same as above, minus time spent in nested zones
+		float		mAverage;	// Smoothed time spent in the zone per frame, in milliseconds
+		float		mPeak;		// Highest time spent in the zone within a single frame, in milliseconds
+	};
+
+	// Records the zone it was created in
+	class Scope
+	{
+		const char*	mName;
+		Ticks		mStart;
+		bool		mActive;
+
+	public:
+
+		Scope (const char* name) : mActive(IsEnabled())
+		{
+			if (mActive)
+			{
+				mName	= name;
+				mStart	= _Enter();
+			}
+		}
+
+		~Scope() { if (mActive) _Exit(mName, mStart); }
+	};
+
+private:
+
+	static bool mEnabled;
+
+	// Called by the Scope class
+	static Ticks _Enter();
+	static void  _Exit (const char* name, Ticks start);
+
+public:
+
+	// Current timestamp in CPU ticks
+	static inline Ticks GetTicks()
+	{
+#if defined(_MSC_VER)
+		return __rdtsc();
+#elif defined(__i386__) || defined(__x86_64__)
+		return __builtin_ia32_rdtsc();
+#else
+		return (Ticks)(Time::GetSystemSeconds() * 1000000000.0);
+#endif
+	}
+
+	// Number of ticks per second, calibrated when the profiler is first enabled and refined over time
+	static double GetTicksPerSecond();
+
+	// Whether zones are currently being recorded
+	static bool IsEnabled() { return mEnabled; }
+	static void SetEnabled (bool val);
+
+	// Sets the name of the calling thread, used by the trace export
+	static void SetThreadName (const char* name);
+
+	// Returns the calling thread's ring buffer to the pool so that it can be reused -- call before the thread exits
+	static void Detach();
+
+	// Marks the end of the frame: collects the zones recorded by all threads and updates the statistics
+	static void NextFrame();
+
+	// Time between the last two calls to NextFrame(), in milliseconds
+	static float GetFrameTime();
+
+	// Number of zones that could not be recorded because a thread's ring buffer was full
+	static uint GetDroppedEvents();
+
+	// Retrieves up to 'count' zones that took the most time during the last frame, sorted by time
+	static uint GetTopZones (ZoneStats* zones, uint count, bool selfTime = false);
+
+	// Retrieves the statistics of all zones seen so far, in the order they were first seen
+	static void GetAllZones (Array<ZoneStats>& zones);
+
+	// Starts capturing zones for the trace export. Zones past the specified limit are not captured.
+	static void StartCapture (uint maxEvents = 1048576);
+
+	// Stops capturing zones and saves them out in the Chrome trace format ("chrome://tracing")
+	static bool StopCapture (const String& filename);
+
+	// Whether zones are currently being captured
+	static bool IsCapturing();
+};
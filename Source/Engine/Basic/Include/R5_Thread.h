@@ -32,6 +32,18 @@ namespace Thread
 
 	IDType	GetID();
 
+	// Number of logical processors available on this system
+	uint	GetNumberOfCores();
+
+	// Callback executed by ParallelFor for every index in the range
+	typedef FastDelegate<void (uint index)> IndexDelegate;
+
+	// Executes the callback for every index in the 0 to 'count' range, splitting the work between the calling
+	// thread and up to 'maxThreads' worker threads (0 means one per core). Returns when all are done.
+	// Worker threads are shared, created as needed and kept waiting for work. If they are already busy with
+	// another call (including a nested one), the calling thread executes the callback for all indices itself.
+	void	ParallelFor (uint count, const IndexDelegate& callback, uint maxThreads = 0);
+
 #ifdef _LINUX
 	class Lockable
 	{
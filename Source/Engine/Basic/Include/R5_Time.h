@@ -14,5 +14,6 @@ namespace Time
 	double	GetSeconds();		// Precise timestamp in seconds
 	ulong	GetMilliseconds();	// Timestamp in milliseconds
 	ulong	GetDeltaMS();		// Milliseconds since the last update
+	double	GetSystemSeconds();	// High-resolution timestamp in seconds, queried directly from the system
 	uint	GetFPS();			// Current framerate
 };
\ No newline at end of file
@@ -0,0 +1,246 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Hierarchical timing wheel -- schedules values to come due on a specific tick (usually a millisecond).
+// Adding and cancelling entries is O(1), and advancing the wheel only visits the slots that come due
+// rather than every scheduled entry.
+//------------------------------------------------------------------------------------------------------------
+// There are 4 levels of 64 slots. Slots of the first level are one tick apart, and each following level's
+// slots span 64 times more ticks than the previous level's. Entries are placed on the lowest level that can
+// tell them apart from the current tick, and get redistributed onto the lower levels as their slot comes up.
+// Entries further away than the wheel can cover (2^24 ticks, ~4.6 hours in milliseconds) are parked in the
+// last slot of the top level that will come up, and get placed again once it does.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+template <typename Type>
+class TimingWheel
+{
+public:
+
+	// Handles identify scheduled entries and remain unique after the entry has come due or has been
+	// cancelled, so keeping an old handle around is safe. Zero is never a valid handle.
+	typedef uint Handle;
+
+private:
+
+	enum
+	{
+		Bits		= 6,
+		Slots		= 1 << Bits,
+		Mask		= Slots - 1,
+		Levels		= 4,
+		IndexBits	= 22,						// Up to 4 million scheduled entries
+		IndexMask	= (1 << IndexBits) - 1,
+		SerialMask	= (1 << (32 - IndexBits)) - 1,
+	};
+
+	struct Entry
+	{
+		Type	mValue;
+		ulong	mTime;		// Tick the entry comes due on
+		uint	mPrev;		// Previous entry in the same slot
+		uint	mNext;		// Next entry in the same slot, or the next unused entry
+		uint	mSlot;		// Slot the entry is in, INVALID_VAL if the entry is unused
+		uint	mSerial;	// Changed every time the entry gets released, used to validate handles
+	};
+
+	Array<Entry>	mEntries;
+	uint			mHeads[Levels * Slots];	// First entry of every slot
+	uint			mCounts[Levels];		// Number of entries on every level
+	uint			mFree;					// First unused entry
+	uint			mSize;					// Number of scheduled entries
+	ulong			mTime;					// Current tick -- all scheduled entries come due after it
+
+public:
+
+	TimingWheel() : mSize(0), mTime(0) { _Reset(); }
+
+	uint	GetSize()	const	{ return mSize;			}
+	bool	IsEmpty()	const	{ return mSize == 0;	}
+	ulong	GetTime()	const	{ return mTime;			}
+
+	// Whether the handle refers to an entry that is still scheduled
+	bool IsValid (Handle handle) const
+	{
+		uint index = handle & IndexMask;
+		return handle != 0 && index < mEntries.GetSize() &&
+			mEntries[index].mSlot != INVALID_VAL &&
+			mEntries[index].mSerial == (handle >> IndexBits);
+	}
+
+	// Value of a scheduled entry
+	const Type& Get (Handle handle) const { return mEntries[handle & IndexMask].mValue; }
+
+	// Tick a scheduled entry comes due on
+	ulong GetTime (Handle handle) const { return mEntries[handle & IndexMask].mTime; }
+
+	// Schedules the value to come due on the specified tick. Ticks that have already passed are
+	// treated as the next one.
+	Handle Add (const Type& value, ulong time)
+	{
+		uint index = mFree;
+
+		if (index != INVALID_VAL)
+		{
+			mFree = mEntries[index].mNext;
+		}
+		else
+		{
+			index = mEntries.GetSize();
+			ASSERT(index <= IndexMask, "Too many entries scheduled on the timing wheel");
+			mEntries.Expand().mSerial = 1;
+		}
+
+		Entry& entry = mEntries[index];
+		entry.mValue = value;
+		entry.mTime	 = (time > mTime) ? time : mTime + 1;
+		_Link(index);
+		++mSize;
+		return (entry.mSerial << IndexBits) | index;
+	}
+
+	// Cancels a scheduled entry, returning whether it was still scheduled
+	bool Remove (Handle handle)
+	{
+		if (!IsValid(handle)) return false;
+		uint index = handle & IndexMask;
+		_Unlink(index);
+		_Free(index);
+		return true;
+	}
+
+	// Advances the wheel to the specified tick, appending the values of all entries that have come due
+	// to the specified array, in the order they came due. Their handles are no longer valid afterwards.
+	void Advance (ulong time, Array<Type>& due)
+	{
+		while (mTime < time)
+		{
+			if (mSize == 0)
+			{
+				mTime = time;
+				break;
+			}
+
+			// Skip straight to the end of the lowest levels' current revolution if they are empty
+			ulong end = mTime;
+
+			for (uint level = 0; level + 1 < Levels && mCounts[level] == 0; ++level)
+				end = mTime | (((ulong)1 << (Bits * (level + 1))) - 1);
+
+			if (end >= time)
+			{
+				mTime = time;
+				break;
+			}
+
+			mTime = end + 1;
+
+			// Entries of higher levels get redistributed when their slot comes up
+			if ((mTime & Mask) == 0) _Cascade(1);
+
+			// Everything in the first level's current slot is due on this very tick
+			for (uint index = mHeads[mTime & Mask]; index != INVALID_VAL; index = mHeads[mTime & Mask])
+			{
+				due.Expand() = mEntries[index].mValue;
+				_Unlink(index);
+				_Free(index);
+			}
+		}
+	}
+
+	// Cancels all scheduled entries
+	void Clear()
+	{
+		mEntries.Clear();
+		_Reset();
+	}
+
+	// Cancels all scheduled entries and releases the memory
+	void Release()
+	{
+		mEntries.Release();
+		_Reset();
+	}
+
+private:
+
+	// Marks all slots as empty
+	void _Reset()
+	{
+		for (uint i = 0; i < Levels * Slots; ++i) mHeads[i] = INVALID_VAL;
+		for (uint i = 0; i < Levels; ++i) mCounts[i] = 0;
+		mFree = INVALID_VAL;
+		mSize = 0;
+	}
+
+	// Places the entry into the appropriate slot
+	void _Link (uint index)
+	{
+		Entry& entry = mEntries[index];
+		uint level = Levels - 1;
+		uint slot;
+
+		if (((entry.mTime - mTime) >> (Bits * Levels)) != 0)
+		{
+			// Too far away -- park it in the slot of the top level that will come up last
+			slot = (uint)((mTime >> (Bits * level)) - 1) & Mask;
+		}
+		else
+		{
+			// Lowest level on which the entry's tick differs from the current one
+			ulong diff = entry.mTime ^ mTime;
+			for (level = 0; level + 1 < Levels && (diff >> (Bits * (level + 1))) != 0; ++level) {}
+			slot = (uint)(entry.mTime >> (Bits * level)) & Mask;
+		}
+
+		slot += level * Slots;
+		entry.mSlot = slot;
+		entry.mPrev = INVALID_VAL;
+		entry.mNext = mHeads[slot];
+		if (entry.mNext != INVALID_VAL) mEntries[entry.mNext].mPrev = index;
+		mHeads[slot] = index;
+		++mCounts[level];
+	}
+
+	// Removes the entry from its slot
+	void _Unlink (uint index)
+	{
+		Entry& entry = mEntries[index];
+		if (entry.mPrev != INVALID_VAL) mEntries[entry.mPrev].mNext = entry.mNext;
+		else mHeads[entry.mSlot] = entry.mNext;
+		if (entry.mNext != INVALID_VAL) mEntries[entry.mNext].mPrev = entry.mPrev;
+		--mCounts[entry.mSlot / Slots];
+	}
+
+	// Returns the entry to the list of unused entries, invalidating its handle
+	void _Free (uint index)
+	{
+		Entry& entry = mEntries[index];
+		entry.mSlot		= INVALID_VAL;
+		entry.mSerial	= (entry.mSerial == SerialMask) ? 1 : entry.mSerial + 1;
+		entry.mNext		= mFree;
+		mFree = index;
+		--mSize;
+	}
+
+	// Redistributes the entries of the specified level's current slot onto the lower levels
+	void _Cascade (uint level)
+	{
+		uint slot = (uint)(mTime >> (Bits * level)) & Mask;
+
+		// The level above needs to go first if this level has wrapped around
+		if (slot == 0 && level + 1 < Levels) _Cascade(level + 1);
+
+		slot += level * Slots;
+
+		for (uint index = mHeads[slot]; index != INVALID_VAL; index = mHeads[slot])
+		{
+			_Unlink(index);
+			_Link(index);
+		}
+	}
+};
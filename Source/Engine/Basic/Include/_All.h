@@ -16,6 +16,7 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <new>
 
 // Function delegate functionality by Jody Hagins -- see the header file for more information
 #include "../FastDelegate/FastDelegate.h"
@@ -35,6 +36,11 @@ using fastdelegate::bind;
 #include <errno.h>
 #endif
 
+// The profiler reads the CPU's timestamp counter directly
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 // Fluid Studios memory manager to test for possible memory leaks -- see the header file for more information
 #ifdef R5_MEMORY_TEST
 #include "../Memmgr/mmgr.h"
@@ -47,6 +53,8 @@ namespace R5
 	#include "R5_String.h"			// High performance string class
 	#include "R5_System.h"			// System-specific functions
 	#include "R5_Thread.h"			// Multithreading related functions
+	#include "R5_Allocator.h"		// Memory allocator policies used by arrays and memory buffers
+	#include "R5_Arena.h"			// Linear arena allocator and per-frame thread arenas
 	#include "R5_Memory.h"			// Basic memory buffer
 	#include "R5_BaseArray.h"		// Unfinished array template used by Array and PointerArray
 	#include "R5_Array.h"			// Highly optimized dynamic array template, std::vector replacement
@@ -55,11 +63,13 @@ namespace R5
 	#include "R5_LinkedList.h"		// Linked list template (FIFO)
 	#include "R5_Hash.h"			// uint-based hash template
 	#include "R5_PointerHash.h"		// Hash meant to store pointers -- automatically deletes them
+	#include "R5_TimingWheel.h"		// Hierarchical timing wheel, schedules values to come due at a later time
 	#include "R5_Keys.h"			// Key map
 	#include "R5_Bundle.h"			// Bundle is a collection of assets packed into a single file
 	#include "R5_Random.h"			// Cross-platform pseudo-random number generator
 	#include "R5_FileDialog.h"		// File dialog window (implemented natively on each system)
 	#include "R5_Compression.h"		// ZLIB and LZMA-based compression functionality
+	#include "R5_Profiler.h"		// Hierarchical scoped CPU profiler
 };
 
 #endif
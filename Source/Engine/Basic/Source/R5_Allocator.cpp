@@ -0,0 +1,115 @@
+#include "../Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Size of the header preceding the chunks of each block -- keeps the chunks 16-byte aligned
+//============================================================================================================
+
+#define BLOCK_HEADER 16
+
+//============================================================================================================
+
+Pool::Pool (uint chunkSize, uint chunksPerBlock, uint alignment) :
+	mBlocks			(0),
+	mFree			(0),
+	mChunksPerBlock	(chunksPerBlock < 1 ? 1 : chunksPerBlock),
+	mAlignment		(alignment < 16 ? 16 : alignment),
+	mUsed			(0),
+	mCapacity		(0),
+	mAllocations	(0)
+{
+	if (chunkSize < sizeof(Chunk)) chunkSize = sizeof(Chunk);
+	mChunkSize = (chunkSize + mAlignment - 1) & ~(mAlignment - 1);
+}
+
+//============================================================================================================
+// Allocates a chunk of memory (or falls back to the heap if the request doesn't fit into one)
+//============================================================================================================
+
+void* Pool::Allocate (uint bytes, uint alignment)
+{
+	// Chunks are always aligned to at least 16 bytes, so only the size matters
+	if (bytes > mChunkSize) return ::operator new(bytes);
+
+	Chunk* chunk;
+
+	mLock.Lock();
+	{
+		// Allocate a new block if there are no free chunks left
+		if (mFree == 0)
+		{
+			byte* buffer = new byte[BLOCK_HEADER + mAlignment + mChunkSize * mChunksPerBlock];
+
+			Block* block = (Block*)buffer;
+			block->mNext = mBlocks;
+			mBlocks = block;
+
+			// The first chunk starts at the first aligned address past the header
+			size_t mask = mAlignment - 1;
+			byte* first = (byte*)(((size_t)(buffer + BLOCK_HEADER) + mask) & ~mask);
+
+			// Add all of the block's chunks to the list of available chunks
+			for (uint i = mChunksPerBlock; i > 0; )
+			{
+				Chunk* ptr = (Chunk*)(first + mChunkSize * (--i));
+				ptr->mNext = mFree;
+				mFree = ptr;
+			}
+			mCapacity += mChunksPerBlock;
+		}
+
+		chunk = mFree;
+		mFree = chunk->mNext;
+		++mUsed;
+		++mAllocations;
+	}
+	mLock.Unlock();
+	return chunk;
+}
+
+//============================================================================================================
+// Returns the memory back to the pool
+//============================================================================================================
+
+void Pool::Free (void* ptr, uint bytes)
+{
+	if (ptr == 0) return;
+
+	if (bytes > mChunkSize)
+	{
+		::operator delete(ptr);
+	}
+	else
+	{
+		mLock.Lock();
+		{
+			Chunk* chunk = (Chunk*)ptr;
+			chunk->mNext = mFree;
+			mFree = chunk;
+			--mUsed;
+		}
+		mLock.Unlock();
+	}
+}
+
+//============================================================================================================
+// Releases all blocks. Any memory handed out by the pool becomes invalid.
+//============================================================================================================
+
+void Pool::Release()
+{
+	mLock.Lock();
+	{
+		while (mBlocks != 0)
+		{
+			Block* next = mBlocks->mNext;
+			delete [] (byte*)mBlocks;
+			mBlocks = next;
+		}
+
+		mFree		= 0;
+		mUsed		= 0;
+		mCapacity	= 0;
+	}
+	mLock.Unlock();
+}
@@ -0,0 +1,244 @@
+#include "../Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Size of the header preceding the usable memory of each block -- keeps the memory 16-byte aligned
+//============================================================================================================
+
+#define BLOCK_HEADER 16
+
+//============================================================================================================
+
+Arena::Arena (uint blockSize) :
+	mFirst			(0),
+	mCurrent		(0),
+	mUsed			(0),
+	mBlockSize		(blockSize < 1024 ? 1024 : blockSize),
+	mBytes			(0),
+	mAllocations	(0),
+	mFrame			(0),
+	mScopes			(0) {}
+
+//============================================================================================================
+// Total amount of memory allocated by the arena's blocks
+//============================================================================================================
+
+uint Arena::GetCapacity() const
+{
+	uint size = 0;
+	for (Block* block = mFirst; block != 0; block = block->mNext) size += block->mSize;
+	return size;
+}
+
+//============================================================================================================
+// Allocates the specified number of bytes
+//============================================================================================================
+
+void* Arena::Allocate (uint bytes, uint alignment)
+{
+	if (bytes == 0) return 0;
+
+	++mAllocations;
+	mBytes += bytes;
+
+	size_t mask = (alignment < 1 ? 1 : alignment) - 1;
+
+	for (;;)
+	{
+		if (mCurrent != 0)
+		{
+			byte* start	 = (byte*)mCurrent + BLOCK_HEADER;
+			byte* ptr	 = (byte*)(((size_t)(start + mUsed) + mask) & ~mask);
+			uint  offset = (uint)(ptr - start);
+
+			// The allocation fits into the current block
+			if (offset + bytes <= mCurrent->mSize)
+			{
+				mUsed = offset + bytes;
+				return ptr;
+			}
+
+			// Move on to the next block if there is one (blocks that are too small get skipped)
+			if (mCurrent->mNext != 0)
+			{
+				mCurrent = mCurrent->mNext;
+				mUsed = 0;
+				continue;
+			}
+		}
+
+		// Allocate a new block large enough to hold the requested memory
+		uint size = bytes + (uint)mask;
+		if (size < mBlockSize) size = mBlockSize;
+
+		Block* block = (Block*)(new byte[BLOCK_HEADER + size]);
+		block->mNext = 0;
+		block->mSize = size;
+
+		if (mCurrent != 0) mCurrent->mNext = block;
+		else mFirst = block;
+
+		mCurrent = block;
+		mUsed = 0;
+	}
+}
+
+//============================================================================================================
+// Rolls the arena back to the specified state, invalidating everything allocated since then
+//============================================================================================================
+
+void Arena::Rewind (const Marker& marker)
+{
+	if (marker.mBlock != 0)
+	{
+		mCurrent = (Block*)marker.mBlock;
+		mUsed	 = marker.mUsed;
+	}
+	else
+	{
+		mCurrent = mFirst;
+		mUsed	 = 0;
+	}
+}
+
+//============================================================================================================
+// Invalidates all allocations. If more than one block was needed, they get merged into one.
+//============================================================================================================
+
+void Arena::Reset()
+{
+	if (mFirst != 0 && mFirst->mNext != 0)
+	{
+		uint size = GetCapacity();
+		Release();
+
+		mFirst = (Block*)(new byte[BLOCK_HEADER + size]);
+		mFirst->mNext = 0;
+		mFirst->mSize = size;
+	}
+
+	mCurrent		= mFirst;
+	mUsed			= 0;
+	mBytes			= 0;
+	mAllocations	= 0;
+}
+
+//============================================================================================================
+// Releases all memory used by the arena
+//============================================================================================================
+
+void Arena::Release()
+{
+	while (mFirst != 0)
+	{
+		Block* next = mFirst->mNext;
+		delete [] (byte*)mFirst;
+		mFirst = next;
+	}
+
+	mCurrent		= 0;
+	mUsed			= 0;
+	mBytes			= 0;
+	mAllocations	= 0;
+}
+
+//============================================================================================================
+// Frame arena's shared state
+//============================================================================================================
+
+static R5_THREAD_LOCAL Arena*	g_threadArena	= 0;		// Arena used by the calling thread
+static Thread::Lockable			g_arenaLock;				// Lock protecting the two lists below
+static PointerArray<Arena>		g_arenas;					// All arenas created so far
+static Array<Arena*>			g_unusedArenas;				// Arenas detached from their threads
+static uint						g_arenaFrame		= 1;	// Current frame number
+static uint						g_arenaBytes		= 0;	// Bytes allocated during the last frame
+static uint						g_arenaAllocations	= 0;	// Allocation calls during the last frame
+static uint						g_arenaPeak			= 0;	// Highest number of bytes allocated within a frame
+
+//============================================================================================================
+// Retrieves the calling thread's arena, resetting it first if a new frame has started since it was last used
+//============================================================================================================
+
+Arena& FrameArena::Get()
+{
+	Arena* arena = g_threadArena;
+
+	if (arena == 0)
+	{
+		g_arenaLock.Lock();
+		{
+			if (g_unusedArenas.IsValid())
+			{
+				arena = g_unusedArenas.Back();
+				g_unusedArenas.Shrink();
+			}
+			else
+			{
+				arena = new Arena();
+				g_arenas.Expand() = arena;
+			}
+		}
+		g_arenaLock.Unlock();
+		g_threadArena = arena;
+	}
+
+	// Memory handed out during previous frames is no longer in use
+	if (arena->mFrame != g_arenaFrame && arena->mScopes == 0)
+	{
+		arena->Reset();
+		arena->mFrame = g_arenaFrame;
+	}
+	return *arena;
+}
+
+//============================================================================================================
+// Returns the calling thread's arena to the pool so that it can be reused
+//============================================================================================================
+
+void FrameArena::Detach()
+{
+	if (g_threadArena != 0)
+	{
+		g_arenaLock.Lock();
+		g_unusedArenas.Expand() = g_threadArena;
+		g_arenaLock.Unlock();
+		g_threadArena = 0;
+	}
+}
+
+//============================================================================================================
+// Marks the end of the frame. Arenas are reset lazily the next time their thread requests them.
+//============================================================================================================
+
+void FrameArena::NextFrame()
+{
+	uint bytes = 0, allocations = 0;
+
+	g_arenaLock.Lock();
+	{
+		FOREACH(i, g_arenas)
+		{
+			const Arena* arena = g_arenas[i];
+
+			if (arena->mFrame == g_arenaFrame)
+			{
+				bytes		+= arena->mBytes;
+				allocations	+= arena->mAllocations;
+			}
+		}
+		g_arenaBytes		= bytes;
+		g_arenaAllocations	= allocations;
+		if (g_arenaPeak < bytes) g_arenaPeak = bytes;
+		++g_arenaFrame;
+	}
+	g_arenaLock.Unlock();
+}
+
+//============================================================================================================
+// Frame arena statistics
+//============================================================================================================
+
+uint FrameArena::GetFrame()			{ return g_arenaFrame;			}
+uint FrameArena::GetBytes()			{ return g_arenaBytes;			}
+uint FrameArena::GetAllocations()	{ return g_arenaAllocations;	}
+uint FrameArena::GetPeakBytes()		{ return g_arenaPeak;			}
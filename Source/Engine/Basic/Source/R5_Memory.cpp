@@ -11,6 +11,7 @@ Memory::Memory (const Memory& in)
 	mBuffer			= mem.mBuffer;
 	mAllocated		= mem.mAllocated;
 	mSize			= mem.mSize;
+	mAllocator		= mem.mAllocator;
 	mem.mBuffer		= 0;
 	mem.mAllocated	= 0;
 	mem.mSize		= 0;
@@ -25,11 +26,31 @@ void Memory::operator = (const Memory& in)
 	mBuffer			= mem.mBuffer;
 	mAllocated		= mem.mAllocated;
 	mSize			= mem.mSize;
+	mAllocator		= mem.mAllocator;
 	mem.mBuffer		= 0;
 	mem.mAllocated	= 0;
 	mem.mSize		= 0;
 }
 
+//============================================================================================================
+// Allocates a new buffer either on the heap or using the allocator
+//============================================================================================================
+
+byte* Memory::_Allocate (uint size)
+{
+	return (mAllocator == 0) ? new byte[size] : (byte*)mAllocator->Allocate(size);
+}
+
+//============================================================================================================
+// Releases a buffer previously created by _Allocate()
+//============================================================================================================
+
+void Memory::_Free (byte* buffer, uint size)
+{
+	if (mAllocator == 0) delete [] buffer;
+	else mAllocator->Free(buffer, size);
+}
+
 //============================================================================================================
 // Release the memory buffer
 //============================================================================================================
@@ -38,7 +59,7 @@ void Memory::Release()
 {
 	if (mBuffer != 0)
 	{
-		delete [] mBuffer;
+		_Free(mBuffer, mAllocated);
 		mBuffer		= 0;
 		mAllocated	= 0;
 		mSize		= 0;
@@ -56,22 +77,23 @@ byte* Memory::Reserve (uint size)
 		if (mBuffer != 0)
 		{
 			// Start with twice as much memory as currently allocated
+			uint previous = mAllocated;
 			mAllocated = (mAllocated << 1);
 
 			// If we requested more memory, adjust accordingly
 			if (mAllocated < size) mAllocated = size;
 
 			// Allocate the new buffer and copy the old data over
-			byte* newBuffer = new byte[mAllocated];
+			byte* newBuffer = _Allocate(mAllocated);
 			if (mSize > 0) memcpy(newBuffer, mBuffer, mSize);
-			delete [] mBuffer;
+			_Free(mBuffer, previous);
 			mBuffer = newBuffer;
 		}
 		else
 		{
 			// Minimum buffer size is 1 kb
 			mAllocated = (size < 1024) ? 1024 : size;
-			mBuffer = new byte[mAllocated];
+			mBuffer = _Allocate(mAllocated);
 		}
 	}
 	return mBuffer;
@@ -0,0 +1,491 @@
+#include "../Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Prevents the compiler (and on weakly-ordered CPUs, the processor) from reordering memory accesses.
+// Each ring buffer has a single producer and a single consumer, so nothing stronger is needed on x86.
+//============================================================================================================
+
+#if defined(_MSC_VER)
+	#define R5_MEMORY_BARRIER _ReadWriteBarrier()
+#elif defined(__i386__) || defined(__x86_64__)
+	#define R5_MEMORY_BARRIER __asm__ __volatile__ ("" ::: "memory")
+#else
+	#define R5_MEMORY_BARRIER __sync_synchronize()
+#endif
+
+//============================================================================================================
+// Ring buffer of completed zones, written to by a single thread and drained by Profiler::NextFrame()
+//============================================================================================================
+
+struct ThreadLog
+{
+	enum
+	{
+		Size		= 4096,
+		Mask		= Size - 1,
+		MaxDepth	= 32,
+	};
+
+	Profiler::Event		mEvents[Size];
+	volatile uint		mWrite;				// Written to by the owning thread only
+	volatile uint		mRead;				// Written to by the draining thread only
+	uint				mDepth;				// Current nesting depth of the owning thread
+	uint				mDropped;			// Number of zones that didn't fit
+	uint				mIndex;				// Unique identifier used by the trace export
+	String				mName;				// Name of the thread
+	Profiler::Ticks		mNested[MaxDepth];	// Time spent in nested zones, per depth -- used by the draining thread
+
+	ThreadLog (uint index) : mWrite(0), mRead(0), mDepth(0), mDropped(0), mIndex(index)
+	{
+		mName = String("Thread %u", index);
+		for (uint i = 0; i < MaxDepth; ++i) mNested[i] = 0;
+	}
+};
+
+//============================================================================================================
+// Accumulated data for each unique zone
+//============================================================================================================
+
+struct ZoneEntry
+{
+	Profiler::ZoneStats	mStats;		// Statistics of the last frame
+	Profiler::Ticks		mTotal;		// Ticks spent in the zone during the current frame
+	Profiler::Ticks		mSelf;		// Ticks spent in the zone itself, excluding nested zones
+	uint				mCalls;		// Number of calls during the current frame
+};
+
+//============================================================================================================
+// Zone captured for the trace export
+//============================================================================================================
+
+struct CapturedZone
+{
+	const char*		mName;
+	Profiler::Ticks	mStart;
+	Profiler::Ticks	mEnd;
+	uint			mThread;
+};
+
+//============================================================================================================
+
+bool Profiler::mEnabled = false;
+
+R5_THREAD_LOCAL ThreadLog* g_threadLog = 0;
+
+Thread::Lockable	g_profilerLock;
+Array<ThreadLog*>	g_threadLogs;			// All ring buffers ever created
+Array<ThreadLog*>	g_unusedLogs;			// Ring buffers no longer associated with a thread
+Array<ZoneEntry>	g_zones;				// All zones encountered so far
+uint				g_zoneCache[256] = {0};	// Zone index + 1, indexed by the hash of the zone name's pointer
+Array<CapturedZone>	g_capture;				// Captured zones, if a capture is in progress
+uint				g_captureLimit	= 0;
+bool				g_capturing		= false;
+Profiler::Ticks		g_calTicks		= 0;	// Calibration timestamp in ticks
+double				g_calSeconds	= 0.0;	// Calibration timestamp in seconds
+double				g_frequency		= 0.0;	// Calibrated number of ticks per second
+Profiler::Ticks		g_lastFrame		= 0;	// Timestamp of the previous NextFrame() call
+float				g_frameTime		= 0.0f;	// Duration of the last frame, in milliseconds
+
+//============================================================================================================
+// Measures the number of ticks per second against the system timer
+//============================================================================================================
+
+void Calibrate()
+{
+	if (g_frequency == 0.0)
+	{
+		// Initial estimate using a short busy-wait. It gets refined by NextFrame() as time goes on.
+		g_calSeconds	= Time::GetSystemSeconds();
+		g_calTicks		= Profiler::GetTicks();
+
+		double seconds;
+		while ((seconds = Time::GetSystemSeconds()) - g_calSeconds < 0.01) {}
+
+		g_frequency = (double)(Profiler::GetTicks() - g_calTicks) / (seconds - g_calSeconds);
+		if (g_frequency <= 0.0) g_frequency = 1000000000.0;
+	}
+}
+
+//============================================================================================================
+// Retrieves the calling thread's ring buffer, creating it if necessary
+//============================================================================================================
+
+inline ThreadLog* GetThreadLog()
+{
+	ThreadLog* log = g_threadLog;
+
+	if (log == 0)
+	{
+		g_profilerLock.Lock();
+		{
+			if (g_unusedLogs.IsValid())
+			{
+				log = g_unusedLogs.Back();
+				g_unusedLogs.Shrink();
+				log->mName = String("Thread %u", log->mIndex);
+			}
+			else
+			{
+				log = new ThreadLog(g_threadLogs.GetSize());
+				g_threadLogs.Expand() = log;
+			}
+		}
+		g_profilerLock.Unlock();
+		g_threadLog = log;
+	}
+	return log;
+}
+
+//============================================================================================================
+// Finds the zone with the specified name, adding a new one if necessary. Zones are matched by pointer
+// first, and only compared by value when the pointer hasn't been seen before.
+//============================================================================================================
+
+ZoneEntry& GetZone (const char* name)
+{
+	uint hash = (uint)(((size_t)name >> 3) & 255);
+	uint cached = g_zoneCache[hash];
+
+	if (cached != 0 && g_zones[cached - 1].mStats.mName == name)
+		return g_zones[cached - 1];
+
+	for (uint i = 0; i < g_zones.GetSize(); ++i)
+	{
+		const char* zoneName = g_zones[i].mStats.mName;
+
+		if (zoneName == name || strcmp(zoneName, name) == 0)
+		{
+			g_zoneCache[hash] = i + 1;
+			return g_zones[i];
+		}
+	}
+
+	ZoneEntry& zone = g_zones.Expand();
+	memset(&zone, 0, sizeof(ZoneEntry));
+	zone.mStats.mName = name;
+	g_zoneCache[hash] = g_zones.GetSize();
+	return zone;
+}
+
+//============================================================================================================
+// Collects all zones recorded by all threads since the last call. Must be called with the lock held.
+//============================================================================================================
+
+void Drain()
+{
+	FOREACH(i, g_threadLogs)
+	{
+		ThreadLog* log = g_threadLogs[i];
+
+		uint read	= log->mRead;
+		uint write	= log->mWrite;
+		R5_MEMORY_BARRIER;
+
+		for (; read != write; ++read)
+		{
+			const Profiler::Event& e = log->mEvents[read & ThreadLog::Mask];
+
+			uint depth = (e.mDepth < ThreadLog::MaxDepth - 1) ? e.mDepth : ThreadLog::MaxDepth - 2;
+			Profiler::Ticks duration = e.mEnd - e.mStart;
+
+			// Nested zones always finish before their parent, so their time has already been gathered
+			Profiler::Ticks nested = log->mNested[depth + 1];
+			log->mNested[depth + 1] = 0;
+			if (depth > 0) log->mNested[depth] += duration;
+
+			ZoneEntry& zone = GetZone(e.mName);
+			zone.mTotal += duration;
+			zone.mSelf	+= (nested < duration) ? duration - nested : 0;
+			++zone.mCalls;
+
+			if (g_capturing && g_capture.GetSize() < g_captureLimit)
+			{
+				CapturedZone& cz = g_capture.Expand();
+				cz.mName	= e.mName;
+				cz.mStart	= e.mStart;
+				cz.mEnd		= e.mEnd;
+				cz.mThread	= log->mIndex;
+			}
+		}
+
+		// Let the owning thread know the space can be reused
+		R5_MEMORY_BARRIER;
+		log->mRead = write;
+	}
+}
+
+//============================================================================================================
+// Whether the first zone took longer than the second -- used by GetTopZones()
+//============================================================================================================
+
+inline bool IsSlower (const Profiler::ZoneStats& a, const Profiler::ZoneStats& b, bool selfTime)
+{
+	return selfTime ? (a.mSelf > b.mSelf) : (a.mTime > b.mTime);
+}
+
+//============================================================================================================
+// Called when a zone is entered
+//============================================================================================================
+
+Profiler::Ticks Profiler::_Enter()
+{
+	++GetThreadLog()->mDepth;
+	return GetTicks();
+}
+
+//============================================================================================================
+// Called when a zone is exited -- adds the completed zone to the thread's ring buffer
+//============================================================================================================
+
+void Profiler::_Exit (const char* name, Ticks start)
+{
+	Ticks end = GetTicks();
+	ThreadLog* log = GetThreadLog();
+	if (log->mDepth > 0) --log->mDepth;
+
+	uint write = log->mWrite;
+
+	if (write - log->mRead < ThreadLog::Size)
+	{
+		Event& e	= log->mEvents[write & ThreadLog::Mask];
+		e.mName		= name;
+		e.mStart	= start;
+		e.mEnd		= end;
+		e.mDepth	= log->mDepth;
+
+		// The event must be fully written before it gets published
+		R5_MEMORY_BARRIER;
+		log->mWrite = write + 1;
+	}
+	else ++log->mDropped;
+}
+
+//============================================================================================================
+// Number of ticks per second
+//============================================================================================================
+
+double Profiler::GetTicksPerSecond()
+{
+	if (g_frequency == 0.0) Calibrate();
+	return g_frequency;
+}
+
+//============================================================================================================
+// Enables or disables recording of zones
+//============================================================================================================
+
+void Profiler::SetEnabled (bool val)
+{
+	if (val && g_frequency == 0.0) Calibrate();
+	if (val && !mEnabled) g_lastFrame = GetTicks();
+	mEnabled = val;
+}
+
+//============================================================================================================
+// Sets the name of the calling thread
+//============================================================================================================
+
+void Profiler::SetThreadName (const char* name)
+{
+	ThreadLog* log = GetThreadLog();
+	g_profilerLock.Lock();
+	log->mName = name;
+	g_profilerLock.Unlock();
+}
+
+//============================================================================================================
+// Returns the calling thread's ring buffer to the pool. Zones it still holds get collected on the next frame.
+//============================================================================================================
+
+void Profiler::Detach()
+{
+	if (g_threadLog != 0)
+	{
+		g_threadLog->mDepth = 0;
+		g_profilerLock.Lock();
+		g_unusedLogs.Expand() = g_threadLog;
+		g_profilerLock.Unlock();
+		g_threadLog = 0;
+	}
+}
+
+//============================================================================================================
+// Marks the end of the frame, collecting all recorded zones and updating the statistics
+//============================================================================================================
+
+void Profiler::NextFrame()
+{
+	if (!mEnabled && g_zones.IsEmpty()) return;
+
+	Ticks now = GetTicks();
+
+	g_profilerLock.Lock();
+	{
+		Drain();
+
+		// Refine the calibration -- the longer the measured period, the more precise it gets
+		if (g_frequency != 0.0)
+		{
+			double seconds = Time::GetSystemSeconds();
+			if (seconds - g_calSeconds > 1.0) g_frequency = (double)(now - g_calTicks) / (seconds - g_calSeconds);
+		}
+
+		double toMS = 1000.0 / GetTicksPerSecond();
+		g_frameTime = (g_lastFrame != 0) ? (float)((now - g_lastFrame) * toMS) : 0.0f;
+		g_lastFrame = now;
+
+		FOREACH(i, g_zones)
+		{
+			ZoneEntry& zone = g_zones[i];
+			ZoneStats& stats = zone.mStats;
+
+			stats.mCalls	= zone.mCalls;
+			stats.mTime		= (float)(zone.mTotal * toMS);
+			stats.mSelf		= (float)(zone.mSelf  * toMS);
+			stats.mAverage	= stats.mAverage * 0.9f + stats.mTime * 0.1f;
+			if (stats.mPeak < stats.mTime) stats.mPeak = stats.mTime;
+
+			zone.mTotal	= 0;
+			zone.mSelf	= 0;
+			zone.mCalls	= 0;
+		}
+	}
+	g_profilerLock.Unlock();
+}
+
+//============================================================================================================
+// Duration of the last frame, in milliseconds
+//============================================================================================================
+
+float Profiler::GetFrameTime() { return g_frameTime; }
+
+//============================================================================================================
+// Number of zones that could not be recorded because a thread's ring buffer was full
+//============================================================================================================
+
+uint Profiler::GetDroppedEvents()
+{
+	uint count = 0;
+	g_profilerLock.Lock();
+	FOREACH(i, g_threadLogs) count += g_threadLogs[i]->mDropped;
+	g_profilerLock.Unlock();
+	return count;
+}
+
+//============================================================================================================
+// Retrieves up to 'count' zones that took the most time during the last frame, sorted by time
+//============================================================================================================
+
+uint Profiler::GetTopZones (ZoneStats* zones, uint count, bool selfTime)
+{
+	uint found = 0;
+
+	g_profilerLock.Lock();
+	{
+		FOREACH(i, g_zones)
+		{
+			const ZoneStats& stats = g_zones[i].mStats;
+			if (stats.mCalls == 0) continue;
+
+			// Insertion sort -- the number of requested zones is expected to be small
+			uint index = (found < count) ? found++ : count;
+
+			while (index > 0 && IsSlower(stats, zones[index - 1], selfTime))
+			{
+				if (index < count) zones[index] = zones[index - 1];
+				--index;
+			}
+			if (index < count) zones[index] = stats;
+		}
+	}
+	g_profilerLock.Unlock();
+	return found;
+}
+
+//============================================================================================================
+// Retrieves the statistics of all zones seen so far
+//============================================================================================================
+
+void Profiler::GetAllZones (Array<ZoneStats>& zones)
+{
+	zones.Clear();
+	g_profilerLock.Lock();
+	FOREACH(i, g_zones) zones.Expand() = g_zones[i].mStats;
+	g_profilerLock.Unlock();
+}
+
+//============================================================================================================
+// Starts capturing zones for the trace export
+//============================================================================================================
+
+void Profiler::StartCapture (uint maxEvents)
+{
+	g_profilerLock.Lock();
+	{
+		// Zones recorded prior to this point should not be a part of the capture
+		Drain();
+		g_capture.Clear();
+		g_capture.Reserve(maxEvents < 65536 ? maxEvents : 65536);
+		g_captureLimit = maxEvents;
+		g_capturing = true;
+	}
+	g_profilerLock.Unlock();
+	SetEnabled(true);
+}
+
+//============================================================================================================
+// Stops capturing zones and saves them out in the Chrome trace event format
+//============================================================================================================
+
+bool Profiler::StopCapture (const String& filename)
+{
+	Memory mem;
+	String line;
+
+	g_profilerLock.Lock();
+	{
+		Drain();
+		g_capturing = false;
+
+		double toUS = 1000000.0 / GetTicksPerSecond();
+		Ticks base = (g_capture.IsValid()) ? g_capture[0].mStart : 0;
+
+		FOREACH(i, g_capture)
+		{
+			if (g_capture[i].mStart < base) base = g_capture[i].mStart;
+		}
+
+		mem.Append("{\"traceEvents\":[\n", 17);
+
+		// Thread names are added as metadata
+		FOREACH(i, g_threadLogs)
+		{
+			const ThreadLog* log = g_threadLogs[i];
+			line = String("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+				log->mIndex, log->mName.GetBuffer());
+			line << ((i + 1 < g_threadLogs.GetSize() || g_capture.IsValid()) ? ",\n" : "\n");
+			mem.Append(line.GetBuffer(), line.GetLength());
+		}
+
+		FOREACH(i, g_capture)
+		{
+			const CapturedZone& cz = g_capture[i];
+			line = String("{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				cz.mName, cz.mThread, (cz.mStart - base) * toUS, (cz.mEnd - cz.mStart) * toUS);
+			line << ((i + 1 < g_capture.GetSize()) ? ",\n" : "\n");
+			mem.Append(line.GetBuffer(), line.GetLength());
+		}
+
+		mem.Append("]}\n", 3);
+		g_capture.Release();
+	}
+	g_profilerLock.Unlock();
+	return mem.Save(filename);
+}
+
+//============================================================================================================
+// Whether zones are currently being captured
+//============================================================================================================
+
+bool Profiler::IsCapturing() { return g_capturing; }
@@ -91,6 +91,15 @@ Thread::IDType Thread::GetID()
 	return (Thread::IDType)::GetCurrentThreadId();
 }
 
+//------------------------------------------------------------------------------------------------------------
+
+uint Thread::GetNumberOfCores()
+{
+	SYSTEM_INFO info;
+	::GetSystemInfo(&info);
+	return (info.dwNumberOfProcessors > 0) ? (uint)info.dwNumberOfProcessors : 1;
+}
+
 //============================================================================================================
 #elif defined _MACOS
 //============================================================================================================
@@ -146,6 +155,14 @@ Thread::IDType Thread::GetID()
 
 //------------------------------------------------------------------------------------------------------------
 
+uint Thread::GetNumberOfCores()
+{
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return (count > 0) ? (uint)count : 1;
+}
+
+//------------------------------------------------------------------------------------------------------------
+
 void Thread::MessageWindow (const char *format, ...)
 {
 	va_list args;
@@ -265,6 +282,14 @@ Thread::IDType Thread::GetID()
 
 //------------------------------------------------------------------------------------------------------------
 
+uint Thread::GetNumberOfCores()
+{
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return (count > 0) ? (uint)count : 1;
+}
+
+//------------------------------------------------------------------------------------------------------------
+
 void Thread::MessageWindow(const char *format, ...) {}
 bool Thread::AssertWindow(const char* description, int line, const char* filename, bool& keepChecking) 
 {
@@ -273,3 +298,173 @@ bool Thread::AssertWindow(const char* description, int line, const char* filenam
 }
 
 #endif
+
+//============================================================================================================
+// Counting semaphore used to put the worker threads to sleep until there is work for them. It's never
+// destroyed, as the worker threads keep waiting on it until the application exits.
+//============================================================================================================
+
+class Semaphore
+{
+#ifdef _WINDOWS
+	HANDLE mHandle;
+
+public:
+
+	Semaphore() { mHandle = ::CreateSemaphore(0, 0, 0x7FFFFFFF, 0); }
+
+	void Post (uint count)	{ ::ReleaseSemaphore(mHandle, (LONG)count, 0); }
+	void Wait()				{ ::WaitForSingleObject(mHandle, INFINITE); }
+#else
+	pthread_mutex_t	mMutex;
+	pthread_cond_t	mCond;
+	uint			mCount;
+
+public:
+
+	Semaphore() : mCount(0)
+	{
+		pthread_mutex_init(&mMutex, 0);
+		pthread_cond_init(&mCond, 0);
+	}
+
+	void Post (uint count)
+	{
+		pthread_mutex_lock(&mMutex);
+		mCount += count;
+		if (count == 1) pthread_cond_signal(&mCond);
+		else pthread_cond_broadcast(&mCond);
+		pthread_mutex_unlock(&mMutex);
+	}
+
+	void Wait()
+	{
+		pthread_mutex_lock(&mMutex);
+		while (mCount == 0) pthread_cond_wait(&mCond, &mMutex);
+		--mCount;
+		pthread_mutex_unlock(&mMutex);
+	}
+#endif
+};
+
+//============================================================================================================
+// Work shared between the threads participating in Thread::ParallelFor
+//============================================================================================================
+
+struct ParallelJob
+{
+	const Thread::IndexDelegate*	mCallback;
+	uint							mCount;
+	uint							mNext;
+	uint							mWorkers;	// Number of workers that have yet to finish
+	Thread::Lockable				mLock;
+
+	// Keep executing the callback until all indices have been claimed
+	void Run()
+	{
+		for (;;)
+		{
+			mLock.Lock();
+			uint index = mNext;
+			if (index < mCount) ++mNext;
+			mLock.Unlock();
+
+			if (index >= mCount) break;
+			(*mCallback)(index);
+		}
+	}
+
+	// Called by each worker once it runs out of work, returns whether it was the last one
+	bool Finish()
+	{
+		mLock.Lock();
+		bool last = (--mWorkers == 0);
+		mLock.Unlock();
+		return last;
+	}
+};
+
+//============================================================================================================
+// Worker threads are created as they are needed and then stay around, waiting for work
+//============================================================================================================
+
+static Thread::ValType	g_poolBusy		= 0;	// Whether a ParallelFor call is using the workers
+static uint				g_poolWorkers	= 0;	// Number of worker threads created so far
+static ParallelJob*		g_poolJob		= 0;	// Job the woken up workers should work on
+static Semaphore		g_poolWake;				// Posted once for every worker that should join the job
+static Semaphore		g_poolDone;				// Posted by the last worker to finish the job
+
+//============================================================================================================
+// Claims the worker pool, returning 'false' if it's already in use
+//============================================================================================================
+
+inline bool AcquirePool()
+{
+#if defined(_WINDOWS)
+	return ::InterlockedCompareExchange(&g_poolBusy, 1, 0) == 0;
+#elif defined(_MACOS)
+	return ::OSAtomicCompareAndSwap32Barrier(0, 1, &g_poolBusy);
+#else
+	return __sync_bool_compare_and_swap(&g_poolBusy, 0, 1);
+#endif
+}
+
+//============================================================================================================
+
+R5_THREAD_FUNCTION(ParallelForThread, ptr)
+{
+	Profiler::SetThreadName("Worker");
+
+	for (;;)
+	{
+		g_poolWake.Wait();
+		ParallelJob* job = g_poolJob;
+		job->Run();
+
+		// The job lives on the calling thread's stack, so it must not be touched after this point
+		if (job->Finish()) g_poolDone.Post(1);
+	}
+	return 0;
+}
+
+//============================================================================================================
+// Executes the callback for every index in the 0 to 'count' range using multiple threads
+//============================================================================================================
+
+void Thread::ParallelFor (uint count, const IndexDelegate& callback, uint maxThreads)
+{
+	if (count == 0) return;
+
+	if (maxThreads == 0) maxThreads = GetNumberOfCores() - 1;
+	if (maxThreads > count - 1) maxThreads = count - 1;
+
+	// Not worth involving any other threads, or the workers are busy with another call (which may well be
+	// the one making this call) -- in which case the calling thread does all the work
+	if (maxThreads == 0 || !AcquirePool())
+	{
+		for (uint i = 0; i < count; ++i) callback(i);
+		return;
+	}
+
+	while (g_poolWorkers < maxThreads)
+	{
+		Thread::Create(ParallelForThread, 0);
+		++g_poolWorkers;
+	}
+
+	ParallelJob job;
+	job.mCallback	= &callback;
+	job.mCount		= count;
+	job.mNext		= 0;
+	job.mWorkers	= maxThreads;
+
+	g_poolJob = &job;
+	g_poolWake.Post(maxThreads);
+
+	// The calling thread participates as well, then waits for the workers to finish
+	job.Run();
+	g_poolDone.Wait();
+
+	g_poolJob = 0;
+	Thread::Decrement(g_poolBusy);
+}
@@ -52,6 +52,27 @@ void Time::Update()
 	g_time		= (float)g_seconds;
 }
 
+//======================================================================================================
+// Unlike the other functions, this one doesn't rely on Time::Update() -- it queries the system timer
+// directly, making it suitable for measuring short intervals
+//======================================================================================================
+
+double Time::GetSystemSeconds()
+{
+#ifdef _WINDOWS
+	static LARGE_INTEGER frequency = { 0 };
+	if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / frequency.QuadPart;
+#else
+	timeval t;
+	gettimeofday(&t, 0);
+	return t.tv_sec + 0.000001 * t.tv_usec;
+#endif
+}
+
 //======================================================================================================
 // Increments the frame count -- should be called at the end of every drawn frame
 //======================================================================================================
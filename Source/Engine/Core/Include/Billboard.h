@@ -10,6 +10,16 @@
 
 class Billboard : public Object
 {
+public:
+
+	// Camera-facing quad representing the billboard, expanded on the CPU alongside all other billboards
+	struct Quad
+	{
+		Vector3f	mPos;		// World space center
+		Vector2f	mSize;		// Half-size along the camera's right and up axes
+		Color4ub	mColor;		// Color tint
+	};
+
 protected:
 
 	Color4ub			mColor;		// Color tint
@@ -31,14 +41,20 @@ public:
 	void SetTexture		(const ITexture* tex)	{ mTex = tex;		}
 	void SetTechnique	(const ITechnique* tech){ mTech = tech;		}
 
+	// Draw queue parameter that identifies batched billboards
+	static void* GetBatchParam();
+
+	// Draws the billboards, combining all consecutive billboards that share the same texture into a single call
+	static uint DrawBatch (Billboard* const* list, uint count);
+
 protected:
 
 	virtual void OnUpdate();
 	virtual bool OnFill (FillParams& params);
 	virtual uint OnDraw (TemporaryStorage& storage, uint group, const ITechnique* tech, void* param, bool insideOut);
 
-	// Draws the actual billboard reusing the common buffers
-	void DrawBillboard();
+	// Fills the quad representing the billboard. Returns 'false' if the billboard should not be drawn.
+	virtual bool OnFillQuad (IGraphics* graphics, Quad& quad);
 
 	// Serialization
 	virtual void OnSerializeTo	 (TreeNode& root) const;
@@ -0,0 +1,356 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Graphics controller that records all state changes and draw calls instead of executing them, so that
+// draw preparation can happen on worker threads. Recorded commands are later replayed in the same order
+// on the thread that owns the real graphics. State queries are answered from a copy of the real graphics'
+// state taken when the recording began, updated by the recorded commands.
+//------------------------------------------------------------------------------------------------------------
+// Resource management calls get forwarded to the real graphics, one thread at a time.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class CommandList : public IGraphics
+{
+public:
+
+	// Single recorded call
+	struct Command
+	{
+		enum
+		{
+			Fog = 0,
+			DepthWrite,
+			DepthTest,
+			ColorWrite,
+			AlphaTest,
+			StencilTest,
+			ScissorTest,
+			Wireframe,
+			Lighting,
+			Blending,
+			Culling,
+			AlphaCutoff,
+			Thickness,
+			DepthOffset,
+			Viewport,
+			ScissorRect,
+			FogRange,
+			BackgroundColor,
+			DefaultAF,
+			Light,
+			ModelMatrix,
+			ResetModelMatrix,
+			ViewMatrix,
+			ResetViewMatrix,
+			ProjectionMatrix,
+			ResetProjectionMatrix,
+			CameraOrientation,
+			CameraRange,
+			RenderTarget,
+			Technique,
+			Material,
+			MaterialTexture,
+			Shader,
+			Skybox,
+			Color,
+			ScreenProjection,
+			VBO,
+			Texture,
+			DepthFunction,
+			StencilFunction,
+			StencilOperation,
+			VertexAttribute,
+			PrepareToDraw,
+			DrawVertices,
+			DrawIndices,		// Indices in an IVBO
+			DrawShortIndices,	// Indices in memory, 16 bit
+			DrawTypedIndices,	// Indices in an IVBO, specified data type
+			DrawIntIndices,		// Indices in memory, 32 bit
+			Drawable,
+			Clear,
+			Delayed,			// Callback executed before the next frame
+			Flush,
+		};
+
+		uint mType;
+
+		union
+		{
+			uint	mValue[4];	// Integer and boolean arguments
+			float	mFloat[4];	// Floating point arguments
+		};
+
+		const void* mPtr[2];	// Resource and memory arguments
+	};
+
+	typedef Array<Command> Commands;
+
+private:
+
+	// Command list the calling thread is currently recording into, if any
+	static R5_THREAD_LOCAL CommandList* mActive;
+
+	// Delayed callback added while recording, passed on to the target when the commands get replayed
+	struct DelayedEntry
+	{
+		DelayedDelegate	mCallback;
+		void*			mParam;
+	};
+
+	IGraphics*		mTarget;	// Graphics the commands were recorded for
+	Commands		mCommands;	// Recorded commands
+	Array<float>	mData;		// Matrices and vectors that don't fit into their commands
+	Array<DelayedEntry> mDelayed;	// Delayed callbacks referenced by the recorded commands
+
+	// Mirrored state, taken from the target when the recording begins
+	bool			mFog;
+	bool			mDepthWrite;
+	bool			mDepthTest;
+	bool			mAlphaTest;
+	bool			mStencilTest;
+	bool			mScissorTest;
+	bool			mWireframe;
+	bool			mModelSet;
+	uint			mLighting;
+	uint			mBlending;
+	uint			mCulling;
+	float			mAdt;
+	float			mThickness;
+	uint			mDepthOffset;
+	uint			mAf;
+	Vector2i		mViewport;
+	Rect			mScissorRect;
+	Vector2f		mFogRange;
+	Color4f			mBackground;
+	Vector3f		mCamPos;
+	Vector3f		mCamDir;
+	Vector3f		mCamUp;
+	Vector3f		mCamRange;
+	Bounds			mCamBounds;
+	Matrix43		mModel;
+	Matrix43		mView;
+	Matrix43		mDefaultView;
+	Matrix44		mProj;
+	Matrix44		mDefaultProj;
+	Matrix43		mMV;
+	Matrix44		mMVP;
+	Matrix43		mIMV;
+	Matrix44		mIP;
+	Matrix44		mIMVP;
+	ILight			mLights[8];
+
+	const IRenderTarget*	mRenderTarget;
+	const ITechnique*		mTechnique;
+	const IMaterial*		mMaterial;
+	const IShader*			mShader;
+	const ITexture*			mSkybox;
+
+public:
+
+	CommandList();
+	virtual ~CommandList() {}
+
+	// Command list the calling thread is currently recording into, or '0' if none
+	static CommandList* GetActive() { return mActive; }
+
+	// Starts recording on the calling thread, copying the current state of the specified graphics
+	void Begin (IGraphics* target);
+
+	// Stops recording on the calling thread
+	void End();
+
+	// Executes all recorded commands on the graphics the recording was started with
+	void Replay();
+
+	// Removes all recorded commands
+	void Reset() { mCommands.Clear(); mData.Clear(); mDelayed.Clear(); }
+
+	// Direct access to the recorded commands
+	const Commands& GetCommands() const { return mCommands; }
+
+private:
+
+	// Adds a new command
+	Command& _Add (uint type)
+	{
+		Command& cmd = mCommands.Expand();
+		cmd.mType = type;
+		return cmd;
+	}
+
+	// Stores data that doesn't fit into the command, returning its offset
+	uint _Store (const float* data, uint count);
+
+public:
+
+	virtual void Flush() { _Add(Command::Flush); }
+
+	// State control functions
+	virtual void SetFog				(bool val)					{ _Add(Command::Fog).mValue[0]			= mFog			= val; }
+	virtual void SetDepthWrite		(bool val)					{ _Add(Command::DepthWrite).mValue[0]	= mDepthWrite	= val; }
+	virtual void SetDepthTest		(bool val)					{ _Add(Command::DepthTest).mValue[0]	= mDepthTest	= val; }
+	virtual void SetColorWrite		(bool val)					{ _Add(Command::ColorWrite).mValue[0]	= val; }
+	virtual void SetAlphaTest		(bool val)					{ _Add(Command::AlphaTest).mValue[0]	= mAlphaTest	= val; }
+	virtual void SetStencilTest		(bool val)					{ _Add(Command::StencilTest).mValue[0]	= mStencilTest	= val; }
+	virtual void SetScissorTest		(bool val)					{ _Add(Command::ScissorTest).mValue[0]	= mScissorTest	= val; }
+	virtual void SetWireframe		(bool val)					{ _Add(Command::Wireframe).mValue[0]	= mWireframe	= val; }
+	virtual void SetLighting		(uint val)					{ _Add(Command::Lighting).mValue[0]		= mLighting		= val; }
+	virtual void SetBlending		(uint val)					{ _Add(Command::Blending).mValue[0]		= mBlending		= val; }
+	virtual void SetCulling			(uint val)					{ _Add(Command::Culling).mValue[0]		= mCulling		= val; }
+	virtual void SetAlphaCutoff		(float val)					{ _Add(Command::AlphaCutoff).mFloat[0]	= mAdt			= val; }
+	virtual void SetThickness		(float val)					{ _Add(Command::Thickness).mFloat[0]	= mThickness	= val; }
+	virtual void SetDepthOffset		(uint val)					{ _Add(Command::DepthOffset).mValue[0]	= mDepthOffset	= val; }
+	virtual void SetDefaultAF		(uint level)				{ _Add(Command::DefaultAF).mValue[0]	= mAf			= level; }
+	virtual void SetViewport		(const Vector2i& size);
+	virtual void SetScissorRect		(const Rect& rect);
+	virtual void SetFogRange		(const Vector2f& range);
+	virtual void SetBackgroundColor	(const Color4f& color);
+
+public:
+
+	// Statistics and states
+	virtual const DeviceInfo&	GetDeviceInfo()			const	{ return mTarget->GetDeviceInfo();	}
+	virtual const FrameStats&	GetFrameStats()			const	{ return mTarget->GetFrameStats();	}
+	virtual bool				GetFog()				const	{ return mFog;			}
+	virtual bool				GetDepthWrite()			const	{ return mDepthWrite;	}
+	virtual bool				GetDepthTest()			const	{ return mDepthTest;	}
+	virtual bool				GetAlphaTest()			const	{ return mAlphaTest;	}
+	virtual bool				GetStencilTest()		const	{ return mStencilTest;	}
+	virtual bool				GetScissorTest()		const	{ return mScissorTest;	}
+	virtual bool				GetWireframe()			const	{ return mWireframe;	}
+	virtual uint				GetLighting()			const	{ return mLighting;		}
+	virtual uint				GetBlending()			const	{ return mBlending;		}
+	virtual uint				GetCulling()			const	{ return mCulling;		}
+	virtual float				GetAlphaCutoff()		const	{ return mAdt;			}
+	virtual float				GetThickness()			const	{ return mThickness;	}
+	virtual uint				GetDepthOffset()		const	{ return mDepthOffset;	}
+	virtual uint				GetDefaultAF()			const	{ return mAf;			}
+	virtual const Vector2i&		GetViewport()			const	{ return mViewport;		}
+	virtual const Rect&			GetScissorRect()		const	{ return mScissorRect;	}
+	virtual const Vector2f&		GetFogRange()			const	{ return mFogRange;		}
+	virtual const Color4f&		GetBackgroundColor()	const	{ return mBackground;	}
+
+	virtual const ITexture*		GetActiveSkybox()		const	{ return mSkybox;		}
+	virtual const ITechnique*	GetActiveTechnique()	const	{ return mTechnique;	}
+	virtual const IMaterial*	GetActiveMaterial()		const	{ return mMaterial;		}
+	virtual const IShader*		GetActiveShader()		const	{ return mShader;		}
+	virtual const Vector2i&		GetActiveViewport()		const	{ return mViewport;		}
+	virtual const IRenderTarget* GetActiveRenderTarget() const	{ return mRenderTarget; }
+
+	// Access to lights
+	virtual const ILight& GetActiveLight (uint index) const { return mLights[index < 8 ? index : 0]; }
+	virtual void SetActiveLight (uint index, const ILight* ptr);
+
+	// Camera orientation retrieval
+	virtual const Vector3f&		GetCameraPosition()		const	{ return mCamPos;		}
+	virtual const Vector3f&		GetCameraDirection()	const	{ return mCamDir;		}
+	virtual const Vector3f&		GetCameraUpVector()		const	{ return mCamUp;		}
+	virtual const Vector3f&		GetCameraRange()		const	{ return mCamRange;		}
+	virtual const Bounds&		GetCameraNearBounds()	const	{ return mCamBounds;	}
+
+	// Matrix retrieval
+	virtual const Matrix43&		GetModelMatrix()			{ return mModel; }
+	virtual const Matrix43&		GetViewMatrix()				{ return mView; }
+	virtual const Matrix44&		GetProjectionMatrix()		{ return mProj; }
+	virtual const Matrix43&		GetModelViewMatrix();
+	virtual const Matrix44&		GetModelViewProjMatrix();
+	virtual const Matrix43&		GetInverseModelViewMatrix();
+	virtual const Matrix44&		GetInverseProjMatrix();
+	virtual const Matrix44&		GetInverseMVPMatrix();
+
+	// Matrix manipulation
+	virtual void SetModelMatrix (const Matrix43& mat);
+	virtual void ResetModelMatrix();
+	virtual void SetViewMatrix (const Matrix43& mat);
+	virtual void ResetViewMatrix();
+	virtual void SetProjectionMatrix (const Matrix44& mat);
+	virtual void ResetProjectionMatrix();
+
+	// Camera control functions only update the camera's properties -- matrices are not recalculated
+	virtual void SetCameraOrientation		( const Vector3f& eye, const Vector3f& dir, const Vector3f& up );
+	virtual void SetCameraRange				( const Vector3f& range );
+
+	// Active object control
+	virtual void SetActiveRenderTarget		( const IRenderTarget* tar );
+	virtual void SetActiveTechnique			( const ITechnique* ptr, bool insideOut = false );
+	virtual bool SetActiveMaterial			( const IMaterial* ptr );
+	virtual bool SetActiveMaterial			( const ITexture* ptr );
+	virtual bool SetActiveShader			( const IShader* ptr );
+	virtual void SetActiveSkybox			( const ITexture* ptr );
+	virtual void SetActiveColor				( const Color& c );
+	virtual void SetScreenProjection		( bool screen );
+	virtual void SetActiveVBO				( const IVBO* vbo, uint type = IVBO::Type::Invalid );
+	virtual void SetActiveTexture			( uint textureUnit, const ITexture* ptr );
+	virtual void SetActiveDepthFunction		( uint condition );
+	virtual void SetActiveStencilFunction	( uint condition, uint val, uint mask );
+	virtual void SetActiveStencilOperation	( uint testFail, uint depthFail, uint pass );
+	virtual void SetActiveVertexAttribute	( uint			attribute,
+											  const IVBO*	vbo,
+											  const void*	ptr,
+											  uint			dataType,
+											  uint			elements,
+											  uint			stride );
+
+	// Activate all matrices and bind all textures, preparing to draw
+	virtual void PrepareToDraw() { _Add(Command::PrepareToDraw); }
+
+	// Draw bound vertices. Returned values are the number of triangles that will be drawn.
+	virtual uint DrawVertices	( uint primitive, uint vertexCount );
+	virtual uint DrawIndices	( const IVBO* vbo, uint primitive, uint indexCount );
+	virtual uint DrawIndices	( const ushort* indices, uint primitive, uint indexCount );
+	virtual uint DrawIndices	( const IVBO* vbo, uint primitive, uint indexCount, uint dataType );
+	virtual uint DrawIndices	( const uint* indices, uint primitive, uint indexCount );
+
+public:
+
+	// Queries that need the videocard can't be forwarded to the target while recording, as it's busy drawing
+	// on another thread. They are answered using the mirrored state instead, as conservatively as possible.
+	virtual bool		IsPointVisible	(uint id, const Vector3f& v);
+	virtual Color4f		ReadColor		(const Vector2i& pos);
+	virtual Vector3f	ConvertTo3D		(const Vector2i& pos, bool unproject = true);
+	virtual Vector2i	ConvertTo2D		(const Vector3f& pos);
+
+	// Command lists can't be initialized or released, and can't start or end frames
+	virtual bool Init (uint version = 200)	{ return false; }
+	virtual void Release()					{}
+	virtual void BeginFrame()				{ ASSERT(false, "Command lists can't begin frames"); }
+	virtual void EndFrame()					{ ASSERT(false, "Command lists can't end frames"); }
+
+	// Adds a delayed callback function that should be executed on the next frame (at BeginFrame)
+	virtual void ExecuteBeforeNextFrame (const DelayedDelegate& callback, void* param = 0);
+
+	// Clear the screen or the off-screen target
+	virtual void Clear (bool color = true, bool depth = true, bool stencil = true);
+
+	// Draws a pre-defined drawable object such as a skybox or a full-screen quad
+	virtual uint Draw (uint drawable);
+
+	// Resources are managed by the target
+	virtual Techniques&	GetAllTechniques()	{ return mTarget->GetAllTechniques();	}
+	virtual Materials&	GetAllMaterials()	{ return mTarget->GetAllMaterials();	}
+	virtual Textures&	GetAllTextures()	{ return mTarget->GetAllTextures();		}
+	virtual Shaders&	GetAllShaders()		{ return mTarget->GetAllShaders();		}
+	virtual Fonts&		GetAllFonts()		{ return mTarget->GetAllFonts();		}
+
+	virtual IVBO*			CreateVBO();
+	virtual ITexture*		CreateRenderTexture (const char* name = 0);
+	virtual IRenderTarget*	CreateRenderTarget();
+
+	virtual void DeleteVBO			(const IVBO*			ptr);
+	virtual void DeleteTexture		(const ITexture*		ptr);
+	virtual void DeleteRenderTarget	(const IRenderTarget*	ptr);
+
+	virtual ITechnique*		GetTechnique	(const String& name, bool createIfMissing = true);
+	virtual IMaterial*		GetMaterial		(const String& name, bool createIfMissing = true);
+	virtual ITexture*		GetTexture		(const String& name, bool createIfMissing = true);
+	virtual IShader*		GetShader		(const String& name, bool createIfMissing = true);
+	virtual IFont*			GetFont			(const String& name, bool createIfMissing = true);
+
+	// Serialization is handled by the target
+	virtual bool SerializeFrom (const TreeNode& root, bool forceUpdate = false) { return false; }
+	virtual bool SerializeTo (TreeNode& root) const { return false; }
+};
@@ -43,6 +43,10 @@ protected:
 	uint			mFullDraw;			// How many times in a row the scene has been drawn fully (up to 10)
 	Thread::IDType	mThreadID;			// ID of the thread the Core was created in
 	Thread::ValType mThreadCount;		// Number of active threads known to the core
+	Array<Emitter*>	mEmitters;			// Particle emitters waiting to be simulated at the end of the scene update
+	bool			mFlatUpdate;		// Whether the scene is updated using the flattened hierarchy
+	TransformHierarchy mHierarchy;		// Flattened hierarchy of the scene's transforms
+	ScriptRegistry	mScripts;			// Scripts listening to the update and fill callbacks
 
 	// Thread safety
 	Thread::Lockable mLock;
@@ -67,9 +71,10 @@ public:
 
 	R5_DECLARE_NAMED_CLASS(Core);
 
-	// It should be possible to retrieve values passed in the constructor
+	// It should be possible to retrieve values passed in the constructor. Objects drawn on worker
+	// threads get the command list their draw calls are being recorded into instead of the graphics.
 	IWindow*	GetWindow()		{ return mWin;		}
-	IGraphics*	GetGraphics()	{ return mGraphics; }
+	IGraphics*	GetGraphics()	{ IGraphics* list = CommandList::GetActive(); return (list != 0) ? list : mGraphics; }
 	IUI*		GetUI()			{ return mUI;		}
 	IAudio*		GetAudio()		{ return mAudio;	}
 
@@ -130,6 +135,22 @@ public:
 	uint GetSleepDelay() const		{ return mSleepDelay; }
 	void SetSleepDelay (uint delay) { mSleepDelay = delay; }
 
+	// INTERNAL: Queues the particle emitter to be simulated at the end of the scene update
+	void _QueueEmitter (Emitter* emitter) { mEmitters.Expand() = emitter; }
+
+	// Whether the scene is updated using the flattened transform hierarchy rather than recursively
+	bool GetFlatUpdate() const		{ return mFlatUpdate; }
+	void SetFlatUpdate (bool val)	{ mFlatUpdate = val; mHierarchy.SetDirty(); }
+
+	// Flattened transform hierarchy used to update the scene if the flat update is enabled
+	TransformHierarchy& GetTransformHierarchy() { return mHierarchy; }
+
+	// Registry of the scripts listening to the update and fill callbacks, and of sleeping scripts
+	ScriptRegistry& GetScriptRegistry() { return mScripts; }
+
+	// INTERNAL: Notifies the flattened hierarchy that objects or scripts have been added or removed
+	void _InvalidateHierarchy() { mHierarchy.SetDirty(); }
+
 	// Sleep delay used when the game is in UI-only mode
 	uint GetUIOnlyModeSleepDelay() const		{ return mUISleepDelay; }
 	void SetUIOnlyModeSleepDelay (uint delay)	{ mUISleepDelay = delay; }
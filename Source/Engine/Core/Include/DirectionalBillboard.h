@@ -22,5 +22,5 @@ public:
 protected:
 
 	virtual void OnUpdate() {}
-	virtual uint OnDraw (TemporaryStorage& storage, uint group, const ITechnique* tech, void* param, bool insideOut);
+	virtual bool OnFillQuad (IGraphics* graphics, Quad& quad);
 };
\ No newline at end of file
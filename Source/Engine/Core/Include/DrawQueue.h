@@ -4,22 +4,31 @@
 //			R5 Game Engine, individual file copyright belongs to their respective authors.
 //									http://r5ge.googlecode.com/
 //============================================================================================================
-// All drawable objects are separated by layers into different draw sets.
+// Flat queue of drawable objects, sorted once per frame using 64-bit keys.
 //------------------------------------------------------------------------------------------------------------
-// The draw hierarchy is as follows:
+// Each added object gets a single draw item along with one sort key per technique it's visible with.
+// Keys are packed as follows, starting with the most significant bit:
 //------------------------------------------------------------------------------------------------------------
-// - DrawQueue contains up to 32 DrawLayers, as objects can be placed on different layers.
-//   This allows you to manually control the draw order of certain objects.
-// - Each layer is split up into multiple DrawLists by their associated draw techniques.
-//   This minimizes the number of state switches between draw operations.
-// - Each DrawList is in turn split up into different DrawGroups by the group identifier.
-//   This allows batching of similar objects together -- instanced models, particles, etc.
-// - Each DrawGroup contains a list of objects that belong to it along with their distance to the camera.
-//   Distance allows objects to be drawn back-to-front or front-to-back as needed.
+// - Draw layer (5 bits). Objects can be placed on different layers to manually control the draw order.
+// - Technique index (5 bits). This minimizes the number of state switches between draw operations,
+//   and keeps translucent techniques apart from opaque ones.
+// - Inverted group identifier (32 bits). This allows batching of similar objects together -- instanced
+//   models, particles, etc. Inversion ensures that group 0 is drawn last, as that's where all groupless
+//   objects end up, including objects that are purposely groupless in order to be blended correctly.
+// - Distance to the camera (22 bits). Objects get drawn back-to-front or front-to-back as needed.
+//------------------------------------------------------------------------------------------------------------
+// Keys are sorted by everything but the distance using a stable radix sort, so objects within a group keep
+// the order they were added in. Only techniques that sort their objects need the distance, so each of their
+// ranges gets sorted by the entire key right before it's drawn. Drawing walks through the sorted keys, only
+// changing the state when the key's prefix changes.
+//------------------------------------------------------------------------------------------------------------
+// If recording threads are enabled, long runs of objects that can be drawn off the main thread get split
+// into chunks that are recorded into command lists in parallel, then replayed in their original order.
 // Author: Michael Lyashenko
 //============================================================================================================
 
 class LightSource;
+class CommandList;
 class DrawQueue
 {
 public:
@@ -28,6 +37,8 @@ public:
 
 	typedef Array<const ITechnique*> Techniques;
 
+	typedef unsigned long long Key;
+
 	struct LightEntry
 	{
 		LightSource* mLight;
@@ -40,42 +51,98 @@ public:
 
 	typedef Array<LightEntry> Lights;
 
+	// Object added to the queue
+	struct Item
+	{
+		Object*	mObject;	// Object that will be drawn
+		void*	mParam;		// Parameter passed to the object's draw function
+		uint	mGroup;		// Group the object belongs to
+	};
+
+	// Sort key referencing one of the items
+	struct Entry
+	{
+		Key		mKey;
+		uint	mItem;
+	};
+
+	// Consecutive items in draw order that are either drawn directly or recorded into a command list
+	struct Segment
+	{
+		uint	mFirst;		// First index within the draw order
+		uint	mLast;		// One past the last index within the draw order
+		int		mList;		// Command list the segment gets recorded into, or -1 if it's drawn directly
+		uint	mTriangles;	// Number of triangles drawn by the recorded segment
+	};
+
 private:
 
-	// Only the Scene class should be touching 'mLayers' directly
+	// Only the Scene class should be touching 'mLights' and 'mOnDraw' directly
 	friend class Scene;
 
-	Lights			mLights;
-	DrawLayer		mLayers[32];
-	OnDrawCallback	mOnDraw;
+	// Work executed by the recording threads
+	struct RecordingJob;
+
+	Lights				mLights;
+	Array<Item>			mItems;			// Added objects, in order they were added in
+	Array<Entry>		mEntries;		// Sort keys, one per item and technique
+	Array<Entry>		mTemp;			// Temporary buffer used while sorting
+	Array<Billboard*>	mBatch;			// Temporary list used to batch billboards
+	Array<uint>			mOrder;			// Items of the range being drawn, in the order they get drawn in
+	Array<Segment>		mSegments;		// Segments of the range being drawn
+	Array<uint>			mRecorded;		// Segments that get recorded into command lists
+	PointerArray<CommandList> mLists;	// Command lists reused from one frame to the next
+	uint				mMask[32];		// Combined technique mask of each layer, used to quickly skip layers
+	Object*				mLastObject;	// Parameters of the last Add() call, used to skip duplicates
+	void*				mLastParam;
+	uint				mLastLayer;
+	uint				mLastMask;
+	uint				mLastGroup;
+	OnDrawCallback		mOnDraw;
 
 public:
 
+	DrawQueue();
+
 	// Whether we have something to draw
-	bool IsValid() const;
+	bool IsValid() const { return mEntries.IsValid(); }
 
 	// Clear the draw queue
-	void Clear() { mLights.Clear(); for (uint i = 0; i < 32; ++i) mLayers[i].Clear(); }
+	void Clear();
 
 	// Adds a new light to the draw queue
 	void Add (LightSource* light, float distanceToCamera = 0.0f);
 
 	// Add a new object to the draw queue. The 'group' parameter can be a material,
 	// a texture, or anything else you might want to group similar objects by.
-	void Add (uint layer, Object* obj, void* param, uint mask, uint group, float distSquared)
-	{
-		mLayers[layer & 31].Add(obj, param, mask, group, distSquared);
-	}
+	void Add (uint layer, Object* obj, void* param, uint mask, uint group, float distSquared);
 
-	// Sort all objects by group and distance to camera
-	void Sort() { for (uint i = 0; i < 32; ++i) mLayers[i].Sort(); }
+	// Sort all objects by layer, technique, group and distance to camera
+	void Sort();
 
 	// Draw the scene
 	uint Draw (TemporaryStorage& storage, IGraphics* graphics, const Techniques& techniques,
 		bool useLighting, bool insideOut);
 
+	// Number of threads used to record draw calls. '0' draws everything on the calling thread directly.
+	static void SetRecordingThreads (uint count);
+	static uint GetRecordingThreads();
+
 private:
 
+	// Sorts the entries within the specified range by the bits of their keys above 'shift'
+	void SortRange (uint first, uint last, uint shift);
+
+	// Draws all entries within the specified range, which all share the same layer and technique
+	uint DrawRange (TemporaryStorage& storage, IGraphics* graphics, uint first, uint last,
+		const ITechnique* tech, bool insideOut);
+
+	// Draws the items within the specified portion of the draw order
+	uint DrawItems (TemporaryStorage& storage, uint first, uint last, const ITechnique* tech, bool insideOut);
+
+	// Records the recordable portions of the draw order on multiple threads, then replays them in order
+	uint DrawRecorded (TemporaryStorage& storage, IGraphics* graphics, const ITechnique* tech, bool insideOut);
+
 	// Activates all lights
 	void ActivateLights (IGraphics* graphics);
-};
\ No newline at end of file
+};
@@ -35,12 +35,40 @@ public:
 
 	typedef Array<Particle> Particles;
 
+	// Built-in behaviours, used by emitters that don't override UpdateParticle()
+	struct Behavior
+	{
+		Vector3f	mGravity;		// Acceleration applied to the particles, in units per second squared
+		float		mDrag;			// Fraction of the velocity lost every second
+		Vector2f	mSize;			// Radius at spawn and at the end of the lifetime, multiplied by the emitter's scale
+		Vector2f	mFade;			// Fraction of the lifetime spent fading in and fading out
+		float		mSpin;			// Rotation speed in radians per second
+
+		Behavior() : mDrag(0.0f), mSize(1.0f, 1.0f), mFade(0.0f, 0.0f), mSpin(0.0f) {}
+	};
+
+	// Particles are stored as separate streams so that the built-in behaviours can process 4 of them at a time
+	struct Streams
+	{
+		Array<uint>		mRemaining;		// Time remaining, 0 if the slot is free
+		Array<float>	mX, mY, mZ;		// Current position
+		Array<float>	mVX, mVY, mVZ;	// Current velocity, starting as the spawn direction
+		Array<float>	mRadius;		// Radius used to calculate the 4 corners
+		Array<float>	mRotation;		// Clockwise rotation in radians
+		Array<float>	mAlpha;			// Alpha multiplier set by the fading behaviour
+		Array<Color4ub>	mColor;			// Current color
+		Array<Vector3f>	mSpawnPos;		// Position the particle was spawned at
+		Array<uint>		mParam;			// Any other additional flags used by the particle
+	};
+
 protected:
 
 	const ITexture*		mTex;		// Texture used by the emitter
 	const ITechnique*	mTech;		// Technique used to draw this emitter
 
-	Particles		mParticles;		// Array of active particles
+	Streams			mParticles;		// Particle data, recycled in place
+	Behavior		mBehavior;		// Built-in particle behaviours
+	uint			mCount;			// Number of used particle slots, including free slots in between
 	uint			mLifetime;		// Lifetime of individual particles
 	uint			mActiveParts;	// Current number of active particles
 	uint			mMaxParticles;	// Maximum number of particles allowed to be active at any given time
@@ -48,7 +76,9 @@ protected:
 	uint			mActiveTime;	// Time left to actively spawn particles
 	uint			mAccumulated;	// Calculated: Accumulated time since the last particle was spawned
 	uint			mLastVisible;	// Calculated: Timestamp of when the emitter was last visible
+	uint			mDelta;			// Calculated: Time delta of the simulation step that was queued
 	bool			mUpdated;		// Whether the particle positions need to be updated
+	bool			mCustom;		// Whether UpdateParticle() is overridden, cleared by the default version
 
 	// Objects should never be created manually. Use the AddObject<> template instead.
 	Emitter();
@@ -70,6 +100,10 @@ public:
 	uint GetParticleLifetime()	const	{ return mLifetime;			}
 	uint GetMaxParticles()		const	{ return mMaxParticles;		}
 	uint GetSpawnFrequency()	const	{ return mFrequency;		}
+	uint GetActiveParticles()	const	{ return mActiveParts;		}
+
+	const Behavior& GetBehavior() const	{ return mBehavior; }
+	void SetBehavior (const Behavior& b){ mBehavior = b;	}
 
 	void SetActive			 (uint ms = 1)			{ mActiveTime	= ms;		}
 	void SetTexture			 (const ITexture* tex)	{ mTex			= tex;		}
@@ -97,6 +131,28 @@ protected:
 
 	// MUST OVERRIDE: Virtual functionality allows custom particle behavior
 	virtual void InitParticle   (Particle& particle)=0;
-	virtual void UpdateParticle (Particle& particle)=0;
 	virtual void SetRenderStates(IGraphics* graphics)=0;
+
+	// Custom particle behavior. Overriding it replaces the built-in behaviours, but particles then have to be
+	// updated one at a time on the main thread.
+	virtual void UpdateParticle (Particle& particle) { mCustom = false; }
+
+private:
+
+	// Resizes the particle streams
+	void _Reserve (uint count);
+
+	// Spawns a particle in the specified slot
+	void _Spawn (uint index, uint remaining);
+
+	// Runs all particles through UpdateParticle(), one at a time
+	void _UpdateCustom();
+
+public:
+
+	// INTERNAL: Runs the built-in behaviours on all particles and recalculates the bounds
+	void _Simulate();
+
+	// INTERNAL: Simulates all emitters queued during the scene update, in parallel if there is enough work
+	static void _Simulate (const Array<Emitter*>& list);
 };
\ No newline at end of file
@@ -74,13 +74,17 @@ public:
 	void RemoveOnScroll		(const OnScrollDelegate& callback, uint priority);
 	void RemoveOnScroll		(const OnScrollDelegate& callback);
 
-	// Update callback registration -- the execution delay is in seconds
-	void AddOnPreUpdate		(const UpdateList::Callback& callback, float delay = 0.0f)	{ mPreList.Add(callback, delay); }
-	void RemoveOnPreUpdate	(const UpdateList::Callback& callback)						{ mPreList.Remove(callback); }
-	void AddOnPostUpdate	(const UpdateList::Callback& callback, float delay = 0.0f)	{ mPostList.Add(callback, delay); }
-	void RemoveOnPostUpdate	(const UpdateList::Callback& callback)						{ mPostList.Remove(callback); }
-	void AddOnLateUpdate	(const UpdateList::Callback& callback, float delay = 0.0f)	{ mLateList.Add(callback, delay); }
-	void RemoveOnLateUpdate	(const UpdateList::Callback& callback)						{ mLateList.Remove(callback); }
+	// Update callback registration -- the execution delay is in seconds. Removing callbacks using the
+	// returned handle is faster than searching for the callback.
+	UpdateList::Handle AddOnPreUpdate	(const UpdateList::Callback& callback, float delay = 0.0f)	{ return mPreList.Add(callback, delay);  }
+	UpdateList::Handle AddOnPostUpdate	(const UpdateList::Callback& callback, float delay = 0.0f)	{ return mPostList.Add(callback, delay); }
+	UpdateList::Handle AddOnLateUpdate	(const UpdateList::Callback& callback, float delay = 0.0f)	{ return mLateList.Add(callback, delay); }
+	void RemoveOnPreUpdate	(const UpdateList::Callback& callback)	{ mPreList.Remove(callback);  }
+	void RemoveOnPreUpdate	(UpdateList::Handle handle)				{ mPreList.Remove(handle);	  }
+	void RemoveOnPostUpdate	(const UpdateList::Callback& callback)	{ mPostList.Remove(callback); }
+	void RemoveOnPostUpdate	(UpdateList::Handle handle)				{ mPostList.Remove(handle);	  }
+	void RemoveOnLateUpdate	(const UpdateList::Callback& callback)	{ mLateList.Remove(callback); }
+	void RemoveOnLateUpdate	(UpdateList::Handle handle)				{ mLateList.Remove(handle);	  }
 
 protected:
 
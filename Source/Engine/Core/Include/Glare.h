@@ -14,9 +14,10 @@ protected:
 
 	Vector3f	mAlpha;			// Alpha factors for smooth interpolation (start, current, target)
 	float		mTimeStamp;		// Timestamp used for gradual alpha changes
+	uint		mQueryID;		// Identifier used by the asynchronous visibility test
 
 	// Objects should never be created manually. Use the AddObject<> template instead.
-	Glare() : mTimeStamp(0.0f) {}
+	Glare() : mTimeStamp(0.0f), mQueryID(GenerateUID()) {}
 
 public:
 
@@ -30,6 +31,6 @@ protected:
 	// If the alpha is changing, interpolate the value
 	virtual void OnUpdate();
 
-	// Draw the glare
-	virtual uint OnDraw (TemporaryStorage& storage, uint group, const ITechnique* tech, void* param, bool insideOut);
+	// Fills the quad representing the glare if it's visible
+	virtual bool OnFillQuad (IGraphics* graphics, Quad& quad);
 };
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Compact CPU-side heightfield with a min/max pyramid, used for height queries and raycasts
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class Heightfield
+{
+public:
+
+	// Each level of the pyramid covers the heightfield with cells twice the size of the previous level
+	struct Level
+	{
+		uint mWidth;	// Number of cells horizontally
+		uint mHeight;	// Number of cells vertically
+		uint mOffset;	// Offset of the first cell's min/max pair in 'mMinMax'
+	};
+
+protected:
+
+	Array<ushort>	mSamples;	// Heights quantized to 16 bits
+	Array<ushort>	mMinMax;	// Min/max quantized height pairs for every cell of every level
+	Array<Level>	mLevels;	// Pyramid levels, with 0 being the most detailed
+	uint			mWidth;		// Number of samples horizontally
+	uint			mHeight;	// Number of samples vertically
+	float			mMinZ;		// World-space height of quantized value 0
+	float			mRangeZ;	// World-space height difference between quantized values of 0 and 65535
+	Vector3f		mScale;		// Scale applied to the heightfield, same as Terrain::Heightmap::mTerrainScale
+	Vector3f		mOffset;	// Offset applied to the heightfield, same as Terrain::Heightmap::mTerrainOffset
+
+public:
+
+	Heightfield() : mWidth(0), mHeight(0), mMinZ(0.0f), mRangeZ(0.0f), mScale(1.0f) {}
+
+	// Releases all memory used by the heightfield
+	void Release();
+
+	// Whether the heightfield has been set up
+	bool IsValid() const { return mWidth > 1 && mHeight > 1; }
+
+	uint GetWidth()			const { return mWidth;  }
+	uint GetHeight()		const { return mHeight; }
+	uint GetLevelCount()	const { return mLevels.GetSize(); }
+
+	// Total amount of memory used by the heightfield's buffers
+	uint GetSizeInMemory() const { return mSamples.GetSizeInMemory() + mMinMax.GetSizeInMemory(); }
+
+	// Creates the heightfield from the specified floating point buffer (0-1 range, same as Terrain::Heightmap)
+	void Set (const float* buffer, uint width, uint height, const Vector3f& scale, const Vector3f& offset);
+
+	// Retrieves the bilinearly filtered world-space height at the specified world-space XY coordinates
+	float GetHeight (float x, float y) const;
+
+	// Retrieves the world-space normal at the specified world-space XY coordinates
+	Vector3f GetNormal (float x, float y) const;
+
+	// Sets the Z component of all specified world-space positions to the height of the heightfield
+	void GetHeights (Vector3f* positions, uint count, float offset = 0.0f) const;
+
+	// Casts a ray against the heightfield, skipping over regions of the pyramid that the ray can't hit.
+	// Returns 'true' if the ray hits the surface, setting 'distance' to the distance along the ray.
+	bool Raycast (const Vector3f& origin, const Vector3f& dir, float& distance, float maxDistance = 1.0e10f) const;
+
+private:
+
+	// Returns the dequantized world-space height of the specified sample
+	inline float _GetSample (uint x, uint y) const
+	{
+		return mMinZ + mRangeZ * (mSamples[x + y * mWidth] * (1.0f / 65535.0f));
+	}
+
+	// Returns the world-space height of the specified location in sample space
+	float _GetHeight (float sx, float sy) const;
+
+	// Intersects the ray with the two triangles making up the specified cell of the most detailed level
+	bool _RaycastCell (uint cx, uint cy, const Vector3f& origin, const Vector3f& dir, float& distance) const;
+};
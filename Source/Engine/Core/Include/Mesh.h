@@ -19,7 +19,7 @@ public:
 	typedef Array<Color4ub>	Colors;
 	typedef Array<Color4f>	BoneWeights;
 	typedef Array<Color4ub>	BoneIndices;
-	typedef unsigned short	Index;
+	typedef uint			Index;
 	typedef Array<Index>	Indices;
 
 	struct VertexFormat
@@ -34,6 +34,11 @@ public:
 		uint mColor;
 		uint mBoneIndex;
 		uint mBoneWeight;
+		uint mVertexType;		// Data type used by vertex positions in the VBO
+		uint mNormalType;		// Data type used by normals and tangents in the VBO
+		uint mTexCoordType;		// Data type used by texture coordinates in the VBO
+		uint mBoneWeightType;	// Data type used by bone weights in the VBO
+		Matrix43 mUnpack;		// Restores quantized VBO positions to model space (identity if not quantized)
 
 		VertexFormat() { Clear(); }
 
@@ -49,11 +54,38 @@ public:
 			mColor		= 0xFFFFFFFF;
 			mBoneIndex	= 0xFFFFFFFF;
 			mBoneWeight = 0xFFFFFFFF;
+			mVertexType		= IGraphics::DataType::Float;
+			mNormalType		= IGraphics::DataType::Float;
+			mTexCoordType	= IGraphics::DataType::Float;
+			mBoneWeightType	= IGraphics::DataType::Float;
+			mUnpack.SetToIdentity();
 		}
 	};
 
 private:
 
+	// Bone influences grouped by bone, so software skinning can transform each bone's vertices at once
+	struct SkinData
+	{
+		Batch::Vector3fSoA	mV;			// Vertex positions of all influences
+		Batch::Vector3fSoA	mN;			// Normals of all influences
+		Batch::Vector3fSoA	mT;			// Tangents of all influences
+		Batch::Vector3fSoA	mTv;		// Transformed vertex positions
+		Batch::Vector3fSoA	mTn;		// Transformed normals
+		Batch::Vector3fSoA	mTt;		// Transformed tangents
+		Array<uint>			mFirst;		// First influence of each bone, followed by the number of influences
+		Array<uint>			mInfluence;	// Influences of every vertex, one per bone weight
+
+		void Clear()
+		{
+			mV.Clear();
+			mN.Clear();
+			mT.Clear();
+			mFirst.Clear();
+			mInfluence.Clear();
+		}
+	};
+
 	String				mName;				// Every mesh needs a unique name
 	Vertices			mV;					// Vertex positions
 	Normals				mN;					// Normals
@@ -65,10 +97,13 @@ private:
 	BoneWeights			mBw;				// Bone weights
 	uint				mBones;				// Number of bones per vertex
 	bool				mGeneratedNormals;	// Whether normals came from a file or were generated
+	bool				mCompact;			// Whether the mesh should use the compact (quantized) vertex format
+	bool				mHalfFloat;			// Whether the graphics device supports half-float vertex attributes
 
 	Vertices			mTv;				// Transformed vertices (software skinning)
 	Normals				mTn;				// Transformed normals
 	Tangents			mTt;				// Transformed tangents
+	SkinData			mSkin;				// Bone influences used by software skinning
 
 	VertexFormat		mFormat;			// Current vertex format
 	IVBO*				mVbo;				// Vertex buffer object with interleaved vertex information
@@ -80,6 +115,7 @@ private:
 	uint				mPrimitive;			// Primitive type for the indices
 	IVBO*				mIbo;				// Index buffer object
 	uint				mIboSize;			// Number of entries in the IBO
+	uint				mIboType;			// Data type of the IBO's entries (16-bit whenever possible)
 	
 	IGraphics*			mGraphics;			// Pointer to the graphics controller managing the VBOs
 	Bounds				mBounds;			// Bounding box and sphere
@@ -114,6 +150,12 @@ private:
 	// Recalculates normals and tangents as requested
 	void _CalculateNormalsAndTangents();
 
+	// Recalculates the interleaved vertex format
+	void _UpdateFormat();
+
+	// Welds vertices and reorders triangles without rebuilding the buffers
+	bool _Optimize (MeshOptimizer::Stats* before, MeshOptimizer::Stats* after);
+
 public: // Various functions to allow read access to private data
 
 	void			SetName(const String& name)	{ mName = name;	}
@@ -122,6 +164,7 @@ public: // Various functions to allow read access to private data
 	bool			IsValid()			const	{ return (mV.IsValid() && mIndices.IsValid()); }
 	uint			GetSizeInMemory()	const;
 	uint			GetPrimitive()		const	{ return mPrimitive; }
+	bool			IsCompact()			const	{ return mCompact; }
 
 public: // These functions should only be used after the mesh has been locked
 
@@ -145,6 +188,15 @@ public: // These functions should only be used after the mesh has been locked
 	// Change the primitive type
 	void SetPrimitive(uint primitive)		{ ASSERT_IF_UNLOCKED; mPrimitive = primitive;	}
 
+	// Compact meshes use quantized positions, normals, tangents, texture coordinates and bone weights in the VBO,
+	// and are saved with quantized positions, octahedral normals, half-float texture coordinates and byte weights.
+	// Positions of unskinned meshes are stored as shorts relative to the mesh's bounding box, with the scale and
+	// offset folded into the model matrix when drawing.
+	// NOTE: Original arrays are kept at full precision even after the upload. Model instance groups batch meshes
+	// on the CPU using them, saving reads them, the VBO gets rebuilt from them when the format changes (SetCompact,
+	// half-float support of a different device), and software skinning and bounds both rely on them.
+	void SetCompact (bool val);
+
 	// You can manipulate transformed vertices directly -- if present, they will be used instead of the original ones
 	// NOTE: You don't need to call 'Rebuild' function after changing the transformed values.
 	Vertices&	GetTransformedVertices()	{ ASSERT_IF_UNLOCKED; return mTv; }
@@ -153,6 +205,8 @@ public: // These functions should only be used after the mesh has been locked
 
 private:
 
+	void _PrepareSkin();
+	void _Skin (const Array<Matrix43>& transforms, byte* v, byte* n, byte* t, uint stride);
 	bool _TransformToVBO (const Array<Matrix43>& transforms);
 	void _TransformToVAs (const Array<Matrix43>& transforms);
 
@@ -170,6 +224,9 @@ public:
 	// Returns the number of vertex entries
 	uint GetNumberOfVertices() const;
 
+	// Whether the mesh's buffers have already been uploaded, making it possible to record its draw calls
+	bool IsUploaded() const;
+
 	// Returns the size of the VBO vertex in bytes based on the data we have
 	uint GetFinalVertexSize() const { return mFormat.mFullSize; }
 
@@ -182,6 +239,13 @@ public:
 	// Software skinning on the CPU -- recalculates transformed vertices, normals, and tangents
 	bool ApplyTransforms (const Array<Matrix43>& transforms, uint instances);
 
+	// Welds duplicate vertices and reorders triangles and vertices for the GPU's caches. Only triangle lists
+	// can be optimized. Vertex cache statistics before and after the optimization can optionally be retrieved.
+	bool Optimize (MeshOptimizer::Stats* before = 0, MeshOptimizer::Stats* after = 0);
+
+	// Special: will either enable or disable optimizing meshes as they are loaded
+	static void EnableOptimizeOnLoad (bool val);
+
 	// Discards all current transformed arrays, returning to default values
 	void DiscardTransforms() { Lock(); mTv.Clear(); mTn.Clear(); mTt.Clear(); mTboSize = 0; Unlock(); }
 
@@ -67,6 +67,7 @@ protected:
 	float			mAnimationSpeed;	// Per-model animation speed value, for haste/slow/pause effects
 	BoneTransforms	mTransforms;		// Calculated final transforms, one for each bone
 	Matrices		mMatrices;			// Calculated final matrices, one for each bone
+	Matrices		mInvBind;			// Inverse bind pose matrices, one for each bone
 	uint			mUpdateInterval;	// Interval at which to perform animation updates in milliseconds
 	ulong			mLastUpdate;		// Timestamp of when the model was last updated
 	bool			mAnimUpdated;		// Whether the model has been updated
@@ -119,6 +120,9 @@ protected:
 	// Draw any special outline of the object
 	virtual uint _DrawOutline (IGraphics* graphics, const ITechnique* tech);
 
+	// Whether drawing the specified limb can be recorded on a worker thread
+	virtual bool _IsRecordable (const Limb* limb) const;
+
 public:
 
 	bool	IsAnimated()			const;
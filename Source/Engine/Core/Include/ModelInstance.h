@@ -12,12 +12,11 @@ class ModelInstance : public Object
 {
 protected:
 
-	Model*			 mModel;		// Pointer to the model that was instanced
-	mutable bool	 mRecalculate;	// Whether the matrix needs to be recalculated
-	mutable Matrix43 mMatrix;		// Calculated world transformation matrix
+	Model*		mModel;		// Pointer to the model that was instanced
+	Matrix43	mMatrix;	// World transformation matrix, updated along with the absolute coordinates
 
 	// Objects should never be created manually. Use the AddObject<> template instead.
-	ModelInstance() : mModel(0), mRecalculate(false) {}
+	ModelInstance() : mModel(0) {}
 
 public:
 
@@ -28,7 +27,7 @@ public:
 
 	Model*			GetModel()			{ return mModel; }
 	const Model*	GetModel()	const	{ return mModel; }
-	const Matrix43&	GetMatrix()	const;
+	const Matrix43&	GetMatrix()	const	{ return mMatrix; }
 
 	void SetModel (Model* model, bool runOnSerialize = true);
 
@@ -46,6 +45,9 @@ protected:
 	// Draw the object using the specified technique
 	virtual uint OnDraw (TemporaryStorage& storage, uint group, const ITechnique* tech, void* param, bool insideOut);
 
+	// Static models can be drawn on worker threads
+	virtual bool OnIsRecordable (const ITechnique* tech, void* param) const;
+
 	// Serialization to and from the scenegraph tree
 	virtual void OnSerializeTo	 (TreeNode& node) const;
 	virtual bool OnSerializeFrom (const TreeNode& node);
@@ -19,21 +19,21 @@ protected:
 
 		IMaterial*		mMat;		// Material used by this batch
 		Instances		mInstances;	// List of all instances that will be rendered
-		Memory			mVertices;	// Temporary memory used by the VBO
-		Array<ushort>	mIndices;	// Temporary memory used by the IBO
 		Bounds			mBounds;	// Bounds used to cull the batch
 
 		IVBO*	mVBO;
 		IVBO*	mIBO;
 		uint	mStride;
 		uint	mIndexCount;
+		uint	mIndexType;
 		uint	mPrimitive;
 		uint	mNormalOffset;
 		uint	mTanOffset;
 		uint	mTexOffset;
 		uint	mColorOffset;
 
-		Batch() : mMat(0), mVBO(0), mIBO(0), mStride(0), mIndexCount(0), mPrimitive(0),
+		Batch() : mMat(0), mVBO(0), mIBO(0), mStride(0), mIndexCount(0),
+			mIndexType(IGraphics::DataType::UShort), mPrimitive(0),
 			mNormalOffset(0), mTanOffset(0), mTexOffset(0), mColorOffset(0) {}
 	};
 
@@ -13,13 +13,12 @@ class OSPlayIdleAnimations : public Script
 protected:
 
 	Model*	mModel;
-	ulong	mTimeToPlay;
 	bool	mIdleLoop;
 
 	Array<Animation*> mIdleAnims;
 
 	// Use the AddScript<> template to add new scripts
-	OSPlayIdleAnimations() : mModel(0), mTimeToPlay(0), mIdleLoop(false) {}
+	OSPlayIdleAnimations() : mModel(0), mIdleLoop(false) {}
 
 	// Immediately plays a random idle animation
 	void Play();
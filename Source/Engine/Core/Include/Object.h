@@ -14,6 +14,8 @@ class Object
 	friend class Script;	// Script needs access to 'mScripts' so it can remove itself
 	friend class Scene;		// Scene needs to be able to use 'mCore'
 	friend class Core;		// Core needs to be able to set 'mCore'
+	friend class TransformHierarchy;	// Flattened hierarchy updates the objects directly
+	friend class ScriptRegistry;		// Registry keeps count of the scripts subscribed to each phase
 
 public:
 
@@ -70,6 +72,8 @@ protected:
 	bool		mShowOutline;		// Whether to show the bounding outline -- useful for debugging
 	ulong		mLastFilltime;		// Timestamp of the last time Fill() was called
 	uint		mVisibility;		// Visibility counter -- how many times the object is visible per frame
+	uint		mFlatIndex;			// Index of the object within the flattened hierarchy, if it's used
+	ushort		mListeners[ScriptRegistry::Phase::Count];	// Number of scripts subscribed to each phase
 
 	Lockable	mLock;
 	Children	mChildren;
@@ -113,6 +117,10 @@ public:
 	// This is a top-level base class
 	R5_DECLARE_BASE_CLASS(Object);
 
+	// Objects are allocated from cache-line aligned pools rather than individually on the heap
+	static void* operator new	 (size_t size)				{ return ObjectPool::Allocate(size); }
+	static void  operator delete (void* ptr, size_t size)	{ ObjectPool::Free(ptr, size); }
+
 private:
 
 	// INTERNAL Registers a new object of specified type
@@ -136,6 +144,12 @@ private:
 	// Draws the outline of the bounding box
 	uint _DrawOutline (IGraphics* graphics, const ITechnique* tech);
 
+	// INTERNAL: Notifies the scripts and the object itself of each stage of the update.
+	// Returns 'false' if the object was disabled by one of the scripts.
+	bool _PreUpdate();
+	bool _Update();
+	bool _PostUpdate();
+
 public:
 
 	// Clears the object, removing all children and scripts
@@ -254,6 +268,9 @@ public:
 	// Draws the object with the specified technique
 	uint Draw (TemporaryStorage& storage, uint group, const ITechnique* tech, void* param, bool insideOut);
 
+	// Whether drawing the object with the specified technique can be recorded on a worker thread
+	bool IsRecordable (const ITechnique* tech, void* param) const { return !mShowOutline && OnIsRecordable(tech, param); }
+
 	// Cast a ray into space and fill the list with objects that it intersected with
 	void Raycast (const Vector3f& pos, const Vector3f& dir, Array<RaycastHit>& hits);
 
@@ -319,6 +336,10 @@ protected:
 	// OnFill. It should return the number of triangles rendered.
 	virtual uint OnDraw (TemporaryStorage& storage, uint group, const ITechnique* tech, void* param, bool insideOut) { mIgnore.Set(Ignore::Draw, true); return 0; }
 
+	// Should return 'true' if OnDraw only reads the object's state and talks to the graphics retrieved from
+	// the Core, in which case it can be called on a worker thread while the draw calls are being recorded.
+	virtual bool OnIsRecordable (const ITechnique* tech, void* param) const { return false; }
+
 	// Called when the object is being raycast into -- should return 'false' if children were already considered
 	virtual bool OnRaycast (const Vector3f& pos, const Vector3f& dir, Array<RaycastHit>& hits);
 
@@ -331,7 +352,11 @@ protected:
 public:
 
 	// Registers a new object of the specified type
-	template <typename Type> static void Register() { _Register( Type::ClassName(), &Type::_CreateNew ); }
+	template <typename Type> static void Register()
+	{
+		ObjectPool::Register( Type::ClassName(), sizeof(Type) );
+		_Register( Type::ClassName(), &Type::_CreateNew );
+	}
 
 	// Finds a child object of the specified name and type
 	template <typename Type> Type* FindObject (const String& name, bool recursive = true)
@@ -0,0 +1,45 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Cache-line aligned pools used to allocate Objects and Scripts, segregated by size
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class ObjectPool
+{
+public:
+
+	// Pool statistics
+	struct Stats
+	{
+		String	mTypes;			// Comma-separated list of registered types using this pool
+		uint	mChunkSize;		// Size of each chunk in bytes
+		uint	mUsed;			// Number of chunks currently in use
+		uint	mCapacity;		// Number of allocated chunks
+		uint	mAllocations;	// Total number of allocations made from this pool
+	};
+
+	// Memory is allocated in multiples of the cache line size. Larger objects come from the heap.
+	enum
+	{
+		Alignment	= 64,
+		MaxClasses	= 64,
+	};
+
+public:
+
+	// Allocates memory for an object of the specified size
+	static void* Allocate (size_t size);
+
+	// Returns memory previously obtained from Allocate(). 'size' must match the allocated size.
+	static void Free (void* ptr, size_t size);
+
+	// Creates the pool used by objects of the specified size and associates it with the type's name
+	static void Register (const String& type, size_t size);
+
+	// Fills the array with statistics of all active pools
+	static void GetStats (Array<Stats>& stats);
+};
@@ -33,4 +33,7 @@ protected:
 
 	// Draw any special outline of the object
 	virtual uint _DrawOutline (IGraphics* graphics, const ITechnique* tech) { return 0; }
+
+	// Whether drawing the specified limb can be recorded on a worker thread
+	virtual bool _IsRecordable (const Limb* limb) const;
 };
\ No newline at end of file
@@ -51,6 +51,12 @@ private:
 	// Calls 'OnFill' on appropriate nodes
 	void _FillGeometry (void* ptr, float bboxPadding);
 
+	// Collects all leaf nodes (nodes that have no subdivisions)
+	void _GetLeaves (Array<QuadNode*>& leaves);
+
+	// Finds the leaf node containing the specified relative (0-1 range) coordinates
+	QuadNode* _FindLeaf (float x, float y);
+
 	// Called when the object is being considered for rendering
 	void Fill (Array<QuadNode*>& renderList, FillParams& params);
 
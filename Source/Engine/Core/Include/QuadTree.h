@@ -44,6 +44,12 @@ public:
 	// Height padding extends the height of the bounding box by this amount so child objects can fit easier.
 	void FillGeometry (void* ptr, float bboxPadding = 0.0f);
 
+	// Collects all leaf nodes of the tree
+	void GetLeaves (Array<QuadNode*>& leaves) { if (mRootNode != 0) mRootNode->_GetLeaves(leaves); }
+
+	// Finds the leaf node containing the specified relative (0-1 range) coordinates
+	QuadNode* FindLeaf (float x, float y) { return (mRootNode != 0) ? mRootNode->_FindLeaf(x, y) : 0; }
+
 protected:
 
 	// Derived classes must override this function
@@ -15,6 +15,8 @@ public:
 	// Allow Object class to create scripts and access internal members in order to simplify code
 	friend class Object;
 	friend class Core;
+	friend class ScriptRegistry;
+	friend class TransformHierarchy;
 
 	// Script creation function delegate
 	typedef FastDelegate<Script* (void)>  CreateDelegate;
@@ -22,6 +24,7 @@ public:
 
 protected:
 
+	// The first four flags match the phases of the ScriptRegistry
 	struct Ignore
 	{
 		enum
@@ -43,6 +46,11 @@ protected:
 
 private:
 
+	ScriptRegistry*	mRegistry;	// Registry that keeps track of the phases the script is subscribed to
+	uint			mType;		// Index of the script's type within the registry
+	uint			mWake;		// Scheduled wake-up while the script is sleeping, '0' otherwise
+	uint			mSlots[ScriptRegistry::Phase::Count];	// Index within each phase's list, or INVALID_VAL
+
 	// INTERNAL: Registers a new script of the specified type
 	static void _Register(const String& type, const CreateDelegate& func);
 
@@ -64,12 +72,19 @@ private:
 protected:
 
 	// Use the AddScript<> template to add new scripts
-	Script() : mEnabled(true), mSerializable(true) {}
+	Script() : mObject(0), mEnabled(true), mSerializable(true), mRegistry(0), mType(0), mWake(0)
+	{
+		for (uint i = 0; i < ScriptRegistry::Phase::Count; ++i) mSlots[i] = INVALID_VAL;
+	}
 
 public:
 
 	// Registers a new script
-	template <typename Type> static void Register() { _Register( Type::ClassName(), &Type::_CreateNew ); }
+	template <typename Type> static void Register()
+	{
+		ObjectPool::Register( Type::ClassName(), sizeof(Type) );
+		_Register( Type::ClassName(), &Type::_CreateNew );
+	}
 	template <typename Type> static void UnRegister() { _UnRegister( Type::ClassName() ); }
 
 	// Sets the replacement script type list that should be used instead of the built-in one
@@ -86,6 +101,10 @@ public:
 	// Scripts should be removed via DestroySelf() or using the RemoveScript<> template
 	virtual ~Script();
 
+	// Scripts are allocated from cache-line aligned pools rather than individually on the heap
+	static void* operator new	 (size_t size)				{ return ObjectPool::Allocate(size); }
+	static void  operator delete (void* ptr, size_t size)	{ ObjectPool::Free(ptr, size); }
+
 	// Access to the owner of the script
 	Object* GetOwner() { return mObject; }
 	const Object* GetOwner() const { return mObject; }
@@ -96,6 +115,16 @@ public:
 	// Destroys this script - this action is queued until next update
 	void DestroySelf();
 
+	// Puts the script to sleep for the specified number of milliseconds. Sleeping scripts don't
+	// receive any update or fill callbacks until they wake up.
+	void Sleep (uint ms);
+
+	// Wakes up the sleeping script right away
+	void Wake();
+
+	// Whether the script is currently sleeping
+	bool IsSleeping() const { return mWake != 0; }
+
 	// It's possible to choose not to serialize certain scripts
 	bool IsSerializable() const { return mSerializable; }
 	void SetSerializable (bool val) { mSerializable = val; }
@@ -104,6 +133,11 @@ public:
 	void SerializeTo (TreeNode& root) const;
 	void SerializeFrom (const TreeNode& root);
 
+private:
+
+	// Marks the specified phase as ignored, unsubscribing the script from it
+	void _Ignore (uint phase);
+
 protected:
 
 	// Initialization function is called once the script has been created
@@ -116,16 +150,16 @@ protected:
 	virtual void OnPostSerialize() {}
 
 	// Called prior to object's Update function
-	virtual void OnPreUpdate() { mIgnore.Set(Ignore::PreUpdate, true); }
+	virtual void OnPreUpdate() { _Ignore(ScriptRegistry::Phase::PreUpdate); }
 
 	// Called after the object's absolute coordinates have been calculated
-	virtual void OnUpdate() { mIgnore.Set(Ignore::Update, true); }
+	virtual void OnUpdate() { _Ignore(ScriptRegistry::Phase::Update); }
 
 	// Called after the object has updated all of its children
-	virtual void OnPostUpdate() { mIgnore.Set(Ignore::PostUpdate, true); }
+	virtual void OnPostUpdate() { _Ignore(ScriptRegistry::Phase::PostUpdate); }
 
 	// Called when the scene draw queue is being filled
-	virtual void OnFill (FillParams& params) { mIgnore.Set(Ignore::Fill, true); }
+	virtual void OnFill (FillParams& params) { _Ignore(ScriptRegistry::Phase::Fill); }
 
 	// Key and mouse events
 	virtual bool OnKeyPress (const Vector2i& pos, byte key, bool isDown) { mIgnore.Set(Ignore::KeyPress,  true); return false; }
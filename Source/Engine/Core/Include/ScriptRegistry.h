@@ -0,0 +1,96 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Registry of the scripts listening to the update and fill callbacks.
+//------------------------------------------------------------------------------------------------------------
+// Scripts start out subscribed to every phase and are unsubscribed the first time they turn out not to
+// override it (the default Script::OnUpdate() and such). Each phase keeps a compact list of subscribed
+// scripts per script type, and every object knows how many of its scripts are subscribed to each phase,
+// so objects whose scripts don't need to hear about a phase don't have to look at them at all.
+//------------------------------------------------------------------------------------------------------------
+// Sleeping scripts are unsubscribed from all phases and scheduled on a timing wheel, which subscribes
+// them again once they are due to wake up.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class ScriptRegistry
+{
+public:
+
+	// Phases scripts can subscribe to
+	struct Phase
+	{
+		enum
+		{
+			PreUpdate = 0,
+			Update,
+			PostUpdate,
+			Fill,
+			Count,
+		};
+	};
+
+	typedef Array<Script*> List;
+
+private:
+
+	Array<const String*>	mTypes;					// Script types, identified by the address of their class name
+	Array<List>				mLists[Phase::Count];	// Subscribed scripts of each type, one array per phase
+	uint					mActive[Phase::Count];	// Number of times each phase is being iterated through
+	bool					mHasGaps[Phase::Count];	// Whether a phase's lists contain removed entries
+	TimingWheel<Script*>	mSleeping;				// Sleeping scripts, scheduled to wake up in milliseconds
+	Array<Script*>			mAwake;					// Temporary list of scripts that have just woken up
+
+public:
+
+	ScriptRegistry();
+
+	// Number of script types seen so far
+	uint GetTypeCount() const { return mTypes.GetSize(); }
+
+	// Number of sleeping scripts
+	uint GetSleepingCount() const { return mSleeping.GetSize(); }
+
+	// Number of scripts subscribed to the specified phase
+	uint GetCount (uint phase) const;
+
+	// Scripts of the specified type subscribed to the specified phase. Entries of scripts that have been
+	// unsubscribed while the phase was being iterated through are set to '0'.
+	const List& GetList (uint phase, uint type) const { return mLists[phase][type]; }
+
+	// Scripts can safely be unsubscribed from a phase between these calls
+	void BeginPhase (uint phase) { ++mActive[phase]; }
+	void EndPhase (uint phase);
+
+	// Registers a newly added script, subscribing it to all the phases it's not ignoring
+	void Add (Script* script);
+
+	// Unsubscribes the script from all phases and forgets about it
+	void Remove (Script* script);
+
+	// Subscribes the script to the specified phase
+	void Subscribe (Script* script, uint phase);
+
+	// Unsubscribes the script from the specified phase
+	void Unsubscribe (Script* script, uint phase);
+
+	// Unsubscribes the script from all phases until the specified timestamp in milliseconds
+	void Sleep (Script* script, ulong wakeTime);
+
+	// Wakes up the sleeping script immediately
+	void Wake (Script* script);
+
+	// Wakes up all scripts that are due to wake up at the specified timestamp
+	void Update (ulong time);
+
+	// Releases all lists
+	void Release();
+
+private:
+
+	// Subscribes the script to all the phases it's not ignoring
+	void _SubscribeAll (Script* script);
+};
@@ -29,21 +29,73 @@ public:
 
 protected:
 
-	const IMaterial* mMat;
+	// TerrainNodes draw using the index buffers shared by the terrain
+	friend class TerrainNode;
+
+	const IMaterial*	mMat;
+	Heightfield			mHeightfield;	// CPU-side copy of the heightmap used for height queries and raycasts
+	Array<TerrainNode*>	mLeaves;		// All leaf nodes, used for LOD selection
+	Array<IVBO*>		mIBOs;			// Shared index buffers for every LOD and edge stitching combination
+	Array<uint>			mIndexCounts;	// Number of indices in each of the index buffers above
+	Vector2i			mMeshSize;		// Node mesh size that the index buffers were created for
+	uint				mLODCount;		// Number of available levels of detail
+	float				mMaxError;		// Maximum allowed screen-space error, in pixels
+	bool				mLargeIndices;	// Whether the index buffers use 32-bit indices
+	uint				mVertexCount;	// Number of vertices submitted by the last fill
+	uint				mTriangleCount;	// Number of triangles submitted by the last fill
+	const Heightmap*	mGenParams;		// Heightmap being generated (only valid inside Generate)
 
 	// Objects should never be created manually. Use the AddObject<> template instead.
-	Terrain() : mMat(0) {}
+	Terrain();
 
 public:
 
 	R5_DECLARE_INHERITED_CLASS(Terrain, QuadTree, Object);
 
+	// Releases the shared index buffers
+	virtual ~Terrain() { _ReleaseIndices(); }
+
+	// Maximum allowed screen-space error in pixels used to choose each node's level of detail (0 = always full detail)
+	float GetMaxError() const { return mMaxError; }
+	void SetMaxError (float pixels) { mMaxError = pixels; }
+
+	// Number of levels of detail available to each node. Node mesh dimensions of (2^n + 1) give the most levels.
+	uint GetLODCount() const { return mLODCount; }
+
+	// Statistics of the last fill: number of vertices and triangles that will be submitted for drawing
+	uint GetVertexCount()	const { return mVertexCount;	}
+	uint GetTriangleCount()	const { return mTriangleCount;	}
+
 	// The terrain is usually associated with a material
 	const IMaterial* GetMaterial() const { return mMat; }
 	void SetMaterial (const IMaterial* mat) { mMat = mat; }
 
 	// Generate the terrain
-	void Generate (Heightmap& hm) { FillGeometry(&hm); }
+	void Generate (Heightmap& hm);
+
+	// CPU-side heightfield that the terrain was generated from
+	const Heightfield& GetHeightfield() const { return mHeightfield; }
+
+	// Retrieves the height of the terrain at the specified world-space XY coordinates
+	float GetHeight (float x, float y) const { return mHeightfield.GetHeight(x, y); }
+
+	// Retrieves the terrain's normal at the specified world-space XY coordinates
+	Vector3f GetNormal (float x, float y) const { return mHeightfield.GetNormal(x, y); }
+
+	// Places all specified world-space positions on the terrain's surface (plus the optional offset)
+	void GetHeights (Vector3f* positions, uint count, float offset = 0.0f) const
+	{
+		mHeightfield.GetHeights(positions, count, offset);
+	}
+
+	// Object's raycast is still available alongside the terrain-specific version below
+	using Object::Raycast;
+
+	// Casts a ray against the terrain's surface, returning 'true' and the distance along the ray if it hits
+	bool Raycast (const Vector3f& origin, const Vector3f& dir, float& distance, float maxDistance = 1.0e10f) const
+	{
+		return mHeightfield.Raycast(origin, dir, distance, maxDistance);
+	}
 
 protected:
 
@@ -56,12 +108,35 @@ protected:
 	// Should retrieve the technique mask that the terrain can be rendered with (should not include children)
 	virtual uint GetMask() const { return mMat != 0 ? mMat->GetTechniqueMask() : 0; }
 
+	// Selects the level of detail of every node after the visible nodes have been gathered
+	virtual bool OnFill (FillParams& params);
+
 	// Set up all render states and activate the material before moving down to QuadTree's OnDraw
 	virtual uint OnDraw (TemporaryStorage& storage, uint group, const ITechnique* tech, void* param, bool insideOut);
 
+	// Called when the object is being raycast into -- adds a hit if the ray intersects the terrain's surface
+	virtual bool OnRaycast (const Vector3f& pos, const Vector3f& dir, Array<RaycastHit>& hits);
+
 	// Called when the object is being saved
 	virtual void OnSerializeTo (TreeNode& root) const;
 
 	// Called when the object is being loaded
 	virtual bool OnSerializeFrom (const TreeNode& node);
+
+private:
+
+	// Generates the vertices of the specified leaf node -- executed on worker threads
+	void _GenerateNode (uint index);
+
+	// Finds the neighbors of every leaf node, used to stitch the edges between nodes of different detail
+	void _LinkNeighbors();
+
+	// Chooses the level of detail for every leaf node based on the camera's distance and screen-space error
+	void _SelectLOD (const FillParams& params);
+
+	// Retrieves (creating if necessary) the shared index buffer for the specified LOD and stitching mask
+	const IVBO* _GetIndices (const Vector2i& meshSize, uint lod, uint mask, uint& count);
+
+	// Releases all shared index buffers
+	void _ReleaseIndices();
 };
\ No newline at end of file
@@ -10,18 +10,48 @@
 
 class TerrainNode : public QuadNode
 {
+public:
+
+	// Edges of the node -- used to flag neighbors that are drawn with less detail
+	struct Edge
+	{
+		enum
+		{
+			Left	= 0,
+			Right	= 1,
+			Bottom	= 2,
+			Top		= 3,
+		};
+	};
+
 protected:
 
-	IVBO*	mVBO;
-	IVBO*	mIBO;
-	uint	mIndices;
+	IVBO*			mVBO;
+	Memory			mVertices;		// Vertices created by _Generate(), kept until they get uploaded in OnFill()
+	Bounds			mGenBounds;		// Bounds of the generated vertices
+	Vector2i		mMeshSize;		// Number of vertices horizontally and vertically
+	Array<float>	mLODError;		// Maximum height error introduced by each level of detail
+	TerrainNode*	mNeighbor[4];	// Neighboring leaf nodes, indexed by Edge
+	uint			mLOD;			// Currently selected level of detail, 0 being the most detailed
 
 private:
 
 	// Only the Terrain class can create new TerrainNodes
 	friend class Terrain;
 
-	TerrainNode() : mVBO(0), mIBO(0), mIndices(0) {}
+	TerrainNode() : mVBO(0), mLOD(0)
+	{
+		mNeighbor[0] = 0;
+		mNeighbor[1] = 0;
+		mNeighbor[2] = 0;
+		mNeighbor[3] = 0;
+	}
+
+	// Generates the node's vertices and LOD errors without touching the graphics API (thread-safe)
+	void _Generate (const void* ptr, uint lodCount, float bboxPadding);
+
+	// Bitmask of edges that need to be stitched to neighbors drawn with less detail
+	uint _GetStitchMask() const;
 
 public:
 
@@ -30,4 +60,4 @@ public:
 
 	// Draw the object using the specified technique
 	virtual void OnDraw (uint group, const ITechnique* tech, bool insideOut);
-};
\ No newline at end of file
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Flattened copy of the scene graph's transforms, used to update the scene without recursion.
+//------------------------------------------------------------------------------------------------------------
+// Objects are stored breadth-first, so every depth level occupies a contiguous range and the children of
+// each object are next to each other. Local and world transforms, velocities and bounds are kept in
+// separate arrays along with per-object flags, and only the objects that have changed get written back.
+//------------------------------------------------------------------------------------------------------------
+// The update is split into separate phases rather than interleaving callbacks with transforms:
+// - Pre-update callbacks are executed.
+// - World transforms and velocities are calculated level by level, in parallel within each level.
+// - Update callbacks are executed. Absolute values overridden by a callback (for example by the
+//   OSAttachToBone script) are then passed down to the object's descendants, parents first.
+// - Bounds are calculated level by level, starting with the deepest one, in parallel within each level.
+// - Post-update callbacks are executed.
+// In each phase the scripts subscribed to it in the ScriptRegistry go first, one script type at a time,
+// followed by the objects' own callbacks -- parents first, except for the post-update callbacks.
+//------------------------------------------------------------------------------------------------------------
+// Unlike the recursive Object::Update, relative coordinates changed by an update or post-update callback
+// only get applied on the next frame, and objects added during the update only get updated next frame.
+// The list is rebuilt whenever objects get added or removed.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class TransformHierarchy
+{
+public:
+
+	// Flags kept for every object
+	struct Flag
+	{
+		enum
+		{
+			Active		= 1 << 0,	// The object and all of its parents are enabled
+			Dirty		= 1 << 1,	// The object's absolute values changed this update
+			Moved		= 1 << 2,	// Last value of 'mHasMoved' written to the object
+			Velocity	= 1 << 3,	// Last velocity written to the object was not zero
+			Pending		= 1 << 4,	// Relative values changed after the transforms have been calculated
+			PreUpdate	= 1 << 5,	// The object may listen to pre-update callbacks
+			Update		= 1 << 6,	// The object may listen to update callbacks
+			PostUpdate	= 1 << 7,	// The object may listen to post-update callbacks
+		};
+	};
+
+private:
+
+	Array<Object*>		mObjects;		// All objects, breadth-first
+	Array<uint>			mParent;		// Index of each object's parent, or INVALID_VAL for the root
+	Array<uint>			mFirst;			// Index of each object's first child
+	Array<uint>			mCount;			// Number of children of each object
+	Array<uint>			mLevels;		// Index of the first object on each level, followed by the total count
+	Array<Vector3f>		mLocalPos;		// Relative position
+	Array<Quaternion>	mLocalRot;		// Relative rotation
+	Array<Vector3f>		mLocalScale;	// Relative scale
+	Array<Vector3f>		mLastPos;		// Relative position on the previous update, used for velocity
+	Array<Vector3f>		mWorldPos;		// Absolute position
+	Array<Quaternion>	mWorldRot;		// Absolute rotation
+	Array<Vector3f>		mWorldScale;	// Absolute scale
+	Array<Vector3f>		mVelocity;		// Absolute velocity
+	Array<Bounds>		mBounds;		// Complete bounds, including all children
+	Array<byte>			mFlags;			// Combination of flags above
+	uint				mFrom;			// First object of the level being processed by the jobs
+	uint				mTo;			// One past the last object of the level being processed by the jobs
+	float				mDelta;			// Time delta, used to calculate velocities
+	uint				mThreads;		// Number of threads used to update large levels
+	bool				mIsDirty;		// Whether the list needs to be rebuilt
+
+public:
+
+	TransformHierarchy() : mFrom(0), mTo(0), mDelta(0.0f), mThreads(0), mIsDirty(true) {}
+
+	// Marks the list as needing to be rebuilt on the next update
+	void SetDirty() { mIsDirty = true; }
+
+	// Number of objects in the list
+	uint GetSize() const { return mObjects.GetSize(); }
+
+	// Number of depth levels in the list
+	uint GetDepth() const { return mLevels.IsValid() ? mLevels.GetSize() - 1 : 0; }
+
+	// Number of threads used to update large levels (0 means one per core, 1 disables threading)
+	uint GetThreads() const { return mThreads; }
+	void SetThreads (uint count) { mThreads = count; }
+
+	// Updates the specified root and all of its children
+	void Update (Object* root);
+
+	// Releases the list
+	void Release();
+
+private:
+
+	// Rebuilds the list, reading all values from the objects
+	void _Rebuild (Object* root, bool clearDeleted);
+
+	// Executes the specified job on all levels, splitting large levels between multiple threads
+	void _Execute (void (TransformHierarchy::*job)(uint), bool bottomUp);
+
+	// Jobs executed by _Execute on a chunk of the current level
+	void _TransformJob	(uint chunk);
+	void _BoundsJob		(uint chunk);
+
+	// Calculates the absolute values of the specified object using the specified parent's absolute values
+	void _Combine (uint index, const Vector3f& pos, const Quaternion& rot, const Vector3f& scale);
+
+	// Calculates the absolute values of the specified object and its velocity
+	void _Transform (uint index);
+
+	// Calculates the bounds of the specified object
+	void _UpdateBounds (uint index);
+
+	// Whether the absolute values of the specified object differ from the ones calculated by the list
+	bool _IsOverridden (uint index) const;
+
+	// Accepts the absolute values the specified object currently has as its own
+	void _Override (uint index);
+
+	// Passes the overridden absolute values of the specified object down to all of its descendants
+	void _Propagate (uint index);
+
+	// Whether the specified object is a part of the list, and it and all of its parents are enabled
+	bool _IsActive (const Object* obj) const;
+
+	// Executes the callback of all scripts subscribed to the specified phase, one script type at a time
+	void _ExecuteScripts (ScriptRegistry& scripts, uint phase, void (Script::*callback)());
+
+	// Phases executing the callbacks
+	void _PreUpdate	(ScriptRegistry& scripts);
+	void _Update	(ScriptRegistry& scripts);
+	void _PostUpdate(ScriptRegistry& scripts);
+};
@@ -5,6 +5,13 @@
 //									http://r5ge.googlecode.com/
 //============================================================================================================
 // Container for registered update callbacks
+//------------------------------------------------------------------------------------------------------------
+// Callbacks that run every update are kept in a plain list, while delayed ones wait on a timing wheel
+// with millisecond precision, so callbacks that are not due yet cost nothing on each update. Every added
+// callback gets a handle that can be used to remove it in constant time.
+//------------------------------------------------------------------------------------------------------------
+// Callbacks that have come due are executed first, followed by the ones that run every update in reverse
+// order, so the callbacks that were added first get executed last.
 // Author: Michael Lyashenko
 //============================================================================================================
 
@@ -19,24 +26,62 @@ public:
 
 	typedef FastDelegate<float (void)> Callback;
 
+	// Handles identify added callbacks and remain unique after the callback has been removed.
+	// Zero is never a valid handle.
+	typedef uint Handle;
+
 private:
 
 	struct UpdateEntry
 	{
-		float		time;
 		Callback	callback;
+		uint		serial;		// Changed every time the entry gets released, used to validate handles
+		uint		slot;		// Index within the list of callbacks executed every update, or INVALID_VAL
+		uint		timer;		// Handle on the timing wheel while the callback is waiting, '0' otherwise
+		bool		used;		// Whether the entry is in use
 	};
 
-	Array<UpdateEntry> mUpdate;
+	Array<UpdateEntry>	mEntries;	// All entries, used and unused
+	Array<uint>			mUnused;	// Indices of unused entries
+	Array<uint>			mFrame;		// Entries executed on every update, in the order they were added
+	uint				mGaps;		// Number of entries removed from 'mFrame' since it was last compacted
+	TimingWheel<Handle>	mWheel;		// Delayed entries, scheduled in milliseconds
+	Array<Handle>		mDue;		// Entries executed by the current update
+	Thread::Lockable	mLock;
 
 public:
 
+	UpdateList() : mGaps(0) {}
+
 	// Adds a new update function to the list, executed after an optional delay in seconds
-	void Add (const Callback& callback, float delay = 0.0f);
+	Handle Add (const Callback& callback, float delay = 0.0f);
 
 	// Removes the specified function from the list
 	void Remove (const Callback& callback);
 
+	// Removes the function added with the specified handle
+	void Remove (Handle handle);
+
+	// Number of callbacks in the list, including the delayed ones
+	uint GetSize() const { return mEntries.GetSize() - mUnused.GetSize(); }
+
 	// Runs through all update listeners and calls them as necessary
 	void Execute();
-};
\ No newline at end of file
+
+private:
+
+	// Whether the handle refers to a callback in the list
+	bool _IsValid (Handle handle) const;
+
+	// Schedules the entry to be executed after the specified delay in seconds
+	void _Schedule (uint index, float delay, ulong time);
+
+	// Takes the entry off the list of callbacks executed every update, or off the timing wheel
+	void _Unschedule (uint index);
+
+	// Closes the gaps left behind in the list of callbacks executed every update
+	void _Compact();
+
+	// Removes the entry from the list
+	void _Release (uint index);
+};
@@ -21,18 +21,21 @@
 namespace R5
 {
 	class Object;
+	class Script;
+	class Billboard;
 
 	#include "TemporaryStorage.h"		// Textures and render targets used in the draw process
-	#include "DrawGroup.h"				// Class managing an array of drawable objects
-	#include "DrawList.h"				// All drawable objects are separated by techniques into different lists
-	#include "DrawLayer.h"				// Drawable objects can be placed on different layers
-	#include "DrawQueue.h"				// Draw queue contains all 32 possible draw layers
+	#include "CommandList.h"			// Graphics calls recorded on one thread and replayed on another
+	#include "DrawQueue.h"				// Draw queue containing all visible objects, sorted by 64-bit keys
 
 	#include "RaycastHit.h"				// Struct used for raycasts
 	#include "Resource.h"				// TreeNode-based resource
 	#include "FillParams.h"				// Struct containing parameters passed during the 'fill visible geometry' stage
+	#include "ObjectPool.h"				// Cache-line aligned pools used to allocate Objects and Scripts
+	#include "ScriptRegistry.h"			// Per-phase lists of the scripts listening to update and fill callbacks
 	#include "Script.h"					// Scripts can be attached to game objects
 	#include "Object.h"					// Most basic game object
+	#include "TransformHierarchy.h"		// Flattened scene graph transforms, updated level by level
 	#include "ProjectedTexture.h"		// Projected texture object
 	#include "Decal.h"					// Multiple projected texture object
 
@@ -67,6 +70,7 @@ namespace R5
 
 	#include "QuadNode.h"				// Quadtree subdivided node, can be extended to create terrains
 	#include "QuadTree.h"				// Quadtree sub-divisioned scene object
+	#include "Heightfield.h"			// Compact heightfield with a min/max pyramid used for terrain queries
 	#include "TerrainNode.h"			// Sub-divisioned child of the Terrain class
 	#include "Terrain.h"				// Simple terrain implementation using QuadTree
 	#include "Octree.h"					// Octree-partitioned space
@@ -14,6 +14,34 @@ void Billboard::OnUpdate()
 	}
 }
 
+//============================================================================================================
+// Vertex streams shared by all billboards. Billboards are only ever drawn on the graphics thread.
+//============================================================================================================
+
+namespace
+{
+	struct BatchEntry
+	{
+		const ITexture*		mTex;
+		Billboard::Quad		mQuad;
+	};
+
+	char				g_batchParam = 0;	// Only its address is used
+	Array<BatchEntry>	g_entries;			// Quads of the billboards being drawn
+	Array<Vector3f>		g_positions;		// Expanded vertex positions
+	Array<Vector2f>		g_texCoords;		// Texture coordinates, identical for every quad
+	Array<Color4ub>		g_colors;			// Vertex colors
+}
+
+//============================================================================================================
+// Draw queue parameter that identifies batched billboards
+//============================================================================================================
+
+void* Billboard::GetBatchParam()
+{
+	return &g_batchParam;
+}
+
 //============================================================================================================
 // Add the billboard to the draw list
 //============================================================================================================
@@ -22,73 +50,147 @@ bool Billboard::OnFill (FillParams& params)
 {
 	if (mTex != 0 && mTech != 0)
 	{
-		// If we're writing to depth, use the texture for grouping. If not -- don't. This is done so because
-		// different billboards still need to blend correctly and the only way to do that is to sort all of
-		// them together, which wouldn't be possible if they ended up in different groups.
+		// Billboards are grouped by texture so that each group can be drawn with a single call. Blending that
+		// depends on the draw order still needs all billboards to be sorted together, which wouldn't be possible
+		// if they ended up in different groups, so in that case they remain groupless.
 
-		uint group = mTech->GetDepthWrite() ? mTex->GetUID() : 0;
-		params.mDrawQueue.Add(mLayer, this, 0, mTech->GetMask(), group, params.GetDist(mAbsolutePos));
+		uint blending = mTech->GetBlending();
+		bool orderless = mTech->GetDepthWrite() || blending == ITechnique::Blending::None ||
+			blending == ITechnique::Blending::Add;
+
+		uint group = orderless ? mTex->GetUID() : 0;
+		params.mDrawQueue.Add(mLayer, this, GetBatchParam(), mTech->GetMask(), group, params.GetDist(mAbsolutePos));
 	}
 	return true;
 }
 
 //============================================================================================================
-// Draw the billboard
+// Draw the billboard -- only used if the billboard was queued without the batch parameter
 //============================================================================================================
 
 uint Billboard::OnDraw (TemporaryStorage& storage, uint group, const ITechnique* tech, void* param, bool insideOut)
 {
-	IGraphics* graphics = mCore->GetGraphics();
-	Matrix43 mat (graphics->GetViewMatrix());
-	mat.PreTranslate(mAbsolutePos);
-	mat.ReplaceScaling(mAbsoluteScale);
-	graphics->SetModelViewMatrix(mat);
-	DrawBillboard();
-	graphics->ResetModelViewMatrix();
+	Billboard* self = this;
+	return DrawBatch(&self, 1);
+}
+
+//============================================================================================================
+// Fills the quad representing the billboard
+//============================================================================================================
+
+bool Billboard::OnFillQuad (IGraphics* graphics, Quad& quad)
+{
+	quad.mPos	= mAbsolutePos;
+	quad.mSize.Set(mAbsoluteScale.x, mAbsoluteScale.y);
+	quad.mColor = mColor;
+	return true;
+}
+
+//============================================================================================================
+// Draws the quads collected so far that use the specified texture
+//============================================================================================================
+
+uint DrawQuads (IGraphics* graphics, const ITexture* tex, uint first, uint last)
+{
+	if (first == last) return 0;
+
+	graphics->SetActiveMaterial(tex);
+	graphics->SetActiveVertexAttribute( IGraphics::Attribute::TexCoord0, g_texCoords.GetBuffer() + first * 4 );
+	graphics->SetActiveVertexAttribute( IGraphics::Attribute::Color,	 g_colors.GetBuffer()	 + first * 4 );
+	graphics->SetActiveVertexAttribute( IGraphics::Attribute::Vertex,	 g_positions.GetBuffer() + first * 4 );
+	graphics->DrawVertices (IGraphics::Primitive::Quad, (last - first) * 4);
 	return 1;
 }
 
 //============================================================================================================
-// Draws the actual billboard reusing the common buffers
+// Draws the billboards, combining all consecutive billboards that share the same texture into a single call
 //============================================================================================================
 
-void Billboard::DrawBillboard()
+uint Billboard::DrawBatch (Billboard* const* list, uint count)
 {
-	static float vertices[] =
+	if (count == 0) return 0;
+	IGraphics* graphics = list[0]->mCore->GetGraphics();
+
+	// Collect the quads first, as filling them may involve visibility queries
+	g_entries.Clear();
+
+	for (uint i = 0; i < count; ++i)
 	{
-		-1.0f,  1.0f,
-		-1.0f, -1.0f,
-		 1.0f, -1.0f,
-		 1.0f,  1.0f
-	};
+		Billboard* bb = list[i];
+
+		if (bb->mTex != 0)
+		{
+			BatchEntry& entry = g_entries.Expand();
+			entry.mTex = bb->mTex;
+			if (!bb->OnFillQuad(graphics, entry.mQuad)) g_entries.Shrink();
+		}
+	}
+
+	uint quads = g_entries.GetSize();
+	if (quads == 0) return 0;
 
-	static float texcoords[] =
+	// Quads are expanded along the camera's axes taken from the inverse view matrix
+	graphics->ResetModelViewMatrix();
+	const Matrix43& invView = graphics->GetInverseModelViewMatrix();
+	Vector3f axisX (invView[0], invView[1], invView[2]);
+	Vector3f axisY (invView[4], invView[5], invView[6]);
+
+	g_positions.Clear();
+	g_colors.Clear();
+	Vector3f* pos	= g_positions.ExpandTo(quads * 4);
+	Color4ub* color = g_colors.ExpandTo(quads * 4);
+
+	// Texture coordinates are the same for every quad, so they only need to be filled once
+	for (uint i = g_texCoords.GetSize() / 4; i < quads; ++i)
 	{
-		0.0f, 1.0f,
-		0.0f, 0.0f,
-		1.0f, 0.0f,
-		1.0f, 1.0f
-	};
+		g_texCoords.Expand().Set(0.0f, 1.0f);
+		g_texCoords.Expand().Set(0.0f, 0.0f);
+		g_texCoords.Expand().Set(1.0f, 0.0f);
+		g_texCoords.Expand().Set(1.0f, 1.0f);
+	}
+
+	for (uint i = 0; i < quads; ++i)
+	{
+		const Quad& quad = g_entries[i].mQuad;
+		Vector3f x (axisX * quad.mSize.x);
+		Vector3f y (axisY * quad.mSize.y);
+		Vector3f a (x + y), b (x - y);
+
+		pos[0] = quad.mPos - b;
+		pos[1] = quad.mPos - a;
+		pos[2] = quad.mPos + b;
+		pos[3] = quad.mPos + a;
+		pos += 4;
+
+		color[0] = quad.mColor;
+		color[1] = quad.mColor;
+		color[2] = quad.mColor;
+		color[3] = quad.mColor;
+		color += 4;
+	}
 
 	// Set up active render states
-	IGraphics* graphics = mCore->GetGraphics();
 	graphics->SetAlphaCutoff();
 	graphics->SetActiveShader(0);
-	graphics->SetActiveMaterial(mTex);
-
-	// Set the buffers
-	graphics->SetActiveVertexAttribute( IGraphics::Attribute::Color,	  0 );
 	graphics->SetActiveVertexAttribute( IGraphics::Attribute::Normal,	  0 );
 	graphics->SetActiveVertexAttribute( IGraphics::Attribute::Tangent,	  0 );
 	graphics->SetActiveVertexAttribute( IGraphics::Attribute::BoneIndex,  0 );
 	graphics->SetActiveVertexAttribute( IGraphics::Attribute::BoneWeight, 0 );
 	graphics->SetActiveVertexAttribute( IGraphics::Attribute::TexCoord1,  0 );
-	graphics->SetActiveVertexAttribute( IGraphics::Attribute::TexCoord0, (Vector2f*)texcoords );
-	graphics->SetActiveVertexAttribute( IGraphics::Attribute::Vertex,	 (Vector2f*)vertices );
-	graphics->SetActiveColor(mColor);
 
-	// Draw the glow
-	graphics->DrawVertices (IGraphics::Primitive::Quad, 4);
+	// Draw each run of quads sharing the same texture with a single call
+	uint drawn = 0, first = 0;
+
+	for (uint i = 1; i < quads; ++i)
+	{
+		if (g_entries[i].mTex != g_entries[first].mTex)
+		{
+			drawn += DrawQuads(graphics, g_entries[first].mTex, first, i);
+			first = i;
+		}
+	}
+	drawn += DrawQuads(graphics, g_entries[first].mTex, first, quads);
+	return drawn;
 }
 
 //============================================================================================================
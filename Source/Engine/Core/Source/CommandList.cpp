@@ -0,0 +1,783 @@
+#include "../Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Resource management calls are forwarded to the target one thread at a time
+//============================================================================================================
+
+Thread::Lockable g_targetLock;
+
+#define FORWARD(call)	g_targetLock.Lock(); call; g_targetLock.Unlock();
+
+//============================================================================================================
+
+R5_THREAD_LOCAL CommandList* CommandList::mActive = 0;
+
+//============================================================================================================
+// Returns the number of triangles drawn using the specified number of indices
+//============================================================================================================
+
+inline uint CountTriangles (uint primitive, uint indices)
+{
+	switch (primitive)
+	{
+		case IGraphics::Primitive::Triangle:		return indices / 3;
+		case IGraphics::Primitive::TriangleStrip:	return indices > 1 ? indices - 2 : 0;
+		case IGraphics::Primitive::Quad:			return indices / 2;
+		case IGraphics::Primitive::QuadStrip:		return indices > 1 ? indices - 2 : 0;
+		case IGraphics::Primitive::TriangleFan:		return indices > 1 ? indices - 2 : 0;
+		case IGraphics::Primitive::Line:			return indices / 2;
+		case IGraphics::Primitive::LineStrip:		return indices > 0 ? indices - 1 : 0;
+		case IGraphics::Primitive::Point:			return indices;
+	}
+	return 0;
+}
+
+//============================================================================================================
+
+CommandList::CommandList() :
+	mTarget			(0),
+	mFog			(false),
+	mDepthWrite		(false),
+	mDepthTest		(false),
+	mAlphaTest		(false),
+	mStencilTest	(false),
+	mScissorTest	(false),
+	mWireframe		(false),
+	mModelSet		(false),
+	mLighting		(0),
+	mBlending		(0),
+	mCulling		(0),
+	mAdt			(0.0f),
+	mThickness		(1.0f),
+	mDepthOffset	(0),
+	mAf				(0),
+	mRenderTarget	(0),
+	mTechnique		(0),
+	mMaterial		(0),
+	mShader			(0),
+	mSkybox			(0) {}
+
+//============================================================================================================
+// Starts recording on the calling thread, copying the current state of the specified graphics
+//============================================================================================================
+
+void CommandList::Begin (IGraphics* target)
+{
+	ASSERT(mActive == 0, "The thread is already recording into a command list");
+	mActive = this;
+	mTarget = target;
+	Reset();
+
+	mFog			= target->GetFog();
+	mDepthWrite		= target->GetDepthWrite();
+	mDepthTest		= target->GetDepthTest();
+	mAlphaTest		= target->GetAlphaTest();
+	mStencilTest	= target->GetStencilTest();
+	mScissorTest	= target->GetScissorTest();
+	mWireframe		= target->GetWireframe();
+	mLighting		= target->GetLighting();
+	mBlending		= target->GetBlending();
+	mCulling		= target->GetCulling();
+	mAdt			= target->GetAlphaCutoff();
+	mThickness		= target->GetThickness();
+	mDepthOffset	= target->GetDepthOffset();
+	mAf				= target->GetDefaultAF();
+	mViewport		= target->GetActiveViewport();
+	mScissorRect	= target->GetScissorRect();
+	mFogRange		= target->GetFogRange();
+	mBackground		= target->GetBackgroundColor();
+	mCamPos			= target->GetCameraPosition();
+	mCamDir			= target->GetCameraDirection();
+	mCamUp			= target->GetCameraUpVector();
+	mCamRange		= target->GetCameraRange();
+	mCamBounds		= target->GetCameraNearBounds();
+	mRenderTarget	= target->GetActiveRenderTarget();
+	mTechnique		= target->GetActiveTechnique();
+	mSkybox			= target->GetActiveSkybox();
+
+	// The material is unknown, as the target may have moved on by the time the commands get replayed.
+	// This also ensures that SetActiveMaterial() always records the material and returns the same value
+	// that the target will return when the commands get replayed.
+	mMaterial		= 0;
+	mShader			= target->GetActiveShader();
+
+	// The model matrix is also unknown, and objects are expected to set it before drawing
+	mModelSet		= false;
+	mModel.SetToIdentity();
+	mDefaultView	= target->GetViewMatrix();
+	mDefaultProj	= target->GetProjectionMatrix();
+	mView			= mDefaultView;
+	mProj			= mDefaultProj;
+
+	for (uint i = 0; i < 8; ++i) mLights[i] = target->GetActiveLight(i);
+}
+
+//============================================================================================================
+// Stops recording on the calling thread
+//============================================================================================================
+
+void CommandList::End()
+{
+	ASSERT(mActive == this, "The thread is not recording into this command list");
+	mActive = 0;
+}
+
+//============================================================================================================
+// Stores data that doesn't fit into the command, returning its offset
+//============================================================================================================
+
+uint CommandList::_Store (const float* data, uint count)
+{
+	uint offset = mData.GetSize();
+	memcpy(mData.ExpandTo(offset + count) + offset, data, sizeof(float) * count);
+	return offset;
+}
+
+//============================================================================================================
+// Executes all recorded commands on the graphics the recording was started with
+//============================================================================================================
+
+void CommandList::Replay()
+{
+	IGraphics* g = mTarget;
+	const float* data = mData.GetBuffer();
+
+	for (uint i = 0, imax = mCommands.GetSize(); i < imax; ++i)
+	{
+		const Command& cmd = mCommands[i];
+		const uint* v = cmd.mValue;
+		const float* f = cmd.mFloat;
+
+		switch (cmd.mType)
+		{
+			case Command::Fog:					g->SetFog(v[0] != 0);								break;
+			case Command::DepthWrite:			g->SetDepthWrite(v[0] != 0);						break;
+			case Command::DepthTest:			g->SetDepthTest(v[0] != 0);							break;
+			case Command::ColorWrite:			g->SetColorWrite(v[0] != 0);						break;
+			case Command::AlphaTest:			g->SetAlphaTest(v[0] != 0);							break;
+			case Command::StencilTest:			g->SetStencilTest(v[0] != 0);						break;
+			case Command::ScissorTest:			g->SetScissorTest(v[0] != 0);						break;
+			case Command::Wireframe:			g->SetWireframe(v[0] != 0);							break;
+			case Command::Lighting:				g->SetLighting(v[0]);								break;
+			case Command::Blending:				g->SetBlending(v[0]);								break;
+			case Command::Culling:				g->SetCulling(v[0]);								break;
+			case Command::AlphaCutoff:			g->SetAlphaCutoff(f[0]);							break;
+			case Command::Thickness:			g->SetThickness(f[0]);								break;
+			case Command::DepthOffset:			g->SetDepthOffset(v[0]);							break;
+			case Command::DefaultAF:			g->SetDefaultAF(v[0]);								break;
+			case Command::Viewport:				g->SetViewport( Vector2i((int)v[0], (int)v[1]) );	break;
+			case Command::FogRange:				g->SetFogRange( Vector2f(f[0], f[1]) );				break;
+			case Command::BackgroundColor:		g->SetBackgroundColor( Color4f(f[0], f[1], f[2], f[3]) );	break;
+
+			case Command::ScissorRect:
+			{
+				Rect rect;
+				rect.left	= (int)v[0];
+				rect.right	= (int)v[1];
+				rect.top	= (int)v[2];
+				rect.bottom	= (int)v[3];
+				g->SetScissorRect(rect);
+			}
+			break;
+
+			case Command::Light:				g->SetActiveLight(v[0], (const ILight*)cmd.mPtr[0]);			break;
+			case Command::ModelMatrix:			g->SetModelMatrix( *(const Matrix43*)(data + v[0]) );			break;
+			case Command::ResetModelMatrix:		g->ResetModelMatrix();											break;
+			case Command::ViewMatrix:			g->SetViewMatrix( *(const Matrix43*)(data + v[0]) );			break;
+			case Command::ResetViewMatrix:		g->ResetViewMatrix();											break;
+			case Command::ProjectionMatrix:		g->SetProjectionMatrix( *(const Matrix44*)(data + v[0]) );		break;
+			case Command::ResetProjectionMatrix:g->ResetProjectionMatrix();										break;
+			case Command::CameraRange:			g->SetCameraRange( Vector3f(f[0], f[1], f[2]) );				break;
+
+			case Command::CameraOrientation:
+			{
+				const float* p = data + v[0];
+				g->SetCameraOrientation( Vector3f(p[0], p[1], p[2]), Vector3f(p[3], p[4], p[5]),
+					Vector3f(p[6], p[7], p[8]) );
+			}
+			break;
+
+			case Command::RenderTarget:			g->SetActiveRenderTarget((const IRenderTarget*)cmd.mPtr[0]);	break;
+			case Command::Technique:			g->SetActiveTechnique((const ITechnique*)cmd.mPtr[0], v[0] != 0); break;
+			case Command::Material:				g->SetActiveMaterial((const IMaterial*)cmd.mPtr[0]);			break;
+			case Command::MaterialTexture:		g->SetActiveMaterial((const ITexture*)cmd.mPtr[0]);				break;
+			case Command::Shader:				g->SetActiveShader((const IShader*)cmd.mPtr[0]);				break;
+			case Command::Skybox:				g->SetActiveSkybox((const ITexture*)cmd.mPtr[0]);				break;
+			case Command::Color:				g->SetActiveColor( Color4f(f[0], f[1], f[2], f[3]) );			break;
+			case Command::ScreenProjection:		g->SetScreenProjection(v[0] != 0);								break;
+			case Command::VBO:					g->SetActiveVBO((const IVBO*)cmd.mPtr[0], v[0]);				break;
+			case Command::Texture:				g->SetActiveTexture(v[0], (const ITexture*)cmd.mPtr[0]);		break;
+			case Command::DepthFunction:		g->SetActiveDepthFunction(v[0]);								break;
+			case Command::StencilFunction:		g->SetActiveStencilFunction(v[0], v[1], v[2]);					break;
+			case Command::StencilOperation:		g->SetActiveStencilOperation(v[0], v[1], v[2]);					break;
+
+			case Command::VertexAttribute:
+				g->SetActiveVertexAttribute(v[0], (const IVBO*)cmd.mPtr[0], cmd.mPtr[1], v[1], v[2], v[3]);
+			break;
+
+			case Command::PrepareToDraw:		g->PrepareToDraw();												break;
+			case Command::DrawVertices:			g->DrawVertices(v[0], v[1]);									break;
+			case Command::DrawIndices:			g->DrawIndices((const IVBO*)cmd.mPtr[0], v[0], v[1]);			break;
+			case Command::DrawShortIndices:		g->DrawIndices((const ushort*)cmd.mPtr[0], v[0], v[1]);			break;
+			case Command::DrawTypedIndices:		g->DrawIndices((const IVBO*)cmd.mPtr[0], v[0], v[1], v[2]);		break;
+			case Command::DrawIntIndices:		g->DrawIndices((const uint*)cmd.mPtr[0], v[0], v[1]);			break;
+			case Command::Drawable:				g->Draw(v[0]);													break;
+			case Command::Clear:				g->Clear(v[0] != 0, v[1] != 0, v[2] != 0);						break;
+			case Command::Delayed:				g->ExecuteBeforeNextFrame(mDelayed[v[0]].mCallback, mDelayed[v[0]].mParam); break;
+			case Command::Flush:				g->Flush();														break;
+		}
+	}
+}
+
+//============================================================================================================
+// State control functions that don't fit into a single line
+//============================================================================================================
+
+void CommandList::SetViewport (const Vector2i& size)
+{
+	Command& cmd = _Add(Command::Viewport);
+	cmd.mValue[0] = (uint)size.x;
+	cmd.mValue[1] = (uint)size.y;
+	mViewport = size;
+}
+
+//============================================================================================================
+
+void CommandList::SetScissorRect (const Rect& rect)
+{
+	Command& cmd = _Add(Command::ScissorRect);
+	cmd.mValue[0] = (uint)rect.left;
+	cmd.mValue[1] = (uint)rect.right;
+	cmd.mValue[2] = (uint)rect.top;
+	cmd.mValue[3] = (uint)rect.bottom;
+	mScissorRect = rect;
+}
+
+//============================================================================================================
+
+void CommandList::SetFogRange (const Vector2f& range)
+{
+	Command& cmd = _Add(Command::FogRange);
+	cmd.mFloat[0] = range.x;
+	cmd.mFloat[1] = range.y;
+	mFogRange = range;
+}
+
+//============================================================================================================
+
+void CommandList::SetBackgroundColor (const Color4f& color)
+{
+	Command& cmd = _Add(Command::BackgroundColor);
+	for (uint i = 0; i < 4; ++i) cmd.mFloat[i] = color[i];
+	mBackground = color;
+}
+
+//============================================================================================================
+// Lights are referenced rather than copied, so they must remain valid until the commands get replayed
+//============================================================================================================
+
+void CommandList::SetActiveLight (uint index, const ILight* ptr)
+{
+	Command& cmd = _Add(Command::Light);
+	cmd.mValue[0] = index;
+	cmd.mPtr[0] = ptr;
+
+	if (index < 8)
+	{
+		if (ptr != 0) mLights[index] = *ptr;
+		else mLights[index].mType = ILight::Type::Invalid;
+	}
+}
+
+//============================================================================================================
+// Derived matrices get calculated the same way GLTransform calculates them
+//============================================================================================================
+
+const Matrix43& CommandList::GetModelViewMatrix()
+{
+	if (!mModelSet) return mView;
+	mMV = mModel * mView;
+	return mMV;
+}
+
+//============================================================================================================
+
+const Matrix44& CommandList::GetModelViewProjMatrix()
+{
+	mMVP = GetModelViewMatrix() * mProj;
+	return mMVP;
+}
+
+//============================================================================================================
+
+const Matrix43& CommandList::GetInverseModelViewMatrix()
+{
+	mIMV = GetModelViewMatrix();
+	mIMV.Invert();
+	return mIMV;
+}
+
+//============================================================================================================
+
+const Matrix44& CommandList::GetInverseProjMatrix()
+{
+	mIP = mProj;
+	mIP.Invert();
+	return mIP;
+}
+
+//============================================================================================================
+
+const Matrix44& CommandList::GetInverseMVPMatrix()
+{
+	mIMVP = GetModelViewProjMatrix();
+	mIMVP.Invert();
+	return mIMVP;
+}
+
+//============================================================================================================
+// Matrix manipulation
+//============================================================================================================
+
+void CommandList::SetModelMatrix (const Matrix43& mat)
+{
+	_Add(Command::ModelMatrix).mValue[0] = _Store(&mat[0], 16);
+	mModel = mat;
+	mModelSet = true;
+}
+
+//============================================================================================================
+
+void CommandList::ResetModelMatrix()
+{
+	_Add(Command::ResetModelMatrix);
+	mModel.SetToIdentity();
+	mModelSet = false;
+}
+
+//============================================================================================================
+
+void CommandList::SetViewMatrix (const Matrix43& mat)
+{
+	_Add(Command::ViewMatrix).mValue[0] = _Store(&mat[0], 16);
+	mView = mat;
+}
+
+//============================================================================================================
+
+void CommandList::ResetViewMatrix()
+{
+	_Add(Command::ResetViewMatrix);
+	mView = mDefaultView;
+}
+
+//============================================================================================================
+
+void CommandList::SetProjectionMatrix (const Matrix44& mat)
+{
+	_Add(Command::ProjectionMatrix).mValue[0] = _Store(&mat[0], 16);
+	mProj = mat;
+}
+
+//============================================================================================================
+
+void CommandList::ResetProjectionMatrix()
+{
+	_Add(Command::ResetProjectionMatrix);
+	mProj = mDefaultProj;
+}
+
+//============================================================================================================
+
+void CommandList::SetCameraOrientation (const Vector3f& eye, const Vector3f& dir, const Vector3f& up)
+{
+	float data[9] = { eye.x, eye.y, eye.z, dir.x, dir.y, dir.z, up.x, up.y, up.z };
+	_Add(Command::CameraOrientation).mValue[0] = _Store(data, 9);
+	mCamPos = eye;
+	mCamDir = dir;
+	mCamUp	= up;
+}
+
+//============================================================================================================
+
+void CommandList::SetCameraRange (const Vector3f& range)
+{
+	Command& cmd = _Add(Command::CameraRange);
+	cmd.mFloat[0] = range.x;
+	cmd.mFloat[1] = range.y;
+	cmd.mFloat[2] = range.z;
+	mCamRange = range;
+}
+
+//============================================================================================================
+// Active object control
+//============================================================================================================
+
+void CommandList::SetActiveRenderTarget (const IRenderTarget* tar)
+{
+	_Add(Command::RenderTarget).mPtr[0] = tar;
+	mRenderTarget = tar;
+	mViewport = (tar != 0) ? tar->GetSize() : mTarget->GetViewport();
+}
+
+//============================================================================================================
+
+void CommandList::SetActiveTechnique (const ITechnique* ptr, bool insideOut)
+{
+	Command& cmd = _Add(Command::Technique);
+	cmd.mPtr[0] = ptr;
+	cmd.mValue[0] = insideOut;
+	mTechnique = ptr;
+	mMaterial = 0;
+}
+
+//============================================================================================================
+// Mirrors the controller's logic: the material is only considered active if it's visible with the technique
+//============================================================================================================
+
+bool CommandList::SetActiveMaterial (const IMaterial* ptr)
+{
+	_Add(Command::Material).mPtr[0] = ptr;
+
+	if (mMaterial != ptr)
+	{
+		const IMaterial::DrawMethod* method = (ptr != 0 && mTechnique != 0) ? ptr->GetVisibleMethod(mTechnique) : 0;
+
+		if (method == 0)
+		{
+			mShader = 0;
+			return false;
+		}
+
+		mMaterial = ptr;
+		mShader = method->mShader;
+	}
+	return true;
+}
+
+//============================================================================================================
+
+bool CommandList::SetActiveMaterial (const ITexture* ptr)
+{
+	_Add(Command::MaterialTexture).mPtr[0] = ptr;
+	mMaterial = 0;
+	mShader = 0;
+	return true;
+}
+
+//============================================================================================================
+
+bool CommandList::SetActiveShader (const IShader* ptr)
+{
+	_Add(Command::Shader).mPtr[0] = ptr;
+	mShader = ptr;
+	return true;
+}
+
+//============================================================================================================
+
+void CommandList::SetActiveSkybox (const ITexture* ptr)
+{
+	_Add(Command::Skybox).mPtr[0] = ptr;
+	mSkybox = ptr;
+}
+
+//============================================================================================================
+
+void CommandList::SetActiveColor (const Color& c)
+{
+	Command& cmd = _Add(Command::Color);
+	const Color4f& color = c.GetColor4f();
+	for (uint i = 0; i < 4; ++i) cmd.mFloat[i] = color[i];
+}
+
+//============================================================================================================
+
+void CommandList::SetScreenProjection (bool screen)
+{
+	_Add(Command::ScreenProjection).mValue[0] = screen;
+}
+
+//============================================================================================================
+
+void CommandList::SetActiveVBO (const IVBO* vbo, uint type)
+{
+	Command& cmd = _Add(Command::VBO);
+	cmd.mPtr[0] = vbo;
+	cmd.mValue[0] = type;
+}
+
+//============================================================================================================
+
+void CommandList::SetActiveTexture (uint textureUnit, const ITexture* ptr)
+{
+	Command& cmd = _Add(Command::Texture);
+	cmd.mPtr[0] = ptr;
+	cmd.mValue[0] = textureUnit;
+}
+
+//============================================================================================================
+
+void CommandList::SetActiveDepthFunction (uint condition)
+{
+	_Add(Command::DepthFunction).mValue[0] = condition;
+}
+
+//============================================================================================================
+
+void CommandList::SetActiveStencilFunction (uint condition, uint val, uint mask)
+{
+	Command& cmd = _Add(Command::StencilFunction);
+	cmd.mValue[0] = condition;
+	cmd.mValue[1] = val;
+	cmd.mValue[2] = mask;
+}
+
+//============================================================================================================
+
+void CommandList::SetActiveStencilOperation (uint testFail, uint depthFail, uint pass)
+{
+	Command& cmd = _Add(Command::StencilOperation);
+	cmd.mValue[0] = testFail;
+	cmd.mValue[1] = depthFail;
+	cmd.mValue[2] = pass;
+}
+
+//============================================================================================================
+// Memory passed as vertex attributes must remain valid until the commands get replayed
+//============================================================================================================
+
+void CommandList::SetActiveVertexAttribute (uint attribute, const IVBO* vbo, const void* ptr,
+	uint dataType, uint elements, uint stride)
+{
+	Command& cmd = _Add(Command::VertexAttribute);
+	cmd.mValue[0] = attribute;
+	cmd.mValue[1] = dataType;
+	cmd.mValue[2] = elements;
+	cmd.mValue[3] = stride;
+	cmd.mPtr[0] = vbo;
+	cmd.mPtr[1] = ptr;
+}
+
+//============================================================================================================
+// Draw calls
+//============================================================================================================
+
+uint CommandList::DrawVertices (uint primitive, uint vertexCount)
+{
+	Command& cmd = _Add(Command::DrawVertices);
+	cmd.mValue[0] = primitive;
+	cmd.mValue[1] = vertexCount;
+	return CountTriangles(primitive, vertexCount);
+}
+
+//============================================================================================================
+
+uint CommandList::DrawIndices (const IVBO* vbo, uint primitive, uint indexCount)
+{
+	Command& cmd = _Add(Command::DrawIndices);
+	cmd.mPtr[0] = vbo;
+	cmd.mValue[0] = primitive;
+	cmd.mValue[1] = indexCount;
+	return CountTriangles(primitive, indexCount);
+}
+
+//============================================================================================================
+
+uint CommandList::DrawIndices (const ushort* indices, uint primitive, uint indexCount)
+{
+	Command& cmd = _Add(Command::DrawShortIndices);
+	cmd.mPtr[0] = indices;
+	cmd.mValue[0] = primitive;
+	cmd.mValue[1] = indexCount;
+	return CountTriangles(primitive, indexCount);
+}
+
+//============================================================================================================
+
+uint CommandList::DrawIndices (const IVBO* vbo, uint primitive, uint indexCount, uint dataType)
+{
+	Command& cmd = _Add(Command::DrawTypedIndices);
+	cmd.mPtr[0] = vbo;
+	cmd.mValue[0] = primitive;
+	cmd.mValue[1] = indexCount;
+	cmd.mValue[2] = dataType;
+	return CountTriangles(primitive, indexCount);
+}
+
+//============================================================================================================
+
+uint CommandList::DrawIndices (const uint* indices, uint primitive, uint indexCount)
+{
+	Command& cmd = _Add(Command::DrawIntIndices);
+	cmd.mPtr[0] = indices;
+	cmd.mValue[0] = primitive;
+	cmd.mValue[1] = indexCount;
+	return CountTriangles(primitive, indexCount);
+}
+
+//============================================================================================================
+
+uint CommandList::Draw (uint drawable)
+{
+	_Add(Command::Drawable).mValue[0] = drawable;
+	return 1;
+}
+
+//============================================================================================================
+
+void CommandList::Clear (bool color, bool depth, bool stencil)
+{
+	Command& cmd = _Add(Command::Clear);
+	cmd.mValue[0] = color;
+	cmd.mValue[1] = depth;
+	cmd.mValue[2] = stencil;
+}
+
+//============================================================================================================
+// Visibility tests can't be requested while recording, as the target may be drawing on another thread.
+// Points outside of the view frustum can't be visible, and the rest are assumed to be visible.
+//============================================================================================================
+
+bool CommandList::IsPointVisible (uint id, const Vector3f& v)
+{
+	// Same matrices as used by the real test, so the state matches once the commands get replayed
+	ResetModelMatrix();
+	ResetViewMatrix();
+
+	const Matrix44& mvp = GetModelViewProjMatrix();
+	float w = v.x * mvp[3] + v.y * mvp[7] + v.z * mvp[11] + mvp[15];
+	Vector3f ndc (v * mvp);
+
+	return (w > 0.0f && ndc.x >= -1.0f && ndc.x <= 1.0f && ndc.y >= -1.0f && ndc.y <= 1.0f &&
+		ndc.z >= -1.0f && ndc.z <= 1.0f);
+}
+
+//============================================================================================================
+// Nothing has been drawn yet, so there is nothing to read
+//============================================================================================================
+
+Color4f CommandList::ReadColor (const Vector2i& pos)
+{
+	ASSERT(mActive == 0, "Colors can't be read while recording");
+	return Color4f();
+}
+
+//============================================================================================================
+// The depth buffer can't be read either, so the depth is the far plane just like with the null graphics
+//============================================================================================================
+
+Vector3f CommandList::ConvertTo3D (const Vector2i& pos, bool unproject)
+{
+	ASSERT(mActive == 0, "Depth can't be read while recording");
+
+	const Vector2i& size = mViewport;
+	Vector3f out ((float)pos.x / size.x, (float)(size.y - pos.y) / size.y, 1.0f);
+	if (unproject) out = GetInverseMVPMatrix().Unproject(out);
+	return out;
+}
+
+//============================================================================================================
+// Converts world coordinates to screen coordinates using the mirrored matrices
+//============================================================================================================
+
+Vector2i CommandList::ConvertTo2D (const Vector3f& pos)
+{
+	const Vector2i& size = mViewport;
+	Vector2i out  ( GetModelViewProjMatrix().Project(pos) * size );
+	out.y = size.y - out.y;
+	return out;
+}
+
+//============================================================================================================
+// Delayed callbacks are passed on to the target when the commands get replayed
+//============================================================================================================
+
+void CommandList::ExecuteBeforeNextFrame (const DelayedDelegate& callback, void* param)
+{
+	DelayedEntry& entry = mDelayed.Expand();
+	entry.mCallback = callback;
+	entry.mParam	= param;
+	_Add(Command::Delayed).mValue[0] = mDelayed.GetSize() - 1;
+}
+
+//============================================================================================================
+// Resource management is forwarded to the target
+//============================================================================================================
+
+IVBO* CommandList::CreateVBO()
+{
+	IVBO* retVal;
+	FORWARD(retVal = mTarget->CreateVBO());
+	return retVal;
+}
+
+//============================================================================================================
+
+ITexture* CommandList::CreateRenderTexture (const char* name)
+{
+	ITexture* retVal;
+	FORWARD(retVal = mTarget->CreateRenderTexture(name));
+	return retVal;
+}
+
+//============================================================================================================
+
+IRenderTarget* CommandList::CreateRenderTarget()
+{
+	IRenderTarget* retVal;
+	FORWARD(retVal = mTarget->CreateRenderTarget());
+	return retVal;
+}
+
+//============================================================================================================
+
+void CommandList::DeleteVBO (const IVBO* ptr)					{ FORWARD(mTarget->DeleteVBO(ptr)); }
+void CommandList::DeleteTexture (const ITexture* ptr)			{ FORWARD(mTarget->DeleteTexture(ptr)); }
+void CommandList::DeleteRenderTarget (const IRenderTarget* ptr)	{ FORWARD(mTarget->DeleteRenderTarget(ptr)); }
+
+//============================================================================================================
+
+ITechnique* CommandList::GetTechnique (const String& name, bool createIfMissing)
+{
+	ITechnique* retVal;
+	FORWARD(retVal = mTarget->GetTechnique(name, createIfMissing));
+	return retVal;
+}
+
+//============================================================================================================
+
+IMaterial* CommandList::GetMaterial (const String& name, bool createIfMissing)
+{
+	IMaterial* retVal;
+	FORWARD(retVal = mTarget->GetMaterial(name, createIfMissing));
+	return retVal;
+}
+
+//============================================================================================================
+
+ITexture* CommandList::GetTexture (const String& name, bool createIfMissing)
+{
+	ITexture* retVal;
+	FORWARD(retVal = mTarget->GetTexture(name, createIfMissing));
+	return retVal;
+}
+
+//============================================================================================================
+
+IShader* CommandList::GetShader (const String& name, bool createIfMissing)
+{
+	IShader* retVal;
+	FORWARD(retVal = mTarget->GetShader(name, createIfMissing));
+	return retVal;
+}
+
+//============================================================================================================
+
+IFont* CommandList::GetFont (const String& name, bool createIfMissing)
+{
+	IFont* retVal;
+	FORWARD(retVal = mTarget->GetFont(name, createIfMissing));
+	return retVal;
+}
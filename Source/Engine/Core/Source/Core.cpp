@@ -23,11 +23,17 @@ R5_THREAD_FUNCTION(SerializeResourceThread, ptr)
 	System::Log("[THREAD]  Executing '%s' [ID: %u]", resource->GetName().GetBuffer(), threadId);
 #endif
 
+	Profiler::SetThreadName("Loader");
+
 	Core* core = resource->GetCore();
 	core->Lock();
-	core->SerializeFrom( resource->GetName(), false, false );
+	{
+		R5_PROFILE("Core::SerializeResource");
+		core->SerializeFrom( resource->GetName(), false, false );
+	}
 	core->Unlock();
 	core->DecrementThreadCount();
+	Profiler::Detach();
 
 #ifdef _DEBUG
 	System::Log("[THREAD]  Finished executing '%s' in %u ms [ID: %u]",
@@ -97,6 +103,8 @@ void Core::Init()
 	// Remember the thread ID
 	mThreadID = Thread::GetID();
 	mThreadCount = 0;
+	mFlatUpdate = false;
+	Profiler::SetThreadName("Main");
 
 	// Root of the scene needs to know who owns it
 	mRoot.mCore = this;
@@ -123,7 +131,9 @@ void Core::Init()
 void Core::Release()
 {
 	Lock();
+	mHierarchy.Release();
 	mRoot.Release();
+	mScripts.Release();
 	Unlock();
 
 	mMeshes.Lock();
@@ -187,6 +197,7 @@ bool Core::Update()
 				// Update all props and models
 				Lock();
 				{
+					R5_PROFILE("Core::UpdateModels");
 					mModels.Lock();
 					{
 						for (uint i = mModels.GetSize(); i > 0; )
@@ -205,13 +216,31 @@ bool Core::Update()
 			}
 
 			// Pre-update callbacks
-			mPreList.Execute();
+			{
+				R5_PROFILE("Core::PreUpdate");
+				mPreList.Execute();
+			}
 
 			// Update the entire scene
 			if (mRoot.GetFlag(Object::Flag::Enabled))
 			{
 				Lock();
-				mRoot.Update(Vector3f(), Quaternion(), 1.0f, false);
+				{
+					R5_PROFILE("Core::UpdateScene");
+
+					// Scripts that are due to wake up should be updated along with the rest
+					mScripts.Update(Time::GetMilliseconds());
+
+					if (mFlatUpdate) mHierarchy.Update(&mRoot);
+					else mRoot.Update(Vector3f(), Quaternion(), 1.0f, false);
+				}
+
+				// Particle emitters queued during the update get simulated all at once
+				if (mEmitters.IsValid())
+				{
+					Emitter::_Simulate(mEmitters);
+					mEmitters.Clear();
+				}
 				Unlock();
 			}
 			else
@@ -220,18 +249,26 @@ bool Core::Update()
 			}
 
 			// Post-update callbacks
-			mPostList.Execute();
+			{
+				R5_PROFILE("Core::PostUpdate");
+				mPostList.Execute();
+			}
 
 			// The UI should only be updated if the window is not minimized
 			if (mUI != 0 && !minimized) mUI->Update();
 
 			// Post-GUI updates
-			mLateList.Execute();
+			{
+				R5_PROFILE("Core::LateUpdate");
+				mLateList.Execute();
+			}
 		}
 
 		// If the window is not minimized, start the drawing process
 		if (!minimized)
 		{
+			R5_PROFILE("Core::Draw");
+
 			// Start the drawing process
 			mWin->BeginFrame();
 			if (mGraphics != 0)	mGraphics->BeginFrame();
@@ -241,6 +278,7 @@ bool Core::Update()
 			// Trigger all registered draw callbacks
 			if (mRoot.GetFlag(Object::Flag::Enabled))
 			{
+				R5_PROFILE("Core::DrawScene");
 				Lock();
 				drawn = HandleOnDraw();
 				Unlock();
@@ -258,13 +296,22 @@ bool Core::Update()
 			if (mUI != 0) mUI->Draw();
 
 			// Finish the drawing process
-			if (mGraphics != 0)	mGraphics->EndFrame();
-			mWin->EndFrame();
+			{
+				R5_PROFILE("Core::EndFrame");
+				if (mGraphics != 0)	mGraphics->EndFrame();
+				mWin->EndFrame();
+			}
 
 			// Increment the framerate
 			Time::IncrementFPS();
 		}
 
+		// Everything allocated from the frame arenas during this frame is no longer needed
+		FrameArena::NextFrame();
+
+		// Collect the zones recorded by all threads during this frame
+		Profiler::NextFrame();
+
 		// Sleep the thread, letting others run in the background
 		Thread::Sleep(mFullDraw > 0 ? mSleepDelay : mUISleepDelay);
 		return true;
@@ -562,6 +609,52 @@ bool Core::SerializeTo (TreeNode& root, bool window, bool graphics, bool ui) con
 	return true;
 }
 
+//============================================================================================================
+// Tags recognized by Core::SerializeFrom(), in the same order as the values below
+//============================================================================================================
+
+struct CoreTag
+{
+	enum
+	{
+		Core,
+		Window,
+		Graphics,
+		UI,
+		Scene,
+		Mesh,
+		Cloud,
+		Skeleton,
+		ModelTemplate,
+		Model,
+		Serializable,
+		Sleep,
+		SerializeFrom,
+		Execute,
+	};
+};
+
+const char* g_coreTags[] =
+{
+	"Core",
+	"Window",
+	"Graphics",
+	"UI",
+	"Scene",
+	"Mesh",
+	"Cloud",
+	"Skeleton",
+	"ModelTemplate",
+	"Model",
+	"Serializable",
+	"Sleep",
+	"Serialize From",
+	"Execute",
+	0
+};
+
+TagMap g_coreTagMap (g_coreTags);
+
 //============================================================================================================
 // Serialization -- Load
 //============================================================================================================
@@ -574,111 +667,127 @@ bool Core::SerializeFrom (const TreeNode& root, bool forceUpdate, bool createThr
 	bool retVal = true;
 	bool serializable = true;
 
-	for (uint i = 0; i < root.mChildren.GetSize(); ++i)
+	for (uint i = 0; i < root.mChildren.GetSize() && retVal; ++i)
 	{
 		const TreeNode& node	= root.mChildren[i];
-		const String&	tag		= node.mTag;
 		const Variable&	value	= node.mValue;
 
-		if (tag == Core::ClassName())
+		switch (g_coreTagMap[node])
 		{
-			// SerializeFrom only returns 'false' if something important failed
-			if ( !SerializeFrom(node, forceUpdate, createThreads) )
+			case CoreTag::Core:
 			{
-				retVal = false;
-				break;
+				// SerializeFrom only returns 'false' if something important failed
+				if ( !SerializeFrom(node, forceUpdate, createThreads) ) retVal = false;
 			}
-		}
-		else if (tag == IWindow::ClassName())
-		{
-			// If window creation fails, let the calling function know
-			if (mWin != 0 && !mWin->SerializeFrom(node))
+			break;
+
+			case CoreTag::Window:
 			{
-				retVal = false;
-				break;
+				// If window creation fails, let the calling function know
+				if (mWin != 0 && !mWin->SerializeFrom(node)) retVal = false;
 			}
-		}
-		else if (tag == IGraphics::ClassName())
-		{
-			// If graphics init fails, let the calling function know
-			if (mGraphics != 0 && !mGraphics->SerializeFrom(node, forceUpdate))
+			break;
+
+			case CoreTag::Graphics:
 			{
-				retVal = false;
-				break;
+				// If graphics init fails, let the calling function know
+				if (mGraphics != 0 && !mGraphics->SerializeFrom(node, forceUpdate)) retVal = false;
 			}
-		}
-		else if (tag == IUI::ClassName())
-		{
-			if (mUI != 0 && mGraphics != 0)
+			break;
+
+			case CoreTag::UI:
 			{
-				Unlock();
-				mUI->SerializeFrom(node);
-				Lock();
+				if (mUI != 0 && mGraphics != 0)
+				{
+					Unlock();
+					mUI->SerializeFrom(node);
+					Lock();
+				}
 			}
-		}
-		else if (tag == Scene::ClassName())
-		{
-			mRoot.SerializeFrom(node, forceUpdate);
-		}
-		else if (tag == Mesh::ClassName())
-		{
-			Mesh* mesh = GetMesh(value.AsString(), true);
-			if (mesh != 0) mesh->SerializeFrom(node, forceUpdate);
-		}
-		else if (tag == Cloud::ClassName())
-		{
-			Cloud* bm = GetCloud(value.AsString(), true);
-			if (bm != 0) bm->SerializeFrom(node, forceUpdate);
-		}
-		else if (tag == Skeleton::ClassName())
-		{
-			Skeleton* skel = GetSkeleton(value.AsString(), true);
-			if (skel != 0) skel->SerializeFrom(node, forceUpdate);
-		}
-		else if (tag == ModelTemplate::ClassName())
-		{
-			ModelTemplate* temp = GetModelTemplate(value.AsString(), true);
+			break;
 
-			if (temp != 0)
+			case CoreTag::Scene:
 			{
-				temp->SerializeFrom(node, forceUpdate);
-				if (!serializable) temp->SetSerializable(false);
+				mRoot.SerializeFrom(node, forceUpdate);
 			}
-		}
-		else if (tag == Model::ClassName())
-		{
-			Model* model = GetModel(value.AsString(), true);
+			break;
 
-			if (model != 0)
+			case CoreTag::Mesh:
 			{
-				model->SerializeFrom(node, forceUpdate);
-				if (!serializable) model->SetSerializable(false);
+				Mesh* mesh = GetMesh(value.AsString(), true);
+				if (mesh != 0) mesh->SerializeFrom(node, forceUpdate);
 			}
-		}
-		else if (tag == "Serializable")
-		{
-			value >> serializable;
-		}
-		else if (tag == "Sleep")
-		{
-			uint ms;
-			if (value >> ms) Thread::Sleep( ms );
-		}
-		else if (tag == "Serialize From" || tag == "Execute")
-		{
-			if (value.IsStringArray())
+			break;
+
+			case CoreTag::Cloud:
+			{
+				Cloud* bm = GetCloud(value.AsString(), true);
+				if (bm != 0) bm->SerializeFrom(node, forceUpdate);
+			}
+			break;
+
+			case CoreTag::Skeleton:
+			{
+				Skeleton* skel = GetSkeleton(value.AsString(), true);
+				if (skel != 0) skel->SerializeFrom(node, forceUpdate);
+			}
+			break;
+
+			case CoreTag::ModelTemplate:
 			{
-				const Array<String>& arr = value.AsStringArray();
+				ModelTemplate* temp = GetModelTemplate(value.AsString(), true);
 
-				FOREACH(b, arr)
+				if (temp != 0)
 				{
-					SerializeFrom(arr[b], serializable && createThreads, serializable);
+					temp->SerializeFrom(node, forceUpdate);
+					if (!serializable) temp->SetSerializable(false);
 				}
 			}
-			else if (value.IsString())
+			break;
+
+			case CoreTag::Model:
+			{
+				Model* model = GetModel(value.AsString(), true);
+
+				if (model != 0)
+				{
+					model->SerializeFrom(node, forceUpdate);
+					if (!serializable) model->SetSerializable(false);
+				}
+			}
+			break;
+
+			case CoreTag::Serializable:
+			{
+				value >> serializable;
+			}
+			break;
+
+			case CoreTag::Sleep:
+			{
+				uint ms;
+				if (value >> ms) Thread::Sleep( ms );
+			}
+			break;
+
+			case CoreTag::SerializeFrom:
+			case CoreTag::Execute:
 			{
-				SerializeFrom(value.AsString(), serializable && createThreads, serializable);
+				if (value.IsStringArray())
+				{
+					const Array<String>& arr = value.AsStringArray();
+
+					FOREACH(b, arr)
+					{
+						SerializeFrom(arr[b], serializable && createThreads, serializable);
+					}
+				}
+				else if (value.IsString())
+				{
+					SerializeFrom(value.AsString(), serializable && createThreads, serializable);
+				}
 			}
+			break;
 		}
 	}
 	// Something may have changed, update the scene
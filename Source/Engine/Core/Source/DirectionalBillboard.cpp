@@ -2,22 +2,17 @@
 using namespace R5;
 
 //============================================================================================================
-// Draw the billboard
+// Fills the quad representing the billboard on the farthest edge of the horizon
 //============================================================================================================
 
-uint DirectionalBillboard::OnDraw (TemporaryStorage& storage, uint group, const ITechnique* tech, void* param, bool insideOut)
+bool DirectionalBillboard::OnFillQuad (IGraphics* graphics, Quad& quad)
 {
-	IGraphics* graphics = mCore->GetGraphics();
-
-	Matrix43 mat (graphics->GetViewMatrix());
-
 	const Vector3f& camPos = graphics->GetCameraPosition();
 	const Vector3f& camRange = graphics->GetCameraRange();
-	mat.PreTranslate(camPos - mAbsoluteRot.GetForward() * camRange.y);
-	mat.ReplaceScaling(mAbsoluteScale * camRange.y * 0.1f);
+	const Vector3f& scale = mAbsoluteScale * camRange.y * 0.1f;
 
-	graphics->SetModelViewMatrix(mat);
-	DrawBillboard();
-	graphics->ResetModelViewMatrix();
-	return 1;
+	quad.mPos	= camPos - mAbsoluteRot.GetForward() * camRange.y;
+	quad.mSize.Set(scale.x, scale.y);
+	quad.mColor = mColor;
+	return true;
 }
\ No newline at end of file
@@ -21,13 +21,11 @@ void DirectionalGlare::OnUpdate()
 }
 
 //============================================================================================================
-// Draw the glare
+// Fills the quad representing the glare if it's visible
 //============================================================================================================
 
-uint DirectionalGlare::OnDraw (TemporaryStorage& storage, uint group, const ITechnique* tech, void* param, bool insideOut)
+bool DirectionalGlare::OnFillQuad (IGraphics* graphics, Quad& quad)
 {
-	IGraphics* graphics = mCore->GetGraphics();
-
 	const Vector3f& camPos = graphics->GetCameraPosition();
 	const Vector3f& camRange = graphics->GetCameraRange();
 
@@ -38,21 +36,16 @@ uint DirectionalGlare::OnDraw (TemporaryStorage& storage, uint group, const ITec
 	Vector3f distant (camPos - offset * 0.99f);
 
 	// If the distant point is visible, our glare should be as well
-	if (graphics->IsPointVisible(distant)) _SetTargetAlpha(1.0f);
+	if (graphics->IsPointVisible(mQueryID, distant)) _SetTargetAlpha(1.0f);
 
 	// Current scale
 	const Vector3f& scale = mAbsoluteScale * mAlpha.y;
 
 	// Only draw the billboard if it's large enough to be drawn
-	if (!scale.IsZero())
-	{
-		IGraphics* graphics = mCore->GetGraphics();
-		Matrix43 mat (graphics->GetViewMatrix());
-		mat.PreTranslate(camPos - offset);
-		mat.ReplaceScaling(scale * camRange.y * 0.1f);
-		graphics->SetModelViewMatrix(mat);
-		DrawBillboard();
-		graphics->ResetModelViewMatrix();
-	}
-	return 1;
+	if (scale.IsZero()) return false;
+
+	quad.mPos	= camPos - offset;
+	quad.mSize.Set(scale.x * camRange.y * 0.1f, scale.y * camRange.y * 0.1f);
+	quad.mColor = mColor;
+	return true;
 }
\ No newline at end of file
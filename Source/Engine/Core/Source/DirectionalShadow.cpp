@@ -430,6 +430,8 @@ void DirectionalShadow::BlurShadows (const ITexture* camDepth)
 ITexture* DirectionalShadow::Draw (Object* root, const Object* eye, const Vector3f& dir,
 								   const Matrix44& imvp, const ITexture* depth)
 {
+	R5_PROFILE("DirectionalShadow::Draw");
+
 	// Sanity check
 	if (mCascadeCount < 1) mCascadeCount = 1;
 	if (mCascadeCount > 4) mCascadeCount = 4;
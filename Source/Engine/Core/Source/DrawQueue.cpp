@@ -2,30 +2,242 @@
 using namespace R5;
 
 //============================================================================================================
-// Adds a new light to the draw queue
-//============================================================================================================
-
-void DrawQueue::Add (LightSource* light, float distanceToCamera)
-{
-	LightEntry& ent = mLights.Expand();
-	ent.mLight = light;
-	ent.mDistance = distanceToCamera;
+// Layout of the sort keys
+//============================================================================================================
+
+#define LAYER_SHIFT		59
+#define TECH_SHIFT		54
+#define GROUP_SHIFT		22
+#define DEPTH_MASK		0x3FFFFFULL
+
+//============================================================================================================
+// Queues smaller than this get sorted using an insertion sort instead
+//============================================================================================================
+
+#define RADIX_THRESHOLD	64
+
+//============================================================================================================
+// Recordable runs shorter than this are drawn directly, as recording them is not worth the overhead.
+// Marks the first item of every group in the draw order, as billboard batches should not cross groups.
+//============================================================================================================
+
+#define MIN_RECORDED	32
+#define GROUP_START		0x80000000
+#define ITEM_MASK		0x7FFFFFFF
+
+//============================================================================================================
+// Number of threads used to record draw calls
+//============================================================================================================
+
+uint g_recordingThreads = 0;
+
+extern R5_THREAD_LOCAL ModelInstance* g_lastModel;
+
+//============================================================================================================
+// Converts the squared distance into the 22-bit depth portion of the key. Positive floats keep
+// their order when compared as integers, so dropping the lowest 9 bits of the mantissa is enough.
+//============================================================================================================
+
+inline DrawQueue::Key GetDepthBits (float distSquared)
+{
+	if (!(distSquared > 0.0f)) return 0;
+	union { float f; uint u; } val;
+	val.f = distSquared;
+	return (DrawQueue::Key)(val.u >> 9);
+}
+
+//============================================================================================================
+// Whether the entries are already sorted, comparing only the bits of the keys above 'shift'
+//============================================================================================================
+
+bool IsSorted (const DrawQueue::Entry* entries, uint count, uint shift)
+{
+	for (uint i = 1; i < count; ++i)
+		if ((entries[i-1].mKey >> shift) > (entries[i].mKey >> shift)) return false;
+	return true;
+}
+
+//============================================================================================================
+// Stable insertion sort, used for short queues
+//============================================================================================================
+
+void InsertionSort (DrawQueue::Entry* entries, uint count, uint shift)
+{
+	for (uint i = 1; i < count; ++i)
+	{
+		DrawQueue::Entry ent = entries[i];
+		DrawQueue::Key key = ent.mKey >> shift;
+		uint b = i;
+
+		for (; b > 0 && (entries[b-1].mKey >> shift) > key; --b)
+			entries[b] = entries[b-1];
+
+		entries[b] = ent;
+	}
+}
+
+//============================================================================================================
+// Stable least significant digit radix sort of the bits of the keys above 'shift', 8 bits at a time.
+// Bytes that are the same across all keys are skipped, and the histograms of the rest are gathered in
+// a single pass. Returns the sorted buffer.
+//============================================================================================================
+
+DrawQueue::Entry* RadixSort (DrawQueue::Entry* entries, DrawQueue::Entry* temp, uint count, uint shift)
+{
+	// Find the bits that differ between the keys
+	DrawQueue::Key diff = 0;
+	for (uint i = 1; i < count; ++i) diff |= entries[i].mKey ^ entries[0].mKey;
+	diff >>= shift;
+
+	uint passes = 0;
+	uint shifts[8];
+
+	for (uint b = 0; (diff >> b) != 0; b += 8)
+		if (((diff >> b) & 0xFF) != 0) shifts[passes++] = shift + b;
+
+	uint histogram[8][256];
+	memset(histogram, 0, sizeof(uint) * 256 * passes);
+
+	for (uint i = 0; i < count; ++i)
+	{
+		DrawQueue::Key key = entries[i].mKey;
+
+		for (uint b = 0; b < passes; ++b)
+		{
+			++histogram[b][(uint)(key >> shifts[b]) & 0xFF];
+		}
+	}
+
+	DrawQueue::Entry* src = entries;
+	DrawQueue::Entry* dst = temp;
+
+	for (uint b = 0; b < passes; ++b)
+	{
+		uint* counts = histogram[b];
+		shift = shifts[b];
+
+		// Turn the counts into offsets
+		for (uint i = 0, offset = 0; i < 256; ++i)
+		{
+			uint val = counts[i];
+			counts[i] = offset;
+			offset += val;
+		}
+
+		for (uint i = 0; i < count; ++i)
+		{
+			const DrawQueue::Entry& ent = src[i];
+			dst[ counts[(uint)(ent.mKey >> shift) & 0xFF]++ ] = ent;
+		}
+		Swap(src, dst);
+	}
+	return src;
+}
+
+//============================================================================================================
+// Work executed by the recording threads: every thread records one segment at a time
+//============================================================================================================
+
+struct DrawQueue::RecordingJob
+{
+	DrawQueue*			mQueue;
+	TemporaryStorage*	mStorage;
+	IGraphics*			mGraphics;
+	const ITechnique*	mTech;
+	bool				mInsideOut;
+
+	void Run (uint index)
+	{
+		Segment& seg = mQueue->mSegments[ mQueue->mRecorded[index] ];
+		CommandList* list = mQueue->mLists[seg.mList];
+
+		// The model's matrix must be set at the beginning of every command list
+		list->Begin(mGraphics);
+		g_lastModel = 0;
+		seg.mTriangles = mQueue->DrawItems(*mStorage, seg.mFirst, seg.mLast, mTech, mInsideOut);
+		list->End();
+	}
+};
+
+//============================================================================================================
+
+DrawQueue::DrawQueue() : mLastObject(0), mLastParam(0), mLastLayer(0), mLastMask(0), mLastGroup(0)
+{
+	memset(mMask, 0, sizeof(mMask));
 }
 
 //============================================================================================================
-// Whether we have something to draw
-//============================================================================================================
-
-bool DrawQueue::IsValid() const
+// Clear the draw queue
+//============================================================================================================
+
+void DrawQueue::Clear()
 {
-	for (uint i = 0; i < 32; ++i)
+	mLights.Clear();
+	mItems.Clear();
+	mEntries.Clear();
+	memset(mMask, 0, sizeof(mMask));
+	mLastObject = 0;
+}
+
+//============================================================================================================
+// Adds a new light to the draw queue
+//============================================================================================================
+
+void DrawQueue::Add (LightSource* light, float distanceToCamera)
+{
+	LightEntry& ent = mLights.Expand();
+	ent.mLight = light;
+	ent.mDistance = distanceToCamera;
+}
+
+//============================================================================================================
+// Add a new object to the draw queue
+//============================================================================================================
+
+void DrawQueue::Add (uint layer, Object* obj, void* param, uint mask, uint group, float distSquared)
+{
+	layer &= 31;
+
+	// Objects that get added twice in a row should only be drawn once
+	if (obj == mLastObject && param == mLastParam && layer == mLastLayer &&
+		mask == mLastMask && group == mLastGroup) return;
+
+	mLastObject	= obj;
+	mLastParam	= param;
+	mLastLayer	= layer;
+	mLastMask	= mask;
+	mLastGroup	= group;
+	mMask[layer] |= mask;
+
+	uint index = mItems.GetSize();
+	Item& item = mItems.Expand();
+	item.mObject = obj;
+	item.mParam	 = param;
+	item.mGroup	 = group;
+
+	Key key = ((Key)layer << LAYER_SHIFT) | ((Key)(~group) << GROUP_SHIFT) | GetDepthBits(distSquared);
+
+	// Add a sort key for every technique the object is visible with
+	for (uint i = 0; mask != 0; ++i, mask >>= 1)
 	{
-		if (mLayers[i].mList.IsValid())
+		if ((mask & 0x1) != 0)
 		{
-			return true;
+			Entry& ent = mEntries.Expand();
+			ent.mKey  = key | ((Key)i << TECH_SHIFT);
+			ent.mItem = index;
 		}
 	}
-	return false;
+}
+
+//============================================================================================================
+// Sort all objects by layer, technique and group. Distance to the camera only matters to techniques that
+// sort their objects, so their entries get sorted by distance as they are drawn.
+//============================================================================================================
+
+void DrawQueue::Sort()
+{
+	R5_PROFILE("DrawQueue::Sort");
+	SortRange(0, mEntries.GetSize(), GROUP_SHIFT);
 }
 
 //============================================================================================================
@@ -35,6 +247,7 @@ bool DrawQueue::IsValid() const
 uint DrawQueue::Draw (TemporaryStorage& storage, IGraphics* graphics, const Techniques& techniques,
 					  bool useLighting, bool insideOut)
 {
+	R5_PROFILE("DrawQueue::Draw");
 	uint result(0);
 	uint mask = 0;
 
@@ -45,22 +258,46 @@ uint DrawQueue::Draw (TemporaryStorage& storage, IGraphics* graphics, const Tech
 		if (tech != 0) mask |= tech->GetMask();
 	}
 
-	// Run through all layers
-	for (uint i = 0; i < 32; ++i)
+	const Entry* entries = mEntries.GetBuffer();
+	uint count = mEntries.GetSize();
+
+	// Run through all layers present in the queue
+	for (uint start = 0; start < count; )
 	{
-		DrawLayer& layer = mLayers[i];
+		uint layer = (uint)(entries[start].mKey >> LAYER_SHIFT);
+		uint end = start + 1;
+		while (end < count && (uint)(entries[end].mKey >> LAYER_SHIFT) == layer) ++end;
 
 		// Ensure this layer is visible with our mask
-		if ((layer.mMask & mask) != 0)
+		if ((mMask[layer] & mask) != 0)
 		{
-			// Draw all deferred techniques first
 			FOREACH(b, techniques)
 			{
 				const ITechnique* tech = techniques[b];
 
 				// If the layer has something visible on the specified technique
-				if (tech != 0 && (layer.mMask & tech->GetMask()) != 0)
+				if (tech != 0 && (mMask[layer] & tech->GetMask()) != 0)
 				{
+					// Keys are sorted, so all entries using this technique are next to each other
+					Key prefix = ((Key)layer << (LAYER_SHIFT - TECH_SHIFT)) | tech->GetIndex();
+					uint first = start;
+
+					for (uint range = end - start; range > 0; )
+					{
+						uint half = range >> 1;
+
+						if ((entries[first + half].mKey >> TECH_SHIFT) < prefix)
+						{
+							first += half + 1;
+							range -= half + 1;
+						}
+						else range = half;
+					}
+
+					uint last = first;
+					while (last < end && (entries[last].mKey >> TECH_SHIFT) == prefix) ++last;
+					if (first == last) continue;
+
 					// Call the optional callback
 					if (mOnDraw) mOnDraw(tech);
 
@@ -71,15 +308,232 @@ uint DrawQueue::Draw (TemporaryStorage& storage, IGraphics* graphics, const Tech
 					if (useLighting && tech->GetLighting() != IGraphics::Lighting::None)
 						ActivateLights(graphics);
 
-					// Draw everything on this layer
-					result += layer.Draw(storage, tech, insideOut);
+					// Draw everything on this layer that uses this technique
+					result += DrawRange(storage, graphics, first, last, tech, insideOut);
 				}
 			}
 		}
+		start = end;
 	}
 	return result;
 }
 
+//============================================================================================================
+// Draws all entries within the specified range, which all share the same layer and technique
+//============================================================================================================
+
+uint DrawQueue::DrawRange (TemporaryStorage& storage, IGraphics* graphics, uint first, uint last,
+						   const ITechnique* tech, bool insideOut)
+{
+	bool backToFront = (tech->GetSorting() == ITechnique::Sorting::BackToFront);
+
+	// The entries share the same layer and technique, so sorting them by the entire key sorts every group
+	if (tech->GetSorting() != ITechnique::Sorting::None) SortRange(first, last, 0);
+
+	const Entry* entries = mEntries.GetBuffer();
+	mOrder.Clear();
+	uint* order = mOrder.ExpandTo(last - first);
+
+	for (uint start = first; start < last; )
+	{
+		// Find where the current group ends
+		Key group = (entries[start].mKey >> GROUP_SHIFT);
+		uint end = start + 1;
+		while (end < last && (entries[end].mKey >> GROUP_SHIFT) == group) ++end;
+
+		// Entries within the group are either in the order they were added in, or sorted front-to-back
+		if (backToFront) for (uint i = end; i > start; ) *order++ = entries[--i].mItem;
+		else for (uint i = start; i < end; ++i) *order++ = entries[i].mItem;
+
+		*(order - (end - start)) |= GROUP_START;
+		start = end;
+	}
+
+	if (g_recordingThreads > 0 && mOrder.GetSize() >= MIN_RECORDED)
+		return DrawRecorded(storage, graphics, tech, insideOut);
+
+	return DrawItems(storage, 0, mOrder.GetSize(), tech, insideOut);
+}
+
+//============================================================================================================
+// Sorts the entries within the specified range by the bits of their keys above 'shift'
+//============================================================================================================
+
+void DrawQueue::SortRange (uint first, uint last, uint shift)
+{
+	uint count = last - first;
+	Entry* entries = mEntries.GetBuffer() + first;
+
+	// Scenes that don't change much often end up adding objects in the same order every frame
+	if (IsSorted(entries, count, shift)) return;
+
+	if (count < RADIX_THRESHOLD)
+	{
+		InsertionSort(entries, count, shift);
+	}
+	else
+	{
+		mTemp.ExpandTo(count);
+		Entry* sorted = RadixSort(entries, mTemp.GetBuffer(), count, shift);
+		if (sorted != entries) memcpy(entries, sorted, sizeof(Entry) * count);
+	}
+}
+
+//============================================================================================================
+// Draws the items within the specified portion of the draw order
+//============================================================================================================
+
+uint DrawQueue::DrawItems (TemporaryStorage& storage, uint first, uint last, const ITechnique* tech, bool insideOut)
+{
+	uint retVal = 0;
+	void* batchParam = Billboard::GetBatchParam();
+
+	for (uint i = first; i < last; )
+	{
+		const Item& item = mItems[mOrder[i] & ITEM_MASK];
+
+		if (item.mParam == batchParam)
+		{
+			// Consecutive billboards within the same group get expanded into a single vertex stream
+			mBatch.Clear();
+
+			do
+			{
+				mBatch.Expand() = (Billboard*)mItems[mOrder[i] & ITEM_MASK].mObject;
+			}
+			while (++i < last && (mOrder[i] & GROUP_START) == 0 &&
+				mItems[mOrder[i] & ITEM_MASK].mParam == batchParam);
+
+			retVal += Billboard::DrawBatch(mBatch.GetBuffer(), mBatch.GetSize());
+		}
+		else
+		{
+			retVal += item.mObject->Draw(storage, item.mGroup, tech, item.mParam, insideOut);
+			++i;
+		}
+	}
+	return retVal;
+}
+
+//============================================================================================================
+// Records the recordable portions of the draw order on multiple threads, then replays them in order
+//============================================================================================================
+
+uint DrawQueue::DrawRecorded (TemporaryStorage& storage, IGraphics* graphics, const ITechnique* tech, bool insideOut)
+{
+	uint count = mOrder.GetSize();
+	mSegments.Clear();
+	mRecorded.Clear();
+
+	// Split the draw order into runs of items that can and can't be recorded
+	for (uint start = 0; start < count; )
+	{
+		const Item& first = mItems[mOrder[start] & ITEM_MASK];
+		bool recordable = first.mObject->IsRecordable(tech, first.mParam);
+		uint end = start + 1;
+
+		for (; end < count; ++end)
+		{
+			const Item& item = mItems[mOrder[end] & ITEM_MASK];
+			if (item.mObject->IsRecordable(tech, item.mParam) != recordable) break;
+		}
+
+		if (!recordable || end - start < MIN_RECORDED)
+		{
+			// Consecutive segments that get drawn directly can be merged
+			if (mSegments.IsValid() && mSegments.Back().mList == -1)
+			{
+				mSegments.Back().mLast = end;
+			}
+			else
+			{
+				Segment& seg = mSegments.Expand();
+				seg.mFirst		= start;
+				seg.mLast		= end;
+				seg.mList		= -1;
+				seg.mTriangles	= 0;
+			}
+		}
+		else
+		{
+			// Long runs get split into one chunk per thread
+			uint chunks = Min(g_recordingThreads, (end - start) / MIN_RECORDED);
+			uint size = (end - start) / chunks;
+
+			for (uint i = start, chunk = 1; i < end; ++chunk)
+			{
+				uint last = (chunk == chunks) ? end : Min(i + size, end);
+
+				// Multiple parts of the same object should stay together, as they share the same matrix
+				while (last < end && mItems[mOrder[last] & ITEM_MASK].mObject ==
+					mItems[mOrder[last - 1] & ITEM_MASK].mObject) ++last;
+
+				Segment& seg = mSegments.Expand();
+				seg.mFirst		= i;
+				seg.mLast		= last;
+				seg.mList		= (int)mRecorded.GetSize();
+				seg.mTriangles	= 0;
+				mRecorded.Expand() = mSegments.GetSize() - 1;
+				i = last;
+			}
+		}
+		start = end;
+	}
+
+	// Command lists are kept around and reused
+	while (mLists.GetSize() < mRecorded.GetSize()) mLists.Expand() = new CommandList();
+
+	// Record all chunks at the same time
+	{
+		R5_PROFILE("DrawQueue::Record");
+		RecordingJob job;
+		job.mQueue		= this;
+		job.mStorage	= &storage;
+		job.mGraphics	= graphics;
+		job.mTech		= tech;
+		job.mInsideOut	= insideOut;
+
+		if (g_recordingThreads > 1 && mRecorded.GetSize() > 1)
+		{
+			Thread::ParallelFor(mRecorded.GetSize(), bind(&RecordingJob::Run, &job), g_recordingThreads - 1);
+		}
+		else
+		{
+			for (uint i = 0; i < mRecorded.GetSize(); ++i) job.Run(i);
+		}
+	}
+
+	// Draw everything in the original order, replaying the recorded segments
+	R5_PROFILE("DrawQueue::Replay");
+	uint retVal = 0;
+
+	FOREACH(i, mSegments)
+	{
+		const Segment& seg = mSegments[i];
+
+		if (seg.mList == -1)
+		{
+			retVal += DrawItems(storage, seg.mFirst, seg.mLast, tech, insideOut);
+		}
+		else
+		{
+			mLists[seg.mList]->Replay();
+			retVal += seg.mTriangles;
+
+			// The replayed commands have changed the model matrix
+			g_lastModel = 0;
+		}
+	}
+	return retVal;
+}
+
+//============================================================================================================
+// Number of threads used to record draw calls
+//============================================================================================================
+
+void DrawQueue::SetRecordingThreads (uint count)	{ g_recordingThreads = count; }
+uint DrawQueue::GetRecordingThreads()				{ return g_recordingThreads; }
+
 //============================================================================================================
 // Activate all lights
 //============================================================================================================
@@ -103,4 +557,4 @@ void DrawQueue::ActivateLights (IGraphics* graphics)
 			graphics->SetActiveLight(i, 0);
 		}
 	}
-}
\ No newline at end of file
+}
@@ -1,6 +1,213 @@
 #include "../Include/_All.h"
+
+#ifdef R5_SSE
+#include <emmintrin.h>
+#endif
+
 using namespace R5;
 
+//============================================================================================================
+// Emitters are only simulated on multiple threads if there are enough particles to make it worthwhile
+//============================================================================================================
+
+#define PARALLEL_THRESHOLD 4096
+
+//============================================================================================================
+// Ages the particles, returning the number of particles that are still alive
+//============================================================================================================
+
+uint AgeParticles (uint* remaining, uint delta, uint count)
+{
+	uint i = 0, alive = 0;
+
+#ifdef R5_SSE
+	// Particles never live anywhere near 2^31 milliseconds, so signed comparisons can be used
+	__m128i d		= _mm_set1_epi32((int)delta);
+	__m128i zero	= _mm_setzero_si128();
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i r		= _mm_loadu_si128((const __m128i*)(remaining + i));
+		__m128i live	= _mm_cmpgt_epi32(r, d);
+		r = _mm_and_si128(_mm_sub_epi32(r, d), live);
+		_mm_storeu_si128((__m128i*)(remaining + i), r);
+
+		int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(r, zero)));
+		alive += (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1);
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		uint& r = remaining[i];
+		r = (r > delta) ? r - delta : 0;
+		if (r != 0) ++alive;
+	}
+	return alive;
+}
+
+//============================================================================================================
+// Applies gravity and drag to the velocity, then moves the particles
+//============================================================================================================
+
+void MoveParticles (float* pos, float* vel, float accel, float damping, float dt, uint count)
+{
+	uint i = 0;
+
+#ifdef R5_SSE
+	__m128 a = _mm_set1_ps(accel * dt);
+	__m128 k = _mm_set1_ps(damping);
+	__m128 t = _mm_set1_ps(dt);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 v = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vel + i), k), a);
+		_mm_storeu_ps(vel + i, v);
+		_mm_storeu_ps(pos + i, _mm_add_ps(_mm_loadu_ps(pos + i), _mm_mul_ps(v, t)));
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		vel[i]  = vel[i] * damping + accel * dt;
+		pos[i] += vel[i] * dt;
+	}
+}
+
+//============================================================================================================
+// Calculates the size, fading and rotation of the particles based on their progress
+//============================================================================================================
+
+struct Curves
+{
+	float mInvLife;		// 1 / lifetime
+	float mSize0;		// Radius at spawn
+	float mSizeDelta;	// Change in radius over the particle's lifetime
+	float mFadeIn;		// Fade in slope, 0 if there is no fading in
+	float mFadeInBias;	// 1 if there is no fading in, 0 otherwise
+	float mFadeOut;		// Fade out slope, 0 if there is no fading out
+	float mFadeOutBias;	// 1 if there is no fading out, 0 otherwise
+	float mSpin;		// Rotation during this update
+};
+
+void ShapeParticles (const Curves& c, const uint* remaining, float* radius, float* alpha, float* rotation, uint count)
+{
+	uint i = 0;
+
+#ifdef R5_SSE
+	__m128 one		= _mm_set1_ps(1.0f);
+	__m128 zero		= _mm_setzero_ps();
+	__m128 invLife	= _mm_set1_ps(c.mInvLife);
+	__m128 size0	= _mm_set1_ps(c.mSize0);
+	__m128 sizeD	= _mm_set1_ps(c.mSizeDelta);
+	__m128 fadeIn	= _mm_set1_ps(c.mFadeIn);
+	__m128 biasIn	= _mm_set1_ps(c.mFadeInBias);
+	__m128 fadeOut	= _mm_set1_ps(c.mFadeOut);
+	__m128 biasOut	= _mm_set1_ps(c.mFadeOutBias);
+	__m128 spin		= _mm_set1_ps(c.mSpin);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		// Fraction of the lifetime that's left, which is 1 minus the progress
+		__m128 left = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(remaining + i)));
+		left = _mm_min_ps(_mm_mul_ps(left, invLife), one);
+		__m128 progress = _mm_sub_ps(one, left);
+
+		_mm_storeu_ps(radius + i, _mm_add_ps(size0, _mm_mul_ps(sizeD, progress)));
+
+		__m128 in  = _mm_min_ps(_mm_add_ps(_mm_mul_ps(progress, fadeIn), biasIn), one);
+		__m128 out = _mm_min_ps(_mm_add_ps(_mm_mul_ps(left, fadeOut), biasOut), one);
+		_mm_storeu_ps(alpha + i, _mm_max_ps(_mm_mul_ps(in, out), zero));
+
+		_mm_storeu_ps(rotation + i, _mm_add_ps(_mm_loadu_ps(rotation + i), spin));
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		float left		= Min((float)remaining[i] * c.mInvLife, 1.0f);
+		float progress	= 1.0f - left;
+		float in		= Min(progress * c.mFadeIn + c.mFadeInBias, 1.0f);
+		float out		= Min(left * c.mFadeOut + c.mFadeOutBias, 1.0f);
+
+		radius[i]	 = c.mSize0 + c.mSizeDelta * progress;
+		alpha[i]	 = Max(in * out, 0.0f);
+		rotation[i] += c.mSpin;
+	}
+}
+
+//============================================================================================================
+// Calculates the bounds of all live particles
+//============================================================================================================
+
+void GetParticleBounds (const Emitter::Streams& s, uint count, Bounds& bounds)
+{
+	const float big = 3.0e38f;
+	float minX = big, minY = big, minZ = big, maxX = -big, maxY = -big, maxZ = -big;
+	uint i = 0;
+
+#ifdef R5_SSE
+	__m128 zero = _mm_setzero_ps();
+	__m128 vMinX = _mm_set1_ps(big),  vMinY = vMinX, vMinZ = vMinX;
+	__m128 vMaxX = _mm_set1_ps(-big), vMaxY = vMaxX, vMaxZ = vMaxX;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		// Free slots contribute nothing: their radius gets replaced by a huge negative value
+		__m128 live = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_loadu_si128(
+			(const __m128i*)(s.mRemaining.GetBuffer() + i)), _mm_setzero_si128()));
+		__m128 r = _mm_max_ps(_mm_loadu_ps(s.mRadius.GetBuffer() + i), zero);
+		r = _mm_or_ps(_mm_and_ps(live, r), _mm_andnot_ps(live, _mm_set1_ps(-big)));
+
+		__m128 x = _mm_loadu_ps(s.mX.GetBuffer() + i);
+		__m128 y = _mm_loadu_ps(s.mY.GetBuffer() + i);
+		__m128 z = _mm_loadu_ps(s.mZ.GetBuffer() + i);
+
+		vMinX = _mm_min_ps(vMinX, _mm_sub_ps(x, r));
+		vMinY = _mm_min_ps(vMinY, _mm_sub_ps(y, r));
+		vMinZ = _mm_min_ps(vMinZ, _mm_sub_ps(z, r));
+		vMaxX = _mm_max_ps(vMaxX, _mm_add_ps(x, r));
+		vMaxY = _mm_max_ps(vMaxY, _mm_add_ps(y, r));
+		vMaxZ = _mm_max_ps(vMaxZ, _mm_add_ps(z, r));
+	}
+
+	float f[4];
+	_mm_storeu_ps(f, vMinX); minX = Min(Min(f[0], f[1]), Min(f[2], f[3]));
+	_mm_storeu_ps(f, vMinY); minY = Min(Min(f[0], f[1]), Min(f[2], f[3]));
+	_mm_storeu_ps(f, vMinZ); minZ = Min(Min(f[0], f[1]), Min(f[2], f[3]));
+	_mm_storeu_ps(f, vMaxX); maxX = Max(Max(f[0], f[1]), Max(f[2], f[3]));
+	_mm_storeu_ps(f, vMaxY); maxY = Max(Max(f[0], f[1]), Max(f[2], f[3]));
+	_mm_storeu_ps(f, vMaxZ); maxZ = Max(Max(f[0], f[1]), Max(f[2], f[3]));
+#endif
+
+	for (; i < count; ++i)
+	{
+		if (s.mRemaining[i] == 0) continue;
+		float r = Max(s.mRadius[i], 0.0f);
+		minX = Min(minX, s.mX[i] - r);	maxX = Max(maxX, s.mX[i] + r);
+		minY = Min(minY, s.mY[i] - r);	maxY = Max(maxY, s.mY[i] + r);
+		minZ = Min(minZ, s.mZ[i] - r);	maxZ = Max(maxZ, s.mZ[i] + r);
+	}
+
+	bounds.Clear();
+
+	if (minX <= maxX)
+	{
+		bounds.Include(Vector3f(minX, minY, minZ));
+		bounds.Include(Vector3f(maxX, maxY, maxZ));
+	}
+}
+
+//============================================================================================================
+// Work passed to the threads simulating the queued emitters
+//============================================================================================================
+
+struct SimulationJob
+{
+	const Array<Emitter*>* mList;
+	void Run (uint index) { (*mList)[index]->_Simulate(); }
+};
+
 //============================================================================================================
 // Particle emitter class constructor
 //============================================================================================================
@@ -8,6 +215,7 @@ using namespace R5;
 Emitter::Emitter() :
 	mTex			(0),
 	mTech			(0),
+	mCount			(0),
 	mLifetime		(1000),
 	mActiveParts	(0),
 	mMaxParticles	(10),
@@ -15,7 +223,9 @@ Emitter::Emitter() :
 	mActiveTime		(0),
 	mAccumulated	(0),
 	mLastVisible	(0),
-	mUpdated		(false)
+	mDelta			(0),
+	mUpdated		(false),
+	mCustom			(true)
 {
 	// Particle emitter uses absolute bounds and ignores relative
 	mCalcAbsBounds = false;
@@ -23,7 +233,121 @@ Emitter::Emitter() :
 }
 
 //============================================================================================================
-// Runs through all particles and respawns them as necessary
+// Resizes the particle streams
+//============================================================================================================
+
+void Emitter::_Reserve (uint count)
+{
+	Streams& s = mParticles;
+	s.mRemaining.ExpandTo(count, true);
+	s.mX.ExpandTo(count, true);
+	s.mY.ExpandTo(count, true);
+	s.mZ.ExpandTo(count, true);
+	s.mVX.ExpandTo(count, true);
+	s.mVY.ExpandTo(count, true);
+	s.mVZ.ExpandTo(count, true);
+	s.mRadius.ExpandTo(count, true);
+	s.mRotation.ExpandTo(count, true);
+	s.mAlpha.ExpandTo(count, true);
+	s.mColor.ExpandTo(count, true);
+	s.mSpawnPos.ExpandTo(count, true);
+	s.mParam.ExpandTo(count, true);
+}
+
+//============================================================================================================
+// Spawns a particle in the specified slot
+//============================================================================================================
+
+void Emitter::_Spawn (uint index, uint remaining)
+{
+	Particle particle;
+	particle.mSpawnPos	= mAbsolutePos;
+	particle.mSpawnDir	= Vector3f();
+	particle.mColor		= Color4ub(255, 255, 255, 255);
+	particle.mRadius	= mAbsoluteScale.x * mBehavior.mSize.x;
+	particle.mRotation	= 0.0f;
+	particle.mRemaining	= remaining;
+	particle.mParam		= 0;
+
+	InitParticle(particle);
+
+	Streams& s = mParticles;
+	s.mRemaining[index]	= particle.mRemaining;
+	s.mX[index]			= particle.mSpawnPos.x;
+	s.mY[index]			= particle.mSpawnPos.y;
+	s.mZ[index]			= particle.mSpawnPos.z;
+	s.mVX[index]		= particle.mSpawnDir.x;
+	s.mVY[index]		= particle.mSpawnDir.y;
+	s.mVZ[index]		= particle.mSpawnDir.z;
+	s.mRadius[index]	= particle.mRadius;
+	s.mRotation[index]	= particle.mRotation;
+	s.mAlpha[index]		= 1.0f;
+	s.mColor[index]		= particle.mColor;
+	s.mSpawnPos[index]	= particle.mSpawnPos;
+	s.mParam[index]		= particle.mParam;
+
+	if (mCount <= index) mCount = index + 1;
+}
+
+//============================================================================================================
+// Runs all particles through UpdateParticle(), one at a time
+//============================================================================================================
+
+void Emitter::_UpdateCustom()
+{
+	Streams& s = mParticles;
+	Particle particle;
+
+	uint alive = mActiveParts;
+	mActiveParts = 0;
+	mAbsoluteBounds.Clear();
+
+	for (uint i = 0; i < mCount; ++i)
+	{
+		if (s.mRemaining[i] == 0) continue;
+
+		particle.mSpawnPos	= s.mSpawnPos[i];
+		particle.mSpawnDir.Set(s.mVX[i], s.mVY[i], s.mVZ[i]);
+		particle.mPos.Set(s.mX[i], s.mY[i], s.mZ[i]);
+		particle.mColor		= s.mColor[i];
+		particle.mRadius	= s.mRadius[i];
+		particle.mRotation	= s.mRotation[i];
+		particle.mRemaining	= s.mRemaining[i];
+		particle.mParam		= s.mParam[i];
+
+		UpdateParticle(particle);
+
+		// The default implementation means the built-in behaviours should be used instead
+		if (!mCustom)
+		{
+			mActiveParts = alive;
+			return;
+		}
+
+		s.mSpawnPos[i]	= particle.mSpawnPos;
+		s.mVX[i]		= particle.mSpawnDir.x;
+		s.mVY[i]		= particle.mSpawnDir.y;
+		s.mVZ[i]		= particle.mSpawnDir.z;
+		s.mX[i]			= particle.mPos.x;
+		s.mY[i]			= particle.mPos.y;
+		s.mZ[i]			= particle.mPos.z;
+		s.mColor[i]		= particle.mColor;
+		s.mRadius[i]	= particle.mRadius;
+		s.mRotation[i]	= particle.mRotation;
+		s.mRemaining[i]	= particle.mRemaining;
+		s.mParam[i]		= particle.mParam;
+
+		// UpdateParticle might set the particle's remaining time to be 0 as well
+		if (particle.mRemaining != 0)
+		{
+			++mActiveParts;
+			mAbsoluteBounds.Include(particle.mPos, particle.mRadius);
+		}
+	}
+}
+
+//============================================================================================================
+// Ages the particles, spawns new ones, and either updates them right away or queues the built-in simulation
 //============================================================================================================
 
 void Emitter::OnUpdate()
@@ -36,14 +360,9 @@ void Emitter::OnUpdate()
 
 	// Delay since last frame
 	ulong delta = Time::GetDeltaMS();
-
-	// Recalculate the number of active particles
-	mActiveParts = 0;
+	mDelta = (uint)delta;
 	mUpdated = true;
 
-	// Reset the bounds as we'll recalculate them
-	mAbsoluteBounds.Clear();
-
 	// Update our accumulated spawn time
 	mAccumulated += delta;
 
@@ -53,55 +372,33 @@ void Emitter::OnUpdate()
 		mActiveTime = (mActiveTime > delta) ? mActiveTime - delta : 0;
 	}
 
-	// Update the particle and the bounding volume
-	for (uint i = mParticles.GetSize(); i > 0; )
-	{
-		Particle& particle = mParticles[--i];
+	// Particles get recycled in place, so their storage only needs to be allocated once
+	if (mParticles.mRemaining.GetSize() < mMaxParticles) _Reserve(mMaxParticles);
 
-		// Update the particle's time
-		particle.mRemaining = (particle.mRemaining > delta) ? particle.mRemaining - delta : 0;
+	// Update the particles' time
+	mActiveParts = AgeParticles(mParticles.mRemaining.GetBuffer(), mDelta, mCount);
 
-		// If this is an inactive particle, see if we can reactivate it
-		if ( particle.mRemaining == 0 && mActiveTime != 0 && mActiveParts < mMaxParticles )
+	// Spawn new particles in the free slots
+	for (uint i = 0, imax = mParticles.mRemaining.GetSize(); i < imax && mActiveTime != 0 &&
+		mActiveParts < mMaxParticles && mAccumulated >= mFrequency; ++i)
+	{
+		if (mParticles.mRemaining[i] == 0)
 		{
-			// If it's time to spawn a new particle, let's do that now
-			if (mAccumulated >= mFrequency)
-			{
-				mAccumulated -= mFrequency;
-				particle.mRemaining = (mLifetime > mAccumulated) ? mLifetime - mAccumulated : 0;
-				InitParticle(particle);
-			}
-		}
-
-		// If the particle has some time remaining, update it and include it in the bounds
-		if (particle.mRemaining != 0)
-		{
-			UpdateParticle(particle);
-
-			// One final check, as UpdateParticle might set the particle's remaining time to be 0 as well
-			if (particle.mRemaining != 0)
-			{
-				++mActiveParts;
-				mAbsoluteBounds.Include(particle.mPos, particle.mRadius);
-			}
+			mAccumulated -= mFrequency;
+			_Spawn(i, (mLifetime > mAccumulated) ? mLifetime - mAccumulated : 0);
+			if (mParticles.mRemaining[i] != 0) ++mActiveParts;
 		}
 	}
 
-	// If the number of particles hasn't reached maximum yet, see if we can add new ones
-	for ( ; (mParticles.GetSize() < mMaxParticles) && (mAccumulated >= mFrequency); ++mActiveParts )
-	{
-		mAccumulated -= mFrequency;
-		Particle& particle = mParticles.Expand();
-		particle.mRemaining = (mLifetime > mAccumulated) ? mLifetime - mAccumulated : 0;
+	// Custom particle behavior has to run on this thread, so it's done right away
+	if (mCustom) _UpdateCustom();
 
-		InitParticle(particle);
-		UpdateParticle(particle);
-		mAbsoluteBounds.Include(particle.mPos, particle.mRadius);
-	}
+	// Built-in behaviours are simulated after the entire scene has been updated, alongside all other emitters.
+	// Since that happens after the parents have calculated their complete bounds, those will lag a frame behind.
+	if (!mCustom) mCore->_QueueEmitter(this);
 
 	// Automatically shrink the trailing particles that are no longer used
-	while (mParticles.IsValid() && mParticles.Back().mRemaining == 0)
-		mParticles.Shrink();
+	while (mCount > 0 && mParticles.mRemaining[mCount - 1] == 0) --mCount;
 
 	// The accumulated amount should never carry over more than a frequency's worth
 	if (mAccumulated > mFrequency)
@@ -111,6 +408,74 @@ void Emitter::OnUpdate()
 	mIsDirty = true;
 }
 
+//============================================================================================================
+// Runs the built-in behaviours on all particles and recalculates the bounds
+//============================================================================================================
+
+void Emitter::_Simulate()
+{
+	Streams& s = mParticles;
+	float dt = 0.001f * mDelta;
+
+	// Motion
+	float damping = Max(1.0f - mBehavior.mDrag * dt, 0.0f);
+	MoveParticles(s.mX.GetBuffer(), s.mVX.GetBuffer(), mBehavior.mGravity.x, damping, dt, mCount);
+	MoveParticles(s.mY.GetBuffer(), s.mVY.GetBuffer(), mBehavior.mGravity.y, damping, dt, mCount);
+	MoveParticles(s.mZ.GetBuffer(), s.mVZ.GetBuffer(), mBehavior.mGravity.z, damping, dt, mCount);
+
+	// Size, fading and rotation
+	Curves c;
+	float scale		= mAbsoluteScale.x;
+	c.mInvLife		= (mLifetime > 0) ? 1.0f / mLifetime : 0.0f;
+	c.mSize0		= scale * mBehavior.mSize.x;
+	c.mSizeDelta	= scale * (mBehavior.mSize.y - mBehavior.mSize.x);
+	c.mFadeIn		= (mBehavior.mFade.x > 0.0f) ? 1.0f / mBehavior.mFade.x : 0.0f;
+	c.mFadeInBias	= (mBehavior.mFade.x > 0.0f) ? 0.0f : 1.0f;
+	c.mFadeOut		= (mBehavior.mFade.y > 0.0f) ? 1.0f / mBehavior.mFade.y : 0.0f;
+	c.mFadeOutBias	= (mBehavior.mFade.y > 0.0f) ? 0.0f : 1.0f;
+	c.mSpin			= mBehavior.mSpin * dt;
+	ShapeParticles(c, s.mRemaining.GetBuffer(), s.mRadius.GetBuffer(), s.mAlpha.GetBuffer(), s.mRotation.GetBuffer(), mCount);
+
+	// The emitter's own bounds are only known now, so the complete bounds have to be updated as well
+	GetParticleBounds(s, mCount, mAbsoluteBounds);
+	mCompleteBounds = mAbsoluteBounds;
+
+	if (mIncChildBounds)
+	{
+		for (uint i = 0; i < mChildren.GetSize(); ++i)
+		{
+			Object* obj = mChildren[i];
+
+			if (obj != 0 && obj->GetFlag(Flag::Enabled))
+			{
+				mCompleteBounds.Include(obj->GetCompleteBounds());
+			}
+		}
+	}
+}
+
+//============================================================================================================
+// Simulates all emitters queued during the scene update, in parallel if there is enough work
+//============================================================================================================
+
+void Emitter::_Simulate (const Array<Emitter*>& list)
+{
+	R5_PROFILE("Emitter::Simulate");
+	uint particles = 0;
+	FOREACH(i, list) particles += list[i]->mCount;
+
+	if (list.GetSize() > 1 && particles >= PARALLEL_THRESHOLD)
+	{
+		SimulationJob job;
+		job.mList = &list;
+		Thread::ParallelFor(list.GetSize(), bind(&SimulationJob::Run, &job));
+	}
+	else
+	{
+		FOREACH(i, list) list[i]->_Simulate();
+	}
+}
+
 //============================================================================================================
 // Adds the emitter to the list of renderable objects
 //============================================================================================================
@@ -119,7 +484,7 @@ bool Emitter::OnFill (FillParams& params)
 {
 	mLastVisible = Time::GetMilliseconds();
 
-	if (mTex != 0 && mParticles.IsValid())
+	if (mTex != 0 && mActiveParts != 0)
 	{
 		// If no special technique was specified, assume the default value
 		if (mTech == 0) mTech = mCore->GetGraphics()->GetTechnique("Particle", true);
@@ -151,32 +516,38 @@ uint Emitter::OnDraw (TemporaryStorage& storage, uint group, const ITechnique* t
 		uint flipU = mFlags.Get(Flag::FlipU) ? 1 : 0;
 		uint flipV = mFlags.Get(Flag::FlipV) ? 2 : 0;
 
-		// Rotate the 4 corners using the inverse projection matrix
+		// Camera-facing axes taken from the inverse view matrix
 		graphics->ResetModelViewMatrix();
 		const Matrix43& invView = graphics->GetInverseModelViewMatrix();
 
-		// 4 corners of the particle
-		Vector3f v0 (-1.0f,  1.0f, 0.5f);
-		Vector3f v1 (-1.0f, -1.0f, 0.5f);
-		Vector3f v2 ( 1.0f, -1.0f, 0.5f);
-		Vector3f v3 ( 1.0f,  1.0f, 0.5f);
+		Vector3f axisX	(invView[0], invView[1], invView[2]);
+		Vector3f axisY	(invView[4], invView[5], invView[6]);
+		Vector3f offset	(invView[8] * 0.5f, invView[9] * 0.5f, invView[10] * 0.5f);
 
-		// Whether we need to transform the corners by the inverse view matrix
-		bool transform = true;
+		// The 4 corners are (-1, 1), (-1, -1), (1, -1) and (1, 1) rotated around the Z axis and offset by half
+		// the forward vector. Rotated corners are symmetrical, so only two of them need to be calculated.
+		Vector3f a (axisX + axisY), b (axisY - axisX);
 
 		// UV coordinates can be randomly flipped in order to add non-uniformness to the particle textures
 		float left, right, top, bottom, last = 0.0f;
 
-		// Time to re-fill the vertex information
+		// The vertex arrays only ever grow, so they get allocated once and are then simply overwritten
+		uint count = mActiveParts * 4;
 		mPositions.Clear();
 		mTexCoords.Clear();
 		mColors.Clear();
 
+		Vector3f* pos	= mPositions.ExpandTo(count);
+		Vector2f* tc	= mTexCoords.ExpandTo(count);
+		Color4ub* color = mColors.ExpandTo(count);
+
+		const Streams& s = mParticles;
+		uint written = 0;
+
 		// Run through all particles and update them one at a time
-		for (uint i = mParticles.GetSize(); i > 0; )
+		for (uint i = mCount; i > 0 && written < count; )
 		{
-			Particle& particle = mParticles[--i];
-			if (particle.mRemaining == 0) continue;
+			if (s.mRemaining[--i] == 0) continue;
 
 			// Add non-uniformness by flipping the texture coordinates, if allowed
 			if ( (i & flipU) == 1 )	{ left   = 1.0f;  right	= 0.0f; }
@@ -185,21 +556,23 @@ uint Emitter::OnDraw (TemporaryStorage& storage, uint group, const ITechnique* t
 			else					{ bottom = 0.0f;  top	= 1.0f; }
 
 			// Colors are identical across all 4 vertices
-			mColors.Expand() = particle.mColor;
-			mColors.Expand() = particle.mColor;
-			mColors.Expand() = particle.mColor;
-			mColors.Expand() = particle.mColor;
+			Color4ub c (s.mColor[i]);
+			if (s.mAlpha[i] < 1.0f) c.a = (byte)Float::RoundToInt(c.a * s.mAlpha[i]);
+			color[0] = c;
+			color[1] = c;
+			color[2] = c;
+			color[3] = c;
 
 			// Texture coordinates are also simple
-			mTexCoords.Expand().Set(left, top);
-			mTexCoords.Expand().Set(left, bottom);
-			mTexCoords.Expand().Set(right, bottom);
-			mTexCoords.Expand().Set(right, top);
+			tc[0].Set(left, top);
+			tc[1].Set(left, bottom);
+			tc[2].Set(right, bottom);
+			tc[3].Set(right, top);
 
-			// Rotate the particle if the rotation has changed
-			if (last != particle.mRotation)
+			// Rotate the corners if the rotation has changed
+			if (last != s.mRotation[i])
 			{
-				last = particle.mRotation;
+				last = s.mRotation[i];
 
 				float z =  Float::Sin(last);
 				float w = -Float::Cos(last);
@@ -207,32 +580,36 @@ uint Emitter::OnDraw (TemporaryStorage& storage, uint group, const ITechnique* t
 				float zw = z * w;
 				float zz = z * z;
 
-				// Optimized rotation of the 4 points based on the starting values above
-				// rotated by the quaternion created using the rotation around the Z axis.
+				// Optimized rotation of the (1, 1) corner by the quaternion created using the rotation around the Z axis
+				float x = 1.0f - (zw + zz) * 2.0f;
+				float y = 1.0f + (zw - zz) * 2.0f;
 
-				v3.Set(1.0f - (zw + zz) * 2.0f, 1.0f + (zw - zz) * 2.0f, 0.5f);
-				v0.Set(-v3.y,  v3.x, 0.5f);
-				v1.Set(-v3.x, -v3.y, 0.5f);
-				v2.Set( v3.y, -v3.x, 0.5f);
-
-				transform = true;
-			}
-
-			// Transform the vertices by the inverse view matrix if needed
-			if (transform)
-			{
-				transform = false;
-				v0 %= invView;
-				v1 %= invView;
-				v2 %= invView;
-				v3 %= invView;
+				a = axisX * x + axisY * y;
+				b = axisY * x - axisX * y;
 			}
 
 			// Vertex positions are based on the offset particle position
-			mPositions.Expand() = particle.mPos + v0 * particle.mRadius;
-			mPositions.Expand() = particle.mPos + v1 * particle.mRadius;
-			mPositions.Expand() = particle.mPos + v2 * particle.mRadius;
-			mPositions.Expand() = particle.mPos + v3 * particle.mRadius;
+			Vector3f center (s.mX[i], s.mY[i], s.mZ[i]);
+			float radius = s.mRadius[i];
+			center += offset * radius;
+
+			pos[0] = center + b * radius;
+			pos[1] = center - a * radius;
+			pos[2] = center - b * radius;
+			pos[3] = center + a * radius;
+
+			pos		+= 4;
+			tc		+= 4;
+			color	+= 4;
+			written += 4;
+		}
+
+		// Just in case the count was off, never draw vertices that weren't written
+		while (mPositions.GetSize() > written)
+		{
+			mPositions.Shrink();
+			mTexCoords.Shrink();
+			mColors.Shrink();
 		}
 	}
 
@@ -282,6 +659,13 @@ void Emitter::OnSerializeTo (TreeNode& root) const
 	root.AddChild("Lifetime",		mLifetime);
 	root.AddChild("Max Particles",	mMaxParticles);
 	root.AddChild("Frequency",		mFrequency);
+
+	// Built-in behaviours are only saved if they differ from the defaults
+	if (mBehavior.mGravity != Vector3f())			root.AddChild("Gravity",	mBehavior.mGravity);
+	if (mBehavior.mDrag != 0.0f)					root.AddChild("Drag",		mBehavior.mDrag);
+	if (mBehavior.mSize != Vector2f(1.0f, 1.0f))	root.AddChild("Size",		mBehavior.mSize);
+	if (mBehavior.mFade != Vector2f(0.0f, 0.0f))	root.AddChild("Fade",		mBehavior.mFade);
+	if (mBehavior.mSpin != 0.0f)					root.AddChild("Spin",		mBehavior.mSpin);
 }
 
 //============================================================================================================
@@ -318,5 +702,30 @@ bool Emitter::OnSerializeFrom (const TreeNode& node)
 		node.mValue >> mFrequency;
 		return true;
 	}
+	else if (node.mTag == "Gravity")
+	{
+		node.mValue >> mBehavior.mGravity;
+		return true;
+	}
+	else if (node.mTag == "Drag")
+	{
+		node.mValue >> mBehavior.mDrag;
+		return true;
+	}
+	else if (node.mTag == "Size")
+	{
+		node.mValue >> mBehavior.mSize;
+		return true;
+	}
+	else if (node.mTag == "Fade")
+	{
+		node.mValue >> mBehavior.mFade;
+		return true;
+	}
+	else if (node.mTag == "Spin")
+	{
+		node.mValue >> mBehavior.mSpin;
+		return true;
+	}
 	return false;
 }
@@ -42,31 +42,22 @@ void Glare::OnUpdate()
 }
 
 //============================================================================================================
-// Draw the billboard
+// Fills the quad representing the glare if it's visible
 //============================================================================================================
 
-uint Glare::OnDraw (TemporaryStorage& storage, uint group, const ITechnique* tech, void* param, bool insideOut)
+bool Glare::OnFillQuad (IGraphics* graphics, Quad& quad)
 {
-	// IGraphics::IsVisible() check is affected by the ModelView matrix
-	IGraphics* graphics = mCore->GetGraphics();
-
 	// If the point is visible, alpha should be moving toward '1'
-	if (graphics->IsPointVisible(mAbsolutePos)) _SetTargetAlpha(1.0f);
+	if (graphics->IsPointVisible(mQueryID, mAbsolutePos)) _SetTargetAlpha(1.0f);
 
 	// Current scale
 	const Vector3f& scale = mAbsoluteScale * mAlpha.y;
 
 	// Only draw the billboard if it's large enough to be drawn
-	if (!scale.IsZero())
-	{
-		graphics->ResetModelViewMatrix();
-		IGraphics* graphics = mCore->GetGraphics();
-		Matrix43 mat (graphics->GetViewMatrix());
-		mat.PreTranslate(mAbsolutePos);
-		mat.ReplaceScaling(scale);
-		graphics->SetModelViewMatrix(mat);
-		DrawBillboard();
-		graphics->ResetModelViewMatrix();
-	}
-	return 1;
+	if (scale.IsZero()) return false;
+
+	quad.mPos	= mAbsolutePos;
+	quad.mSize.Set(scale.x, scale.y);
+	quad.mColor = mColor;
+	return true;
 }
\ No newline at end of file
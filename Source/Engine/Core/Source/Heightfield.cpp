@@ -0,0 +1,365 @@
+#include "../Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Ray-box slab test used while walking the pyramid. Narrows down the [tmin, tmax] range on success.
+//============================================================================================================
+
+inline bool RayBox (const Vector3f& origin, const Vector3f& invDir, const Vector3f& min, const Vector3f& max,
+	float& tmin, float& tmax)
+{
+	float t0 = (min.x - origin.x) * invDir.x;
+	float t1 = (max.x - origin.x) * invDir.x;
+	if (t0 > t1) Swap(t0, t1);
+	if (t0 > tmin) tmin = t0;
+	if (t1 < tmax) tmax = t1;
+	if (tmin > tmax) return false;
+
+	t0 = (min.y - origin.y) * invDir.y;
+	t1 = (max.y - origin.y) * invDir.y;
+	if (t0 > t1) Swap(t0, t1);
+	if (t0 > tmin) tmin = t0;
+	if (t1 < tmax) tmax = t1;
+	if (tmin > tmax) return false;
+
+	t0 = (min.z - origin.z) * invDir.z;
+	t1 = (max.z - origin.z) * invDir.z;
+	if (t0 > t1) Swap(t0, t1);
+	if (t0 > tmin) tmin = t0;
+	if (t1 < tmax) tmax = t1;
+	return (tmin <= tmax);
+}
+
+//============================================================================================================
+// Ray-triangle intersection (Moller-Trumbore). Only front and back faces are both considered.
+//============================================================================================================
+
+inline bool RayTriangle (const Vector3f& origin, const Vector3f& dir, const Vector3f& v0, const Vector3f& v1,
+	const Vector3f& v2, float& t)
+{
+	Vector3f e1 (v1 - v0);
+	Vector3f e2 (v2 - v0);
+	Vector3f p  (Cross(dir, e2));
+
+	float det = e1.Dot(p);
+	if (Float::IsZero(det)) return false;
+
+	float inv = 1.0f / det;
+	Vector3f s (origin - v0);
+	float u = s.Dot(p) * inv;
+	if (u < 0.0f || u > 1.0f) return false;
+
+	Vector3f q (Cross(s, e1));
+	float v = dir.Dot(q) * inv;
+	if (v < 0.0f || u + v > 1.0f) return false;
+
+	t = e2.Dot(q) * inv;
+	return t >= 0.0f;
+}
+
+//============================================================================================================
+// Releases all memory used by the heightfield
+//============================================================================================================
+
+void Heightfield::Release()
+{
+	mSamples.Release();
+	mMinMax.Release();
+	mLevels.Release();
+	mWidth	= 0;
+	mHeight = 0;
+}
+
+//============================================================================================================
+// Creates the heightfield from the specified floating point buffer
+//============================================================================================================
+
+void Heightfield::Set (const float* buffer, uint width, uint height, const Vector3f& scale, const Vector3f& offset)
+{
+	Release();
+	if (buffer == 0 || width < 2 || height < 2) return;
+
+	mWidth	= width;
+	mHeight = height;
+	mScale	= scale;
+	mOffset = offset;
+
+	// Find the height range so that the samples can be quantized to 16 bits
+	uint count = width * height;
+	float low = buffer[0], high = buffer[0];
+
+	for (uint i = 1; i < count; ++i)
+	{
+		if (buffer[i] < low ) low  = buffer[i];
+		if (buffer[i] > high) high = buffer[i];
+	}
+
+	mMinZ	= low  * scale.z + offset.z;
+	mRangeZ	= (high - low) * scale.z;
+
+	// Quantize all samples
+	{
+		float factor = (high > low) ? 65535.0f / (high - low) : 0.0f;
+		ushort* sample = mSamples.ExpandTo(count);
+
+		for (uint i = 0; i < count; ++i)
+		{
+			sample[i] = (ushort)Float::RoundToUInt((buffer[i] - low) * factor);
+		}
+	}
+
+	// The most detailed level has a cell between every 4 neighboring samples
+	Level* level = &mLevels.Expand();
+	level->mWidth  = width  - 1;
+	level->mHeight = height - 1;
+	level->mOffset = 0;
+
+	ushort* mm = mMinMax.ExpandTo(level->mWidth * level->mHeight * 2);
+
+	for (uint y = 0; y < level->mHeight; ++y)
+	{
+		const ushort* row0 = mSamples.GetBuffer() + y * width;
+		const ushort* row1 = row0 + width;
+
+		for (uint x = 0; x < level->mWidth; ++x, mm += 2)
+		{
+			mm[0] = Min( Min(row0[x], row0[x+1]), Min(row1[x], row1[x+1]) );
+			mm[1] = Max( Max(row0[x], row0[x+1]), Max(row1[x], row1[x+1]) );
+		}
+	}
+
+	// Each following level combines 2x2 cells of the previous level until only one cell remains
+	while (level->mWidth > 1 || level->mHeight > 1)
+	{
+		Level prev = *level;
+		level = &mLevels.Expand();
+		level->mWidth  = (prev.mWidth  + 1) >> 1;
+		level->mHeight = (prev.mHeight + 1) >> 1;
+		level->mOffset = mMinMax.GetSize();
+
+		mMinMax.ExpandTo(level->mOffset + level->mWidth * level->mHeight * 2);
+		const ushort* src = mMinMax.GetBuffer() + prev.mOffset;
+		mm = mMinMax.GetBuffer() + level->mOffset;
+
+		for (uint y = 0; y < level->mHeight; ++y)
+		{
+			uint y0 = y << 1;
+			uint y1 = Min(y0 + 1, prev.mHeight - 1);
+
+			for (uint x = 0; x < level->mWidth; ++x, mm += 2)
+			{
+				uint x0 = x << 1;
+				uint x1 = Min(x0 + 1, prev.mWidth - 1);
+
+				const ushort* c00 = src + (x0 + y0 * prev.mWidth) * 2;
+				const ushort* c10 = src + (x1 + y0 * prev.mWidth) * 2;
+				const ushort* c01 = src + (x0 + y1 * prev.mWidth) * 2;
+				const ushort* c11 = src + (x1 + y1 * prev.mWidth) * 2;
+
+				mm[0] = Min( Min(c00[0], c10[0]), Min(c01[0], c11[0]) );
+				mm[1] = Max( Max(c00[1], c10[1]), Max(c01[1], c11[1]) );
+			}
+		}
+	}
+}
+
+//============================================================================================================
+// Returns the world-space height of the specified location in sample space
+//============================================================================================================
+
+float Heightfield::_GetHeight (float sx, float sy) const
+{
+	sx = Float::Clamp(sx, 0.0f, (float)(mWidth  - 1));
+	sy = Float::Clamp(sy, 0.0f, (float)(mHeight - 1));
+
+	uint x0 = Float::FloorToUInt(sx);
+	uint y0 = Float::FloorToUInt(sy);
+	uint x1 = Min(x0 + 1, mWidth  - 1);
+	uint y1 = Min(y0 + 1, mHeight - 1);
+
+	float fx = sx - x0;
+	float fy = sy - y0;
+
+	return	(_GetSample(x0, y0) * (1.0f - fx) + _GetSample(x1, y0) * fx) * (1.0f - fy) +
+			(_GetSample(x0, y1) * (1.0f - fx) + _GetSample(x1, y1) * fx) * fy;
+}
+
+//============================================================================================================
+// Retrieves the bilinearly filtered world-space height at the specified world-space XY coordinates
+//============================================================================================================
+
+float Heightfield::GetHeight (float x, float y) const
+{
+	if (!IsValid()) return 0.0f;
+	return _GetHeight(	(x - mOffset.x) / mScale.x * (mWidth  - 1),
+						(y - mOffset.y) / mScale.y * (mHeight - 1) );
+}
+
+//============================================================================================================
+// Retrieves the world-space normal at the specified world-space XY coordinates
+//============================================================================================================
+
+Vector3f Heightfield::GetNormal (float x, float y) const
+{
+	if (!IsValid()) return Vector3f(0.0f, 0.0f, 1.0f);
+
+	float sx = (x - mOffset.x) / mScale.x * (mWidth  - 1);
+	float sy = (y - mOffset.y) / mScale.y * (mHeight - 1);
+
+	// World-space distance between two neighboring samples
+	float dx = mScale.x / (mWidth  - 1);
+	float dy = mScale.y / (mHeight - 1);
+
+	// Central differences
+	float hx = _GetHeight(sx + 1.0f, sy) - _GetHeight(sx - 1.0f, sy);
+	float hy = _GetHeight(sx, sy + 1.0f) - _GetHeight(sx, sy - 1.0f);
+
+	Vector3f normal (-hx * dy, -hy * dx, 2.0f * dx * dy);
+	normal.Normalize();
+	return normal;
+}
+
+//============================================================================================================
+// Sets the Z component of all specified world-space positions to the height of the heightfield
+//============================================================================================================
+
+void Heightfield::GetHeights (Vector3f* positions, uint count, float offset) const
+{
+	if (!IsValid()) return;
+
+	float kx = (mWidth  - 1) / mScale.x;
+	float ky = (mHeight - 1) / mScale.y;
+
+	for (Vector3f* end = positions + count; positions != end; ++positions)
+	{
+		positions->z = _GetHeight(	(positions->x - mOffset.x) * kx,
+									(positions->y - mOffset.y) * ky ) + offset;
+	}
+}
+
+//============================================================================================================
+// Intersects the ray with the two triangles making up the specified cell of the most detailed level
+//============================================================================================================
+
+bool Heightfield::_RaycastCell (uint cx, uint cy, const Vector3f& origin, const Vector3f& dir, float& distance) const
+{
+	float fx = (float)cx;
+	float fy = (float)cy;
+
+	Vector3f v00 (fx,		 fy,		_GetSample(cx,	   cy	 ));
+	Vector3f v10 (fx + 1.0f, fy,		_GetSample(cx + 1, cy	 ));
+	Vector3f v01 (fx,		 fy + 1.0f, _GetSample(cx,	   cy + 1));
+	Vector3f v11 (fx + 1.0f, fy + 1.0f, _GetSample(cx + 1, cy + 1));
+
+	// Same split as the one used by the quads generated in TerrainNode::OnFill
+	float t0, t1;
+	bool hit0 = RayTriangle(origin, dir, v01, v00, v10, t0);
+	bool hit1 = RayTriangle(origin, dir, v01, v10, v11, t1);
+
+	if (hit0 && (!hit1 || t0 < t1)) { distance = t0; return true; }
+	if (hit1) { distance = t1; return true; }
+	return false;
+}
+
+//============================================================================================================
+// Casts a ray against the heightfield, skipping over regions of the pyramid that the ray can't hit.
+//============================================================================================================
+
+bool Heightfield::Raycast (const Vector3f& origin, const Vector3f& dir, float& distance, float maxDistance) const
+{
+	if (!IsValid()) return false;
+
+	float length = dir.Magnitude();
+	if (Float::IsZero(length)) return false;
+
+	// Transform the ray into sample space (XY in samples, Z in world units). This is an affine
+	// transform, so the distance along the ray remains proportional to the original ray's.
+	float kx = (mWidth  - 1) / mScale.x;
+	float ky = (mHeight - 1) / mScale.y;
+
+	Vector3f o ((origin.x - mOffset.x) * kx, (origin.y - mOffset.y) * ky, origin.z);
+	Vector3f d (dir.x * kx, dir.y * ky, dir.z);
+	Vector3f inv (	Float::IsZero(d.x) ? 1.0e30f : 1.0f / d.x,
+					Float::IsZero(d.y) ? 1.0e30f : 1.0f / d.y,
+					Float::IsZero(d.z) ? 1.0e30f : 1.0f / d.z );
+
+	float best	= maxDistance / length;
+	bool found	= false;
+	float quant = mRangeZ * (1.0f / 65535.0f);
+
+	// Order in which the children are visited: closest to the ray's origin first
+	uint nearX = (d.x < 0.0f) ? 1 : 0;
+	uint nearY = (d.y < 0.0f) ? 1 : 0;
+
+	// Each level pushes at most 4 entries, and there can be no more than 32 levels
+	struct Entry { uint level, x, y; } stack[128];
+	uint top = 0;
+
+	// Start with all the cells of the least detailed level
+	uint topLevel = mLevels.GetSize() - 1;
+	const Level& root = mLevels[topLevel];
+
+	for (uint y = 0; y < root.mHeight; ++y)
+	{
+		for (uint x = 0; x < root.mWidth; ++x)
+		{
+			Entry& e = stack[top++];
+			e.level = topLevel;
+			e.x = x;
+			e.y = y;
+		}
+	}
+
+	while (top > 0)
+	{
+		Entry e = stack[--top];
+		const Level& level = mLevels[e.level];
+		const ushort* mm = mMinMax.GetBuffer() + level.mOffset + (e.x + e.y * level.mWidth) * 2;
+
+		// Bounds of this cell in sample space, padded slightly to avoid precision-related misses
+		Vector3f min ((float)(e.x << e.level), (float)(e.y << e.level), mMinZ + quant * mm[0]);
+		Vector3f max ((float)Min((e.x + 1) << e.level, mWidth  - 1),
+					  (float)Min((e.y + 1) << e.level, mHeight - 1), mMinZ + quant * mm[1]);
+
+		min -= 0.001f;
+		max += 0.001f;
+
+		float tmin = 0.0f, tmax = best;
+		if (!RayBox(o, inv, min, max, tmin, tmax)) continue;
+
+		if (e.level == 0)
+		{
+			float t;
+
+			if (_RaycastCell(e.x, e.y, o, d, t) && t < best)
+			{
+				best  = t;
+				found = true;
+			}
+		}
+		else
+		{
+			// Push the children furthest-first so that the closest ones get popped first
+			const Level& child = mLevels[e.level - 1];
+			uint level = e.level - 1;
+
+			for (uint i = 4; i > 0; )
+			{
+				--i;
+				uint cx = (e.x << 1) + ((i & 1) ^ nearX);
+				uint cy = (e.y << 1) + (((i >> 1) & 1) ^ nearY);
+
+				if (cx < child.mWidth && cy < child.mHeight)
+				{
+					Entry& entry = stack[top++];
+					entry.level = level;
+					entry.x = cx;
+					entry.y = cy;
+				}
+			}
+		}
+	}
+
+	if (found) distance = best * length;
+	return found;
+}
@@ -4,6 +4,9 @@ using namespace R5;
 // Defined in Model.cpp
 extern bool g_skinToVBO;
 
+// Whether meshes should be optimized as they are loaded
+bool g_optimizeOnLoad = false;
+
 //============================================================================================================
 // Helpful macros that shorten the code below
 //============================================================================================================
@@ -105,6 +108,217 @@ uint CountBonesPerVertex (const Mesh::BoneWeights& bw)
 	}
 	return max;
 }
+
+//============================================================================================================
+// Quantization helpers used by the compact vertex format
+//============================================================================================================
+
+inline short ToNormalizedShort (float val)
+{
+	return (short)Float::RoundToInt(Float::Clamp(val, -1.0f, 1.0f) * 32767.0f);
+}
+
+inline ushort ToNormalizedUShort (float val)
+{
+	return (ushort)Float::RoundToUInt(Float::Clamp(val, 0.0f, 1.0f) * 65535.0f);
+}
+
+inline float FromNormalizedUShort (ushort val)
+{
+	return val * (1.0f / 65535.0f);
+}
+
+inline float SignOf (float val)
+{
+	return (val < 0.0f) ? -1.0f : 1.0f;
+}
+
+//============================================================================================================
+// Packs a normal or tangent into the VBO as 4 normalized shorts (the last one is padding)
+//============================================================================================================
+
+inline void PackNormal (byte* ptr, const Vector3f& v)
+{
+	short* s = (short*)ptr;
+	s[0] = ToNormalizedShort(v.x);
+	s[1] = ToNormalizedShort(v.y);
+	s[2] = ToNormalizedShort(v.z);
+	s[3] = 0;
+}
+
+//============================================================================================================
+// Packs a position into the VBO as 4 normalized shorts relative to the specified center and scale
+//============================================================================================================
+
+inline void PackPosition (byte* ptr, const Vector3f& v, const Vector3f& center, float invScale)
+{
+	short* s = (short*)ptr;
+	s[0] = ToNormalizedShort((v.x - center.x) * invScale);
+	s[1] = ToNormalizedShort((v.y - center.y) * invScale);
+	s[2] = ToNormalizedShort((v.z - center.z) * invScale);
+	s[3] = 0;
+}
+
+//============================================================================================================
+// Packs texture coordinates into the VBO as half-precision floats
+//============================================================================================================
+
+inline void PackTexCoord (byte* ptr, const Vector2f& v)
+{
+	ushort* h = (ushort*)ptr;
+	h[0] = Float::ToHalf(v.x);
+	h[1] = Float::ToHalf(v.y);
+}
+
+//============================================================================================================
+// Quantizes vertex positions to 16 bits per component, relative to the vertices' bounding box
+//============================================================================================================
+
+void EncodeVertices (const Mesh::Vertices& in, Array<ushort>& out, Vector3f& min, Vector3f& max)
+{
+	min = in[0];
+	max = in[0];
+
+	for (uint i = in.GetSize(); i > 1; )
+	{
+		const Vector3f& v = in[--i];
+		if (v.x < min.x) min.x = v.x; else if (v.x > max.x) max.x = v.x;
+		if (v.y < min.y) min.y = v.y; else if (v.y > max.y) max.y = v.y;
+		if (v.z < min.z) min.z = v.z; else if (v.z > max.z) max.z = v.z;
+	}
+
+	Vector3f range (max - min);
+	Vector3f scale (range.x > 0.0f ? 1.0f / range.x : 0.0f,
+					range.y > 0.0f ? 1.0f / range.y : 0.0f,
+					range.z > 0.0f ? 1.0f / range.z : 0.0f);
+
+	ushort* ptr = out.ExpandTo(in.GetSize() * 3);
+
+	for (uint i = 0, imax = in.GetSize(); i < imax; ++i)
+	{
+		const Vector3f& v = in[i];
+		*ptr++ = ToNormalizedUShort((v.x - min.x) * scale.x);
+		*ptr++ = ToNormalizedUShort((v.y - min.y) * scale.y);
+		*ptr++ = ToNormalizedUShort((v.z - min.z) * scale.z);
+	}
+}
+
+//============================================================================================================
+// Restores quantized vertex positions
+//============================================================================================================
+
+void DecodeVertices (const Array<ushort>& in, const Vector3f& min, const Vector3f& max, Mesh::Vertices& out)
+{
+	Vector3f range (max - min);
+	uint count = in.GetSize() / 3;
+	Vector3f* ptr = out.ExpandTo(count);
+
+	for (uint i = 0; i < count; ++i)
+	{
+		Vector3f& v = ptr[i];
+		v.x = min.x + range.x * FromNormalizedUShort(in[i * 3    ]);
+		v.y = min.y + range.y * FromNormalizedUShort(in[i * 3 + 1]);
+		v.z = min.z + range.z * FromNormalizedUShort(in[i * 3 + 2]);
+	}
+}
+
+//============================================================================================================
+// Encodes normals using octahedral mapping: 2 values per normal instead of 3
+//============================================================================================================
+
+void EncodeNormals (const Mesh::Normals& in, Array<ushort>& out)
+{
+	ushort* ptr = out.ExpandTo(in.GetSize() * 2);
+
+	for (uint i = 0, imax = in.GetSize(); i < imax; ++i)
+	{
+		const Vector3f& n = in[i];
+
+		// Project the normal onto the octahedron, folding the lower half over the upper one
+		float sum = Float::Abs(n.x) + Float::Abs(n.y) + Float::Abs(n.z);
+		float x = (sum > 0.0f) ? n.x / sum : 0.0f;
+		float y = (sum > 0.0f) ? n.y / sum : 0.0f;
+
+		if (n.z < 0.0f)
+		{
+			float fx = (1.0f - Float::Abs(y)) * SignOf(x);
+			float fy = (1.0f - Float::Abs(x)) * SignOf(y);
+			x = fx;
+			y = fy;
+		}
+
+		*ptr++ = ToNormalizedUShort(x * 0.5f + 0.5f);
+		*ptr++ = ToNormalizedUShort(y * 0.5f + 0.5f);
+	}
+}
+
+//============================================================================================================
+// Restores octahedral-encoded normals
+//============================================================================================================
+
+void DecodeNormals (const Array<ushort>& in, Mesh::Normals& out)
+{
+	uint count = in.GetSize() / 2;
+	Vector3f* ptr = out.ExpandTo(count);
+
+	for (uint i = 0; i < count; ++i)
+	{
+		float x = FromNormalizedUShort(in[i * 2    ]) * 2.0f - 1.0f;
+		float y = FromNormalizedUShort(in[i * 2 + 1]) * 2.0f - 1.0f;
+		float z = 1.0f - Float::Abs(x) - Float::Abs(y);
+
+		if (z < 0.0f)
+		{
+			float fx = (1.0f - Float::Abs(y)) * SignOf(x);
+			float fy = (1.0f - Float::Abs(x)) * SignOf(y);
+			x = fx;
+			y = fy;
+		}
+
+		Vector3f& n = ptr[i];
+		n.x = x;
+		n.y = y;
+		n.z = z;
+		n.Normalize();
+	}
+}
+
+//============================================================================================================
+// Converts texture coordinates to and from half-precision floats
+//============================================================================================================
+
+void EncodeTexCoords (const Mesh::TexCoords& in, Array<ushort>& out)
+{
+	ushort* ptr = out.ExpandTo(in.GetSize() * 2);
+
+	for (uint i = 0, imax = in.GetSize(); i < imax; ++i)
+	{
+		*ptr++ = Float::ToHalf(in[i].x);
+		*ptr++ = Float::ToHalf(in[i].y);
+	}
+}
+
+void DecodeTexCoords (const Array<ushort>& in, Mesh::TexCoords& out)
+{
+	uint count = in.GetSize() / 2;
+	Vector2f* ptr = out.ExpandTo(count);
+
+	for (uint i = 0; i < count; ++i)
+	{
+		ptr[i].x = Float::FromHalf(in[i * 2    ]);
+		ptr[i].y = Float::FromHalf(in[i * 2 + 1]);
+	}
+}
+
+//============================================================================================================
+// Number of weights used by the vertex, ignoring the trailing zero weights
+//============================================================================================================
+
+inline uint CountWeights (const Color4f& bw, uint maxWeights)
+{
+	while (maxWeights > 0 && bw[maxWeights - 1] == 0.0f) --maxWeights;
+	return maxWeights;
+}
 } // anonymous namespace
 
 //============================================================================================================
@@ -115,6 +329,8 @@ Mesh::Mesh (const String& name) :
 	mName				(name),
 	mBones				(0),
 	mGeneratedNormals	(true),
+	mCompact			(false),
+	mHalfFloat			(false),
 	mVbo				(0),
 	mTbo				(0),
 	mVboSize			(0),
@@ -122,6 +338,7 @@ Mesh::Mesh (const String& name) :
 	mPrimitive			(IGraphics::Primitive::Triangle),
 	mIbo				(0),
 	mIboSize			(0),
+	mIboType			(IGraphics::DataType::UShort),
 	mGraphics			(0) {}
 
 //============================================================================================================
@@ -184,6 +401,7 @@ void Mesh::_Clear()
 	mTv.Clear();
 	mTn.Clear();
 	mTt.Clear();
+	mSkin.Clear();
 	mIndices.Clear();
 	mBounds.Clear();
 }
@@ -436,60 +654,10 @@ void Mesh::Update ( bool rebuildBuffers,
 		mTv.Clear();
 		mTn.Clear();
 		mTt.Clear();
+		mSkin.Clear();
 
 		// Recalculate the vertex format
-		mFormat.Clear();
-
-		if (mV.IsValid())
-		{
-			mFormat.mVertex	    = mFormat.mFullSize;
-			mFormat.mFullSize  += mV.GetElementSize();
-			mFormat.mTransSize += mV.GetElementSize();
-		}
-
-		if (mN.IsValid())
-		{
-			mFormat.mNormal	    = mFormat.mFullSize;
-			mFormat.mFullSize  += mN.GetElementSize();
-			mFormat.mTransSize += mN.GetElementSize();
-		}
-
-		if (mT.IsValid())
-		{
-			mFormat.mTangent	= mFormat.mFullSize;
-			mFormat.mFullSize  += mT.GetElementSize();
-			mFormat.mTransSize += mT.GetElementSize();
-		}
-
-		if (mTc0.IsValid())
-		{
-			mFormat.mTexCoord0	= mFormat.mFullSize;
-			mFormat.mFullSize  += mTc0.GetElementSize();
-		}
-
-		if (mTc1.IsValid())
-		{
-			mFormat.mTexCoord1	= mFormat.mFullSize;
-			mFormat.mFullSize  += mTc1.GetElementSize();
-		}
-
-		if (mC.IsValid())
-		{
-			mFormat.mColor		= mFormat.mFullSize;
-			mFormat.mFullSize  += mC.GetElementSize();
-		}
-
-		if (mBi.IsValid())
-		{
-			mFormat.mBoneIndex	= mFormat.mFullSize;
-			mFormat.mFullSize  += mBi.GetElementSize();
-		}
-
-		if (mBw.IsValid())
-		{
-			mFormat.mBoneWeight = mFormat.mFullSize;
-			mFormat.mFullSize  += mBw.GetElementSize();
-		}
+		_UpdateFormat();
 
 		// Recalculate the bounds
 		_RecalculateBounds();
@@ -517,6 +685,194 @@ void Mesh::Update ( bool rebuildBuffers,
 #endif
 }
 
+//============================================================================================================
+// Recalculates the interleaved vertex format
+//============================================================================================================
+
+void Mesh::_UpdateFormat()
+{
+	mFormat.Clear();
+
+	// Skinned meshes share the position, normal and tangent layout with the transformed VBO, which is
+	// filled with floats on the CPU, so only unskinned meshes can have their normals and tangents packed.
+	bool packNormals	= mCompact && !HasBoneInfo();
+	bool packPositions	= packNormals && mV.IsValid();
+	bool packTexCoords	= mCompact && mHalfFloat;
+
+	if (packPositions)	mFormat.mVertexType		= IGraphics::DataType::Short;
+	if (packNormals)	mFormat.mNormalType		= IGraphics::DataType::Short | IGraphics::DataType::Normalized;
+	if (packTexCoords)	mFormat.mTexCoordType	= IGraphics::DataType::HalfFloat;
+	if (mCompact)		mFormat.mBoneWeightType	= IGraphics::DataType::Byte  | IGraphics::DataType::Normalized;
+
+	uint vertexSize		= packPositions	? sizeof(short) * 4		: sizeof(Vector3f);
+	uint normalSize		= packNormals	? sizeof(short) * 4		: sizeof(Vector3f);
+	uint texCoordSize	= packTexCoords	? sizeof(ushort) * 2	: sizeof(Vector2f);
+	uint weightSize		= mCompact		? sizeof(Color4ub)		: sizeof(Color4f);
+
+	if (mV.IsValid())
+	{
+		mFormat.mVertex	    = mFormat.mFullSize;
+		mFormat.mFullSize  += vertexSize;
+		mFormat.mTransSize += vertexSize;
+	}
+
+	// Quantized positions are stored relative to the center of the bounding box. The scale is uniform so that
+	// folding it into the model matrix affects normals and tangents the same way scaling an object does.
+	// Shorts are not flagged as normalized as fixed-function vertex arrays can't normalize positions, so
+	// the normalization is a part of the unpacking matrix instead.
+	if (packPositions)
+	{
+		Vector3f min (mV[0]), max (mV[0]);
+
+		for (uint i = mV.GetSize(); i > 1; )
+		{
+			const Vector3f& v = mV[--i];
+			if (v.x < min.x) min.x = v.x; else if (v.x > max.x) max.x = v.x;
+			if (v.y < min.y) min.y = v.y; else if (v.y > max.y) max.y = v.y;
+			if (v.z < min.z) min.z = v.z; else if (v.z > max.z) max.z = v.z;
+		}
+
+		Vector3f extents ((max - min) * 0.5f);
+		float scale = Max(extents.x, Max(extents.y, extents.z));
+		if (scale == 0.0f) scale = 1.0f;
+
+		scale *= 1.0f / 32767.0f;
+		mFormat.mUnpack.SetToTransform((min + max) * 0.5f, Vector3f(scale, scale, scale));
+	}
+
+	if (mN.IsValid())
+	{
+		mFormat.mNormal	    = mFormat.mFullSize;
+		mFormat.mFullSize  += normalSize;
+		mFormat.mTransSize += normalSize;
+	}
+
+	if (mT.IsValid())
+	{
+		mFormat.mTangent	= mFormat.mFullSize;
+		mFormat.mFullSize  += normalSize;
+		mFormat.mTransSize += normalSize;
+	}
+
+	if (mTc0.IsValid())
+	{
+		mFormat.mTexCoord0	= mFormat.mFullSize;
+		mFormat.mFullSize  += texCoordSize;
+	}
+
+	if (mTc1.IsValid())
+	{
+		mFormat.mTexCoord1	= mFormat.mFullSize;
+		mFormat.mFullSize  += texCoordSize;
+	}
+
+	if (mC.IsValid())
+	{
+		mFormat.mColor		= mFormat.mFullSize;
+		mFormat.mFullSize  += mC.GetElementSize();
+	}
+
+	if (mBi.IsValid())
+	{
+		mFormat.mBoneIndex	= mFormat.mFullSize;
+		mFormat.mFullSize  += mBi.GetElementSize();
+	}
+
+	if (mBw.IsValid())
+	{
+		mFormat.mBoneWeight = mFormat.mFullSize;
+		mFormat.mFullSize  += weightSize;
+	}
+}
+
+//============================================================================================================
+// Switches between the full precision and the compact vertex formats
+//============================================================================================================
+
+void Mesh::SetCompact (bool val)
+{
+	Lock();
+	{
+		if (mCompact != val)
+		{
+			mCompact = val;
+			mVboSize = 0;
+			_UpdateFormat();
+		}
+	}
+	Unlock();
+}
+
+//============================================================================================================
+// Welds duplicate vertices and reorders triangles and vertices for the GPU's caches
+//============================================================================================================
+
+bool Mesh::Optimize (MeshOptimizer::Stats* before, MeshOptimizer::Stats* after)
+{
+	bool retVal = false;
+
+	Lock();
+	{
+		// Rebuild the buffers, keeping the current normals and tangents
+		if ( (retVal = _Optimize(before, after)) ) Update(true, false, false, false, false, true);
+	}
+	Unlock();
+	return retVal;
+}
+
+//============================================================================================================
+// INTERNAL: Optimizes the mesh's arrays without rebuilding the buffers
+//============================================================================================================
+
+bool Mesh::_Optimize (MeshOptimizer::Stats* before, MeshOptimizer::Stats* after)
+{
+	if (mPrimitive != IGraphics::Primitive::Triangle || mV.IsEmpty()) return false;
+
+	// Unindexed meshes are treated as a list of triangles using every vertex in order
+	if (mIndices.IsEmpty())
+	{
+		Index* ptr = mIndices.ExpandTo(mV.GetSize());
+		for (uint i = mV.GetSize(); i > 0; ) { --i; ptr[i] = i; }
+	}
+
+	if (before != 0) MeshOptimizer::GetStats(mIndices, *before);
+
+	// All attributes are taken into account when looking for duplicate vertices
+	MeshOptimizer opt;
+	opt.AddStream(mV);
+	if (mN.GetSize()	== mV.GetSize()) opt.AddStream(mN);
+	if (mT.GetSize()	== mV.GetSize()) opt.AddStream(mT);
+	if (mTc0.GetSize()	== mV.GetSize()) opt.AddStream(mTc0);
+	if (mTc1.GetSize()	== mV.GetSize()) opt.AddStream(mTc1);
+	if (mC.GetSize()	== mV.GetSize()) opt.AddStream(mC);
+	if (mBi.GetSize()	== mV.GetSize()) opt.AddStream(mBi);
+	if (mBw.GetSize()	== mV.GetSize()) opt.AddStream(mBw);
+
+	Array<uint> remap;
+	uint count = opt.Optimize(mIndices, remap);
+
+	MeshOptimizer::Remap(mV,   remap, count);
+	MeshOptimizer::Remap(mN,   remap, count);
+	MeshOptimizer::Remap(mT,   remap, count);
+	MeshOptimizer::Remap(mTc0, remap, count);
+	MeshOptimizer::Remap(mTc1, remap, count);
+	MeshOptimizer::Remap(mC,   remap, count);
+	MeshOptimizer::Remap(mBi,  remap, count);
+	MeshOptimizer::Remap(mBw,  remap, count);
+
+	if (after != 0) MeshOptimizer::GetStats(mIndices, *after);
+	return true;
+}
+
+//============================================================================================================
+// Special: will either enable or disable optimizing meshes as they are loaded
+//============================================================================================================
+
+void Mesh::EnableOptimizeOnLoad (bool val)
+{
+	g_optimizeOnLoad = val;
+}
+
 //============================================================================================================
 // Returns the memory size used by the mesh
 //============================================================================================================
@@ -595,206 +951,200 @@ bool Mesh::ApplyTransforms (const Array<Matrix43>& transforms, uint instances)
 }
 
 //============================================================================================================
-// Common loop element, macro-defined to shorten the code as it repeats
+// INTERNAL: Groups the bone influences by bone, gathering the vertices, normals and tangents they affect
 //============================================================================================================
 
-#define COMMON_LOOP										\
-	--i;												\
-														\
-	const Color4ub& bi	= mBi[i];						\
-	const Color4f& bw	= mBw[i];						\
-														\
-	uint myWeights = maxWeights;						\
-														\
-	if (myWeights == 4 && bw[3] == 0.0f) --myWeights;	\
-	if (myWeights == 3 && bw[2] == 0.0f) --myWeights;	\
-	if (myWeights == 2 && bw[1] == 0.0f) --myWeights;	\
-	if (myWeights == 1 && bw[0] == 0.0f) --myWeights;
-
-//============================================================================================================
-
-#define VBO_VERTEX	byte* current = (ptr + mFormat.mTransSize * i);	\
-					const Vector3f& v	= mV [i];	\
-					Vector3f&		tv	= CURRENT_VERTEX;
-
-//============================================================================================================
+void Mesh::_PrepareSkin()
+{
+	uint maxWeights	= GetNumberOfWeights();
+	uint vertices	= mV.GetSize();
+	bool normals	= (mFormat.mNormal != 0xFFFFFFFF);
+	bool tangents	= (mFormat.mTangent != 0xFFFFFFFF) && normals;
+	uint counts[256];
+	uint bones = 0;
+
+	mSkin.Clear();
+	memset(counts, 0, sizeof(counts));
+
+	// Count the influences of every bone
+	for (uint i = 0; i < vertices; ++i)
+	{
+		const Color4ub& bi	= mBi[i];
+		uint weights		= CountWeights(mBw[i], maxWeights);
 
-#define VBO_NORMAL	const Vector3f& n  = mN [i];	\
-					Vector3f&		tn = CURRENT_NORMAL;
+		for (uint b = 0; b < weights; ++b)
+		{
+			++counts[bi[b]];
+			if (bones <= bi[b]) bones = bi[b] + 1;
+		}
+	}
 
-//============================================================================================================
+	// Turn the counts into the first influence of every bone
+	uint* first = mSkin.mFirst.ExpandTo(bones + 1);
+	uint total = 0;
 
-#define VBO_TANGENT	const Vector3f& t  = mT [i]; \
-					Vector3f&		tt = CURRENT_TANGENT;
+	for (uint b = 0; b < bones; ++b)
+	{
+		first[b]	= total;
+		total	   += counts[b];
+		counts[b]	= first[b];
+	}
+	first[bones] = total;
 
-//============================================================================================================
+	mSkin.mV.Resize(total);
+	mSkin.mTv.Resize(total);
 
-#define VA_VERTEX	const Vector3f& v	= mV [i];	\
-					Vector3f&		tv	= mTv[i];
+	if (normals)
+	{
+		mSkin.mN.Resize(total);
+		mSkin.mTn.Resize(total);
+	}
 
-//============================================================================================================
+	if (tangents)
+	{
+		mSkin.mT.Resize(total);
+		mSkin.mTt.Resize(total);
+	}
 
-#define VA_NORMAL	const Vector3f& n  = mN [i];	\
-					Vector3f&		tn = mTn[i];
+	// Gather the affected values in bone order, remembering where each vertex's influences ended up
+	uint* influence = mSkin.mInfluence.ExpandTo(vertices * maxWeights);
 
-//============================================================================================================
+	for (uint i = 0; i < vertices; ++i, influence += maxWeights)
+	{
+		const Color4ub& bi	= mBi[i];
+		uint weights		= CountWeights(mBw[i], maxWeights);
 
-#define VA_TANGENT	const Vector3f& t  = mT [i]; \
-					Vector3f&		tt = mTt[i];
+		for (uint b = 0; b < weights; ++b)
+		{
+			uint index = counts[bi[b]]++;
+			influence[b] = index;
+			mSkin.mV.Set(index, mV[i]);
+			if (normals)  mSkin.mN.Set(index, mN[i]);
+			if (tangents) mSkin.mT.Set(index, mT[i]);
+		}
+	}
+}
 
 //============================================================================================================
-// INTERNAL: Transforms the vertices using the specified matrices directly into the VBO
-//============================================================================================================
-// NOTE: This code was designed for speed over size, so it has a fair bit of duplication.
+// INTERNAL: Skins the vertices, normals and tangents, writing them every 'stride' bytes. Rather than going
+// through the bones of every vertex, all influences of a bone are transformed at once using its matrix,
+// after which every vertex adds up its weighted influences.
 //============================================================================================================
 
-bool Mesh::_TransformToVBO (const Array<Matrix43> &transforms)
+void Mesh::_Skin (const Array<Matrix43>& transforms, byte* v, byte* n, byte* t, uint stride)
 {
-	// Try to create a VBO
-	if (mTbo == 0) mTbo = mGraphics->CreateVBO();
+	if (mSkin.mFirst.IsEmpty()) _PrepareSkin();
 
-	// If VBO couldn't be created, nothing we can do
-	if (mTbo == 0) return false;
+	uint bones = mSkin.mFirst.GetSize() - 1;
+	ASSERT(bones <= transforms.GetSize(), "Bone index is out of range");
+	if (bones > transforms.GetSize()) bones = transforms.GetSize();
 
-	// Get the number of vertices
-	uint maxWeights = GetNumberOfWeights();
-	uint vertices   = GetNumberOfVertices();
-	ASSERT( vertices > 0, "Invalid number of vertices? How did this happen?" );
+	// Transform the influences of every bone
+	for (uint b = 0; b < bones; ++b)
+	{
+		const Matrix43& mat = transforms[b];
+		uint first = mSkin.mFirst[b];
+		uint count = mSkin.mFirst[b+1] - first;
 
-	// Transformed buffer size
-	mTboSize = mFormat.mTransSize * vertices;
-	ASSERT( mTboSize > 0, "Invalid VBO size" );
+		Batch::Transform(mat, mSkin.mV, mSkin.mTv, first, count);
+		if (n != 0) Batch::Rotate(mat, mSkin.mN, mSkin.mTn, first, count);
+		if (t != 0) Batch::Rotate(mat, mSkin.mT, mSkin.mTt, first, count);
+	}
 
-	mTbo->Lock();
+	uint maxWeights = GetNumberOfWeights();
+	const uint* influence = mSkin.mInfluence.GetBuffer();
+
+	// Blend the influences of every vertex
+	for (uint i = 0, imax = mV.GetSize(); i < imax; ++i, influence += maxWeights, v += stride)
 	{
-		// Reserve the required amount of space in the buffer
-		byte* ptr = mMem.Resize(mTboSize);
+		const Color4f& bw	= mBw[i];
+		uint weights		= CountWeights(bw, maxWeights);
+		Vector3f& tv		= *(Vector3f*)v;
 
-		IF_TANGENT_AND_NORMAL
+		if (weights != 0)
 		{
-			for (uint i = vertices; i > 0; )
-			{
-				COMMON_LOOP;
-				VBO_VERTEX;
-				VBO_NORMAL;
-				VBO_TANGENT;
-
-				if (myWeights != 0)
-				{
-					for (uint b = 0; b < myWeights; ++b)
-					{
-						const byte&	 boneIndex	= bi[b];
-						const float& boneWeight	= bw[b];
-
-						ASSERT(boneIndex < transforms.GetSize(), "Bone index is out of range");
-
-						const Matrix43& m = transforms[boneIndex];
+			tv = mSkin.mTv.Get(influence[0]) * bw[0];
+			for (uint b = 1; b < weights; ++b) tv += mSkin.mTv.Get(influence[b]) * bw[b];
+		}
+		else
+		{
+			tv = mV[i];
+		}
 
-						if (b == 0)
-						{
-							tv = (v	* m) * boneWeight;
-							tn = (n % m) * boneWeight;
-							tt = (t % m) * boneWeight;
-						}
-						else
-						{
-							tv += (v * m) * boneWeight;
-							tn += (n % m) * boneWeight;
-							tt += (t % m) * boneWeight;
-						}
-					}
+		if (n != 0)
+		{
+			Vector3f& tn = *(Vector3f*)n;
+			n += stride;
 
-					if (myWeights > 1)
-					{
-						tn.Normalize();
-						tt.Normalize();
-					}
-				}
-				else
-				{
-					tv = v;
-					tn = n;
-					tt = t;
-				}
+			if (weights != 0)
+			{
+				tn = mSkin.mTn.Get(influence[0]) * bw[0];
+				for (uint b = 1; b < weights; ++b) tn += mSkin.mTn.Get(influence[b]) * bw[b];
+				if (weights > 1) tn.Normalize();
 			}
-		}
-		else IF_NORMAL
-		{
-			for (uint i = vertices; i > 0; )
+			else
 			{
-				COMMON_LOOP;
-				VBO_VERTEX;
-				VBO_NORMAL;
+				tn = mN[i];
+			}
+		}
 
-				if (myWeights != 0)
-				{
-					for (uint b = 0; b < myWeights; ++b)
-					{
-						const byte&	 boneIndex	= bi[b];
-						const float& boneWeight	= bw[b];
+		if (t != 0)
+		{
+			Vector3f& tt = *(Vector3f*)t;
+			t += stride;
 
-						ASSERT(boneIndex < transforms.GetSize(), "Bone index is out of range");
+			if (weights != 0)
+			{
+				tt = mSkin.mTt.Get(influence[0]) * bw[0];
+				for (uint b = 1; b < weights; ++b) tt += mSkin.mTt.Get(influence[b]) * bw[b];
+				if (weights > 1) tt.Normalize();
+			}
+			else
+			{
+				tt = mT[i];
+			}
+		}
+	}
+}
 
-						const Matrix43& m = transforms[boneIndex];
+//============================================================================================================
+// INTERNAL: Transforms the vertices using the specified matrices directly into the VBO
+//============================================================================================================
 
-						if (b == 0)
-						{
-							tv = (v	* m) * boneWeight;
-							tn = (n % m) * boneWeight;
-						}
-						else
-						{
-							tv += (v * m) * boneWeight;
-							tn += (n % m) * boneWeight;
-						}
-					}
+bool Mesh::_TransformToVBO (const Array<Matrix43> &transforms)
+{
+	// Try to create a VBO
+	if (mTbo == 0) mTbo = mGraphics->CreateVBO();
 
-					if (myWeights > 1)
-					{
-						tn.Normalize();
-					}
-				}
-				else
-				{
-					tv = v;
-					tn = n;
-				}
-			}
-		}
-		else
-		{
-			for (uint i = vertices; i > 0; )
-			{
-				COMMON_LOOP;
-				VBO_VERTEX;
+	// If VBO couldn't be created, nothing we can do
+	if (mTbo == 0) return false;
 
-				if (myWeights != 0)
-				{
-					for (uint b = 0; b < myWeights; ++b)
-					{
-						const byte&	 boneIndex	= bi[b];
-						const float& boneWeight	= bw[b];
+	// Get the number of vertices
+	uint vertices = GetNumberOfVertices();
+	ASSERT( vertices > 0, "Invalid number of vertices? How did this happen?" );
 
-						ASSERT(boneIndex < transforms.GetSize(), "Bone index is out of range");
+	// Transformed buffer size
+	mTboSize = mFormat.mTransSize * vertices;
+	ASSERT( mTboSize > 0, "Invalid VBO size" );
 
-						const Matrix43& m = transforms[boneIndex];
+	mTbo->Lock();
+	{
+		// Reserve the required amount of space in the buffer
+		byte* ptr = mMem.Resize(mTboSize);
+		byte* n = 0;
+		byte* t = 0;
 
-						if (b == 0)
-						{
-							tv = (v	* m) * boneWeight;
-						}
-						else
-						{
-							tv += (v * m) * boneWeight;
-						}
-					}
-				}
-				else
-				{
-					tv = v;
-				}
-			}
+		IF_TANGENT_AND_NORMAL
+		{
+			n = ptr + mFormat.mNormal;
+			t = ptr + mFormat.mTangent;
 		}
+		else IF_NORMAL
+		{
+			n = ptr + mFormat.mNormal;
+		}
+
+		_Skin(transforms, ptr + mFormat.mVertex, n, t, mFormat.mTransSize);
 
 		// Copy the local memory buffer to the VBO
 		mTbo->Set(mMem.GetBuffer(), mMem.GetSize(), IVBO::Type::Vertex);
@@ -806,14 +1156,9 @@ bool Mesh::_TransformToVBO (const Array<Matrix43> &transforms)
 //============================================================================================================
 // INTERNAL: Transforms vertices, normals, and tangents into vertex arrays
 //============================================================================================================
-// NOTE: Just like its VBO counterpart above this function was designed for speed over size.
-//============================================================================================================
 
 void Mesh::_TransformToVAs (const Array<Matrix43>& transforms)
 {
-	// Get the number of vertices
-	uint maxWeights = GetNumberOfWeights();
-
 	// If the vertices changed, resize the transformed arrays
 	{
 		if (mV.GetSize() != mTv.GetSize())
@@ -835,132 +1180,20 @@ void Mesh::_TransformToVAs (const Array<Matrix43>& transforms)
 		}
 	}
 
+	byte* n = 0;
+	byte* t = 0;
+
 	IF_TANGENT_AND_NORMAL
 	{
-		// Run through all vertices and calculate transformed values
-		for (uint i = mV.GetSize(); i > 0; )
-		{
-			COMMON_LOOP;
-			VA_VERTEX;
-			VA_NORMAL;
-			VA_TANGENT;
-
-			if (myWeights != 0)
-			{
-				for (uint b = 0; b < myWeights; ++b)
-				{
-					const byte&	 boneIndex	= bi[b];
-					const float& boneWeight	= bw[b];
-
-					ASSERT(boneIndex < transforms.GetSize(), "Bone index is out of range");
-
-					const Matrix43& m = transforms[boneIndex];
-
-					if (b == 0)
-					{
-						tv = (v	* m) * boneWeight;
-						tn = (n % m) * boneWeight;
-						tt = (t % m) * boneWeight;
-					}
-					else
-					{
-						tv += (v * m) * boneWeight;
-						tn += (n % m) * boneWeight;
-						tt += (t % m) * boneWeight;
-					}
-				}
-
-				if (myWeights > 1)
-				{
-					tn.Normalize();
-					tt.Normalize();
-				}
-			}
-			else
-			{
-				tv = v;
-				tn = n;
-				tt = t;
-			}
-		}
+		n = (byte*)mTn.GetBuffer();
+		t = (byte*)mTt.GetBuffer();
 	}
 	else IF_NORMAL
 	{
-		for (uint i = mV.GetSize(); i > 0; )
-		{
-			COMMON_LOOP;
-			VA_VERTEX;
-			VA_NORMAL;
-
-			if (myWeights != 0)
-			{
-				for (uint b = 0; b < myWeights; ++b)
-				{
-					const byte&	 boneIndex	= bi[b];
-					const float& boneWeight	= bw[b];
-
-					ASSERT(boneIndex < transforms.GetSize(), "Bone index is out of range");
-
-					const Matrix43& m = transforms[boneIndex];
-
-					if (b == 0)
-					{
-						tv = (v	* m) * boneWeight;
-						tn = (n % m) * boneWeight;
-					}
-					else
-					{
-						tv += (v * m) * boneWeight;
-						tn += (n % m) * boneWeight;
-					}
-				}
-
-				if (myWeights > 1)
-				{
-					tn.Normalize();
-				}
-			}
-			else
-			{
-				tv = v;
-				tn = n;
-			}
-		}
+		n = (byte*)mTn.GetBuffer();
 	}
-	else
-	{
-		for (uint i = mV.GetSize(); i > 0; )
-		{
-			COMMON_LOOP;
-			VA_VERTEX;
 
-			if (myWeights != 0)
-			{
-				for (uint b = 0; b < myWeights; ++b)
-				{
-					const byte&	 boneIndex	= bi[b];
-					const float& boneWeight	= bw[b];
-
-					ASSERT(boneIndex < transforms.GetSize(), "Bone index is out of range");
-
-					const Matrix43& m = transforms[boneIndex];
-
-					if (b == 0)
-					{
-						tv = (v	* m) * boneWeight;
-					}
-					else
-					{
-						tv += (v * m) * boneWeight;
-					}
-				}
-			}
-			else
-			{
-				tv = v;
-			}
-		}
-	}
+	_Skin(transforms, (byte*)mTv.GetBuffer(), n, t, sizeof(Vector3f));
 }
 
 //============================================================================================================
@@ -988,6 +1221,18 @@ uint Mesh::GetNumberOfVertices() const
 	return vertices;
 }
 
+//============================================================================================================
+// Whether the mesh's buffers have already been uploaded, making it possible to record its draw calls
+//============================================================================================================
+
+bool Mesh::IsUploaded() const
+{
+	if (mGraphics == 0) return false;
+	if (mVboSize == 0 && GetNumberOfVertices() != 0) return false;
+	if (mIboSize == 0 && mIndices.IsValid()) return false;
+	return true;
+}
+
 //============================================================================================================
 // Draws the mesh, sending the data to the graphics controller
 //============================================================================================================
@@ -997,12 +1242,13 @@ uint Mesh::Draw (IGraphics* graphics)
 	uint result(0);
 
 #ifdef _DEBUG
-	if (mGraphics != 0) ASSERT(mGraphics == graphics, "Graphics controller doesn't match!");
+	if (mGraphics != 0 && CommandList::GetActive() == 0) ASSERT(mGraphics == graphics, "Graphics controller doesn't match!");
 #endif
 
 	Lock();
 	{
-		mGraphics = graphics;
+		// Recorded draw calls only happen after the mesh has been uploaded, so they don't change the controller
+		if (mGraphics == 0) mGraphics = graphics;
 
 		// Determine the number of vertices
 		uint vertices = GetNumberOfVertices();
@@ -1010,6 +1256,13 @@ uint Mesh::Draw (IGraphics* graphics)
 		// If the vertex count has been reset, and there is data present, recreate the VBO
 		if ( mVboSize == 0 && vertices != 0 )
 		{
+			// Half-float attributes depend on the device, so compact meshes finalize their format here
+			if (mCompact && mHalfFloat != graphics->GetDeviceInfo().mHalfFloatVertex)
+			{
+				mHalfFloat = !mHalfFloat;
+				_UpdateFormat();
+			}
+
 #ifdef _DEBUG
 			// All sizes must match up
 			ASSERT(mV.IsEmpty()   || mV.GetSize()	== vertices, "Size mismatch!");
@@ -1036,20 +1289,57 @@ uint Mesh::Draw (IGraphics* graphics)
 				// Resize the buffer to fit our VBO's contents
 				byte* ptr = mMem.Resize(mVboSize);
 
+				bool packPositions	= (mFormat.mVertexType		!= IGraphics::DataType::Float);
+				bool packNormals	= (mFormat.mNormalType		!= IGraphics::DataType::Float);
+				bool packTexCoords	= (mFormat.mTexCoordType	!= IGraphics::DataType::Float);
+				bool packWeights	= (mFormat.mBoneWeightType	!= IGraphics::DataType::Float);
+
+				// Quantized positions are relative to the center of the bounding box (the unpacking matrix)
+				Vector3f center		(mFormat.mUnpack.x, mFormat.mUnpack.y, mFormat.mUnpack.z);
+				float invScale		= 1.0f / (mFormat.mUnpack[0] * 32767.0f);
+
 				// Fill in all the vertex information
 				for (uint i = vertices; i > 0; )
 				{
 					--i;
 					byte* current = (ptr + mFormat.mFullSize * i);
 
-					IF_VERTEX		CURRENT_VERTEX		= mV[i];
-					IF_NORMAL		CURRENT_NORMAL		= mN[i];
-					IF_TANGENT		CURRENT_TANGENT		= mT[i];
-					IF_TEXCOORD0	CURRENT_TEXCOORD0	= mTc0[i];
-					IF_TEXCOORD1	CURRENT_TEXCOORD1	= mTc1[i];
+					IF_VERTEX
+					{
+						if (packPositions) PackPosition(current + mFormat.mVertex, mV[i], center, invScale);
+						else CURRENT_VERTEX = mV[i];
+					}
+
 					IF_COLOR		CURRENT_COLOR		= mC[i];
 					IF_BONEINDEX	CURRENT_BONEINDEX	= mBi[i];
-					IF_BONEWEIGHT	CURRENT_BONEWEIGHT	= mBw[i];
+
+					if (packNormals)
+					{
+						IF_NORMAL		PackNormal(current + mFormat.mNormal,  mN[i]);
+						IF_TANGENT		PackNormal(current + mFormat.mTangent, mT[i]);
+					}
+					else
+					{
+						IF_NORMAL		CURRENT_NORMAL		= mN[i];
+						IF_TANGENT		CURRENT_TANGENT		= mT[i];
+					}
+
+					if (packTexCoords)
+					{
+						IF_TEXCOORD0	PackTexCoord(current + mFormat.mTexCoord0, mTc0[i]);
+						IF_TEXCOORD1	PackTexCoord(current + mFormat.mTexCoord1, mTc1[i]);
+					}
+					else
+					{
+						IF_TEXCOORD0	CURRENT_TEXCOORD0	= mTc0[i];
+						IF_TEXCOORD1	CURRENT_TEXCOORD1	= mTc1[i];
+					}
+
+					IF_BONEWEIGHT
+					{
+						if (packWeights) *((Color4ub*)(current + mFormat.mBoneWeight)) = mBw[i];
+						else CURRENT_BONEWEIGHT = mBw[i];
+					}
 				}
 
 				mVbo->Lock();
@@ -1071,7 +1361,24 @@ uint Mesh::Draw (IGraphics* graphics)
 			if (mIbo != 0)
 			{
 				mIbo->Lock();
-				mIbo->Set(mIndices, IVBO::Type::Index, false);
+				{
+					// Indices are only uploaded as 32-bit values if the mesh has too many vertices for 16 bits
+					if (vertices > 65536)
+					{
+						mIboType = IGraphics::DataType::UInt;
+						mIbo->Set(mIndices, IVBO::Type::Index, false);
+					}
+					else
+					{
+						Arena::Scope scope (FrameArena::Get());
+						Array<ushort> ind (FrameArena::Get());
+						ushort* ptr = ind.ExpandTo(mIboSize);
+						for (uint i = mIboSize; i > 0; ) { --i; ptr[i] = (ushort)mIndices[i]; }
+
+						mIboType = IGraphics::DataType::UShort;
+						mIbo->Set(ind, IVBO::Type::Index, false);
+					}
+				}
 				mIbo->Unlock();
 			}
 		}
@@ -1089,7 +1396,7 @@ uint Mesh::Draw (IGraphics* graphics)
 					{
 						// Texture coordinates are in the VBO
 						graphics->SetActiveVertexAttribute( IGraphics::Attribute::TexCoord0, mVbo,
-							mFormat.mTexCoord0, IGraphics::DataType::Float, 2, mFormat.mFullSize );
+							mFormat.mTexCoord0, mFormat.mTexCoordType, 2, mFormat.mFullSize );
 					}
 					else
 					{
@@ -1112,7 +1419,7 @@ uint Mesh::Draw (IGraphics* graphics)
 					{
 						// Texture coordinates are in the VBO
 						graphics->SetActiveVertexAttribute( IGraphics::Attribute::TexCoord1, mVbo,
-							mFormat.mTexCoord1, IGraphics::DataType::Float, 2, mFormat.mFullSize );
+							mFormat.mTexCoord1, mFormat.mTexCoordType, 2, mFormat.mFullSize );
 					}
 					else
 					{
@@ -1158,7 +1465,7 @@ uint Mesh::Draw (IGraphics* graphics)
 					{
 						// Texture coordinates are in the VBO
 						graphics->SetActiveVertexAttribute( IGraphics::Attribute::BoneWeight, mVbo,
-							mFormat.mBoneWeight, IGraphics::DataType::Float, 4, mFormat.mFullSize );
+							mFormat.mBoneWeight, mFormat.mBoneWeightType, 4, mFormat.mFullSize );
 					}
 					else
 					{
@@ -1215,7 +1522,7 @@ uint Mesh::Draw (IGraphics* graphics)
 					{
 						// No transformed normals, but there are normals present in the VBO
 						graphics->SetActiveVertexAttribute( IGraphics::Attribute::Normal, mVbo,
-							mFormat.mNormal, IGraphics::DataType::Float, 3, mFormat.mFullSize );
+							mFormat.mNormal, mFormat.mNormalType, 3, mFormat.mFullSize );
 					}
 					else
 					{
@@ -1249,7 +1556,7 @@ uint Mesh::Draw (IGraphics* graphics)
 					{
 						// Tangents are in the VBO
 						graphics->SetActiveVertexAttribute( IGraphics::Attribute::Tangent, mVbo,
-							mFormat.mTangent, IGraphics::DataType::Float, 3, mFormat.mFullSize );
+							mFormat.mTangent, mFormat.mNormalType, 3, mFormat.mFullSize );
 					}
 					else
 					{
@@ -1264,6 +1571,9 @@ uint Mesh::Draw (IGraphics* graphics)
 				}
 			}
 
+			// Quantized positions need the model matrix to restore them, drawn positions are in model space otherwise
+			bool unpack = false;
+
 			// Vertex positions
 			{
 				if ( mTv.GetSize() == vertices )
@@ -1283,7 +1593,8 @@ uint Mesh::Draw (IGraphics* graphics)
 					{
 						// Vertices are in the VBO
 						graphics->SetActiveVertexAttribute( IGraphics::Attribute::Vertex, mVbo,
-							mFormat.mVertex, IGraphics::DataType::Float, 3, mFormat.mFullSize );
+							mFormat.mVertex, mFormat.mVertexType, 3, mFormat.mFullSize );
+						unpack = (mFormat.mVertexType != IGraphics::DataType::Float);
 					}
 					else
 					{
@@ -1293,10 +1604,18 @@ uint Mesh::Draw (IGraphics* graphics)
 				}
 			}
 
+			Matrix43 model;
+
+			if (unpack)
+			{
+				model = graphics->GetModelMatrix();
+				graphics->SetModelMatrix(mFormat.mUnpack * model);
+			}
+
 			if (mIbo != 0)
 			{
 				// Indices are in the VBO
-				result += graphics->DrawIndices( mIbo, mPrimitive, mIboSize );
+				result += graphics->DrawIndices( mIbo, mPrimitive, mIboSize, mIboType );
 			}
 			else if (mIndices.IsValid())
 			{
@@ -1308,12 +1627,57 @@ uint Mesh::Draw (IGraphics* graphics)
 				// No index buffer specified -- draw all vertices
 				result += graphics->DrawVertices( mPrimitive, vertices );
 			}
+
+			// Restore the original model matrix
+			if (unpack) graphics->SetModelMatrix(model);
 		}
 	}
 	Unlock();
 	return result;
 }
 
+//============================================================================================================
+// Tags recognized by Mesh::SerializeFrom(), in the same order as the values below
+//============================================================================================================
+
+struct MeshTag
+{
+	enum
+	{
+		Vertices,
+		Normals,
+		TexCoords0,
+		TexCoords1,
+		Colors,
+		BoneWeights,
+		BoneIndices,
+		CompactVertices,
+		CompactNormals,
+		CompactTexCoords0,
+		CompactTexCoords1,
+		CompactBoneWeights,
+	};
+};
+
+const char* g_meshTags[] =
+{
+	"Vertices",
+	"Normals",
+	"TexCoords 0",
+	"TexCoords 1",
+	"Colors",
+	"Bone Weights",
+	"Bone Indices",
+	"Compact Vertices",
+	"Compact Normals",
+	"Compact TexCoords 0",
+	"Compact TexCoords 1",
+	"Compact Bone Weights",
+	0
+};
+
+TagMap g_meshTagMap (g_meshTags);
+
 //============================================================================================================
 // Serialization -- Load
 //============================================================================================================
@@ -1325,6 +1689,7 @@ bool Mesh::SerializeFrom (const TreeNode& root, bool forceUpdate)
 	Lock();
 	{
 		_Clear();
+		mCompact = false;
 
 		bool buffers	= false,
 			 normals	= false,
@@ -1340,90 +1705,193 @@ bool Mesh::SerializeFrom (const TreeNode& root, bool forceUpdate)
 			const String&	tag		= node.mTag;
 			const Variable&	value	= node.mValue;
 
-			if ( tag == "Vertices" )
+			switch (g_meshTagMap[node])
 			{
-				if (value.IsVector3fArray())
+				case MeshTag::Vertices:
 				{
-					mV.CopyMemory(value.AsVector3fArray());
-					success = true;
-					buffers = true;
+					if (value.IsVector3fArray())
+					{
+						mV.CopyMemory(value.AsVector3fArray());
+						success = true;
+						buffers = true;
+					}
 				}
-			}
-			else if ( tag == "Normals" )
-			{
-				if (value.IsVector3fArray())
+				break;
+
+				case MeshTag::Normals:
 				{
-					mN.CopyMemory(value.AsVector3fArray());
-					success = true;
-					normals = true;
-					buffers = true;
-					mGeneratedNormals = false;
+					if (value.IsVector3fArray())
+					{
+						mN.CopyMemory(value.AsVector3fArray());
+						success = true;
+						normals = true;
+						buffers = true;
+						mGeneratedNormals = false;
+					}
 				}
-			}
-			else if ( tag == "TexCoords 0" )
-			{
-				if (value.IsVector2fArray())
+				break;
+
+				case MeshTag::TexCoords0:
 				{
-					mTc0.CopyMemory(value.AsVector2fArray());
-					success = true;
-					buffers = true;
-					texCoords = true;
+					if (value.IsVector2fArray())
+					{
+						mTc0.CopyMemory(value.AsVector2fArray());
+						success = true;
+						buffers = true;
+						texCoords = true;
+					}
 				}
-			}
-			else if ( tag == "TexCoords 1" )
-			{
-				if (value.IsVector2fArray())
+				break;
+
+				case MeshTag::TexCoords1:
 				{
-					mTc1.CopyMemory(value.AsVector2fArray());
-					success = true;
-					buffers = true;
+					if (value.IsVector2fArray())
+					{
+						mTc1.CopyMemory(value.AsVector2fArray());
+						success = true;
+						buffers = true;
+					}
 				}
-			}
-			else if ( tag == "Colors" )
-			{
-				if (value.IsColor4ubArray())
+				break;
+
+				case MeshTag::Colors:
 				{
-					mC.CopyMemory(value.AsColor4ubArray());
-					success = true;
-					buffers = true;
+					if (value.IsColor4ubArray())
+					{
+						mC.CopyMemory(value.AsColor4ubArray());
+						success = true;
+						buffers = true;
+					}
 				}
-			}
-			else if ( tag == "Bone Weights" )
-			{
-				if (value.IsColor4fArray())
+				break;
+
+				case MeshTag::BoneWeights:
 				{
-					mBw.CopyMemory(value.AsColor4fArray());
-					success = true;
-					buffers = true;
-					boneInfo = true;
+					if (value.IsColor4fArray())
+					{
+						mBw.CopyMemory(value.AsColor4fArray());
+						success = true;
+						buffers = true;
+						boneInfo = true;
+					}
 				}
-			}
-			else if ( tag == "Bone Indices" )
-			{
-				if (value.IsColor4ubArray())
+				break;
+
+				case MeshTag::BoneIndices:
+				{
+					if (value.IsColor4ubArray())
+					{
+						mBi.CopyMemory(value.AsColor4ubArray());
+						success = true;
+						buffers = true;
+						boneInfo = true;
+					}
+				}
+				break;
+
+				case MeshTag::CompactVertices:
 				{
-					mBi.CopyMemory(value.AsColor4ubArray());
-					success = true;
-					buffers = true;
-					boneInfo = true;
+					Vector3f min, max;
+
+					// Quantized vertices are relative to the bounds saved as child nodes
+					for (uint b = 0; b < node.mChildren.GetSize(); ++b)
+					{
+						const TreeNode& bound = node.mChildren[b];
+						if		(bound.mTag == "Min") bound.mValue >> min;
+						else if (bound.mTag == "Max") bound.mValue >> max;
+					}
+
+					if (value.IsUShortArray())
+					{
+						DecodeVertices(value.AsUShortArray(), min, max, mV);
+						success = true;
+						buffers = true;
+						mCompact = true;
+					}
 				}
-			}
-			else
-			{
-				uint primitive = ::GetPrimitive(tag);
+				break;
 
-				if (primitive != INVALID_VAL)
+				case MeshTag::CompactNormals:
 				{
-					mPrimitive = primitive;
+					if (value.IsUShortArray())
+					{
+						DecodeNormals(value.AsUShortArray(), mN);
+						success = true;
+						normals = true;
+						buffers = true;
+						mCompact = true;
+						mGeneratedNormals = false;
+					}
+				}
+				break;
 
+				case MeshTag::CompactTexCoords0:
+				{
 					if (value.IsUShortArray())
 					{
-						mIndices.CopyMemory(value.AsUShortArray());
+						DecodeTexCoords(value.AsUShortArray(), mTc0);
 						success = true;
 						buffers = true;
-						indices = true;
+						texCoords = true;
+						mCompact = true;
+					}
+				}
+				break;
+
+				case MeshTag::CompactTexCoords1:
+				{
+					if (value.IsUShortArray())
+					{
+						DecodeTexCoords(value.AsUShortArray(), mTc1);
+						success = true;
+						buffers = true;
+						mCompact = true;
+					}
+				}
+				break;
+
+				case MeshTag::CompactBoneWeights:
+				{
+					if (value.IsColor4ubArray())
+					{
+						const Array<Color4ub>& weights = value.AsColor4ubArray();
+						Color4f* ptr = mBw.ExpandTo(weights.GetSize());
+						for (uint b = weights.GetSize(); b > 0; ) { --b; ptr[b] = weights[b]; }
+						success = true;
+						buffers = true;
+						boneInfo = true;
+						mCompact = true;
+					}
+				}
+				break;
+
+				default:
+				{
+					uint primitive = ::GetPrimitive(tag);
+
+					if (primitive != INVALID_VAL)
+					{
+						mPrimitive = primitive;
+
+						if (value.IsUIntArray())
+						{
+							mIndices.CopyMemory(value.AsUIntArray());
+							success = true;
+							buffers = true;
+							indices = true;
+						}
+						else if (value.IsUShortArray())
+						{
+							const Array<ushort>& in = value.AsUShortArray();
+							Index* ptr = mIndices.ExpandTo(in.GetSize());
+							for (uint b = in.GetSize(); b > 0; ) { --b; ptr[b] = in[b]; }
+							success = true;
+							buffers = true;
+							indices = true;
+						}
 					}
 				}
+				break;
 			}
 
 			if (!success)
@@ -1434,6 +1902,9 @@ bool Mesh::SerializeFrom (const TreeNode& root, bool forceUpdate)
 			}
 		}
 
+		// Optimize the mesh before the normals and tangents are generated
+		if (g_optimizeOnLoad && buffers && _Optimize(0, 0)) indices = true;
+
 		// Update everything
 		Update(buffers, mGeneratedNormals, normals || texCoords, texCoords, boneInfo, indices);
 	}
@@ -1454,28 +1925,61 @@ bool Mesh::SerializeTo (TreeNode& root) const
 			TreeNode& node = root.AddChild("Mesh");
 			node.mValue = mName;
 
-			if (mV.IsValid())
+			if (mCompact)
 			{
-				TreeNode& child	= node.AddChild("Vertices");
-				child.mValue.ToVector3fArray().CopyMemory(mV);
-			}
+				// Compact meshes are saved with quantized positions, octahedral normals and half-float texture coordinates
+				if (mV.IsValid())
+				{
+					Vector3f min, max;
+					TreeNode& child	= node.AddChild("Compact Vertices");
+					EncodeVertices(mV, child.mValue.ToUShortArray(), min, max);
+					child.AddChild("Min", min);
+					child.AddChild("Max", max);
+				}
 
-			if (mN.IsValid() && !mGeneratedNormals)
-			{
-				TreeNode& child = node.AddChild("Normals");
-				child.mValue.ToVector3fArray().CopyMemory(mN);
-			}
+				if (mN.IsValid() && !mGeneratedNormals)
+				{
+					TreeNode& child = node.AddChild("Compact Normals");
+					EncodeNormals(mN, child.mValue.ToUShortArray());
+				}
 
-			if (mTc0.IsValid())
-			{
-				TreeNode& child = node.AddChild("TexCoords 0");
-				child.mValue.ToVector2fArray().CopyMemory(mTc0);
-			}
+				if (mTc0.IsValid())
+				{
+					TreeNode& child = node.AddChild("Compact TexCoords 0");
+					EncodeTexCoords(mTc0, child.mValue.ToUShortArray());
+				}
 
-			if (mTc1.IsValid())
+				if (mTc1.IsValid())
+				{
+					TreeNode& child = node.AddChild("Compact TexCoords 1");
+					EncodeTexCoords(mTc1, child.mValue.ToUShortArray());
+				}
+			}
+			else
 			{
-				TreeNode& child = node.AddChild("TexCoords 1");
-				child.mValue.ToVector2fArray().CopyMemory(mTc1);
+				if (mV.IsValid())
+				{
+					TreeNode& child	= node.AddChild("Vertices");
+					child.mValue.ToVector3fArray().CopyMemory(mV);
+				}
+
+				if (mN.IsValid() && !mGeneratedNormals)
+				{
+					TreeNode& child = node.AddChild("Normals");
+					child.mValue.ToVector3fArray().CopyMemory(mN);
+				}
+
+				if (mTc0.IsValid())
+				{
+					TreeNode& child = node.AddChild("TexCoords 0");
+					child.mValue.ToVector2fArray().CopyMemory(mTc0);
+				}
+
+				if (mTc1.IsValid())
+				{
+					TreeNode& child = node.AddChild("TexCoords 1");
+					child.mValue.ToVector2fArray().CopyMemory(mTc1);
+				}
 			}
 
 			if (mC.IsValid())
@@ -1486,8 +1990,18 @@ bool Mesh::SerializeTo (TreeNode& root) const
 
 			if ( GetNumberOfWeights() > 0 )
 			{
-				TreeNode& bw = node.AddChild("Bone Weights");
-				bw.mValue.ToColor4fArray().CopyMemory(mBw);
+				if (mCompact)
+				{
+					TreeNode& bw = node.AddChild("Compact Bone Weights");
+					Array<Color4ub>& weights = bw.mValue.ToColor4ubArray();
+					Color4ub* ptr = weights.ExpandTo(mBw.GetSize());
+					for (uint b = mBw.GetSize(); b > 0; ) { --b; ptr[b] = mBw[b]; }
+				}
+				else
+				{
+					TreeNode& bw = node.AddChild("Bone Weights");
+					bw.mValue.ToColor4fArray().CopyMemory(mBw);
+				}
 
 				TreeNode& bi = node.AddChild("Bone Indices");
 				bi.mValue.ToColor4ubArray().CopyMemory(mBi);
@@ -1496,7 +2010,18 @@ bool Mesh::SerializeTo (TreeNode& root) const
 			if (HasIndices())
 			{
 				TreeNode& faceNode = node.AddChild(GetType(mPrimitive));
-				faceNode.mValue.ToUShortArray().CopyMemory(mIndices);
+
+				// Indices are saved as 16-bit values unless the mesh has too many vertices
+				if (GetNumberOfVertices() > 65536)
+				{
+					faceNode.mValue.ToUIntArray().CopyMemory(mIndices);
+				}
+				else
+				{
+					Array<ushort>& out = faceNode.mValue.ToUShortArray();
+					ushort* ptr = out.ExpandTo(mIndices.GetSize());
+					for (uint b = mIndices.GetSize(); b > 0; ) { --b; ptr[b] = (ushort)mIndices[b]; }
+				}
 			}
 		}
 		Unlock();
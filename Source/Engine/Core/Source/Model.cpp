@@ -47,9 +47,9 @@ void Model::Update()
 		// If the mesh is animated we need to update the animations
 		if ( IsAnimated() )
 		{
+			R5_PROFILE("Model::Update");
 			float delta	= Float::Abs(0.001f * (current - mLastUpdate) * mAnimationSpeed);
-			static Array<Notification> notifications;
-			notifications.Clear();
+			Array<Notification> notifications (FrameArena::Get());
 
 			const Skeleton::Bones& bones = mSkeleton->GetAllBones();
 
@@ -158,14 +158,13 @@ void Model::Update()
 					trans.CalculateTransformMatrix();
 				}
 
-				// Set the bone's final transformation matrix
-				mMatrices[t].SetToTransform(
-					trans.mInvBindPos,
-					trans.mAbsolutePos,
-					trans.mInvBindRot,
-					trans.mAbsoluteRot );
+				// Set the bone's absolute transformation matrix
+				mMatrices[t].SetToTransform(trans.mAbsolutePos, trans.mAbsoluteRot);
 			}
 
+			// The final matrices transform the vertices from the bind pose into the bones' current orientation
+			Batch::Multiply(mInvBind.GetBuffer(), mMatrices.GetBuffer(), mMatrices.GetBuffer(), mTransforms.GetSize());
+
 			// Inform the listeners
 			for (uint i = notifications.GetSize(); i > 0; )
 			{
@@ -257,6 +256,15 @@ uint Model::_Draw (uint group, IGraphics* graphics, const ITechnique* tech, Limb
 	return 1;
 }
 
+//============================================================================================================
+// Skinned models share static state between draw calls, so only static models can be recorded
+//============================================================================================================
+
+bool Model::_IsRecordable (const Limb* limb) const
+{
+	return (mSkeleton == 0 || mMatrices.IsEmpty()) && Prop::_IsRecordable(limb);
+}
+
 //============================================================================================================
 // Draw the outline
 //============================================================================================================
@@ -471,6 +479,7 @@ void Model::_OnSkeletonChanged()
 	mActiveAnims.Release();
 	mTransforms.Clear();
 	mMatrices.Clear();
+	mInvBind.Clear();
 
 	if (mSkeleton != 0)
 	{
@@ -512,6 +521,9 @@ void Model::_OnSkeletonChanged()
 				// Calculate the inverse transforms
 				trans.mInvBindPos = -trans.mAbsolutePos;
 				trans.mInvBindRot = -trans.mAbsoluteRot;
+
+				// Inverse bind pose matrix undoes the bone's bind pose orientation
+				mInvBind.Expand().SetToTransform(trans.mInvBindPos, Vector3f(), trans.mInvBindRot, Quaternion());
 			}
 
 			// We want to have the proper number of matrices as well
@@ -530,6 +542,7 @@ void Model::_OnRelease()
 	mActiveAnims.Release();
 	mTransforms.Release();
 	mMatrices.Release();
+	mInvBind.Release();
 }
 
 //============================================================================================================
@@ -1,21 +1,7 @@
 #include "../Include/_All.h"
 using namespace R5;
 
-extern ModelInstance* g_lastModel;
-
-//============================================================================================================
-// Retrieves the world transformation matrix
-//============================================================================================================
-
-const Matrix43& ModelInstance::GetMatrix() const
-{
-	if (mRecalculate)
-	{
-		mRecalculate = false;
-		mMatrix.SetToTransform( mAbsolutePos, mAbsoluteRot, mAbsoluteScale );
-	}
-	return mMatrix;
-}
+extern R5_THREAD_LOCAL ModelInstance* g_lastModel;
 
 //============================================================================================================
 // Updates the pointer to the instanced model, keeping track of the number of instances
@@ -56,7 +42,8 @@ void ModelInstance::OnInit()
 }
 
 //============================================================================================================
-// Updates the transformation matrix
+// Updates the transformation matrix. It's calculated here rather than on first use, as static models get
+// drawn on worker threads, and multi-limb models can be drawn by several of them at once.
 //============================================================================================================
 
 void ModelInstance::OnUpdate()
@@ -66,7 +53,7 @@ void ModelInstance::OnUpdate()
 		if (mModel->IsDirty()) mIsDirty = true;
 		mRelativeBounds = mModel->GetBounds();
 	}
-	if (mIsDirty) mRecalculate = true;
+	if (mIsDirty) mMatrix.SetToTransform( mAbsolutePos, mAbsoluteRot, mAbsoluteScale );
 }
 
 //============================================================================================================
@@ -143,6 +130,15 @@ uint ModelInstance::OnDraw (TemporaryStorage& storage, uint group, const ITechni
 	return mModel->_Draw(group, graphics, tech, (Limb*)param);
 }
 
+//============================================================================================================
+// Static models can be drawn on worker threads
+//============================================================================================================
+
+bool ModelInstance::OnIsRecordable (const ITechnique* tech, void* param) const
+{
+	return (mModel != 0) && mModel->_IsRecordable((const Limb*)param);
+}
+
 //============================================================================================================
 // Serialization -- Save
 //============================================================================================================
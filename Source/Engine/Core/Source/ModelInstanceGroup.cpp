@@ -174,9 +174,13 @@ uint ModelInstanceGroup::OnDraw (TemporaryStorage& storage, uint group, const IT
 	if (batch->mIndexCount == 0)
 	{
 		batch->mBounds.Clear();
-		ushort vertexCount = 0;
+		uint vertexCount = 0;
+
+		// Temporary buffers only live until they get uploaded, so they come from the frame arena
+		Arena::Scope scope (FrameArena::Get());
+		Memory mem (FrameArena::Get());
+		Array<uint> ind (FrameArena::Get());
 
-		Memory& mem = batch->mVertices;
 		batch->mStride		 = 0;
 		batch->mNormalOffset = 0;
 		batch->mTanOffset	 = 0;
@@ -248,13 +252,11 @@ uint ModelInstanceGroup::OnDraw (TemporaryStorage& storage, uint group, const IT
 					// Append all of the indices
 					for (uint b = 0, bmax = indices.GetSize(); b < bmax; ++b)
 					{
-						batch->mIndices.Expand() = vertexCount + indices[b];
+						ind.Expand() = vertexCount + indices[b];
 					}
 
-					ASSERT((vertexCount + verts.GetSize()) < 65535, "Time to implement uint indices...");
-
 					// The next index buffer will start at this offset
-					vertexCount += (ushort)verts.GetSize();
+					vertexCount += verts.GetSize();
 					batch->mIndexCount += indices.GetSize();
 				}
 			}
@@ -267,13 +269,24 @@ uint ModelInstanceGroup::OnDraw (TemporaryStorage& storage, uint group, const IT
 			if (batch->mVBO == 0) batch->mVBO = mGraphics->CreateVBO();
 			if (batch->mIBO == 0) batch->mIBO = mGraphics->CreateVBO();
 
-			batch->mVBO->Set(batch->mVertices.GetBuffer(), batch->mVertices.GetSize());
-			batch->mIBO->Set(batch->mIndices.GetBuffer(), batch->mIndices.GetSizeInMemory(), IVBO::Type::Index);
-		}
+			batch->mVBO->Set(mem.GetBuffer(), mem.GetSize());
 
-		// Clear the temporary arrays
-		batch->mVertices.Clear();
-		batch->mIndices.Clear();
+			// Indices are only uploaded as 32-bit values if there are too many vertices for 16 bits
+			if (vertexCount > 65536)
+			{
+				batch->mIndexType = IGraphics::DataType::UInt;
+				batch->mIBO->Set(ind.GetBuffer(), ind.GetSizeInMemory(), IVBO::Type::Index);
+			}
+			else
+			{
+				Array<ushort> shortInd (FrameArena::Get());
+				ushort* ptr = shortInd.ExpandTo(ind.GetSize());
+				for (uint i = ind.GetSize(); i > 0; ) { --i; ptr[i] = (ushort)ind[i]; }
+
+				batch->mIndexType = IGraphics::DataType::UShort;
+				batch->mIBO->Set(shortInd.GetBuffer(), shortInd.GetSizeInMemory(), IVBO::Type::Index);
+			}
+		}
 	}
 
 	// If the batch has nothing to draw or isn't visible with this technique, do nothing
@@ -345,5 +358,5 @@ uint ModelInstanceGroup::OnDraw (TemporaryStorage& storage, uint group, const IT
 		batch->mVBO, 0, IGraphics::DataType::Float, 3, batch->mStride);
 
 	// Draw the instance
-	return mGraphics->DrawIndices( batch->mIBO, batch->mPrimitive, batch->mIndexCount );
+	return mGraphics->DrawIndices( batch->mIBO, batch->mPrimitive, batch->mIndexCount, batch->mIndexType );
 }
\ No newline at end of file
@@ -660,6 +660,7 @@ bool ModelTemplate::Save (TreeNode& root) const
 		// Save the OnSerialize section itself
 		model.mChildren.Expand() = mOnSerialize;
 		model.mChildren.Back().mTag = "OnSerialize";
+		model.InvalidateIndex();
 	}
 	return true;
 }
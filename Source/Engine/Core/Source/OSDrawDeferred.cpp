@@ -63,6 +63,8 @@ void OSDrawDeferred::OnInit()
 
 void OSDrawDeferred::MaterialStage()
 {
+	R5_PROFILE("OSDrawDeferred::MaterialStage");
+
 	Vector2i size (mScene.GetFinalTargetSize());
 
 	// Set up the material render target
@@ -120,6 +122,8 @@ void OSDrawDeferred::MaterialStage()
 
 void OSDrawDeferred::LightStage()
 {
+	R5_PROFILE("OSDrawDeferred::LightStage");
+
 	// If we have no lights to draw, just exit
 	const DrawQueue::Lights& lights = mScene.GetVisibleLights();
 	if (lights.IsEmpty()) return;
@@ -276,6 +280,8 @@ void OSDrawDeferred::LightStage()
 
 void OSDrawDeferred::CombineStage()
 {
+	R5_PROFILE("OSDrawDeferred::CombineStage");
+
 	IRenderTarget* target = mScene.GetFinalTarget();
 
 	if (mFinalTarget == 0)
@@ -325,6 +331,8 @@ void OSDrawDeferred::CombineStage()
 
 void OSDrawDeferred::PostProcessStage()
 {
+	R5_PROFILE("OSDrawDeferred::PostProcessStage");
+
 	// Add forward rendering
 	mGraphics->ResetModelViewMatrix();
 	mGraphics->SetScreenProjection(false);
@@ -351,6 +359,8 @@ void OSDrawDeferred::PostProcessStage()
 
 void OSDrawDeferred::OnDraw()
 {
+	R5_PROFILE("OSDrawDeferred::OnDraw");
+
 	// Cull the scene with our camera
 	mScene.Cull(mCam);
 
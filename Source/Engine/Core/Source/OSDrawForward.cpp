@@ -44,6 +44,8 @@ void OSDrawForward::OnDestroy()
 
 void OSDrawForward::OnDraw()
 {
+	R5_PROFILE("OSDrawForward::OnDraw");
+
 	// Cull the scene
 	mScene.Cull(mCam);
 	uint pass = 0;
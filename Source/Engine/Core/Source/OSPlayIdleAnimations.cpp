@@ -105,17 +105,9 @@ void OSPlayIdleAnimations::OnUpdate()
 {
 	if (mIdleLoop)
 	{
-		ulong delta = Time::GetDeltaMS();
-
-		if (mTimeToPlay > delta)
-		{
-			mTimeToPlay -= delta;
-		}
-		else
-		{
-			mTimeToPlay = 4000 + Float::RoundToUInt(10000.0f * g_rand.GenerateFloat());
-			Play();
-		}
+		// Nothing needs to happen until it's time to play the next animation, so sleep until then
+		Play();
+		Sleep(4000 + Float::RoundToUInt(10000.0f * g_rand.GenerateFloat()));
 	}
 	else
 	{
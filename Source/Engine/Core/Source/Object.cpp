@@ -53,10 +53,12 @@ Object::Object() :
 	mSerializable	(true),
 	mShowOutline	(false),
 	mLastFilltime	(0),
-	mVisibility		(0)
+	mVisibility		(0),
+	mFlatIndex		(INVALID_VAL)
 {
 	mFlags.Set(Flag::Enabled, true);
 	mIgnore.Set(Ignore::Subscriptions, true);
+	memset(mListeners, 0, sizeof(mListeners));
 }
 
 //============================================================================================================
@@ -133,6 +135,7 @@ Object* Object::_AddObject (const String& type, const String& name)
 			ptr->mIsDirty = true;
 			ptr->mGraphics = mCore->GetGraphics();
 			mChildren.Expand() = ptr;
+			mCore->_InvalidateHierarchy();
 
 			// Initialize the object
 			ptr->OnInit();
@@ -212,6 +215,7 @@ Script* Object::_AddScript (const char* type)
 		{
 			ptr->mObject = this;
 			mScripts.Expand() = ptr;
+			if (mCore != 0) mCore->GetScriptRegistry().Add(ptr);
 			ptr->OnInit();
 		}
 	}
@@ -253,6 +257,7 @@ Script* Object::_AddScript (const String& type)
 		{
 			ptr->mObject = this;
 			mScripts.Expand() = ptr;
+			if (mCore != 0) mCore->GetScriptRegistry().Add(ptr);
 			ptr->OnInit();
 		}
 	}
@@ -325,6 +330,7 @@ void Object::_Add (Object* obj)
 
 		mChildren.Expand() = obj;
 		mIsDirty = true;
+		if (mCore != 0) mCore->_InvalidateHierarchy();
 
 		OnAddChild(obj);
 	}
@@ -351,6 +357,7 @@ void Object::_Remove (Object* obj)
 		obj->mLastPos		= obj->mRelativePos;
 
 		mIsDirty = true;
+		if (mCore != 0) mCore->_InvalidateHierarchy();
 	}
 }
 
@@ -493,10 +500,16 @@ void Object::DestroyAllScripts()
 	{
 		Script* script = mScripts[i];
 		script->OnDestroy();
+		if (script->mRegistry != 0) script->mRegistry->Remove(script);
 		mDeletedScripts.Expand() = script;
 		mScripts[i] = 0;
 	}
-	mScripts.Clear();
+
+	if (mScripts.IsValid())
+	{
+		mScripts.Clear();
+		if (mCore != 0) mCore->_InvalidateHierarchy();
+	}
 }
 
 //============================================================================================================
@@ -666,23 +679,8 @@ bool Object::Update (const Vector3f& pos, const Quaternion& rot, const Vector3f&
 		// If the parent has moved then we need to recalculate the absolute values
 		if (parentMoved) mIsDirty = true;
 
-		// Run through all scripts and notify them
-		for (uint i = mScripts.GetSize(); i > 0; )
-		{
-			Script* script = mScripts[--i];
-
-			// If the script is listening to pre-update events
-			if (!script->mIgnore.Get(Script::Ignore::PreUpdate))
-			{
-				script->OnPreUpdate();
-
-				if (!mFlags.Get(Flag::Enabled)) return true;
-				while (i > mScripts.GetSize()) --i;
-			}
-		}
-
-		// Call the pre-update function
-		if (!mIgnore.Get(Ignore::PreUpdate)) OnPreUpdate();
+		// Notify the scripts and the object that the update is about to begin
+		if (!_PreUpdate()) return true;
 
 		// If something has changed, update the absolute values
 		if (mIsDirty)
@@ -704,23 +702,8 @@ bool Object::Update (const Vector3f& pos, const Quaternion& rot, const Vector3f&
 		}
 		mLastPos = mRelativePos;
 
-		// Run through all scripts and notify them
-		for (uint i = mScripts.GetSize(); i > 0; )
-		{
-			Script* script = mScripts[--i];
-
-			// If the script is listening to pre-update events
-			if (!script->mIgnore.Get(Script::Ignore::Update))
-			{
-				script->OnUpdate();
-
-				if (!mFlags.Get(Flag::Enabled)) return true;
-				while (i > mScripts.GetSize()) --i;
-			}
-		}
-
-		// Call the update function
-		if (!mIgnore.Get(Ignore::Update)) OnUpdate();
+		// Absolute values have been calculated
+		if (!_Update()) return true;
 
 		// Update all children
 		if (mChildren.IsValid())
@@ -778,23 +761,8 @@ bool Object::Update (const Vector3f& pos, const Quaternion& rot, const Vector3f&
 			}
 		}
 
-		// Run through all scripts and notify them
-		for (uint i = mScripts.GetSize(); i > 0; )
-		{
-			Script* script = mScripts[--i];
-
-			// If the script is listening to pre-update events
-			if (!script->mIgnore.Get(Script::Ignore::PostUpdate))
-			{
-				script->OnPostUpdate();
-
-				if (!mFlags.Get(Flag::Enabled)) return true;
-				while (i > mScripts.GetSize()) --i;
-			}
-		}
-
-		// Call the post-update function
-		if (!mIgnore.Get(Ignore::PostUpdate)) OnPostUpdate();
+		// Children and bounds have been updated
+		if (!_PostUpdate()) return true;
 
 		// All absolute values have now been calculated
 		mIsDirty = false;
@@ -808,6 +776,81 @@ bool Object::Update (const Vector3f& pos, const Quaternion& rot, const Vector3f&
 	return retVal;
 }
 
+//============================================================================================================
+// INTERNAL: Notifies the scripts and the object itself that the update is about to begin
+//============================================================================================================
+
+bool Object::_PreUpdate()
+{
+	// Scripts only need to be looked at if some of them are listening to pre-update events
+	for (uint i = (mListeners[ScriptRegistry::Phase::PreUpdate] != 0) ? mScripts.GetSize() : 0; i > 0; )
+	{
+		Script* script = mScripts[--i];
+
+		if (script->mSlots[ScriptRegistry::Phase::PreUpdate] != INVALID_VAL)
+		{
+			script->OnPreUpdate();
+
+			if (!mFlags.Get(Flag::Enabled)) return false;
+			while (i > mScripts.GetSize()) --i;
+		}
+	}
+
+	// Call the pre-update function
+	if (!mIgnore.Get(Ignore::PreUpdate)) OnPreUpdate();
+	return true;
+}
+
+//============================================================================================================
+// INTERNAL: Notifies the scripts and the object itself that the absolute values have been calculated
+//============================================================================================================
+
+bool Object::_Update()
+{
+	// Scripts only need to be looked at if some of them are listening to update events
+	for (uint i = (mListeners[ScriptRegistry::Phase::Update] != 0) ? mScripts.GetSize() : 0; i > 0; )
+	{
+		Script* script = mScripts[--i];
+
+		if (script->mSlots[ScriptRegistry::Phase::Update] != INVALID_VAL)
+		{
+			script->OnUpdate();
+
+			if (!mFlags.Get(Flag::Enabled)) return false;
+			while (i > mScripts.GetSize()) --i;
+		}
+	}
+
+	// Call the update function
+	if (!mIgnore.Get(Ignore::Update)) OnUpdate();
+	return true;
+}
+
+//============================================================================================================
+// INTERNAL: Notifies the scripts and the object itself that the children and bounds have been updated
+//============================================================================================================
+
+bool Object::_PostUpdate()
+{
+	// Scripts only need to be looked at if some of them are listening to post-update events
+	for (uint i = (mListeners[ScriptRegistry::Phase::PostUpdate] != 0) ? mScripts.GetSize() : 0; i > 0; )
+	{
+		Script* script = mScripts[--i];
+
+		if (script->mSlots[ScriptRegistry::Phase::PostUpdate] != INVALID_VAL)
+		{
+			script->OnPostUpdate();
+
+			if (!mFlags.Get(Flag::Enabled)) return false;
+			while (i > mScripts.GetSize()) --i;
+		}
+	}
+
+	// Call the post-update function
+	if (!mIgnore.Get(Ignore::PostUpdate)) OnPostUpdate();
+	return true;
+}
+
 //============================================================================================================
 // Fills the render queues
 //============================================================================================================
@@ -832,11 +875,11 @@ void Object::Fill (FillParams& params)
 			if (!mAbsoluteBounds.IsValid() || params.mFrustum.IsVisible(mAbsoluteBounds))
 			{
 				// Inform script listeners of this event
-				for (uint i = mScripts.GetSize(); i > 0; )
+				for (uint i = (mListeners[ScriptRegistry::Phase::Fill] != 0) ? mScripts.GetSize() : 0; i > 0; )
 				{
 					Script* script = mScripts[--i];
 
-					if (!script->mIgnore.Get(Script::Ignore::Fill))
+					if (script->mSlots[ScriptRegistry::Phase::Fill] != INVALID_VAL)
 					{
 						script->OnFill(params);
 					}
@@ -1100,6 +1143,28 @@ bool Object::SerializeTo (TreeNode& root) const
 	return false;
 }
 
+//============================================================================================================
+// Tags recognized by Object::SerializeFrom(), in the same order as the values below
+//============================================================================================================
+
+struct ObjectTag
+{
+	enum
+	{
+		Serializable,
+		Position,
+		Rotation,
+		Scale,
+		Min,
+		Max,
+		Layer,
+		ShowOutline,
+	};
+};
+
+const char* g_objectTags[] = { "Serializable", "Position", "Rotation", "Scale", "Min", "Max", "Layer", "Show Outline", 0 };
+TagMap g_objectTagMap (g_objectTags);
+
 //============================================================================================================
 // Serialization -- Load
 //============================================================================================================
@@ -1116,64 +1181,81 @@ bool Object::SerializeFrom (const TreeNode& root, bool forceUpdate)
 		const String&	tag   = node.mTag;
 		const Variable&	value = node.mValue;
 
-		if (tag == "Serializable")
+		switch (g_objectTagMap[node])
 		{
-			value >> serializable;
-			mSerializable = serializable;
-		}
-		else if	(tag == "Position")		{ if (value >> mRelativePos)	mIsDirty = true; }
-		else if (tag == "Rotation")		{ if (value >> mRelativeRot)	mIsDirty = true; }
-		else if (tag == "Scale")		{ if (value >> mRelativeScale)	mIsDirty = true; }
-		else if (tag == "Min" || tag == "Max")
-		{
-			Vector3f v;
+			case ObjectTag::Serializable:
+			{
+				value >> serializable;
+				mSerializable = serializable;
+			}
+			break;
+
+			case ObjectTag::Position:	if (value >> mRelativePos)		mIsDirty = true;	break;
+			case ObjectTag::Rotation:	if (value >> mRelativeRot)		mIsDirty = true;	break;
+			case ObjectTag::Scale:		if (value >> mRelativeScale)	mIsDirty = true;	break;
 
-			if (value >> v)
+			case ObjectTag::Min:
+			case ObjectTag::Max:
 			{
-				mCalcRelBounds = false;
-				mRelativeBounds.Include(v);
-				mIsDirty = true;
+				Vector3f v;
+
+				if (value >> v)
+				{
+					mCalcRelBounds = false;
+					mRelativeBounds.Include(v);
+					mIsDirty = true;
+				}
 			}
-		}
-		else if (tag == "Layer")
-		{
-			uint temp;
+			break;
 
-			if (value >> temp)
+			case ObjectTag::Layer:
 			{
-				mLayer = (byte)(temp & 31);
-				mIsDirty = true;
+				uint temp;
+
+				if (value >> temp)
+				{
+					mLayer = (byte)(temp & 31);
+					mIsDirty = true;
+				}
 			}
-		}
-		else if (tag == "Show Outline")
-		{
-			mShowOutline = value.IsBool() ? value.AsBool() : true;
-		}
-		else if (tag == Script::ClassName())
-		{
-			// The 'contains' check is here because scripts can self-destruct inside OnInit()
-			Script* ptr = _AddScript(value.AsString());
+			break;
 
-			if (ptr != 0 && mScripts.Contains(ptr))
+			case ObjectTag::ShowOutline:
 			{
-				// The object should not remain locked during script serialization
-				ptr->SerializeFrom(node);
-				if (!serializable && mParent == 0) ptr->SetSerializable(false);
-				ptr->OnPostSerialize();
+				mShowOutline = value.IsBool() ? value.AsBool() : true;
 			}
-		}
-		else if (mIgnore.Get(Ignore::SerializeFrom) || !OnSerializeFrom(node))
-		{
-			Object* ptr = _AddObject(tag, value.AsString());
+			break;
 
-			if (ptr != 0)
+			default:
 			{
-				// The object should not remain locked during child serialization
-				ptr->SerializeFrom(node, forceUpdate);
-				if (!serializable && mParent == 0) ptr->SetSerializable(false);
-				ptr->SetDirty();
-				ptr->OnPostSerialize();
+				if (tag == Script::ClassName())
+				{
+					// The 'contains' check is here because scripts can self-destruct inside OnInit()
+					Script* ptr = _AddScript(value.AsString());
+
+					if (ptr != 0 && mScripts.Contains(ptr))
+					{
+						// The object should not remain locked during script serialization
+						ptr->SerializeFrom(node);
+						if (!serializable && mParent == 0) ptr->SetSerializable(false);
+						ptr->OnPostSerialize();
+					}
+				}
+				else if (mIgnore.Get(Ignore::SerializeFrom) || !OnSerializeFrom(node))
+				{
+					Object* ptr = _AddObject(tag, value.AsString());
+
+					if (ptr != 0)
+					{
+						// The object should not remain locked during child serialization
+						ptr->SerializeFrom(node, forceUpdate);
+						if (!serializable && mParent == 0) ptr->SetSerializable(false);
+						ptr->SetDirty();
+						ptr->OnPostSerialize();
+					}
+				}
 			}
+			break;
 		}
 	}
 	return true;
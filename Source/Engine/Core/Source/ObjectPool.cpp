@@ -0,0 +1,108 @@
+#include "../Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Pools for each size class, along with the names of the types registered with them
+//============================================================================================================
+
+static Thread::Lockable	g_poolLock;
+static Pool*			g_pools[ObjectPool::MaxClasses] = {0};
+static Array<String>	g_poolTypes[ObjectPool::MaxClasses];
+
+//============================================================================================================
+// Returns the pool for the specified size class, creating it if necessary
+//============================================================================================================
+
+inline Pool* GetPool (uint index)
+{
+	Pool* pool = g_pools[index];
+
+	if (pool == 0)
+	{
+		g_poolLock.Lock();
+		{
+			if ((pool = g_pools[index]) == 0)
+			{
+				uint size	= (index + 1) * ObjectPool::Alignment;
+				uint count	= 65536 / size;
+				pool		= new Pool(size, count < 4 ? 4 : count, ObjectPool::Alignment);
+				g_pools[index] = pool;
+			}
+		}
+		g_poolLock.Unlock();
+	}
+	return pool;
+}
+
+//============================================================================================================
+// Allocates memory for an object of the specified size
+//============================================================================================================
+
+void* ObjectPool::Allocate (size_t size)
+{
+	uint index = (uint)((size + Alignment - 1) / Alignment);
+	if (index == 0 || index > MaxClasses) return ::operator new(size);
+	return GetPool(index - 1)->Allocate((uint)size);
+}
+
+//============================================================================================================
+// Returns memory previously obtained from Allocate()
+//============================================================================================================
+
+void ObjectPool::Free (void* ptr, size_t size)
+{
+	uint index = (uint)((size + Alignment - 1) / Alignment);
+	if (index == 0 || index > MaxClasses) ::operator delete(ptr);
+	else GetPool(index - 1)->Free(ptr, (uint)size);
+}
+
+//============================================================================================================
+// Creates the pool used by objects of the specified size and associates it with the type's name
+//============================================================================================================
+
+void ObjectPool::Register (const String& type, size_t size)
+{
+	uint index = (uint)((size + Alignment - 1) / Alignment);
+
+	if (index != 0 && index <= MaxClasses)
+	{
+		GetPool(--index);
+
+		g_poolLock.Lock();
+		g_poolTypes[index].AddUnique(type);
+		g_poolLock.Unlock();
+	}
+}
+
+//============================================================================================================
+// Fills the array with statistics of all active pools
+//============================================================================================================
+
+void ObjectPool::GetStats (Array<Stats>& stats)
+{
+	stats.Clear();
+
+	g_poolLock.Lock();
+	{
+		for (uint i = 0; i < MaxClasses; ++i)
+		{
+			const Pool* pool = g_pools[i];
+			if (pool == 0) continue;
+
+			Stats& s = stats.Expand();
+			s.mTypes.Clear();
+
+			FOREACH(b, g_poolTypes[i])
+			{
+				if (b != 0) s.mTypes << ", ";
+				s.mTypes << g_poolTypes[i][b];
+			}
+
+			s.mChunkSize	= pool->GetChunkSize();
+			s.mUsed			= pool->GetUsed();
+			s.mCapacity		= pool->GetCapacity();
+			s.mAllocations	= pool->GetAllocations();
+		}
+	}
+	g_poolLock.Unlock();
+}
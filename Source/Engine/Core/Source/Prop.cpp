@@ -110,4 +110,13 @@ uint Prop::_Draw (uint group, IGraphics* graphics, const ITechnique* tech, Limb*
 		}
 	}
 	return 1;
-}
\ No newline at end of file
+}
+
+//============================================================================================================
+// Meshes get uploaded the first time they're drawn, which must happen on the thread that owns the graphics
+//============================================================================================================
+
+bool Prop::_IsRecordable (const Limb* limb) const
+{
+	return (limb != 0 && limb->mMesh != 0 && limb->mMesh->IsUploaded());
+}
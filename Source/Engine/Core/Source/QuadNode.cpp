@@ -196,6 +196,44 @@ void QuadNode::_FillGeometry (void* ptr, float padding)
 	if (mLeaf) OnFill(ptr, padding);
 }
 
+//============================================================================================================
+// Collects all leaf nodes (nodes that have no subdivisions)
+//============================================================================================================
+
+void QuadNode::_GetLeaves (Array<QuadNode*>& leaves)
+{
+	if (mPart[0] == 0 && mPart[1] == 0 && mPart[2] == 0 && mPart[3] == 0)
+	{
+		leaves.Expand() = this;
+	}
+	else
+	{
+		if (mPart[0] != 0) mPart[0]->_GetLeaves(leaves);
+		if (mPart[1] != 0) mPart[1]->_GetLeaves(leaves);
+		if (mPart[2] != 0) mPart[2]->_GetLeaves(leaves);
+		if (mPart[3] != 0) mPart[3]->_GetLeaves(leaves);
+	}
+}
+
+//============================================================================================================
+// Finds the leaf node containing the specified relative (0-1 range) coordinates
+//============================================================================================================
+
+QuadNode* QuadNode::_FindLeaf (float x, float y)
+{
+	if (x < mOffset.x || y < mOffset.y || x > mOffset.x + mSize.x || y > mOffset.y + mSize.y) return 0;
+
+	for (uint i = 0; i < 4; ++i)
+	{
+		if (mPart[i] != 0)
+		{
+			QuadNode* node = mPart[i]->_FindLeaf(x, y);
+			if (node != 0) return node;
+		}
+	}
+	return (mPart[0] == 0 && mPart[1] == 0 && mPart[2] == 0 && mPart[3] == 0) ? this : 0;
+}
+
 //============================================================================================================
 // Called when the object is being considered for rendering
 //============================================================================================================
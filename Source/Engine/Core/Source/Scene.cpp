@@ -2,7 +2,7 @@
 using namespace R5;
 
 void* g_lastScene = 0;
-ModelInstance* g_lastModel = 0;
+R5_THREAD_LOCAL ModelInstance* g_lastModel = 0;
 
 //============================================================================================================
 // Sets the root of the scene
@@ -254,12 +254,20 @@ uint Scene::DrawWithTechniques (const Techniques& techniques, bool clearColor, b
 
 void Scene::_Cull (const Frustum& frustum, const Vector3f& pos, const Vector3f& dir, const Object* eye)
 {
+	R5_PROFILE("Scene::Cull");
+
 	FillParams params (mQueue, frustum);
 	params.mCamPos	= pos;
 	params.mCamDir	= dir;
 	params.mEye		= eye;
 
 	mQueue.Clear();
-	mRoot->Fill(params);
-	mQueue.Sort();
+	{
+		R5_PROFILE("Scene::Fill");
+		mRoot->Fill(params);
+	}
+	{
+		R5_PROFILE("DrawQueue::Sort");
+		mQueue.Sort();
+	}
 }
\ No newline at end of file
@@ -127,6 +127,8 @@ Script::List* Script::GetTypeList()
 
 Script::~Script()
 {
+	if (mRegistry != 0) mRegistry->Remove(this);
+
 	if (mObject != 0)
 	{
 		mObject->mScripts.Remove(this);
@@ -153,12 +155,42 @@ void Script::DestroySelf()
 	{
 		OnDestroy();
 
+		if (mRegistry != 0) mRegistry->Remove(this);
 		mObject->mScripts.Remove(this);
 		mObject->mDeletedScripts.Expand() = this;
+		if (mObject->mCore != 0) mObject->mCore->_InvalidateHierarchy();
 		mObject = 0;
 	}
 }
 
+//============================================================================================================
+// Puts the script to sleep for the specified number of milliseconds
+//============================================================================================================
+
+void Script::Sleep (uint ms)
+{
+	if (mRegistry != 0) mRegistry->Sleep(this, Time::GetMilliseconds() + ms);
+}
+
+//============================================================================================================
+// Wakes up the sleeping script right away
+//============================================================================================================
+
+void Script::Wake()
+{
+	if (mRegistry != 0) mRegistry->Wake(this);
+}
+
+//============================================================================================================
+// Marks the specified phase as ignored, unsubscribing the script from it
+//============================================================================================================
+
+void Script::_Ignore (uint phase)
+{
+	mIgnore.Set(1 << phase, true);
+	if (mRegistry != 0) mRegistry->Unsubscribe(this, phase);
+}
+
 //============================================================================================================
 // Serialization -- Save
 //============================================================================================================
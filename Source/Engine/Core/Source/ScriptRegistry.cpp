@@ -0,0 +1,223 @@
+#include "../Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+
+ScriptRegistry::ScriptRegistry()
+{
+	for (uint i = 0; i < Phase::Count; ++i)
+	{
+		mActive[i] = 0;
+		mHasGaps[i] = false;
+	}
+}
+
+//============================================================================================================
+// Number of scripts subscribed to the specified phase
+//============================================================================================================
+
+uint ScriptRegistry::GetCount (uint phase) const
+{
+	uint count = 0;
+	const Array<List>& lists = mLists[phase];
+
+	for (uint i = 0; i < lists.GetSize(); ++i)
+	{
+		const List& list = lists[i];
+		if (!mHasGaps[phase]) count += list.GetSize();
+		else for (uint b = 0; b < list.GetSize(); ++b) if (list[b] != 0) ++count;
+	}
+	return count;
+}
+
+//============================================================================================================
+// Removed scripts leave gaps in the lists while the phase is being iterated through -- close them now
+//============================================================================================================
+
+void ScriptRegistry::EndPhase (uint phase)
+{
+	if (--mActive[phase] == 0 && mHasGaps[phase])
+	{
+		mHasGaps[phase] = false;
+		Array<List>& lists = mLists[phase];
+
+		for (uint i = 0; i < lists.GetSize(); ++i)
+		{
+			List& list = lists[i];
+			uint count = 0;
+
+			for (uint b = 0; b < list.GetSize(); ++b)
+			{
+				Script* script = list[b];
+
+				if (script != 0)
+				{
+					script->mSlots[phase] = count;
+					list[count++] = script;
+				}
+			}
+			while (list.GetSize() > count) list.Shrink();
+		}
+	}
+}
+
+//============================================================================================================
+// Registers a newly added script, subscribing it to all the phases it's not ignoring
+//============================================================================================================
+
+void ScriptRegistry::Add (Script* script)
+{
+	const String* type = &script->GetClassName();
+	uint index = 0;
+
+	while (index < mTypes.GetSize() && mTypes[index] != type) ++index;
+
+	// First script of this type -- every phase needs a new list
+	if (index == mTypes.GetSize())
+	{
+		mTypes.Expand() = type;
+		for (uint i = 0; i < Phase::Count; ++i) mLists[i].Expand().Clear();
+	}
+
+	script->mRegistry = this;
+	script->mType = index;
+	_SubscribeAll(script);
+}
+
+//============================================================================================================
+// Unsubscribes the script from all phases and forgets about it
+//============================================================================================================
+
+void ScriptRegistry::Remove (Script* script)
+{
+	if (script->mWake != 0)
+	{
+		mSleeping.Remove(script->mWake);
+		script->mWake = 0;
+	}
+
+	for (uint i = 0; i < Phase::Count; ++i) Unsubscribe(script, i);
+	script->mRegistry = 0;
+}
+
+//============================================================================================================
+// Subscribes the script to the specified phase
+//============================================================================================================
+
+void ScriptRegistry::Subscribe (Script* script, uint phase)
+{
+	// Sleeping scripts get subscribed once they wake up
+	if (script->mSlots[phase] != INVALID_VAL || script->mWake != 0) return;
+
+	List& list = mLists[phase][script->mType];
+	script->mSlots[phase] = list.GetSize();
+	list.Expand() = script;
+
+	if (script->mObject != 0) ++script->mObject->mListeners[phase];
+}
+
+//============================================================================================================
+// Unsubscribes the script from the specified phase
+//============================================================================================================
+
+void ScriptRegistry::Unsubscribe (Script* script, uint phase)
+{
+	uint slot = script->mSlots[phase];
+	if (slot == INVALID_VAL) return;
+
+	script->mSlots[phase] = INVALID_VAL;
+	if (script->mObject != 0) --script->mObject->mListeners[phase];
+
+	List& list = mLists[phase][script->mType];
+
+	if (mActive[phase] != 0)
+	{
+		// The list is being iterated through, so leave a gap that will be closed later
+		list[slot] = 0;
+		mHasGaps[phase] = true;
+	}
+	else
+	{
+		// Move the last script into the vacated slot
+		Script* last = list.Back();
+		list.Shrink();
+
+		if (last != script)
+		{
+			list[slot] = last;
+			last->mSlots[phase] = slot;
+		}
+	}
+}
+
+//============================================================================================================
+// Unsubscribes the script from all phases until the specified timestamp in milliseconds
+//============================================================================================================
+
+void ScriptRegistry::Sleep (Script* script, ulong wakeTime)
+{
+	if (script->mWake != 0) mSleeping.Remove(script->mWake);
+	for (uint i = 0; i < Phase::Count; ++i) Unsubscribe(script, i);
+	script->mWake = mSleeping.Add(script, wakeTime);
+}
+
+//============================================================================================================
+// Wakes up the sleeping script immediately
+//============================================================================================================
+
+void ScriptRegistry::Wake (Script* script)
+{
+	if (script->mWake != 0)
+	{
+		mSleeping.Remove(script->mWake);
+		script->mWake = 0;
+		_SubscribeAll(script);
+	}
+}
+
+//============================================================================================================
+// Wakes up all scripts that are due to wake up at the specified timestamp
+//============================================================================================================
+
+void ScriptRegistry::Update (ulong time)
+{
+	mSleeping.Advance(time, mAwake);
+
+	for (uint i = 0; i < mAwake.GetSize(); ++i)
+	{
+		Script* script = mAwake[i];
+		script->mWake = 0;
+		_SubscribeAll(script);
+	}
+	mAwake.Clear();
+}
+
+//============================================================================================================
+// Releases all lists
+//============================================================================================================
+
+void ScriptRegistry::Release()
+{
+	mTypes.Release();
+	mSleeping.Release();
+	mAwake.Release();
+
+	for (uint i = 0; i < Phase::Count; ++i)
+	{
+		mLists[i].Release();
+		mActive[i] = 0;
+		mHasGaps[i] = false;
+	}
+}
+
+//============================================================================================================
+// Subscribes the script to all the phases it's not ignoring
+//============================================================================================================
+
+void ScriptRegistry::_SubscribeAll (Script* script)
+{
+	for (uint i = 0; i < Phase::Count; ++i)
+	{
+		if (!script->mIgnore.Get(1 << i)) Subscribe(script, i);
+	}
+}
@@ -1,6 +1,311 @@
 #include "../Include/_All.h"
 using namespace R5;
 
+//============================================================================================================
+// Number of levels of detail possible with the specified mesh dimensions -- each level doubles the step
+//============================================================================================================
+
+uint CountLODs (uint width, uint height)
+{
+	uint count = 1;
+	for (uint step = 2; step < width && step < height &&
+		(width - 1) % step == 0 && (height - 1) % step == 0; step <<= 1) ++count;
+	return count;
+}
+
+//============================================================================================================
+// Returns the index of the specified vertex, snapping odd vertices on stitched edges to their even neighbor
+//============================================================================================================
+
+inline uint GetStitchedIndex (uint x, uint y, uint width, uint height, uint step, uint mask)
+{
+	if ((mask & (1 << TerrainNode::Edge::Left))   && x == 0			 && ((y / step) & 1)) y -= step;
+	if ((mask & (1 << TerrainNode::Edge::Right))  && x == width - 1	 && ((y / step) & 1)) y -= step;
+	if ((mask & (1 << TerrainNode::Edge::Bottom)) && y == 0			 && ((x / step) & 1)) x -= step;
+	if ((mask & (1 << TerrainNode::Edge::Top))	  && y == height - 1 && ((x / step) & 1)) x -= step;
+	return x + y * width;
+}
+
+//============================================================================================================
+// Adds a triangle to the index buffer, skipping triangles that collapsed due to stitching
+//============================================================================================================
+
+template <typename Index>
+inline void AddTriangle (Memory& mem, uint v0, uint v1, uint v2)
+{
+	if (v0 != v1 && v1 != v2 && v0 != v2)
+	{
+		Index* index = (Index*)mem.Expand(sizeof(Index) * 3);
+		index[0] = (Index)v0;
+		index[1] = (Index)v1;
+		index[2] = (Index)v2;
+	}
+}
+
+//============================================================================================================
+// Fills the index buffer for the specified level of detail and stitching mask, returning the index count
+//============================================================================================================
+
+template <typename Index>
+uint FillIndices (Memory& mem, uint width, uint height, uint step, uint mask)
+{
+	mem.Clear();
+
+	for (uint y = 0; y + step < height; y += step)
+	{
+		for (uint x = 0; x + step < width; x += step)
+		{
+			uint v00 = GetStitchedIndex(x,		  y,		width, height, step, mask);
+			uint v10 = GetStitchedIndex(x + step, y,		width, height, step, mask);
+			uint v01 = GetStitchedIndex(x,		  y + step, width, height, step, mask);
+			uint v11 = GetStitchedIndex(x + step, y + step, width, height, step, mask);
+
+			// Same split and winding as the quads that were used before
+			AddTriangle<Index>(mem, v01, v00, v10);
+			AddTriangle<Index>(mem, v01, v10, v11);
+		}
+	}
+	return mem.GetSize() / sizeof(Index);
+}
+
+//============================================================================================================
+// Terrain starts with no nodes
+//============================================================================================================
+
+Terrain::Terrain() :
+	mMat			(0),
+	mLODCount		(1),
+	mMaxError		(2.0f),
+	mLargeIndices	(false),
+	mVertexCount	(0),
+	mTriangleCount	(0),
+	mGenParams		(0) {}
+
+//============================================================================================================
+// Generate the terrain, keeping a compact copy of the heightmap for height queries and raycasts
+//============================================================================================================
+
+void Terrain::Generate (Heightmap& hm)
+{
+	mHeightfield.Set(hm.mBufferData, hm.mBufferWidth, hm.mBufferHeight, hm.mTerrainScale, hm.mTerrainOffset);
+
+	uint width  = hm.mMeshSize.x < 2 ? 2 : hm.mMeshSize.x;
+	uint height = hm.mMeshSize.y < 2 ? 2 : hm.mMeshSize.y;
+	mLODCount = CountLODs(width, height);
+
+	// Gather all leaf nodes
+	Array<QuadNode*> leaves;
+	GetLeaves(leaves);
+	mLeaves.Clear();
+	FOREACH(i, leaves) mLeaves.Expand() = (TerrainNode*)leaves[i];
+
+	// Generate the vertices of all nodes on worker threads
+	mGenParams = &hm;
+	Thread::ParallelFor(mLeaves.GetSize(), bind(&Terrain::_GenerateNode, this));
+	mGenParams = 0;
+
+	// Find the neighbors, then upload the generated vertices
+	_LinkNeighbors();
+	FillGeometry(&hm);
+}
+
+//============================================================================================================
+// Generates the vertices of the specified leaf node -- executed on worker threads
+//============================================================================================================
+
+void Terrain::_GenerateNode (uint index)
+{
+	mLeaves[index]->_Generate(mGenParams, mLODCount, 0.0f);
+}
+
+//============================================================================================================
+// Finds the neighbors of every leaf node, used to stitch the edges between nodes of different detail
+//============================================================================================================
+
+void Terrain::_LinkNeighbors()
+{
+	const float offset = 0.0001f;
+
+	FOREACH(i, mLeaves)
+	{
+		TerrainNode* node = mLeaves[i];
+
+		float x0 = node->mOffset.x - offset;
+		float y0 = node->mOffset.y - offset;
+		float x1 = node->mOffset.x + node->mSize.x + offset;
+		float y1 = node->mOffset.y + node->mSize.y + offset;
+		float cx = node->mOffset.x + node->mSize.x * 0.5f;
+		float cy = node->mOffset.y + node->mSize.y * 0.5f;
+
+		node->mNeighbor[TerrainNode::Edge::Left]	= (TerrainNode*)FindLeaf(x0, cy);
+		node->mNeighbor[TerrainNode::Edge::Right]	= (TerrainNode*)FindLeaf(x1, cy);
+		node->mNeighbor[TerrainNode::Edge::Bottom]	= (TerrainNode*)FindLeaf(cx, y0);
+		node->mNeighbor[TerrainNode::Edge::Top]		= (TerrainNode*)FindLeaf(cx, y1);
+	}
+}
+
+//============================================================================================================
+// Chooses the level of detail for every leaf node based on the camera's distance and screen-space error
+//============================================================================================================
+
+void Terrain::_SelectLOD (const FillParams& params)
+{
+	IGraphics* graphics = mCore->GetGraphics();
+
+	if (mLODCount > 1 && mMaxError > 0.0f && graphics != 0)
+	{
+		// Number of pixels covered by one world unit at the distance of one world unit
+		float fov = graphics->GetCameraRange().z;
+		if (fov < 1.0f) fov = 90.0f;
+		float pixels = graphics->GetViewport().y * 0.5f / TAN(DEG2RAD(fov * 0.5f));
+
+		// Height error in world units that's allowed per world unit of distance
+		float allowed = mMaxError / pixels;
+
+		FOREACH(i, mLeaves)
+		{
+			TerrainNode* node = mLeaves[i];
+
+			// Distance from the camera to the closest point of the node's bounds
+			const Vector3f& min = node->mBounds.GetMin();
+			const Vector3f& max = node->mBounds.GetMax();
+			Vector3f closest (	Clamp(params.mCamPos.x, min.x, max.x),
+								Clamp(params.mCamPos.y, min.y, max.y),
+								Clamp(params.mCamPos.z, min.z, max.z) );
+
+			float limit = allowed * closest.GetDistanceTo(params.mCamPos);
+			uint lod = 0;
+
+			while (lod + 1 < node->mLODError.GetSize() && node->mLODError[lod + 1] <= limit) ++lod;
+			node->mLOD = lod;
+		}
+
+		// Neighbors must be no more than one level apart in order for the stitching to be seamless
+		for (bool changed = true; changed; )
+		{
+			changed = false;
+
+			FOREACH(i, mLeaves)
+			{
+				TerrainNode* node = mLeaves[i];
+
+				for (uint b = 0; b < 4; ++b)
+				{
+					const TerrainNode* neighbor = node->mNeighbor[b];
+
+					if (neighbor != 0 && node->mLOD > neighbor->mLOD + 1)
+					{
+						node->mLOD = neighbor->mLOD + 1;
+						changed = true;
+					}
+				}
+			}
+		}
+	}
+	else
+	{
+		FOREACH(i, mLeaves) mLeaves[i]->mLOD = 0;
+	}
+
+	// Gather the statistics for the nodes that will be drawn
+	mVertexCount	= 0;
+	mTriangleCount	= 0;
+
+	FOREACH(i, mRenderable)
+	{
+		const TerrainNode* node = (const TerrainNode*)mRenderable[i];
+		uint step = 1 << node->mLOD;
+		uint cellsX = (node->mMeshSize.x - 1) / step;
+		uint cellsY = (node->mMeshSize.y - 1) / step;
+		mVertexCount	+= (cellsX + 1) * (cellsY + 1);
+		mTriangleCount	+= cellsX * cellsY * 2;
+	}
+}
+
+//============================================================================================================
+// Retrieves (creating if necessary) the shared index buffer for the specified LOD and stitching mask
+//============================================================================================================
+
+const IVBO* Terrain::_GetIndices (const Vector2i& meshSize, uint lod, uint mask, uint& count)
+{
+	IGraphics* graphics = mCore->GetGraphics();
+	if (graphics == 0) return 0;
+
+	// All nodes are expected to share the same dimensions
+	if (mMeshSize != meshSize)
+	{
+		_ReleaseIndices();
+		mMeshSize = meshSize;
+		mLargeIndices = ((uint)meshSize.x * meshSize.y > 65536);
+	}
+
+	uint width	= mMeshSize.x;
+	uint height = mMeshSize.y;
+	uint levels = CountLODs(width, height);
+	if (lod >= levels) lod = levels - 1;
+
+	uint index = (lod << 4) | (mask & 15);
+
+	if (mIBOs.GetSize() < (levels << 4))
+	{
+		mIBOs.ExpandTo(levels << 4, true);
+		mIndexCounts.ExpandTo(levels << 4, true);
+	}
+
+	IVBO* ibo = mIBOs[index];
+
+	if (ibo == 0)
+	{
+		Memory mem;
+		uint step = 1 << lod;
+
+		// The least detailed level never needs to be stitched
+		if (lod + 1 == levels) mask = 0;
+
+		mIndexCounts[index] = mLargeIndices ?
+			FillIndices<uint>	(mem, width, height, step, mask) :
+			FillIndices<ushort>	(mem, width, height, step, mask);
+
+		ibo = mIBOs[index] = graphics->CreateVBO();
+		ibo->Lock();
+		ibo->Set(mem.GetBuffer(), mem.GetSize(), IVBO::Type::Index);
+		ibo->Unlock();
+	}
+
+	count = mIndexCounts[index];
+	return ibo;
+}
+
+//============================================================================================================
+// Releases all shared index buffers
+//============================================================================================================
+
+void Terrain::_ReleaseIndices()
+{
+	IGraphics* graphics = (mCore != 0) ? mCore->GetGraphics() : 0;
+
+	if (graphics != 0)
+	{
+		FOREACH(i, mIBOs)
+		{
+			if (mIBOs[i] != 0) graphics->DeleteVBO(mIBOs[i]);
+		}
+	}
+	mIBOs.Clear();
+	mIndexCounts.Clear();
+}
+
+//============================================================================================================
+// Selects the level of detail of every node after the visible nodes have been gathered
+//============================================================================================================
+
+bool Terrain::OnFill (FillParams& params)
+{
+	QuadTree::OnFill(params);
+	_SelectLOD(params);
+	return false;
+}
+
 //============================================================================================================
 // Set up all render states and activate the material before moving down to QuadTree's OnDraw
 //============================================================================================================
@@ -25,6 +330,23 @@ uint Terrain::OnDraw (TemporaryStorage& storage, uint group, const ITechnique* t
 	return 0;
 }
 
+//============================================================================================================
+// Called when the object is being raycast into -- adds a hit if the ray intersects the terrain's surface
+//============================================================================================================
+
+bool Terrain::OnRaycast (const Vector3f& pos, const Vector3f& dir, Array<RaycastHit>& hits)
+{
+	float distance;
+
+	if (mHeightfield.Raycast(pos, dir, distance))
+	{
+		RaycastHit& hit = hits.Expand();
+		hit.mObject = this;
+		hit.mDistanceToCameraSquared = distance * distance;
+	}
+	return true;
+}
+
 //============================================================================================================
 // Called when the object is being saved
 //============================================================================================================
@@ -2,117 +2,152 @@
 using namespace R5;
 
 //============================================================================================================
-// Should create the node's topology and update 'mBounds'
+// Generates the node's vertices and LOD errors without touching the graphics API (thread-safe)
 //============================================================================================================
 
-void TerrainNode::OnFill (void* ptr, float bboxPadding)
+void TerrainNode::_Generate (const void* ptr, uint lodCount, float bboxPadding)
 {
-	IGraphics* graphics = mTree->GetCore()->GetGraphics();
-
-	if (graphics != 0)
+	// Passed parameters used to generate the terrain
+	const Terrain::Heightmap* hm	= (const Terrain::Heightmap*)ptr;
+	const float*	buffer			= hm->mBufferData;
+	const uint		bufferWidth		= hm->mBufferWidth;
+	const uint		bufferHeight	= hm->mBufferHeight;
+	const uint		meshWidth		= hm->mMeshSize.x < 2 ? 2 : hm->mMeshSize.x;
+	const uint		meshHeight		= hm->mMeshSize.y < 2 ? 2 : hm->mMeshSize.y;
+	const Vector3f& terrainScale	= hm->mTerrainScale;
+	const Vector3f& terrainOffset	= hm->mTerrainOffset;
+
+	// The number of indices is always one less than the number of vertices
+	uint indexX = meshWidth  - 1;
+	uint indexY = meshHeight - 1;
+
+	mMeshSize.Set(meshWidth, meshHeight);
+	mGenBounds.Clear();
+
+	// Scaled value that will convert vertex iterators below into
+	// 0-1 range relative to the size of the terrain
+	Vector2f iterToRelative (mSize.x / indexX, mSize.y / indexY);
+
+	// Create a temporary buffer
+	Vector3f* start = (Vector3f*)mVertices.Resize(meshWidth * meshHeight * sizeof(Vector3f));
+	Vector3f* v = start;
+
+	float fx, fy, wx, wy, wz;
+
+	uint myWidth  = Float::RoundToUInt(mSize.x * bufferWidth);
+	uint myHeight = Float::RoundToUInt(mSize.y * bufferHeight);
+	bool upsample = (meshWidth > myWidth && meshHeight > myHeight);
+
+	// Fill the buffer with vertices
+	for (unsigned int y = 0; y < meshHeight; ++y)
 	{
-		// Passed parameters used to generate the terrain
-		const Terrain::Heightmap* hm	= (const Terrain::Heightmap*)ptr;
-		const float*	buffer			= hm->mBufferData;
-		const uint		bufferWidth		= hm->mBufferWidth;
-		const uint		bufferHeight	= hm->mBufferHeight;
-		const uint		meshWidth		= hm->mMeshSize.x < 2 ? 2 : hm->mMeshSize.x;
-		const uint		meshHeight		= hm->mMeshSize.y < 2 ? 2 : hm->mMeshSize.y;
-		const Vector3f& terrainScale	= hm->mTerrainScale;
-		const Vector3f& terrainOffset	= hm->mTerrainOffset;
-
-		// The number of indices is always one less than the number of vertices
-		uint indexX = meshWidth  - 1;
-		uint indexY = meshHeight - 1;
-
-		Memory mem;
-
-		// Generate all the vertices
+		fy = mOffset.y + iterToRelative.y * y;
+		wy = terrainOffset.y + fy * terrainScale.y;
+
+		for (unsigned int x = 0; x < meshWidth; ++x, ++v)
 		{
-			// Scaled value that will convert vertex iterators below into
-			// 0-1 range relative to the size of the terrain
-			Vector2f iterToRelative (mSize.x / indexX, mSize.y / indexY);
+			fx = mOffset.x + iterToRelative.x * x;
+			wx = terrainOffset.x + fx * terrainScale.x;
 
-			// Create a temporary buffer
-			Vector3f* v = (Vector3f*)mem.Resize(meshWidth * meshHeight * sizeof(Vector3f));
+			// Sample the buffer using hermite filtering if upsampling
+			wz = upsample ?
+				Interpolation::HermiteClamp (buffer, bufferWidth, bufferHeight, fx, fy) :
+				Interpolation::BilinearClamp(buffer, bufferWidth, bufferHeight, fx, fy);
 
-			float fx, fy, wx, wy, wz;
+			// Set the vertex
+			v->Set(wx, wy, wz * terrainScale.z + terrainOffset.z);
 
-			uint myWidth  = Float::RoundToUInt(mSize.x * bufferWidth);
-			uint myHeight = Float::RoundToUInt(mSize.y * bufferHeight);
-			bool upsample = (meshWidth > myWidth && meshHeight > myHeight);
+			// Include this vertex in the node's bounds
+			mGenBounds.Include(*v);
+		}
+	}
 
-			// Fill the buffer with vertices
-			for (unsigned int y = 0; y < meshHeight; ++y)
-			{
-				fy = mOffset.y + iterToRelative.y * y;
-				wy = terrainOffset.y + fy * terrainScale.y;
+	// Take padding into consideration
+	if (bboxPadding > 0.0f)
+	{
+		Vector3f min (mGenBounds.GetMin());
+		Vector3f max (mGenBounds.GetMax());
 
-				for (unsigned int x = 0; x < meshWidth; ++x, ++v)
-				{
-					fx = mOffset.x + iterToRelative.x * x;
-					wx = terrainOffset.x + fx * terrainScale.x;
+		min.y -= bboxPadding;
+		max.y += bboxPadding;
 
-					// Sample the buffer using hermite filtering if upsampling
-					wz = upsample ?
-						Interpolation::HermiteClamp (buffer, bufferWidth, bufferHeight, fx, fy) :
-						Interpolation::BilinearClamp(buffer, bufferWidth, bufferHeight, fx, fy);
+		mGenBounds.Include(min);
+		mGenBounds.Include(max);
+	}
 
-					// Set the vertex
-					v->Set(wx, wy, wz * terrainScale.z + terrainOffset.z);
+	// Calculate the maximum height error introduced by skipping vertices at each level of detail
+	mLODError.Clear();
+	mLODError.Expand() = 0.0f;
 
-					// Include this vertex in the node's bounds
-					mBounds.Include(*v);
-				}
-			}
+	for (uint lod = 1; lod < lodCount; ++lod)
+	{
+		uint step = 1 << lod;
+		float error = mLODError.Back();
+		float invStep = 1.0f / step;
 
-			// Take padding into consideration
-			if (bboxPadding > 0.0f)
+		for (uint y = 0; y < meshHeight; ++y)
+		{
+			uint y0 = (y / step) * step;
+			uint y1 = (y0 + step < meshHeight) ? y0 + step : y0;
+			float fy = (y - y0) * invStep;
+
+			for (uint x = 0; x < meshWidth; ++x)
 			{
-				Vector3f min (mBounds.GetMin());
-				Vector3f max (mBounds.GetMax());
+				uint x0 = (x / step) * step;
+				uint x1 = (x0 + step < meshWidth) ? x0 + step : x0;
+				float fx = (x - x0) * invStep;
 
-				min.y -= bboxPadding;
-				max.y += bboxPadding;
+				float z = (start[x0 + y0 * meshWidth].z * (1.0f - fx) + start[x1 + y0 * meshWidth].z * fx) * (1.0f - fy) +
+						  (start[x0 + y1 * meshWidth].z * (1.0f - fx) + start[x1 + y1 * meshWidth].z * fx) * fy;
 
-				mBounds.Include(min);
-				mBounds.Include(max);
+				float diff = Float::Abs(z - start[x + y * meshWidth].z);
+				if (diff > error) error = diff;
 			}
-
-			if (mVBO == 0) mVBO = graphics->CreateVBO();
-			
-			// Fill the VBO
-			mVBO->Lock();
-			mVBO->Set(mem.GetBuffer(), mem.GetSize(), IVBO::Type::Vertex);
-			mVBO->Unlock();
 		}
+		mLODError.Expand() = error;
+	}
+}
 
-		// Generate the indices
-		{
-			mIndices = indexX * indexY * 4;
-			ushort* index = (ushort*)mem.Resize(mIndices * sizeof(short));
+//============================================================================================================
+// Bitmask of edges that need to be stitched to neighbors drawn with less detail
+//============================================================================================================
 
-			// Fill the index array using quad primitives
-			for (unsigned int y = 0; y < indexY; ++y)
-			{
-				unsigned int y0 = meshWidth * y;
-				unsigned int y1 = meshWidth * (y + 1);
-
-				for (unsigned int x = 0; x < indexX; ++x)
-				{
-					*index = y1 + x;		++index;
-					*index = y0 + x;		++index;
-					*index = y0 + x + 1;	++index;
-					*index = y1 + x + 1;	++index;
-				}
-			}
+uint TerrainNode::_GetStitchMask() const
+{
+	uint mask = 0;
+
+	for (uint i = 0; i < 4; ++i)
+	{
+		const TerrainNode* node = mNeighbor[i];
+		if (node != 0 && node->mLOD > mLOD) mask |= (1 << i);
+	}
+	return mask;
+}
 
-			if (mIBO == 0) mIBO = graphics->CreateVBO();
+//============================================================================================================
+// Should create the node's topology and update 'mBounds'
+//============================================================================================================
 
-			mIBO->Lock();
-			mIBO->Set(mem.GetBuffer(), mem.GetSize(), IVBO::Type::Index);
-			mIBO->Unlock();
-		}
+void TerrainNode::OnFill (void* ptr, float bboxPadding)
+{
+	IGraphics* graphics = mTree->GetCore()->GetGraphics();
+
+	if (graphics != 0)
+	{
+		// Vertices may have already been generated on a worker thread by Terrain::Generate
+		if (mVertices.GetSize() == 0) _Generate(ptr, 1, bboxPadding);
+
+		mBounds.Include(mGenBounds);
+
+		if (mVBO == 0) mVBO = graphics->CreateVBO();
+
+		// Fill the VBO
+		mVBO->Lock();
+		mVBO->Set(mVertices.GetBuffer(), mVertices.GetSize(), IVBO::Type::Vertex);
+		mVBO->Unlock();
+
+		// The vertices are no longer needed
+		mVertices.Release();
 	}
 }
 
@@ -123,9 +158,23 @@ void TerrainNode::OnFill (void* ptr, float bboxPadding)
 void TerrainNode::OnDraw (uint group, const ITechnique* tech, bool insideOut)
 {
 	IGraphics* graphics = mTree->GetCore()->GetGraphics();
+	Terrain* terrain = (Terrain*)mTree;
+
+	uint count = 0;
+	const IVBO* ibo = terrain->_GetIndices(mMeshSize, mLOD, _GetStitchMask(), count);
 
-	graphics->SetActiveVertexAttribute( IGraphics::Attribute::Vertex,
-		mVBO, 0, IGraphics::DataType::Float, 3, 0 );
+	if (ibo != 0)
+	{
+		graphics->SetActiveVertexAttribute( IGraphics::Attribute::Vertex,
+			mVBO, 0, IGraphics::DataType::Float, 3, 0 );
 
-	graphics->DrawIndices(mIBO, IGraphics::Primitive::Quad, mIndices);
-}
\ No newline at end of file
+		if (terrain->mLargeIndices)
+		{
+			graphics->DrawIndices(ibo, IGraphics::Primitive::Triangle, count, IGraphics::DataType::UInt);
+		}
+		else
+		{
+			graphics->DrawIndices(ibo, IGraphics::Primitive::Triangle, count);
+		}
+	}
+}
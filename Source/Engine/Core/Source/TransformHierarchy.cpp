@@ -0,0 +1,576 @@
+#include "../Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Levels are split into chunks of this many objects, and only levels with at least PARALLEL_THRESHOLD
+// objects get processed on multiple threads.
+//============================================================================================================
+
+#define CHUNK_SIZE			512
+#define PARALLEL_THRESHOLD	4096
+
+//============================================================================================================
+// Values are compared bit by bit, as even the smallest change must be passed down to the children
+//============================================================================================================
+
+template <typename Type> inline bool IsSame (const Type& a, const Type& b)
+{
+	return memcmp(&a, &b, sizeof(Type)) == 0;
+}
+
+//============================================================================================================
+
+inline bool IsZero (const Vector3f& v) { return v.x == 0.0f && v.y == 0.0f && v.z == 0.0f; }
+
+//============================================================================================================
+// Updates the specified root and all of its children
+//============================================================================================================
+
+void TransformHierarchy::Update (Object* root)
+{
+	// Objects removed since the last update get deleted once they are no longer referenced by the list
+	if (mIsDirty) _Rebuild(root, true);
+
+	mDelta = Time::GetDelta();
+
+	ScriptRegistry& scripts = root->mCore->GetScriptRegistry();
+	_PreUpdate(scripts);
+
+	// Objects added by the pre-update callbacks should be updated right away. Objects removed by them
+	// are still referenced by their parents, so the list needs to be rebuilt again on the next update.
+	if (mIsDirty)
+	{
+		_Rebuild(root, false);
+		mIsDirty = true;
+	}
+
+	_Execute(&TransformHierarchy::_TransformJob, false);
+	_Update(scripts);
+	_Execute(&TransformHierarchy::_BoundsJob, true);
+	_PostUpdate(scripts);
+}
+
+//============================================================================================================
+// Releases the list
+//============================================================================================================
+
+void TransformHierarchy::Release()
+{
+	mObjects.Release();
+	mParent.Release();
+	mFirst.Release();
+	mCount.Release();
+	mLevels.Release();
+	mLocalPos.Release();
+	mLocalRot.Release();
+	mLocalScale.Release();
+	mLastPos.Release();
+	mWorldPos.Release();
+	mWorldRot.Release();
+	mWorldScale.Release();
+	mVelocity.Release();
+	mBounds.Release();
+	mFlags.Release();
+	mIsDirty = true;
+}
+
+//============================================================================================================
+// Rebuilds the list, reading all values from the objects
+//============================================================================================================
+
+void TransformHierarchy::_Rebuild (Object* root, bool clearDeleted)
+{
+	R5_PROFILE("TransformHierarchy::Rebuild");
+
+	mIsDirty = false;
+	mObjects.Clear();
+	mParent.Clear();
+	mFirst.Clear();
+	mCount.Clear();
+	mLevels.Clear();
+
+	mObjects.Expand() = root;
+	mParent.Expand() = INVALID_VAL;
+
+	// Gather the objects one level at a time. Children are added in reverse order, as that's the order
+	// they are updated in by Object::Update.
+	for (uint from = 0, to = 1; from < to; from = to, to = mObjects.GetSize())
+	{
+		mLevels.Expand() = from;
+
+		for (uint i = from; i < to; ++i)
+		{
+			Object* obj = mObjects[i];
+			Object::Children& children = obj->mChildren;
+
+			if (clearDeleted)
+			{
+				if (obj->mDeletedObjects.IsValid()) obj->mDeletedObjects.Clear();
+				if (obj->mDeletedScripts.IsValid()) obj->mDeletedScripts.Clear();
+			}
+
+			uint first = mObjects.GetSize();
+			mFirst.Expand() = first;
+
+			for (uint c = children.GetSize(); c > 0; )
+			{
+				Object* child = children[--c];
+
+				if (child != 0)
+				{
+					mObjects.Expand() = child;
+					mParent.Expand() = i;
+				}
+			}
+			mCount.Expand() = mObjects.GetSize() - first;
+		}
+	}
+	mLevels.Expand() = mObjects.GetSize();
+
+	// Read the current values of all objects
+	uint count = mObjects.GetSize();
+
+	mLocalPos.ExpandTo(count);
+	mLocalRot.ExpandTo(count);
+	mLocalScale.ExpandTo(count);
+	mLastPos.ExpandTo(count);
+	mWorldPos.ExpandTo(count);
+	mWorldRot.ExpandTo(count);
+	mWorldScale.ExpandTo(count);
+	mVelocity.ExpandTo(count);
+	mBounds.ExpandTo(count);
+	mFlags.ExpandTo(count);
+
+	for (uint i = 0; i < count; ++i)
+	{
+		Object* obj = mObjects[i];
+		uint parent = mParent[i];
+		byte flags = 0;
+
+		obj->mFlatIndex = i;
+
+		mLocalPos[i]	= obj->mRelativePos;
+		mLocalRot[i]	= obj->mRelativeRot;
+		mLocalScale[i]	= obj->mRelativeScale;
+		mLastPos[i]		= obj->mLastPos;
+		mWorldPos[i]	= obj->mAbsolutePos;
+		mWorldRot[i]	= obj->mAbsoluteRot;
+		mWorldScale[i]	= obj->mAbsoluteScale;
+		mVelocity[i]	= obj->mAbsoluteVel;
+		mBounds[i]		= obj->mCompleteBounds;
+
+		if (obj->mFlags.Get(Object::Flag::Enabled) && (parent == INVALID_VAL || (mFlags[parent] & Flag::Active)))
+			flags |= Flag::Active;
+
+		if (obj->mHasMoved)					flags |= Flag::Moved;
+		if (!IsZero(obj->mAbsoluteVel))		flags |= Flag::Velocity;
+
+		// Callbacks that have never been executed can't be ignored yet
+		if (!obj->mIgnore.Get(Object::Ignore::PreUpdate))	flags |= Flag::PreUpdate;
+		if (!obj->mIgnore.Get(Object::Ignore::Update))		flags |= Flag::Update;
+		if (!obj->mIgnore.Get(Object::Ignore::PostUpdate))	flags |= Flag::PostUpdate;
+
+		mFlags[i] = flags;
+	}
+}
+
+//============================================================================================================
+// Executes the specified job on all levels, splitting large levels between multiple threads
+//============================================================================================================
+
+void TransformHierarchy::_Execute (void (TransformHierarchy::*job)(uint), bool bottomUp)
+{
+	uint depth = GetDepth();
+
+	for (uint i = 0; i < depth; ++i)
+	{
+		uint level = bottomUp ? depth - 1 - i : i;
+
+		mFrom	= mLevels[level];
+		mTo		= mLevels[level + 1];
+
+		uint chunks = (mTo - mFrom + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+		if (mThreads != 1 && mTo - mFrom >= PARALLEL_THRESHOLD)
+		{
+			Thread::ParallelFor(chunks, bind(job, this), (mThreads > 0) ? mThreads - 1 : 0);
+		}
+		else
+		{
+			for (uint c = 0; c < chunks; ++c) (this->*job)(c);
+		}
+	}
+}
+
+//============================================================================================================
+// Calculates the transforms of a chunk of the current level
+//============================================================================================================
+
+void TransformHierarchy::_TransformJob (uint chunk)
+{
+	uint from = mFrom + chunk * CHUNK_SIZE;
+	uint to = Min(from + CHUNK_SIZE, mTo);
+	for (uint i = from; i < to; ++i) _Transform(i);
+}
+
+//============================================================================================================
+// Calculates the bounds of a chunk of the current level
+//============================================================================================================
+
+void TransformHierarchy::_BoundsJob (uint chunk)
+{
+	uint from = mFrom + chunk * CHUNK_SIZE;
+	uint to = Min(from + CHUNK_SIZE, mTo);
+	for (uint i = from; i < to; ++i) _UpdateBounds(i);
+}
+
+//============================================================================================================
+// Calculates the absolute values of the specified object using its relative values and the specified
+// parent's absolute values, writing them back to the object.
+//============================================================================================================
+
+void TransformHierarchy::_Combine (uint index, const Vector3f& pos, const Quaternion& rot, const Vector3f& scale)
+{
+	Object* obj = mObjects[index];
+
+	mLocalPos[index]	= obj->mRelativePos;
+	mLocalRot[index]	= obj->mRelativeRot;
+	mLocalScale[index]	= obj->mRelativeScale;
+
+	mWorldPos[index]	= (mLocalPos[index] * rot) * scale + pos;
+	mWorldScale[index]	= mLocalScale[index] * scale;
+	mWorldRot[index].Combine(rot, mLocalRot[index]);
+
+	obj->mAbsolutePos	= mWorldPos[index];
+	obj->mAbsoluteRot	= mWorldRot[index];
+	obj->mAbsoluteScale	= mWorldScale[index];
+	obj->mIsDirty		= true;
+	obj->mHasMoved		= true;
+
+	mFlags[index] |= Flag::Dirty | Flag::Moved;
+}
+
+//============================================================================================================
+// Calculates the absolute values of the specified object and its velocity
+//============================================================================================================
+
+void TransformHierarchy::_Transform (uint index)
+{
+	Object* obj = mObjects[index];
+	uint parent = mParent[index];
+	byte flags = mFlags[index] & ~(Flag::Active | Flag::Dirty | Flag::Pending);
+	mFlags[index] = flags;
+
+	// Disabled objects are skipped by their parents, along with all of their children
+	if (parent != INVALID_VAL && (!(mFlags[parent] & Flag::Active) ||
+		!obj->mFlags.Get(Object::Flag::Enabled))) return;
+
+	if (flags & Flag::Moved)
+	{
+		obj->mHasMoved = false;
+		flags &= ~Flag::Moved;
+	}
+
+	// The root is disabled -- no velocity
+	if (!obj->mFlags.Get(Object::Flag::Enabled))
+	{
+		obj->mRelativeVel.Set(0.0f, 0.0f, 0.0f);
+		obj->mAbsoluteVel = obj->mRelativeVel;
+		mVelocity[index] = obj->mAbsoluteVel;
+		mFlags[index] = flags | Flag::Velocity;
+		return;
+	}
+
+	mFlags[index] = flags | Flag::Active;
+
+	// If the object or its parent has changed, update the absolute values
+	if (obj->mIsDirty || (parent != INVALID_VAL && (mFlags[parent] & Flag::Dirty)))
+	{
+		if (parent != INVALID_VAL)
+		{
+			_Combine(index, mWorldPos[parent], mWorldRot[parent], mWorldScale[parent]);
+		}
+		else
+		{
+			_Combine(index, Vector3f(), Quaternion(), Vector3f(1.0f));
+		}
+	}
+
+	// Calculate the velocity since last update
+	const Vector3f& pos = mLocalPos[index];
+	Vector3f relVel ((pos - mLastPos[index]) / mDelta);
+	Vector3f absVel (relVel);
+
+	if (parent != INVALID_VAL)
+	{
+		absVel *= mWorldScale[index];
+		absVel += mVelocity[parent];
+	}
+	mVelocity[index] = absVel;
+
+	// Velocity only needs to be written if it's not zero, or wasn't zero the last time it was written
+	bool moving = !IsZero(relVel) || !IsZero(absVel);
+
+	if (moving || (mFlags[index] & Flag::Velocity))
+	{
+		obj->mRelativeVel = relVel;
+		obj->mAbsoluteVel = absVel;
+		if (moving) mFlags[index] |= Flag::Velocity;
+		else mFlags[index] &= ~Flag::Velocity;
+	}
+
+	if (!IsSame(mLastPos[index], pos))
+	{
+		mLastPos[index] = pos;
+		obj->mLastPos = pos;
+	}
+}
+
+//============================================================================================================
+// Calculates the bounds of the specified object
+//============================================================================================================
+
+void TransformHierarchy::_UpdateBounds (uint index)
+{
+	byte flags = mFlags[index];
+	if (!(flags & Flag::Active)) return;
+
+	Object* obj = mObjects[index];
+	uint first = mFirst[index];
+	uint last = first + mCount[index];
+
+	// Bounds need to be recalculated if the object or any of its children have changed
+	bool dirty = obj->mIsDirty;
+
+	for (uint i = first; !dirty && i < last; ++i)
+		if ((mFlags[i] & (Flag::Active | Flag::Dirty)) == (Flag::Active | Flag::Dirty))
+			dirty = true;
+
+	if (!dirty)
+	{
+		mFlags[index] = flags & ~Flag::Dirty;
+		return;
+	}
+
+	obj->mIsDirty = true;
+
+	// Recalculate absolute bounds
+	if (obj->mCalcAbsBounds)
+	{
+		if (obj->mRelativeBounds.IsValid())
+		{
+			obj->mAbsoluteBounds = obj->mRelativeBounds;
+			obj->mAbsoluteBounds.Transform(obj->mAbsolutePos, obj->mAbsoluteRot, obj->mAbsoluteScale);
+		}
+		else
+		{
+			obj->mAbsoluteBounds.Clear();
+		}
+	}
+
+	// Start with absolute bounds, including the bounds of all children. Bounds of the children that haven't
+	// changed are read from the objects, as they might have been set outside of the update.
+	Bounds& complete = mBounds[index];
+	complete = obj->mAbsoluteBounds;
+
+	if (obj->mIncChildBounds)
+	{
+		for (uint i = first; i < last; ++i)
+		{
+			byte child = mFlags[i];
+			if (child & Flag::Active) complete.Include((child & Flag::Dirty) ? mBounds[i] :
+				mObjects[i]->mCompleteBounds);
+		}
+	}
+	obj->mCompleteBounds = complete;
+	flags |= Flag::Dirty;
+
+	// Relative values changed by the update callbacks will only be applied on the next update
+	if (!IsSame(obj->mRelativePos, mLocalPos[index]) ||
+		!IsSame(obj->mRelativeRot, mLocalRot[index]) ||
+		!IsSame(obj->mRelativeScale, mLocalScale[index])) flags |= Flag::Pending;
+
+	mFlags[index] = flags;
+}
+
+//============================================================================================================
+// Whether the absolute values of the specified object differ from the ones calculated by the list
+//============================================================================================================
+
+bool TransformHierarchy::_IsOverridden (uint index) const
+{
+	const Object* obj = mObjects[index];
+	return !IsSame(obj->mAbsolutePos, mWorldPos[index]) ||
+		   !IsSame(obj->mAbsoluteRot, mWorldRot[index]) ||
+		   !IsSame(obj->mAbsoluteScale, mWorldScale[index]);
+}
+
+//============================================================================================================
+// Accepts the absolute values the specified object currently has as its own
+//============================================================================================================
+
+void TransformHierarchy::_Override (uint index)
+{
+	const Object* obj = mObjects[index];
+	mWorldPos[index]	= obj->mAbsolutePos;
+	mWorldRot[index]	= obj->mAbsoluteRot;
+	mWorldScale[index]	= obj->mAbsoluteScale;
+	mFlags[index]	   |= Flag::Dirty;
+}
+
+//============================================================================================================
+// Passes the overridden absolute values of the specified object down to all of its descendants
+//============================================================================================================
+
+void TransformHierarchy::_Propagate (uint index)
+{
+	_Override(index);
+
+	// Children of a contiguous range of objects form a contiguous range on the next level
+	for (uint from = index, to = index + 1; from < to; )
+	{
+		uint first = mFirst[from];
+		uint last = mFirst[to - 1] + mCount[to - 1];
+
+		for (uint i = first; i < last; ++i)
+		{
+			if (mFlags[i] & Flag::Active)
+			{
+				// Descendants that had their absolute values overridden by their own scripts keep them
+				if (_IsOverridden(i))
+				{
+					_Override(i);
+				}
+				else
+				{
+					uint parent = mParent[i];
+					_Combine(i, mWorldPos[parent], mWorldRot[parent], mWorldScale[parent]);
+				}
+			}
+		}
+
+		from = first;
+		to = last;
+	}
+}
+
+//============================================================================================================
+// Whether the specified object is a part of the list, and it and all of its parents are enabled
+//============================================================================================================
+
+bool TransformHierarchy::_IsActive (const Object* obj) const
+{
+	if (obj == 0) return false;
+	uint index = obj->mFlatIndex;
+	return index < mObjects.GetSize() && mObjects[index] == obj &&
+		(mFlags[index] & Flag::Active) && obj->mFlags.Get(Object::Flag::Enabled);
+}
+
+//============================================================================================================
+// Executes the callback of all scripts subscribed to the specified phase, one script type at a time
+//============================================================================================================
+
+void TransformHierarchy::_ExecuteScripts (ScriptRegistry& scripts, uint phase, void (Script::*callback)())
+{
+	scripts.BeginPhase(phase);
+
+	for (uint type = 0; type < scripts.GetTypeCount(); ++type)
+	{
+		// The list can grow as the scripts are executed, so it has to be retrieved every time
+		for (uint i = 0; i < scripts.GetList(phase, type).GetSize(); ++i)
+		{
+			Script* script = scripts.GetList(phase, type)[i];
+			if (script != 0 && _IsActive(script->mObject)) (script->*callback)();
+		}
+	}
+	scripts.EndPhase(phase);
+}
+
+//============================================================================================================
+// Executes the pre-update callbacks of the scripts, followed by the objects' own, parents first
+//============================================================================================================
+
+void TransformHierarchy::_PreUpdate (ScriptRegistry& scripts)
+{
+	R5_PROFILE("TransformHierarchy::PreUpdate");
+	_ExecuteScripts(scripts, ScriptRegistry::Phase::PreUpdate, &Script::OnPreUpdate);
+
+	const byte mask = Flag::Active | Flag::PreUpdate;
+
+	for (uint i = 0, imax = mObjects.GetSize(); i < imax; ++i)
+	{
+		if ((mFlags[i] & mask) == mask)
+		{
+			Object* obj = mObjects[i];
+
+			if (obj->mFlags.Get(Object::Flag::Enabled))
+			{
+				obj->OnPreUpdate();
+				if (obj->mIgnore.Get(Object::Ignore::PreUpdate)) mFlags[i] &= ~Flag::PreUpdate;
+			}
+		}
+	}
+}
+
+//============================================================================================================
+// Executes the update callbacks of the scripts, followed by the objects' own, parents first
+//============================================================================================================
+
+void TransformHierarchy::_Update (ScriptRegistry& scripts)
+{
+	R5_PROFILE("TransformHierarchy::Update");
+	_ExecuteScripts(scripts, ScriptRegistry::Phase::Update, &Script::OnUpdate);
+
+	for (uint i = 0, imax = mObjects.GetSize(); i < imax; ++i)
+	{
+		byte flags = mFlags[i];
+		if (!(flags & Flag::Active)) continue;
+
+		Object* obj = mObjects[i];
+
+		// Objects without any update callbacks keep the values calculated by the list
+		if (!(flags & Flag::Update) && obj->mListeners[ScriptRegistry::Phase::Update] == 0) continue;
+		if (!obj->mFlags.Get(Object::Flag::Enabled)) continue;
+
+		if (flags & Flag::Update)
+		{
+			obj->OnUpdate();
+			if (obj->mIgnore.Get(Object::Ignore::Update)) mFlags[i] &= ~Flag::Update;
+			if (!obj->mFlags.Get(Object::Flag::Enabled)) continue;
+		}
+
+		// If the callbacks have marked the object as dirty or overridden its absolute values,
+		// all of its descendants need to be updated before their own callbacks get executed.
+		if ((obj->mIsDirty && !(flags & Flag::Dirty)) || _IsOverridden(i)) _Propagate(i);
+	}
+}
+
+//============================================================================================================
+// Executes the post-update callbacks of the scripts, followed by the objects' own, children first
+//============================================================================================================
+
+void TransformHierarchy::_PostUpdate (ScriptRegistry& scripts)
+{
+	R5_PROFILE("TransformHierarchy::PostUpdate");
+	_ExecuteScripts(scripts, ScriptRegistry::Phase::PostUpdate, &Script::OnPostUpdate);
+
+	for (uint i = mObjects.GetSize(); i > 0; )
+	{
+		byte flags = mFlags[--i];
+		if (!(flags & Flag::Active)) continue;
+
+		Object* obj = mObjects[i];
+		if (!obj->mFlags.Get(Object::Flag::Enabled)) continue;
+
+		if (flags & Flag::PostUpdate)
+		{
+			obj->OnPostUpdate();
+			if (obj->mIgnore.Get(Object::Ignore::PostUpdate)) mFlags[i] &= ~Flag::PostUpdate;
+			if (!obj->mFlags.Get(Object::Flag::Enabled)) continue;
+		}
+		else if (!(flags & Flag::Dirty)) continue;
+
+		// All absolute values have now been calculated
+		if (!(flags & Flag::Pending)) obj->mIsDirty = false;
+	}
+}
@@ -2,68 +2,232 @@
 using namespace R5;
 
 //============================================================================================================
-// Adds a new OnKeyPress event listener
-//============================================================================================================
-
-void UpdateList::Add (const Callback& callback, float delay)
-{
-	mUpdate.Lock();
-	{
-		UpdateEntry& entry = mUpdate.Expand();
-		entry.time = Time::GetTime() + delay;
-		entry.callback = callback;
-	}
-	mUpdate.Unlock();
+// Handles combine the index of the entry with its serial number
+//============================================================================================================
+
+#define INDEX_BITS	22
+#define INDEX_MASK	((1 << INDEX_BITS) - 1)
+#define SERIAL_MASK	((1 << (32 - INDEX_BITS)) - 1)
+
+//============================================================================================================
+// Adds a new update function to the list, executed after an optional delay in seconds
+//============================================================================================================
+
+UpdateList::Handle UpdateList::Add (const Callback& callback, float delay)
+{
+	Handle handle;
+
+	mLock.Lock();
+	{
+		uint index;
+
+		if (mUnused.IsValid())
+		{
+			index = mUnused.Back();
+			mUnused.Shrink();
+		}
+		else
+		{
+			index = mEntries.GetSize();
+			UpdateEntry& entry = mEntries.Expand();
+			entry.serial = 1;
+			entry.used	 = false;
+		}
+
+		UpdateEntry& entry = mEntries[index];
+		entry.callback	= callback;
+		entry.slot		= INVALID_VAL;
+		entry.timer		= 0;
+		entry.used		= true;
+		handle = (entry.serial << INDEX_BITS) | index;
+
+		_Schedule(index, delay, Time::GetMilliseconds());
+	}
+	mLock.Unlock();
+	return handle;
 }
 
 //============================================================================================================
-// Removes the specified function from the list
-//============================================================================================================
+// Removes the specified function from the list
+//============================================================================================================
 
 void UpdateList::Remove (const Callback& callback)
 {
-	mUpdate.Lock();
+	mLock.Lock();
 	{
-		FOREACH(i, mUpdate)
+		FOREACH(i, mEntries)
 		{
-			UpdateEntry& entry = mUpdate[i];
+			UpdateEntry& entry = mEntries[i];
 
-			if (entry.callback == callback)
+			if (entry.used && entry.callback == callback)
 			{
-				mUpdate.RemoveAt(i);
+				_Release(i);
 				break;
 			}
 		}
 	}
-	mUpdate.Unlock();
+	mLock.Unlock();
+}
+
+//============================================================================================================
+// Removes the function added with the specified handle
+//============================================================================================================
+
+void UpdateList::Remove (Handle handle)
+{
+	mLock.Lock();
+	if (_IsValid(handle)) _Release(handle & INDEX_MASK);
+	mLock.Unlock();
+}
+
+//============================================================================================================
+// Runs through all update listeners and calls them as necessary
+//============================================================================================================
+
+void UpdateList::Execute()
+{
+	mLock.Lock();
+	{
+		ulong time = Time::GetMilliseconds();
+
+		// Delayed callbacks that have come due are executed along with the ones executed every update
+		mDue.Clear();
+		mWheel.Advance(time, mDue);
+
+		for (uint i = 0; i < mDue.GetSize(); ++i) mEntries[mDue[i] & INDEX_MASK].timer = 0;
+
+		// Callbacks executed every update follow, with the ones that were added first going last
+		if (mGaps != 0) _Compact();
+
+		for (uint i = mFrame.GetSize(); i > 0; )
+		{
+			uint index = mFrame[--i];
+			mDue.Expand() = (mEntries[index].serial << INDEX_BITS) | index;
+		}
+
+		// The list is unlocked while the callbacks run, so they are free to add and remove callbacks
+		for (uint i = 0; i < mDue.GetSize(); ++i)
+		{
+			Handle handle = mDue[i];
+			if (!_IsValid(handle)) continue;
+
+			uint index = handle & INDEX_MASK;
+			Callback callback (mEntries[index].callback);
+
+			mLock.Unlock();
+			float result = callback();
+			mLock.Lock();
+
+			// The callback may have removed itself
+			if (!_IsValid(handle)) continue;
+
+			if (result < 0.0f)
+			{
+				_Release(index);
+			}
+			else
+			{
+				_Schedule(index, result, time);
+			}
+		}
+		mDue.Clear();
+	}
+	mLock.Unlock();
 }
 
-//============================================================================================================
-// Runs through all update listeners and calls them as necessary
-//============================================================================================================
-
-void UpdateList::Execute()
-{
-	mUpdate.Lock();
-	{
-		float time = Time::GetTime(), result;
-
-		for (uint i = mUpdate.GetSize(); i > 0; )
-		{
-			UpdateEntry& entry = mUpdate[--i];
-			if (entry.time > time) continue;
-
-			result = entry.callback();
-
-			if (result < 0.0f)
-			{
-				mUpdate.RemoveAt(i);
-			}
-			else
-			{
-				entry.time = time + result;
-			}
-		}
-	}
-	mUpdate.Unlock();
-}
\ No newline at end of file
+//============================================================================================================
+// Whether the handle refers to a callback in the list
+//============================================================================================================
+
+bool UpdateList::_IsValid (Handle handle) const
+{
+	uint index = handle & INDEX_MASK;
+	return index < mEntries.GetSize() && mEntries[index].used && mEntries[index].serial == (handle >> INDEX_BITS);
+}
+
+//============================================================================================================
+// Schedules the entry to be executed after the specified delay in seconds
+//============================================================================================================
+
+void UpdateList::_Schedule (uint index, float delay, ulong time)
+{
+	UpdateEntry& entry = mEntries[index];
+	uint ms = (delay > 0.0f) ? Float::RoundToUInt(delay * 1000.0f) : 0;
+
+	if (ms == 0)
+	{
+		// No delay -- the callback is executed on every update
+		if (entry.slot == INVALID_VAL)
+		{
+			_Unschedule(index);
+			entry.slot = mFrame.GetSize();
+			mFrame.Expand() = index;
+		}
+	}
+	else
+	{
+		_Unschedule(index);
+		entry.timer = mWheel.Add((entry.serial << INDEX_BITS) | index, time + ms);
+	}
+}
+
+//============================================================================================================
+// Takes the entry off the list of callbacks executed every update, or off the timing wheel
+//============================================================================================================
+
+void UpdateList::_Unschedule (uint index)
+{
+	UpdateEntry& entry = mEntries[index];
+
+	if (entry.slot != INVALID_VAL)
+	{
+		// The list keeps its order, so the gap gets closed on the next update
+		mFrame[entry.slot] = INVALID_VAL;
+		entry.slot = INVALID_VAL;
+		++mGaps;
+	}
+
+	if (entry.timer != 0)
+	{
+		mWheel.Remove(entry.timer);
+		entry.timer = 0;
+	}
+}
+
+//============================================================================================================
+// Removes the entry from the list
+//============================================================================================================
+
+void UpdateList::_Release (uint index)
+{
+	_Unschedule(index);
+
+	UpdateEntry& entry = mEntries[index];
+	entry.callback.clear();
+	entry.used	 = false;
+	entry.serial = (entry.serial == SERIAL_MASK) ? 1 : entry.serial + 1;
+	mUnused.Expand() = index;
+}
+
+//============================================================================================================
+// Closes the gaps left behind in the list of callbacks executed every update
+//============================================================================================================
+
+void UpdateList::_Compact()
+{
+	uint count = 0;
+
+	for (uint i = 0; i < mFrame.GetSize(); ++i)
+	{
+		uint index = mFrame[i];
+
+		if (index != INVALID_VAL)
+		{
+			mEntries[index].slot = count;
+			mFrame[count++] = index;
+		}
+	}
+
+	while (mFrame.GetSize() > count) mFrame.Shrink();
+	mGaps = 0;
+}
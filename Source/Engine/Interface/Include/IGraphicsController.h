@@ -22,8 +22,15 @@ struct IGraphicsController
 		{
 			Invalid		= 0,
 			Byte		= 0x1401,
+			Short		= 0x1402,
+			UShort		= 0x1403,
 			Int			= 0x1404,
+			UInt		= 0x1405,
 			Float		= 0x1406,
+			HalfFloat	= 0x140B,
+
+			// Flag that can be combined with integer types to have them normalized to 0-1 (or -1 to 1) range
+			Normalized	= 0x10000,
 		};
 	};
 
@@ -218,6 +225,10 @@ public:
 	virtual uint DrawIndices	( const IVBO* vbo, uint primitive, uint indexCount )=0;
 	virtual uint DrawIndices	( const ushort* indices, uint primitive, uint indexCount )=0;
 
+	// 32-bit index versions of the draw functions above, for meshes with more than 65535 vertices
+	virtual uint DrawIndices	( const IVBO* vbo, uint primitive, uint indexCount, uint dataType )=0;
+	virtual uint DrawIndices	( const uint* indices, uint primitive, uint indexCount )=0;
+
 public: // Convenience functions
 
 	inline void SetActiveMaterial			( int zero )					{ SetActiveMaterial((const IMaterial*)0); }
@@ -48,8 +48,9 @@ struct IGraphicsManager
 	typedef ResourceArray<IShader>		Shaders;
 	typedef ResourceArray<IFont>		Fonts;
 
-	// Returns whether the specified point would be visible if rendered
-	virtual bool IsPointVisible (const Vector3f& v)=0;
+	// Returns the last known visibility of the point identified by 'id', and tests it again. Tests are
+	// asynchronous, with results arriving a few frames later. Identifiers should be unique: GenerateUID().
+	virtual bool IsPointVisible (uint id, const Vector3f& v)=0;
 
 	// Reads the buffer's color at the specified pixel
 	virtual Color4f ReadColor (const Vector2i& pos)=0;
@@ -218,4 +218,8 @@ namespace Float
 
 	// Rounds the float down to a specific precision, so 0.39 with precision of 0.25 becomes 0.5
 	float Round (float val, const float& precision);
+
+	// Conversion to and from 16-bit half precision floats (IEEE 754 binary16)
+	ushort	ToHalf		(float val);
+	float	FromHalf	(ushort val);
 };
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Functions operating on whole arrays of vectors, matrices and quaternions at once. When SIMD is available
+// they process 4 elements at a time, falling back to the regular scalar operators otherwise. Input and
+// output arrays can be the same, and don't require any particular alignment. Vectors that are transformed
+// often can be kept in a Vector3fSoA instead, saving the shuffling needed to split them into components.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+namespace Batch
+{
+	//========================================================================================================
+	// Vectors stored as separate X, Y and Z arrays (structure of arrays) rather than as Vector3f triplets.
+	// Each array is 16-byte aligned and padded to a multiple of 4, so SIMD can load and store 4 components
+	// at a time without having to shuffle them. Resizing the container discards its previous contents.
+	//========================================================================================================
+
+	class Vector3fSoA
+	{
+		float*	mBuffer;	// Allocated memory
+		float*	mX;			// Aligned X components
+		float*	mY;			// Aligned Y components
+		float*	mZ;			// Aligned Z components
+		uint	mSize;		// Number of vectors
+		uint	mAllocated;	// Number of vectors the memory was allocated for
+
+	public:
+
+		Vector3fSoA() : mBuffer(0), mX(0), mY(0), mZ(0), mSize(0), mAllocated(0) {}
+		Vector3fSoA (const Vector3fSoA& v) : mBuffer(0), mX(0), mY(0), mZ(0), mSize(0), mAllocated(0) { *this = v; }
+		~Vector3fSoA() { if (mBuffer != 0) delete [] mBuffer; }
+
+		Vector3fSoA& operator = (const Vector3fSoA& v);
+
+		uint			GetSize()	const	{ return mSize; }
+		bool			IsValid()	const	{ return mSize != 0; }
+		bool			IsEmpty()	const	{ return mSize == 0; }
+		const float*	GetX()		const	{ return mX; }
+		const float*	GetY()		const	{ return mY; }
+		const float*	GetZ()		const	{ return mZ; }
+		float*			GetX()				{ return mX; }
+		float*			GetY()				{ return mY; }
+		float*			GetZ()				{ return mZ; }
+
+		void Set (uint index, const Vector3f& v)	{ mX[index] = v.x; mY[index] = v.y; mZ[index] = v.z; }
+		Vector3f Get (uint index) const				{ return Vector3f(mX[index], mY[index], mZ[index]); }
+
+		// Resizes the container, reusing the allocated memory if it's large enough
+		void Resize (uint size);
+
+		// Clears the container without releasing its memory
+		void Clear() { mSize = 0; }
+
+		// Releases the allocated memory
+		void Release();
+	};
+
+	// Transforms the vertices by the specified matrix: out[i] = in[i] * mat
+	void Transform (const Matrix43& mat, const Vector3f* in, Vector3f* out, uint count);
+
+	// Same as above, transforming the 'count' vectors starting at 'first'
+	void Transform (const Matrix43& mat, const Vector3fSoA& in, Vector3fSoA& out, uint first, uint count);
+
+	// Rotates the vertices by the specified matrix, ignoring its translation: out[i] = in[i] % mat
+	void Rotate (const Matrix43& mat, const Vector3f* in, Vector3f* out, uint count);
+
+	// Same as above, rotating the 'count' vectors starting at 'first'
+	void Rotate (const Matrix43& mat, const Vector3fSoA& in, Vector3fSoA& out, uint first, uint count);
+
+	// Multiplies every matrix by the specified one: out[i] = in[i] * mat
+	void Multiply (const Matrix43* in, const Matrix43& mat, Matrix43* out, uint count);
+
+	// Multiplies pairs of matrices: out[i] = a[i] * b[i]
+	void Multiply (const Matrix43* a, const Matrix43* b, Matrix43* out, uint count);
+
+	// Combines pairs of quaternions: out[i].Combine(a[i], b[i])
+	void Combine (const Quaternion* a, const Quaternion* b, Quaternion* out, uint count);
+
+	// Spherical linear interpolation of quaternion pairs: out[i] = Interpolation::Slerp(from[i], to[i], factor)
+	void Slerp (const Quaternion* from, const Quaternion* to, float factor, Quaternion* out, uint count);
+};
@@ -94,4 +94,7 @@ public:
 
 	// Transform the bounding volume by the specified rotation
 	void Transform (const Quaternion& rot);
+
+	// Transform the bounding volume by the specified matrix
+	void Transform (const Matrix43& mat);
 };
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Welds duplicate vertices and reorders triangle lists for the GPU's post-transform and fetch caches
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class MeshOptimizer
+{
+public:
+
+	enum
+	{
+		CacheSize	= 32,			// Size of the simulated LRU cache used when reordering triangles
+		Invalid		= 0xFFFFFFFF,	// Remap value of vertices that are no longer referenced
+	};
+
+	// Vertex cache statistics, calculated using a FIFO cache
+	struct Stats
+	{
+		uint	mVertices;	// Number of referenced vertices
+		uint	mTriangles;	// Number of triangles
+		float	mACMR;		// Average cache miss ratio: vertices transformed per triangle (0.5 to 3.0, lower is better)
+		float	mATVR;		// Average transform to vertex ratio: times each vertex gets transformed (1.0 is ideal)
+
+		Stats() : mVertices(0), mTriangles(0), mACMR(0.0f), mATVR(0.0f) {}
+	};
+
+private:
+
+	struct Stream
+	{
+		const byte*	mData;
+		uint		mSize;
+	};
+
+	Array<Stream>	mStreams;	// Vertex attribute streams used to identify duplicate vertices
+	uint			mVertices;	// Number of vertices in each stream
+
+public:
+
+	MeshOptimizer() : mVertices(0) {}
+
+	// Registers a vertex attribute stream. All streams must have the same number of entries.
+	template <typename Type>
+	void AddStream (const Array<Type>& arr) { _AddStream(arr.GetBuffer(), sizeof(Type), arr.GetSize()); }
+
+	// Welds identical vertices, then reorders the triangle list for the post-transform cache and the vertices
+	// for the order they are used in. An empty index array is treated as an unindexed triangle list.
+	// Fills the 'remap' table (old vertex index to new) and returns the new number of vertices.
+	uint Optimize (Array<uint>& indices, Array<uint>& remap, bool weld = true) const;
+
+	// Calculates the vertex cache statistics of the specified triangle list
+	static void GetStats (const Array<uint>& indices, Stats& stats, uint cacheSize = 16);
+
+	// Builds a table mapping every vertex to the first identical one, returning the number of unique vertices
+	static uint Weld (const byte* data, uint stride, uint vertices, Array<uint>& remap);
+
+	// Reorders triangles for the post-transform cache (Tom Forsyth's linear-speed vertex cache optimization)
+	static void ReorderTriangles (Array<uint>& indices, uint vertices, uint cacheSize = CacheSize);
+
+	// Renumbers vertices in the order they are first referenced, returning the number of referenced vertices
+	static uint ReorderVertices (Array<uint>& indices, uint vertices, Array<uint>& remap);
+
+	// Rearranges the vertex attribute array according to the remap table
+	template <typename Type>
+	static void Remap (Array<Type>& arr, const Array<uint>& remap, uint count)
+	{
+		if (arr.GetSize() != remap.GetSize()) return;
+
+		Array<Type> temp (count);
+		temp.ExpandTo(count);
+
+		for (uint i = remap.GetSize(); i > 0; )
+		{
+			--i;
+			if (remap[i] != Invalid) temp[remap[i]] = arr[i];
+		}
+		arr.CopyMemory(temp);
+	}
+
+private:
+
+	void _AddStream (const void* data, uint size, uint count);
+};
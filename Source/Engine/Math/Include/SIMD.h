@@ -0,0 +1,163 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Thin wrapper around the SSE and NEON intrinsics, letting the math code be written once for both.
+// Loads and stores don't require any alignment, so existing matrices and arrays can be used as-is.
+// Aligned versions are available for 16-byte aligned data, such as Batch::Vector3fSoA.
+// Operations are performed in the same order as their scalar counterparts, giving identical results.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+#ifdef R5_SIMD
+
+namespace SIMD
+{
+#if defined(R5_SSE)
+
+typedef __m128 Float4;
+
+inline Float4	Load	(const float* f)					{ return _mm_loadu_ps(f);	}
+inline void		Store	(float* f, const Float4& v)			{ _mm_storeu_ps(f, v);		}
+inline Float4	LoadA	(const float* f)					{ return _mm_load_ps(f);	}
+inline void		StoreA	(float* f, const Float4& v)			{ _mm_store_ps(f, v);		}
+inline Float4	Splat	(float f)							{ return _mm_set1_ps(f);	}
+inline Float4	Add		(const Float4& a, const Float4& b)	{ return _mm_add_ps(a, b);	}
+inline Float4	Sub		(const Float4& a, const Float4& b)	{ return _mm_sub_ps(a, b);	}
+inline Float4	Mul		(const Float4& a, const Float4& b)	{ return _mm_mul_ps(a, b);	}
+
+//============================================================================================================
+// Loads 4 interleaved XYZ triplets, splitting them into separate X, Y and Z components
+//============================================================================================================
+
+inline void Load3 (const float* f, Float4& x, Float4& y, Float4& z)
+{
+	Float4 a = _mm_loadu_ps(f);		// x0 y0 z0 x1
+	Float4 b = _mm_loadu_ps(f + 4);	// y1 z1 x2 y2
+	Float4 c = _mm_loadu_ps(f + 8);	// z2 x3 y3 z3
+
+	x = _mm_shuffle_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3,3,0,0)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(1,1,2,2)), _MM_SHUFFLE(2,0,2,0));
+	y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0,0,1,1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2,2,3,3)), _MM_SHUFFLE(2,0,2,0));
+	z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1,1,2,2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3,3,0,0)), _MM_SHUFFLE(2,0,2,0));
+}
+
+//============================================================================================================
+// Interleaves separate X, Y and Z components, storing them as 4 XYZ triplets
+//============================================================================================================
+
+inline void Store3 (float* f, const Float4& x, const Float4& y, const Float4& z)
+{
+	_mm_storeu_ps(f,	 _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0,0,0,0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1,1,0,0)), _MM_SHUFFLE(2,0,2,0)));
+	_mm_storeu_ps(f + 4, _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1,1,1,1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2,2,2,2)), _MM_SHUFFLE(2,0,2,0)));
+	_mm_storeu_ps(f + 8, _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3,3,2,2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3,3,3,3)), _MM_SHUFFLE(2,0,2,0)));
+}
+
+//============================================================================================================
+// Loads 4 interleaved XYZW quadruplets, splitting them into separate X, Y, Z and W components
+//============================================================================================================
+
+inline void Load4 (const float* f, Float4& x, Float4& y, Float4& z, Float4& w)
+{
+	x = _mm_loadu_ps(f);
+	y = _mm_loadu_ps(f + 4);
+	z = _mm_loadu_ps(f + 8);
+	w = _mm_loadu_ps(f + 12);
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+}
+
+//============================================================================================================
+// Interleaves separate X, Y, Z and W components, storing them as 4 XYZW quadruplets
+//============================================================================================================
+
+inline void Store4 (float* f, Float4 x, Float4 y, Float4 z, Float4 w)
+{
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+	_mm_storeu_ps(f,	  x);
+	_mm_storeu_ps(f + 4,  y);
+	_mm_storeu_ps(f + 8,  z);
+	_mm_storeu_ps(f + 12, w);
+}
+
+#elif defined(R5_NEON)
+
+typedef float32x4_t Float4;
+
+inline Float4	Load	(const float* f)					{ return vld1q_f32(f);		}
+inline void		Store	(float* f, const Float4& v)			{ vst1q_f32(f, v);			}
+inline Float4	LoadA	(const float* f)					{ return vld1q_f32(f);		}
+inline void		StoreA	(float* f, const Float4& v)			{ vst1q_f32(f, v);			}
+inline Float4	Splat	(float f)							{ return vdupq_n_f32(f);	}
+inline Float4	Add		(const Float4& a, const Float4& b)	{ return vaddq_f32(a, b);	}
+inline Float4	Sub		(const Float4& a, const Float4& b)	{ return vsubq_f32(a, b);	}
+inline Float4	Mul		(const Float4& a, const Float4& b)	{ return vmulq_f32(a, b);	}
+
+//============================================================================================================
+// NEON is able to (de)interleave the components while loading and storing them
+//============================================================================================================
+
+inline void Load3 (const float* f, Float4& x, Float4& y, Float4& z)
+{
+	float32x4x3_t v = vld3q_f32(f);
+	x = v.val[0];
+	y = v.val[1];
+	z = v.val[2];
+}
+
+//============================================================================================================
+
+inline void Store3 (float* f, const Float4& x, const Float4& y, const Float4& z)
+{
+	float32x4x3_t v;
+	v.val[0] = x;
+	v.val[1] = y;
+	v.val[2] = z;
+	vst3q_f32(f, v);
+}
+
+//============================================================================================================
+
+inline void Load4 (const float* f, Float4& x, Float4& y, Float4& z, Float4& w)
+{
+	float32x4x4_t v = vld4q_f32(f);
+	x = v.val[0];
+	y = v.val[1];
+	z = v.val[2];
+	w = v.val[3];
+}
+
+//============================================================================================================
+
+inline void Store4 (float* f, Float4 x, Float4 y, Float4 z, Float4 w)
+{
+	float32x4x4_t v;
+	v.val[0] = x;
+	v.val[1] = y;
+	v.val[2] = z;
+	v.val[3] = w;
+	vst4q_f32(f, v);
+}
+
+#endif
+
+//============================================================================================================
+// Linear combination of matrix columns: c0 * w[0] + c1 * w[1] + c2 * w[2]
+//============================================================================================================
+
+inline Float4 Combine (const Float4& c0, const Float4& c1, const Float4& c2, const float* w)
+{
+	return Add(Add(Mul(c0, Splat(w[0])), Mul(c1, Splat(w[1]))), Mul(c2, Splat(w[2])));
+}
+
+//============================================================================================================
+// Linear combination of matrix columns: c0 * w[0] + c1 * w[1] + c2 * w[2] + c3 * w[3]
+//============================================================================================================
+
+inline Float4 Combine (const Float4& c0, const Float4& c1, const Float4& c2, const Float4& c3, const float* w)
+{
+	return Add(Combine(c0, c1, c2, w), Mul(c3, Splat(w[3])));
+}
+}; // namespace SIMD
+
+#endif
@@ -17,9 +17,16 @@
 	#include <stdlib.h>			// Windows has abs() defined in <math.h>
 #endif
 
+#if defined(R5_SSE)
+	#include <xmmintrin.h>		// SSE intrinsics
+#elif defined(R5_NEON)
+	#include <arm_neon.h>		// NEON intrinsics
+#endif
+
 namespace R5
 {
 	#include "Basic.h"			// Very basic math functions such as Clamp(), Wrap(), and NarrowPrecision()
+	#include "SIMD.h"			// Thin wrapper around SSE and NEON intrinsics used by the math classes
 	#include "Color3f.h"		// Color3f  -- 3 float color
 	#include "Color4f.h"		// Color4f  -- 4 float color
 	#include "Color4ub.h"		// Color4ub -- 4 byte color
@@ -32,6 +39,7 @@ namespace R5
 	#include "Matrix43.h"		// 4x3 matrix suitable for view and world transformation
 	#include "Matrix44.h"		// 4x4 matrix suitable for everything Matrix43 is meant for, plus projection
 	#include "Bounds.h"			// Bounding sphere + box for quick viewing frustum checks
+	#include "Batch.h"			// Functions operating on whole arrays of vectors, matrices and quaternions
 	#include "Frustum.h"		// Viewing frustum
 	#include "Functions.h"		// Various 3D math functions (Vector, Normalize, Cross, operators, etc)
 	#include "Interpolation.h"	// Functions for interpolation -- from linear to spline
@@ -41,6 +49,7 @@ namespace R5
 	#include "Shapes.h"			// Geometric shapes generated using math algorithms
 	#include "Intersect.h"		// Intersection test functions
 	#include "Rectangle.h"		// Basic templated rectangle
+	#include "MeshOptimizer.h"	// Vertex welding and triangle reordering for the GPU's vertex caches
 };
 
 #endif
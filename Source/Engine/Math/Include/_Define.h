@@ -15,4 +15,9 @@
 // Macros
 #define MAKEUINT(a, b)			((uint)a ^ ((uint)b << 16))
 #define DEG2RAD(Degrees)		(Degrees * 0.01745329252f)
-#define RAD2DEG(Rads)			(Rads * 57.29577951f)
\ No newline at end of file
+#define RAD2DEG(Rads)			(Rads * 57.29577951f)
+
+// The math library uses SIMD code if the instruction set was detected in R5_Defines.h
+#if defined(R5_SSE) || defined(R5_NEON)
+	#define R5_SIMD
+#endif
\ No newline at end of file
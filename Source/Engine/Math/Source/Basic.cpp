@@ -15,4 +15,63 @@ float R5::Float::Round (float val, const float& precision)
 
 	if (half > val) step = step - precision;
 	return (sign) ? step : -step;
-}
\ No newline at end of file
+}
+
+//============================================================================================================
+// Converts a 32-bit float into a 16-bit half precision float, rounding to nearest
+//============================================================================================================
+
+ushort R5::Float::ToHalf (float val)
+{
+	OrInt in (val);
+	uint sign = (in.i >> 16) & 0x8000;
+	uint bits = in.i & 0x7FFFFFFF;
+
+	// NaN stays NaN, infinity and values too large to be represented become infinity
+	if (bits >= 0x7F800000) return (ushort)(sign | (bits > 0x7F800000 ? 0x7E00 : 0x7C00));
+	if (bits >= 0x477FF000) return (ushort)(sign | 0x7C00);
+
+	// Values too small to be normalized become denormals (or zero)
+	if (bits < 0x38800000)
+	{
+		if (bits < 0x33000000) return (ushort)sign;
+		uint mantissa = (bits & 0x007FFFFF) | 0x00800000;
+		uint shift = 126 - (bits >> 23);
+		return (ushort)(sign | ((mantissa + (1 << (shift - 1))) >> shift));
+	}
+
+	// Re-bias the exponent and round the mantissa
+	return (ushort)(sign | ((bits - 0x38000000 + 0x00000FFF + ((bits >> 13) & 1)) >> 13));
+}
+
+//============================================================================================================
+// Converts a 16-bit half precision float back into a 32-bit float
+//============================================================================================================
+
+float R5::Float::FromHalf (ushort val)
+{
+	uint sign		= (uint)(val & 0x8000) << 16;
+	uint exponent	= (val >> 10) & 0x1F;
+	uint mantissa	= val & 0x03FF;
+
+	if (exponent == 0x1F)
+	{
+		// Infinity or NaN
+		exponent = 0xFF;
+	}
+	else if (exponent != 0)
+	{
+		// Normalized value
+		exponent += 112;
+	}
+	else if (mantissa != 0)
+	{
+		// Denormal -- normalize it
+		exponent = 113;
+		while ((mantissa & 0x0400) == 0) { mantissa <<= 1; --exponent; }
+		mantissa &= 0x03FF;
+	}
+
+	OrInt out ((int32)(sign | (exponent << 23) | (mantissa << 13)));
+	return out.f;
+}
@@ -0,0 +1,338 @@
+#include "../Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Copies the specified vectors
+//============================================================================================================
+
+Batch::Vector3fSoA& Batch::Vector3fSoA::operator = (const Vector3fSoA& v)
+{
+	if (this != &v)
+	{
+		Resize(v.mSize);
+
+		if (mSize != 0)
+		{
+			memcpy(mX, v.mX, sizeof(float) * mSize);
+			memcpy(mY, v.mY, sizeof(float) * mSize);
+			memcpy(mZ, v.mZ, sizeof(float) * mSize);
+		}
+	}
+	return *this;
+}
+
+//============================================================================================================
+// Resizes the container, reusing the allocated memory if it's large enough
+//============================================================================================================
+
+void Batch::Vector3fSoA::Resize (uint size)
+{
+	if (size > mAllocated)
+	{
+		if (mBuffer != 0) delete [] mBuffer;
+
+		// Every component array is padded to a multiple of 4, with 3 extra floats to align the first one
+		uint padded = (size + 3) & ~3;
+		mBuffer		= new float[padded * 3 + 3];
+		mAllocated	= padded;
+		mX			= (float*)(((size_t)mBuffer + 15) & ~(size_t)15);
+		mY			= mX + padded;
+		mZ			= mY + padded;
+	}
+	mSize = size;
+}
+
+//============================================================================================================
+// Releases the allocated memory
+//============================================================================================================
+
+void Batch::Vector3fSoA::Release()
+{
+	if (mBuffer != 0) delete [] mBuffer;
+	mBuffer		= 0;
+	mX			= 0;
+	mY			= 0;
+	mZ			= 0;
+	mSize		= 0;
+	mAllocated	= 0;
+}
+
+//============================================================================================================
+// Transforms the vertices by the specified matrix
+//============================================================================================================
+
+void Batch::Transform (const Matrix43& mat, const Vector3f* in, Vector3f* out, uint count)
+{
+	uint i = 0;
+
+#ifdef R5_SIMD
+	SIMD::Float4 m0 (SIMD::Splat(mat[0])), m4 (SIMD::Splat(mat[4])), m8  (SIMD::Splat(mat[8])),  m12 (SIMD::Splat(mat[12]));
+	SIMD::Float4 m1 (SIMD::Splat(mat[1])), m5 (SIMD::Splat(mat[5])), m9  (SIMD::Splat(mat[9])),  m13 (SIMD::Splat(mat[13]));
+	SIMD::Float4 m2 (SIMD::Splat(mat[2])), m6 (SIMD::Splat(mat[6])), m10 (SIMD::Splat(mat[10])), m14 (SIMD::Splat(mat[14]));
+	SIMD::Float4 x, y, z;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		SIMD::Load3(&in[i].x, x, y, z);
+
+		SIMD::Store3(&out[i].x,
+			SIMD::Add(SIMD::Add(SIMD::Add(SIMD::Mul(x, m0), SIMD::Mul(y, m4)), SIMD::Mul(z, m8)),  m12),
+			SIMD::Add(SIMD::Add(SIMD::Add(SIMD::Mul(x, m1), SIMD::Mul(y, m5)), SIMD::Mul(z, m9)),  m13),
+			SIMD::Add(SIMD::Add(SIMD::Add(SIMD::Mul(x, m2), SIMD::Mul(y, m6)), SIMD::Mul(z, m10)), m14));
+	}
+#endif
+
+	for (; i < count; ++i) out[i] = in[i] * mat;
+}
+
+//============================================================================================================
+// Transforms the vectors stored as separate components. The vectors before the first 16-byte boundary are
+// transformed one at a time, as are the ones past the last multiple of 4.
+//============================================================================================================
+
+void Batch::Transform (const Matrix43& mat, const Vector3fSoA& in, Vector3fSoA& out, uint first, uint count)
+{
+	uint i = first, last = first + count;
+
+#ifdef R5_SIMD
+	for (; i < last && (i & 3) != 0; ++i) out.Set(i, in.Get(i) * mat);
+
+	const float *ix = in.GetX(), *iy = in.GetY(), *iz = in.GetZ();
+	float *ox = out.GetX(), *oy = out.GetY(), *oz = out.GetZ();
+
+	SIMD::Float4 m0 (SIMD::Splat(mat[0])), m4 (SIMD::Splat(mat[4])), m8  (SIMD::Splat(mat[8])),  m12 (SIMD::Splat(mat[12]));
+	SIMD::Float4 m1 (SIMD::Splat(mat[1])), m5 (SIMD::Splat(mat[5])), m9  (SIMD::Splat(mat[9])),  m13 (SIMD::Splat(mat[13]));
+	SIMD::Float4 m2 (SIMD::Splat(mat[2])), m6 (SIMD::Splat(mat[6])), m10 (SIMD::Splat(mat[10])), m14 (SIMD::Splat(mat[14]));
+	SIMD::Float4 x, y, z;
+
+	for (; i + 4 <= last; i += 4)
+	{
+		x = SIMD::LoadA(ix + i);
+		y = SIMD::LoadA(iy + i);
+		z = SIMD::LoadA(iz + i);
+
+		SIMD::StoreA(ox + i, SIMD::Add(SIMD::Add(SIMD::Add(SIMD::Mul(x, m0), SIMD::Mul(y, m4)), SIMD::Mul(z, m8)),  m12));
+		SIMD::StoreA(oy + i, SIMD::Add(SIMD::Add(SIMD::Add(SIMD::Mul(x, m1), SIMD::Mul(y, m5)), SIMD::Mul(z, m9)),  m13));
+		SIMD::StoreA(oz + i, SIMD::Add(SIMD::Add(SIMD::Add(SIMD::Mul(x, m2), SIMD::Mul(y, m6)), SIMD::Mul(z, m10)), m14));
+	}
+#endif
+
+	for (; i < last; ++i) out.Set(i, in.Get(i) * mat);
+}
+
+//============================================================================================================
+// Rotates the vertices by the specified matrix, ignoring its translation
+//============================================================================================================
+
+void Batch::Rotate (const Matrix43& mat, const Vector3f* in, Vector3f* out, uint count)
+{
+	uint i = 0;
+
+#ifdef R5_SIMD
+	SIMD::Float4 m0 (SIMD::Splat(mat[0])), m4 (SIMD::Splat(mat[4])), m8  (SIMD::Splat(mat[8]));
+	SIMD::Float4 m1 (SIMD::Splat(mat[1])), m5 (SIMD::Splat(mat[5])), m9  (SIMD::Splat(mat[9]));
+	SIMD::Float4 m2 (SIMD::Splat(mat[2])), m6 (SIMD::Splat(mat[6])), m10 (SIMD::Splat(mat[10]));
+	SIMD::Float4 x, y, z;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		SIMD::Load3(&in[i].x, x, y, z);
+
+		SIMD::Store3(&out[i].x,
+			SIMD::Add(SIMD::Add(SIMD::Mul(x, m0), SIMD::Mul(y, m4)), SIMD::Mul(z, m8)),
+			SIMD::Add(SIMD::Add(SIMD::Mul(x, m1), SIMD::Mul(y, m5)), SIMD::Mul(z, m9)),
+			SIMD::Add(SIMD::Add(SIMD::Mul(x, m2), SIMD::Mul(y, m6)), SIMD::Mul(z, m10)));
+	}
+#endif
+
+	for (; i < count; ++i) out[i] = in[i] % mat;
+}
+
+//============================================================================================================
+// Rotates the vectors stored as separate components, ignoring the matrix's translation
+//============================================================================================================
+
+void Batch::Rotate (const Matrix43& mat, const Vector3fSoA& in, Vector3fSoA& out, uint first, uint count)
+{
+	uint i = first, last = first + count;
+
+#ifdef R5_SIMD
+	for (; i < last && (i & 3) != 0; ++i) out.Set(i, in.Get(i) % mat);
+
+	const float *ix = in.GetX(), *iy = in.GetY(), *iz = in.GetZ();
+	float *ox = out.GetX(), *oy = out.GetY(), *oz = out.GetZ();
+
+	SIMD::Float4 m0 (SIMD::Splat(mat[0])), m4 (SIMD::Splat(mat[4])), m8  (SIMD::Splat(mat[8]));
+	SIMD::Float4 m1 (SIMD::Splat(mat[1])), m5 (SIMD::Splat(mat[5])), m9  (SIMD::Splat(mat[9]));
+	SIMD::Float4 m2 (SIMD::Splat(mat[2])), m6 (SIMD::Splat(mat[6])), m10 (SIMD::Splat(mat[10]));
+	SIMD::Float4 x, y, z;
+
+	for (; i + 4 <= last; i += 4)
+	{
+		x = SIMD::LoadA(ix + i);
+		y = SIMD::LoadA(iy + i);
+		z = SIMD::LoadA(iz + i);
+
+		SIMD::StoreA(ox + i, SIMD::Add(SIMD::Add(SIMD::Mul(x, m0), SIMD::Mul(y, m4)), SIMD::Mul(z, m8)));
+		SIMD::StoreA(oy + i, SIMD::Add(SIMD::Add(SIMD::Mul(x, m1), SIMD::Mul(y, m5)), SIMD::Mul(z, m9)));
+		SIMD::StoreA(oz + i, SIMD::Add(SIMD::Add(SIMD::Mul(x, m2), SIMD::Mul(y, m6)), SIMD::Mul(z, m10)));
+	}
+#endif
+
+	for (; i < last; ++i) out.Set(i, in.Get(i) % mat);
+}
+
+//============================================================================================================
+// Multiplies every matrix by the specified one
+//============================================================================================================
+
+void Batch::Multiply (const Matrix43* in, const Matrix43& mat, Matrix43* out, uint count)
+{
+#ifdef R5_SIMD
+	SIMD::Float4 c0 (SIMD::Load(mat.mF));
+	SIMD::Float4 c1 (SIMD::Load(mat.mF + 4));
+	SIMD::Float4 c2 (SIMD::Load(mat.mF + 8));
+	SIMD::Float4 c3 (SIMD::Load(mat.mF + 12));
+
+	for (uint i = 0; i < count; ++i)
+	{
+		const float* f = in[i].mF;
+		float* o = out[i].mF;
+
+		SIMD::Store(o,		SIMD::Combine(c0, c1, c2, f));
+		SIMD::Store(o + 4,	SIMD::Combine(c0, c1, c2, f + 4));
+		SIMD::Store(o + 8,	SIMD::Combine(c0, c1, c2, f + 8));
+		SIMD::Store(o + 12, SIMD::Add(SIMD::Combine(c0, c1, c2, f + 12), c3));
+
+		o[3]  = 0.0f;
+		o[7]  = 0.0f;
+		o[11] = 0.0f;
+		o[15] = 1.0f;
+	}
+#else
+	for (uint i = 0; i < count; ++i) out[i] = in[i] * mat;
+#endif
+}
+
+//============================================================================================================
+// Multiplies pairs of matrices
+//============================================================================================================
+
+void Batch::Multiply (const Matrix43* a, const Matrix43* b, Matrix43* out, uint count)
+{
+#ifdef R5_SIMD
+	for (uint i = 0; i < count; ++i)
+	{
+		const float* m = b[i].mF;
+		SIMD::Float4 c0 (SIMD::Load(m));
+		SIMD::Float4 c1 (SIMD::Load(m + 4));
+		SIMD::Float4 c2 (SIMD::Load(m + 8));
+		SIMD::Float4 c3 (SIMD::Load(m + 12));
+
+		const float* f = a[i].mF;
+		float* o = out[i].mF;
+
+		SIMD::Store(o,		SIMD::Combine(c0, c1, c2, f));
+		SIMD::Store(o + 4,	SIMD::Combine(c0, c1, c2, f + 4));
+		SIMD::Store(o + 8,	SIMD::Combine(c0, c1, c2, f + 8));
+		SIMD::Store(o + 12, SIMD::Add(SIMD::Combine(c0, c1, c2, f + 12), c3));
+
+		o[3]  = 0.0f;
+		o[7]  = 0.0f;
+		o[11] = 0.0f;
+		o[15] = 1.0f;
+	}
+#else
+	for (uint i = 0; i < count; ++i) out[i] = a[i] * b[i];
+#endif
+}
+
+//============================================================================================================
+// Combines pairs of quaternions
+//============================================================================================================
+
+void Batch::Combine (const Quaternion* a, const Quaternion* b, Quaternion* out, uint count)
+{
+	uint i = 0;
+
+#ifdef R5_SIMD
+	SIMD::Float4 ax, ay, az, aw, bx, by, bz, bw;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		SIMD::Load4(&a[i].x, ax, ay, az, aw);
+		SIMD::Load4(&b[i].x, bx, by, bz, bw);
+
+		SIMD::Store4(&out[i].x,
+			SIMD::Sub(SIMD::Add(SIMD::Add(SIMD::Mul(aw, bx), SIMD::Mul(ax, bw)), SIMD::Mul(ay, bz)), SIMD::Mul(az, by)),
+			SIMD::Add(SIMD::Add(SIMD::Sub(SIMD::Mul(aw, by), SIMD::Mul(ax, bz)), SIMD::Mul(ay, bw)), SIMD::Mul(az, bx)),
+			SIMD::Add(SIMD::Sub(SIMD::Add(SIMD::Mul(aw, bz), SIMD::Mul(ax, by)), SIMD::Mul(ay, bx)), SIMD::Mul(az, bw)),
+			SIMD::Sub(SIMD::Sub(SIMD::Sub(SIMD::Mul(aw, bw), SIMD::Mul(ax, bx)), SIMD::Mul(ay, by)), SIMD::Mul(az, bz)));
+	}
+#endif
+
+	for (; i < count; ++i) out[i].Combine(a[i], b[i]);
+}
+
+//============================================================================================================
+// Spherical linear interpolation of quaternion pairs. The dot products and the final blending are done
+// 4 pairs at a time, while the trigonometric functions remain scalar. Pairs that are close enough to be
+// linearly interpolated blend using (1 - factor) and factor, so they can differ from the scalar version
+// by a rounding error.
+//============================================================================================================
+
+void Batch::Slerp (const Quaternion* from, const Quaternion* to, float factor, Quaternion* out, uint count)
+{
+	uint i = 0;
+
+#ifdef R5_SIMD
+	SIMD::Float4 fx, fy, fz, fw, tx, ty, tz, tw, f0, f1;
+	float dot[4], first[4], second[4];
+
+	for (; i + 4 <= count; i += 4)
+	{
+		SIMD::Load4(&from[i].x, fx, fy, fz, fw);
+		SIMD::Load4(&to[i].x, tx, ty, tz, tw);
+
+		SIMD::Store(dot, SIMD::Add(SIMD::Add(SIMD::Add(SIMD::Mul(fx, tx), SIMD::Mul(fy, ty)),
+			SIMD::Mul(fz, tz)), SIMD::Mul(fw, tw)));
+
+		for (uint b = 0; b < 4; ++b)
+		{
+			float d = Float::Clamp(dot[b], -1.0f, 1.0f), sign = 1.0f;
+
+			// Choose the shortest path
+			if (d < 0.0f)
+			{
+				d = -d;
+				sign = -1.0f;
+			}
+
+			// If the quaternions are too close together, LERP
+			if (d > FLOAT_INV_TOLERANCE)
+			{
+				first[b]  = 1.0f - factor;
+				second[b] = factor;
+			}
+			else
+			{
+				float theta  = Float::Acos(d);
+				float sinInv = 1.0f / Float::Sin(theta);
+				first[b]  = Float::Sin((1.0f - factor) * theta) * sinInv;
+				second[b] = sign * Float::Sin(factor * theta) * sinInv;
+			}
+		}
+
+		f0 = SIMD::Load(first);
+		f1 = SIMD::Load(second);
+
+		SIMD::Store4(&out[i].x,
+			SIMD::Add(SIMD::Mul(f0, fx), SIMD::Mul(f1, tx)),
+			SIMD::Add(SIMD::Mul(f0, fy), SIMD::Mul(f1, ty)),
+			SIMD::Add(SIMD::Mul(f0, fz), SIMD::Mul(f1, tz)),
+			SIMD::Add(SIMD::Mul(f0, fw), SIMD::Mul(f1, tw)));
+	}
+#endif
+
+	for (; i < count; ++i) out[i] = Interpolation::Slerp(from[i], to[i], factor);
+}
@@ -85,37 +85,15 @@ void Bounds::Transform (const Vector3f& pos, const Quaternion& rot, const Vector
 		}
 		else
 		{
-			Vector3f dir0 ( (mMax - mMin) * 0.5f);		// Top-right
-			Vector3f dir1 ( dir0.x, dir0.y, -dir0.z);	// Bottom-right
-			Vector3f dir2 (-dir0.x, dir0.y,  dir0.z);	// Top-left
-			Vector3f dir3 (-dir0.x, dir0.y, -dir0.z);	// Bottom-left
-
-			dir0 *= rot;
-			dir1 *= rot;
-			dir2 *= rot;
-			dir3 *= rot;
-
-			dir0 *= scale;
-			dir1 *= scale;
-			dir2 *= scale;
-			dir3 *= scale;
-
-			Clear();
-
-			mCenter  = (mMax + mMin) * 0.5f;
-			mCenter *= rot;
-			mCenter *= scale;
-			mCenter += pos;
-
-			Include(mCenter + dir0);
-			Include(mCenter + dir1);
-			Include(mCenter + dir2);
-			Include(mCenter + dir3);
-
-			Include(mCenter - dir0);
-			Include(mCenter - dir1);
-			Include(mCenter - dir2);
-			Include(mCenter - dir3);
+			// Scale is applied after the rotation, so it scales the rows of the rotation matrix
+			Matrix43 mat (rot);
+
+			mat[0] *= scale.x;	mat[4] *= scale.x;	mat[8]  *= scale.x;
+			mat[1] *= scale.y;	mat[5] *= scale.y;	mat[9]  *= scale.y;
+			mat[2] *= scale.z;	mat[6] *= scale.z;	mat[10] *= scale.z;
+			mat.Translate(pos);
+
+			Transform(mat);
 		}
 	}
 }
@@ -125,32 +103,34 @@ void Bounds::Transform (const Vector3f& pos, const Quaternion& rot, const Vector
 //============================================================================================================
 
 void Bounds::Transform (const Quaternion& rot)
+{
+	if (mIsValid) Transform(Matrix43(rot));
+}
+
+//============================================================================================================
+// Transform the bounding volume by the specified matrix. Rather than transforming all 8 corners, only the
+// center gets transformed. The new extents along each axis are the sum of the old extents scaled by the
+// absolute values of the matrix's corresponding row, which gives the exact same box.
+//============================================================================================================
+// 36 arithmetic operations
+//============================================================================================================
+
+void Bounds::Transform (const Matrix43& mat)
 {
 	if (mIsValid)
 	{
-		Vector3f dir0 ( (mMax - mMin) * 0.5f);		// Top-right
-		Vector3f dir1 ( dir0.x, dir0.y, -dir0.z);	// Bottom-right
-		Vector3f dir2 (-dir0.x, dir0.y,  dir0.z);	// Top-left
-		Vector3f dir3 (-dir0.x, dir0.y, -dir0.z);	// Bottom-left
-
-		dir0 *= rot;
-		dir1 *= rot;
-		dir2 *= rot;
-		dir3 *= rot;
-
-		Clear();
-
-		mCenter = (mMax + mMin) * 0.5f;
-		mCenter *= rot;
-
-		Include(mCenter + dir0);
-		Include(mCenter + dir1);
-		Include(mCenter + dir2);
-		Include(mCenter + dir3);
-
-		Include(mCenter - dir0);
-		Include(mCenter - dir1);
-		Include(mCenter - dir2);
-		Include(mCenter - dir3);
+		Vector3f center ((mMax + mMin) * 0.5f);
+		Vector3f extents ((mMax - mMin) * 0.5f);
+
+		center *= mat;
+
+		Vector3f offset (
+			extents.x * Float::Abs(mat[0]) + extents.y * Float::Abs(mat[4]) + extents.z * Float::Abs(mat[8]),
+			extents.x * Float::Abs(mat[1]) + extents.y * Float::Abs(mat[5]) + extents.z * Float::Abs(mat[9]),
+			extents.x * Float::Abs(mat[2]) + extents.y * Float::Abs(mat[6]) + extents.z * Float::Abs(mat[10]));
+
+		mMin = center - offset;
+		mMax = center + offset;
+		mIsDirty = true;
 	}
 }
\ No newline at end of file
@@ -64,6 +64,26 @@ void Matrix43::operator =(const Quaternion& q)
 void Matrix43::operator *= (const Matrix43& mat)
 {
 	const float* f = mat.mF;
+
+#ifdef R5_SIMD
+	SIMD::Float4 c0 (SIMD::Load(f));
+	SIMD::Float4 c1 (SIMD::Load(f + 4));
+	SIMD::Float4 c2 (SIMD::Load(f + 8));
+	SIMD::Float4 c3 (SIMD::Load(f + 12));
+
+	// The bottom row is left untouched, just like in the scalar version below
+	float w0 = mF[3], w1 = mF[7], w2 = mF[11], w3 = mF[15];
+
+	SIMD::Store(mF,		 SIMD::Combine(c0, c1, c2, mF));
+	SIMD::Store(mF + 4,  SIMD::Combine(c0, c1, c2, mF + 4));
+	SIMD::Store(mF + 8,  SIMD::Combine(c0, c1, c2, mF + 8));
+	SIMD::Store(mF + 12, SIMD::Add(SIMD::Combine(c0, c1, c2, mF + 12), c3));
+
+	mF[3]  = w0;
+	mF[7]  = w1;
+	mF[11] = w2;
+	mF[15] = w3;
+#else
 	float a, b, c;
 
 	a  = f[0] * mF[0]  + f[4] * mF[1]  + f[8]  * mF[2];
@@ -97,6 +117,7 @@ void Matrix43::operator *= (const Matrix43& mat)
 	mF[12] = a;
 	mF[13] = b;
 	mF[14] = c;
+#endif
 }
 
 //============================================================================================================
@@ -109,6 +130,23 @@ Matrix43 Matrix43::operator * (const Matrix43& mat) const
 	Matrix43 out;
 	const float* f = mat.mF;
 
+#ifdef R5_SIMD
+	SIMD::Float4 c0 (SIMD::Load(f));
+	SIMD::Float4 c1 (SIMD::Load(f + 4));
+	SIMD::Float4 c2 (SIMD::Load(f + 8));
+	SIMD::Float4 c3 (SIMD::Load(f + 12));
+
+	SIMD::Store(out.mF,		 SIMD::Combine(c0, c1, c2, mF));
+	SIMD::Store(out.mF + 4,  SIMD::Combine(c0, c1, c2, mF + 4));
+	SIMD::Store(out.mF + 8,  SIMD::Combine(c0, c1, c2, mF + 8));
+	SIMD::Store(out.mF + 12, SIMD::Add(SIMD::Combine(c0, c1, c2, mF + 12), c3));
+
+	// The bottom row keeps its identity values
+	out[3]  = 0.0f;
+	out[7]  = 0.0f;
+	out[11] = 0.0f;
+	out[15] = 1.0f;
+#else
 	out[0]  = f[0] * mF[0]  + f[4] * mF[1]  + f[8]  * mF[2];
 	out[1]  = f[1] * mF[0]  + f[5] * mF[1]  + f[9]  * mF[2];
 	out[2]  = f[2] * mF[0]  + f[6] * mF[1]  + f[10] * mF[2];
@@ -124,7 +162,7 @@ Matrix43 Matrix43::operator * (const Matrix43& mat) const
 	out[12] = f[0] * mF[12] + f[4] * mF[13] + f[8]  * mF[14] + f[12];
 	out[13] = f[1] * mF[12] + f[5] * mF[13] + f[9]  * mF[14] + f[13];
 	out[14] = f[2] * mF[12] + f[6] * mF[13] + f[10] * mF[14] + f[14];
-
+#endif
 	return out;
 }
 
@@ -138,6 +176,17 @@ Matrix44 Matrix43::operator * (const Matrix44& mat) const
 	Matrix44 out;
 	const float* f = mat.mF;
 
+#ifdef R5_SIMD
+	SIMD::Float4 c0 (SIMD::Load(f));
+	SIMD::Float4 c1 (SIMD::Load(f + 4));
+	SIMD::Float4 c2 (SIMD::Load(f + 8));
+	SIMD::Float4 c3 (SIMD::Load(f + 12));
+
+	SIMD::Store(out.mF,		 SIMD::Combine(c0, c1, c2, mF));
+	SIMD::Store(out.mF + 4,  SIMD::Combine(c0, c1, c2, mF + 4));
+	SIMD::Store(out.mF + 8,  SIMD::Combine(c0, c1, c2, mF + 8));
+	SIMD::Store(out.mF + 12, SIMD::Add(SIMD::Combine(c0, c1, c2, mF + 12), c3));
+#else
 	out[0]  = f[0] * mF[0]  + f[4] * mF[1]  + f[8]  * mF[2];
 	out[1]  = f[1] * mF[0]  + f[5] * mF[1]  + f[9]  * mF[2];
 	out[2]  = f[2] * mF[0]  + f[6] * mF[1]  + f[10] * mF[2];
@@ -157,7 +206,7 @@ Matrix44 Matrix43::operator * (const Matrix44& mat) const
 	out[13] = f[1] * mF[12] + f[5] * mF[13] + f[9]  * mF[14] + f[13];
 	out[14] = f[2] * mF[12] + f[6] * mF[13] + f[10] * mF[14] + f[14];
 	out[15] = f[3] * mF[12] + f[7] * mF[13] + f[11] * mF[14] + f[15];
-
+#endif
 	return out;
 }
 
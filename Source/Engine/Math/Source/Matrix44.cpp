@@ -44,6 +44,23 @@ Matrix44 Matrix44::operator * (const Matrix43& mat) const
 	Matrix44 out;
 	const float* f = mat.mF;
 
+#ifdef R5_SIMD
+	SIMD::Float4 c0 (SIMD::Load(f));
+	SIMD::Float4 c1 (SIMD::Load(f + 4));
+	SIMD::Float4 c2 (SIMD::Load(f + 8));
+	SIMD::Float4 c3 (SIMD::Load(f + 12));
+
+	SIMD::Store(out.mF,		 SIMD::Combine(c0, c1, c2, c3, mF));
+	SIMD::Store(out.mF + 4,  SIMD::Combine(c0, c1, c2, c3, mF + 4));
+	SIMD::Store(out.mF + 8,  SIMD::Combine(c0, c1, c2, c3, mF + 8));
+	SIMD::Store(out.mF + 12, SIMD::Combine(c0, c1, c2, c3, mF + 12));
+
+	// The bottom row is copied as-is, just like in the scalar version below
+	out[3]  = mF[3];
+	out[7]  = mF[7];
+	out[11] = mF[11];
+	out[15] = mF[15];
+#else
 	out[0]  = f[0] * mF[0]  + f[4] * mF[1]  + f[8]  * mF[2]  + f[12] * mF[3];
 	out[1]  = f[1] * mF[0]  + f[5] * mF[1]  + f[9]  * mF[2]  + f[13] * mF[3];
 	out[2]  = f[2] * mF[0]  + f[6] * mF[1]  + f[10] * mF[2]  + f[14] * mF[3];
@@ -63,7 +80,7 @@ Matrix44 Matrix44::operator * (const Matrix43& mat) const
 	out[13] = f[1] * mF[12] + f[5] * mF[13] + f[9]  * mF[14] + f[13] * mF[15];
 	out[14] = f[2] * mF[12] + f[6] * mF[13] + f[10] * mF[14] + f[14] * mF[15];
 	out[15] = mF[15];
-
+#endif
 	return out;
 }
 
@@ -75,6 +92,26 @@ Matrix44 Matrix44::operator * (const Matrix43& mat) const
 void Matrix44::operator *= (const Matrix43& mat)
 {
 	const float* f = mat.mF;
+
+#ifdef R5_SIMD
+	SIMD::Float4 c0 (SIMD::Load(f));
+	SIMD::Float4 c1 (SIMD::Load(f + 4));
+	SIMD::Float4 c2 (SIMD::Load(f + 8));
+	SIMD::Float4 c3 (SIMD::Load(f + 12));
+
+	// The bottom row is left untouched, just like in the scalar version below
+	float w0 = mF[3], w1 = mF[7], w2 = mF[11], w3 = mF[15];
+
+	SIMD::Store(mF,		 SIMD::Combine(c0, c1, c2, c3, mF));
+	SIMD::Store(mF + 4,  SIMD::Combine(c0, c1, c2, c3, mF + 4));
+	SIMD::Store(mF + 8,  SIMD::Combine(c0, c1, c2, c3, mF + 8));
+	SIMD::Store(mF + 12, SIMD::Combine(c0, c1, c2, c3, mF + 12));
+
+	mF[3]  = w0;
+	mF[7]  = w1;
+	mF[11] = w2;
+	mF[15] = w3;
+#else
 	float a, b, c;
 
 	a = f[0] * mF[0]  + f[4] * mF[1]  + f[8]  * mF[2]  + f[12] * mF[3];
@@ -108,6 +145,7 @@ void Matrix44::operator *= (const Matrix43& mat)
 	mF[12] = a;
 	mF[13] = b;
 	mF[14] = c;
+#endif
 }
 
 //============================================================================================================
@@ -118,6 +156,18 @@ void Matrix44::operator *= (const Matrix43& mat)
 void Matrix44::operator *= (const Matrix44& mat)
 {
 	const float* f = mat.mF;
+
+#ifdef R5_SIMD
+	SIMD::Float4 c0 (SIMD::Load(f));
+	SIMD::Float4 c1 (SIMD::Load(f + 4));
+	SIMD::Float4 c2 (SIMD::Load(f + 8));
+	SIMD::Float4 c3 (SIMD::Load(f + 12));
+
+	SIMD::Store(mF,		 SIMD::Combine(c0, c1, c2, c3, mF));
+	SIMD::Store(mF + 4,  SIMD::Combine(c0, c1, c2, c3, mF + 4));
+	SIMD::Store(mF + 8,  SIMD::Combine(c0, c1, c2, c3, mF + 8));
+	SIMD::Store(mF + 12, SIMD::Combine(c0, c1, c2, c3, mF + 12));
+#else
 	float a, b, c, d;
 
 	a = f[0] * mF[0]  + f[4] * mF[1]  + f[8]  * mF[2]  + f[12] * mF[3];
@@ -159,88 +209,62 @@ void Matrix44::operator *= (const Matrix44& mat)
 	mF[13] = b;
 	mF[14] = c;
 	mF[15] = d;
+#endif
 }
 
 //============================================================================================================
-// Gets a determinant of the matrix for inversion
-// 96 arithmetic operations
-//============================================================================================================
-
-float GetDeterminant (const float mat[16])
-{
-  return	mat[12] * mat[9]  * mat[6]  * mat[3] -
-			mat[8]  * mat[13] * mat[6]  * mat[3] -
-			mat[12] * mat[5]  * mat[10] * mat[3] +
-			mat[4]  * mat[13] * mat[10] * mat[3] +
-			mat[8]  * mat[5]  * mat[14] * mat[3] -
-			mat[4]  * mat[9]  * mat[14] * mat[3] -
-			mat[12] * mat[9]  * mat[2]  * mat[7] +
-			mat[8]  * mat[13] * mat[2]  * mat[7] +
-			mat[12] * mat[1]  * mat[10] * mat[7] -
-			mat[0]  * mat[13] * mat[10] * mat[7] -
-			mat[8]  * mat[1]  * mat[14] * mat[7] +
-			mat[0]  * mat[9]  * mat[14] * mat[7] +
-			mat[12] * mat[5]  * mat[2]  * mat[11] -
-			mat[4]  * mat[13] * mat[2]  * mat[11] -
-			mat[12] * mat[1]  * mat[6]  * mat[11] +
-			mat[0]  * mat[13] * mat[6]  * mat[11] +
-			mat[4]  * mat[1]  * mat[14] * mat[11] -
-			mat[0]  * mat[5]  * mat[14] * mat[11] -
-			mat[8]  * mat[5]  * mat[2]  * mat[15] +
-			mat[4]  * mat[9]  * mat[2]  * mat[15] +
-			mat[8]  * mat[1]  * mat[6]  * mat[15] -
-			mat[0]  * mat[9]  * mat[6]  * mat[15] -
-			mat[4]  * mat[1]  * mat[10] * mat[15] +
-			mat[0]  * mat[5]  * mat[10] * mat[15];
-}
-
-//============================================================================================================
-// Inverses a matrix
+// Inverses a matrix using the determinants of its 2x2 sub-matrices, each of which is shared by multiple
+// cofactors. Since the inverse of a transposed matrix is the transposed inverse, the same code works for
+// both column-major and row-major matrices.
 //============================================================================================================
-// 386 arithmetic operations, 1 memcopy (18 assignments)
+// 144 arithmetic operations, 1 memcopy (18 assignments)
 //============================================================================================================
 
 void Matrix44::Invert()
 {
-	float fDet = GetDeterminant(mF), out[16];
-    if (fDet == 0.0f) return;
-    fDet = 1.0f / fDet;
-
-    out[0]  =  (-mF[13] * mF[10] * mF[7 ] + mF[9 ] * mF[14] * mF[7 ] + mF[13] * mF[6 ] * mF[11] -
-				 mF[5 ] * mF[14] * mF[11] - mF[9 ] * mF[6 ] * mF[15] + mF[5 ] * mF[10] * mF[15]) * fDet;
-	out[1]  =  ( mF[13] * mF[10] * mF[3 ] - mF[9 ] * mF[14] * mF[3 ] - mF[13] * mF[2 ] * mF[11] +
-				 mF[1 ] * mF[14] * mF[11] + mF[9 ] * mF[2 ] * mF[15] - mF[1 ] * mF[10] * mF[15]) * fDet;
-	out[2]  =  (-mF[13] * mF[6 ] * mF[3 ] + mF[5 ] * mF[14] * mF[3 ] + mF[13] * mF[2 ] * mF[7 ] -
-				 mF[1 ] * mF[14] * mF[7 ] - mF[5 ] * mF[2 ] * mF[15] + mF[1 ] * mF[6 ] * mF[15]) * fDet;
-	out[3]  =  ( mF[9 ] * mF[6 ] * mF[3 ] - mF[5 ] * mF[10] * mF[3 ] - mF[9 ] * mF[2 ] * mF[7 ] +
-				 mF[1 ] * mF[10] * mF[7 ] + mF[5 ] * mF[2 ] * mF[11] - mF[1 ] * mF[6 ] * mF[11]) * fDet;
-
-    out[4]  =  ( mF[12] * mF[10] * mF[7 ] - mF[8 ] * mF[14] * mF[7 ] - mF[12] * mF[6 ] * mF[11] +
-				 mF[4 ] * mF[14] * mF[11] + mF[8 ] * mF[6 ] * mF[15] - mF[4 ] * mF[10] * mF[15]) * fDet;
-	out[5]  =  (-mF[12] * mF[10] * mF[3 ] + mF[8 ] * mF[14] * mF[3 ] + mF[12] * mF[2 ] * mF[11] -
-				 mF[0 ] * mF[14] * mF[11] - mF[8 ] * mF[2 ] * mF[15] + mF[0 ] * mF[10] * mF[15]) * fDet;
-	out[6]  =  ( mF[12] * mF[6 ] * mF[3 ] - mF[4 ] * mF[14] * mF[3 ] - mF[12] * mF[2 ] * mF[7 ] +
-				 mF[0 ] * mF[14] * mF[7 ] + mF[4 ] * mF[2 ] * mF[15] - mF[0 ] * mF[6 ] * mF[15]) * fDet;
-	out[7]  =  (-mF[8 ] * mF[6 ] * mF[3 ] + mF[4 ] * mF[10] * mF[3 ] + mF[8 ] * mF[2 ] * mF[7 ] -
-				 mF[0 ] * mF[10] * mF[7 ] - mF[4 ] * mF[2 ] * mF[11] + mF[0 ] * mF[6 ] * mF[11]) * fDet;
-
-    out[8]  =  (-mF[12] * mF[9 ] * mF[7 ] + mF[8 ] * mF[13] * mF[7 ] + mF[12] * mF[5 ] * mF[11] -
-				 mF[4 ] * mF[13] * mF[11] - mF[8 ] * mF[5 ] * mF[15] + mF[4 ] * mF[9 ] * mF[15]) * fDet;
-	out[9]  =  ( mF[12] * mF[9 ] * mF[3 ] - mF[8 ] * mF[13] * mF[3 ] - mF[12] * mF[1 ] * mF[11] +
-				 mF[0 ] * mF[13] * mF[11] + mF[8 ] * mF[1 ] * mF[15] - mF[0 ] * mF[9 ] * mF[15]) * fDet;
-	out[10] =  (-mF[12] * mF[5 ] * mF[3 ] + mF[4 ] * mF[13] * mF[3 ] + mF[12] * mF[1 ] * mF[7 ] -
-				 mF[0 ] * mF[13] * mF[7 ] - mF[4 ] * mF[1 ] * mF[15] + mF[0 ] * mF[5 ] * mF[15]) * fDet;
-    out[11] =  ( mF[8 ] * mF[5 ] * mF[3 ] - mF[4 ] * mF[9 ] * mF[3 ] - mF[8 ] * mF[1 ] * mF[7 ] +
-				 mF[0 ] * mF[9 ] * mF[7 ] + mF[4 ] * mF[1 ] * mF[11] - mF[0 ] * mF[5 ] * mF[11]) * fDet;
-
-    out[12] =  ( mF[12] * mF[9 ] * mF[6 ] - mF[8 ] * mF[13] * mF[6 ] - mF[12] * mF[5 ] * mF[10] +
-				 mF[4 ] * mF[13] * mF[10] + mF[8 ] * mF[5 ] * mF[14] - mF[4 ] * mF[9 ] * mF[14]) * fDet;
-    out[13] =  (-mF[12] * mF[9 ] * mF[2 ] + mF[8 ] * mF[13] * mF[2 ] + mF[12] * mF[1 ] * mF[10] -
-				 mF[0 ] * mF[13] * mF[10] - mF[8 ] * mF[1 ] * mF[14] + mF[0 ] * mF[9 ] * mF[14]) * fDet;
-    out[14] =  ( mF[12] * mF[5 ] * mF[2 ] - mF[4 ] * mF[13] * mF[2 ] - mF[12] * mF[1 ] * mF[6 ] +
-				 mF[0 ] * mF[13] * mF[6 ] + mF[4 ] * mF[1 ] * mF[14] - mF[0 ] * mF[5 ] * mF[14]) * fDet;
-    out[15] =  (-mF[8 ] * mF[5 ] * mF[2 ] + mF[4 ] * mF[9 ] * mF[2 ] + mF[8 ] * mF[1 ] * mF[6 ] -
-				 mF[0 ] * mF[9 ] * mF[6 ] - mF[4 ] * mF[1 ] * mF[10] + mF[0 ] * mF[5 ] * mF[10]) * fDet;
+	const float* a = mF;
+
+	// 2x2 determinants of the top two rows
+	float s0 = a[0] * a[5] - a[4] * a[1];
+	float s1 = a[0] * a[6] - a[4] * a[2];
+	float s2 = a[0] * a[7] - a[4] * a[3];
+	float s3 = a[1] * a[6] - a[5] * a[2];
+	float s4 = a[1] * a[7] - a[5] * a[3];
+	float s5 = a[2] * a[7] - a[6] * a[3];
+
+	// 2x2 determinants of the bottom two rows
+	float c5 = a[10] * a[15] - a[14] * a[11];
+	float c4 = a[9]  * a[15] - a[13] * a[11];
+	float c3 = a[9]  * a[14] - a[13] * a[10];
+	float c2 = a[8]  * a[15] - a[12] * a[11];
+	float c1 = a[8]  * a[14] - a[12] * a[10];
+	float c0 = a[8]  * a[13] - a[12] * a[9];
+
+	float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+	if (det == 0.0f) return;
+	det = 1.0f / det;
+
+	float out[16];
+
+	out[0]  = ( a[5]  * c5 - a[6]  * c4 + a[7]  * c3) * det;
+	out[1]  = (-a[1]  * c5 + a[2]  * c4 - a[3]  * c3) * det;
+	out[2]  = ( a[13] * s5 - a[14] * s4 + a[15] * s3) * det;
+	out[3]  = (-a[9]  * s5 + a[10] * s4 - a[11] * s3) * det;
+
+	out[4]  = (-a[4]  * c5 + a[6]  * c2 - a[7]  * c1) * det;
+	out[5]  = ( a[0]  * c5 - a[2]  * c2 + a[3]  * c1) * det;
+	out[6]  = (-a[12] * s5 + a[14] * s2 - a[15] * s1) * det;
+	out[7]  = ( a[8]  * s5 - a[10] * s2 + a[11] * s1) * det;
+
+	out[8]  = ( a[4]  * c4 - a[5]  * c2 + a[7]  * c0) * det;
+	out[9]  = (-a[0]  * c4 + a[1]  * c2 - a[3]  * c0) * det;
+	out[10] = ( a[12] * s4 - a[13] * s2 + a[15] * s0) * det;
+	out[11] = (-a[8]  * s4 + a[9]  * s2 - a[11] * s0) * det;
+
+	out[12] = (-a[4]  * c3 + a[5]  * c1 - a[6]  * c0) * det;
+	out[13] = ( a[0]  * c3 - a[1]  * c1 + a[2]  * c0) * det;
+	out[14] = (-a[12] * s3 + a[13] * s1 - a[14] * s0) * det;
+	out[15] = ( a[8]  * s3 - a[9]  * s1 + a[10] * s0) * det;
 
 	memcpy(mF, out, 64);
 }
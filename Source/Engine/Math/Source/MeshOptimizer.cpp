@@ -0,0 +1,389 @@
+#include "../Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Vertex scoring used by the triangle reordering, as described by Tom Forsyth in
+// "Linear-Speed Vertex Cache Optimisation".
+//============================================================================================================
+
+#define CACHE_DECAY_POWER	1.5f
+#define LAST_TRI_SCORE		0.75f
+#define VALENCE_BOOST_SCALE	2.0f
+#define VALENCE_BOOST_POWER	0.5f
+#define MAX_VALENCE			32
+
+namespace
+{
+struct ScoreTable
+{
+	float mCache[MeshOptimizer::CacheSize + 3];
+	float mValence[MAX_VALENCE];
+
+	void Init (uint cacheSize)
+	{
+		// Vertices used by the last triangle get a fixed score so the next triangle doesn't simply reuse them
+		for (uint i = 0; i < cacheSize; ++i)
+		{
+			mCache[i] = (i < 3) ? LAST_TRI_SCORE : powf(1.0f - (float)(i - 3) / (cacheSize - 3), CACHE_DECAY_POWER);
+		}
+
+		// Vertices with few triangles left get a boost so they can be discarded from the cache sooner
+		mValence[0] = 0.0f;
+		for (uint i = 1; i < MAX_VALENCE; ++i) mValence[i] = VALENCE_BOOST_SCALE * powf((float)i, -VALENCE_BOOST_POWER);
+	}
+
+	float Get (int cachePos, uint valence) const
+	{
+		if (valence == 0) return -1.0f;
+		float score = (cachePos < 0) ? 0.0f : mCache[cachePos];
+		return score + mValence[valence < MAX_VALENCE ? valence : MAX_VALENCE - 1];
+	}
+};
+
+//============================================================================================================
+// Hashes the specified number of bytes (FNV-1a)
+//============================================================================================================
+
+inline uint HashBytes (const byte* data, uint size)
+{
+	uint hash = 2166136261u;
+	for (uint i = 0; i < size; ++i) hash = (hash ^ data[i]) * 16777619u;
+	return hash;
+}
+} // anonymous namespace
+
+//============================================================================================================
+// Registers a vertex attribute stream
+//============================================================================================================
+
+void MeshOptimizer::_AddStream (const void* data, uint size, uint count)
+{
+	if (count == 0) return;
+	ASSERT(mStreams.IsEmpty() || mVertices == count, "All streams must have the same number of vertices");
+
+	Stream& s = mStreams.Expand();
+	s.mData = (const byte*)data;
+	s.mSize = size;
+	mVertices = count;
+}
+
+//============================================================================================================
+// Welds identical vertices and reorders the triangles and vertices
+//============================================================================================================
+
+uint MeshOptimizer::Optimize (Array<uint>& indices, Array<uint>& remap, bool weld) const
+{
+	remap.Clear();
+	if (mVertices == 0) return 0;
+
+	// Unindexed triangle lists reference every vertex in order
+	if (indices.IsEmpty())
+	{
+		uint* ptr = indices.ExpandTo(mVertices);
+		for (uint i = 0; i < mVertices; ++i) ptr[i] = i;
+	}
+
+	uint vertices = mVertices;
+	Array<uint> welded;
+
+	if (weld)
+	{
+		// Interleave all streams so that each vertex can be compared as a single block of memory
+		uint stride = 0;
+		FOREACH(i, mStreams) stride += mStreams[i].mSize;
+
+		Memory mem;
+		byte* ptr = mem.Resize(stride * mVertices);
+
+		for (uint v = 0; v < mVertices; ++v)
+		{
+			FOREACH(i, mStreams)
+			{
+				const Stream& s = mStreams[i];
+				memcpy(ptr, s.mData + s.mSize * v, s.mSize);
+				ptr += s.mSize;
+			}
+		}
+
+		vertices = Weld(mem.GetBuffer(), stride, mVertices, welded);
+		FOREACH(i, indices) indices[i] = welded[indices[i]];
+	}
+
+	ReorderTriangles(indices, vertices);
+
+	Array<uint> order;
+	uint count = ReorderVertices(indices, vertices, order);
+
+	// Combine both remap tables
+	uint* ptr = remap.ExpandTo(mVertices);
+
+	for (uint i = 0; i < mVertices; ++i)
+	{
+		ptr[i] = order[weld ? welded[i] : i];
+	}
+	return count;
+}
+
+//============================================================================================================
+// Calculates the vertex cache statistics of the specified triangle list
+//============================================================================================================
+
+void MeshOptimizer::GetStats (const Array<uint>& indices, Stats& stats, uint cacheSize)
+{
+	stats = Stats();
+	if (indices.IsEmpty()) return;
+
+	uint vertices = 0;
+	FOREACH(i, indices) if (vertices <= indices[i]) vertices = indices[i] + 1;
+
+	// Time stamp of when each vertex entered the cache
+	Array<uint> stamps;
+	stamps.ExpandTo(vertices, true);
+
+	Array<bool> used;
+	used.ExpandTo(vertices, true);
+
+	uint misses = 0;
+
+	FOREACH(i, indices)
+	{
+		uint index = indices[i];
+
+		if (!used[index])
+		{
+			used[index] = true;
+			++stats.mVertices;
+		}
+
+		// FIFO cache: the vertex is present if it was added within the last 'cacheSize' misses
+		if (stamps[index] == 0 || misses - stamps[index] + 1 > cacheSize)
+		{
+			stamps[index] = ++misses;
+		}
+	}
+
+	stats.mTriangles = indices.GetSize() / 3;
+	if (stats.mTriangles > 0) stats.mACMR = (float)misses / stats.mTriangles;
+	if (stats.mVertices  > 0) stats.mATVR = (float)misses / stats.mVertices;
+}
+
+//============================================================================================================
+// Builds a table mapping every vertex to a unique index, in order of first appearance
+//============================================================================================================
+
+uint MeshOptimizer::Weld (const byte* data, uint stride, uint vertices, Array<uint>& remap)
+{
+	uint* out = remap.ExpandTo(vertices);
+
+	// Open addressing hash table of vertices seen so far, at most half full
+	uint size = 16;
+	while (size < vertices * 2) size <<= 1;
+
+	Array<uint> table;
+	uint* slots = table.ExpandTo(size);
+	memset(slots, 0xFF, size * sizeof(uint));
+
+	uint unique = 0;
+
+	for (uint i = 0; i < vertices; ++i)
+	{
+		const byte* vertex = data + stride * i;
+		uint slot = HashBytes(vertex, stride) & (size - 1);
+
+		for (;;)
+		{
+			uint existing = slots[slot];
+
+			if (existing == Invalid)
+			{
+				slots[slot] = i;
+				out[i] = unique++;
+				break;
+			}
+
+			if (memcmp(data + stride * existing, vertex, stride) == 0)
+			{
+				out[i] = out[existing];
+				break;
+			}
+			slot = (slot + 1) & (size - 1);
+		}
+	}
+	return unique;
+}
+
+//============================================================================================================
+// Reorders triangles for the post-transform cache
+//============================================================================================================
+
+void MeshOptimizer::ReorderTriangles (Array<uint>& indices, uint vertices, uint cacheSize)
+{
+	uint triangles = indices.GetSize() / 3;
+	if (triangles < 2 || vertices == 0) return;
+	if (cacheSize > CacheSize) cacheSize = CacheSize;
+	if (cacheSize < 4) cacheSize = 4;
+
+	ScoreTable table;
+	table.Init(cacheSize);
+
+	// Count the number of triangles using each vertex
+	Array<uint> valence, offsets;
+	valence.ExpandTo(vertices, true);
+	offsets.ExpandTo(vertices + 1, true);
+
+	for (uint i = 0, imax = triangles * 3; i < imax; ++i) ++valence[indices[i]];
+	for (uint i = 0; i < vertices; ++i) offsets[i + 1] = offsets[i] + valence[i];
+
+	// List of triangles using each vertex. Triangles that have been added get moved past the vertex's valence.
+	Array<uint> adjacency, fill;
+	adjacency.ExpandTo(triangles * 3);
+	fill.CopyMemory(offsets);
+
+	for (uint t = 0; t < triangles; ++t)
+	{
+		adjacency[fill[indices[t * 3    ]]++] = t;
+		adjacency[fill[indices[t * 3 + 1]]++] = t;
+		adjacency[fill[indices[t * 3 + 2]]++] = t;
+	}
+
+	// Initial scores
+	Array<int> cachePos;
+	Array<float> vertexScore, triScore;
+	Array<bool> added;
+
+	cachePos.ExpandTo(vertices);
+	vertexScore.ExpandTo(vertices);
+	triScore.ExpandTo(triangles);
+	added.ExpandTo(triangles, true);
+
+	for (uint v = 0; v < vertices; ++v)
+	{
+		cachePos[v] = -1;
+		vertexScore[v] = table.Get(-1, valence[v]);
+	}
+
+	for (uint t = 0; t < triangles; ++t)
+	{
+		triScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+	}
+
+	uint cache[CacheSize + 3];
+	uint newCache[CacheSize + 3];
+	uint cacheCount = 0;
+	uint scan = 0;
+
+	Array<uint> output;
+	output.Reserve(triangles * 3);
+
+	for (uint remaining = triangles; remaining > 0; --remaining)
+	{
+		// Pick the best triangle among the ones touching vertices in the cache
+		uint best = Invalid;
+		float bestScore = -1.0f;
+
+		for (uint c = 0; c < cacheCount; ++c)
+		{
+			uint v = cache[c];
+
+			for (uint a = offsets[v], amax = offsets[v] + valence[v]; a < amax; ++a)
+			{
+				uint t = adjacency[a];
+
+				if (triScore[t] > bestScore)
+				{
+					bestScore = triScore[t];
+					best = t;
+				}
+			}
+		}
+
+		// Nothing in the cache is usable -- continue with the next triangle that hasn't been added yet
+		if (best == Invalid)
+		{
+			while (added[scan]) ++scan;
+			best = scan;
+		}
+
+		added[best] = true;
+		const uint* tri = indices.GetBuffer() + best * 3;
+
+		// Remove the triangle from its vertices' lists of remaining triangles
+		for (uint i = 0; i < 3; ++i)
+		{
+			uint v = tri[i];
+			output.Expand() = v;
+
+			uint* list = adjacency.GetBuffer() + offsets[v];
+			uint last = --valence[v];
+
+			for (uint a = 0; a <= last; ++a)
+			{
+				if (list[a] == best)
+				{
+					list[a] = list[last];
+					list[last] = best;
+					break;
+				}
+			}
+		}
+
+		// The triangle's vertices move to the front of the cache, pushing everything else back
+		uint newCount = 0;
+		newCache[newCount++] = tri[0];
+		newCache[newCount++] = tri[1];
+		newCache[newCount++] = tri[2];
+
+		for (uint c = 0; c < cacheCount; ++c)
+		{
+			uint v = cache[c];
+			if (v != tri[0] && v != tri[1] && v != tri[2]) newCache[newCount++] = v;
+		}
+
+		// Update the scores of all vertices that were in the cache, including the ones that got pushed out
+		for (uint c = 0; c < newCount; ++c)
+		{
+			uint v = newCache[c];
+			cachePos[v] = (c < cacheSize) ? (int)c : -1;
+			vertexScore[v] = table.Get(cachePos[v], valence[v]);
+		}
+
+		// Update the scores of all affected triangles
+		for (uint c = 0; c < newCount; ++c)
+		{
+			uint v = newCache[c];
+
+			for (uint a = offsets[v], amax = offsets[v] + valence[v]; a < amax; ++a)
+			{
+				uint t = adjacency[a];
+				triScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+			}
+		}
+
+		cacheCount = (newCount < cacheSize) ? newCount : cacheSize;
+		memcpy(cache, newCache, cacheCount * sizeof(uint));
+	}
+
+	// Any trailing indices of an incomplete triangle are kept as-is
+	for (uint i = triangles * 3, imax = indices.GetSize(); i < imax; ++i) output.Expand() = indices[i];
+	indices.CopyMemory(output);
+}
+
+//============================================================================================================
+// Renumbers vertices in the order they are first referenced
+//============================================================================================================
+
+uint MeshOptimizer::ReorderVertices (Array<uint>& indices, uint vertices, Array<uint>& remap)
+{
+	uint* ptr = remap.ExpandTo(vertices);
+	memset(ptr, 0xFF, vertices * sizeof(uint));
+
+	uint count = 0;
+
+	FOREACH(i, indices)
+	{
+		uint& index = indices[i];
+		if (ptr[index] == Invalid) ptr[index] = count++;
+		index = ptr[index];
+	}
+	return count;
+}
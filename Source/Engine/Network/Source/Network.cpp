@@ -500,6 +500,7 @@ void Network::_Update()
 
 	// It's always useful to know when new threads are created and destroyed
 	NORMAL_LOG( String("Worker thread %u has been created", threadId) );
+	Profiler::SetThreadName("Network");
 
 	fd_set read;
 	timeval t;
@@ -612,6 +613,7 @@ void Network::_Update()
 						else if (s.mAction == Socket::Action::Ready)
 						{
 							// Sockets that are ready to receive data do just that
+							R5_PROFILE("Network::Receive");
 							_Receive(s, buffer, mBufferSize, threadId);
 
 							// TCP packets are streamed, so they should not count as active for the sake of sleeping
@@ -641,6 +643,7 @@ void Network::_Update()
 	NORMAL_LOG( String("Worker thread %u finished", Thread::GetID()) );
 
 	// If this point is reached, then 'mTerminate' has been set to 'true'
+	Profiler::Detach();
 	Thread::Decrement(mThreadCount);
 }
 
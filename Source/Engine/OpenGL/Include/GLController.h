@@ -22,9 +22,11 @@ class GLController : public IGraphics
 	{
 		const IVBO*		mVbo;
 		const void*		mPtr;
+		uint			mType;
+		uint			mStride;
 		uint			mEnabled; // Disabled = 0, Client state is active = 1, attribute is active = 2
 
-		BufferEntry() : mVbo(0), mPtr((void*)(-1)), mEnabled(0) {}
+		BufferEntry() : mVbo(0), mPtr((void*)(-1)), mType(0), mStride(0), mEnabled(0) {}
 	};
 
 protected:
@@ -196,8 +198,10 @@ public:
 
 	// Draw bound vertices
 	virtual uint DrawVertices	( uint primitive, uint vertexCount );
-	virtual uint DrawIndices	( const IVBO* vbo, uint primitive, uint indexCount )		{ return _DrawIndices(vbo, 0, primitive, indexCount); }
-	virtual uint DrawIndices	( const ushort* indices, uint primitive, uint indexCount )	{ return _DrawIndices(0, indices, primitive, indexCount); }
+	virtual uint DrawIndices	( const IVBO* vbo, uint primitive, uint indexCount )		{ return _DrawIndices(vbo, 0, primitive, indexCount, DataType::UShort); }
+	virtual uint DrawIndices	( const ushort* indices, uint primitive, uint indexCount )	{ return _DrawIndices(0, indices, primitive, indexCount, DataType::UShort); }
+	virtual uint DrawIndices	( const IVBO* vbo, uint primitive, uint indexCount, uint dataType ) { return _DrawIndices(vbo, 0, primitive, indexCount, dataType); }
+	virtual uint DrawIndices	( const uint* indices, uint primitive, uint indexCount )	{ return _DrawIndices(0, indices, primitive, indexCount, DataType::UInt); }
 
 public:
 
@@ -205,7 +209,7 @@ public:
 	friend class GLTexture;
 
 	// Draw using an index array
-	uint _DrawIndices ( const IVBO* vbo, const ushort* ptr, uint primitive, uint indexCount );
+	uint _DrawIndices ( const IVBO* vbo, const void* ptr, uint primitive, uint indexCount, uint glType );
 
 	// Updates the currently active texture unit
 	void _ActivateTextureUnit();
@@ -21,8 +21,9 @@ protected:
 
 private:
 
-	// Only the GLGraphics manager should be able to create new fonts
+	// Only the graphics managers should be able to create new fonts
 	friend class GLGraphics;
+	friend class NullGraphics;
 	GLFont(const String& name, IGraphics* graphics);
 
 private:
@@ -25,7 +25,7 @@ protected:
 	Thread::IDType		mThread;
 	IVBO*				mSkyboxVBO;
 	IVBO*				mSkyboxIBO;
-	uint				mQuery;
+	VisibilityQueries	mQueries;
 
 	// Resources
 	PointerArray<GLVBO>	mVbos;
@@ -47,8 +47,11 @@ public:
 	// ID of the thread the graphics class was initialized in
 	Thread::IDType GetThreadID() const { return mThread; }
 
-	// Returns whether the specified point would be visible if rendered
-	virtual bool IsPointVisible (const Vector3f& v);
+	// Asynchronous visibility tests, exposed so that their latency can be adjusted
+	VisibilityQueries& GetVisibilityQueries() { return mQueries; }
+
+	// Returns the last known visibility of the specified point, and tests it again
+	virtual bool IsPointVisible (uint id, const Vector3f& v);
 
 	// Reads the buffer's color at the specified pixel
 	virtual Color4f ReadColor (const Vector2i& pos);
@@ -78,6 +81,9 @@ public:
 	// Draws a pre-defined drawable object such as a skybox or a full-screen quad
 	virtual uint Draw (uint drawable);
 
+	// Visibility tests are issued against the active target's depth buffer before it gets changed
+	virtual void SetActiveRenderTarget (const IRenderTarget* tar);
+
 	// Direct access to managed resource arrays
 	virtual Techniques&	GetAllTechniques()	{ return mTechs;		}
 	virtual Materials&	GetAllMaterials()	{ return mMaterials;	}
@@ -105,4 +111,12 @@ public:
 	// Serialization
 	virtual bool SerializeFrom (const TreeNode& root, bool forceUpdate = false);
 	virtual bool SerializeTo (TreeNode& root) const;
+
+private:
+
+	// Issues all visibility tests requested since the last time this function was called
+	void _IssueQueries();
+
+	// Collects the results of visibility tests issued a few frames ago
+	void _CollectQueries();
 };
\ No newline at end of file
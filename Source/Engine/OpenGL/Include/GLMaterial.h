@@ -35,6 +35,7 @@ private:
 
 	// Allow the OpenGL engine class to set the graphics
 	friend class GLGraphics;
+	friend class NullGraphics;
 	void _SetGraphics(IGraphics* graphics)	{ mGraphics = graphics; }
 
 public:
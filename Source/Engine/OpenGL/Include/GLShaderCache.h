@@ -0,0 +1,46 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Cache of preprocessed shader variations, kept in memory and saved to a file so that the preprocessor
+// doesn't have to run again the next time the application starts. Entries are keyed by a 64-bit hash of
+// the shader's source code, the variation's flags, the OpenGL version and the cache's format version.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class GLShaderCache
+{
+public:
+
+	typedef unsigned long long Key;
+
+	// Calculates the key of the specified shader variation
+	static Key GetKey (const String& full, const String& variation, const Flags& flags);
+
+	// Retrieves the preprocessed variation with the specified key, if it has been cached
+	static bool Get (Key key, String& code, Flags& final);
+
+	// Adds a newly preprocessed variation to the cache
+	static void Set (Key key, const String& code, const Flags& final);
+
+	// File the cache is loaded from and saved to. An empty filename keeps the cache in memory only.
+	static void SetFilename (const String& filename);
+	static const String& GetFilename();
+
+	// Saves the cache to its file if anything was added since it was loaded
+	static bool Save();
+
+	// Removes all cached variations
+	static void Clear();
+
+	// Number of threads used to preprocess all variations of a shader as soon as its code changes.
+	// '0' only preprocesses variations as they get requested, on the calling thread.
+	static void SetThreads (uint count);
+	static uint GetThreads();
+
+	// Number of variations found in the cache and preprocessed from scratch so far
+	static uint GetHits();
+	static uint GetMisses();
+};
@@ -36,6 +36,9 @@ class GLSurfaceShader : public IShader
 	// Registered uniforms
 	Array<RegisteredUniform> mUniforms;
 
+	// Work executed by the preprocessing threads
+	struct PreprocessJob;
+
 private:
 
 	friend class GLGraphics;
@@ -59,6 +62,9 @@ private:
 	// Get a compiled variation of the shader
 	Flags GetVariation (String& out, const Flags& flags) const;
 
+	// Preprocesses all variations of the shader on multiple threads, filling the shader cache
+	void Preprocess() const;
+
 	// Gets or creates a shader program given the specified set of flags
 	GLShaderProgram* GetProgram (const Flags& flags);
 
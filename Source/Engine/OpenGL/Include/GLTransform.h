@@ -94,8 +94,10 @@ private:
 
 	// Allow the controller class to access private members for simplicity's sake
 	friend class GLController;
+	friend class NullGraphics;
 
 	bool		mInst;		// Whether instancing is enabled
+	bool		mHeadless;	// Matrices are only maintained on the CPU and never passed to OpenGL
 	bool		mIs2D;		// Overriding 2D projection mode
 	bool		mReset;		// Manual matrix reset, used by 2D mode
 	Vector2i	mSize;		// Viewport size
@@ -111,7 +113,10 @@ private:
 
 public:
 
-	GLTransform() : mInst(false), mIs2D(false), mReset(false) {}
+	GLTransform() : mInst(false), mHeadless(false), mIs2D(false), mReset(false) {}
+
+	// Headless transforms keep track of all matrices without making any OpenGL calls
+	void SetHeadless (bool val) { mHeadless = val; }
 
 	// Activates or deactivates 2D mode
 	void Set2DMode (bool active);
@@ -0,0 +1,381 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Headless graphics that never touches the videocard. All states, matrices and frame statistics are
+// maintained on the CPU exactly as GLGraphics would, and every state change and draw call can optionally
+// be recorded into a compact command log. Meant for measuring the CPU cost of a frame on machines
+// without a GPU, and for comparing the recorded commands between builds.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class NullGraphics : public IGraphics
+{
+public:
+
+	// Single entry in the command log
+	struct Command
+	{
+		enum
+		{
+			// State changes -- the value is the new state
+			Fog = 0,
+			DepthWrite,
+			DepthTest,
+			ColorWrite,
+			AlphaTest,
+			StencilTest,
+			ScissorTest,
+			Wireframe,
+			Lighting,
+			Blending,
+			Culling,
+			DepthFunction,
+			StencilFunction,
+			StencilOperation,
+			Viewport,			// Value is width in the upper 16 bits, height in the lower 16
+
+			// Bound resources -- the value is the resource's unique identifier, or 0 if none
+			RenderTarget,
+			Technique,
+			Material,
+			Shader,
+			Texture,			// Param is the texture unit
+			VBO,				// Param is the IVBO::Type
+
+			// Everything else
+			Matrices,			// Value is the number of matrix switches
+			Clear,				// Value is a combination of 1 (color), 2 (depth) and 4 (stencil)
+			Draw,				// Param is the primitive, value is the number of triangles
+			Drawable,			// Param is the drawable, value is the number of triangles
+			Query,				// Value is 1 if the simulated visibility test passed, 0 otherwise
+
+			Count,
+		};
+
+		ushort	mType;		// Command type from the enum above
+		ushort	mParam;		// Texture unit, primitive or drawable
+		uint	mValue;		// New state, resource identifier or triangle count
+	};
+
+	typedef Array<Command> Commands;
+
+	// Simulated visibility test: should return whether the point (in normalized device coordinates) is visible
+	typedef FastDelegate<bool (const Vector3f& pos)> OnQueryDelegate;
+
+private:
+
+	struct DelegateEntry
+	{
+		DelayedDelegate callback;
+		void* param;
+	};
+
+	typedef Array<DelegateEntry> Delegates;
+
+	// Simulated result of a visibility query
+	struct QueryResult
+	{
+		uint	mFrame;		// Frame the query was issued on
+		bool	mVisible;	// Whether the point passed the test
+	};
+
+	enum
+	{
+		TextureUnits = 8,	// Just like GLController, only the first 8 texture units are used
+		ShadowUnit	 = 7,	// Texture unit used by the shadow map
+	};
+
+protected:
+
+	DeviceInfo		mCaps;				// Made-up device capabilities
+	FrameStats		mStats;				// Current frame statistics
+	GLTransform		mTrans;				// Matrix transforms, kept in headless mode
+
+	bool			mIsValid;			// Whether the graphics have been initialized
+	bool			mRecord;			// Whether commands are being recorded
+	bool			mFog;				// Whether fog is on
+	bool			mDepthWrite;		// Whether writing to depth buffer happens
+	bool			mDepthTest;			// Whether the depth test is on
+	bool			mColorWrite;		// Whether writing to the color buffer happens
+	bool			mAlphaTest;			// Whether the alpha testing is on
+	bool			mStencilTest;		// Whether the stencil test is on
+	bool			mScissorTest;		// Whether the scissor test is on
+	bool			mWireframe;			// Whether the wireframe mode is currently on
+	bool			mMatIsDirty;		// Whether some parts of the material were altered since it was set
+	byte			mLighting;			// Whether the lighting is on
+	byte			mBlending;			// Active blending mode
+	byte			mCulling;			// Active culling mode
+
+	float			mAdt;				// Alpha testing threshold
+	float			mThickness;			// Point and line size when drawing those primitives
+	Vector2i		mSize;				// Screen size
+	Rect			mScissorRect;		// Scissor rectangle
+	Vector2f		mFogRange;			// Fog range
+	uint			mAf;				// Current anisotropy level
+	Color4f			mBackground;		// Current window background color
+	uint			mDepthFunc;			// Active depth function
+
+	const IRenderTarget*	mTarget;		// Active rendering target
+	const ITechnique*		mTechnique;		// Active rendering technique
+	const IMaterial*		mMaterial;		// Active material
+	const IShader*			mShader;		// Active shader
+	const ITexture*			mSkybox;		// Active skybox cubemap texture
+	const ITexture*			mShadowmap;		// Shadowmap texture, cached once it's retrieved
+	const IVBO*				mVBO[3];		// Active vertex buffer of each IVBO::Type
+
+	ITexture*				mNextTex[TextureUnits];		// Textures that will be bound prior to the next draw call
+	uint					mBoundTex[TextureUnits];	// Identifiers of textures that are currently bound
+	mutable Array<ILight>	mLu;						// Light units
+
+	VisibilityQueries		mQueries;		// Asynchronous visibility tests
+	Array<QueryResult>		mResults;		// Simulated results, indexed by query handles
+	OnQueryDelegate			mOnQuery;		// Simulated visibility test
+	uint					mQueryDelay;	// Number of frames it takes for results to become available
+	uint					mFrame;			// Number of frames started so far
+
+	// Resources
+	PointerArray<NullVBO>			mVbos;
+	PointerArray<NullRenderTarget>	mTargets;
+	Delegates						mDelegates;
+	Commands						mLog;
+	Techniques						mTechs;
+	Materials						mMaterials;
+	Textures						mTextures;
+	Textures						mTempTex;
+	Shaders							mShaders;
+	Fonts							mFonts;
+
+public:
+
+	NullGraphics();
+	virtual ~NullGraphics() { Release(); }
+
+	// Whether commands get recorded. The log is cleared at the beginning of every frame.
+	bool IsRecording() const		{ return mRecord; }
+	void SetRecording (bool val)	{ mRecord = val; }
+
+	// Commands recorded since the beginning of the frame
+	const Commands& GetCommands() const { return mLog; }
+
+	// Human-readable name of the specified command type
+	static const char* GetCommandName (uint type);
+
+	// Asynchronous visibility tests, exposed so that their latency can be adjusted
+	VisibilityQueries& GetVisibilityQueries() { return mQueries; }
+
+	// There is nothing on the screen, so without a simulated test points are never visible
+	void SetOnQuery (const OnQueryDelegate& fn) { mOnQuery = fn; }
+
+	// Number of frames it takes for the results to become available, simulating a busy videocard.
+	// Results that are not available by the time they get collected are skipped, same as with OpenGL.
+	uint GetQueryDelay() const			{ return mQueryDelay; }
+	void SetQueryDelay (uint frames)	{ mQueryDelay = frames; }
+
+private:
+
+	// Issues all visibility tests requested since the last time this function was called
+	void _IssueQueries();
+
+	// Collects the results of visibility tests issued a few frames ago
+	void _CollectQueries();
+
+	// Adds a new entry to the command log
+	void _Record (uint type, uint value, uint param = 0)
+	{
+		if (mRecord)
+		{
+			Command& cmd = mLog.Expand();
+			cmd.mType	= (ushort)type;
+			cmd.mParam	= (ushort)param;
+			cmd.mValue	= value;
+		}
+	}
+
+	// Counts the triangles and records the draw call
+	uint _Draw (uint primitive, uint count);
+
+public:
+
+	// Finish all draw operations
+	virtual void Flush() { PrepareToDraw(); }
+
+	// State control functions
+	virtual void SetFog				(bool val);
+	virtual void SetDepthWrite		(bool val);
+	virtual void SetDepthTest		(bool val);
+	virtual void SetColorWrite		(bool val);
+	virtual void SetAlphaTest		(bool val);
+	virtual void SetStencilTest		(bool val);
+	virtual void SetScissorTest		(bool val);
+	virtual void SetWireframe		(bool val);
+	virtual void SetLighting		(uint val);
+	virtual void SetBlending		(uint val);
+	virtual void SetCulling			(uint val);
+	virtual void SetAlphaCutoff		(float val);
+	virtual void SetThickness		(float val)					{ mThickness = Float::Clamp(val, 1.0f, 10.0f); }
+	virtual void SetDepthOffset		(uint val)					{ mTrans.SetDepthOffset(val); }
+	virtual void SetViewport		(const Vector2i& size);
+	virtual void SetScissorRect		(const Rect& rect)			{ mScissorRect = rect; }
+	virtual void SetFogRange		(const Vector2f& range)		{ mFogRange = range; }
+	virtual void SetBackgroundColor	(const Color4f& color)		{ mBackground = color; }
+	virtual void SetDefaultAF		(uint level)				{ mAf = level; }
+
+public:
+
+	// Statistics about the current frame
+	virtual const DeviceInfo&	GetDeviceInfo()			const	{ return mCaps;			}
+	virtual const FrameStats&	GetFrameStats()			const	{ return mStats;		}
+	virtual bool				GetFog()				const	{ return mFog;			}
+	virtual bool				GetDepthWrite()			const	{ return mDepthWrite;	}
+	virtual bool				GetDepthTest()			const	{ return mDepthTest;	}
+	virtual bool				GetAlphaTest()			const	{ return mAlphaTest;	}
+	virtual bool				GetStencilTest()		const	{ return mStencilTest;	}
+	virtual bool				GetScissorTest()		const	{ return mScissorTest;	}
+	virtual bool				GetWireframe()			const	{ return mWireframe;	}
+	virtual uint				GetLighting()			const	{ return mLighting;		}
+	virtual uint				GetBlending()			const	{ return mBlending;		}
+	virtual uint				GetCulling()			const	{ return mCulling;		}
+	virtual float				GetAlphaCutoff()		const	{ return mAdt;			}
+	virtual float				GetThickness()			const	{ return mThickness;	}
+	virtual uint				GetDepthOffset()		const	{ return mTrans.GetDepthOffset();	}
+	virtual uint				GetDefaultAF()			const	{ return mAf;			}
+	virtual const Vector2i&		GetViewport()			const	{ return mTarget == 0 ? mSize : mTarget->GetSize();	}
+	virtual const Rect&			GetScissorRect()		const	{ return mScissorRect;	}
+	virtual const Vector2f&		GetFogRange()			const	{ return mFogRange;		}
+	virtual const Color4f&		GetBackgroundColor()	const	{ return mBackground;	}
+
+	virtual const ITexture*		GetActiveSkybox()		const	{ return mSkybox;		}
+	virtual const ITechnique*	GetActiveTechnique()	const	{ return mTechnique;	}
+	virtual const IMaterial*	GetActiveMaterial()		const	{ return mMaterial;		}
+	virtual const IShader*		GetActiveShader()		const	{ return mShader;		}
+	virtual const Vector2i&		GetActiveViewport()		const	{ return (mTarget == 0) ? mSize : mTarget->GetSize(); }
+	virtual const IRenderTarget* GetActiveRenderTarget() const	{ return mTarget; }
+
+	// Access to lights
+	virtual const ILight& GetActiveLight (uint index) const;
+	virtual void SetActiveLight (uint index, const ILight* ptr);
+
+	// Camera orientation retrieval
+	virtual const Vector3f&		GetCameraPosition()		const	{ return mTrans.mView.pos;		}
+	virtual const Vector3f&		GetCameraDirection()	const	{ return mTrans.mView.dir;		}
+	virtual const Vector3f&		GetCameraUpVector()		const	{ return mTrans.mView.up;		}
+	virtual const Vector3f&		GetCameraRange()		const	{ return mTrans.mProj.range;	}
+	virtual const Bounds&		GetCameraNearBounds()	const	{ return mTrans.mCam;			}
+
+	// Matrix retrieval
+	virtual const Matrix43&		GetModelMatrix()			{ return mTrans.GetModelMatrix(); }
+	virtual const Matrix43&		GetViewMatrix()				{ return mTrans.GetViewMatrix(); }
+	virtual const Matrix44&		GetProjectionMatrix()		{ return mTrans.GetProjectionMatrix(); }
+	virtual const Matrix43&		GetModelViewMatrix()		{ return mTrans.GetModelViewMatrix(); }
+	virtual const Matrix44&		GetModelViewProjMatrix()	{ return mTrans.GetModelViewProjMatrix(); }
+	virtual const Matrix43&		GetInverseModelViewMatrix()	{ return mTrans.GetInverseModelViewMatrix(); }
+	virtual const Matrix44&		GetInverseProjMatrix()		{ return mTrans.GetInverseProjMatrix(); }
+	virtual const Matrix44&		GetInverseMVPMatrix()		{ return mTrans.GetInverseMVPMatrix(); }
+
+	// Model matrix manipulation
+	virtual void SetModelMatrix (const Matrix43& mat)		{ mTrans.OverrideModelMatrix(mat); }
+	virtual void ResetModelMatrix()							{ mTrans.CancelModelMatrixOverride(); }
+
+	// View matrix manipulation
+	virtual void SetViewMatrix (const Matrix43& mat)		{ mTrans.OverrideViewMatrix(mat); }
+	virtual void ResetViewMatrix()							{ mTrans.CancelViewMatrixOverride(); }
+
+	// Projection matrix manipulation
+	virtual void SetProjectionMatrix (const Matrix44& mat)	{ mTrans.OverrideProjectionMatrix(mat); }
+	virtual void ResetProjectionMatrix()					{ mTrans.CancelProjectionMatrixOverride(); }
+
+	// Convenience camera control functions. Range X = near, Y = far, Z = field of view (in degrees)
+	virtual void SetCameraOrientation		( const Vector3f& eye, const Vector3f& dir, const Vector3f& up );
+	virtual void SetCameraRange				( const Vector3f& range );
+
+	// Active object control
+	virtual void SetActiveRenderTarget		( const IRenderTarget* tar );
+	virtual void SetActiveTechnique			( const ITechnique* ptr, bool insideOut = false );
+	virtual bool SetActiveMaterial			( const IMaterial* ptr );
+	virtual bool SetActiveMaterial			( const ITexture* ptr );
+	virtual bool SetActiveShader			( const IShader* ptr );
+	virtual void SetActiveSkybox			( const ITexture* ptr ) { mSkybox = ptr; }
+	virtual void SetActiveColor				( const Color& c ) {}
+	virtual void SetScreenProjection		( bool screen ) { mTrans.Set2DMode(screen); }
+	virtual void SetActiveVBO				( const IVBO* vbo, uint type = IVBO::Type::Invalid );
+	virtual void SetActiveTexture			( uint textureUnit, const ITexture* ptr );
+	virtual void SetActiveDepthFunction		( uint condition );
+	virtual void SetActiveStencilFunction	( uint condition, uint val, uint mask ) { _Record(Command::StencilFunction, condition); }
+	virtual void SetActiveStencilOperation	( uint testFail, uint depthFail, uint pass ) { _Record(Command::StencilOperation, (testFail << 8) | (depthFail << 4) | pass); }
+	virtual void SetActiveVertexAttribute	( uint			attribute,
+											  const IVBO*	vbo,
+											  const void*	ptr,
+											  uint			dataType,
+											  uint			elements,
+											  uint			stride );
+
+	// Activate all matrices and bind all textures, preparing to draw
+	virtual void PrepareToDraw();
+
+	// Draw bound vertices
+	virtual uint DrawVertices	( uint primitive, uint vertexCount )						{ return _Draw(primitive, vertexCount); }
+	virtual uint DrawIndices	( const IVBO* vbo, uint primitive, uint indexCount )		{ SetActiveVBO(vbo, IVBO::Type::Index); return _Draw(primitive, indexCount); }
+	virtual uint DrawIndices	( const ushort* indices, uint primitive, uint indexCount )	{ return _Draw(primitive, indexCount); }
+	virtual uint DrawIndices	( const IVBO* vbo, uint primitive, uint indexCount, uint dataType ) { SetActiveVBO(vbo, IVBO::Type::Index); return _Draw(primitive, indexCount); }
+	virtual uint DrawIndices	( const uint* indices, uint primitive, uint indexCount )	{ return _Draw(primitive, indexCount); }
+
+public:
+
+	// Returns the last known visibility of the specified point, and tests it again
+	virtual bool IsPointVisible (uint id, const Vector3f& v);
+
+	// There is no buffer to read from
+	virtual Color4f ReadColor (const Vector2i& pos) { return mBackground; }
+
+	// Converts screen coordinates to world coordinates and vice versa. Depth is always at the far plane.
+	virtual Vector3f  ConvertTo3D (const Vector2i& pos, bool unproject = true);
+	virtual Vector2i  ConvertTo2D (const Vector3f& pos);
+
+	// Initialize/release the graphics manager
+	virtual bool Init (uint version = 200);
+	virtual void Release();
+
+	// Adds a delayed callback function that should be executed on the next frame (at BeginFrame)
+	virtual void ExecuteBeforeNextFrame(const DelayedDelegate& callback, void* param);
+
+	// Clear the screen or the off-screen target, rendering the skybox if necessary (pre-render)
+	virtual void Clear (bool color = true, bool depth = true, bool stencil = true);
+
+	// Pre/post-render
+	virtual void BeginFrame();
+	virtual void EndFrame();
+
+	// Draws a pre-defined drawable object such as a skybox or a full-screen quad
+	virtual uint Draw (uint drawable);
+
+	// Direct access to managed resource arrays
+	virtual Techniques&	GetAllTechniques()	{ return mTechs;		}
+	virtual Materials&	GetAllMaterials()	{ return mMaterials;	}
+	virtual Textures&	GetAllTextures()	{ return mTextures;		}
+	virtual Shaders&	GetAllShaders()		{ return mShaders;		}
+	virtual Fonts&		GetAllFonts()		{ return mFonts;		}
+
+	// Managed unnamed resources
+	virtual IVBO*			CreateVBO();
+	virtual ITexture*		CreateRenderTexture(const char* name = 0);
+	virtual IRenderTarget*	CreateRenderTarget();
+
+	// Resource removal
+	virtual void DeleteVBO			(const IVBO*			ptr);
+	virtual void DeleteTexture		(const ITexture*		ptr);
+	virtual void DeleteRenderTarget	(const IRenderTarget*	ptr);
+
+	// Managed named resources
+	virtual ITechnique*		GetTechnique	(const String& name, bool createIfMissing = true);
+	virtual IMaterial*		GetMaterial		(const String& name, bool createIfMissing = true);
+	virtual ITexture*		GetTexture		(const String& name, bool createIfMissing = true);
+	virtual IShader*		GetShader		(const String& name, bool createIfMissing = true);
+	virtual IFont*			GetFont			(const String& name, bool createIfMissing = true);
+
+	// Serialization
+	virtual bool SerializeFrom (const TreeNode& root, bool forceUpdate = false);
+	virtual bool SerializeTo (TreeNode& root) const;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Render target used by the headless graphics -- keeps track of attachments, but never draws anything
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class NullRenderTarget : public IRenderTarget
+{
+	struct TextureEntry
+	{
+		ITexture*	mTex;
+		uint		mFormat;
+
+		TextureEntry() : mTex(0), mFormat(ITexture::Format::Invalid) {}
+	};
+
+protected:
+
+	uint				mID;			// Unique identifier of the render target
+	Vector2i			mSize;			// Size of all attached textures
+	ITexture*			mDepthTex;		// Attached depth texture
+	ITexture*			mStencilTex;	// Attached stencil texture
+	Array<TextureEntry>	mColorTex;		// Attached color textures
+	uint				mMSAA;			// Requested multi-sampling level
+	bool				mUsesSkybox;	// Whether the skybox is drawn when the target is cleared
+
+private:
+
+	// Only the NullGraphics class should be able to create render targets
+	friend class NullGraphics;
+	NullRenderTarget (uint id) : mID(id), mDepthTex(0), mStencilTex(0), mMSAA(0), mUsesSkybox(true) {}
+
+	// Textures are sized as soon as they're attached, as there is no need to wait for the target to be activated
+	void _Reserve (ITexture* tex, uint format) const;
+
+public:
+
+	// Unique identifier of the render target
+	uint GetID() const { return mID; }
+
+	virtual void Release() { mDepthTex = 0; mStencilTex = 0; mColorTex.Clear(); }
+
+	virtual uint GetMaxColorAttachments()		const	{ return 4; }
+	virtual bool SupportsStencilAttachments()	const	{ return true; }
+
+	virtual const Vector2i& GetSize() const				{ return mSize; }
+	virtual bool SetSize (const Vector2i& size);
+
+	virtual uint GetMSAA (uint level) const				{ return mMSAA; }
+	virtual void SetMSAA (uint level)					{ mMSAA = level; }
+
+	virtual bool IsUsingSkybox() const					{ return mUsesSkybox; }
+	virtual void UseSkybox (bool val)					{ mUsesSkybox = val; }
+
+	virtual bool AttachColorTexture		(uint bufferIndex, ITexture* tex, uint format = ITexture::Format::RGB);
+	virtual bool AttachDepthTexture		(ITexture* tex);
+	virtual bool AttachStencilTexture	(ITexture* tex);
+
+	virtual const ITexture* GetColorTexture (uint bufferIndex) const { return (bufferIndex < mColorTex.GetSize()) ? mColorTex[bufferIndex].mTex : 0; }
+	virtual const ITexture* GetDepthTexture () const { return mDepthTex; }
+	virtual const ITexture* GetStencilTexture () const { return mStencilTex; }
+
+	virtual bool HasColor()		const;
+	virtual bool HasDepth()		const { return mDepthTex != 0; }
+	virtual bool HasStencil()	const { return mStencilTex != 0; }
+
+	// Nothing needs to be bound
+	virtual void Activate()		const {}
+	virtual void Deactivate()	const {}
+
+	// There is nothing to copy
+	virtual bool CopyTo (const IRenderTarget* destination, bool color = true, bool depth = true, bool stencil = true) const { return true; }
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Shader used by the headless graphics -- holds on to its code, but is never compiled
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class NullShader : public IShader
+{
+protected:
+
+	String mCode;
+
+private:
+
+	// Only the NullGraphics class should be able to create shaders
+	friend class NullGraphics;
+	NullShader (const String& name) { mName = name; }
+
+public:
+
+	// None of the shader's components are present as nothing is ever compiled
+	virtual bool GetFlag (uint val) const { return false; }
+
+	virtual void Clear()						{ mCode.Clear(); }
+	virtual void SetDirty()						{}
+	virtual void SetCode (const String& code)	{ mCode = code; }
+	virtual void GetCode (String& out) const	{ out = mCode; }
+
+	// Uniforms are accepted but not used
+	virtual bool SetUniform (const String& name, const Uniform& uniform) const { return true; }
+	virtual void RegisterUniform (const String& name, const SetUniformDelegate& fnct, uint group = Uniform::Group::SetWhenActivated) {}
+};
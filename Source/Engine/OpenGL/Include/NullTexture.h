@@ -0,0 +1,126 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Texture used by the headless graphics -- keeps track of the source and dimensions, but no pixels
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class NullTexture : public ITexture
+{
+protected:
+
+	String			mName;				// Every texture needs a name
+	String			mSource[6];			// Up to 6 source files
+	NullTexture*	mReplacement;		// Replacement texture that overrides this one
+	uint			mType;				// Texture type (ITexture::TwoDimensional, etc)
+	uint			mFormat;			// Texture format, such as ITexture::Format::RGB
+	uint			mRequestedFormat;	// Original requested format
+	Vector2i		mSize;				// Size of the texture
+	uint			mDepth;				// Depth of the texture
+	ulong			mSizeInMemory;		// Size the texture would be taking up in video memory
+	ulong			mTimestamp;			// Timestamp of the last time Activate() was called
+	uint			mWrapMode;			// Texture wrapping setting
+	uint			mCompareMode;		// Texture compare mode
+	uint			mFilter;			// Texture filtering setting
+	bool			mCheckForSource;	// Whether the texture should be checked to see if it has a valid source
+	bool			mSerializable;		// Whether the texture should be serialized on save
+	Thread::Lockable mLock;
+
+private:
+
+	// Only the NullGraphics manager should be able to create new textures
+	friend class NullGraphics;
+	NullTexture (const String& name);
+
+private:
+
+	// Tries to load the texture by its name
+	void _CheckForSource();
+
+	// Reads the dimensions of the specified image, leaving the format unchanged if it's already set
+	bool _Read (const String& file, uint index);
+
+	// Updates the size in memory using the current dimensions and format
+	void _SetInfo (uint width, uint height, uint depth, uint format);
+
+public:
+
+	virtual void Release();
+
+	virtual const String&	GetName()	const	{ return mName; }
+	virtual const Vector2i& GetSize()	const	{ return (mReplacement == 0) ? mSize : mReplacement->GetSize(); }
+	virtual bool	IsValid()			const;
+	virtual uint	GetDepth()			const	{ return (mReplacement == 0) ? mDepth  : mReplacement->GetDepth(); }
+	virtual uint	GetFormat()			const	{ return (mReplacement == 0) ? mFormat : mReplacement->GetFormat(); }
+	virtual uint	GetFiltering()		const	{ return (mReplacement == 0) ? mFilter : mReplacement->GetFiltering(); }
+	virtual uint	GetWrapMode()		const	{ return (mReplacement == 0) ? mWrapMode : mReplacement->GetWrapMode(); }
+	virtual uint	GetCompareMode()	const	{ return (mReplacement == 0) ? mCompareMode : mReplacement->GetCompareMode(); }
+	virtual ulong	GetSizeInMemory()	const	{ return (mReplacement == 0) ? mSizeInMemory : mReplacement->GetSizeInMemory(); }
+	virtual uint	GetMaxSize()		const	{ return 8192; }
+	virtual uint	GetType()			const	{ return (mReplacement == 0) ? mType : mReplacement->GetType(); }
+	virtual ulong	GetLastUsedTime()	const	{ return (mReplacement == 0) ? mTimestamp : mReplacement->GetLastUsedTime(); }
+
+	// Returns the valid path to the texture's source
+	virtual const String& GetSource (uint index) const;
+
+	// There are no pixels to read back
+	virtual bool GetBuffer (Memory& mem) { return false; }
+
+	// Wrapping mode and filtering
+	virtual void SetWrapMode	(uint wrapMode)		{ mWrapMode = wrapMode; }
+	virtual void SetFiltering	(uint filtering)	{ mFilter = filtering; }
+	virtual void SetCompareMode	(uint compareMode)	{ mCompareMode = compareMode; }
+	virtual void InvalidateMipmap() {}
+
+	// Activates the texture and returns its identifier
+	virtual uint Activate();
+
+	// Reserve an internal texture of specified dimensions
+	virtual bool Reserve (uint width, uint height, uint depth = 1, uint format = ITexture::Format::RGBA, uint msaa = 0);
+
+	// Load a single texture from the specified file
+	virtual bool Load( const String& file, uint textureFormat = Format::Optimal );
+
+	// Load a cube map using the six specified textures
+	virtual bool Load(	const String&	up,
+						const String&	down,
+						const String&	north,
+						const String&	east,
+						const String&	south,
+						const String&	west,
+						uint			format = Format::Optimal );
+
+	// Assign texture data manually
+	virtual bool Set(	const void*		buffer,
+						uint			width,
+						uint			height,
+						uint			depth,
+						uint			dataFormat,
+						uint			format = Format::Optimal );
+
+	// Assign the cube map data manually
+	virtual bool Set(	const void*	up,
+						const void*	down,
+						const void*	north,
+						const void*	east,
+						const void*	south,
+						const void*	west,
+						uint width, uint height,
+						uint dataFormat,
+						uint textureFormat = Format::Optimal );
+
+	// Replacement texture that this texture is pointing to
+	virtual const ITexture* GetReplacement() const { return mReplacement; }
+	virtual void SetReplacement (ITexture* tex) { if (tex == this) tex = 0; mReplacement = (NullTexture*)tex; }
+
+public:
+
+	// Serialization
+	virtual bool IsSerializable() const { return (mSerializable && mSource[0].IsValid()); }
+	virtual void SetSerializable(bool val) { mSerializable = val; }
+	virtual bool SerializeTo (TreeNode& root) const;
+	virtual bool SerializeFrom (const TreeNode& root, bool forceUpdate = false);
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Vertex buffer used by the headless graphics -- keeps a copy of the data in system memory
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class NullVBO : public IVBO
+{
+protected:
+
+	uint				mID;		// Unique identifier, used in place of the OpenGL buffer ID
+	uint				mType;		// Type of data stored in the buffer
+	Memory				mData;		// Copy of the buffer's data
+	Thread::Lockable	mLock;
+
+private:
+
+	// Only the NullGraphics class should be able to create VBOs
+	friend class NullGraphics;
+	NullVBO (uint id) : mID(id), mType(Type::Invalid) {}
+
+public:
+
+	virtual uint	GetID()		const { return mID; }
+	virtual uint	GetType()	const { return mType; }
+	virtual uint	GetSize()	const { return mData.GetSize(); }
+	virtual bool	IsValid()	const { return (mType != Type::Invalid); }
+	virtual void	Release()	{ mLock.Lock(); mData.Release(); mType = Type::Invalid; mLock.Unlock(); }
+	virtual void	Lock()		{ mLock.Lock(); }
+	virtual void	Unlock()	{ mLock.Unlock(); }
+
+	virtual void Get (VoidPtr& data, uint& size, uint& type)
+	{
+		data = mData.GetBuffer();
+		size = mData.GetSize();
+		type = mType;
+	}
+
+	virtual void Set (const void* data, uint size, uint type = Type::Vertex, bool dynamic = false)
+	{
+		if (data != 0 && size > 0) memcpy(mData.Resize(size), data, size);
+		else mData.Release();
+		mType = type;
+	}
+};
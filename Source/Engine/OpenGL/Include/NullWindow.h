@@ -0,0 +1,73 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Window that never shows up on screen, used together with NullGraphics to run the engine headless
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class NullWindow : public IWindow
+{
+public:
+
+	typedef FastDelegate<void (void)> FrameDelegate;
+
+protected:
+
+	String			mTitle;			// Window title
+	Vector2i		mPos;			// Window position
+	Vector2i		mSize;			// Window size
+	uint			mStyle;			// Window style
+	bool			mIsValid;		// Whether the window has been created
+	IEventReceiver*	mHandler;		// Event notifier
+	IGraphics*		mGraphics;		// Associated graphics controller
+	String			mClipboard;		// Clipboard text is simply kept locally
+	FrameDelegate	mOnBegin;		// Optional callback triggered at the beginning of the frame
+	FrameDelegate	mOnEnd;			// Optional callback triggered at the end of the frame
+
+public:
+
+	NullWindow() : mStyle(Style::Undefined), mIsValid(false), mHandler(0), mGraphics(0) {}
+	virtual ~NullWindow() { Close(); }
+
+	// Optional callbacks triggered when the frame begins and ends drawing, handy for timing the draw process
+	void SetOnBeginFrame (const FrameDelegate& fnct) { mOnBegin = fnct; }
+	void SetOnEndFrame	 (const FrameDelegate& fnct) { mOnEnd	= fnct; }
+
+	// Creates the window, initializing the graphics controller if one has been set
+	virtual bool Create(const String&	title,
+						short			x			= 0,
+						short			y			= 0,
+						ushort			width		= 1024,
+						ushort			height		= 768,
+						uint			style		= Style::Normal);
+
+	virtual void SetTitle		( const String& title  )	{ mTitle = title; }
+	virtual void SetEventHandler( IEventReceiver* ptr   )	{ mHandler = ptr; }
+	virtual bool SetGraphics	( IGraphics*	 ptr   );
+	virtual bool SetPosition	( const Vector2i& pos  )	{ mPos = pos; return true; }
+	virtual bool SetSize		( const Vector2i& size );
+	virtual bool SetStyle		( uint style )				{ mStyle = style; return true; }
+	virtual void SetFocus		()							{}
+
+	virtual bool		IsValid()		const	{ return mIsValid; }
+	virtual String		GetTitle()		const	{ return mTitle; }
+	virtual Vector2i	GetPosition()	const	{ return mPos; }
+	virtual Vector2i	GetSize()		const	{ return mSize; }
+	virtual uint		GetStyle()		const	{ return mStyle; }
+	virtual bool		IsMinimized()	const	{ return false; }
+	virtual void		ShowCursor(bool show)	{}
+	virtual void		Close();
+	virtual bool		Update()				{ return mIsValid; }
+	virtual void		BeginFrame()			{ if (mOnBegin) mOnBegin(); }
+	virtual void		EndFrame()				{ if (mOnEnd) mOnEnd(); }
+
+	virtual String GetClipboardText() const				{ return mClipboard; }
+	virtual void SetClipboardText (const String& text)	{ mClipboard = text; }
+
+	// Serialization
+	virtual bool SerializeFrom (const TreeNode& root);
+	virtual bool SerializeTo (TreeNode& root) const;
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Pool of asynchronous point visibility tests used by the graphics managers. Points are identified by a
+// unique ID provided by the caller, and each one keeps its last known visibility. Tests requested during
+// a frame get issued together by the graphics manager, and their results are only collected a few frames
+// later, so the CPU never has to wait for the videocard to catch up. A point's visibility only changes
+// once several results in a row disagree with it, which prevents glares from flickering.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class VisibilityQueries
+{
+public:
+
+	enum
+	{
+		MaxLatency = 4,		// Maximum number of frames a query can stay in flight for
+	};
+
+	// Visibility test of a single point
+	struct Query
+	{
+		Vector3f	mPos;		// Position of the point in normalized device coordinates
+		uint		mID;		// Identifier of the point
+		uint		mHandle;	// Query object used by the graphics manager, or '0' if it hasn't been issued
+	};
+
+	typedef Array<Query> Queries;
+
+private:
+
+	// Last known state of a single point
+	struct Point
+	{
+		uint	mFrame;		// Last frame the point was tested on
+		uint	mCount;		// Number of results in a row that disagree with the last known visibility
+		bool	mVisible;	// Last known visibility
+	};
+
+	Hash<Point>	mPoints;
+	Queries		mFrames[MaxLatency];	// Queries of all frames in flight, used as a ring buffer
+	Array<uint>	mFree;					// Query objects that are not currently in use
+	uint		mFrame;					// Current frame
+	uint		mLatency;				// Number of frames between a query being issued and its result collected
+	uint		mHysteresis;			// Number of results in a row needed to change a point's visibility
+	uint		mIssued;				// Number of the current frame's queries that have already been issued
+
+public:
+
+	VisibilityQueries() : mFrame(0), mLatency(2), mHysteresis(2), mIssued(0) {}
+
+	// Number of frames between a query being issued and its result collected (1 to MaxLatency).
+	// Changing the latency discards all queries that are currently in flight.
+	uint GetLatency() const { return mLatency; }
+	void SetLatency (uint frames);
+
+	// Number of results in a row that must disagree with a point's visibility in order to change it
+	uint GetHysteresis() const { return mHysteresis; }
+	void SetHysteresis (uint count) { mHysteresis = (count > 0) ? count : 1; }
+
+	// Returns the last known visibility of the specified point, testing it again if it's on-screen.
+	// Points are only tested once per frame, regardless of how many times they are requested.
+	bool Request (uint id, const Vector3f& pos, const Matrix44& mvp);
+
+	// Queries requested during the current frame
+	Queries& GetCurrent() { return mFrames[mFrame % mLatency]; }
+
+	// Index of the first query of the current frame that hasn't been issued yet
+	uint GetUnissued() const { return mIssued; }
+	void SetIssued (uint count) { mIssued = count; }
+
+	// Retrieves a query object that can be reused, or '0' if the graphics manager should create a new one
+	uint AcquireHandle();
+
+	// Starts a new frame, returning the queries issued 'latency' frames ago. Available results should be
+	// passed to SetResult(), after which Recycle() must be called before any new points are requested.
+	Queries& NextFrame();
+
+	// Updates the visibility of the point tested by the specified query
+	void SetResult (const Query& query, bool visible);
+
+	// Returns all query objects used by the queries retrieved via NextFrame() back to the pool
+	void Recycle();
+
+	// Removes all points and queries, retrieving all query objects so that they can be deleted
+	void Release (Array<uint>& handles);
+};
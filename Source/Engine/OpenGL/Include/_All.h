@@ -20,14 +20,22 @@ namespace R5
 	#include "GLTexture.h"			// Regular 2D texture
 	#include "GLFont.h"				// OpenGL implementation of the font class
 	#include "GLShaderUniforms.h"			// Built-in shader uniforms
+	#include "GLShaderCache.h"		// Cache of preprocessed shader variations
 	#include "GLShaderComponent.h"	// Single vertex or fragment shader, part of a GLSL program
 	#include "GLShaderProgram.h"	// GLSL shader program using one or more Shader Components
 	#include "GLSurfaceShader.h"	// Surface shader is a combination of different shader programs
 	#include "GLTechnique.h"		// Material rendering technique
 	#include "GLMaterial.h"			// Material management
+	#include "VisibilityQueries.h"	// Pool of asynchronous point visibility tests
 	#include "GLController.h"		// Low-level graphics controller -- closest level of interaction with the renderer API
 	#include "GLGraphics.h"			// Higher level of renderer API interaction, handles resource management for graphical resources
 	#include "GLWindow.h"			// OpenGL window creation
+	#include "NullTexture.h"		// Texture that only keeps track of its source and dimensions
+	#include "NullVBO.h"			// Vertex buffer object kept in system memory
+	#include "NullShader.h"			// Shader that is never compiled
+	#include "NullRenderTarget.h"	// Render target with no backing frame buffer
+	#include "NullGraphics.h"		// Headless graphics manager that records state changes instead of issuing them
+	#include "NullWindow.h"			// Window that never appears on screen
 };
 
 #endif
@@ -879,6 +879,13 @@ void GLController::SetActiveVertexAttribute(
 	BufferEntry& buffer = mBuffers[attribute];
 	bool shouldBeEnabled = (ptr != 0 || (vbo != 0 && vbo->IsValid()));
 
+	// The same buffer can be bound again with a different format (for example after a mesh changes its layout)
+	uint type = dataType;
+
+	// Client state arrays normalize integer data on their own, attributes need to be told to do so
+	bool normalized = (dataType & DataType::Normalized) != 0;
+	dataType &= ~DataType::Normalized;
+
 	// Convert the specified attribute to an OpenGL client state index
 	uint clientState = g_attributeToClientState[attribute];
 	bool useClientState = (clientState != 0);
@@ -905,7 +912,7 @@ void GLController::SetActiveVertexAttribute(
 			if (buffer.mEnabled)
 			{
 				// If the buffer doesn't change, there is no sense in continuing
-				if (buffer.mVbo == vbo && buffer.mPtr == ptr) return;
+				if (buffer.mVbo == vbo && buffer.mPtr == ptr && buffer.mType == type && buffer.mStride == stride) return;
 			}
 			else
 			{
@@ -915,8 +922,10 @@ void GLController::SetActiveVertexAttribute(
 			}
 
 			// Activate the VBO and bind the attribute
+			buffer.mType	= type;
+			buffer.mStride	= stride;
 			GLController::SetActiveVBO( buffer.mVbo = vbo, IVBO::Type::Vertex );
-			glVertexAttribPointer(attribute, elements, dataType, 0, stride, buffer.mPtr = ptr);
+			glVertexAttribPointer(attribute, elements, dataType, normalized ? 1 : 0, stride, buffer.mPtr = ptr);
 			CHECK_GL_ERROR;
 		}
 		else if (buffer.mEnabled)
@@ -941,7 +950,7 @@ void GLController::SetActiveVertexAttribute(
 		{
 			if (buffer.mEnabled)
 			{
-				if (buffer.mVbo == vbo && buffer.mPtr == ptr) return;
+				if (buffer.mVbo == vbo && buffer.mPtr == ptr && buffer.mType == type && buffer.mStride == stride) return;
 			}
 			else
 			{
@@ -950,6 +959,8 @@ void GLController::SetActiveVertexAttribute(
 				CHECK_GL_ERROR;
 			}
 
+			buffer.mType	= type;
+			buffer.mStride	= stride;
 			GLController::SetActiveVBO( buffer.mVbo = vbo, IVBO::Type::Vertex );
 
 			switch (attribute)
@@ -1022,7 +1033,7 @@ uint GLController::DrawVertices(uint primitive, uint vertexCount)
 // Draw using an index array
 //============================================================================================================
 
-uint GLController::_DrawIndices(const IVBO* vbo, const ushort* ptr, uint primitive, uint indexCount)
+uint GLController::_DrawIndices(const IVBO* vbo, const void* ptr, uint primitive, uint indexCount, uint glType)
 {
 	uint glPrimitive(0), triangleCount(0);
 	GetGLPrimitive(primitive, indexCount, glPrimitive, triangleCount);
@@ -1034,7 +1045,7 @@ uint GLController::_DrawIndices(const IVBO* vbo, const ushort* ptr, uint primiti
 
 		// Draw the indices
 		GLController::PrepareToDraw();
-		glDrawElements( glPrimitive, indexCount, GL_UNSIGNED_SHORT, ptr );
+		glDrawElements( glPrimitive, indexCount, glType, ptr );
 		mStats.mTriangles += triangleCount;
 		++mStats.mDrawCalls;
 	}
@@ -93,6 +93,23 @@ bool GLFont::Load (const byte* buffer, uint bufferSize, byte fontSize, byte padd
 	return retVal;
 }
 
+//============================================================================================================
+// Tags recognized by GLFont::SerializeFrom(), in the same order as the values below
+//============================================================================================================
+
+struct FontTag
+{
+	enum
+	{
+		Source,
+		Size,
+		Serializable,
+	};
+};
+
+const char* g_fontTags[] = { "Source", "Size", "Serializable", 0 };
+TagMap g_fontTagMap (g_fontTags);
+
 //============================================================================================================
 // Serialization -- Load
 //============================================================================================================
@@ -108,12 +125,14 @@ bool GLFont::SerializeFrom (const TreeNode& root, bool forceUpdate)
 		for (uint i = 0; i < root.mChildren.GetSize(); ++i)
 		{
 			const TreeNode& node  = root.mChildren[i];
-			const String&	tag   = node.mTag;
 			const Variable&	value = node.mValue;
 
-			if		(tag == "Source")		value >> source;
-			else if (tag == "Size")			value >> size;
-			else if (tag == "Serializable") value >> mSerializable;
+			switch (g_fontTagMap[node])
+			{
+				case FontTag::Source:		value >> source;		break;
+				case FontTag::Size:			value >> size;			break;
+				case FontTag::Serializable:	value >> mSerializable;	break;
+			}
 		}
 
 		if (source.IsValid() && size > 0 && (!IsValid() || forceUpdate) && mFont.Load(source, size))
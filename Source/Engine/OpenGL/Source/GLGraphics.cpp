@@ -7,64 +7,123 @@ using namespace R5;
 GLGraphics::GLGraphics() :
 	mThread		(0),
 	mSkyboxVBO	(0),
-	mSkyboxIBO	(0),
-	mQuery		(0)
+	mSkyboxIBO	(0)
 {
 }
 
 //============================================================================================================
-// Returns whether the specified point would be visible if rendered
+// Returns the last known visibility of the specified point, and tests it again
 //============================================================================================================
 
-bool GLGraphics::IsPointVisible (const Vector3f& v)
+bool GLGraphics::IsPointVisible (uint id, const Vector3f& v)
 {
-	// Reset the ModelView matrix as the query is affected by it
+	if (!g_caps.mOcclusion) return false;
+
+	// Reset the ModelView matrix as the test is affected by it
 	ResetModelMatrix();
 	ResetViewMatrix();
 
-	// Convert the 3D point to screen coordinates
-	Vector2i screen (ConvertTo2D(v));
+	// The point gets converted to normalized device coordinates right away, as the matrices
+	// may be different by the time the test actually gets issued.
+	return mQueries.Request(id, v, GetModelViewProjMatrix());
+}
+
+//============================================================================================================
+// Issues all visibility tests requested since the last time this function was called
+//============================================================================================================
+
+void GLGraphics::_IssueQueries()
+{
+	VisibilityQueries::Queries& queries = mQueries.GetCurrent();
+	uint first = mQueries.GetUnissued();
+	uint last  = queries.GetSize();
+	if (first == last) return;
+	mQueries.SetIssued(last);
 
-	// Occlusion query should not be performed if the point is off-screen
-	if (screen.x >= 0 && screen.y >= 0 && screen.x < mSize.x && screen.y < mSize.y)
+	// Remember the states that are about to be changed
+	bool colorWrite (mColorWrite);
+	bool depthWrite (mDepthWrite);
+	bool depthTest  (mDepthTest);
+
+	// Points are only tested against the depth buffer, without actually being drawn
+	SetActiveMaterial((const IMaterial*)0);
+	SetColorWrite(false);
+	SetDepthWrite(false);
+	SetDepthTest(true);
+
+	// Only the vertex array is used
+	SetActiveVertexAttribute( Attribute::Normal,	 0, 0, 0, 0, 0 );
+	SetActiveVertexAttribute( Attribute::Tangent,	 0, 0, 0, 0, 0 );
+	SetActiveVertexAttribute( Attribute::Color,		 0, 0, 0, 0, 0 );
+	SetActiveVertexAttribute( Attribute::BoneIndex,  0, 0, 0, 0, 0 );
+	SetActiveVertexAttribute( Attribute::BoneWeight, 0, 0, 0, 0, 0 );
+	SetActiveVertexAttribute( Attribute::TexCoord0,	 0, 0, 0, 0, 0 );
+	SetActiveVertexAttribute( Attribute::TexCoord1,	 0, 0, 0, 0, 0 );
+	SetActiveVertexAttribute( Attribute::Vertex, 0, &queries[0].mPos, DataType::Float, 3, sizeof(VisibilityQueries::Query) );
+	PrepareToDraw();
+
+	// Positions are already in normalized device coordinates
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+
+	// Every point gets its own query, but they're all issued together without waiting on the results
+	for (uint i = first; i < last; ++i)
 	{
-		if (g_caps.mOcclusion)
-		{
-			// Activate the matrices as the query will need them to be properly set up
-			mStats.mMatSwitches += mTrans.Activate(0);
+		VisibilityQueries::Query& query = queries[i];
+		query.mHandle = mQueries.AcquireHandle();
+		if (query.mHandle == 0) glGenQueries(1, &query.mHandle);
 
-			// If the query hasn't been created yet, do that now
-			if (mQuery == 0)
-			{
-				glGenQueries(1, &mQuery);
-				CHECK_GL_ERROR;
-			}
+		glBeginQuery(GL_SAMPLES_PASSED, query.mHandle);
+		glDrawArrays(GL_POINTS, i, 1);
+		glEndQuery(GL_SAMPLES_PASSED);
+	}
 
-			// Depth test should be considered in occlusion tests, so ensure that it's on
-			if (!mDepthTest) glEnable(GL_DEPTH_TEST);
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+	glPopMatrix();
+	CHECK_GL_ERROR;
 
-			// Begin a query and render a single point at the specified coordinates
-			glBeginQuery(GL_SAMPLES_PASSED, mQuery);
-			{
-				glBegin(GL_POINTS);
-				glVertex3f(v.x, v.y, v.z);
-				glEnd();
-			}
-			glEndQuery(GL_SAMPLES_PASSED);
+	// Restore the previous states
+	SetActiveVertexAttribute(Attribute::Vertex, 0, 0, 0, 0, 0);
+	SetColorWrite(colorWrite);
+	SetDepthWrite(depthWrite);
+	SetDepthTest(depthTest);
+}
 
-			// Restore the depth testing value
-			if (!mDepthTest) glDisable(GL_DEPTH_TEST);
+//============================================================================================================
+// Collects the results of visibility tests issued a few frames ago
+//============================================================================================================
 
-			// Retrieve the query's result
-			uint count (0);
-			glGetQueryObjectuiv(mQuery, GL_QUERY_RESULT, &count);
-			CHECK_GL_ERROR;
+void GLGraphics::_CollectQueries()
+{
+	VisibilityQueries::Queries& queries = mQueries.NextFrame();
 
-			// The point is visible if the number of fragments returned is not zero
-			return (count != 0);
+	FOREACH(i, queries)
+	{
+		const VisibilityQueries::Query& query = queries[i];
+
+		if (query.mHandle != 0)
+		{
+			// Results that still aren't available are skipped rather than waited on
+			uint available (0);
+			glGetQueryObjectuiv(query.mHandle, GL_QUERY_RESULT_AVAILABLE, &available);
+
+			if (available != 0)
+			{
+				// The point is visible if the number of fragments returned is not zero
+				uint count (0);
+				glGetQueryObjectuiv(query.mHandle, GL_QUERY_RESULT, &count);
+				mQueries.SetResult(query, count != 0);
+			}
 		}
 	}
-	return false;
+	CHECK_GL_ERROR;
+	mQueries.Recycle();
 }
 
 //============================================================================================================
@@ -238,12 +297,16 @@ void GLGraphics::Release()
 		mSkyboxVBO = 0;
 		mSkyboxIBO = 0;
 
-		if (mQuery != 0)
+		// Delete all visibility queries
 		{
-			glDeleteQueries(1, &mQuery);
-			mQuery = 0;
+			Array<uint> queries;
+			mQueries.Release(queries);
+			if (queries.IsValid()) glDeleteQueries(queries.GetSize(), queries.GetBuffer());
 		}
 
+		// Save all newly preprocessed shaders
+		GLShaderCache::Save();
+
 		mFonts.Release();
 		mShaders.Release();
 		mTextures.Release();
@@ -294,6 +357,9 @@ void GLGraphics::Clear (bool color, bool depth, bool stencil)
 {
 	if (!color && !depth && !stencil) return;
 
+	// Visibility tests must be issued before the depth buffer gets cleared
+	if (depth) _IssueQueries();
+
 	if (mTarget != 0)
 	{
 		if (!mTarget->HasColor())	 color   = false;
@@ -379,6 +445,7 @@ void GLGraphics::Clear (bool color, bool depth, bool stencil)
 void GLGraphics::BeginFrame()
 {
 	mStats.Clear();
+	_CollectQueries();
 
 	if (mDelegates.IsValid())
 	{
@@ -401,6 +468,8 @@ void GLGraphics::BeginFrame()
 
 void GLGraphics::EndFrame()
 {
+	_IssueQueries();
+
 	// NOTE: Intel driver seems to have a bug in it where it resets the blending mode to its default
 	// value when the frame finishes the draw process (src_alpha, one_minus_src_alpha).
 	// This call here effectively fixes the issue, but it's obviously a work-around rather than a true fix.
@@ -408,6 +477,16 @@ void GLGraphics::EndFrame()
 	mTechnique = 0;
 }
 
+//============================================================================================================
+// Visibility tests are issued against the active target's depth buffer before it gets changed
+//============================================================================================================
+
+void GLGraphics::SetActiveRenderTarget (const IRenderTarget* tar)
+{
+	if (mTarget != tar) _IssueQueries();
+	GLController::SetActiveRenderTarget(tar);
+}
+
 //============================================================================================================
 // Draws the active skybox cube
 //============================================================================================================
@@ -802,7 +881,7 @@ void GLGraphics::DeleteRenderTarget (const IRenderTarget* ptr)
 }
 
 //============================================================================================================
-// Retrieves or creates a new render group -- contains several default presets for convenience
+// Retrieves or creates a new render group
 //============================================================================================================
 
 ITechnique* GLGraphics::GetTechnique (const String& name, bool createIfMissing)
@@ -829,102 +908,8 @@ ITechnique* GLGraphics::GetTechnique (const String& name, bool createIfMissing)
 			// Not found -- add a new one
 			if (createIfMissing)
 			{
+				// Commonly used techniques are set up with presets by the GLTechnique itself
 				tech = new GLTechnique(name);
-
-				if (name == "Depth")
-				{
-					tech->SetFog(false);
-					tech->SetColorWrite(false);
-					tech->SetAlphaTest(true);
-					tech->SetLighting(ITechnique::Lighting::None);
-					tech->SetBlending(ITechnique::Blending::None);
-				}
-				else if (name == "Glow")
-				{
-					// Glow is drawn with no depth writing, using additive blending and no lighting
-					tech->SetFog(false);
-					tech->SetDepthWrite(false);
-					tech->SetAlphaTest(false);
-					tech->SetBlending(ITechnique::Blending::Add);
-					tech->SetLighting(ITechnique::Lighting::None);
-					tech->SetSorting(ITechnique::Sorting::BackToFront);
-				}
-				else if (name == "Glare")
-				{
-					// Glare is drawn last, as it goes on top of everything and doesn't use depth, blending or lighting
-					tech->SetFog(false);
-					tech->SetDepthWrite(false);
-					tech->SetDepthTest(false);
-					tech->SetAlphaTest(false);
-					tech->SetBlending(ITechnique::Blending::Add);
-					tech->SetLighting(ITechnique::Lighting::None);
-					tech->SetSorting(ITechnique::Sorting::BackToFront);
-				}
-				else if (name == "Particle")
-				{
-					tech->SetDepthWrite(false);
-					tech->SetLighting(ITechnique::Lighting::None);
-					tech->SetSorting(ITechnique::Sorting::BackToFront);
-				}
-				else if (name == "Post Process")
-				{
-					tech->SetFog(false);
-					tech->SetDepthWrite(false);
-					tech->SetDepthTest(false);
-					tech->SetAlphaTest(false);
-					tech->SetLighting(IGraphics::Lighting::None);
-					tech->SetBlending(IGraphics::Blending::None);
-				}
-				else if (name == "Deferred")
-				{
-					tech->SetFlag(ITechnique::Flag::Deferred, true);
-					tech->SetFog(false);
-					tech->SetLighting(IGraphics::Lighting::None);
-					tech->SetBlending(IGraphics::Blending::None);
-				}
-				else if (name == "Decal")
-				{
-					tech->SetFog(false);
-					tech->SetDepthWrite(false);
-					tech->SetLighting(IGraphics::Lighting::None);
-					tech->SetBlending(IGraphics::Blending::None);
-				}
-				else if (name == "Projected Texture")
-				{
-					tech->SetFog(false);
-					tech->SetDepthWrite(false);
-					tech->SetLighting(IGraphics::Lighting::None);
-					tech->SetBlending(IGraphics::Blending::Replace);
-				}
-
-				// Wireframe technique
-				if (name.Contains("Wireframe"))
-				{
-					tech->SetFog(false);
-					tech->SetLighting(IGraphics::Lighting::None);
-					tech->SetBlending(IGraphics::Blending::None);
-					tech->SetWireframe(true);
-				}
-
-				// Solid material group -- no alpha testing or blending needed
-				if (name.Contains("Opaque"))
-				{
-					tech->SetAlphaTest(false);
-					tech->SetBlending(ITechnique::Blending::None);
-				}
-				else if (name.Contains("Transparent"))
-				{
-					// Group for objects with transparency, drawn after solids -- default everything
-					tech->SetSorting(ITechnique::Sorting::BackToFront);
-				}
-
-				if (name.Contains("Shadowed"))
-				{
-					tech->SetFlag(ITechnique::Flag::Shadowed, true);
-				}
-
-				// Newly created techniques should not be serializable until something changes
-				tech->SetSerializable(false);
 				mTechs.Expand() = tech;
 			}
 			else tech = 0;
@@ -1089,6 +1074,48 @@ IFont* GLGraphics::GetFont (const String& name, bool createIfMissing)
 		if (!isSerializable && !serializable) p->SetSerializable(false);		\
 	}
 
+//============================================================================================================
+// Tags recognized by GLGraphics::SerializeFrom(), in the same order as the values below
+//============================================================================================================
+
+struct GraphicsTag
+{
+	enum
+	{
+		Graphics,
+		Serializable,
+		DefaultAF,
+		AnisotropicFilter,
+		BackgroundColor,
+		FogRange,
+		Skybox,
+		Technique,
+		Texture,
+		Material,
+		Font,
+		DXT,
+	};
+};
+
+const char* g_graphicsTags[] =
+{
+	"Graphics",
+	"Serializable",
+	"Default AF",
+	"Anisotropic Filter",
+	"Background Color",
+	"Fog Range",
+	"Skybox",
+	"Technique",
+	"Texture",
+	"Material",
+	"Font",
+	"DXT",
+	0
+};
+
+TagMap g_graphicsTagMap (g_graphicsTags);
+
 //============================================================================================================
 
 bool GLGraphics::SerializeFrom (const TreeNode& root, bool forceUpdate)
@@ -1101,44 +1128,58 @@ bool GLGraphics::SerializeFrom (const TreeNode& root, bool forceUpdate)
 	for (uint i = 0; i < root.mChildren.GetSize(); ++i)
 	{
 		const TreeNode& node  = root.mChildren[i];
-		const String&	tag   = node.mTag;
 		const Variable&	value = node.mValue;
 
-		if (tag == ClassName())
+		switch (g_graphicsTagMap[node])
 		{
-			return SerializeFrom(node, forceUpdate);
-		}
-		else if (tag == "Serializable")
-		{
-			value >> serializable;
-		}
-		else if (tag == "Default AF" || tag == "Anisotropic Filter")
-		{
-			uint val;
-			if (value >> val) SetDefaultAF(val);
-		}
-		else if (tag == "Background Color")
-		{
-			Color4f color;
-			if (value >> color) SetBackgroundColor(color);
-		}
-		else if (tag == "Fog Range")
-		{
-			Vector2f range;
-			if (value >> range) SetFogRange(range);
-		}
-		else if (tag == "Skybox") skybox = (value.AsString());
-		else if	(tag == ITechnique::ClassName())	EXECUTE(ITechnique,	GetTechnique)
-		else if (tag == ITexture::ClassName())	EXECUTE(ITexture,	GetTexture)
-		else if (tag == IMaterial::ClassName())	EXECUTE(IMaterial,	GetMaterial)
-		else if (tag == IFont::ClassName())		EXECUTE(IFont,		GetFont)
-		else if (tag == "DXT")
-		{
-			// Turn off DXT compression if requested
-			if (value.IsBool() && !value.AsBool())
+			case GraphicsTag::Graphics:
+			{
+				return SerializeFrom(node, forceUpdate);
+			}
+
+			case GraphicsTag::Serializable:
+			{
+				value >> serializable;
+			}
+			break;
+
+			case GraphicsTag::DefaultAF:
+			case GraphicsTag::AnisotropicFilter:
+			{
+				uint val;
+				if (value >> val) SetDefaultAF(val);
+			}
+			break;
+
+			case GraphicsTag::BackgroundColor:
+			{
+				Color4f color;
+				if (value >> color) SetBackgroundColor(color);
+			}
+			break;
+
+			case GraphicsTag::FogRange:
 			{
-				g_caps.mDXTCompression = false;
+				Vector2f range;
+				if (value >> range) SetFogRange(range);
+			}
+			break;
+
+			case GraphicsTag::Skybox:		skybox = (value.AsString());			break;
+			case GraphicsTag::Technique:	EXECUTE(ITechnique,	GetTechnique)	break;
+			case GraphicsTag::Texture:		EXECUTE(ITexture,	GetTexture)		break;
+			case GraphicsTag::Material:		EXECUTE(IMaterial,	GetMaterial)	break;
+			case GraphicsTag::Font:			EXECUTE(IFont,		GetFont)		break;
+
+			case GraphicsTag::DXT:
+			{
+				// Turn off DXT compression if requested
+				if (value.IsBool() && !value.AsBool())
+				{
+					g_caps.mDXTCompression = false;
+				}
 			}
+			break;
 		}
 	}
 
@@ -130,6 +130,52 @@ void GLMaterial::ClearAllDrawMethods()
 	}
 }
 
+//============================================================================================================
+// Tags recognized by the material's serialization functions, in the same order as the values below
+//============================================================================================================
+
+struct MaterialTag
+{
+	enum
+	{
+		Shader,
+		Textures,
+		Diffuse,
+		Color,
+		Glow,
+		SpecularHue,
+		Specularity,
+		Shininess,
+		Reflectiveness,
+		Occlusion,
+		Specular,
+		AlphaCutoff,
+		ADT,
+		Technique,
+	};
+};
+
+const char* g_materialTags[] =
+{
+	"Shader",
+	"Textures",
+	"Diffuse",
+	"Color",
+	"Glow",
+	"Specular Hue",
+	"Specularity",
+	"Shininess",
+	"Reflectiveness",
+	"Occlusion",
+	"Specular",
+	"Alpha Cutoff",
+	"ADT",
+	"Technique",
+	0
+};
+
+TagMap g_materialTagMap (g_materialTags);
+
 //============================================================================================================
 // Serialization -- Load
 //============================================================================================================
@@ -142,30 +188,39 @@ void SerializeMethodFrom (IMaterial::DrawMethod& m, const TreeNode& root, IGraph
 		const String&	tag   = node.mTag;
 		const Variable&	value = node.mValue;
 
-		if (tag == IShader::ClassName())
-		{
-			m.mShader = (value.IsValid()) ? graphics->GetShader(
-				value.AsString()) : 0;
-		}
-		else if (tag == "Textures")
+		switch (g_materialTagMap[node])
 		{
-			if (value.IsStringArray())
+			case MaterialTag::Shader:
 			{
-				const Array<String>& sa = value.AsStringArray();
-				for (uint i = 0; i < sa.GetSize(); ++i) m.SetTexture(i, graphics->GetTexture(sa[i]));
+				m.mShader = (value.IsValid()) ? graphics->GetShader(
+					value.AsString()) : 0;
 			}
-		}
-		// LEGACY SUPPORT, WILL BE REMOVED
-		else if (tag.BeginsWith(ITexture::ClassName()))
-		{
-			String left, right;
-			uint textureUnit = 0;
+			break;
+
+			case MaterialTag::Textures:
+			{
+				if (value.IsStringArray())
+				{
+					const Array<String>& sa = value.AsStringArray();
+					for (uint i = 0; i < sa.GetSize(); ++i) m.SetTexture(i, graphics->GetTexture(sa[i]));
+				}
+			}
+			break;
 
-			if ( tag.Split(left, ' ', right) && left == ITexture::ClassName() && right >> textureUnit )
+			// LEGACY SUPPORT, WILL BE REMOVED
+			default:
 			{
-				m.SetTexture( textureUnit, graphics->GetTexture(
-					value.AsString()) );
+				String left, right;
+				uint textureUnit = 0;
+
+				if ( tag.BeginsWith(ITexture::ClassName()) && tag.Split(left, ' ', right) &&
+					 left == ITexture::ClassName() && right >> textureUnit )
+				{
+					m.SetTexture( textureUnit, graphics->GetTexture(
+						value.AsString()) );
+				}
 			}
+			break;
 		}
 	}
 }
@@ -213,36 +268,44 @@ bool GLMaterial::SerializeFrom (const TreeNode& root, bool forceUpdate)
 	for (uint i = 0; i < root.mChildren.GetSize(); ++i)
 	{
 		const TreeNode& node  = root.mChildren[i];
-		const String&	tag   = node.mTag;
 		const Variable&	value = node.mValue;
 
-		if (tag == "Diffuse" || tag == "Color")
-		{
-			if (value >> c) SetDiffuse(c);
-		}
-		else if (tag == "Glow")				{ if (value >> f) SetGlow(f); }
-		else if (tag == "Specular Hue")		{ if (value >> f) SetSpecularHue(f); }
-		else if (tag == "Specularity")		{ if (value >> f) SetSpecularity(f); }
-		else if (tag == "Shininess")		{ if (value >> f) SetShininess(f); }
-		else if (tag == "Reflectiveness")	{ if (value >> f) SetReflectiveness(f); }
-		else if (tag == "Occlusion")		{ if (value >> f) SetOcclusion(f); }
-		else if (tag == "Specular")			// Deprecated syntax
+		switch (g_materialTagMap[node])
 		{
-			if (value >> c)
+			case MaterialTag::Diffuse:
+			case MaterialTag::Color:			if (value >> c) SetDiffuse(c);			break;
+			case MaterialTag::Glow:				if (value >> f) SetGlow(f);				break;
+			case MaterialTag::SpecularHue:		if (value >> f) SetSpecularHue(f);		break;
+			case MaterialTag::Specularity:		if (value >> f) SetSpecularity(f);		break;
+			case MaterialTag::Shininess:		if (value >> f) SetShininess(f);		break;
+			case MaterialTag::Reflectiveness:	if (value >> f) SetReflectiveness(f);	break;
+			case MaterialTag::Occlusion:		if (value >> f) SetOcclusion(f);		break;
+
+			// Deprecated syntax
+			case MaterialTag::Specular:
 			{
-				SetSpecularity((c.r + c.g + c.b) / 3.0f);
-				SetShininess(c.a);
+				if (value >> c)
+				{
+					SetSpecularity((c.r + c.g + c.b) / 3.0f);
+					SetShininess(c.a);
+				}
 			}
-		}
-		else if (tag == "Alpha Cutoff" || tag == "ADT")
-		{
-			value >> mAlphaCutoff;
-		}
-		else if (tag == ITechnique::ClassName())
-		{
-			const ITechnique* tech = mGraphics->GetTechnique(value.AsString());
-			DrawMethod* ren = GetDrawMethod(tech, true);
-			SerializeMethodFrom(*ren, node, mGraphics);
+			break;
+
+			case MaterialTag::AlphaCutoff:
+			case MaterialTag::ADT:
+			{
+				value >> mAlphaCutoff;
+			}
+			break;
+
+			case MaterialTag::Technique:
+			{
+				const ITechnique* tech = mGraphics->GetTechnique(value.AsString());
+				DrawMethod* ren = GetDrawMethod(tech, true);
+				SerializeMethodFrom(*ren, node, mGraphics);
+			}
+			break;
 		}
 	}
 	return true;
@@ -57,6 +57,15 @@ void RegisterBuiltInUniforms()
 	InsertRecord("R5_inverseViewRotationMatrix",	9);
 }
 
+//============================================================================================================
+// Prepares the preprocessor for use. Must be called before shaders get preprocessed on multiple threads.
+//============================================================================================================
+
+void GLInitShaderPreprocessor()
+{
+	if (g_uniforms.IsEmpty()) RegisterBuiltInUniforms();
+}
+
 //============================================================================================================
 // Convenience (fake) uniforms
 //============================================================================================================
@@ -595,7 +604,7 @@ void ReplaceSample (String& code, String& prefix, const char* type)
 void AddReferencedVariables (String& code, bool isFragmentShader)
 {
 	// If we have no uniform records to work with, create them
-	if (g_uniforms.IsEmpty()) RegisterBuiltInUniforms();
+	GLInitShaderPreprocessor();
 
 	String prefix;
 
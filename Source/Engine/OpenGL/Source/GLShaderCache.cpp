@@ -0,0 +1,253 @@
+#include "../Include/_All.h"
+#include "../Include/_OpenGL.h"
+using namespace R5;
+
+//============================================================================================================
+// Format version of the cache. Must be increased every time the shader preprocessor changes, as that
+// invalidates all previously preprocessed code. Saved files with a different version are ignored.
+//============================================================================================================
+
+#define CACHE_VERSION	1
+#define CACHE_TAG		"R5SC"
+
+//============================================================================================================
+// Single preprocessed shader variation
+//============================================================================================================
+
+struct CacheEntry
+{
+	GLShaderCache::Key	mKey;
+	uint				mFlags;
+	String				mCode;
+};
+
+//============================================================================================================
+// Entries are indexed by the folded key, so the full key must still be compared on lookup
+//============================================================================================================
+
+Array<CacheEntry>	g_cache;
+Hash<uint>			g_cacheIndex;
+Thread::Lockable	g_cacheLock;
+String				g_cacheFile		= "Cache/Shaders.bin";
+bool				g_cacheLoaded	= false;
+bool				g_cacheChanged	= false;
+uint				g_cacheThreads	= 0;
+uint				g_cacheHits		= 0;
+uint				g_cacheMisses	= 0;
+
+//============================================================================================================
+// 64-bit FNV-1a hash
+//============================================================================================================
+
+inline void HashBytes (GLShaderCache::Key& key, const void* data, uint size)
+{
+	const byte* ptr = (const byte*)data;
+
+	for (const byte* end = ptr + size; ptr != end; ++ptr)
+	{
+		key ^= *ptr;
+		key *= 0x100000001B3ULL;
+	}
+}
+
+//============================================================================================================
+
+inline uint FoldKey (GLShaderCache::Key key) { return (uint)(key ^ (key >> 32)); }
+
+//============================================================================================================
+// Adds an entry to the cache -- the cache must be locked prior to calling this function
+//============================================================================================================
+
+void AddEntry (GLShaderCache::Key key, const String& code, uint flags)
+{
+	uint folded = FoldKey(key);
+	uint* index = g_cacheIndex.GetIfExists(folded);
+
+	// Entries with the same folded key replace each other
+	CacheEntry& entry = (index != 0) ? g_cache[*index] : g_cache.Expand();
+	if (index == 0) g_cacheIndex[folded] = g_cache.GetSize() - 1;
+
+	entry.mKey		= key;
+	entry.mFlags	= flags;
+	entry.mCode		= code;
+}
+
+//============================================================================================================
+// Loads the cache from its file -- the cache must be locked prior to calling this function
+//============================================================================================================
+
+void LoadCache()
+{
+	g_cacheLoaded = true;
+	if (g_cacheFile.IsEmpty()) return;
+
+	Memory mem;
+	if (!mem.Load(g_cacheFile)) return;
+
+	ConstBytePtr buffer = mem.GetBuffer();
+	uint size = mem.GetSize();
+	uint version, count;
+
+	// Files saved by a different version of the engine are ignored
+	if (size < 4 || memcmp(buffer, CACHE_TAG, 4) != 0) return;
+	buffer += 4;
+	size -= 4;
+
+	if (!Memory::Extract(buffer, size, version) || version != CACHE_VERSION) return;
+	if (!Memory::Extract(buffer, size, count)) return;
+
+	GLShaderCache::Key key;
+	uint flags;
+	String code;
+
+	for (uint i = 0; i < count; ++i)
+	{
+		if (!Memory::Extract(buffer, size, key) ||
+			!Memory::Extract(buffer, size, flags) ||
+			!Memory::Extract(buffer, size, code)) break;
+
+		// Entries added before the file was loaded take precedence
+		if (g_cacheIndex.GetIfExists(FoldKey(key)) == 0) AddEntry(key, code, flags);
+	}
+}
+
+//============================================================================================================
+// Calculates the key of the specified shader variation
+//============================================================================================================
+
+GLShaderCache::Key GLShaderCache::GetKey (const String& full, const String& variation, const Flags& flags)
+{
+	Key key = 0xCBF29CE484222325ULL;
+	uint values[3] = { flags.Get(), g_caps.mVersion, CACHE_VERSION };
+
+	HashBytes(key, full.GetBuffer(), full.GetLength());
+	HashBytes(key, variation.GetBuffer(), variation.GetLength());
+	HashBytes(key, values, sizeof(values));
+	return key;
+}
+
+//============================================================================================================
+// Retrieves the preprocessed variation with the specified key, if it has been cached
+//============================================================================================================
+
+bool GLShaderCache::Get (Key key, String& code, Flags& final)
+{
+	bool retVal = false;
+
+	g_cacheLock.Lock();
+	{
+		if (!g_cacheLoaded) LoadCache();
+
+		const uint* index = g_cacheIndex.GetIfExists(FoldKey(key));
+
+		if (index != 0 && g_cache[*index].mKey == key)
+		{
+			const CacheEntry& entry = g_cache[*index];
+			code  = entry.mCode;
+			final = entry.mFlags;
+			retVal = true;
+			++g_cacheHits;
+		}
+		else ++g_cacheMisses;
+	}
+	g_cacheLock.Unlock();
+	return retVal;
+}
+
+//============================================================================================================
+// Adds a newly preprocessed variation to the cache
+//============================================================================================================
+
+void GLShaderCache::Set (Key key, const String& code, const Flags& final)
+{
+	g_cacheLock.Lock();
+	{
+		if (!g_cacheLoaded) LoadCache();
+		AddEntry(key, code, final.Get());
+		g_cacheChanged = true;
+	}
+	g_cacheLock.Unlock();
+}
+
+//============================================================================================================
+// File the cache is loaded from and saved to
+//============================================================================================================
+
+void GLShaderCache::SetFilename (const String& filename)
+{
+	g_cacheLock.Lock();
+	{
+		if (g_cacheFile != filename)
+		{
+			g_cacheFile = filename;
+			g_cacheLoaded = false;
+		}
+	}
+	g_cacheLock.Unlock();
+}
+
+//============================================================================================================
+
+const String& GLShaderCache::GetFilename() { return g_cacheFile; }
+
+//============================================================================================================
+// Saves the cache to its file if anything was added since it was loaded
+//============================================================================================================
+
+bool GLShaderCache::Save()
+{
+	bool retVal = true;
+
+	g_cacheLock.Lock();
+	{
+		if (g_cacheChanged && g_cacheFile.IsValid())
+		{
+			Memory mem;
+			mem.Append(CACHE_TAG, 4);
+			mem.Append((uint)CACHE_VERSION);
+			mem.Append(g_cache.GetSize());
+
+			FOREACH(i, g_cache)
+			{
+				const CacheEntry& entry = g_cache[i];
+				mem.Append(entry.mKey);
+				mem.Append(entry.mFlags);
+				mem.Append(entry.mCode);
+			}
+
+			retVal = mem.Save(g_cacheFile);
+			if (retVal) g_cacheChanged = false;
+		}
+	}
+	g_cacheLock.Unlock();
+	return retVal;
+}
+
+//============================================================================================================
+// Removes all cached variations
+//============================================================================================================
+
+void GLShaderCache::Clear()
+{
+	g_cacheLock.Lock();
+	{
+		g_cache.Clear();
+		g_cacheIndex.Clear();
+		g_cacheChanged = false;
+	}
+	g_cacheLock.Unlock();
+}
+
+//============================================================================================================
+// Number of threads used to preprocess all variations of a shader as soon as its code changes
+//============================================================================================================
+
+void GLShaderCache::SetThreads (uint count)	{ g_cacheThreads = count; }
+uint GLShaderCache::GetThreads()			{ return g_cacheThreads; }
+
+//============================================================================================================
+// Number of variations found in the cache and preprocessed from scratch so far
+//============================================================================================================
+
+uint GLShaderCache::GetHits()	{ return g_cacheHits; }
+uint GLShaderCache::GetMisses()	{ return g_cacheMisses; }
@@ -5,6 +5,7 @@ using namespace R5;
 // External functions
 extern uint GLGetInternalShaderCode (String& code, const String& name);
 extern Flags GLPreprocessShader (const String& surface, String& code, const Flags& desired);
+extern void GLInitShaderPreprocessor();
 
 GLShaderProgram* g_lastProgram = 0;
 
@@ -26,6 +27,7 @@ bool GLSurfaceShader::Activate (const ITechnique* tech)
 		mIsDirty = false;
 		mPrograms.Release();
 		mComponents.Release();
+		if (!mHasErrors) Preprocess();
 	}
 
 	if (!mHasErrors)
@@ -177,8 +179,89 @@ Flags GLSurfaceShader::GetVariation (String& out, const Flags& flags) const
 	}
 	String full;
 	mCode.SerializeTo(full);
-	return ::GLPreprocessShader(full, out, flags);
-}
+
+	// Preprocessing is slow, so reuse the result of a previous run if possible
+	GLShaderCache::Key key = GLShaderCache::GetKey(full, out, flags);
+	Flags final;
+
+	if (!GLShaderCache::Get(key, out, final))
+	{
+		final = ::GLPreprocessShader(full, out, flags);
+		GLShaderCache::Set(key, out, final);
+	}
+	return final;
+}
+
+//============================================================================================================
+// Preprocesses all variations of the shader on multiple threads, filling the shader cache
+//============================================================================================================
+
+struct GLSurfaceShader::PreprocessJob
+{
+	const GLSurfaceShader*	mShader;
+	const Array<Flags>*		mVariations;
+
+	void Run (uint index)
+	{
+		String code;
+		mShader->GetVariation(code, (*mVariations)[index]);
+	}
+};
+
+//============================================================================================================
+
+void GLSurfaceShader::Preprocess() const
+{
+	uint threads = GLShaderCache::GetThreads();
+	if (threads == 0) return;
+
+	// Every combination of flags Activate() can request
+	Array<Flags> desired;
+
+	if (mBasicFlags.Get(IShader::Flag::Surface))
+	{
+		desired.Expand() = IShader::Flag::Deferred;
+		desired.Expand() = IShader::Flag::DepthOnly;
+
+		for (uint i = 0; i < 2; ++i)
+		{
+			Flags fog;
+			fog.Set(IShader::Flag::Fog, i == 1);
+
+			desired.Expand() = fog;
+			desired.Expand() = fog | IShader::Flag::DirLight;
+			desired.Expand() = fog | IShader::Flag::DirLight | IShader::Flag::Shadowed;
+			desired.Expand() = fog | IShader::Flag::PointLight;
+		}
+	}
+	else desired.Expand() = 0;
+
+	// Each combination gets a variation for every stage present in the code
+	Array<Flags> variations;
+
+	FOREACH(i, desired)
+	{
+		const Flags& flags = desired[i];
+		if (mBasicFlags.Get(IShader::Flag::Vertex))		variations.Expand() = flags | IShader::Flag::Vertex;
+		if (mBasicFlags.Get(IShader::Flag::Fragment))	variations.Expand() = flags | IShader::Flag::Fragment;
+		if (mBasicFlags.Get(IShader::Flag::Geometry))	variations.Expand() = flags | IShader::Flag::Geometry;
+	}
+
+	::GLInitShaderPreprocessor();
+
+	PreprocessJob job;
+	job.mShader		= this;
+	job.mVariations	= &variations;
+
+	if (threads > 1 && variations.GetSize() > 1)
+	{
+		Thread::ParallelFor(variations.GetSize(), bind(&PreprocessJob::Run, &job), threads - 1);
+	}
+	else
+	{
+		for (uint i = 0; i < variations.GetSize(); ++i) job.Run(i);
+	}
+}
 
 //============================================================================================================
 // Gets or creates a shader program given the specified set of flags
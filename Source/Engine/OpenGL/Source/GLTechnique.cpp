@@ -3,7 +3,7 @@
 using namespace R5;
 
 //============================================================================================================
-// Default group properties are that of a solid object group
+// Default group properties are that of a solid object group, with presets for common techniques
 //============================================================================================================
 
 GLTechnique::GLTechnique (const String& name) :
@@ -28,8 +28,144 @@ GLTechnique::GLTechnique (const String& name) :
 		mIndex = 0;
 		WARNING("Number of unique techniques exceeded implementation limits! (32)");
 	}
+
+	// Several commonly used techniques come with presets
+	if (name == "Depth")
+	{
+		SetFog(false);
+		SetColorWrite(false);
+		SetAlphaTest(true);
+		SetLighting(ITechnique::Lighting::None);
+		SetBlending(ITechnique::Blending::None);
+	}
+	else if (name == "Glow")
+	{
+		// Glow is drawn with no depth writing, using additive blending and no lighting
+		SetFog(false);
+		SetDepthWrite(false);
+		SetAlphaTest(false);
+		SetBlending(ITechnique::Blending::Add);
+		SetLighting(ITechnique::Lighting::None);
+		SetSorting(ITechnique::Sorting::BackToFront);
+	}
+	else if (name == "Glare")
+	{
+		// Glare is drawn last, as it goes on top of everything and doesn't use depth, blending or lighting
+		SetFog(false);
+		SetDepthWrite(false);
+		SetDepthTest(false);
+		SetAlphaTest(false);
+		SetBlending(ITechnique::Blending::Add);
+		SetLighting(ITechnique::Lighting::None);
+		SetSorting(ITechnique::Sorting::BackToFront);
+	}
+	else if (name == "Particle")
+	{
+		SetDepthWrite(false);
+		SetLighting(ITechnique::Lighting::None);
+		SetSorting(ITechnique::Sorting::BackToFront);
+	}
+	else if (name == "Post Process")
+	{
+		SetFog(false);
+		SetDepthWrite(false);
+		SetDepthTest(false);
+		SetAlphaTest(false);
+		SetLighting(IGraphics::Lighting::None);
+		SetBlending(IGraphics::Blending::None);
+	}
+	else if (name == "Deferred")
+	{
+		SetFlag(ITechnique::Flag::Deferred, true);
+		SetFog(false);
+		SetLighting(IGraphics::Lighting::None);
+		SetBlending(IGraphics::Blending::None);
+	}
+	else if (name == "Decal")
+	{
+		SetFog(false);
+		SetDepthWrite(false);
+		SetLighting(IGraphics::Lighting::None);
+		SetBlending(IGraphics::Blending::None);
+	}
+	else if (name == "Projected Texture")
+	{
+		SetFog(false);
+		SetDepthWrite(false);
+		SetLighting(IGraphics::Lighting::None);
+		SetBlending(IGraphics::Blending::Replace);
+	}
+
+	// Wireframe technique
+	if (name.Contains("Wireframe"))
+	{
+		SetFog(false);
+		SetLighting(IGraphics::Lighting::None);
+		SetBlending(IGraphics::Blending::None);
+		SetWireframe(true);
+	}
+
+	// Solid material group -- no alpha testing or blending needed
+	if (name.Contains("Opaque"))
+	{
+		SetAlphaTest(false);
+		SetBlending(ITechnique::Blending::None);
+	}
+	else if (name.Contains("Transparent"))
+	{
+		// Group for objects with transparency, drawn after solids -- default everything
+		SetSorting(ITechnique::Sorting::BackToFront);
+	}
+
+	if (name.Contains("Shadowed"))
+	{
+		SetFlag(ITechnique::Flag::Shadowed, true);
+	}
+
+	// Newly created techniques should not be serializable until something changes
+	mSerializable = false;
 }
 
+//============================================================================================================
+// Tags recognized by GLTechnique::SerializeFrom(), in the same order as the values below
+//============================================================================================================
+
+struct TechniqueTag
+{
+	enum
+	{
+		Fog,
+		DepthWrite,
+		DepthTest,
+		ColorWrite,
+		AlphaTest,
+		Wireframe,
+		Serializable,
+		Lighting,
+		Blending,
+		Culling,
+		Sorting,
+	};
+};
+
+const char* g_techniqueTags[] =
+{
+	"Fog",
+	"Depth Write",
+	"Depth Test",
+	"Color Write",
+	"Alpha Test",
+	"Wireframe",
+	"Serializable",
+	"Lighting",
+	"Blending",
+	"Culling",
+	"Sorting",
+	0
+};
+
+TagMap g_techniqueTagMap (g_techniqueTags);
+
 //============================================================================================================
 // Serialization -- Load
 //============================================================================================================
@@ -41,46 +177,56 @@ bool GLTechnique::SerializeFrom (const TreeNode& root, bool forceUpdate)
 	for (uint i = 0; i < root.mChildren.GetSize(); ++i)
 	{
 		const TreeNode& node  = root.mChildren[i];
-		const String&	tag   = node.mTag;
 		const Variable&	value = node.mValue;
+		const String&	s	  = value.AsString();
 
-		if		(tag == "Fog")			value >> mFog;
-		else if (tag == "Depth Write")	value >> mDepthWrite;
-		else if (tag == "Depth Test")	value >> mDepthTest;
-		else if (tag == "Color Write")	value >> mColorWrite;
-		else if (tag == "Alpha Test")	value >> mAlphaTest;
-		else if (tag == "Wireframe")	value >> mWireframe;
-		else if (tag == "Serializable") value >> mSerializable;
-		else if (value.IsString())
+		switch (g_techniqueTagMap[node])
 		{
-			const String& s (value.AsString());
+			case TechniqueTag::Fog:				value >> mFog;			break;
+			case TechniqueTag::DepthWrite:		value >> mDepthWrite;	break;
+			case TechniqueTag::DepthTest:		value >> mDepthTest;	break;
+			case TechniqueTag::ColorWrite:		value >> mColorWrite;	break;
+			case TechniqueTag::AlphaTest:		value >> mAlphaTest;	break;
+			case TechniqueTag::Wireframe:		value >> mWireframe;	break;
+			case TechniqueTag::Serializable:	value >> mSerializable;	break;
 
-			if (tag == "Lighting")
+			case TechniqueTag::Lighting:
 			{
-				if		(s == "One-sided")	mLighting = Lighting::OneSided;
-				else if (s == "Two-sided")	mLighting = Lighting::TwoSided;
-				else						mLighting = Lighting::None;
+				if (!value.IsString())			break;
+				if		(s == "One-sided")		mLighting = Lighting::OneSided;
+				else if (s == "Two-sided")		mLighting = Lighting::TwoSided;
+				else							mLighting = Lighting::None;
 			}
-			else if (tag == "Blending")
+			break;
+
+			case TechniqueTag::Blending:
 			{
-				if		(s == "Replace")	mBlending = Blending::Replace;
-				else if (s == "Modulate")	mBlending = Blending::Modulate;
-				else if (s == "Add")		mBlending = Blending::Add;
-				else if (s == "Subtract")	mBlending = Blending::Subtract;
-				else						mBlending = Blending::None;
+				if (!value.IsString())			break;
+				if		(s == "Replace")		mBlending = Blending::Replace;
+				else if (s == "Modulate")		mBlending = Blending::Modulate;
+				else if (s == "Add")			mBlending = Blending::Add;
+				else if (s == "Subtract")		mBlending = Blending::Subtract;
+				else							mBlending = Blending::None;
 			}
-			else if (tag == "Culling")
+			break;
+
+			case TechniqueTag::Culling:
 			{
-				if		(s == "Front")		mCulling = Culling::Front;
-				else if (s == "Back")		mCulling = Culling::Back;
-				else						mCulling = Culling::None;
+				if (!value.IsString())			break;
+				if		(s == "Front")			mCulling = Culling::Front;
+				else if (s == "Back")			mCulling = Culling::Back;
+				else							mCulling = Culling::None;
 			}
-			else if (tag == "Sorting")
+			break;
+
+			case TechniqueTag::Sorting:
 			{
+				if (!value.IsString())			break;
 				if		(s == "Back to Front")	mSorting = Sorting::BackToFront;
 				else if	(s == "Front to Back")	mSorting = Sorting::FrontToBack;
 				else							mSorting = Sorting::None;
 			}
+			break;
 		}
 	}
 	return true;
@@ -125,7 +125,9 @@ uint Generate2DMipmap (uint glType, const DataType* buffer, uint width, uint hei
 	if (w == 0) w = 1;
 	if (h == 0) h = 1;
 
-	Array<DataType> temp;
+	// The downsampled level is only needed until it's uploaded and used to create the next one
+	Arena::Scope scope (FrameArena::Get());
+	Array<DataType> temp (FrameArena::Get());
 	temp.ExpandTo(w * h * channels);
 	uint bl, br, tl, tr, idx;
 	SumType sum;
@@ -1306,6 +1308,48 @@ bool GLTexture::SerializeTo (TreeNode& root) const
 	return true;
 }
 
+//============================================================================================================
+// Tags recognized by GLTexture::SerializeFrom(), in the same order as the values below
+//============================================================================================================
+
+struct TextureTag
+{
+	enum
+	{
+		Source,
+		PositiveX,
+		NegativeX,
+		PositiveY,
+		NegativeY,
+		PositiveZ,
+		NegativeZ,
+		Serializable,
+		Format,
+		Filtering,
+		WrapMode,
+		CompareMode,
+	};
+};
+
+const char* g_textureTags[] =
+{
+	"Source",
+	"Positive X",
+	"Negative X",
+	"Positive Y",
+	"Negative Y",
+	"Positive Z",
+	"Negative Z",
+	"Serializable",
+	"Format",
+	"Filtering",
+	"Wrap Mode",
+	"Compare Mode",
+	0
+};
+
+TagMap g_textureTagMap (g_textureTags);
+
 //============================================================================================================
 // Serialization -- loading
 //============================================================================================================
@@ -1328,24 +1372,24 @@ bool GLTexture::SerializeFrom (const TreeNode& root, bool forceUpdate)
 		for (uint i = 0; i < root.mChildren.GetSize(); ++i)
 		{
 			const TreeNode& node  = root.mChildren[i];
-			const String&	tag   = node.mTag;
 			const Variable&	value = node.mValue;
+			const String&	s	  = value.AsString();
 
-			if		(tag == "Source")		value >> file[0];
-			else if (tag == "Positive X")	value >> file[0];	// GL_TEXTURE_CUBE_MAP_POSITIVE_X
-			else if (tag == "Negative X")	value >> file[1];	// GL_TEXTURE_CUBE_MAP_NEGATIVE_X
-			else if (tag == "Positive Y")	value >> file[2];	// GL_TEXTURE_CUBE_MAP_POSITIVE_Y
-			else if (tag == "Negative Y")	value >> file[3];	// GL_TEXTURE_CUBE_MAP_NEGATIVE_Y
-			else if (tag == "Positive Z")	value >> file[4];	// GL_TEXTURE_CUBE_MAP_POSITIVE_Z
-			else if (tag == "Negative Z")	value >> file[5];	// GL_TEXTURE_CUBE_MAP_NEGATIVE_Z
-			else if (tag == "Serializable") value >> mSerializable;
-			else if (value.IsString())
+			switch (g_textureTagMap[node])
 			{
-				const String& s = value.AsString();
-				if		(tag == "Format")		format			= ITexture::StringToFormat(s);
-				else if (tag == "Filtering")	mFilter			= ITexture::StringToFilter(s);
-				else if (tag == "Wrap Mode")	mWrapMode		= ITexture::StringToWrapMode(s);
-				else if (tag == "Compare Mode")	mCompareMode	= ITexture::StringToCompareMode(s);
+				case TextureTag::Source:		value >> file[0];	break;
+				case TextureTag::PositiveX:		value >> file[0];	break;	// GL_TEXTURE_CUBE_MAP_POSITIVE_X
+				case TextureTag::NegativeX:		value >> file[1];	break;	// GL_TEXTURE_CUBE_MAP_NEGATIVE_X
+				case TextureTag::PositiveY:		value >> file[2];	break;	// GL_TEXTURE_CUBE_MAP_POSITIVE_Y
+				case TextureTag::NegativeY:		value >> file[3];	break;	// GL_TEXTURE_CUBE_MAP_NEGATIVE_Y
+				case TextureTag::PositiveZ:		value >> file[4];	break;	// GL_TEXTURE_CUBE_MAP_POSITIVE_Z
+				case TextureTag::NegativeZ:		value >> file[5];	break;	// GL_TEXTURE_CUBE_MAP_NEGATIVE_Z
+				case TextureTag::Serializable:	value >> mSerializable;	break;
+
+				case TextureTag::Format:		if (value.IsString()) format		= ITexture::StringToFormat(s);		break;
+				case TextureTag::Filtering:		if (value.IsString()) mFilter		= ITexture::StringToFilter(s);		break;
+				case TextureTag::WrapMode:		if (value.IsString()) mWrapMode		= ITexture::StringToWrapMode(s);	break;
+				case TextureTag::CompareMode:	if (value.IsString()) mCompareMode	= ITexture::StringToCompareMode(s);	break;
 			}
 		}
 
@@ -153,7 +153,7 @@ void GLTransform::SetTargetSize (Vector2i size)
 		mProj.SetAspect((float)size.x / size.y);
 
 		// Update the OpenGL viewport
-		glViewport(0, 0, size.x, size.y);
+		if (!mHeadless) glViewport(0, 0, size.x, size.y);
 
 		// If we're in 2D mode, reset the matrices next time we draw
 		if (mIs2D) mReset = true;
@@ -300,13 +300,16 @@ uint GLTransform::Activate (const IShader* shader)
 	{
 		if (mReset)
 		{
-			Matrix43 mat (mSize.x, mSize.y);
+			if (!mHeadless)
+			{
+				Matrix43 mat (mSize.x, mSize.y);
 
-			glMatrixMode(GL_MODELVIEW);
-			glLoadIdentity();
+				glMatrixMode(GL_MODELVIEW);
+				glLoadIdentity();
 
-			glMatrixMode(GL_PROJECTION);
-			glLoadMatrixf(mat.mF);
+				glMatrixMode(GL_PROJECTION);
+				glLoadMatrixf(mat.mF);
+			}
 			++switches;
 		}
 	}
@@ -320,23 +323,41 @@ uint GLTransform::Activate (const IShader* shader)
 			mProj.changed   = true;
 		}
 
-		if (mProj.changed)
+		if (mHeadless)
 		{
-			glMatrixMode(GL_PROJECTION);
-			glLoadMatrixf(GetProjectionMatrix().mF);
-			++switches;
-		}
-
-		if (mModel.changed || mView.changed)
-		{
-			glMatrixMode(GL_MODELVIEW);
-			glLoadMatrixf(GetModelViewMatrix().mF);
-			++switches;
+			// Matrices are still calculated so that the CPU cost matches the real thing
+			if (mProj.changed)
+			{
+				GetProjectionMatrix();
+				++switches;
+			}
+
+			if (mModel.changed || mView.changed)
+			{
+				GetModelViewMatrix();
+				++switches;
+			}
 		}
-		else if (mProj.changed)
+		else
 		{
-			// Always end with ModelView
-			glMatrixMode(GL_MODELVIEW);
+			if (mProj.changed)
+			{
+				glMatrixMode(GL_PROJECTION);
+				glLoadMatrixf(GetProjectionMatrix().mF);
+				++switches;
+			}
+
+			if (mModel.changed || mView.changed)
+			{
+				glMatrixMode(GL_MODELVIEW);
+				glLoadMatrixf(GetModelViewMatrix().mF);
+				++switches;
+			}
+			else if (mProj.changed)
+			{
+				// Always end with ModelView
+				glMatrixMode(GL_MODELVIEW);
+			}
 		}
 
 		// Reset the 'changed' flags on all matrices
@@ -0,0 +1,1251 @@
+#include "../Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Command names, in the same order as NullGraphics::Command types
+//============================================================================================================
+
+const char* g_commandNames[] =
+{
+	"Fog",
+	"Depth Write",
+	"Depth Test",
+	"Color Write",
+	"Alpha Test",
+	"Stencil Test",
+	"Scissor Test",
+	"Wireframe",
+	"Lighting",
+	"Blending",
+	"Culling",
+	"Depth Function",
+	"Stencil Function",
+	"Stencil Operation",
+	"Viewport",
+	"Render Target",
+	"Technique",
+	"Material",
+	"Shader",
+	"Texture",
+	"VBO",
+	"Matrices",
+	"Clear",
+	"Draw",
+	"Drawable",
+	"Query",
+};
+
+//============================================================================================================
+// Number of triangles drawn using the specified primitive, matching GLController's count
+//============================================================================================================
+
+inline uint CountTriangles (uint primitive, uint vertexCount)
+{
+	switch (primitive)
+	{
+		case IGraphicsManager::Primitive::Triangle:			return vertexCount / 3;
+		case IGraphicsManager::Primitive::TriangleStrip:	return vertexCount > 1 ? vertexCount - 2 : 0;
+		case IGraphicsManager::Primitive::Quad:				return vertexCount / 2;
+		case IGraphicsManager::Primitive::QuadStrip:		return vertexCount > 1 ? vertexCount - 2 : 0;
+		case IGraphicsManager::Primitive::TriangleFan:		return vertexCount > 1 ? vertexCount - 2 : 0;
+		case IGraphicsManager::Primitive::Line:				return vertexCount / 2;
+		case IGraphicsManager::Primitive::LineStrip:		return vertexCount > 0 ? vertexCount - 1 : 0;
+		case IGraphicsManager::Primitive::Point:			return vertexCount;
+	}
+	return 0;
+}
+
+//============================================================================================================
+
+NullGraphics::NullGraphics() :
+	mIsValid		(false),
+	mRecord			(false),
+	mFog			(false),
+	mDepthWrite		(false),
+	mDepthTest		(false),
+	mColorWrite		(true),
+	mAlphaTest		(false),
+	mStencilTest	(false),
+	mScissorTest	(false),
+	mWireframe		(false),
+	mMatIsDirty		(true),
+	mLighting		(Lighting::None),
+	mBlending		(Blending::None),
+	mCulling		(Culling::None),
+	mAdt			(0.0f),
+	mThickness		(1.0f),
+	mAf				(0),
+	mDepthFunc		(Condition::Less),
+	mTarget			(0),
+	mTechnique		(0),
+	mMaterial		(0),
+	mShader			(0),
+	mSkybox			(0),
+	mShadowmap		(0),
+	mQueryDelay		(0),
+	mFrame			(0)
+{
+	mTrans.SetHeadless(true);
+
+	// Pretend to be a capable videocard so that none of the fallback paths get used
+	mCaps.mVersion					= 300;
+	mCaps.mFloat16Format			= true;
+	mCaps.mFloat32Format			= true;
+	mCaps.mBufferObjects			= true;
+	mCaps.mDrawBuffers				= true;
+	mCaps.mDepthStencil				= true;
+	mCaps.mDXTCompression			= true;
+	mCaps.mDepthAttachments			= true;
+	mCaps.mAlphaAttachments			= true;
+	mCaps.mMixedAttachments			= true;
+	mCaps.mShaders					= true;
+	mCaps.mHalfFloatVertex			= true;
+	mCaps.mMaxTextureUnits_FFP		= TextureUnits;
+	mCaps.mMaxTextureUnits_Shader	= TextureUnits;
+	mCaps.mMaxTextureCoords			= TextureUnits;
+	mCaps.mMaxTextureSize			= 8192;
+	mCaps.mMaxLights				= 8;
+	mCaps.mMaxFBOAttachments		= 4;
+	mCaps.mMaxAnisotropicLevel		= 16;
+
+	mVBO[0] = 0;
+	mVBO[1] = 0;
+	mVBO[2] = 0;
+
+	for (uint i = 0; i < TextureUnits; ++i)
+	{
+		mNextTex[i] = 0;
+		mBoundTex[i] = 0;
+	}
+}
+
+//============================================================================================================
+// Human-readable name of the specified command type
+//============================================================================================================
+
+const char* NullGraphics::GetCommandName (uint type)
+{
+	return (type < Command::Count) ? g_commandNames[type] : "Unknown";
+}
+
+//============================================================================================================
+// Counts the triangles and records the draw call
+//============================================================================================================
+
+uint NullGraphics::_Draw (uint primitive, uint count)
+{
+	uint triangles = CountTriangles(primitive, count);
+
+	if (triangles > 0)
+	{
+		PrepareToDraw();
+		mStats.mTriangles += triangles;
+		++mStats.mDrawCalls;
+		_Record(Command::Draw, triangles, primitive);
+	}
+	return triangles;
+}
+
+//============================================================================================================
+// State control functions mirror GLController, including invalidating the active technique
+//============================================================================================================
+
+void NullGraphics::SetFog (bool val)
+{
+	if (mFogRange.x == mFogRange.y) val = false;
+
+	if (mFog != val)
+	{
+		mTechnique = 0;
+		_Record(Command::Fog, mFog = val);
+	}
+}
+
+//============================================================================================================
+
+void NullGraphics::SetDepthWrite (bool val)
+{
+	if (mDepthWrite != val)
+	{
+		if (val)
+		{
+			val = (mTarget == 0 || mTarget->HasDepth());
+			if (mDepthWrite == val) return;
+		}
+
+		mTechnique = 0;
+		_Record(Command::DepthWrite, mDepthWrite = val);
+	}
+}
+
+//============================================================================================================
+
+void NullGraphics::SetDepthTest (bool val)
+{
+	if (mDepthTest != val)
+	{
+		mTechnique = 0;
+		_Record(Command::DepthTest, mDepthTest = val);
+	}
+}
+
+//============================================================================================================
+
+void NullGraphics::SetColorWrite (bool val)
+{
+	if (mColorWrite != val)
+	{
+		mTechnique = 0;
+		_Record(Command::ColorWrite, mColorWrite = val);
+	}
+}
+
+//============================================================================================================
+
+void NullGraphics::SetAlphaTest (bool val)
+{
+	if (mAlphaTest != val)
+	{
+		mTechnique = 0;
+		_Record(Command::AlphaTest, mAlphaTest = val);
+	}
+}
+
+//============================================================================================================
+
+void NullGraphics::SetStencilTest (bool val)
+{
+	if (mStencilTest != val)
+	{
+		_Record(Command::StencilTest, mStencilTest = val);
+	}
+}
+
+//============================================================================================================
+
+void NullGraphics::SetScissorTest (bool val)
+{
+	if (mScissorTest != val)
+	{
+		_Record(Command::ScissorTest, mScissorTest = val);
+	}
+}
+
+//============================================================================================================
+
+void NullGraphics::SetWireframe (bool val)
+{
+	if (mWireframe != val)
+	{
+		mTechnique = 0;
+		_Record(Command::Wireframe, mWireframe = val);
+	}
+}
+
+//============================================================================================================
+
+void NullGraphics::SetLighting (uint val)
+{
+	if (mLighting != val)
+	{
+		mTechnique = 0;
+		_Record(Command::Lighting, mLighting = (byte)val);
+	}
+}
+
+//============================================================================================================
+
+void NullGraphics::SetBlending (uint val)
+{
+	if (mBlending != val)
+	{
+		mTechnique = 0;
+		_Record(Command::Blending, mBlending = (byte)val);
+	}
+}
+
+//============================================================================================================
+
+void NullGraphics::SetCulling (uint val)
+{
+	if (mCulling != val)
+	{
+		mTechnique = 0;
+		_Record(Command::Culling, mCulling = (byte)val);
+	}
+}
+
+//============================================================================================================
+
+void NullGraphics::SetAlphaCutoff (float val)
+{
+	if (mAlphaTest && Float::IsNotEqual(mAdt, val))
+	{
+		mMatIsDirty = true;
+		mAdt = val;
+	}
+}
+
+//============================================================================================================
+
+void NullGraphics::SetViewport (const Vector2i& size)
+{
+	if (mSize != size)
+	{
+		mSize = size;
+		if (mTarget == 0) mTrans.SetTargetSize(mSize);
+		_Record(Command::Viewport, ((uint)(ushort)size.x << 16) | (ushort)size.y);
+	}
+}
+
+//============================================================================================================
+// Retrieves the current light's properties
+//============================================================================================================
+
+const ILight& NullGraphics::GetActiveLight (uint index) const
+{
+	if (mLu.IsEmpty()) mLu.ExpandTo( mCaps.mMaxLights );
+	return (index < mLu.GetSize()) ? mLu[index] : mLu[0];
+}
+
+//============================================================================================================
+// Activates and/or changes light properties for the specified light
+//============================================================================================================
+
+void NullGraphics::SetActiveLight (uint index, const ILight* light)
+{
+	if (mLu.IsEmpty()) mLu.ExpandTo( mCaps.mMaxLights );
+	ILight& dest = (index < mLu.GetSize()) ? mLu[index] : mLu[0];
+
+	if (light)
+	{
+		dest = *light;
+
+		if (dest.mType != ILight::Type::Point)
+		{
+			dest.mDir %= GetModelMatrix();
+			dest.mDir %= GetViewMatrix();
+		}
+
+		if (dest.mType != ILight::Type::Directional)
+		{
+			dest.mPos *= GetModelMatrix();
+			dest.mPos *= GetViewMatrix();
+		}
+	}
+	else
+	{
+		dest.mType = ILight::Type::Invalid;
+	}
+}
+
+//============================================================================================================
+// Convenience function -- sets the view matrix
+//============================================================================================================
+
+void NullGraphics::SetCameraOrientation (const Vector3f& eye, const Vector3f& dir, const Vector3f& up)
+{
+	mTrans.CancelModelMatrixOverride();
+	mTrans.CancelViewMatrixOverride();
+	mTrans.SetViewMatrix(eye, dir, up);
+}
+
+//============================================================================================================
+// Convenience function -- sets the projection matrix
+//============================================================================================================
+
+void NullGraphics::SetCameraRange (const Vector3f& range)
+{
+	mTrans.CancelProjectionMatrixOverride();
+	mTrans.SetProjectionRange(range);
+}
+
+//============================================================================================================
+// Changes the active render target
+//============================================================================================================
+
+void NullGraphics::SetActiveRenderTarget (const IRenderTarget* tar)
+{
+	if (mTarget != tar)
+	{
+		// Visibility tests are issued against the active target before it changes, same as with OpenGL
+		_IssueQueries();
+
+		// Textures must be bound prior to switching render targets, same as with OpenGL
+		PrepareToDraw();
+
+		mTarget = tar;
+		mTrans.SetTargetSize(tar != 0 ? tar->GetSize() : mSize);
+		_Record(Command::RenderTarget, tar != 0 ? ((const NullRenderTarget*)tar)->GetID() : 0);
+	}
+}
+
+//============================================================================================================
+// Activates the specified technique
+//============================================================================================================
+
+void NullGraphics::SetActiveTechnique (const ITechnique* ptr, bool insideOut)
+{
+	if (ptr != 0)
+	{
+		byte culling = ptr->GetCulling();
+
+		if (insideOut)
+		{
+			if		(culling == Culling::Front)	culling = Culling::Back;
+			else if (culling == Culling::Back)	culling = Culling::Front;
+		}
+
+		if (mTechnique == ptr)
+		{
+			// Same technique as last time, but culling might be inverted
+			if (mCulling != culling) SetCulling(culling);
+		}
+		else
+		{
+			SetFog			( ptr->GetFog()			);
+			SetDepthWrite	( ptr->GetDepthWrite()	);
+			SetDepthTest	( ptr->GetDepthTest()	);
+			SetColorWrite	( ptr->GetColorWrite()	);
+			SetAlphaTest	( ptr->GetAlphaTest()	);
+			SetWireframe	( ptr->GetWireframe()	);
+			SetLighting		( ptr->GetLighting()	);
+			SetBlending		( ptr->GetBlending()	);
+			SetCulling		( culling				);
+
+			mMatIsDirty = true;
+			++mStats.mTechSwitches;
+			_Record(Command::Technique, ptr->GetMask());
+		}
+	}
+	mTechnique = ptr;
+}
+
+//============================================================================================================
+// Activates the specified material
+//============================================================================================================
+
+bool NullGraphics::SetActiveMaterial (const IMaterial* ptr)
+{
+	if (mMaterial != ptr || mMatIsDirty)
+	{
+		mMatIsDirty = false;
+
+		// If the material is invisible under the current technique, consider options to be invalid
+		const IMaterial::DrawMethod* ren = ( (ptr != 0 && mTechnique != 0) ?
+			ptr->GetVisibleMethod(mTechnique) : 0 );
+
+		if (ren == 0)
+		{
+			for (uint i = TextureUnits; i > 0; )
+				SetActiveTexture(--i, 0);
+
+			SetAlphaCutoff(0.003921568627451f);
+			SetActiveShader(0);
+			return false;
+		}
+
+		if (mMaterial != ptr) _Record(Command::Material, ptr->GetUID());
+		mMaterial = ptr;
+
+		SetAlphaCutoff( ptr->GetAlphaCutoff() * ptr->GetDiffuse().a );
+		SetActiveShader(ren->mShader);
+
+		ren->mTextures.Lock();
+		{
+			// The shadow map always goes into the last texture unit, just like with GLController
+			if (mShader != 0 && mShader->GetFlag(IShader::Flag::Shadowed))
+			{
+				if (mShadowmap == 0) mShadowmap = GetTexture("R5_shadowMap");
+				SetActiveTexture(ShadowUnit, mShadowmap);
+			}
+			else
+			{
+				SetActiveTexture(ShadowUnit, 0);
+			}
+
+			uint lastTex = ren->mTextures.GetSize();
+
+			for (uint i = ShadowUnit; i > 0; )
+			{
+				const ITexture* tex = (--i < lastTex) ? ren->mTextures[i] : 0;
+				SetActiveTexture(i, tex);
+			}
+		}
+		ren->mTextures.Unlock();
+	}
+	return true;
+}
+
+//============================================================================================================
+// Activates this texture on Texture Unit 0, and disables all other texture units
+//============================================================================================================
+
+bool NullGraphics::SetActiveMaterial (const ITexture* ptr)
+{
+	for (uint i = TextureUnits; i > 1; )
+		SetActiveTexture(--i, 0);
+
+	SetActiveTexture(0, ptr);
+	mMatIsDirty = true;
+	return (ptr != 0 && ptr->IsValid());
+}
+
+//============================================================================================================
+// Changes the currently active shader
+//============================================================================================================
+
+bool NullGraphics::SetActiveShader (const IShader* ptr)
+{
+	if (mShader != ptr)
+	{
+		mShader = ptr;
+		mMatIsDirty = true;
+		if (ptr != 0) ++mStats.mShaderSwitches;
+		_Record(Command::Shader, ptr != 0 ? ptr->GetUID() : 0);
+	}
+	return true;
+}
+
+//============================================================================================================
+// Activates the vertex buffer object
+//============================================================================================================
+
+void NullGraphics::SetActiveVBO (const IVBO* ptr, uint type)
+{
+	if (ptr != 0) type = ptr->GetType();
+
+	if (type < 3 && mVBO[type] != ptr)
+	{
+		mVBO[type] = ptr;
+		if (ptr != 0) ++mStats.mBufferBinds;
+		_Record(Command::VBO, ptr != 0 ? ptr->GetID() : 0, type);
+	}
+}
+
+//============================================================================================================
+// Sets the active texture on the specified texture unit
+//============================================================================================================
+
+void NullGraphics::SetActiveTexture (uint textureUnit, const ITexture* tex)
+{
+	if (textureUnit < TextureUnits)
+	{
+		mNextTex[textureUnit] = const_cast<ITexture*>(tex);
+		mMatIsDirty = true;
+	}
+}
+
+//============================================================================================================
+// Sets the active depth buffer comparison function
+//============================================================================================================
+
+void NullGraphics::SetActiveDepthFunction (uint condition)
+{
+	if (mDepthFunc != condition)
+	{
+		_Record(Command::DepthFunction, mDepthFunc = condition);
+	}
+}
+
+//============================================================================================================
+// Only the vertex buffer is tracked -- the data itself is never read
+//============================================================================================================
+
+void NullGraphics::SetActiveVertexAttribute (
+	uint		attribute,
+	const IVBO*	vbo,
+	const void*	ptr,
+	uint		dataType,
+	uint		elements,
+	uint		stride )
+{
+	ASSERT(attribute < 16, "Invalid attribute");
+	if (vbo != 0) SetActiveVBO(vbo, IVBO::Type::Vertex);
+}
+
+//============================================================================================================
+// Activate all matrices and bind all textures, preparing to draw
+//============================================================================================================
+
+void NullGraphics::PrepareToDraw()
+{
+	uint switches = mTrans.Activate(mShader);
+
+	if (switches > 0)
+	{
+		mStats.mMatSwitches += switches;
+		_Record(Command::Matrices, switches);
+	}
+
+	for (uint i = TextureUnits; i > 0; )
+	{
+		uint id = (mNextTex[--i] != 0) ? mNextTex[i]->Activate() : 0;
+
+		if (mBoundTex[i] != id)
+		{
+			mBoundTex[i] = id;
+			if (id != 0) ++mStats.mTexSwitches;
+			_Record(Command::Texture, id, i);
+		}
+	}
+}
+
+//============================================================================================================
+// Converts screen coordinates to world coordinates. With no depth buffer, the depth is the far plane.
+//============================================================================================================
+
+Vector3f NullGraphics::ConvertTo3D (const Vector2i& v, bool unproject)
+{
+	Vector2i size ( mTarget ? mTarget->GetSize() : mSize );
+	Vector2i pos  ( v.x, mSize.y - v.y );
+
+	Vector3f out ((float)pos.x / size.x, (float)pos.y / size.y, 1.0f);
+	if (unproject) out = GetInverseMVPMatrix().Unproject(out);
+	return out;
+}
+
+//============================================================================================================
+// Converts world coordinates to screen coordinates
+//============================================================================================================
+
+Vector2i NullGraphics::ConvertTo2D (const Vector3f& v)
+{
+	Vector2i size ( mTarget != 0 ? mTarget->GetSize() : mSize );
+	Vector2i out  ( GetModelViewProjMatrix().Project(v) * size );
+	out.y = size.y - out.y;
+	return out;
+}
+
+//============================================================================================================
+// Initializes the graphics manager using the same default states as GLGraphics
+//============================================================================================================
+
+bool NullGraphics::Init (uint version)
+{
+	if (!mIsValid)
+	{
+		mIsValid = true;
+
+		SetDepthWrite	(true);
+		SetDepthTest	(true);
+		SetAlphaTest	(true);
+		SetAlphaCutoff	(0.003921568627451f);
+		SetBlending		(Blending::Replace);
+		SetCulling		(Culling::Back);
+		SetFogRange		(Vector2f(50.0f, 100.0f));
+		SetCameraRange	(Vector3f(0.3f, 100.0f, 90.0f));
+		SetFog			(true);
+	}
+	return true;
+}
+
+//============================================================================================================
+// Release all resources
+//============================================================================================================
+
+void NullGraphics::Release()
+{
+	if (mIsValid)
+	{
+		mIsValid = false;
+
+		mFonts.Release();
+		mShaders.Release();
+		mTempTex.Release();
+		mTextures.Release();
+		mMaterials.Release();
+		mTechs.Release();
+		mTargets.Release();
+		mVbos.Release();
+		mLog.Release();
+
+		Array<uint> queries;
+		mQueries.Release(queries);
+		mResults.Release();
+
+		// Call any pending callbacks
+		for (uint i = 0; i < mDelegates.GetSize(); ++i)
+		{
+			DelegateEntry& entry = mDelegates[i];
+			entry.callback(this, entry.param);
+		}
+		mDelegates.Release();
+	}
+}
+
+//============================================================================================================
+// Adds a delayed callback function that should be executed on the next frame (at BeginFrame)
+//============================================================================================================
+
+void NullGraphics::ExecuteBeforeNextFrame (const DelayedDelegate& callback, void* param)
+{
+	mDelegates.Lock();
+	{
+		DelegateEntry& entry = mDelegates.Expand();
+		entry.callback = callback;
+		entry.param = param;
+	}
+	mDelegates.Unlock();
+}
+
+//============================================================================================================
+// Clear the screen or the off-screen target, rendering the skybox if necessary
+//============================================================================================================
+
+void NullGraphics::Clear (bool color, bool depth, bool stencil)
+{
+	if (mTarget != 0)
+	{
+		if (!mTarget->HasColor())	color   = false;
+		if (!mTarget->HasDepth())	depth   = false;
+		if (!mTarget->HasStencil())	stencil = false;
+	}
+
+	if (!color && !depth && !stencil) return;
+
+	// Visibility tests must be issued before the depth buffer gets cleared
+	if (depth) _IssueQueries();
+
+	bool skybox = (mSkybox != 0 && mSkybox->GetType() == ITexture::Type::EnvironmentCubeMap &&
+		(mTarget == 0 || mTarget->IsUsingSkybox()));
+
+	// The skybox takes care of clearing the color buffer
+	_Record(Command::Clear, ((color && !skybox) ? 1 : 0) | (depth ? 2 : 0) | (stencil ? 4 : 0));
+
+	if (skybox && color)
+	{
+		bool depthWrite (mDepthWrite);
+		bool depthTest  (mDepthTest);
+
+		SetScreenProjection(false);
+		Draw(Drawable::Skybox);
+
+		SetDepthWrite(depthWrite);
+		SetDepthTest(depthTest);
+	}
+}
+
+//============================================================================================================
+// Pre-render
+//============================================================================================================
+
+void NullGraphics::BeginFrame()
+{
+	mStats.Clear();
+	mLog.Clear();
+	_CollectQueries();
+
+	if (mDelegates.IsValid())
+	{
+		mDelegates.Lock();
+		{
+			for (uint i = 0, imax = mDelegates.GetSize(); i < imax; ++i)
+			{
+				DelegateEntry& entry = mDelegates[i];
+				entry.callback(this, entry.param);
+			}
+			mDelegates.Clear();
+		}
+		mDelegates.Unlock();
+	}
+}
+
+//============================================================================================================
+// Post-render
+//============================================================================================================
+
+void NullGraphics::EndFrame()
+{
+	_IssueQueries();
+	SetBlending(Blending::Replace);
+	mTechnique = 0;
+}
+
+//============================================================================================================
+// Returns the last known visibility of the specified point, and tests it again
+//============================================================================================================
+
+bool NullGraphics::IsPointVisible (uint id, const Vector3f& v)
+{
+	ResetModelMatrix();
+	ResetViewMatrix();
+	return mQueries.Request(id, v, GetModelViewProjMatrix());
+}
+
+//============================================================================================================
+// Issues all visibility tests requested since the last time this function was called
+//============================================================================================================
+
+void NullGraphics::_IssueQueries()
+{
+	VisibilityQueries::Queries& queries = mQueries.GetCurrent();
+	uint first = mQueries.GetUnissued();
+	uint last  = queries.GetSize();
+	if (first == last) return;
+	mQueries.SetIssued(last);
+
+	bool colorWrite (mColorWrite);
+	bool depthWrite (mDepthWrite);
+	bool depthTest  (mDepthTest);
+
+	// Same state changes as with OpenGL
+	SetActiveMaterial((const IMaterial*)0);
+	SetColorWrite(false);
+	SetDepthWrite(false);
+	SetDepthTest(true);
+	PrepareToDraw();
+
+	for (uint i = first; i < last; ++i)
+	{
+		VisibilityQueries::Query& query = queries[i];
+		query.mHandle = mQueries.AcquireHandle();
+
+		if (query.mHandle == 0)
+		{
+			mResults.Expand();
+			query.mHandle = mResults.GetSize();
+		}
+
+		QueryResult& result = mResults[query.mHandle - 1];
+		result.mFrame	= mFrame;
+		result.mVisible	= mOnQuery ? mOnQuery(query.mPos) : false;
+		_Record(Command::Query, result.mVisible ? 1 : 0);
+	}
+
+	SetColorWrite(colorWrite);
+	SetDepthWrite(depthWrite);
+	SetDepthTest(depthTest);
+}
+
+//============================================================================================================
+// Collects the results of visibility tests issued a few frames ago
+//============================================================================================================
+
+void NullGraphics::_CollectQueries()
+{
+	VisibilityQueries::Queries& queries = mQueries.NextFrame();
+	++mFrame;
+
+	FOREACH(i, queries)
+	{
+		const VisibilityQueries::Query& query = queries[i];
+
+		if (query.mHandle != 0)
+		{
+			const QueryResult& result = mResults[query.mHandle - 1];
+
+			// Results that would still be in flight get skipped
+			if (mFrame - result.mFrame >= mQueryDelay)
+				mQueries.SetResult(query, result.mVisible);
+		}
+	}
+	mQueries.Recycle();
+}
+
+//============================================================================================================
+// Pre-defined drawables go through the same state changes as with GLGraphics
+//============================================================================================================
+
+uint NullGraphics::Draw (uint drawable)
+{
+	uint result (0);
+
+	if (drawable == Drawable::Skybox)
+	{
+		if (mSkybox == 0) return 0;
+
+		SetFog(false);
+		SetDepthTest(false);
+		SetDepthWrite(false);
+		SetAlphaTest(false);
+		SetColorWrite(true);
+		SetLighting(Lighting::None);
+		SetBlending(Blending::Replace);
+		SetActiveMaterial(mSkybox);
+		SetActiveShader(0);
+
+		// The skybox is centered on the camera
+		ResetModelViewMatrix();
+		Matrix43 view (GetViewMatrix());
+		view.PreTranslate(GetCameraPosition());
+		SetViewMatrix(view);
+
+		PrepareToDraw();
+		ResetViewMatrix();
+		result = 12;
+	}
+	else if (drawable == Drawable::FullscreenQuad || drawable == Drawable::InvertedQuad)
+	{
+		PrepareToDraw();
+		result = 2;
+	}
+	else if (drawable == Drawable::Plane)
+	{
+		ResetModelViewMatrix();
+		PrepareToDraw();
+		result = 2;
+	}
+	else if (drawable == Drawable::Grid || drawable == Drawable::Axis)
+	{
+		byte light = mLighting;
+
+		SetFog(true);
+		SetDepthTest(true);
+		SetDepthWrite(true);
+		SetAlphaTest(false);
+		SetColorWrite(true);
+		SetLighting(Lighting::None);
+		SetBlending(drawable == Drawable::Grid ? Blending::None : Blending::Replace);
+		SetActiveMaterial((const IMaterial*)0);
+
+		if (drawable == Drawable::Grid) ResetModelViewMatrix();
+		PrepareToDraw();
+
+		if (light) SetLighting(light);
+		result = (drawable == Drawable::Grid) ? 42 : 3;
+	}
+
+	if (result > 0)
+	{
+		mStats.mTriangles += result;
+		++mStats.mDrawCalls;
+		_Record(Command::Drawable, result, drawable);
+	}
+	return result;
+}
+
+//============================================================================================================
+// Creates a new vertex buffer object
+//============================================================================================================
+
+IVBO* NullGraphics::CreateVBO()
+{
+	mVbos.Lock();
+	NullVBO* vbo = new NullVBO(mVbos.GetSize() + 1);
+	mVbos.Expand() = vbo;
+	mVbos.Unlock();
+	return vbo;
+}
+
+//============================================================================================================
+// Creates a new temporary texture resource
+//============================================================================================================
+
+ITexture* NullGraphics::CreateRenderTexture (const char* name)
+{
+	static uint counter = 0;
+	mTempTex.Lock();
+	String s;
+	s << "[Generated] ";
+
+	if (name != 0)
+	{
+		s << name;
+	}
+	else
+	{
+		s << "Render Texture ";
+		s << counter++;
+	}
+	NullTexture* tex = new NullTexture(s);
+	mTempTex.Expand() = tex;
+	mTempTex.Unlock();
+	return tex;
+}
+
+//============================================================================================================
+// Creates a new render target
+//============================================================================================================
+
+IRenderTarget* NullGraphics::CreateRenderTarget()
+{
+	mTargets.Lock();
+	NullRenderTarget* target = new NullRenderTarget(mTargets.GetSize() + 1);
+	mTargets.Expand() = target;
+	mTargets.Unlock();
+	return target;
+}
+
+//============================================================================================================
+// Resources are only released, but kept in the managed arrays so that identifiers stay unique
+//============================================================================================================
+
+void NullGraphics::DeleteVBO (const IVBO* ptr)
+{
+	if (ptr != 0) const_cast<IVBO*>(ptr)->Release();
+}
+
+//============================================================================================================
+
+void NullGraphics::DeleteTexture (const ITexture* ptr)
+{
+	if (ptr != 0) const_cast<ITexture*>(ptr)->Release();
+}
+
+//============================================================================================================
+
+void NullGraphics::DeleteRenderTarget (const IRenderTarget* ptr)
+{
+	if (ptr != 0) const_cast<IRenderTarget*>(ptr)->Release();
+}
+
+//============================================================================================================
+// Retrieves or creates a new technique
+//============================================================================================================
+
+ITechnique* NullGraphics::GetTechnique (const String& name, bool createIfMissing)
+{
+	ITechnique* tech (0);
+
+	if (name.IsValid())
+	{
+		mTechs.Lock();
+		{
+			for (uint i = 0; i < mTechs.GetSize(); ++i)
+			{
+				tech = mTechs[i];
+
+				if (tech != 0 && tech->GetName() == name)
+				{
+					mTechs.Unlock();
+					return tech;
+				}
+			}
+
+			if (createIfMissing)
+			{
+				tech = new GLTechnique(name);
+				mTechs.Expand() = tech;
+			}
+			else tech = 0;
+		}
+		mTechs.Unlock();
+	}
+	return tech;
+}
+
+//============================================================================================================
+// Retrieves or creates a new material
+//============================================================================================================
+
+IMaterial* NullGraphics::GetMaterial (const String& name, bool createIfMissing)
+{
+	IMaterial* mat = 0;
+
+	if (name.IsValid())
+	{
+		mMaterials.Lock();
+		{
+			for (uint i = 0; i < mMaterials.GetSize(); ++i)
+			{
+				mat = mMaterials[i];
+
+				if (mat != 0 && mat->GetName() == name)
+				{
+					mMaterials.Unlock();
+					return mat;
+				}
+			}
+
+			if (createIfMissing)
+			{
+				GLMaterial* glMat = new GLMaterial(name);
+				glMat->_SetGraphics(this);
+				mMaterials.Expand() = glMat;
+				mat = glMat;
+			}
+			else mat = 0;
+		}
+		mMaterials.Unlock();
+	}
+	return mat;
+}
+
+//============================================================================================================
+// Retrieves or creates a texture with the specified name
+//============================================================================================================
+
+ITexture* NullGraphics::GetTexture (const String& name, bool createIfMissing)
+{
+	ITexture* tex = 0;
+
+	if (name.IsValid())
+	{
+		mTextures.Lock();
+		{
+			for (uint i = 0; i < mTextures.GetSize(); ++i)
+			{
+				tex = mTextures[i];
+
+				if (tex != 0 && tex->GetName() == name)
+				{
+					mTextures.Unlock();
+					return tex;
+				}
+			}
+
+			if (createIfMissing)
+			{
+				tex = new NullTexture(name);
+				mTextures.Expand() = tex;
+			}
+			else tex = 0;
+		}
+		mTextures.Unlock();
+	}
+	return tex;
+}
+
+//============================================================================================================
+// Retrieves or creates a shader with the specified name
+//============================================================================================================
+
+IShader* NullGraphics::GetShader (const String& name, bool createIfMissing)
+{
+	IShader* shader = 0;
+
+	if (name.IsValid())
+	{
+		mShaders.Lock();
+		{
+			for (uint i = 0; i < mShaders.GetSize(); ++i)
+			{
+				shader = mShaders[i];
+
+				if (shader != 0 && shader->GetName() == name)
+				{
+					mShaders.Unlock();
+					return shader;
+				}
+			}
+
+			if (createIfMissing)
+			{
+				shader = new NullShader(name);
+				mShaders.Expand() = shader;
+			}
+			else shader = 0;
+		}
+		mShaders.Unlock();
+	}
+	return shader;
+}
+
+//============================================================================================================
+// Retrieves or creates a font with the specified name
+//============================================================================================================
+
+IFont* NullGraphics::GetFont (const String& name, bool createIfMissing)
+{
+	IFont* font = 0;
+
+	if (name.IsValid())
+	{
+		mFonts.Lock();
+		{
+			for (uint i = 0; i < mFonts.GetSize(); ++i)
+			{
+				font = mFonts[i];
+
+				if (font != 0 && font->GetName() == name)
+				{
+					mFonts.Unlock();
+					return font;
+				}
+			}
+
+			if (createIfMissing)
+			{
+				font = new GLFont(name, this);
+				mFonts.Expand() = font;
+			}
+			else font = 0;
+		}
+		mFonts.Unlock();
+	}
+	return font;
+}
+
+//============================================================================================================
+// Serialization -- Load
+//============================================================================================================
+
+#define EXECUTE(type, fnc)														\
+	{																			\
+		type* p = fnc(value.AsString());										\
+		bool isSerializable = p->IsSerializable();								\
+		p->SerializeFrom(node, forceUpdate);									\
+		if (!isSerializable && !serializable) p->SetSerializable(false);		\
+	}
+
+//============================================================================================================
+
+bool NullGraphics::SerializeFrom (const TreeNode& root, bool forceUpdate)
+{
+	if (!mIsValid) return false;
+	String skybox;
+
+	bool serializable = true;
+
+	for (uint i = 0; i < root.mChildren.GetSize(); ++i)
+	{
+		const TreeNode& node  = root.mChildren[i];
+		const String&	tag   = node.mTag;
+		const Variable&	value = node.mValue;
+
+		if (tag == ClassName())
+		{
+			return SerializeFrom(node, forceUpdate);
+		}
+		else if (tag == "Serializable")
+		{
+			value >> serializable;
+		}
+		else if (tag == "Default AF" || tag == "Anisotropic Filter")
+		{
+			uint val;
+			if (value >> val) SetDefaultAF(val);
+		}
+		else if (tag == "Background Color")
+		{
+			Color4f color;
+			if (value >> color) SetBackgroundColor(color);
+		}
+		else if (tag == "Fog Range")
+		{
+			Vector2f range;
+			if (value >> range) SetFogRange(range);
+		}
+		else if (tag == "Skybox") skybox = (value.AsString());
+		else if	(tag == ITechnique::ClassName())	EXECUTE(ITechnique,	GetTechnique)
+		else if (tag == ITexture::ClassName())		EXECUTE(ITexture,	GetTexture)
+		else if (tag == IMaterial::ClassName())		EXECUTE(IMaterial,	GetMaterial)
+		else if (tag == IFont::ClassName())			EXECUTE(IFont,		GetFont)
+	}
+
+	if (skybox.IsValid()) mSkybox = GetTexture(skybox);
+	return true;
+}
+
+//============================================================================================================
+// Serialization -- Save
+//============================================================================================================
+
+#define SAVE(arr)	{ arr.Lock(); for (uint i = 0; i < arr.GetSize(); ++i) arr[i]->SerializeTo(node); arr.Unlock(); }
+
+bool NullGraphics::SerializeTo (TreeNode& root) const
+{
+	TreeNode& node = root.AddChild( ClassName() );
+	node.AddChild("Default AF", mAf);
+
+	if ( mSkybox && mSkybox->GetType() == ITexture::Type::EnvironmentCubeMap )
+		node.AddChild("Skybox", mSkybox->GetName());
+
+	SAVE(mTechs);
+	SAVE(mTextures);
+	SAVE(mMaterials);
+	SAVE(mFonts);
+
+	return true;
+}
@@ -0,0 +1,95 @@
+#include "../Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Reserves the texture using the render target's size
+//============================================================================================================
+
+void NullRenderTarget::_Reserve (ITexture* tex, uint format) const
+{
+	if (tex != 0 && mSize != 0 && format != ITexture::Format::Invalid)
+	{
+		tex->Reserve(mSize.x, mSize.y, 1, format, mMSAA);
+	}
+}
+
+//============================================================================================================
+// Changes the size of the render target, resizing all attached textures
+//============================================================================================================
+
+bool NullRenderTarget::SetSize (const Vector2i& size)
+{
+	if (mSize != size)
+	{
+		if (size.x < 8 || size.y < 8)
+		{
+			ASSERT(false, "The requested size for NullRenderTarget::SetSize() is too small");
+			return false;
+		}
+
+		mSize = size;
+
+		FOREACH(i, mColorTex) _Reserve(mColorTex[i].mTex, mColorTex[i].mFormat);
+		_Reserve(mDepthTex, (mStencilTex != 0) ? ITexture::Format::DepthStencil : ITexture::Format::Depth);
+	}
+	return true;
+}
+
+//============================================================================================================
+// Attaches a texture to the specified color index
+//============================================================================================================
+
+bool NullRenderTarget::AttachColorTexture (uint bufferIndex, ITexture* tex, uint format)
+{
+	if (bufferIndex < GetMaxColorAttachments())
+	{
+		if (bufferIndex >= mColorTex.GetSize()) mColorTex.ExpandTo(bufferIndex + 1);
+
+		TextureEntry& entry = mColorTex[bufferIndex];
+		entry.mTex		= tex;
+		entry.mFormat	= format;
+		_Reserve(tex, format);
+		return true;
+	}
+	return false;
+}
+
+//============================================================================================================
+// Attaches a depth texture
+//============================================================================================================
+
+bool NullRenderTarget::AttachDepthTexture (ITexture* tex)
+{
+	mDepthTex = tex;
+	_Reserve(tex, ITexture::Format::Depth);
+	return true;
+}
+
+//============================================================================================================
+// Attaches a stencil texture -- just like with FBOs, it must be a combined depth-stencil texture
+//============================================================================================================
+
+bool NullRenderTarget::AttachStencilTexture (ITexture* tex)
+{
+	if (mStencilTex != tex)
+	{
+		if (mDepthTex != 0 && mDepthTex != tex) return false;
+		mDepthTex = tex;
+		mStencilTex = tex;
+		_Reserve(tex, ITexture::Format::DepthStencil);
+	}
+	return true;
+}
+
+//============================================================================================================
+// Determines if we have a valid color attachment
+//============================================================================================================
+
+bool NullRenderTarget::HasColor() const
+{
+	FOREACH(i, mColorTex)
+	{
+		if (mColorTex[i].mTex != 0) return true;
+	}
+	return false;
+}
@@ -0,0 +1,309 @@
+#include "../Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+
+NullTexture::NullTexture (const String& name) :
+	mName				(name),
+	mReplacement		(0),
+	mType				(Type::Invalid),
+	mFormat				(Format::Invalid),
+	mRequestedFormat	(Format::Optimal),
+	mDepth				(0),
+	mSizeInMemory		(0),
+	mTimestamp			(0),
+	mWrapMode			(WrapMode::Default),
+	mCompareMode		(CompareMode::Default),
+	mFilter				(Filter::Default),
+	mCheckForSource		(true),
+	mSerializable		(false) {}
+
+//============================================================================================================
+// Tries to load the texture by its name
+//============================================================================================================
+
+void NullTexture::_CheckForSource()
+{
+	mCheckForSource = false;
+
+	if (_Read(mName, 0))
+	{
+		mSerializable = false;
+		mType = (mDepth > 1) ? Type::ThreeDimensional : Type::TwoDimensional;
+	}
+}
+
+//============================================================================================================
+// Reads the dimensions of the specified image. The pixel data is discarded right away.
+//============================================================================================================
+
+bool NullTexture::_Read (const String& file, uint index)
+{
+	Image img;
+	if (!img.Load(file)) return false;
+
+	mSource[index] = img.GetSource();
+
+	if (index == 0)
+	{
+		uint format = (mRequestedFormat == Format::Optimal) ? img.GetFormat() : mRequestedFormat;
+		_SetInfo(img.GetWidth(), img.GetHeight(), img.GetDepth(), format);
+	}
+	return true;
+}
+
+//============================================================================================================
+// Updates the size in memory using the current dimensions and format
+//============================================================================================================
+
+void NullTexture::_SetInfo (uint width, uint height, uint depth, uint format)
+{
+	mSize.Set(width, height);
+	mDepth = depth;
+	mFormat = format;
+	mSizeInMemory = (ulong)width * height * depth * GetBitsPerPixel(format) / 8;
+}
+
+//============================================================================================================
+// Releases the texture
+//============================================================================================================
+
+void NullTexture::Release()
+{
+	mLock.Lock();
+	{
+		for (uint i = 0; i < 6; ++i) mSource[i].Clear();
+		mType			= Type::Invalid;
+		mFormat			= Format::Invalid;
+		mSize			= 0;
+		mDepth			= 0;
+		mSizeInMemory	= 0;
+		mCheckForSource = false;
+	}
+	mLock.Unlock();
+}
+
+//============================================================================================================
+// Whether the texture can be used
+//============================================================================================================
+
+bool NullTexture::IsValid() const
+{
+	if (mReplacement != 0) return mReplacement->IsValid();
+	if (mCheckForSource) (const_cast<NullTexture*>(this))->_CheckForSource();
+	return (mFormat != Format::Invalid);
+}
+
+//============================================================================================================
+// Returns the valid path to the texture's source
+//============================================================================================================
+
+const String& NullTexture::GetSource (uint index) const
+{
+	if (mReplacement != 0) return mReplacement->GetSource(index);
+	return (index < 6 ? mSource[index] : mSource[0]);
+}
+
+//============================================================================================================
+// Activating a texture only updates its timestamp. The returned identifier is the texture's UID.
+//============================================================================================================
+
+uint NullTexture::Activate()
+{
+	if (mReplacement != 0) return mReplacement->Activate();
+	mTimestamp = Time::GetMilliseconds();
+	return IsValid() ? mUID : 0;
+}
+
+//============================================================================================================
+// Reserve an internal texture of specified dimensions
+//============================================================================================================
+
+bool NullTexture::Reserve (uint width, uint height, uint depth, uint format, uint msaa)
+{
+	if (mReplacement != 0) return mReplacement->Reserve(width, height, depth, format, msaa);
+
+	mLock.Lock();
+	{
+		mCheckForSource = false;
+		mRequestedFormat = format;
+		mType = (depth > 1) ? Type::ThreeDimensional : Type::TwoDimensional;
+		_SetInfo(width, height, depth, format);
+	}
+	mLock.Unlock();
+	return true;
+}
+
+//============================================================================================================
+// Load a single texture from the specified file
+//============================================================================================================
+
+bool NullTexture::Load (const String& file, uint format)
+{
+	if (mReplacement != 0) return mReplacement->Load(file, format);
+
+	bool retVal = false;
+
+	mLock.Lock();
+	{
+		mCheckForSource = false;
+		mRequestedFormat = format;
+
+		if (_Read(file, 0))
+		{
+			mType = (mDepth > 1) ? Type::ThreeDimensional : Type::TwoDimensional;
+			retVal = true;
+		}
+	}
+	mLock.Unlock();
+	return retVal;
+}
+
+//============================================================================================================
+// Load a cube map using the six specified textures
+//============================================================================================================
+
+bool NullTexture::Load (const String&	up,
+						const String&	down,
+						const String&	north,
+						const String&	east,
+						const String&	south,
+						const String&	west,
+						uint			format)
+{
+	if (mReplacement != 0) return mReplacement->Load(up, down, north, east, south, west, format);
+
+	bool retVal = false;
+
+	mLock.Lock();
+	{
+		mCheckForSource = false;
+		mRequestedFormat = format;
+
+		if (_Read(up, 0) && _Read(down, 1) && _Read(north, 2) && _Read(east, 3) && _Read(south, 4) && _Read(west, 5))
+		{
+			mType = Type::EnvironmentCubeMap;
+			retVal = true;
+		}
+	}
+	mLock.Unlock();
+	return retVal;
+}
+
+//============================================================================================================
+// Assign texture data manually
+//============================================================================================================
+
+bool NullTexture::Set (const void* buffer, uint width, uint height, uint depth, uint dataFormat, uint format)
+{
+	if (mReplacement != 0) return mReplacement->Set(buffer, width, height, depth, dataFormat, format);
+	return Reserve(width, height, depth, (format == Format::Optimal) ? dataFormat : format);
+}
+
+//============================================================================================================
+// Assign the cube map data manually
+//============================================================================================================
+
+bool NullTexture::Set (	const void*	up,
+						const void*	down,
+						const void*	north,
+						const void*	east,
+						const void*	south,
+						const void*	west,
+						uint width, uint height,
+						uint dataFormat,
+						uint format )
+{
+	if (mReplacement != 0) return mReplacement->Set(up, down, north, east, south, west, width, height, dataFormat, format);
+
+	bool retVal = Reserve(width, height, 1, (format == Format::Optimal) ? dataFormat : format);
+	mType = Type::EnvironmentCubeMap;
+	return retVal;
+}
+
+//============================================================================================================
+// Serialization -- saving
+//============================================================================================================
+
+bool NullTexture::SerializeTo (TreeNode& root) const
+{
+	if (mReplacement != 0) return mReplacement->SerializeTo(root);
+
+	if (mFormat == ITexture::Format::Invalid || mName.IsEmpty() || mSource[0].IsEmpty() || !mSerializable)
+		return false;
+
+	TreeNode& node = root.AddChild(ITexture::ClassName(), mName);
+
+	if (mType == Type::EnvironmentCubeMap)
+	{
+		node.AddChild("Positive X", mSource[0]);
+		node.AddChild("Negative X", mSource[1]);
+		node.AddChild("Positive Y", mSource[2]);
+		node.AddChild("Negative Y", mSource[3]);
+		node.AddChild("Positive Z", mSource[4]);
+		node.AddChild("Negative Z", mSource[5]);
+	}
+	else
+	{
+		node.AddChild("Source", mSource[0]);
+	}
+
+	node.AddChild("Format", ITexture::FormatToString(mRequestedFormat));
+	node.AddChild("Filtering", ITexture::FilterToString(mFilter));
+	node.AddChild("Wrap Mode", ITexture::WrapModeToString(mWrapMode));
+
+	if (mCompareMode != CompareMode::Default)
+	{
+		node.AddChild("Compare Mode", ITexture::CompareModeToString(mCompareMode));
+	}
+	return true;
+}
+
+//============================================================================================================
+// Serialization -- loading
+//============================================================================================================
+
+bool NullTexture::SerializeFrom (const TreeNode& root, bool forceUpdate)
+{
+	if (mReplacement != 0) return mReplacement->SerializeFrom(root, forceUpdate);
+	if (mFormat != Format::Invalid && !forceUpdate) return true;
+
+	mSerializable = true;
+
+	String file[6];
+	uint format (mRequestedFormat);
+
+	for (uint i = 0; i < root.mChildren.GetSize(); ++i)
+	{
+		const TreeNode& node  = root.mChildren[i];
+		const String&	tag   = node.mTag;
+		const Variable&	value = node.mValue;
+
+		if		(tag == "Source")		value >> file[0];
+		else if (tag == "Positive X")	value >> file[0];
+		else if (tag == "Negative X")	value >> file[1];
+		else if (tag == "Positive Y")	value >> file[2];
+		else if (tag == "Negative Y")	value >> file[3];
+		else if (tag == "Positive Z")	value >> file[4];
+		else if (tag == "Negative Z")	value >> file[5];
+		else if (tag == "Serializable") value >> mSerializable;
+		else if (value.IsString())
+		{
+			const String& s = value.AsString();
+			if		(tag == "Format")		format			= ITexture::StringToFormat(s);
+			else if (tag == "Filtering")	mFilter			= ITexture::StringToFilter(s);
+			else if (tag == "Wrap Mode")	mWrapMode		= ITexture::StringToWrapMode(s);
+			else if (tag == "Compare Mode")	mCompareMode	= ITexture::StringToCompareMode(s);
+		}
+	}
+
+	if (file[1].IsValid())
+	{
+		Load(file[0], file[1], file[2], file[3], file[4], file[5], format);
+	}
+	else if (file[0].IsValid())
+	{
+		Load(file[0], format);
+	}
+	return true;
+}
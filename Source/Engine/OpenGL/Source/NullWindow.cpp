@@ -0,0 +1,106 @@
+#include "../Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Creates the window, initializing the graphics controller if one has been set
+//============================================================================================================
+
+bool NullWindow::Create (const String& title, short x, short y, ushort width, ushort height, uint style)
+{
+	mTitle = title;
+	mPos.Set(x, y);
+	mStyle = style;
+	mIsValid = true;
+
+	if (mGraphics != 0 && !mGraphics->Init())
+	{
+		mIsValid = false;
+		return false;
+	}
+	return SetSize( Vector2i(width, height) );
+}
+
+//============================================================================================================
+// Associates the graphics controller with the window
+//============================================================================================================
+
+bool NullWindow::SetGraphics (IGraphics* ptr)
+{
+	if (mGraphics == ptr) return true;
+	if (mGraphics != 0) mGraphics->Release();
+	mGraphics = ptr;
+	return (mGraphics == 0 || !mIsValid || mGraphics->Init());
+}
+
+//============================================================================================================
+// Changes the size of the window, notifying the event handler
+//============================================================================================================
+
+bool NullWindow::SetSize (const Vector2i& size)
+{
+	if (mSize != size)
+	{
+		mSize = size;
+		if (mHandler) mHandler->OnResize(mSize);
+	}
+	return true;
+}
+
+//============================================================================================================
+// Closes the window
+//============================================================================================================
+
+void NullWindow::Close()
+{
+	if (mIsValid)
+	{
+		mIsValid = false;
+		if (mGraphics != 0) mGraphics->Release();
+	}
+}
+
+//============================================================================================================
+// Serialization -- Load
+//============================================================================================================
+
+bool NullWindow::SerializeFrom (const TreeNode& root)
+{
+	String		title (mTitle);
+	Vector2i	size  (mIsValid ? mSize : Vector2i(1024, 768));
+	Vector2i	pos   (mPos);
+
+	for (uint i = 0; i < root.mChildren.GetSize(); ++i)
+	{
+		const TreeNode& node  = root.mChildren[i];
+		const String&	tag   = node.mTag;
+		const Variable&	value = node.mValue;
+
+		if		(tag == "Title")	value >> title;
+		else if (tag == "Position")	value >> pos;
+		else if (tag == "Size")		value >> size;
+	}
+
+	if (mIsValid)
+	{
+		mTitle = title;
+		mPos = pos;
+		return SetSize(size);
+	}
+	return Create(title, pos.x, pos.y, size.x, size.y);
+}
+
+//============================================================================================================
+// Serialization -- Save
+//============================================================================================================
+
+bool NullWindow::SerializeTo (TreeNode& root) const
+{
+	if (mTitle.IsEmpty()) return false;
+
+	TreeNode& node = root.AddChild(IWindow::ClassName());
+	node.AddChild("Title", mTitle);
+	node.AddChild("Position", mPos);
+	node.AddChild("Size", mSize);
+	node.AddChild("Full Screen", false);
+	return true;
+}
@@ -0,0 +1,174 @@
+#include "../Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Points that haven't been tested for this many frames get forgotten
+//============================================================================================================
+
+#define FORGET_AFTER 256
+
+//============================================================================================================
+// Changing the latency discards all queries that are currently in flight
+//============================================================================================================
+
+void VisibilityQueries::SetLatency (uint frames)
+{
+	frames = Clamp(frames, 1U, (uint)MaxLatency);
+
+	if (mLatency != frames)
+	{
+		for (uint i = 0; i < MaxLatency; ++i)
+		{
+			Queries& queries = mFrames[i];
+
+			FOREACH(b, queries)
+			{
+				if (queries[b].mHandle != 0) mFree.Expand() = queries[b].mHandle;
+			}
+			queries.Clear();
+		}
+		mLatency = frames;
+		mIssued = 0;
+	}
+}
+
+//============================================================================================================
+// Returns the last known visibility of the specified point, testing it again if it's on-screen
+//============================================================================================================
+
+bool VisibilityQueries::Request (uint id, const Vector3f& pos, const Matrix44& mvp)
+{
+	Point* point = mPoints.GetIfExists(id);
+
+	if (point == 0)
+	{
+		point = &mPoints[id];
+		point->mFrame	= mFrame - 1;
+		point->mCount	= 0;
+		point->mVisible	= false;
+	}
+
+	if (point->mFrame != mFrame)
+	{
+		point->mFrame = mFrame;
+
+		// Points behind the camera and outside of the view frustum can't be visible
+		float w = pos.x * mvp[3] + pos.y * mvp[7] + pos.z * mvp[11] + mvp[15];
+		Vector3f ndc (pos * mvp);
+
+		if (w > 0.0f && ndc.x >= -1.0f && ndc.x <= 1.0f && ndc.y >= -1.0f && ndc.y <= 1.0f &&
+			ndc.z >= -1.0f && ndc.z <= 1.0f)
+		{
+			Query& query	= GetCurrent().Expand();
+			query.mPos		= ndc;
+			query.mID		= id;
+			query.mHandle	= 0;
+		}
+		else
+		{
+			// There is no doubt about off-screen points, so there is no need to wait
+			point->mVisible = false;
+			point->mCount = 0;
+		}
+	}
+	return point->mVisible;
+}
+
+//============================================================================================================
+// Retrieves a query object that can be reused, or '0' if the graphics manager should create a new one
+//============================================================================================================
+
+uint VisibilityQueries::AcquireHandle()
+{
+	if (mFree.IsEmpty()) return 0;
+	uint handle = mFree.Back();
+	mFree.RemoveAt(mFree.GetSize() - 1);
+	return handle;
+}
+
+//============================================================================================================
+// Starts a new frame, returning the queries issued 'latency' frames ago
+//============================================================================================================
+
+VisibilityQueries::Queries& VisibilityQueries::NextFrame()
+{
+	++mFrame;
+	mIssued = 0;
+	return GetCurrent();
+}
+
+//============================================================================================================
+// Updates the visibility of the point tested by the specified query
+//============================================================================================================
+
+void VisibilityQueries::SetResult (const Query& query, bool visible)
+{
+	Point* point = mPoints.GetIfExists(query.mID);
+
+	if (point != 0)
+	{
+		if (point->mVisible == visible)
+		{
+			point->mCount = 0;
+		}
+		else if (++point->mCount >= mHysteresis)
+		{
+			point->mVisible = visible;
+			point->mCount = 0;
+		}
+	}
+}
+
+//============================================================================================================
+// Returns all query objects used by the queries retrieved via NextFrame() back to the pool
+//============================================================================================================
+
+void VisibilityQueries::Recycle()
+{
+	Queries& queries = GetCurrent();
+
+	FOREACH(i, queries)
+	{
+		if (queries[i].mHandle != 0) mFree.Expand() = queries[i].mHandle;
+	}
+	queries.Clear();
+
+	// Every once in a while forget points that are no longer being tested
+	if ((mFrame % FORGET_AFTER) == 0 && mPoints.IsValid())
+	{
+		Array<uint> expired;
+		const Hash<Point>::Keys& keys = mPoints.GetAllKeys();
+		const Hash<Point>::Values& points = mPoints.GetAllValues();
+
+		FOREACH(i, points)
+		{
+			if (mFrame - points[i].mFrame > FORGET_AFTER) expired.Expand() = keys[i];
+		}
+
+		FOREACH(i, expired) mPoints.Delete(expired[i]);
+	}
+}
+
+//============================================================================================================
+// Removes all points and queries, retrieving all query objects so that they can be deleted
+//============================================================================================================
+
+void VisibilityQueries::Release (Array<uint>& handles)
+{
+	handles = mFree;
+	mFree.Clear();
+
+	for (uint i = 0; i < MaxLatency; ++i)
+	{
+		Queries& queries = mFrames[i];
+
+		FOREACH(b, queries)
+		{
+			if (queries[b].mHandle != 0) handles.Expand() = queries[b].mHandle;
+		}
+		queries.Clear();
+	}
+
+	mPoints.Clear();
+	mIssued = 0;
+}
@@ -261,6 +261,7 @@ bool InitOpenGL (uint requiredVersion)
 					g_caps.mDXTCompression	= CheckExtension("GL_EXT_texture_compression_s3tc", false);
 					g_caps.mOcclusion		= CheckExtension("GL_ARB_occlusion", false);
 					g_caps.mMSAA			= CheckExtension("GL_ARB_texture_multisample", false);
+					g_caps.mHalfFloatVertex	= CheckExtension("GL_ARB_half_float_vertex", false);
 
 					if ( (supported = g_caps.mBufferObjects) )
 					{
@@ -20,13 +20,41 @@ struct TreeNode
 		};
 	};
 
+	// Nodes with at least this many children use a hash table to find them by tag
+	enum { IndexThreshold = 16 };
+
+	struct Index;
+
 	String			mTag;
 	Variable		mValue;
 	Array<TreeNode>	mChildren;
 	Flags			mFlags;
 
-	TreeNode(const char* tag = "Root") { mTag = tag; }
-	TreeNode(const String& s) { mTag = s; }
+private:
+
+	mutable uint			mID;		// Interned identifier of the tag
+	mutable const String*	mIDTag;		// Interned tag the identifier belongs to, used to tell if 'mTag' has changed
+	mutable Index*			mIndex;		// Hash table of the children's indices, built on demand for large nodes
+
+public:
+
+	TreeNode(const char* tag = "Root")	: mID(0), mIDTag(0), mIndex(0) { mTag = tag; }
+	TreeNode(const String& s)			: mID(0), mIDTag(0), mIndex(0) { mTag = s; }
+	TreeNode(const TreeNode& node)		: mID(0), mIDTag(0), mIndex(0) { *this = node; }
+	~TreeNode() { _ReleaseIndex(); }
+
+	// Copies the tag, value, and all children. The index is not copied.
+	TreeNode& operator = (const TreeNode& node)
+	{
+		mTag		= node.mTag;
+		mValue		= node.mValue;
+		mChildren	= node.mChildren;
+		mFlags		= node.mFlags;
+		mID			= node.mID;
+		mIDTag		= node.mIDTag;
+		_ReleaseIndex();
+		return *this;
+	}
 
 	void Lock()		{ mChildren.Lock(); }
 	void Unlock()	{ mChildren.Unlock(); }
@@ -38,8 +66,19 @@ struct TreeNode
 		mValue.Release();
 		mChildren.Release();
 		mFlags.Clear();
+		_ReleaseIndex();
 	}
 
+	// Returns the tag's interned identifier. Nodes with identical tags always have identical identifiers.
+	uint GetID() const { return (mIDTag != 0 && *mIDTag == mTag) ? mID : _UpdateID(); }
+
+	// Returns the identifier of the specified tag, adding it to the list of known tags if necessary
+	static uint GetID (const char* tag);
+	static uint GetID (const String& tag) { return GetID(tag.GetBuffer()); }
+
+	// Returns the identifier of the specified tag if it's known, or '0' otherwise. Doesn't add the tag.
+	static uint FindID (const char* tag);
+
 	// The node is valid as long as it has a tag
 	bool IsValid() const { return mTag.IsValid(); }
 
@@ -51,21 +90,12 @@ struct TreeNode
 	{
 		TreeNode& node = mChildren.Expand();
 		node.mTag = tag;
+		if (mIndex != 0) _AddToIndex();
 		return node;
 	}
 
 	// Not thread-safe. Lock the tree before using.
-	TreeNode& AddUnique (const char* tag)
-	{
-		FOREACH(i, mChildren)
-		{
-			if (mChildren[i].mTag == tag)
-			{
-				return mChildren[i];
-			}
-		}
-		return AddChild(tag);
-	}
+	TreeNode& AddUnique (const char* tag);
 
 	// Implementations of various data types
 	template <typename Type>
@@ -74,12 +104,18 @@ struct TreeNode
 		TreeNode& node	= mChildren.Expand();
 		node.mTag		= tag;
 		node.mValue		= val;
+		if (mIndex != 0) _AddToIndex();
 		return node;
 	}
 
-	// Finds a child with the specified tag
+	// Finds a child with the specified tag. Not thread-safe for nodes with many children. Lock the tree before using.
 	TreeNode* FindChild (const String& tag, bool recursive = true);
 
+	// Nodes with many children find them using an index. Children added with AddChild() keep it up to date, and
+	// so does appending to 'mChildren' directly, but changing a child's tag in place or removing, inserting and
+	// reordering children through 'mChildren' must be followed by a call to this function.
+	void InvalidateIndex() { _ReleaseIndex(); }
+
 public: // Simple serialization functions
 
 	// Saves to the specified file, using the file's extension to determine whether it should be binary
@@ -124,6 +160,47 @@ public: // Advanced serialization functions
 
 private:
 
-	// Recursive text format parsing
-	bool ParseProperties (const String& data, uint& first, uint last);
+	// Interns the current tag
+	uint _UpdateID() const;
+
+	// Adds the last child to the index
+	void _AddToIndex();
+
+	// Finds the first direct child with the specified tag using the index, building it if necessary
+	TreeNode* _FindIndexed (const char* tag);
+
+	// Releases the index of the children
+	void _ReleaseIndex() const;
+};
+
+//============================================================================================================
+// Maps a fixed list of tags to their position in the list, allowing nodes to be dispatched with a switch:
+//
+// const char* g_tags[] = { "Position", "Rotation", 0 };
+// TagMap g_tagMap (g_tags);
+//
+// switch (g_tagMap[node]) { case 0: ...; case 1: ...; default: ... }
+//============================================================================================================
+
+class TagMap
+{
+public:
+
+	enum { Unknown = 0xFFFFFFFF };
+
+private:
+
+	Array<uint> mPositions;	// Position of each tag in the list, indexed by the tag's identifier
+
+public:
+
+	// The list of tags must end with a null pointer
+	TagMap (const char* tags[]);
+
+	// Returns the position of the node's tag in the list, or 'Unknown' if it's not in the list
+	uint operator [] (const TreeNode& node) const
+	{
+		uint id = node.GetID();
+		return (id < mPositions.GetSize()) ? mPositions[id] : Unknown;
+	}
 };
\ No newline at end of file
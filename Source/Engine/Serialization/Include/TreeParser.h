@@ -0,0 +1,79 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Single-pass parser of the text (R5A) format that works directly on the raw buffer
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class TreeParser
+{
+public:
+
+	// SAX-style receiver of the parsed nodes
+	struct Handler
+	{
+		virtual ~Handler() {}
+
+		// Called as soon as the node's tag and value have been parsed, before any of its children. The tag is only
+		// valid for the duration of the call, but the value can be taken over by swapping it with another variable.
+		// Returning 'false' stops the parsing.
+		virtual bool OnNodeStart (const String& tag, Variable& value)=0;
+
+		// Called after all of the node's children have been parsed
+		virtual void OnNodeEnd() {}
+	};
+
+private:
+
+	const char*	mPos;		// Current position in the buffer
+	const char*	mEnd;		// End of the buffer
+	Handler*	mHandler;	// Receiver of the parsed nodes
+	String		mTag;		// Tag of the node being parsed
+	String		mTemp;		// Text of values that need to go through the string conversion
+	Variable	mValue;		// Value of the node being parsed
+	bool		mStop;		// Set when the handler asks to stop
+
+	TreeParser (const char* text, uint length, Handler& handler) :
+		mPos(text), mEnd(text + length), mHandler(&handler), mStop(false) {}
+
+public:
+
+	// Parses all nodes in the text, passing them to the handler. Returns 'false' if the text is malformed.
+	static bool Parse (const char* text, uint length, Handler& handler);
+
+	// Replaces the tree's contents with the first node found in the text
+	static bool Parse (const char* text, uint length, TreeNode& root);
+
+private:
+
+	// Copies the specified range into the temporary string
+	const String& _ToString (const char* from, const char* to);
+
+	// Skips spaces, tabs, line breaks and comments
+	void _SkipSpaces();
+
+	// Skips everything up to and including the closing bracket of the current block
+	void _SkipBlock();
+
+	// Retrieves a single phrase such as a tag or a value, stopping at the end of the line
+	bool _GetPhrase (String& out);
+
+	// Parses the node at the current position along with all of its children
+	bool _ParseNode();
+
+	// Parses the value following the equality sign
+	bool _ParseValue();
+
+	// Parses an array of the specified type, such as "Float3[] { ... }"
+	bool _ParseArray (const char* type, const char* typeEnd);
+
+	// Numeric arrays are parsed in place, line by line. Returns 'false' if the generic path should be used instead.
+	bool _ParseNumbers (uint type);
+	void _ParseLine (uint type, const char* pos, const char* end);
+
+	// Copies the bracketed array into the temporary string the way the generic conversion expects it
+	bool _GetSegment();
+};
@@ -59,6 +59,17 @@ public:
 	// Releases the variable's data, clearing any used memory
 	void Release();
 
+	// Exchanges the contents of two variables without copying any of the allocated data
+	void Swap (Variable& val)
+	{
+		byte temp[16], type = mType;
+		memcpy(temp, mBytes, 16);
+		memcpy(mBytes, val.mBytes, 16);
+		memcpy(val.mBytes, temp, 16);
+		mType = val.mType;
+		val.mType = type;
+	}
+
 	// If copying of memory is desired, this function will do just that
 	void operator =(const Variable& val);
 
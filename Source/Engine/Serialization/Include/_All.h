@@ -15,6 +15,7 @@ namespace R5
 	#include "Conversion.h"
 	#include "Variable.h"
 	#include "TreeNode.h"
+	#include "TreeParser.h"
 	#include "CodeNode.h"
 };
 
@@ -1,159 +1,273 @@
 #include "../Include/_All.h"
 using namespace R5;
-
+
+namespace
+{
 //============================================================================================================
-// Skip comments, returning 'true' if a comment was skipped, 'false' otherwise
+// HashKey() leaves the low bits poorly distributed for similar tags, so they get mixed before masking
 //============================================================================================================
 
-bool SkipComment (const String& s, uint& from, uint to)
+inline uint HashTag (const char* tag)
 {
-	if ((from + 1 < to) && (s[from] == '/') && (s[from+1] == '/'))
+	uint key = HashKey(tag);
+	key ^= key >> 16;
+	key *= 0x85ebca6b;
+	key ^= key >> 13;
+	key *= 0xc2b2ae35;
+	key ^= key >> 16;
+	return key;
+}
+
+//============================================================================================================
+// Table of all interned tags
+//============================================================================================================
+
+struct TagTable : public Thread::Lockable
+{
+	PointerArray<String>	mTags;	// Interned tags, indexed by their identifier minus one
+	Array<uint>				mSlots;	// Open addressing hash table of identifiers, at most half full
+
+	TagTable() { mSlots.ExpandTo(256, true); }
+
+	// Inserts the identifier into the hash table
+	void Insert (uint id)
+	{
+		uint mask = mSlots.GetSize() - 1;
+		uint slot = HashTag(mTags[id - 1]->GetBuffer()) & mask;
+		while (mSlots[slot] != 0) slot = (slot + 1) & mask;
+		mSlots[slot] = id;
+	}
+
+	// Returns the identifier of the specified tag, or '0' if it hasn't been interned. Must be called while locked.
+	uint Find (const char* tag) const
 	{
-		char ch;
+		uint mask = mSlots.GetSize() - 1;
 
-		for (from += 2; from < to; ++from)
+		for (uint slot = HashTag(tag) & mask; mSlots[slot] != 0; slot = (slot + 1) & mask)
 		{
-			ch = s[from];
-			if (ch == '\n' || ch == '\r') break;
+			if (*mTags[mSlots[slot] - 1] == tag) return mSlots[slot];
 		}
-		return true;
+		return 0;
 	}
-	return false;
+
+	// Returns the identifier of the specified tag, adding it if necessary. Must be called while locked.
+	uint Intern (const char* tag, const String*& interned)
+	{
+		uint mask = mSlots.GetSize() - 1;
+
+		for (uint slot = HashTag(tag) & mask; mSlots[slot] != 0; slot = (slot + 1) & mask)
+		{
+			const String* existing = mTags[mSlots[slot] - 1];
+
+			if (*existing == tag)
+			{
+				interned = existing;
+				return mSlots[slot];
+			}
+		}
+
+		String* str = new String();
+		*str = tag;
+		mTags.Expand() = str;
+		interned = str;
+		uint id = mTags.GetSize();
+
+		if ((id << 1) > mSlots.GetSize())
+		{
+			// Grow the hash table, re-inserting all identifiers
+			uint size = mSlots.GetSize() << 1;
+			mSlots.Clear();
+			mSlots.ExpandTo(size, true);
+			for (uint i = 1; i <= id; ++i) Insert(i);
+		}
+		else Insert(id);
+		return id;
+	}
+};
+
+// The table is created on first use so that tag maps can be created during static initialization
+TagTable& GetTagTable()
+{
+	static TagTable table;
+	return table;
 }
 
+// Ensures that the table gets created before any threads are started
+TagTable& g_tagTable = GetTagTable();
+
+//============================================================================================================
+// Spreads out sequential tag identifiers
+//============================================================================================================
+
+inline uint HashID (uint id) { return id * 2654435761u; }
+} // anonymous namespace
+
 //============================================================================================================
-// Retrieves a single phrase from the string
+// Hash table of the children's indices, used by nodes with a lot of children
 //============================================================================================================
 
-bool GetPhrase (const String& s, uint& from, uint to, String& out)
+struct TreeNode::Index
 {
-	if (from < to)
-	{
-		// Skip all spaces, tabs, and comments
-		while (from < to && (s[from] < 33 || SkipComment(s, from, to))) ++from;
+	uint		mCount;	// Number of children the index covers
+	Array<uint>	mSlots;	// Pairs of tag identifiers and 1-based indices of the first child with that tag
 
-		char ch = s[from];
+	// Adds the child with the specified identifier, unless an earlier child with the same tag is already indexed
+	void Insert (uint id, uint index)
+	{
+		uint* slots = mSlots.GetBuffer();
+		uint mask = (mSlots.GetSize() >> 1) - 1;
 
-		// If we haven't reached the end and have a valid character to work with
-		if ( (from != to) && (ch <= '~') && (ch != '{') && (ch != '}') && (ch != '=') )
+		for (uint slot = HashID(id) & mask; ; slot = (slot + 1) & mask)
 		{
-			uint phraseEnd = from;
-			uint lastChar = from;
-			bool inQuotes = false;
+			uint* entry = slots + (slot << 1);
 
-			// Find where this phrase ends
-			while (phraseEnd < to)
+			if (entry[0] == 0)
 			{
-				ch = s[phraseEnd];
+				entry[0] = id;
+				entry[1] = index + 1;
+				break;
+			}
+			if (entry[0] == id) break;
+		}
+	}
 
-				// If it's an empty character, keep going
-				if (ch == ' ' || ch == '\t')
-				{
-					++phraseEnd;
-				}
-				else
-				{
-					// Keep track of whether we're inside quoted strings or not
-					if (ch == '"') inQuotes = !inQuotes;
+	// Rebuilds the index for the specified children
+	void Build (const Array<TreeNode>& children)
+	{
+		mCount = children.GetSize();
 
-					// Only process characters while we are not in quotes
-					if (!inQuotes)
-					{
-						// If we found a comment, the rest of the line should be ignored
-						if (SkipComment(s, phraseEnd, to)) break;
+		uint size = 32;
+		while (size < (mCount << 1)) size <<= 1;
 
-						// If it's an end-of-phrase character, stop
-						if (ch < ' ' || ch == '=' || ch > '~' || ch == '{' || ch == '}') break;
-					}
+		mSlots.Clear();
+		mSlots.ExpandTo(size << 1, true);
+		for (uint i = 0; i < mCount; ++i) Insert(children[i].GetID(), i);
+	}
 
-					// Remember the last valid character
-					lastChar = phraseEnd;
-					++phraseEnd;
-				}
-			}
+	// Adds the last of the children, growing the table once it would become more than half full
+	void Append (const Array<TreeNode>& children)
+	{
+		if (((mCount + 1) << 2) > mSlots.GetSize())
+		{
+			Build(children);
+		}
+		else
+		{
+			Insert(children[mCount].GetID(), mCount);
+			++mCount;
+		}
+	}
 
-			// Get the substring and update the starting position to the last processed character
-			if ( s.GetString(out, from, lastChar + 1) )
-			{
-				from = phraseEnd;
+	// Returns the 1-based index of the first child with the specified identifier, or '0' if there is none
+	uint Find (uint id) const
+	{
+		const uint* slots = mSlots.GetBuffer();
+		uint mask = (mSlots.GetSize() >> 1) - 1;
 
-				// Skip trailing spaces
-				while (from < to && s[from] < 33) ++from;
-				return true;
-			}
+		for (uint slot = HashID(id) & mask; ; slot = (slot + 1) & mask)
+		{
+			const uint* entry = slots + (slot << 1);
+			if (entry[0] == id) return entry[1];
+			if (entry[0] == 0) return 0;
 		}
 	}
-	return false;
+};
+
+//============================================================================================================
+// Returns the identifier of the specified tag, adding it to the list of known tags if necessary
+//============================================================================================================
+
+uint TreeNode::GetID (const char* tag)
+{
+	const String* interned;
+	TagTable& table = GetTagTable();
+	table.Lock();
+	uint id = table.Intern(tag, interned);
+	table.Unlock();
+	return id;
 }
 
 //============================================================================================================
-// Retrieves a segment of bracketed text. 'out' will be set to the text inside the brackets, and
-// 'from' will be updated to be past the closing bracket.
+// Returns the identifier of the specified tag without interning it, or '0' if the tag has never been seen
 //============================================================================================================
-// Example: "abc[] { 123 } More = { 321 }"
-// Feeding the above string will return "abc[] { 123 }" in the 'out' parameter.
+
+uint TreeNode::FindID (const char* tag)
+{
+	TagTable& table = GetTagTable();
+	table.Lock();
+	uint id = table.Find(tag);
+	table.Unlock();
+	return id;
+}
+
+//============================================================================================================
+// Interns the current tag
 //============================================================================================================
 
-bool GetSegment (const String& s, uint& from, uint to, String& out)
+uint TreeNode::_UpdateID() const
 {
-	if (from < to)
+	TagTable& table = GetTagTable();
+	table.Lock();
+	mID = table.Intern(mTag.GetBuffer(), mIDTag);
+	table.Unlock();
+	return mID;
+}
+
+//============================================================================================================
+// Adds the child that was just added to the index. Children added to 'mChildren' directly change the count
+// instead, which makes the next search rebuild the index.
+//============================================================================================================
+
+void TreeNode::_AddToIndex()
+{
+	if (mIndex->mCount + 1 == mChildren.GetSize()) mIndex->Append(mChildren);
+}
+
+//============================================================================================================
+// Finds the first direct child with the specified tag using the index, building it if necessary.
+// A miss is final: children renamed in place must be followed by a call to InvalidateIndex().
+//============================================================================================================
+
+TreeNode* TreeNode::_FindIndexed (const char* tag)
+{
+	if (mIndex == 0)
 	{
-		// Skip empty characters
-		while (from < to && s[from] < 33) ++from;
+		mIndex = new Index();
+		mIndex->Build(mChildren);
+	}
+	else if (mIndex->mCount != mChildren.GetSize())
+	{
+		mIndex->Build(mChildren);
+	}
 
-		out.Clear();
-		int brackets = 0;
-		bool inQuotes = false;
+	// Building the index interns every child's tag, so a tag that was never interned can't match any of them
+	uint id = FindID(tag);
+	if (id == 0) return 0;
 
-		for (uint i = from; i < to; )
-		{
-			char ch = s[i];
+	uint index = mIndex->Find(id);
+	if (index == 0) return 0;
 
-			if (ch == '"')
-			{
-				inQuotes = !inQuotes;
-			}
-			else if (inQuotes)
-			{
-				// Append this character
-				out.Expand() = ch;
-			}
-			else if (ch == '/' && (i + 1 < to) && s[i+1] == '/')
-			{
-				// If a C++ style comment is encountered...
-				// Skip the rest of the line
-				for (i += 2; i < to; ++i)
-				{
-					if (s[i] < ' ') break;
-				}
-				continue;
-			}
-			else
-			{
-				// Append this character
-				out.Expand() = ch;
+	TreeNode& child = mChildren[index - 1];
+	if (child.GetID() == id) return &child;
 
-				if (ch == '{')
-				{
-					++brackets;
-				}
-				else if (ch == '}')
-				{
-					if (--brackets < 1)
-					{
-						// Move up the starting position
-						from = i + 1;
-						
-						// Skip empty characters
-						while (from < to && s[from] < 33) ++from;
-						return true;
-					}
-				}
-			}
-			++i;
-		}
+	// The child was renamed without invalidating the index
+	ASSERT(false, "Stale TreeNode index -- call InvalidateIndex() after renaming children");
+	mIndex->Build(mChildren);
+	index = mIndex->Find(id);
+	return (index != 0) ? &mChildren[index - 1] : 0;
+}
+
+//============================================================================================================
+// Releases the index of the children
+//============================================================================================================
+
+void TreeNode::_ReleaseIndex() const
+{
+	if (mIndex != 0)
+	{
+		delete mIndex;
+		mIndex = 0;
 	}
-	return false;
 }
 
 //============================================================================================================
@@ -162,10 +276,18 @@ bool GetSegment (const String& s, uint& from, uint to, String& out)
 
 TreeNode* TreeNode::FindChild (const String& tag, bool recursive)
 {
-	FOREACH(i, mChildren)
+	if (mChildren.GetSize() >= IndexThreshold)
 	{
-		TreeNode& child = mChildren[i];
-		if (child.mTag == tag) return &child;
+		TreeNode* child = _FindIndexed(tag.GetBuffer());
+		if (child != 0) return child;
+	}
+	else
+	{
+		FOREACH(i, mChildren)
+		{
+			TreeNode& child = mChildren[i];
+			if (child.mTag == tag) return &child;
+		}
 	}
 
 	if (recursive)
@@ -179,6 +301,30 @@ TreeNode* TreeNode::FindChild (const String& tag, bool recursive)
 	return 0;
 }
 
+//============================================================================================================
+// Finds a child with the specified tag, adding a new one if it doesn't exist
+//============================================================================================================
+
+TreeNode& TreeNode::AddUnique (const char* tag)
+{
+	if (mChildren.GetSize() >= IndexThreshold)
+	{
+		TreeNode* child = _FindIndexed(tag);
+		if (child != 0) return *child;
+	}
+	else
+	{
+		FOREACH(i, mChildren)
+		{
+			if (mChildren[i].mTag == tag)
+			{
+				return mChildren[i];
+			}
+		}
+	}
+	return AddChild(tag);
+}
+
 //============================================================================================================
 // Saves to the specified file, using the file's extension to determine whether it should be binary
 //============================================================================================================
@@ -239,10 +385,7 @@ bool TreeNode::Load (const byte* buffer, uint size)
 	// 'Root' header -- missing proper header type
 	if (buffer[0] == 'R' && buffer[1] == 'o' && buffer[2] == 'o' && buffer[3] == 't')
 	{
-		String s;
-		memcpy(s.Resize(size), buffer, size);
-		s[size] = 0;
-		return SerializeFrom(s);
+		return TreeParser::Parse((const char*)buffer, size, *this);
 	}
 
 	// Proper '//R5' header
@@ -255,13 +398,8 @@ bool TreeNode::Load (const byte* buffer, uint size)
 
 		if (type == 'A')
 		{
-			// Copy the memory into a string
-			String s;
-			memcpy(s.Resize(size), buffer, size);
-			s[size] = 0;
-
-			// Load the tree
-			return SerializeFrom(s);
+			// Parse the text directly from memory
+			return TreeParser::Parse((const char*)buffer, size, *this);
 		}
 		else if (type == 'B')
 		{
@@ -384,6 +522,7 @@ bool TreeNode::SerializeFrom (ConstBytePtr& buffer, uint& size)
 
 	if (Memory::Extract(buffer, size, mTag) && mValue.SerializeFrom(buffer, size))
 	{
+		GetID();
 		uint children;
 		
 		if (Memory::ExtractSize(buffer, size, children))
@@ -406,106 +545,32 @@ bool TreeNode::SerializeFrom (ConstBytePtr& buffer, uint& size)
 }
 
 //============================================================================================================
-// Serialize from the string format. Note that the text must be already clean -- no comments!
+// Serialize from the string format
 //============================================================================================================
 
 bool TreeNode::SerializeFrom (const String& s)
 {
-	Release();
-	uint from = 0, to = s.GetLength();
-
-	// Get the node's tag
-	if (GetPhrase(s, from, to, mTag))
-	{
-		// Serialize from this string
-		return ParseProperties(s, from, to);
-	}
-	return false;
+	return TreeParser::Parse(s.GetBuffer(), s.GetLength(), *this);
 }
 
 //============================================================================================================
-// Recursive text format parsing
+// Maps a fixed list of tags to their position in the list
 //============================================================================================================
 
-bool TreeNode::ParseProperties (const String& s, uint& from, uint to)
+TagMap::TagMap (const char* tags[])
 {
-	// If there is more, keep going
-	if (from < to)
+	for (uint i = 0; tags[i] != 0; ++i)
 	{
-		String temp;
+		uint id = TreeNode::GetID(tags[i]);
 
-		// If the from character is an equality sign, we must be expecting a value
-		if (s[from] == '=')
+		if (id >= mPositions.GetSize())
 		{
-			uint wordStart = ++from;
-
-			if (s.GetWord(temp, wordStart, to))
-			{
-				// If the from word ends with square brackets, then the array must follow
-				if (temp.EndsWith("[]"))
-				{
-					if (GetSegment(s, from, to, temp))
-					{
-						if (!mValue.SerializeFrom(temp))
-						{
-							ASSERT(false, "Failed to serialize the value");
-							return false;
-						}
-					}
-				}
-				else if (GetPhrase(s, from, to, temp))
-				{
-					if (!mValue.SerializeFrom(temp))
-					{
-						ASSERT(false, "Failed to serialize the value");
-						return false;
-					}
-				}
-			}
+			uint size = mPositions.GetSize();
+			mPositions.ExpandTo(id + 1);
+			for (; size <= id; ++size) mPositions[size] = Unknown;
 		}
 
-		// If the next character is an opening bracket, then this node has children
-		if (from < to && s[from] == '{')
-		{
-			uint closingBracket = from++, counter = 1;
-
-			// Find the correct closing bracket
-			while (counter)
-			{
-				if (++closingBracket < to)
-				{
-					if		(s[closingBracket] == '}')  --counter;
-					else if (s[closingBracket] == '{')  ++counter;
-				}
-				else
-				{
-					ASSERT(false, "Unable to find the matching bracket");
-					return false;
-				}
-			}
-
-			// Keep going until the closing bracket is reached
-			while (from < closingBracket)
-			{
-				// Get the node's tag, and if failed just break out
-				if (!GetPhrase(s, from, to, temp)) break;
-
-				// Add this child
-				TreeNode& child = mChildren.Expand();
-				child.mTag = temp;
-
-				// Serialize the child -- if failed, just break out
-				if (!child.ParseProperties(s, from, closingBracket))
-				{
-					mChildren.Shrink();
-					break;
-				}
-			}
-
-			// Skip the closing bracket
-			from = closingBracket + 1;
-		}
-		return true;
+		// Duplicate tags keep their first position
+		if (mPositions[id] == Unknown) mPositions[id] = i;
 	}
-	return true;
-}
\ No newline at end of file
+}
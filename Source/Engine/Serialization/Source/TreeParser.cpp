@@ -0,0 +1,613 @@
+#include "../Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Helper functions that work on ranges of the raw buffer
+//============================================================================================================
+
+namespace
+{
+typedef Variable::Type VT;
+
+// Exact powers of ten that can be represented by a double
+const double g_pow10[] =
+{
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+//============================================================================================================
+// Same rules as the ones used by String::GetWord() and String::GetLine()
+//============================================================================================================
+
+inline bool IsWordChar (char c) { return (c > ' ') && (c < '~'); }
+inline bool IsDigit (char c) { return (c >= '0') && (c <= '9'); }
+inline bool IsComment (const char* pos, const char* end) { return (pos + 1 < end) && (pos[0] == '/') && (pos[1] == '/'); }
+
+//============================================================================================================
+// Parses an integer, returning 'false' if it's not a plain decimal number that fits into 31 bits
+//============================================================================================================
+
+inline bool ParseInt (const char*& pos, const char* end, int& out, bool sign)
+{
+	const char* p = pos;
+	bool negative = false;
+
+	if (sign && p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+
+	const char* digits = p;
+	int val = 0;
+
+	for (; p < end && IsDigit(*p); ++p) val = val * 10 + (*p - '0');
+	if (p == digits || p - digits > 9) return false;
+
+	out = negative ? -val : val;
+	pos = p;
+	return true;
+}
+
+//============================================================================================================
+// Parses a floating point value in decimal notation. Values that can't be converted exactly using double
+// precision math (more than 15 significant digits, or huge exponents) are left to the generic conversion.
+//============================================================================================================
+
+inline bool ParseFloat (const char*& pos, const char* end, float& out)
+{
+	const char* p = pos;
+	bool negative = false;
+
+	if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+
+	double val = 0.0;
+	int digits = 0, exponent = 0;
+	bool found = false;
+
+	// Whole part
+	for (; p < end && IsDigit(*p); ++p, found = true)
+	{
+		if (digits < 15)
+		{
+			val = val * 10.0 + (*p - '0');
+			if (val != 0.0) ++digits;
+		}
+		else ++exponent;
+	}
+
+	// Fractional part
+	if (p < end && *p == '.')
+	{
+		for (++p; p < end && IsDigit(*p); ++p, found = true)
+		{
+			if (digits < 15)
+			{
+				val = val * 10.0 + (*p - '0');
+				if (val != 0.0) ++digits;
+				--exponent;
+			}
+		}
+	}
+
+	if (!found) return false;
+
+	// Optional exponent
+	if (p < end && (*p == 'e' || *p == 'E'))
+	{
+		const char* e = p + 1;
+		bool negExp = false;
+		if (e < end && (*e == '-' || *e == '+')) negExp = (*e++ == '-');
+
+		if (e < end && IsDigit(*e))
+		{
+			int exp = 0;
+			for (; e < end && IsDigit(*e); ++e) if (exp < 1000) exp = exp * 10 + (*e - '0');
+			exponent += negExp ? -exp : exp;
+			p = e;
+		}
+	}
+
+	if (exponent < -22 || exponent > 22) return false;
+
+	if		(exponent < 0) val /= g_pow10[-exponent];
+	else if (exponent > 0) val *= g_pow10[ exponent];
+
+	out = (float)(negative ? -val : val);
+	pos = p;
+	return true;
+}
+
+//============================================================================================================
+
+inline bool ParseValue (const char*& pos, const char* end, float& out)	{ return ParseFloat(pos, end, out); }
+inline bool ParseValue (const char*& pos, const char* end, int& out)	{ return ParseInt(pos, end, out, true); }
+
+//============================================================================================================
+// Parses exactly the specified number of space-separated values, failing if anything else is on the line
+//============================================================================================================
+
+template <typename Type>
+inline bool ParseValues (const char* pos, const char* end, Type* out, uint count)
+{
+	for (uint i = 0; i < count; ++i)
+	{
+		if (i > 0)
+		{
+			if (pos == end || (*pos != ' ' && *pos != '\t')) return false;
+			while (pos < end && (*pos == ' ' || *pos == '\t')) ++pos;
+		}
+
+		if (!ParseValue(pos, end, out[i])) return false;
+	}
+	return (pos == end);
+}
+
+//============================================================================================================
+// Parses all words on the line, the same way PARSE_MULTIPLE_CASE does it in Variable.cpp
+//============================================================================================================
+
+template <typename Type>
+void ParseWords (Array<Type>& arr, const char* pos, const char* end, bool sign, String& temp)
+{
+	for (;;)
+	{
+		while (pos < end && !IsWordChar(*pos)) ++pos;
+		if (pos == end) break;
+
+		const char* wordEnd = pos;
+		while (wordEnd < end && IsWordChar(*wordEnd)) ++wordEnd;
+
+		const char* p = pos;
+		int val;
+
+		if (ParseInt(p, wordEnd, val, sign) && p == wordEnd)
+		{
+			arr.Expand() = (Type)val;
+		}
+		else
+		{
+			uint length = (uint)(wordEnd - pos);
+			memcpy(temp.Resize(length), pos, length);
+			temp >> arr.Expand();
+		}
+		pos = wordEnd;
+	}
+}
+
+//============================================================================================================
+// Determines the type of the array from its name
+//============================================================================================================
+
+uint GetArrayType (const char* name, const char* end)
+{
+	String type;
+	uint length = (uint)(end - name);
+	memcpy(type.Resize(length), name, length);
+
+	if		(type == "Bool")	return VT::Bool;
+	else if (type == "Int")		return VT::Int;
+	else if (type == "UInt")	return VT::UInt;
+	else if (type == "UShort")	return VT::UShort;
+	else if (type == "Short2")	return VT::Short2;
+	else if (type == "Float")	return VT::Float;
+	else if (type == "Float2")	return VT::Float2;
+	else if (type == "Float3")	return VT::Float3;
+	else if (type == "Float4")	return VT::Float4;
+	else if (type == "Color")	return VT::Color;
+	return VT::Invalid;
+}
+
+//============================================================================================================
+// Handler that builds the TreeNode hierarchy
+//============================================================================================================
+
+class TreeBuilder : public TreeParser::Handler
+{
+	TreeNode&			mRoot;
+	Array<TreeNode*>	mStack;
+
+public:
+
+	TreeBuilder (TreeNode& root) : mRoot(root) {}
+
+	virtual bool OnNodeStart (const String& tag, Variable& value)
+	{
+		TreeNode* node = mStack.IsEmpty() ? &mRoot : &mStack.Back()->mChildren.Expand();
+		node->mTag = tag;
+		node->mValue.Swap(value);
+		node->GetID();
+		mStack.Expand() = node;
+		return true;
+	}
+
+	virtual void OnNodeEnd() { mStack.Shrink(); }
+};
+} // anonymous namespace
+
+//============================================================================================================
+// Parses all nodes in the text, passing them to the handler
+//============================================================================================================
+
+bool TreeParser::Parse (const char* text, uint length, Handler& handler)
+{
+	TreeParser parser (text, length, handler);
+	bool retVal = false;
+
+	for (;;)
+	{
+		parser._SkipSpaces();
+		if (parser.mStop || parser.mPos == parser.mEnd) break;
+		if (!parser._ParseNode()) return false;
+		retVal = true;
+	}
+	return retVal;
+}
+
+//============================================================================================================
+// Replaces the tree's contents with the first node found in the text
+//============================================================================================================
+
+bool TreeParser::Parse (const char* text, uint length, TreeNode& root)
+{
+	root.Release();
+	TreeBuilder builder (root);
+	TreeParser parser (text, length, builder);
+	return parser._ParseNode();
+}
+
+//============================================================================================================
+// Copies the specified range into the temporary string
+//============================================================================================================
+
+const String& TreeParser::_ToString (const char* from, const char* to)
+{
+	uint length = (uint)(to - from);
+	memcpy(mTemp.Resize(length), from, length);
+	return mTemp;
+}
+
+//============================================================================================================
+// Skips spaces, tabs, line breaks and comments
+//============================================================================================================
+
+void TreeParser::_SkipSpaces()
+{
+	while (mPos < mEnd)
+	{
+		if (*mPos < 33)
+		{
+			++mPos;
+		}
+		else if (IsComment(mPos, mEnd))
+		{
+			for (mPos += 2; mPos < mEnd && *mPos != '\n' && *mPos != '\r'; ++mPos) {}
+		}
+		else break;
+	}
+}
+
+//============================================================================================================
+// Skips everything up to and including the closing bracket of the current block
+//============================================================================================================
+
+void TreeParser::_SkipBlock()
+{
+	for (uint brackets = 1; mPos < mEnd; )
+	{
+		char ch = *mPos++;
+		if (ch == '{') ++brackets;
+		else if (ch == '}' && --brackets == 0) break;
+	}
+}
+
+//============================================================================================================
+// Retrieves a single phrase such as a tag or a value. Spaces are allowed within the phrase, but line breaks,
+// brackets, equality signs and comments end it unless they're inside quotes.
+//============================================================================================================
+
+bool TreeParser::_GetPhrase (String& out)
+{
+	_SkipSpaces();
+	if (mPos == mEnd) return false;
+
+	char ch = *mPos;
+	if (ch > '~' || ch == '{' || ch == '}' || ch == '=') return false;
+
+	const char* start	= mPos;
+	const char* last	= mPos;
+	bool inQuotes		= false;
+
+	for (; mPos < mEnd; ++mPos)
+	{
+		ch = *mPos;
+		if (ch == ' ' || ch == '\t') continue;
+
+		// Keep track of whether we're inside quoted strings or not
+		if (ch == '"') inQuotes = !inQuotes;
+
+		if (!inQuotes)
+		{
+			// If we found a comment, the rest of the line should be ignored
+			if (IsComment(mPos, mEnd))
+			{
+				for (mPos += 2; mPos < mEnd && *mPos != '\n' && *mPos != '\r'; ++mPos) {}
+				break;
+			}
+
+			// If it's an end-of-phrase character, stop
+			if (ch < ' ' || ch == '=' || ch > '~' || ch == '{' || ch == '}') break;
+		}
+		last = mPos;
+	}
+
+	uint length = (uint)(last + 1 - start);
+	memcpy(out.Resize(length), start, length);
+
+	// Skip trailing spaces
+	while (mPos < mEnd && *mPos < 33) ++mPos;
+	return true;
+}
+
+//============================================================================================================
+// Parses the node at the current position along with all of its children
+//============================================================================================================
+
+bool TreeParser::_ParseNode()
+{
+	if (!_GetPhrase(mTag)) return false;
+	mValue.Release();
+
+	// If the tag is followed by an equality sign, the value must follow
+	if (mPos < mEnd && *mPos == '=' && !_ParseValue())
+	{
+		ASSERT(false, "Failed to serialize the value");
+		mValue.Release();
+	}
+
+	_SkipSpaces();
+
+	if (!mHandler->OnNodeStart(mTag, mValue))
+	{
+		mStop = true;
+		return true;
+	}
+
+	// If the next character is an opening bracket, then this node has children
+	if (mPos < mEnd && *mPos == '{')
+	{
+		for (++mPos; ; )
+		{
+			_SkipSpaces();
+
+			if (mPos == mEnd)
+			{
+				ASSERT(false, "Unable to find the matching bracket");
+				mHandler->OnNodeEnd();
+				return false;
+			}
+
+			if (*mPos == '}')
+			{
+				++mPos;
+				break;
+			}
+
+			if (!_ParseNode())
+			{
+				// Missing brackets can't be recovered from
+				if (mPos == mEnd)
+				{
+					mHandler->OnNodeEnd();
+					return false;
+				}
+
+				// Unexpected character -- ignore the rest of the block
+				_SkipBlock();
+				break;
+			}
+
+			if (mStop) return true;
+		}
+	}
+
+	mHandler->OnNodeEnd();
+	return true;
+}
+
+//============================================================================================================
+// Parses the value following the equality sign
+//============================================================================================================
+
+bool TreeParser::_ParseValue()
+{
+	const char* word = ++mPos;
+	while (word < mEnd && !IsWordChar(*word)) ++word;
+
+	const char* wordEnd = word;
+	while (wordEnd < mEnd && IsWordChar(*wordEnd)) ++wordEnd;
+
+	// If the first word ends with square brackets, then the array must follow
+	if (wordEnd - word > 1 && wordEnd[-2] == '[' && wordEnd[-1] == ']')
+	{
+		return _ParseArray(word, wordEnd - 2);
+	}
+
+	// Single values are small enough to go through the generic conversion
+	return _GetPhrase(mTemp) ? mValue.SerializeFrom(mTemp) : true;
+}
+
+//============================================================================================================
+// Parses an array of the specified type, such as "Float3[] { ... }"
+//============================================================================================================
+
+bool TreeParser::_ParseArray (const char* type, const char* typeEnd)
+{
+	for (mPos = typeEnd + 2; mPos < mEnd && *mPos < 33; ++mPos) {}
+
+	if (mPos < mEnd && *mPos == '{' && _ParseNumbers(GetArrayType(type, typeEnd))) return true;
+
+	// Everything else goes through the generic conversion
+	mValue.Release();
+	mPos = type;
+	return _GetSegment() && mValue.SerializeFrom(mTemp);
+}
+
+//============================================================================================================
+// Numeric arrays are parsed in place, line by line
+//============================================================================================================
+
+bool TreeParser::_ParseNumbers (uint type)
+{
+	// Make sure that the array exists even if it ends up being empty
+	switch (type)
+	{
+		case VT::Int:		mValue.ToIntArray();		break;
+		case VT::UInt:		mValue.ToUIntArray();		break;
+		case VT::UShort:	mValue.ToUShortArray();		break;
+		case VT::Short2:	mValue.ToVector2iArray();	break;
+		case VT::Float:		mValue.ToFloatArray();		break;
+		case VT::Float2:	mValue.ToVector2fArray();	break;
+		case VT::Float3:	mValue.ToVector3fArray();	break;
+		case VT::Float4:	mValue.ToQuaternionArray();	break;
+		default:			return false;
+	}
+
+	for (const char* pos = mPos + 1; ; )
+	{
+		// Skip to the beginning of the next line
+		while (pos < mEnd && !IsWordChar(*pos)) ++pos;
+		if (pos == mEnd) return false;
+
+		if (*pos == '}')
+		{
+			for (mPos = pos + 1; mPos < mEnd && *mPos < 33; ++mPos) {}
+			return true;
+		}
+
+		// Find the end of the line. Quotes, comments and brackets need the generic path.
+		const char* lineEnd = pos;
+
+		for (; lineEnd < mEnd; ++lineEnd)
+		{
+			char ch = *lineEnd;
+			if (ch == '\n' || ch == '\r' || ch == '}') break;
+			if (ch == '"' || ch == '/' || ch == '{') return false;
+		}
+
+		// Skip trailing spaces
+		const char* end = lineEnd;
+		while (end > pos && end[-1] < 33) --end;
+
+		_ParseLine(type, pos, end);
+		pos = lineEnd;
+	}
+}
+
+//============================================================================================================
+// Parses a single line of a numeric array. Lines that are not in the expected format (such as Euler angles
+// used in place of quaternions) go through the same string conversion that Variable::SerializeFrom() uses.
+//============================================================================================================
+
+void TreeParser::_ParseLine (uint type, const char* pos, const char* end)
+{
+	float f[4];
+	int i[2];
+
+	switch (type)
+	{
+		case VT::Int:		ParseWords(mValue.ToIntArray(),		pos, end, true,  mTemp);	break;
+		case VT::UInt:		ParseWords(mValue.ToUIntArray(),	pos, end, false, mTemp);	break;
+		case VT::UShort:	ParseWords(mValue.ToUShortArray(),	pos, end, false, mTemp);	break;
+
+		case VT::Short2:
+		{
+			Vector2i& v = mValue.ToVector2iArray().Expand();
+
+			if (ParseValues(pos, end, i, 2))
+			{
+				v.x = (short)i[0];
+				v.y = (short)i[1];
+			}
+			else _ToString(pos, end) >> v;
+		}
+		break;
+
+		case VT::Float:
+		{
+			float& v = mValue.ToFloatArray().Expand();
+			if (ParseValues(pos, end, f, 1)) v = f[0];
+			else _ToString(pos, end) >> v;
+		}
+		break;
+
+		case VT::Float2:
+		{
+			Vector2f& v = mValue.ToVector2fArray().Expand();
+			if (ParseValues(pos, end, f, 2)) v.Set(f[0], f[1]);
+			else _ToString(pos, end) >> v;
+		}
+		break;
+
+		case VT::Float3:
+		{
+			Vector3f& v = mValue.ToVector3fArray().Expand();
+			if (ParseValues(pos, end, f, 3)) v.Set(f[0], f[1], f[2]);
+			else _ToString(pos, end) >> v;
+		}
+		break;
+
+		case VT::Float4:
+		{
+			Quaternion& v = mValue.ToQuaternionArray().Expand();
+			if (ParseValues(pos, end, f, 4)) v.Set(f[0], f[1], f[2], f[3]);
+			else _ToString(pos, end) >> v;
+		}
+		break;
+	}
+}
+
+//============================================================================================================
+// Copies the bracketed array into the temporary string, skipping comments and removing quotes the same way
+// the text parser always did. The result is in the "Type[] { ... }" format expected by Variable.
+//============================================================================================================
+
+bool TreeParser::_GetSegment()
+{
+	mTemp.Clear();
+	int brackets = 0;
+	bool inQuotes = false;
+
+	while (mPos < mEnd)
+	{
+		char ch = *mPos;
+
+		if (ch == '"')
+		{
+			inQuotes = !inQuotes;
+		}
+		else if (inQuotes)
+		{
+			mTemp.Expand() = ch;
+		}
+		else if (IsComment(mPos, mEnd))
+		{
+			// Skip the rest of the line
+			for (mPos += 2; mPos < mEnd && *mPos >= ' '; ++mPos) {}
+			continue;
+		}
+		else
+		{
+			mTemp.Expand() = ch;
+
+			if (ch == '{')
+			{
+				++brackets;
+			}
+			else if (ch == '}' && --brackets < 1)
+			{
+				for (++mPos; mPos < mEnd && *mPos < 33; ++mPos) {}
+				return true;
+			}
+		}
+		++mPos;
+	}
+	return false;
+}
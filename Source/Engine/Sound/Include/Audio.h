@@ -20,13 +20,20 @@ protected:
 
 	Hash<AudioLayer>		mLayers;
 	LinkedList<Sound*>		mSounds;
+	AudioDecoder			mDecoder;
+	SoundCache				mCache;
 
 public:
-	Audio();
+	// If 'nullDevice' is 'true', the audio is processed without being output anywhere (headless mode)
+	Audio(bool nullDevice = false);
 
 	virtual AudioLayer* GetLayer(uint layer) 
 				{ return &mLayers[layer]; }
 
+	// Cache that keeps the decoded data of static sounds within a memory budget
+	SoundCache& GetCache()
+				{ return mCache; }
+
 	virtual void SetListener(const Vector3f& position, const Vector3f& direction, const Vector3f& up, const Vector3f& velocity);
 
 	virtual ISound* GetSound(const String& name, bool createIfMissing = true);
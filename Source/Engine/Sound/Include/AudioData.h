@@ -13,6 +13,10 @@
 
 #pragma once
 
+//============================================================================================================
+// Compressed audio data. Once loaded it is never modified -- decoding is done through an AudioStream.
+//============================================================================================================
+
 class AudioData
 {
 private:
@@ -20,24 +24,18 @@ private:
 
 	uint	mChannels;
 	uint	mRate;
-
-	uint	mChunkSize;
-	bool	mEOF;
-
-	OggVorbis_File*	mOggFile;
+	long	mLength;
 
 public:
 	AudioData();
-	~AudioData();
 
+	const Memory& GetData() const		{ return mData; }
 	uint GetChannels() const			{ return mChannels; }
 	uint GetRate() const				{ return mRate; }
-	void SetChunkSize(uint size)		{ mChunkSize = size; }
-	bool IsEOF() const					{ return mEOF; }
+	long GetLength() const				{ return mLength; }
 
-	long GetLength() const;
 	bool Load(const String& name);
-	void Decode(Memory& dataOut);
-	void Reset();
-};
 
+	// Decodes the entire stream
+	void Decode(Memory& dataOut) const;
+};
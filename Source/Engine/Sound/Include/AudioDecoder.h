@@ -0,0 +1,52 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class StreamedInstance;
+
+//============================================================================================================
+// Background worker thread that keeps the rings of all streamed instances filled with decoded PCM data.
+// The lock only guards the list of streams and is never held while decoding. The main thread uses
+// LockStream() whenever it needs to reset a stream, which also waits for the worker to finish with it.
+//============================================================================================================
+
+class AudioDecoder : public Thread::Lockable
+{
+private:
+
+	Array<StreamedInstance*>	mStreams;	// All streams that should be kept filled
+	Array<StreamedInstance*>	mQueue;		// Copy of the list above that the worker thread is going through
+	StreamedInstance* volatile	mCurrent;	// Stream the worker thread is decoding right now
+	Thread::ValType				mActive;	// Whether the worker thread is running
+	volatile bool				mStop;		// Signals the worker thread to exit
+
+public:
+
+	AudioDecoder();
+	~AudioDecoder();
+
+	// Starts the worker thread
+	void Start();
+
+	// Stops the worker thread, waiting for it to exit
+	void Stop();
+
+	// Registers or removes a stream that should be kept filled
+	void Add	(StreamedInstance* stream);
+	void Remove	(StreamedInstance* stream);
+
+	// Locks the decoder, first waiting for the worker thread to finish decoding the specified stream.
+	// The worker won't touch the stream until Unlock() gets called.
+	void LockStream (StreamedInstance* stream);
+
+	// INTERNAL: Decodes the next chunk of every stream that has room for it. Returns 'false' if all rings are full.
+	bool _Decode();
+
+	// INTERNAL: Worker thread's main loop
+	void _Run();
+};
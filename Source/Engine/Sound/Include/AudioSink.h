@@ -0,0 +1,106 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Output targets for the software mixer
+// Author: Michael Lyashenko
+//============================================================================================================
+
+//============================================================================================================
+// Receives the mixed interleaved 16-bit stereo output of the SoftAudio mixer
+//============================================================================================================
+
+class AudioSink
+{
+public:
+
+	virtual ~AudioSink() {}
+
+	// Returns the number of frames the sink would like to receive, given how much time has passed
+	virtual uint GetDemand (uint elapsedFrames) { return elapsedFrames; }
+
+	// Consumes the mixed frames
+	virtual void Write (const short* samples, uint frames)=0;
+};
+
+//============================================================================================================
+// Discards the output -- used to run the mixer headless
+//============================================================================================================
+
+class NullSink : public AudioSink
+{
+protected:
+
+	uint mFrames;
+
+public:
+
+	NullSink() : mFrames(0) {}
+
+	// Total number of frames received so far
+	uint GetFrames() const { return mFrames; }
+
+	virtual void Write (const short* samples, uint frames) { mFrames += frames; }
+};
+
+//============================================================================================================
+// Writes the output into a 16-bit stereo WAV file
+//============================================================================================================
+
+class WavSink : public AudioSink
+{
+protected:
+
+	FILE*	mFile;
+	uint	mRate;
+	uint	mFrames;
+
+public:
+
+	WavSink (const String& filename, uint rate = 44100);
+	virtual ~WavSink();
+
+	bool IsValid() const	{ return mFile != 0; }
+	uint GetFrames() const	{ return mFrames; }
+
+	virtual void Write (const short* samples, uint frames);
+
+private:
+
+	// Writes the RIFF header for the current number of frames
+	void _WriteHeader();
+};
+
+//============================================================================================================
+// Plays the output through a single streaming OpenAL source on the default device
+//============================================================================================================
+
+class StreamSink : public AudioSink
+{
+public:
+
+	enum
+	{
+		BufferCount = 4,
+	};
+
+protected:
+
+	uint	mRate;
+	uint	mBlock;					// Frames per buffer
+	uint	mSource;
+	uint	mBuffers[BufferCount];
+	uint	mFree[BufferCount];		// Buffers that are not currently queued
+	uint	mFreeCount;
+
+public:
+
+	StreamSink (uint rate = 44100, uint blockFrames = 2048);
+	virtual ~StreamSink();
+
+	// Demand is driven by the number of buffers OpenAL has finished playing rather than time
+	virtual uint GetDemand (uint elapsedFrames);
+	virtual void Write (const short* samples, uint frames);
+};
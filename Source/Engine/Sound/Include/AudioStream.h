@@ -0,0 +1,49 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Author: Eugene Gorodinsky
+//============================================================================================================
+
+//============================================================================================================
+// Decoding state of a single playback of an AudioData. The compressed data itself is shared and never
+// modified, so any number of streams can decode the same AudioData simultaneously.
+//============================================================================================================
+
+class AudioStream
+{
+public:
+	// Read position within the shared compressed data
+	struct Cursor
+	{
+		const Memory*	mData;
+		uint			mOffset;
+	};
+
+private:
+	const AudioData*	mSource;
+	Cursor				mCursor;
+	OggVorbis_File		mOggFile;
+	bool				mEOF;
+
+public:
+	AudioStream() : mSource(0), mEOF(false) {}
+	~AudioStream() { Close(); }
+
+	bool IsOpen() const	{ return mSource != 0; }
+	bool IsEOF() const	{ return mEOF; }
+
+	bool Open(const AudioData* source);
+	void Close();
+
+	// Ogg/Vorbis decoder state, valid while the stream is open
+	OggVorbis_File* GetOggFile() { return &mOggFile; }
+
+	// Decodes up to 'chunkSize' bytes (or everything, if it's 0) starting at the current position
+	void Decode(Memory& dataOut, uint chunkSize = 0);
+
+	// Rewinds the stream to the beginning
+	void Reset();
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Audio controller that mixes all voices on the CPU rather than relying on OpenAL sources. There is no
+// limit on the number of voices: only the loudest 'max voices' are mixed, the rest are tracked virtually.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class SoftAudio : public IAudio
+{
+public:
+
+	enum
+	{
+		BlockFrames = 512,	// Maximum number of frames mixed at once
+	};
+
+	struct Stats
+	{
+		uint	mVoices;		// Voices that are currently playing
+		uint	mMixed;			// Voices mixed during the last block
+		uint	mVirtual;		// Virtual voices during the last block
+		double	mVoiceFrames;	// Total number of frames mixed across all voices
+		double	mMixTime;		// Total time spent mixing, in milliseconds
+
+		Stats() : mVoices(0), mMixed(0), mVirtual(0), mVoiceFrames(0.0), mMixTime(0.0) {}
+
+		// Mixing throughput: number of voices mixed per millisecond, each voice being 'BlockFrames' long
+		double GetVoicesPerMs() const { return (mMixTime > 0.0) ? (mVoiceFrames / BlockFrames) / mMixTime : 0.0; }
+	};
+
+protected:
+
+	// Voice along with its loudness, used to pick the voices that get mixed
+	struct Audible
+	{
+		SoftVoice*	mVoice;
+		float		mLevel;
+	};
+
+	Thread::Lockable		mLock;
+	AudioSink*				mSink;
+	uint					mRate;
+	uint					mMaxVoices;
+	ulong					mLastUpdate;
+	uint					mRemainder;		// Leftover time from the previous update (in 1/1000 of a frame)
+	PointerArray<SoftSound>	mSounds;
+	PointerArray<SoftLayer>	mLayers;
+	Array<SoftVoice*>		mVoices;
+	Array<Audible>			mAudible;
+	Memory					mMaster;		// Planar float mix of all layers
+	Memory					mOutput;		// Interleaved 16-bit output buffer
+	Vector3f				mListenerPos;
+	Vector3f				mListenerRight;
+	Stats					mStats;
+
+public:
+
+	// The mixer takes ownership of the sink. If none is specified, the output is discarded.
+	SoftAudio (AudioSink* sink = 0, uint rate = 44100);
+	virtual ~SoftAudio();
+
+	uint GetRate() const				{ return mRate; }
+	uint GetMaxVoices() const			{ return mMaxVoices; }
+	void SetMaxVoices (uint count)		{ mMaxVoices = count; }
+	AudioSink* GetSink()				{ return mSink; }
+	const Stats& GetStats() const		{ return mStats; }
+	void ResetStats()					{ mStats = Stats(); }
+
+	// Mixes the specified number of frames and sends them to the sink, regardless of the sink's demand
+	void Mix (uint frames);
+
+	// Adds a sound using already decoded 16-bit PCM data rather than loading it from a file
+	ISound* CreateSound (const String& name, const short* samples, uint frames, uint channels, uint rate);
+
+public:
+
+	virtual void Release();
+	virtual void Update();
+	virtual bool Release (ISound* sound);
+	virtual void SetListener (const Vector3f& position, const Vector3f& dir, const Vector3f& up, const Vector3f& velocity);
+	virtual IAudioLayer* GetLayer (uint layer);
+	virtual ISound* GetSound (const String& name, bool createIfMissing = true);
+	virtual ISoundInstance* Instantiate (ISound* sound, uint layer, float fadeInTime, bool repeat = false);
+	virtual ISoundInstance* Instantiate (ISound* sound, const Vector3f& position, uint layer, float fadeInTime, bool repeat = false);
+
+	// INTERNAL: Removes the voice and deletes it
+	void _Destroy (SoftVoice* voice);
+
+private:
+
+	SoftLayer* _GetLayer (uint layer);
+	SoftVoice* _Instantiate (ISound* sound, uint layer, bool spatial, float fadeInTime, bool repeat);
+	void _MixBlock (short* out, uint frames);
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Software mixer's bus: voices are mixed into their layer, which is then mixed into the output
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class SoftLayer : public IAudioLayer
+{
+	friend class SoftAudio;
+
+protected:
+
+	float	mVolume;
+	Memory	mBus;		// Planar float buffer: left channel followed by the right channel
+	bool	mActive;	// Whether anything was mixed into the bus during the current block
+
+public:
+
+	SoftLayer() : mVolume(1.0f), mActive(false) {}
+
+	virtual float GetVolume() const			{ return mVolume; }
+	virtual void  SetVolume (float volume)	{ mVolume = Clamp(volume, 0.0f, 1.0f); }
+};
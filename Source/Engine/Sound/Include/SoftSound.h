@@ -0,0 +1,40 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Fully decoded sound used by the software mixer
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class SoftSound : public ISound
+{
+	friend class SoftAudio;
+
+protected:
+
+	String	mName;
+	Memory	mData;		// Decoded 16-bit PCM data
+	uint	mChannels;
+	uint	mRate;
+	uint	mFrames;
+	uint	mRefCount;	// Number of voices using this sound
+
+public:
+
+	SoftSound (const String& name) : mName(name), mChannels(1), mRate(44100), mFrames(0), mRefCount(0) {}
+
+	virtual const String& GetName() const { return mName; }
+
+	const short*	GetSamples()	const	{ return (const short*)mData.GetBuffer(); }
+	uint			GetChannels()	const	{ return mChannels; }
+	uint			GetRate()		const	{ return mRate; }
+	uint			GetFrames()		const	{ return mFrames; }
+
+	// Loads and decodes the sound
+	bool Load();
+
+	// Uses the specified 16-bit PCM data instead of loading it, such as a generated tone
+	void Set (const short* samples, uint frames, uint channels, uint rate);
+};
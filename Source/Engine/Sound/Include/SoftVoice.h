@@ -0,0 +1,69 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Sound instance played by the software mixer. Voices that can't be heard become virtual: they are no
+// longer mixed, but keep advancing their playback position so they resume in the right spot.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class SoftAudio;
+
+class SoftVoice : public ISoundInstance
+{
+	friend class SoftAudio;
+
+public:
+
+	struct State
+	{
+		enum
+		{
+			Stopped = 0,
+			Playing,
+			Paused,
+		};
+	};
+
+protected:
+
+	SoftAudio*	mAudio;
+	SoftSound*	mSound;
+	SoftLayer*	mLayer;
+	uint		mState;
+	bool		mRepeat;
+	bool		mSpatial;
+	bool		mVirtual;		// Whether the voice was only tracked rather than mixed during the last update
+	float		mVolume;
+	float		mFade;			// Current fade-in multiplier
+	float		mFadeSpeed;		// Fade-in rate per second
+	double		mCursor;		// Playback position in source frames
+	Vector3f	mPosition;
+	Vector3f	mVelocity;
+	float		mGain[2];		// Left and right channel gain for the current block
+
+public:
+
+	SoftVoice (SoftAudio* audio, SoftSound* sound, SoftLayer* layer, bool spatial, bool repeat, float fadeInTime);
+
+	virtual bool IsStopped()	const	{ return mState == State::Stopped;	}
+	virtual bool IsPaused()		const	{ return mState == State::Paused;	}
+	bool		 IsVirtual()	const	{ return mVirtual;					}
+
+	virtual void DestroySelf();
+
+	virtual void Play()		{ mState = State::Playing; }
+	virtual void Pause()	{ if (mState == State::Playing) mState = State::Paused; }
+	virtual void Stop()		{ mState = State::Stopped; mCursor = 0.0; }
+
+	virtual void SetPosition (const Vector3f& position)	{ mPosition = position; }
+	virtual void SetVelocity (const Vector3f& velocity)	{ mVelocity = velocity; }
+	virtual void SetVolume	 (float volume)				{ mVolume = Clamp(volume, 0.0f, 1.0f); }
+	virtual void SetRepeat	 (bool repeat)				{ mRepeat = repeat; }
+	virtual void SetEffect	 (byte effect)				{}
+
+	virtual float			GetVolume() const	{ return mVolume; }
+	virtual IAudioLayer*	GetLayer()	const	{ return mLayer; }
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Keeps the decoded PCM data of static sounds within a memory budget by evicting the least recently used
+// sounds that have no instances. Evicted sounds are decoded again the next time they are instantiated.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class StaticSound;
+
+class SoundCache
+{
+public:
+
+	struct Stats
+	{
+		uint	mResident;		// Bytes of decoded PCM data currently uploaded
+		uint	mCompressed;	// Bytes of compressed data kept in memory
+		uint	mSounds;		// Number of sounds with resident PCM data
+		uint	mHits;			// Instantiations that found the sound's data resident
+		uint	mMisses;		// Instantiations that had to decode the sound
+		uint	mEvictions;		// Number of times a sound's PCM data was released
+
+		Stats() : mResident(0), mCompressed(0), mSounds(0), mHits(0), mMisses(0), mEvictions(0) {}
+	};
+
+protected:
+
+	Array<StaticSound*>	mSounds;		// Sounds with resident data, least recently used first
+	uint				mBudget;		// Maximum number of resident bytes (0 = unlimited)
+	bool				mCompressed;	// Whether to keep the compressed data of evicted sounds in memory
+	Stats				mStats;
+
+public:
+
+	SoundCache() : mBudget(0), mCompressed(false) {}
+
+	// Maximum number of bytes of decoded PCM data to keep resident (0 = unlimited)
+	uint GetBudget() const { return mBudget; }
+	void SetBudget (uint bytes) { mBudget = bytes; Trim(); }
+
+	// Keeping the compressed data resident means evicted sounds are decoded from memory rather than read from disk
+	bool GetKeepCompressed() const { return mCompressed; }
+	void SetKeepCompressed (bool val) { mCompressed = val; }
+
+	const Stats& GetStats() const { return mStats; }
+
+	// Makes sure the sound's PCM data is resident, marking the sound as the most recently used one
+	bool Acquire (StaticSound* sound);
+
+	// Removes the sound from the cache -- should be called before the sound gets deleted
+	void Remove (StaticSound* sound);
+
+	// Evicts the least recently used sounds without any instances until the resident data fits the budget
+	void Trim();
+
+private:
+
+	// Updates the amount of compressed data kept in memory after the sound was loaded or unloaded
+	void _Account (StaticSound* sound);
+};
@@ -42,6 +42,9 @@ protected:
 	SoundInstance(Sound* sound);
 	virtual ~SoundInstance();
 
+	// Removes the instance from its layer and the list of active instances
+	void _Detach();
+
 public:
 	void SetSpatial(bool isSpatial);
 
@@ -8,19 +8,37 @@
 //============================================================================================================
 
 class SoundInstance;
+class SoundCache;
 
 class StaticSound: public Sound
 {
+friend class SoundCache;
+
 protected:
 	StaticSound() {}
 
 protected:
-	uint mBuffer;
+	uint		mBuffer;	// OpenAL buffer with the decoded data, 0 if the data is not resident
+	uint		mResident;	// Size of the decoded data in bytes
+	uint		mCounted;	// Size of the compressed data the cache is aware of
+	AudioData*	mAudioData;	// Compressed data, only kept between decoding if the cache asks for it
+	SoundCache*	mCache;
 
 public:
-	StaticSound(const String& name, AudioData* audioData);
+	StaticSound(const String& name, AudioData* audioData, SoundCache* cache);
 	virtual ~StaticSound();
 
+	bool IsResident() const			{ return mBuffer != 0; }
+	uint GetCompressedSize() const	{ return (mAudioData != 0) ? mAudioData->GetData().GetSize() : 0; }
+
 	virtual SoundInstance* Instantiate();
 	virtual void SetAudioData(AudioData* audioData);
+
+// INTERNAL
+private:
+	// Decodes the data and uploads it into a new buffer, loading the file first if necessary
+	bool _Load(bool keepCompressed);
+
+	// Releases the buffer along with the compressed data, unless it should be kept
+	void _Unload(bool keepCompressed);
 };
@@ -10,19 +10,46 @@
 class StreamedInstance: public SoundInstance
 {
 friend class StreamedSound;
+friend class AudioDecoder;
+
+public:
+	// Number of OpenAL buffers queued on the source, the number of decoded chunks kept ahead of playback,
+	// and the size of each decoded chunk in bytes
+	enum
+	{
+		BufferCount	= 4,
+		RingSize	= 4,
+		ChunkSize	= 16384,
+	};
 
 protected:
-	uint			mBuffers[2];
-	int				mBuffersProcessed;
+	uint			mBuffers[BufferCount];
+	uint			mFree[BufferCount];		// OpenAL buffers that are not currently queued
+	uint			mFreeCount;
 	bool			mRepeat;
-	uint			mChunk;
-	uint			mNextChunk;
+	AudioStream		mStream;				// This instance's decoding state
+
+	// Ring of decoded chunks: filled by the decoder thread, consumed by the main thread. Each side only
+	// ever advances its own counter, so the hand-off needs no locking.
+	Memory			mRing[RingSize];
+	Thread::ValType	mProduced;
+	Thread::ValType	mConsumed;
+	bool			mDecoded;				// Set by the decoder thread once the end of the stream was decoded
 
 protected:
 	StreamedInstance() {}
 	StreamedInstance(Sound* sound);
 	virtual ~StreamedInstance();
 
+	// Decoder thread: decodes the next chunk into the ring if there is room. Returns whether anything was decoded.
+	bool _Prefetch();
+
+	// Main thread: uploads the next decoded chunk into the specified buffer and queues it. Returns 'false' if none were ready.
+	bool _Upload(uint buffer);
+
+	// Uploads as many decoded chunks as there are free buffers
+	void _UploadAll();
+
 public:
 	virtual void SetRepeat(bool repeat);
 	virtual void Init();
@@ -31,4 +58,7 @@ public:
 	virtual void Play();
 	virtual void Pause();
 	virtual void Stop();
+
+	// Instances are recycled by the sound they belong to
+	virtual void DestroySelf();
 };
@@ -7,20 +7,35 @@
 // Author: Eugene Gorodinsky
 //============================================================================================================
 
+class StreamedInstance;
+
 class StreamedSound: public Sound
 {
+friend class StreamedInstance;
+
 protected:
 	StreamedSound() {}
 
 protected:
 	AudioData *mAudioData;
+	AudioDecoder *mDecoder;	// Background thread that decodes the instances' data
+
+	// Finished instances kept around for reuse, so starting a stream doesn't need to allocate anything
+	Array<StreamedInstance*>	mPool;
+	Thread::Lockable			mPoolLock;
 
 public:
-	StreamedSound(const String& name, AudioData* audioData);
+	StreamedSound(const String& name, AudioData* audioData, AudioDecoder* decoder);
 	virtual ~StreamedSound();
 
-	AudioData* GetAudioData();
+	const AudioData* GetAudioData() const { return mAudioData; }
+	AudioDecoder* GetDecoder() { return mDecoder; }
 
 	virtual SoundInstance* Instantiate();
 	virtual void SetAudioData(AudioData* audioData);
+
+// INTERNAL
+private:
+	// Stops the instance and returns it to the pool
+	void _Recycle(StreamedInstance* inst);
 };
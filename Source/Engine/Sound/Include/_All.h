@@ -13,9 +13,12 @@ namespace R5
 	#include "AudioLayer.h"
 	#include "AudioLibrary.h"
 	#include "AudioData.h"
+	#include "AudioStream.h"
+	#include "AudioDecoder.h"
 
 	#include "Sound.h"
 	#include "StaticSound.h"
+	#include "SoundCache.h"
 	#include "StreamedSound.h"
 
 	#include "SoundInstance.h"
@@ -23,4 +26,10 @@ namespace R5
 	#include "StreamedInstance.h"
 
 	#include "Audio.h"
+
+	#include "AudioSink.h"
+	#include "SoftSound.h"
+	#include "SoftLayer.h"
+	#include "SoftVoice.h"
+	#include "SoftAudio.h"
 };
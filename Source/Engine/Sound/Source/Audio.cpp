@@ -7,9 +7,12 @@ using namespace R5;
 
 AudioLibrary g_audioLibrary;
 
-Audio::Audio()
+Audio::Audio(bool nullDevice)
 {
-	ALCdevice* device = alcOpenDevice(NULL);
+	ALCdevice* device = nullDevice ? 0 : alcOpenDevice(NULL);
+
+	// Fall back to OpenAL Soft's null output device, allowing audio to run headless
+	if (device == 0) device = alcOpenDevice("No Output");
 	ASSERT(device != 0, "Couldn't open the default OpenAL device");
 	
 	ALCcontext* context = alcCreateContext(device, NULL);
@@ -17,11 +20,14 @@ Audio::Audio()
 
 	ALCboolean retval = alcMakeContextCurrent(context);
 	ASSERT(retval != 0, "Couldn't make the context current");
+
+	mDecoder.Start();
 }
 
 Audio::~Audio()
 {
 	Release();
+	mDecoder.Stop();
 	ALCcontext* context = alcGetCurrentContext();
 	ALCdevice* device = alcGetContextsDevice(context);
 	alcDestroyContext(context);
@@ -104,14 +110,15 @@ ISound* Audio::GetSound(const String& name, bool createIfMissing)
 			{
 				if (audioData->GetLength() > 150000)
 				{
-					StreamedSound *s = new StreamedSound(name, audioData);
+					StreamedSound *s = new StreamedSound(name, audioData, &mDecoder);
 					s->mSoundsEntry = mSounds.GetUnused();
 					mSounds.Expand() = s;
 					retVal = s;
 				}
 				else
 				{
-					StaticSound *s = new StaticSound(name, audioData);
+					StaticSound *s = new StaticSound(name, audioData, &mCache);
+					mCache.Acquire(s);
 					s->mSoundsEntry = mSounds.GetUnused();
 					mSounds.Expand() = s;
 					retVal = s;
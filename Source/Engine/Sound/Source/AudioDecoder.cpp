@@ -0,0 +1,131 @@
+#include "../Include/_All.h"
+
+using namespace R5;
+
+//============================================================================================================
+// Worker thread function
+//============================================================================================================
+
+R5_THREAD_FUNCTION(AudioDecoderThread, ptr)
+{
+	((AudioDecoder*)ptr)->_Run();
+	return 0;
+}
+
+//============================================================================================================
+
+AudioDecoder::AudioDecoder() : mCurrent(0), mActive(0), mStop(false) {}
+AudioDecoder::~AudioDecoder() { Stop(); }
+
+//============================================================================================================
+// Starts the worker thread
+//============================================================================================================
+
+void AudioDecoder::Start()
+{
+	if (mActive == 0)
+	{
+		mStop = false;
+		Thread::Increment(mActive);
+		Thread::Create(AudioDecoderThread, this);
+	}
+}
+
+//============================================================================================================
+// Stops the worker thread, waiting for it to exit
+//============================================================================================================
+
+void AudioDecoder::Stop()
+{
+	mStop = true;
+	while (mActive != 0) Thread::Sleep(1);
+}
+
+//============================================================================================================
+// Registers a stream that should be kept filled
+//============================================================================================================
+
+void AudioDecoder::Add (StreamedInstance* stream)
+{
+	Lock();
+	mStreams.AddUnique(stream);
+	Unlock();
+}
+
+//============================================================================================================
+// Removes a stream -- once this returns, the worker thread is guaranteed not to be touching it
+//============================================================================================================
+
+void AudioDecoder::Remove (StreamedInstance* stream)
+{
+	LockStream(stream);
+	mStreams.Remove(stream);
+	Unlock();
+}
+
+//============================================================================================================
+// Locks the decoder, first waiting for the worker thread to finish decoding the specified stream
+//============================================================================================================
+
+void AudioDecoder::LockStream (StreamedInstance* stream)
+{
+	Lock();
+
+	// The worker only picks the next stream while holding the lock, so once it's done with this one it stays done
+	while (mCurrent == stream)
+	{
+		Unlock();
+		Thread::Sleep(1);
+		Lock();
+	}
+}
+
+//============================================================================================================
+// Decodes the next chunk of every stream that has room for it. The list is copied first so that adding
+// and removing streams never has to wait for the decoding to finish.
+//============================================================================================================
+
+bool AudioDecoder::_Decode()
+{
+	bool decoded = false;
+
+	Lock();
+	mQueue.CopyMemory(mStreams);
+	Unlock();
+
+	FOREACH(i, mQueue)
+	{
+		StreamedInstance* stream = mQueue[i];
+
+		// The stream may have been removed after the list was copied
+		Lock();
+		mCurrent = mStreams.Contains(stream) ? stream : 0;
+		Unlock();
+
+		if (mCurrent != 0)
+		{
+			if (stream->_Prefetch()) decoded = true;
+
+			Lock();
+			mCurrent = 0;
+			Unlock();
+		}
+	}
+	return decoded;
+}
+
+//============================================================================================================
+// Worker thread's main loop -- sleeps whenever all rings are full
+//============================================================================================================
+
+void AudioDecoder::_Run()
+{
+	Profiler::SetThreadName("Audio");
+
+	while (!mStop)
+	{
+		if (!_Decode()) Thread::Sleep(5);
+	}
+	Profiler::Detach();
+	Thread::Decrement(mActive);
+}
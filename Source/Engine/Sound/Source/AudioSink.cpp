@@ -0,0 +1,163 @@
+#include "../Include/_All.h"
+
+#include "../Include/AL/al.h"
+#include "../Include/AL/alc.h"
+
+using namespace R5;
+
+//============================================================================================================
+// Writes a 32-bit and a 16-bit little-endian value
+//============================================================================================================
+
+inline void WriteUInt (FILE* fp, uint val)
+{
+	byte b[4] = { (byte)val, (byte)(val >> 8), (byte)(val >> 16), (byte)(val >> 24) };
+	fwrite(b, 1, 4, fp);
+}
+
+inline void WriteUShort (FILE* fp, uint val)
+{
+	byte b[2] = { (byte)val, (byte)(val >> 8) };
+	fwrite(b, 1, 2, fp);
+}
+
+//============================================================================================================
+
+WavSink::WavSink (const String& filename, uint rate) : mRate(rate), mFrames(0)
+{
+	mFile = fopen(filename.GetBuffer(), "wb");
+	if (mFile != 0) _WriteHeader();
+}
+
+//============================================================================================================
+// The header is only final once the total number of frames is known
+//============================================================================================================
+
+WavSink::~WavSink()
+{
+	if (mFile != 0)
+	{
+		fseek(mFile, 0, SEEK_SET);
+		_WriteHeader();
+		fclose(mFile);
+	}
+}
+
+//============================================================================================================
+// Appends the frames to the file
+//============================================================================================================
+
+void WavSink::Write (const short* samples, uint frames)
+{
+	if (mFile != 0)
+	{
+		fwrite(samples, sizeof(short) * 2, frames, mFile);
+		mFrames += frames;
+	}
+}
+
+//============================================================================================================
+// Writes the RIFF header for the current number of frames
+//============================================================================================================
+
+void WavSink::_WriteHeader()
+{
+	uint dataSize = mFrames * 4;
+
+	fwrite("RIFF", 1, 4, mFile);
+	WriteUInt	(mFile, 36 + dataSize);
+	fwrite("WAVEfmt ", 1, 8, mFile);
+	WriteUInt	(mFile, 16);			// Format chunk size
+	WriteUShort	(mFile, 1);				// PCM
+	WriteUShort	(mFile, 2);				// Channels
+	WriteUInt	(mFile, mRate);			// Sample rate
+	WriteUInt	(mFile, mRate * 4);		// Bytes per second
+	WriteUShort	(mFile, 4);				// Bytes per frame
+	WriteUShort	(mFile, 16);			// Bits per sample
+	fwrite("data", 1, 4, mFile);
+	WriteUInt	(mFile, dataSize);
+}
+
+//============================================================================================================
+
+StreamSink::StreamSink (uint rate, uint blockFrames) : mRate(rate), mBlock(blockFrames), mFreeCount(BufferCount)
+{
+	ALCdevice* device = alcOpenDevice(NULL);
+	if (device == 0) device = alcOpenDevice("No Output");
+	ASSERT(device != 0, "Couldn't open the default OpenAL device");
+
+	ALCcontext* context = alcCreateContext(device, NULL);
+	ASSERT(context != 0, "Couldn't create the default context");
+
+	ALCboolean retval = alcMakeContextCurrent(context);
+	ASSERT(retval != 0, "Couldn't make the context current");
+
+	alGenSources(1, &mSource);
+	alGenBuffers(BufferCount, mBuffers);
+	ASSERT(alGetError() == 0, "AL error occured");
+
+	// The mixer has already positioned everything
+	alSourcei(mSource, AL_SOURCE_RELATIVE, AL_TRUE);
+
+	for (uint i = 0; i < BufferCount; ++i) mFree[i] = mBuffers[i];
+}
+
+//============================================================================================================
+
+StreamSink::~StreamSink()
+{
+	alSourceStop(mSource);
+	alSourcei(mSource, AL_BUFFER, 0);
+	alDeleteSources(1, &mSource);
+	alDeleteBuffers(BufferCount, mBuffers);
+	ASSERT(alGetError() == 0, "AL error occured");
+
+	ALCcontext* context = alcGetCurrentContext();
+	ALCdevice* device = alcGetContextsDevice(context);
+	alcMakeContextCurrent(NULL);
+	alcDestroyContext(context);
+	alcCloseDevice(device);
+}
+
+//============================================================================================================
+// Reclaims the buffers OpenAL has finished playing -- each one needs a new block of frames
+//============================================================================================================
+
+uint StreamSink::GetDemand (uint elapsedFrames)
+{
+	int processed;
+	alGetSourcei(mSource, AL_BUFFERS_PROCESSED, &processed);
+
+	while (processed-- > 0)
+	{
+		uint buffer;
+		alSourceUnqueueBuffers(mSource, 1, &buffer);
+		mFree[mFreeCount++] = buffer;
+	}
+	ASSERT(alGetError() == 0, "AL error occured");
+	return mFreeCount * mBlock;
+}
+
+//============================================================================================================
+// Uploads the frames into the available buffers and queues them, restarting the source if it ran dry
+//============================================================================================================
+
+void StreamSink::Write (const short* samples, uint frames)
+{
+	while (frames > 0 && mFreeCount > 0)
+	{
+		uint count = Min(frames, mBlock);
+		uint buffer = mFree[--mFreeCount];
+
+		alBufferData(buffer, AL_FORMAT_STEREO16, samples, count * 4, mRate);
+		alSourceQueueBuffers(mSource, 1, &buffer);
+		ASSERT(alGetError() == 0, "AL error occured");
+
+		samples += count * 2;
+		frames	-= count;
+	}
+
+	int state;
+	alGetSourcei(mSource, AL_SOURCE_STATE, &state);
+	if (state != AL_PLAYING) alSourcePlay(mSource);
+}
@@ -0,0 +1,140 @@
+#include "../Include/_All.h"
+
+using namespace R5;
+
+//============================================================================================================
+// Ogg/Vorbis callbacks for decoding a stream in memory
+//============================================================================================================
+
+size_t MemRead(void* outBuffer, size_t size, size_t nmemb, void* dataSource)
+{
+	AudioStream::Cursor* cursor = ((AudioStream::Cursor*)dataSource);
+
+	uint dataSize = Min((uint)(size * nmemb), cursor->mData->GetSize() - cursor->mOffset);
+
+	if (dataSize)
+	{
+		const void* inBuffer = (const void*)(cursor->mData->GetBuffer() + cursor->mOffset);
+		cursor->mOffset += dataSize;
+
+		memcpy(outBuffer, inBuffer, dataSize);
+	}
+
+	return dataSize;
+}
+
+int MemSeek(void* dataSource, ogg_int64_t offset, int whence)
+{
+	AudioStream::Cursor* cursor = ((AudioStream::Cursor*)dataSource);
+
+	if (whence == SEEK_SET)
+	{
+		cursor->mOffset = Min((uint)offset, cursor->mData->GetSize());
+	}
+	else if (whence == SEEK_END)
+	{
+		cursor->mOffset = cursor->mData->GetSize() - Min((uint)offset, cursor->mData->GetSize());
+	}
+	else
+	{
+		cursor->mOffset = Min((uint)(offset + cursor->mOffset), cursor->mData->GetSize());
+	}
+
+	return 0;
+}
+
+// The cursor is owned by the stream, so there is nothing to release
+int MemClose(void *dataSource)
+{
+	return 0;
+}
+
+long int MemTell(void* dataSource)
+{
+	return ((AudioStream::Cursor*)dataSource)->mOffset;
+}
+
+//============================================================================================================
+// Starts decoding the specified data from the beginning
+//============================================================================================================
+
+bool AudioStream::Open(const AudioData* source)
+{
+	Close();
+
+	mCursor.mData	= &source->GetData();
+	mCursor.mOffset	= 0;
+	mEOF			= false;
+
+	ov_callbacks cb = { MemRead, MemSeek, MemClose, MemTell };
+
+	if (ov_open_callbacks((void*)&mCursor, &mOggFile, NULL, 0, cb) == 0)
+	{
+		mSource = source;
+		return true;
+	}
+	ASSERT(false, "ov_open_callbacks failed");
+	return false;
+}
+
+//============================================================================================================
+// Releases the decoder
+//============================================================================================================
+
+void AudioStream::Close()
+{
+	if (mSource != 0)
+	{
+		ov_clear(&mOggFile);
+		mSource = 0;
+	}
+}
+
+//============================================================================================================
+// Decodes the stream. If 'chunkSize' is a value other than 0, then a maximum of chunkSize of bytes are
+// decoded and placed in the buffer, otherwise everything from the current position to the end is decoded
+//============================================================================================================
+
+void AudioStream::Decode(Memory& outBuffer, uint chunkSize)
+{
+	outBuffer.Clear();
+
+	if (mSource != 0 && !mEOF)
+	{
+		if (chunkSize) 
+			outBuffer.Reserve(chunkSize);
+		else 
+			outBuffer.Reserve(mSource->GetLength() * mSource->GetChannels());
+
+		int bytesRead = 0;
+		uint size = 0;
+		do
+		{
+			int stream;
+			size = outBuffer.GetAllocated() - outBuffer.GetSize();
+			if (size)
+			{
+				bytesRead = ov_read(&mOggFile, (char*)outBuffer.GetBuffer() + outBuffer.GetSize(), size, 0, 2, 1, &stream);
+				outBuffer.Resize(outBuffer.GetSize() + bytesRead);
+			}
+			ASSERT(bytesRead >= 0, "ov_read returned an error code");
+		}
+		while (bytesRead > 0 && size > 0);
+
+		if (ov_pcm_tell(&mOggFile) == ov_pcm_total(&mOggFile, -1)) 
+			mEOF = true;
+	}
+}
+
+//============================================================================================================
+// Resets the data stream, so that decoding starts from the beginning of the stream.
+//============================================================================================================
+
+void AudioStream::Reset()
+{
+	if (mSource != 0)
+	{
+		mEOF = false;
+		ov_raw_seek(&mOggFile, 0);
+	}
+}
@@ -0,0 +1,611 @@
+#include "../Include/_All.h"
+
+#ifdef R5_SSE
+#include <emmintrin.h>
+#endif
+
+using namespace R5;
+
+//============================================================================================================
+// Voices quieter than this are not mixed
+//============================================================================================================
+
+#define AUDIBLE_THRESHOLD	0.0005f
+#define REFERENCE_DISTANCE	1.0f
+#define ROLLOFF_FACTOR		1.0f
+
+//============================================================================================================
+// Index of the sample following the specified one
+//============================================================================================================
+
+inline uint GetNext (uint index, uint frames, bool repeat)
+{
+	return (index + 1 < frames) ? index + 1 : (repeat ? 0 : index);
+}
+
+//============================================================================================================
+// Resamples 'count' frames of the source using linear interpolation, adding the result into the planar
+// left and right buffers. Samples are gathered one at a time, but interpolation and mixing is done 4 frames at once.
+//============================================================================================================
+
+template <uint Channels>
+void MixSegment (const short* src, uint frames, bool repeat, double pos, double step,
+	float leftGain, float rightGain, float* left, float* right, uint count)
+{
+	const float scale = 1.0f / 32768.0f;
+	leftGain  *= scale;
+	rightGain *= scale;
+
+	uint i = 0;
+
+#ifdef R5_SSE
+	__m128 gl = _mm_set1_ps(leftGain);
+	__m128 gr = _mm_set1_ps(rightGain);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		float fr[4], a0[4], b0[4], a1[4], b1[4];
+
+		for (uint k = 0; k < 4; ++k)
+		{
+			double p	= pos + (i + k) * step;
+			uint index	= (uint)p;
+			if (index >= frames) index = frames - 1;
+			uint next	= GetNext(index, frames, repeat);
+
+			fr[k] = (float)(p - index);
+			a0[k] = src[index * Channels];
+			b0[k] = src[next  * Channels];
+
+			if (Channels == 2)
+			{
+				a1[k] = src[index * 2 + 1];
+				b1[k] = src[next  * 2 + 1];
+			}
+		}
+
+		__m128 f  = _mm_loadu_ps(fr);
+		__m128 s0 = _mm_loadu_ps(a0);
+		s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b0), s0), f));
+		__m128 s1 = s0;
+
+		if (Channels == 2)
+		{
+			s1 = _mm_loadu_ps(a1);
+			s1 = _mm_add_ps(s1, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b1), s1), f));
+		}
+
+		_mm_storeu_ps(left  + i, _mm_add_ps(_mm_loadu_ps(left  + i), _mm_mul_ps(s0, gl)));
+		_mm_storeu_ps(right + i, _mm_add_ps(_mm_loadu_ps(right + i), _mm_mul_ps(s1, gr)));
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		double p	= pos + i * step;
+		uint index	= (uint)p;
+		if (index >= frames) index = frames - 1;
+		uint next	= GetNext(index, frames, repeat);
+		float f		= (float)(p - index);
+
+		float a = src[index * Channels];
+		float s0 = a + (src[next * Channels] - a) * f;
+		float s1 = s0;
+
+		if (Channels == 2)
+		{
+			a = src[index * 2 + 1];
+			s1 = a + (src[next * 2 + 1] - a) * f;
+		}
+
+		left [i] += s0 * leftGain;
+		right[i] += s1 * rightGain;
+	}
+}
+
+//============================================================================================================
+// Adds 'src' scaled by 'gain' to 'dst'
+//============================================================================================================
+
+void MixBus (const float* src, float gain, float* dst, uint count)
+{
+	uint i = 0;
+
+#ifdef R5_SSE
+	__m128 g = _mm_set1_ps(gain);
+
+	for (; i + 4 <= count; i += 4)
+		_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+#endif
+
+	for (; i < count; ++i) dst[i] += src[i] * gain;
+}
+
+//============================================================================================================
+// Converts planar float data into interleaved 16-bit samples, clamping the values
+//============================================================================================================
+
+void Interleave (const float* left, const float* right, short* out, uint count)
+{
+	uint i = 0;
+
+#ifdef R5_SSE
+	__m128 scale = _mm_set1_ps(32767.0f);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		// Conversion to 16 bits saturates, taking care of the clamping
+		__m128i l = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(left  + i), scale));
+		__m128i r = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(right + i), scale));
+		l = _mm_packs_epi32(l, l);
+		r = _mm_packs_epi32(r, r);
+		_mm_storeu_si128((__m128i*)(out + i * 2), _mm_unpacklo_epi16(l, r));
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		out[i * 2    ] = (short)Float::RoundToInt(Clamp(left [i], -1.0f, 1.0f) * 32767.0f);
+		out[i * 2 + 1] = (short)Float::RoundToInt(Clamp(right[i], -1.0f, 1.0f) * 32767.0f);
+	}
+}
+
+//============================================================================================================
+// Mixes the voice into the buffers (or just advances it if the buffers are null).
+// Returns 'false' if the voice has reached its end.
+//============================================================================================================
+
+bool MixVoice (const SoftSound* sound, uint rate, float* left, float* right, uint count,
+	float leftGain, float rightGain, double& cursor, bool repeat)
+{
+	uint frames = sound->GetFrames();
+	if (frames == 0) return false;
+
+	double step = (double)sound->GetRate() / rate;
+	double pos	= cursor;
+
+	if (left == 0)
+	{
+		pos += step * count;
+	}
+	else
+	{
+		const short* src = sound->GetSamples();
+
+		while (count > 0)
+		{
+			if (pos >= frames)
+			{
+				if (!repeat) break;
+				pos = fmod(pos, (double)frames);
+			}
+
+			// Mix up to the end of the sound, then wrap around
+			uint n = (uint)ceil((frames - pos) / step);
+			if (n == 0) n = 1;
+			if (n > count) n = count;
+
+			if (sound->GetChannels() == 2)	MixSegment<2>(src, frames, repeat, pos, step, leftGain, rightGain, left, right, n);
+			else							MixSegment<1>(src, frames, repeat, pos, step, leftGain, rightGain, left, right, n);
+
+			pos		+= n * step;
+			left	+= n;
+			right	+= n;
+			count	-= n;
+		}
+	}
+
+	if (pos >= frames)
+	{
+		if (!repeat) return false;
+		pos = fmod(pos, (double)frames);
+	}
+
+	cursor = pos;
+	return true;
+}
+
+//============================================================================================================
+// Moves the 'count' loudest voices to the front of the array
+//============================================================================================================
+
+template <typename Type>
+void SelectLoudest (Type* list, int size, int count)
+{
+	int first = 0, last = size - 1;
+
+	while (first < last)
+	{
+		float pivot = list[(first + last) >> 1].mLevel;
+		int i = first, j = last;
+
+		while (i <= j)
+		{
+			while (list[i].mLevel > pivot) ++i;
+			while (list[j].mLevel < pivot) --j;
+			if (i <= j) Swap(list[i++], list[j--]);
+		}
+
+		// Everything before 'i' is at least as loud as everything past 'j'
+		if		(count <= j)	last  = j;
+		else if (count >= i)	first = i;
+		else break;
+	}
+}
+
+//============================================================================================================
+
+SoftAudio::SoftAudio (AudioSink* sink, uint rate) :
+	mSink			(sink != 0 ? sink : new NullSink()),
+	mRate			(rate),
+	mMaxVoices		(64),
+	mLastUpdate		(0),
+	mRemainder		(0),
+	mListenerRight	(1.0f, 0.0f, 0.0f) {}
+
+//============================================================================================================
+
+SoftAudio::~SoftAudio()
+{
+	Release();
+	delete mSink;
+}
+
+//============================================================================================================
+// Release all audio resources
+//============================================================================================================
+
+void SoftAudio::Release()
+{
+	mLock.Lock();
+	{
+		FOREACH(i, mVoices) delete mVoices[i];
+		mVoices.Release();
+		mAudible.Release();
+		mSounds.Release();
+		mLayers.Release();
+	}
+	mLock.Unlock();
+}
+
+//============================================================================================================
+// Mixes as many frames as the sink needs to cover the time passed since the last update
+//============================================================================================================
+
+void SoftAudio::Update()
+{
+	ulong now = Time::GetMilliseconds();
+	ulong delta = (mLastUpdate == 0) ? 0 : now - mLastUpdate;
+	mLastUpdate = now;
+
+	// Don't try to catch up on long stalls
+	if (delta > 250) delta = 250;
+
+	uint elapsed = (uint)(delta * mRate) + mRemainder;
+	mRemainder = elapsed % 1000;
+	elapsed /= 1000;
+
+	uint frames = mSink->GetDemand(elapsed);
+	if (frames > 0) Mix(frames);
+}
+
+//============================================================================================================
+// Mixes the specified number of frames and sends them to the sink
+//============================================================================================================
+
+void SoftAudio::Mix (uint frames)
+{
+	mLock.Lock();
+	{
+		short* out = (short*)mOutput.Resize(frames * 2 * sizeof(short));
+
+		for (uint offset = 0; offset < frames; offset += BlockFrames)
+		{
+			_MixBlock(out + offset * 2, Min(frames - offset, (uint)BlockFrames));
+		}
+	}
+	mLock.Unlock();
+
+	mSink->Write((const short*)mOutput.GetBuffer(), frames);
+}
+
+//============================================================================================================
+// Release all resources associated with the specified sound
+//============================================================================================================
+
+bool SoftAudio::Release (ISound* sound)
+{
+	bool retVal = false;
+
+	mLock.Lock();
+	{
+		SoftSound* s = (SoftSound*)sound;
+
+		if (s != 0 && s->mRefCount == 0)
+		{
+			mSounds.Remove(s);
+			delete s;
+			retVal = true;
+		}
+	}
+	mLock.Unlock();
+	return retVal;
+}
+
+//============================================================================================================
+// Sets the listener position and orientation -- only the right vector is needed for panning
+//============================================================================================================
+
+void SoftAudio::SetListener (const Vector3f& position, const Vector3f& dir, const Vector3f& up, const Vector3f& velocity)
+{
+	mListenerPos	= position;
+	mListenerRight	= Normalize(Cross(dir, up));
+}
+
+//============================================================================================================
+// Gets the specified layer, creating it if necessary
+//============================================================================================================
+
+IAudioLayer* SoftAudio::GetLayer (uint layer)
+{
+	mLock.Lock();
+	SoftLayer* ptr = _GetLayer(layer);
+	mLock.Unlock();
+	return ptr;
+}
+
+//============================================================================================================
+// Either returns a sound that's already in the library or loads and decodes it
+//============================================================================================================
+
+ISound* SoftAudio::GetSound (const String& name, bool createIfMissing)
+{
+	SoftSound* sound = 0;
+
+	mLock.Lock();
+	{
+		FOREACH(i, mSounds)
+		{
+			if (mSounds[i]->GetName() == name)
+			{
+				sound = mSounds[i];
+				break;
+			}
+		}
+
+		if (sound == 0 && createIfMissing)
+		{
+			sound = new SoftSound(name);
+
+			if (sound->Load())
+			{
+				mSounds.Expand() = sound;
+			}
+			else
+			{
+				delete sound;
+				sound = 0;
+			}
+		}
+	}
+	mLock.Unlock();
+	return sound;
+}
+
+//============================================================================================================
+// Adds a sound using already decoded 16-bit PCM data, replacing the existing sound's data if there is one
+//============================================================================================================
+
+ISound* SoftAudio::CreateSound (const String& name, const short* samples, uint frames, uint channels, uint rate)
+{
+	SoftSound* sound = (SoftSound*)GetSound(name, false);
+
+	mLock.Lock();
+	{
+		if (sound == 0)
+		{
+			sound = new SoftSound(name);
+			mSounds.Expand() = sound;
+		}
+		sound->Set(samples, frames, channels, rate);
+	}
+	mLock.Unlock();
+	return sound;
+}
+
+//============================================================================================================
+// Creates a 2D sound instance
+//============================================================================================================
+
+ISoundInstance* SoftAudio::Instantiate (ISound* sound, uint layer, float fadeInTime, bool repeat)
+{
+	ASSERT(sound != NULL, "A NULL pointer has been passed to SoftAudio::Instantiate() when creating a 2D sound instance");
+	return _Instantiate(sound, layer, false, fadeInTime, repeat);
+}
+
+//============================================================================================================
+// Creates a 3D sound instance at a specified position
+//============================================================================================================
+
+ISoundInstance* SoftAudio::Instantiate (ISound* sound, const Vector3f& position, uint layer, float fadeInTime, bool repeat)
+{
+	ASSERT(sound != NULL, "A NULL pointer has been passed to SoftAudio::Instantiate() when creating a 3D sound instance");
+	SoftVoice* voice = _Instantiate(sound, layer, true, fadeInTime, repeat);
+	voice->SetPosition(position);
+	return voice;
+}
+
+//============================================================================================================
+// Removes the voice and deletes it
+//============================================================================================================
+
+void SoftAudio::_Destroy (SoftVoice* voice)
+{
+	mLock.Lock();
+	{
+		mVoices.Remove(voice);
+		--voice->mSound->mRefCount;
+		delete voice;
+	}
+	mLock.Unlock();
+}
+
+//============================================================================================================
+// Gets the specified layer, creating it if necessary
+//============================================================================================================
+
+SoftLayer* SoftAudio::_GetLayer (uint layer)
+{
+	if (layer >= mLayers.GetSize()) mLayers.ExpandTo(layer + 1);
+	SoftLayer*& ptr = mLayers[layer];
+	if (ptr == 0) ptr = new SoftLayer();
+	return ptr;
+}
+
+//============================================================================================================
+// Creates a new voice
+//============================================================================================================
+
+SoftVoice* SoftAudio::_Instantiate (ISound* sound, uint layer, bool spatial, float fadeInTime, bool repeat)
+{
+	SoftVoice* voice;
+
+	mLock.Lock();
+	{
+		SoftSound* s = (SoftSound*)sound;
+		voice = new SoftVoice(this, s, _GetLayer(layer), spatial, repeat, fadeInTime);
+		++s->mRefCount;
+		mVoices.Expand() = voice;
+	}
+	mLock.Unlock();
+	return voice;
+}
+
+//============================================================================================================
+// Mixes a single block of frames, writing the result into the 16-bit interleaved output
+//============================================================================================================
+
+void SoftAudio::_MixBlock (short* out, uint frames)
+{
+	double start = Time::GetSystemSeconds();
+	float delta = (float)frames / mRate;
+	uint busSize = frames * 2 * sizeof(float);
+
+	// Figure out the gain of every playing voice
+	mAudible.Clear();
+	mStats.mVoices = 0;
+
+	FOREACH(i, mVoices)
+	{
+		SoftVoice* voice = mVoices[i];
+		if (voice->mState != SoftVoice::State::Playing) continue;
+		++mStats.mVoices;
+
+		float gain = voice->mVolume * voice->mFade;
+
+		if (voice->mFade < 1.0f)
+		{
+			voice->mFade = Min(1.0f, voice->mFade + voice->mFadeSpeed * delta);
+		}
+
+		if (voice->mSpatial)
+		{
+			Vector3f offset (voice->mPosition - mListenerPos);
+			float distance = offset.Magnitude();
+
+			// Inverse distance attenuation with equal power panning
+			gain *= REFERENCE_DISTANCE / (REFERENCE_DISTANCE + ROLLOFF_FACTOR *
+				(Max(distance, REFERENCE_DISTANCE) - REFERENCE_DISTANCE));
+
+			float pan = (distance > 0.0001f) ? Dot(offset, mListenerRight) / distance : 0.0f;
+			float angle = (pan + 1.0f) * (PI * 0.25f);
+
+			voice->mGain[0] = gain * COS(angle);
+			voice->mGain[1] = gain * SIN(angle);
+		}
+		else
+		{
+			voice->mGain[0] = gain;
+			voice->mGain[1] = gain;
+		}
+
+		// Layer volume is applied to the bus rather than to each voice
+		float level = Max(voice->mGain[0], voice->mGain[1]) * voice->mLayer->mVolume;
+
+		if (level > AUDIBLE_THRESHOLD)
+		{
+			Audible& a = mAudible.Expand();
+			a.mVoice = voice;
+			a.mLevel = level;
+		}
+		else
+		{
+			voice->mVirtual = true;
+
+			if (!MixVoice(voice->mSound, mRate, 0, 0, frames, 0.0f, 0.0f, voice->mCursor, voice->mRepeat))
+				voice->Stop();
+		}
+	}
+
+	// Only the loudest voices get mixed
+	uint mixed = mAudible.GetSize();
+
+	if (mixed > mMaxVoices)
+	{
+		SelectLoudest(&mAudible[0], mixed, mMaxVoices);
+		mixed = mMaxVoices;
+	}
+
+	FOREACH(i, mLayers)
+	{
+		if (mLayers[i] != 0) mLayers[i]->mActive = false;
+	}
+
+	FOREACH(i, mAudible)
+	{
+		SoftVoice* voice = mAudible[i].mVoice;
+		float* left = 0;
+		float* right = 0;
+
+		if (i < mixed)
+		{
+			SoftLayer* layer = voice->mLayer;
+
+			if (!layer->mActive)
+			{
+				layer->mActive = true;
+				memset(layer->mBus.Resize(busSize), 0, busSize);
+			}
+
+			left  = (float*)layer->mBus.GetBuffer();
+			right = left + frames;
+		}
+
+		voice->mVirtual = (left == 0);
+
+		if (!MixVoice(voice->mSound, mRate, left, right, frames,
+			voice->mGain[0], voice->mGain[1], voice->mCursor, voice->mRepeat))
+			voice->Stop();
+	}
+
+	// Mix the layers together
+	float* master = (float*)mMaster.Resize(busSize);
+	memset(master, 0, busSize);
+
+	FOREACH(i, mLayers)
+	{
+		SoftLayer* layer = mLayers[i];
+
+		if (layer != 0 && layer->mActive)
+		{
+			MixBus((const float*)layer->mBus.GetBuffer(), layer->mVolume, master, frames * 2);
+		}
+	}
+
+	Interleave(master, master + frames, out, frames);
+
+	mStats.mMixed		 = mixed;
+	mStats.mVirtual		 = mStats.mVoices - mixed;
+	mStats.mVoiceFrames	+= (double)mixed * frames;
+	mStats.mMixTime		+= (Time::GetSystemSeconds() - start) * 1000.0;
+}
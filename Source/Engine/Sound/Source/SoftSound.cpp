@@ -0,0 +1,37 @@
+#include "../Include/_All.h"
+
+using namespace R5;
+
+//============================================================================================================
+// Loads and decodes the sound
+//============================================================================================================
+
+bool SoftSound::Load()
+{
+	AudioData data;
+
+	if (data.Load(mName))
+	{
+		data.Decode(mData);
+
+		mChannels	= data.GetChannels();
+		mRate		= data.GetRate();
+		mFrames		= mData.GetSize() / (mChannels * sizeof(short));
+		return (mFrames != 0 && mChannels <= 2);
+	}
+	return false;
+}
+
+//============================================================================================================
+// Uses the specified 16-bit PCM data instead of loading it
+//============================================================================================================
+
+void SoftSound::Set (const short* samples, uint frames, uint channels, uint rate)
+{
+	mChannels	= channels;
+	mRate		= rate;
+	mFrames		= frames;
+
+	uint size = frames * channels * sizeof(short);
+	memcpy(mData.Resize(size), samples, size);
+}
@@ -0,0 +1,31 @@
+#include "../Include/_All.h"
+
+using namespace R5;
+
+//============================================================================================================
+
+SoftVoice::SoftVoice (SoftAudio* audio, SoftSound* sound, SoftLayer* layer, bool spatial, bool repeat, float fadeInTime) :
+	mAudio		(audio),
+	mSound		(sound),
+	mLayer		(layer),
+	mState		(State::Stopped),
+	mRepeat		(repeat),
+	mSpatial	(spatial),
+	mVirtual	(false),
+	mVolume		(1.0f),
+	mFade		(fadeInTime > 0.0f ? 0.0f : 1.0f),
+	mFadeSpeed	(fadeInTime > 0.0f ? 1.0f / fadeInTime : 0.0f),
+	mCursor		(0.0)
+{
+	mGain[0] = 0.0f;
+	mGain[1] = 0.0f;
+}
+
+//============================================================================================================
+// Voices are owned by the audio controller
+//============================================================================================================
+
+void SoftVoice::DestroySelf()
+{
+	mAudio->_Destroy(this);
+}
@@ -0,0 +1,93 @@
+#include "../Include/_All.h"
+
+using namespace R5;
+
+//============================================================================================================
+// Makes sure the sound's PCM data is resident, marking the sound as the most recently used one
+//============================================================================================================
+
+bool SoundCache::Acquire (StaticSound* sound)
+{
+	if (sound->IsResident())
+	{
+		++mStats.mHits;
+
+		// Move the sound to the back of the list
+		if (mSounds.IsValid() && mSounds.Back() != sound)
+		{
+			mSounds.Remove(sound);
+			mSounds.Expand() = sound;
+		}
+		return true;
+	}
+
+	++mStats.mMisses;
+
+	bool retVal = sound->_Load(mCompressed);
+	_Account(sound);
+
+	if (retVal)
+	{
+		mStats.mResident += sound->mResident;
+		mSounds.Expand() = sound;
+		mStats.mSounds = mSounds.GetSize();
+		Trim();
+	}
+	return retVal;
+}
+
+//============================================================================================================
+// Removes the sound from the cache
+//============================================================================================================
+
+void SoundCache::Remove (StaticSound* sound)
+{
+	if (mSounds.Remove(sound))
+	{
+		mStats.mResident -= sound->mResident;
+		mStats.mSounds = mSounds.GetSize();
+	}
+
+	mStats.mCompressed -= sound->mCounted;
+	sound->mCounted = 0;
+}
+
+//============================================================================================================
+// Evicts the least recently used sounds without any instances until the resident data fits the budget
+//============================================================================================================
+
+void SoundCache::Trim()
+{
+	for (uint i = 0; i < mSounds.GetSize(); )
+	{
+		StaticSound* sound = mSounds[i];
+
+		// The sound that was just acquired (and any sound still in use) can't be evicted
+		if (mBudget != 0 && mStats.mResident > mBudget && sound->mRefCount == 0 && i + 1 < mSounds.GetSize())
+		{
+			mStats.mResident -= sound->mResident;
+			++mStats.mEvictions;
+
+			sound->_Unload(mCompressed);
+			_Account(sound);
+			mSounds.RemoveAt(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	mStats.mSounds = mSounds.GetSize();
+}
+
+//============================================================================================================
+// Updates the amount of compressed data kept in memory after the sound was loaded or unloaded
+//============================================================================================================
+
+void SoundCache::_Account (StaticSound* sound)
+{
+	uint size = sound->GetCompressedSize();
+	mStats.mCompressed = mStats.mCompressed - sound->mCounted + size;
+	sound->mCounted = size;
+}
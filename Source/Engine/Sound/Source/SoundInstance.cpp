@@ -5,7 +5,7 @@
 using namespace R5;
 
 SoundInstance::SoundInstance(Sound* sound)
-	:mActiveInstancesEntry(NULL), mState(0), mVolume(1.0f), mSound(sound)
+	:mActiveInstancesEntry(NULL), mInstancesEntry(NULL), mLayer(NULL), mState(0), mVolume(1.0f), mSound(sound)
 {
 	alGenSources(1, &mSource);
 	ASSERT(alGetError() == 0, "AL error occured");
@@ -15,12 +15,7 @@ SoundInstance::SoundInstance(Sound* sound)
 
 SoundInstance::~SoundInstance()
 {
-	mLayer->mInstances.Recycle(mInstancesEntry);
-
-	if (mActiveInstancesEntry)
-	{
-		mActiveInstances->Recycle(mActiveInstancesEntry);
-	}
+	_Detach();
 
 	alDeleteSources(1, &mSource);
 	ASSERT(alGetError() == 0, "AL error occured");
@@ -28,6 +23,21 @@ SoundInstance::~SoundInstance()
 	mSound->mRefCount--;
 }
 
+void SoundInstance::_Detach()
+{
+	if (mInstancesEntry)
+	{
+		mLayer->mInstances.Recycle(mInstancesEntry);
+		mInstancesEntry = NULL;
+	}
+
+	if (mActiveInstancesEntry)
+	{
+		mActiveInstances->Recycle(mActiveInstancesEntry);
+		mActiveInstancesEntry = NULL;
+	}
+}
+
 void SoundInstance::SetVolume(float volume)
 {
 	mVolume = Min(volume, 1.0f);
@@ -49,6 +59,6 @@ void SoundInstance::SetVelocity(const Vector3f& velocity)
 
 void SoundInstance::SetSpatial(bool isSpatial)
 {
-	alSourcei(mSource, AL_SOURCE_RELATIVE, true);
+	alSourcei(mSource, AL_SOURCE_RELATIVE, !isSpatial);
 	ASSERT(alGetError() == 0, "AL error occured");
 }
@@ -4,24 +4,24 @@
 
 using namespace R5;
 
-StaticSound::StaticSound(const String& name, AudioData *audioData)
+StaticSound::StaticSound(const String& name, AudioData *audioData, SoundCache* cache)
+	: mBuffer(0), mResident(0), mCounted(0), mAudioData(audioData), mCache(cache)
 {
-	alGenBuffers(1, &mBuffer);
-	ASSERT(alGetError() == 0, "AL error occured");
-
 	mName = name;
-	SetAudioData(audioData);
-	delete audioData;
 }
 
 StaticSound::~StaticSound()
 {
-	alDeleteBuffers(1, &mBuffer);
-	ASSERT(alGetError() == 0, "Coudn't delete sound");
+	mCache->Remove(this);
+	_Unload(false);
 }
 
 SoundInstance* StaticSound::Instantiate()
 {
+	// Decode the sound again if it has been evicted
+	bool resident = mCache->Acquire(this);
+	ASSERT(resident, "Unable to load the sound");
+
 	StaticInstance* inst = new StaticInstance(this);
 
 	alSourcei(inst->mSource, AL_BUFFER, mBuffer);
@@ -30,14 +30,77 @@ SoundInstance* StaticSound::Instantiate()
 	return inst;
 }
 
+//============================================================================================================
+// Replaces the sound's data
+//============================================================================================================
+
 void StaticSound::SetAudioData(AudioData* audioData)
 {
+	mCache->Remove(this);
+	_Unload(false);
+
+	mAudioData = audioData;
+	mCache->Acquire(this);
+}
+
+//============================================================================================================
+// Decodes the data and uploads it into a new buffer, loading the file first if necessary
+//============================================================================================================
+
+bool StaticSound::_Load(bool keepCompressed)
+{
+	if (mBuffer != 0) return true;
+
+	if (mAudioData == 0)
+	{
+		mAudioData = new AudioData;
+
+		if (!mAudioData->Load(mName))
+		{
+			delete mAudioData;
+			mAudioData = 0;
+			return false;
+		}
+	}
+
 	Memory dataOut;
-	audioData->SetChunkSize(0);
-	audioData->Decode(dataOut);
+	mAudioData->Decode(dataOut);
+
+	alGenBuffers(1, &mBuffer);
+	ASSERT(alGetError() == 0, "AL error occured");
 
-	ALenum format = (audioData->GetChannels() == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;	
+	ALenum format = (mAudioData->GetChannels() == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;	
 
-	alBufferData(mBuffer, format, dataOut.GetBuffer(), dataOut.GetSize(), audioData->GetRate());
+	alBufferData(mBuffer, format, dataOut.GetBuffer(), dataOut.GetSize(), mAudioData->GetRate());
 	ASSERT(alGetError() == 0, "AL error occured");
+
+	mResident = dataOut.GetSize();
+
+	if (!keepCompressed)
+	{
+		delete mAudioData;
+		mAudioData = 0;
+	}
+	return true;
+}
+
+//============================================================================================================
+// Releases the buffer along with the compressed data, unless it should be kept
+//============================================================================================================
+
+void StaticSound::_Unload(bool keepCompressed)
+{
+	if (mBuffer != 0)
+	{
+		alDeleteBuffers(1, &mBuffer);
+		ASSERT(alGetError() == 0, "Coudn't delete sound");
+		mBuffer = 0;
+		mResident = 0;
+	}
+
+	if (!keepCompressed && mAudioData != 0)
+	{
+		delete mAudioData;
+		mAudioData = 0;
+	}
 }
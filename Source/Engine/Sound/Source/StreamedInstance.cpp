@@ -5,113 +5,176 @@
 using namespace R5;
 
 StreamedInstance::StreamedInstance(Sound* sound): 
-	mBuffersProcessed(0), mChunk(0), SoundInstance(sound)
+	mFreeCount(0), mRepeat(false), mProduced(0), mConsumed(0), mDecoded(false), SoundInstance(sound)
 {
-	alGenBuffers(2, mBuffers);
+	alGenBuffers(BufferCount, mBuffers);
 	ASSERT(alGetError() == 0, "AL error occured");
+
+	// Each instance decodes the sound's shared data independently
+	mStream.Open(((StreamedSound*)sound)->GetAudioData());
 }
 
 StreamedInstance::~StreamedInstance()
 {
+	// Make sure the decoder thread is no longer using this instance
+	((StreamedSound*)mSound)->GetDecoder()->Remove(this);
+
 	alSourceStop(mSource);
 
 	alSourcei(mSource, AL_BUFFER, 0);
 	ASSERT(alGetError() == 0, "AL error occured");
 
-	alDeleteBuffers(2, mBuffers);
+	alDeleteBuffers(BufferCount, mBuffers);
 	ASSERT(alGetError() == 0, "AL error occured");
 }
 
 //============================================================================================================
-// Initializes the sound, preloading the two buffers with the first two chunks of the stream
+// Rewinds the stream. The decoder thread will then refill the ring, starting at the beginning of the stream.
 //============================================================================================================
 
 void StreamedInstance::Init()
 {
-	Memory dataOut;
-	ALenum format = (((StreamedSound*)mSound)->GetAudioData()->GetChannels() == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;	
-
+	alSourceStop(mSource);
 	alSourcei(mSource, AL_BUFFER, 0);
 	ASSERT(alGetError() == 0, "AL error occured");
 
-	((StreamedSound*)mSound)->GetAudioData()->Reset();
-	((StreamedSound*)mSound)->GetAudioData()->Decode(dataOut);
+	// All buffers are now available
+	for (mFreeCount = 0; mFreeCount < BufferCount; ++mFreeCount)
+		mFree[mFreeCount] = mBuffers[mFreeCount];
 
-	alBufferData(mBuffers[0], format, dataOut.GetBuffer(), dataOut.GetSize(), ((StreamedSound*)mSound)->GetAudioData()->GetRate());
-	ASSERT(alGetError() == 0, "AL error occured");
+	AudioDecoder* decoder = ((StreamedSound*)mSound)->GetDecoder();
+
+	decoder->LockStream(this);
+	{
+		mStream.Reset();
+		mProduced	= 0;
+		mConsumed	= 0;
+		mDecoded	= false;
+	}
+	decoder->Unlock();
+}
+
+//============================================================================================================
+// Decoder thread: decodes the next chunk into the ring if there is room
+//============================================================================================================
+
+bool StreamedInstance::_Prefetch()
+{
+	if (mDecoded || (mProduced - mConsumed) >= RingSize) return false;
+
+	if (mStream.IsEOF())
+	{
+		if (!mRepeat)
+		{
+			mDecoded = true;
+			return false;
+		}
+		mStream.Reset();
+	}
 
-	((StreamedSound*)mSound)->GetAudioData()->Decode(dataOut);
+	Memory& chunk = mRing[mProduced % RingSize];
+	mStream.Decode(chunk, ChunkSize);
 
-	alBufferData(mBuffers[1], format, dataOut.GetBuffer(), dataOut.GetSize(), ((StreamedSound*)mSound)->GetAudioData()->GetRate());
+	// The stream is empty or failed to decode -- there is nothing more to prefetch, even if repeating
+	if (chunk.GetSize() == 0)
+	{
+		mDecoded = true;
+		return false;
+	}
+
+	// Only publish the chunk once it has been completely written
+	Thread::Increment(mProduced);
+	return true;
+}
+
+//============================================================================================================
+// Main thread: uploads the next decoded chunk into the specified buffer and queues it
+//============================================================================================================
+
+bool StreamedInstance::_Upload(uint buffer)
+{
+	if (mConsumed == mProduced) return false;
+
+	const AudioData* data = ((StreamedSound*)mSound)->GetAudioData();
+	ALenum format = (data->GetChannels() == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+	const Memory& chunk = mRing[mConsumed % RingSize];
+
+	alBufferData(buffer, format, chunk.GetBuffer(), chunk.GetSize(), data->GetRate());
 	ASSERT(alGetError() == 0, "AL error occured");
 
-	alSourceQueueBuffers(mSource, 2, mBuffers);
+	alSourceQueueBuffers(mSource, 1, &buffer);
 	ASSERT(alGetError() == 0, "AL error occured");
+
+	// The slot can now be reused by the decoder thread
+	Thread::Increment(mConsumed);
+	return true;
 }
 
 //============================================================================================================
-// Updates the sound, loading new portions as it's being played. 
+// Uploads as many decoded chunks as there are free buffers
+//============================================================================================================
+
+void StreamedInstance::_UploadAll()
+{
+	while (mFreeCount > 0 && _Upload(mFree[mFreeCount - 1])) --mFreeCount;
+}
+
+//============================================================================================================
+// Updates the sound, handing off the chunks decoded by the decoder thread as buffers finish playing.
 // Returns false when the sound has finished playing
 //============================================================================================================
 
 bool StreamedInstance::Update()
 {
-	if (mState != State::Playing) return false;
+	if (mState != State::Playing)
+	{
+		// Audio::Update will remove the instance from the active list
+		mActiveInstancesEntry = NULL;
+		return false;
+	}
 
-	int queued;
-	alGetSourcei(mSource, AL_BUFFERS_QUEUED, &queued);
+	int processed;
+	alGetSourcei(mSource, AL_BUFFERS_PROCESSED, &processed);
 	ASSERT(alGetError() == 0, "AL error occured");
 
-	if (queued)
+	// Reclaim the buffers that have finished playing
+	while (processed-- > 0)
 	{
-		int processed;
-		alGetSourcei(mSource, AL_BUFFERS_PROCESSED, &processed);
+		uint processedBuffer;
+		alSourceUnqueueBuffers(mSource, 1, &processedBuffer);
 		ASSERT(alGetError() == 0, "AL error occured");
+		mFree[mFreeCount++] = processedBuffer;
+	}
 
-		while (processed--)
-		{
-			uint processedBuffer;
-			alSourceUnqueueBuffers(mSource, 1, &processedBuffer);
-			ASSERT(alGetError() == 0, "AL error occured");
-
-			if (((StreamedSound*)mSound)->GetAudioData()->IsEOF() && mRepeat)
-			{
-				((StreamedSound*)mSound)->GetAudioData()->Reset();
-			}
-
-			if (!((StreamedSound*)mSound)->GetAudioData()->IsEOF())
-			{
-				Memory dataOut;
-				ALenum format = (((StreamedSound*)mSound)->GetAudioData()->GetChannels() == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;	
-
-				((StreamedSound*)mSound)->GetAudioData()->Decode(dataOut);
-
-				alBufferData(processedBuffer, format, dataOut.GetBuffer(), dataOut.GetSize(), ((StreamedSound*)mSound)->GetAudioData()->GetRate());
-				ASSERT(alGetError() == 0, "AL error occured");
+	_UploadAll();
 
-				alSourceQueueBuffers(mSource, 1, &processedBuffer);
-				ASSERT(alGetError() == 0, "AL error occured");
-			}
-		}
+	int queued;
+	alGetSourcei(mSource, AL_BUFFERS_QUEUED, &queued);
+	ASSERT(alGetError() == 0, "AL error occured");
 
+	if (queued)
+	{
 		int streamState;
 		alGetSourcei(mSource, AL_SOURCE_STATE, &streamState);
 
-		if (streamState == AL_STOPPED)
+		// The source stops if it runs out of queued data -- resume it
+		if (streamState != AL_PLAYING)
 		{
 			alSourcePlay(mSource);
 		}
-
 		return true;
 	}
-	else
+	else if (mDecoded && mConsumed == mProduced)
 	{
-		// Load the buffers with initial data in case the sound is to be played again.
+		// Rewind the stream in case the sound is to be played again
 		Init();
 		mState = State::Stopped;
 		mActiveInstancesEntry = NULL;
 		return false;
 	}
+
+	// Still waiting on the decoder thread
+	return true;
 }
 
 void StreamedInstance::SetRepeat(bool repeat)
@@ -125,6 +188,9 @@ void StreamedInstance::Play()
 	{
 		mState = State::Playing;
 
+		// Queue whatever the decoder thread has prepared so far -- Update() takes care of the rest
+		_UploadAll();
+
 		alSourcePlay(mSource);
 		ASSERT(alGetError() == 0, "AL error occured");
 
@@ -159,3 +225,12 @@ void StreamedInstance::Stop()
 		Init();
 	}
 }
+
+//============================================================================================================
+// Returns the instance to the sound's pool rather than deleting it
+//============================================================================================================
+
+void StreamedInstance::DestroySelf()
+{
+	((StreamedSound*)mSound)->_Recycle(this);
+}
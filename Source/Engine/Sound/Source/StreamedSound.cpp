@@ -1,28 +1,65 @@
 #include "../Include/_All.h"
 
+#include "AL/al.h"
+
 using namespace R5;
 
 //============================================================================================================
-// Creates a new instance of streamed sound object
+// Returns a new instance of the streamed sound, reusing a previously released one if possible
 //============================================================================================================
 
 SoundInstance* StreamedSound::Instantiate()
 {
-	StreamedInstance* inst = new StreamedInstance(this);
+	StreamedInstance* inst = 0;
+
+	mPoolLock.Lock();
+	{
+		if (mPool.IsValid())
+		{
+			inst = mPool.Back();
+			mPool.Shrink();
+		}
+	}
+	mPoolLock.Unlock();
+
+	if (inst == 0)
+	{
+		inst = new StreamedInstance(this);
+	}
+	else
+	{
+		// Pooled instances don't count as references to the sound
+		++mRefCount;
+	}
+
 	inst->Init();
-	
+
+	// The decoder thread will now start filling the instance's ring
+	mDecoder->Add(inst);
 	return inst;
 }
 
-StreamedSound::StreamedSound(const String& name, AudioData *audioData)
+//============================================================================================================
+
+StreamedSound::StreamedSound(const String& name, AudioData *audioData, AudioDecoder* decoder)
 {
 	mName = name;
 	mAudioData = audioData;
-	mAudioData->SetChunkSize(4096);
+	mDecoder = decoder;
 }
 
 StreamedSound::~StreamedSound()
 {
+	mPoolLock.Lock();
+	{
+		// Pooled instances have already given up their reference, so restore it before deleting them
+		mRefCount += mPool.GetSize();
+
+		FOREACH(i, mPool) delete mPool[i];
+		mPool.Release();
+	}
+	mPoolLock.Unlock();
+
 	delete mAudioData;
 }
 
@@ -31,7 +68,27 @@ void StreamedSound::SetAudioData(AudioData* audioData)
 	mAudioData = audioData;
 }
 
-AudioData* StreamedSound::GetAudioData() 
+//============================================================================================================
+// Stops the instance and returns it to the pool
+//============================================================================================================
+
+void StreamedSound::_Recycle(StreamedInstance* inst)
 {
-	return mAudioData;
+	mDecoder->Remove(inst);
+
+	inst->mState = SoundInstance::State::Stopped;
+	inst->Init();
+	inst->_Detach();
+
+	// Restore the default source settings for the next user
+	inst->mVolume = 1.0f;
+	inst->SetSpatial(true);
+	inst->SetPosition(Vector3f());
+	inst->SetVelocity(Vector3f());
+
+	--mRefCount;
+
+	mPoolLock.Lock();
+	mPool.Expand() = inst;
+	mPoolLock.Unlock();
 }
@@ -0,0 +1,63 @@
+#pragma once
+
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// Debugger widget -- shows the profiler zones that took the most time during the last frame
+// Author: Michael Lyashenko
+//============================================================================================================
+
+class UIProfiler : public UIAnimatedFrame
+{
+private:
+
+	bool			mIsDirty;
+	bool			mSelfTime;
+	Color4ub		mShadow;
+	Array<UILabel*>	mLabels;
+	Array<Profiler::ZoneStats> mZones;
+
+	// INTERNAL: Adds a new label to the list
+	UILabel* _AddLabel (uint index);
+
+	// INTERNAL: Changes the number of displayed zones
+	void _SetLabelCount (uint count);
+
+public:
+
+	UIProfiler() : mIsDirty(false), mSelfTime(false) {}
+
+	R5_DECLARE_INHERITED_CLASS(UIProfiler, UIFrame, UIWidget);
+
+	// Font used by the labels
+	const IFont* GetFont() const { return mLabels.IsValid() ? mLabels[0]->GetFont() : 0; }
+	void SetFont (const IFont* font) { for (uint i = mLabels.GetSize(); i > 0; ) mLabels[--i]->SetFont(font); mIsDirty = true; }
+
+	// Color of the drop-down shadow
+	const Color4ub& GetShadowColor() const { return mShadow; }
+	void SetShadowColor (const Color4ub& c) { mShadow = c; }
+
+	// Number of zones shown by the widget
+	uint GetZoneCount() const { return mLabels.IsValid() ? mLabels.GetSize() - 1 : 0; }
+	void SetZoneCount (uint count) { _SetLabelCount(count + 1); }
+
+	// Whether zones are sorted by the time spent in them, excluding nested zones
+	bool IsUsingSelfTime() const { return mSelfTime; }
+	void SetUseSelfTime (bool val) { mSelfTime = val; }
+
+	// Function called after the parent and root have been set -- enables the profiler
+	virtual void OnInit();
+
+	// Change the layer of the labels
+	virtual void OnLayerChanged();
+
+	// Only the update event is necessary for this widget
+	virtual bool OnUpdate (bool dimensionsChanged);
+
+protected:
+
+	// Serialization
+	virtual void OnSerializeTo (TreeNode& node) const;
+	virtual bool OnSerializeFrom (const TreeNode& node);
+};
@@ -50,6 +50,7 @@ namespace R5
 	#include "UIList.h"				// Slightly extended menu class that updates the button's text
 	#include "UITreeView.h"			// Widget designed to visualize TreeNode hierarchies
 	#include "UIStats.h"			// Debugger widget -- contains various run-time statistics
+	#include "UIProfiler.h"			// Debugger widget -- shows the most expensive profiler zones
 
 	#include "USFadeIn.h"			// Script that fades in the widget
 	#include "USFadeOut.h"			// Script that fades out the widget
@@ -58,6 +58,7 @@ UIManager::UIManager() :
 		UIWidget::Register<UIShadedArea>();
 		UIWidget::Register<UIColorPicker>();
 		UIWidget::Register<UIStats>();
+		UIWidget::Register<UIProfiler>();
 		UIWidget::Register<UITreeView>();
 
 		UIScript::Register<USEventListener>();
@@ -402,6 +403,7 @@ void UIManager::OnResize(const Vector2i& size)
 
 bool UIManager::Update()
 {
+	R5_PROFILE("UIManager::Update");
 	Lock();
 	{
 		// Update all widgets
@@ -575,6 +577,26 @@ bool UIManager::OnChar (byte character)
 	return retVal;
 }
 
+//============================================================================================================
+// Tags recognized by UIManager::SerializeFrom(), in the same order as the values below
+//============================================================================================================
+
+struct UITag
+{
+	enum
+	{
+		UI,
+		DefaultSkin,
+		DefaultFont,
+		TooltipDelay,
+		Skin,
+		Layout,
+	};
+};
+
+const char* g_uiTags[] = { "UI", "Default Skin", "Default Font", "Tooltip Delay", "Skin", "Layout", 0 };
+TagMap g_uiTagMap (g_uiTags);
+
 //============================================================================================================
 // Serialization -- Load
 //============================================================================================================
@@ -586,37 +608,49 @@ bool UIManager::SerializeFrom (const TreeNode& root, bool threadSafe)
 		for (uint i = 0; i < root.mChildren.GetSize(); ++i)
 		{
 			const TreeNode& node  = root.mChildren[i];
-			const String&	tag   = node.mTag;
 			const Variable&	value = node.mValue;
 
-			if (tag == "UI")
-			{
-				SerializeFrom(node, false);
-				if (threadSafe) Unlock();
-				return true;
-			}
-			else if (tag == "Default Skin")
-			{
-				UISkin* skin = GetSkin( value.AsString() );
-				SetDefaultSkin(skin);
-			}
-			else if (tag == "Default Font")
-			{
-				IFont* font = GetFont( value.AsString() );
-				SetDefaultFont(font);
-			}
-			else if (tag == "Tooltip Delay")
-			{
-				value >> mTtDelay;
-			}
-			else if (tag == "Skin")
-			{
-				UISkin* skin = GetSkin( value.AsString(), false );
-				skin->SerializeFrom(node);
-			}
-			else if (tag == "Layout")
+			switch (g_uiTagMap[node])
 			{
-				mRoot.SerializeFrom(node);
+				case UITag::UI:
+				{
+					SerializeFrom(node, false);
+					if (threadSafe) Unlock();
+					return true;
+				}
+
+				case UITag::DefaultSkin:
+				{
+					UISkin* skin = GetSkin( value.AsString() );
+					SetDefaultSkin(skin);
+				}
+				break;
+
+				case UITag::DefaultFont:
+				{
+					IFont* font = GetFont( value.AsString() );
+					SetDefaultFont(font);
+				}
+				break;
+
+				case UITag::TooltipDelay:
+				{
+					value >> mTtDelay;
+				}
+				break;
+
+				case UITag::Skin:
+				{
+					UISkin* skin = GetSkin( value.AsString(), false );
+					skin->SerializeFrom(node);
+				}
+				break;
+
+				case UITag::Layout:
+				{
+					mRoot.SerializeFrom(node);
+				}
+				break;
 			}
 		}
 
@@ -697,6 +731,7 @@ bool UIManager::SerializeTo (TreeNode& root, bool threadSafe) const
 
 uint UIManager::Draw()
 {
+	R5_PROFILE("UIManager::Draw");
 	mIsDirty = false;
 	uint triangles (0);
 
@@ -0,0 +1,157 @@
+#include "../Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// INTERNAL: Adds a new label to the list
+//============================================================================================================
+
+UILabel* UIProfiler::_AddLabel (uint index)
+{
+	UILabel* lbl = AddWidget<UILabel>(String("%s Zone %u", mName.GetBuffer(), index), false);
+	lbl->SetSerializable(false);
+	lbl->SetEventHandling(EventHandling::None);
+	lbl->SetLayer(mLayer);
+
+	if (mLabels.IsValid()) lbl->SetFont(mLabels[0]->GetFont());
+
+	UIRegion& rgn = lbl->GetRegion();
+	rgn.SetLeft(0.0f, 2.0f);
+	rgn.SetRight(1.0f, -2.0f);
+	return lbl;
+}
+
+//============================================================================================================
+// INTERNAL: Changes the number of displayed zones. The first label is the summary.
+//============================================================================================================
+
+void UIProfiler::_SetLabelCount (uint count)
+{
+	if (count < 2) count = 2;
+
+	while (mLabels.GetSize() < count) mLabels.Expand() = _AddLabel(mLabels.GetSize());
+
+	while (mLabels.GetSize() > count)
+	{
+		mLabels.Back()->DestroySelf();
+		mLabels.Shrink();
+	}
+	mIsDirty = true;
+}
+
+//============================================================================================================
+// Function called after the parent and root have been set
+//============================================================================================================
+
+void UIProfiler::OnInit()
+{
+	mShadow.Set(0, 0, 0, 175);
+	_SetLabelCount(9);
+
+	// The widget is useless without the profiler
+	Profiler::SetEnabled(true);
+}
+
+//============================================================================================================
+// Change the layer of the labels
+//============================================================================================================
+
+void UIProfiler::OnLayerChanged()
+{
+	for (uint i = mLabels.GetSize(); i > 0; )
+		mLabels[--i]->SetLayer(mLayer);
+}
+
+//============================================================================================================
+// Only the update event is necessary for this widget
+//============================================================================================================
+
+bool UIProfiler::OnUpdate (bool dimensionsChanged)
+{
+	if (mIsDirty)
+	{
+		const IFont* font = GetFont();
+		if (font == 0) return false;
+		uint size = font->GetSize();
+
+		for (uint i = 0; i < mLabels.GetSize(); ++i)
+		{
+			UIRegion& rgn = mLabels[i]->GetRegion();
+			rgn.SetTop(0.0f, 2.0f + (float)(size * i));
+			rgn.SetBottom(0.0f, 2.0f + (float)(size * (i + 1)));
+		}
+	}
+
+	uint count = mLabels.GetSize() - 1;
+	mZones.ExpandTo(count);
+	count = Profiler::GetTopZones(mZones.GetBuffer(), count, mSelfTime);
+
+	for (uint i = 0; i < mLabels.GetSize(); ++i) mLabels[i]->SetShadowColor(mShadow);
+
+	mLabels[0]->SetText( String("[FF5555]%.2f[FFFFFF] ms per frame", Profiler::GetFrameTime()) );
+
+	for (uint i = 1; i < mLabels.GetSize(); ++i)
+	{
+		if (i > count)
+		{
+			mLabels[i]->SetText("");
+		}
+		else
+		{
+			const Profiler::ZoneStats& zone = mZones[i - 1];
+
+			mLabels[i]->SetText( String("[FF5555]%.2f[FFFFFF] ms (%ux) %s",
+				mSelfTime ? zone.mSelf : zone.mTime, zone.mCalls, zone.mName) );
+		}
+	}
+
+	if (mIsDirty)
+	{
+		mIsDirty = false;
+		return true;
+	}
+	return false;
+}
+
+//============================================================================================================
+// Serialization -- Save
+//============================================================================================================
+
+void UIProfiler::OnSerializeTo (TreeNode& node) const
+{
+	const IFont* font = GetFont();
+	if (font != 0 && font != mUI->GetDefaultFont()) node.AddChild("Font", font->GetName());
+	node.AddChild("Shadow Color", mShadow);
+	node.AddChild("Zones", GetZoneCount());
+	node.AddChild("Self Time", mSelfTime);
+}
+
+//============================================================================================================
+// Serialization -- Load
+//============================================================================================================
+
+bool UIProfiler::OnSerializeFrom (const TreeNode& node)
+{
+	if (node.mTag == "Font")
+	{
+		SetFont( mUI->GetFont(node.mValue.AsString()) );
+		return true;
+	}
+	else if (node.mTag == "Shadow Color")
+	{
+		Color4ub c;
+		if (node.mValue >> c) SetShadowColor(c);
+		return true;
+	}
+	else if (node.mTag == "Zones")
+	{
+		uint count;
+		if (node.mValue >> count) SetZoneCount(count);
+		return true;
+	}
+	else if (node.mTag == "Self Time")
+	{
+		node.mValue >> mSelfTime;
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,172 @@
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// AudioBench measures the software mixer without an audio device. Voices scattered around the listener are
+// mixed into a null sink (or a WAV file), reporting the number of voices mixed per millisecond. By default
+// the voices play generated tones: a mono one that has to be resampled and a stereo one that doesn't.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+#include "../../Engine/Sound/Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Generates a looping tone with a bit of noise, 'frames' long
+//============================================================================================================
+
+void GenerateTone (Array<short>& samples, uint frames, uint channels, uint rate, float frequency)
+{
+	Random random (12345);
+	samples.Clear();
+	samples.Reserve(frames * channels);
+
+	for (uint i = 0; i < frames; ++i)
+	{
+		float phase = TWOPI * frequency * i / rate;
+
+		for (uint c = 0; c < channels; ++c)
+		{
+			float val = 0.5f * Float::Sin(phase + c) + 0.05f * random.GenerateRangeFloat();
+			samples.Expand() = (short)Float::RoundToInt(val * 32767.0f);
+		}
+	}
+}
+
+//============================================================================================================
+// Mixes 'seconds' worth of audio with the specified number of voices, only 'maxVoices' of which get mixed
+//============================================================================================================
+
+void Run (SoftAudio& audio, const Array<ISound*>& sounds, uint voices, uint maxVoices, float seconds)
+{
+	Random random (54321);
+	Array<ISoundInstance*> instances;
+
+	for (uint i = 0; i < voices; ++i)
+	{
+		// Voices are scattered up to 20 units away from the listener, so all of them remain audible
+		Vector3f pos (random.GenerateRangeFloat(), random.GenerateRangeFloat(), random.GenerateRangeFloat());
+		ISoundInstance* inst = audio.Instantiate(sounds[i % sounds.GetSize()], pos * 20.0f, 0, 0.0f, true);
+		inst->Play();
+		instances.Expand() = inst;
+	}
+
+	audio.SetMaxVoices(maxVoices);
+	audio.ResetStats();
+
+	uint frames = (uint)(seconds * audio.GetRate());
+	double start = Time::GetSystemSeconds();
+
+	for (uint offset = 0; offset < frames; offset += SoftAudio::BlockFrames)
+		audio.Mix( Min(frames - offset, (uint)SoftAudio::BlockFrames) );
+
+	double elapsed = (Time::GetSystemSeconds() - start) * 1000.0;
+	const SoftAudio::Stats& stats = audio.GetStats();
+
+	printf("  %8u %8u %8u %10.3f ms %12.1f %10.1fx\n", voices, stats.mMixed, stats.mVirtual, elapsed,
+		stats.GetVoicesPerMs(), (elapsed > 0.0) ? seconds * 1000.0 / elapsed : 0.0);
+
+	FOREACH(i, instances) instances[i]->DestroySelf();
+}
+
+//============================================================================================================
+// Application entry point
+//============================================================================================================
+
+int main (int argc, char* argv[])
+{
+#ifdef _MACOS
+	String path ( System::GetPathFromFilename(argv[0]) );
+	System::SetCurrentPath(path.GetBuffer());
+	System::SetCurrentPath("../../../");
+#endif
+
+	String	file;
+	String	wav;
+	uint	voices		= 0;
+	uint	maxVoices	= 0;
+	float	seconds		= 5.0f;
+	uint	rate		= 44100;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		String arg (argv[i]);
+
+		if		(arg == "-voices" && i + 1 < argc)	voices = atoi(argv[++i]);
+		else if (arg == "-max" && i + 1 < argc)		maxVoices = atoi(argv[++i]);
+		else if (arg == "-seconds" && i + 1 < argc)	seconds = (float)atof(argv[++i]);
+		else if (arg == "-rate" && i + 1 < argc)	rate = atoi(argv[++i]);
+		else if (arg == "-wav" && i + 1 < argc)		wav = argv[++i];
+		else if (arg == "-path" && i + 1 < argc)	System::SetCurrentPath(argv[++i]);
+		else if (arg.BeginsWith("-"))				{ seconds = 0.0f; break; }
+		else										file = arg;
+	}
+
+	if (seconds <= 0.0f || rate == 0)
+	{
+		printf("Usage: AudioBench [-voices N] [-max N] [-seconds N] [-rate N] [-wav <output file>] [-path <resources>] [sound file]\n");
+		printf("Example: AudioBench -path ../../Resources -voices 256 Sound/bling.ogg\n");
+		return 0;
+	}
+
+	AudioSink* sink = 0;
+
+	if (wav.IsValid())
+	{
+		WavSink* wavSink = new WavSink(wav, rate);
+
+		if (!wavSink->IsValid())
+		{
+			printf("ERROR: Unable to create '%s'\n", wav.GetBuffer());
+			delete wavSink;
+			return 1;
+		}
+		sink = wavSink;
+	}
+
+	SoftAudio audio (sink, rate);
+	audio.SetListener(Vector3f(), Vector3f(0.0f, 1.0f, 0.0f), Vector3f(0.0f, 0.0f, 1.0f), Vector3f());
+	Array<ISound*> sounds;
+
+	if (file.IsValid())
+	{
+		ISound* sound = audio.GetSound(file);
+
+		if (sound == 0)
+		{
+			printf("ERROR: Unable to load '%s'\n", file.GetBuffer());
+			return 1;
+		}
+		sounds.Expand() = sound;
+		printf("Loaded '%s'\n", file.GetBuffer());
+	}
+	else
+	{
+		Array<short> samples;
+		GenerateTone(samples, 22050, 1, 22050, 440.0f);
+		sounds.Expand() = audio.CreateSound("Mono Tone", samples.GetBuffer(), 22050, 1, 22050);
+		GenerateTone(samples, rate, 2, rate, 660.0f);
+		sounds.Expand() = audio.CreateSound("Stereo Tone", samples.GetBuffer(), rate, 2, rate);
+	}
+
+#ifdef R5_SSE
+	printf("SIMD: SSE\n");
+#else
+	printf("SIMD: none\n");
+#endif
+	printf("%.1f seconds of audio at %u Hz per run\n\n", seconds, rate);
+	printf("  %8s %8s %8s %13s %12s %11s\n", "Voices", "Mixed", "Virtual", "Time", "Voices/ms", "Realtime");
+
+	if (voices > 0)
+	{
+		Run(audio, sounds, voices, maxVoices > 0 ? maxVoices : voices, seconds);
+	}
+	else
+	{
+		// Everything gets mixed, then only the loudest 64 voices are mixed and the rest become virtual
+		const uint counts[] = { 16, 64, 256, 1024 };
+		for (uint i = 0; i < 4; ++i) Run(audio, sounds, counts[i], maxVoices > 0 ? maxVoices : counts[i], seconds);
+		Run(audio, sounds, 1024, 64, seconds);
+	}
+	return 0;
+}
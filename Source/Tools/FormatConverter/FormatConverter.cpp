@@ -16,6 +16,131 @@ using namespace R5;
 #define READ_ERROR	printf("ERROR: Unable to read '%s'\n", filename.GetBuffer())
 #define WRITE_ERROR printf("ERROR: Unable to write '%s'\n", filename.GetBuffer())
 
+//============================================================================================================
+// Adds the vertex attribute array to the optimizer (or rearranges it) if its size matches the vertex count
+//============================================================================================================
+
+bool AddStream (MeshOptimizer& opt, const Variable& value, uint vertices)
+{
+	if		(value.IsVector3fArray() && value.AsVector3fArray().GetSize() == vertices)	opt.AddStream(value.AsVector3fArray());
+	else if (value.IsVector2fArray() && value.AsVector2fArray().GetSize() == vertices)	opt.AddStream(value.AsVector2fArray());
+	else if (value.IsColor4fArray()	 && value.AsColor4fArray().GetSize()  == vertices)	opt.AddStream(value.AsColor4fArray());
+	else if (value.IsColor4ubArray() && value.AsColor4ubArray().GetSize() == vertices)	opt.AddStream(value.AsColor4ubArray());
+	else return false;
+	return true;
+}
+
+void RemapStream (Variable& value, const Array<uint>& remap, uint count)
+{
+	if		(value.IsVector3fArray())	MeshOptimizer::Remap(value.ToVector3fArray(), remap, count);
+	else if (value.IsVector2fArray())	MeshOptimizer::Remap(value.ToVector2fArray(), remap, count);
+	else if (value.IsColor4fArray())	MeshOptimizer::Remap(value.ToColor4fArray(),  remap, count);
+	else if (value.IsColor4ubArray())	MeshOptimizer::Remap(value.ToColor4ubArray(), remap, count);
+}
+
+//============================================================================================================
+// Welds duplicate vertices and reorders the triangles of the specified mesh node
+//============================================================================================================
+
+void OptimizeMesh (TreeNode& mesh)
+{
+	TreeNode* vertNode = 0;
+	TreeNode* faceNode = 0;
+
+	FOREACH(i, mesh.mChildren)
+	{
+		TreeNode& child = mesh.mChildren[i];
+
+		if (child.mTag == "Vertices")
+		{
+			vertNode = &child;
+		}
+		else if (child.mTag == "Triangles")
+		{
+			faceNode = &child;
+		}
+		else if (child.mTag.BeginsWith("Compact"))
+		{
+			printf("Skipped '%s': compact meshes can't be optimized\n", mesh.mValue.AsString().GetBuffer());
+			return;
+		}
+	}
+
+	if (vertNode == 0 || !vertNode->mValue.IsVector3fArray()) return;
+	uint vertices = vertNode->mValue.AsVector3fArray().GetSize();
+
+	Array<uint> indices;
+
+	if (faceNode != 0)
+	{
+		if (faceNode->mValue.IsUIntArray())
+		{
+			indices.CopyMemory(faceNode->mValue.AsUIntArray());
+		}
+		else if (faceNode->mValue.IsUShortArray())
+		{
+			const Array<ushort>& in = faceNode->mValue.AsUShortArray();
+			FOREACH(i, in) indices.Expand() = in[i];
+		}
+		else return;
+	}
+	else
+	{
+		// Unindexed triangle list -- every vertex is used in order
+		for (uint i = 0; i < vertices; ++i) indices.Expand() = i;
+		faceNode = &mesh.AddChild("Triangles");
+	}
+
+	MeshOptimizer opt;
+	FOREACH(i, mesh.mChildren) AddStream(opt, mesh.mChildren[i].mValue, vertices);
+
+	MeshOptimizer::Stats before, after;
+	MeshOptimizer::GetStats(indices, before);
+
+	Array<uint> remap;
+	uint count = opt.Optimize(indices, remap);
+
+	FOREACH(i, mesh.mChildren)
+	{
+		TreeNode& child = mesh.mChildren[i];
+		if (&child != faceNode) RemapStream(child.mValue, remap, count);
+	}
+
+	// Indices are saved as 16-bit values unless there are too many vertices
+	if (count > 65536)
+	{
+		faceNode->mValue.ToUIntArray().CopyMemory(indices);
+	}
+	else
+	{
+		Array<ushort>& out = faceNode->mValue.ToUShortArray();
+		out.Clear();
+		FOREACH(i, indices) out.Expand() = (ushort)indices[i];
+	}
+
+	MeshOptimizer::GetStats(indices, after);
+
+	printf("Optimized '%s': %u -> %u vertices, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+		mesh.mValue.AsString().GetBuffer(), vertices, count,
+		before.mACMR, after.mACMR, before.mATVR, after.mATVR);
+}
+
+//============================================================================================================
+// Optimizes all meshes found in the tree
+//============================================================================================================
+
+void OptimizeMeshes (TreeNode& node)
+{
+	if (node.mTag == "Mesh")
+	{
+		OptimizeMesh(node);
+	}
+	else
+	{
+		FOREACH(i, node.mChildren) OptimizeMeshes(node.mChildren[i]);
+	}
+}
+
 //============================================================================================================
 // Main application entry point
 //============================================================================================================
@@ -30,6 +155,10 @@ int main (int argc, char* argv[])
 
 	uint errors = 0;
 
+	// Meshes are only optimized when requested
+	bool optimize = false;
+	for (int i = 1; i < argc; ++i) if (strcmp(argv[i], "-optimize") == 0) optimize = true;
+
 #ifndef _DEBUG
 	if (argc > 1)
 #endif
@@ -42,6 +171,7 @@ int main (int argc, char* argv[])
 #endif
 		{
 #ifndef _DEBUG
+			if (argv[i][0] == '-') continue;
 			String filename (argv[i]);
 #else
 			String filename ("c:/projects/r5ge/resources/models/shadow test 2.r5c");
@@ -75,6 +205,7 @@ int main (int argc, char* argv[])
 					}
 					else if (root.Load(mem))
 					{
+						if (optimize) OptimizeMeshes(root);
 						filename.Replace(ext, ext == "r5c" ? "r5a" : "r5c");
 
 						if (root.Save(filename.GetBuffer()))
@@ -106,7 +237,8 @@ int main (int argc, char* argv[])
 	{
 		++errors;
 		puts("R5 Format Converter Tool v.2.0.0 by Michael Lyashenko");
-		puts("Usage: FormatConverter file0 [file1] [file2] [...]");
+		puts("Usage: FormatConverter [-optimize] file0 [file1] [file2] [...]");
+		puts("-optimize: welds duplicate vertices and reorders triangles of all meshes for the vertex cache");
 		puts("You can also drag the file in question onto this executable in order to convert it.");
 	}
 #endif
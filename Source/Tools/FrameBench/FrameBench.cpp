@@ -0,0 +1,897 @@
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// FrameBench runs the specified scene through Core::Update using the headless graphics backend,
+// measuring the CPU cost of every stage of the frame. No videocard is required. Instead of loading a scene,
+// a hierarchy of the specified number of objects can be generated in order to measure the scene update,
+// and a number of delayed callbacks can be kept pending in order to measure the cost of waiting timers.
+// A generated terrain can be viewed from several distances as well, reporting the geometry submitted at each.
+// Particle emitters can be simulated using either the built-in behaviours or an UpdateParticle() override,
+// and a field of billboards and glares can be drawn, reporting how many draw calls they were batched into.
+// Finally, the draw queue's sort can be measured on its own, with the objects added in random or sorted order.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+#include "../../Engine/OpenGL/Include/_All.h"
+#include "../../Engine/UI/Include/_All.h"
+#include "../../Engine/Core/Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Stages of the frame, timed using markers placed into the update lists and the window's frame callbacks
+//============================================================================================================
+
+struct Stage
+{
+	enum
+	{
+		Models = 0,	// Model updates and pre-update callbacks
+		Scene,		// Scene update and post-update callbacks
+		UI,			// UI update and late-update callbacks
+		Other,		// Time spent between the update and the start of the frame
+		Draw,		// Everything between BeginFrame and EndFrame
+		Finish,		// Frame arena reset and sleep after EndFrame
+		Count,
+	};
+};
+
+const char* g_stageNames[] =
+{
+	"Models & pre-update",
+	"Scene & post-update",
+	"UI & late-update",
+	"Other",
+	"Draw",
+	"End of frame",
+};
+
+//============================================================================================================
+// Emitters used by the particle benchmark. Both spawn identical particles that live for the entire run, but
+// the first one relies on the built-in behaviours while the second one applies the same behaviours itself.
+//============================================================================================================
+
+Random g_random;
+
+class BenchEmitter : public Emitter
+{
+public:
+
+	R5_DECLARE_INHERITED_CLASS(BenchEmitter, Emitter, Object);
+
+	BenchEmitter()
+	{
+		mLifetime	= 1000000;
+		mFrequency	= 0;
+		mActiveTime	= 1000000;
+
+		mBehavior.mGravity.Set(0.0f, 0.0f, -9.8f);
+		mBehavior.mDrag	= 0.5f;
+		mBehavior.mSize.Set(0.5f, 2.0f);
+		mBehavior.mFade.Set(0.1f, 0.3f);
+		mBehavior.mSpin	= 1.0f;
+	}
+
+protected:
+
+	virtual void InitParticle (Particle& particle)
+	{
+		particle.mSpawnDir.Set(g_random.GenerateRangeFloat(), g_random.GenerateRangeFloat(),
+			g_random.GenerateRangeFloat() + 3.0f);
+		particle.mRotation = g_random.GenerateFloat() * TWOPI;
+	}
+
+	virtual void SetRenderStates (IGraphics* graphics) {}
+};
+
+//============================================================================================================
+
+class CustomEmitter : public BenchEmitter
+{
+public:
+
+	R5_DECLARE_INHERITED_CLASS(CustomEmitter, BenchEmitter, Object);
+
+protected:
+
+	// Same math as the built-in behaviours, one particle at a time
+	virtual void UpdateParticle (Particle& particle)
+	{
+		const Behavior& b = mBehavior;
+		float dt = 0.001f * mDelta;
+		float damping = Max(1.0f - b.mDrag * dt, 0.0f);
+
+		particle.mSpawnDir	= particle.mSpawnDir * damping + b.mGravity * dt;
+		particle.mPos	   += particle.mSpawnDir * dt;
+
+		float left		= Min((float)particle.mRemaining / mLifetime, 1.0f);
+		float progress	= 1.0f - left;
+		float in		= (b.mFade.x > 0.0f) ? Min(progress / b.mFade.x, 1.0f) : 1.0f;
+		float out		= (b.mFade.y > 0.0f) ? Min(left / b.mFade.y, 1.0f) : 1.0f;
+
+		particle.mRadius	 = mAbsoluteScale.x * Interpolation::Linear(b.mSize.x, b.mSize.y, progress);
+		particle.mRotation	+= b.mSpin * dt;
+		particle.mColor.a	 = Float::ToRangeByte(in * out);
+	}
+};
+
+//============================================================================================================
+
+class FrameBench
+{
+	NullWindow*		mWin;
+	NullGraphics*	mGraphics;
+	UI*				mUI;
+	Core*			mCore;
+
+	double		mMarker[Stage::Count + 1];	// Timestamps of the current frame's markers
+	double		mTotal[Stage::Count];		// Accumulated time spent in each stage
+	double		mMin;						// Fastest frame
+	double		mMax;						// Slowest frame
+	ulong		mStats[8];					// Accumulated frame statistics
+	Array<uint>	mCommands;					// Accumulated number of commands of each type
+	uint		mFired;						// Number of times the pending timers have fired
+
+public:
+
+	FrameBench() : mMin(0.0), mMax(0.0), mFired(0)
+	{
+		mWin		= new NullWindow();
+		mGraphics	= new NullGraphics();
+		mUI			= new UI(mGraphics, mWin);
+		mCore		= new Core(mWin, mGraphics, mUI);
+
+		// Markers are placed prior to loading the scene. Update lists are executed in reverse order,
+		// so these callbacks end up executing last in their respective lists.
+		mCore->AddOnPreUpdate ( bind(&FrameBench::OnPreUpdate,  this) );
+		mCore->AddOnPostUpdate( bind(&FrameBench::OnPostUpdate, this) );
+		mCore->AddOnLateUpdate( bind(&FrameBench::OnLateUpdate, this) );
+		mWin->SetOnBeginFrame ( bind(&FrameBench::OnBeginFrame, this) );
+		mWin->SetOnEndFrame	  ( bind(&FrameBench::OnEndFrame,	this) );
+
+		// The benchmark should run as fast as possible
+		mCore->SetSleepDelay(0);
+		mCore->SetUIOnlyModeSleepDelay(0);
+	}
+
+	~FrameBench()
+	{
+		if (mCore)		delete mCore;
+		if (mUI)		delete mUI;
+		if (mGraphics)	delete mGraphics;
+		if (mWin)		delete mWin;
+	}
+
+private:
+
+	float OnPreUpdate()		{ mMarker[Stage::Models + 1]	= Time::GetSystemSeconds(); return 0.0f; }
+	float OnPostUpdate()	{ mMarker[Stage::Scene + 1]		= Time::GetSystemSeconds(); return 0.0f; }
+	float OnLateUpdate()	{ mMarker[Stage::UI + 1]		= Time::GetSystemSeconds(); return 0.0f; }
+	void  OnBeginFrame()	{ mMarker[Stage::Other + 1]		= Time::GetSystemSeconds(); }
+	void  OnEndFrame()		{ mMarker[Stage::Draw + 1]		= Time::GetSystemSeconds(); }
+
+	// Pending timers re-arm themselves for anywhere between 1 and 60 seconds
+	float OnTimer()			{ return 1.0f + (float)(++mFired % 60); }
+
+	// Simulated visibility test: nothing ever gets in the way
+	bool OnQuery (const Vector3f& pos) { return true; }
+
+	// Runs a single frame, returning its duration in seconds
+	double RunFrame();
+
+	// Adds up the current frame's statistics
+	void Accumulate();
+
+	// Generates a random hierarchy of the specified number of objects, some of which keep rotating
+	void Generate (uint count);
+
+	// Generates a terrain split into the specified number of nodes per side, along with a camera to view it
+	Terrain* GenerateTerrain (uint nodes);
+
+	// Adds the specified number of emitters of the specified type, returning the object they were added to
+	template <typename Type> Object* GenerateEmitters (const String& name, uint count, uint particles);
+
+	// Adds the specified number of billboards of the specified type in front of the camera, using 4 textures
+	template <typename Type> Object* GenerateBillboards (const String& name, uint count, const String& tech);
+
+public:
+
+	// Adds the specified number of delayed pre-update callbacks, spread out over the next minute
+	void AddTimers (uint count);
+
+	// Updates the scene using the flattened transform hierarchy with the specified number of threads
+	void SetFlatUpdate (bool val, uint threads)
+	{
+		mCore->SetFlatUpdate(val);
+		mCore->GetTransformHierarchy().SetThreads(threads);
+	}
+
+	// Loads the scene (or generates a hierarchy of 'nodes' objects if no file was specified) and runs the
+	// specified number of frames. If a trace file is specified, profiler zones get saved out in the Chrome
+	// trace format.
+	bool Run (const String& file, uint nodes, uint frames, uint warmup, bool log, bool profile, const String& trace);
+
+	// Generates a terrain and views it from several distances, running the specified number of frames at each
+	// and reporting the number of vertices and triangles submitted per frame.
+	bool RunTerrain (uint nodes, uint frames, uint warmup);
+
+	// Simulates the specified number of emitters using the built-in behaviours, then using an UpdateParticle()
+	// override that does the same thing, reporting the number of particles simulated per millisecond.
+	bool RunEmitters (uint count, uint particles, uint frames, uint warmup);
+
+	// Draws the specified number of billboards using additive and alpha blending, followed by as many glares,
+	// reporting the number of draw calls each set was batched into.
+	bool RunBillboards (uint count, uint frames, uint warmup);
+};
+
+//============================================================================================================
+// Runs a single frame, returning its duration in seconds
+//============================================================================================================
+
+double FrameBench::RunFrame()
+{
+	// The scene only gets updated if it's dirty or some time has passed
+	mCore->SetDirty();
+
+	mMarker[0] = Time::GetSystemSeconds();
+	for (uint i = 1; i <= Stage::Count; ++i) mMarker[i] = mMarker[0];
+
+	mCore->Update();
+	mMarker[Stage::Count] = Time::GetSystemSeconds();
+
+	// Stages that were skipped collapse to the previous marker
+	for (uint i = 1; i < Stage::Count; ++i)
+		if (mMarker[i] < mMarker[i-1]) mMarker[i] = mMarker[i-1];
+
+	return mMarker[Stage::Count] - mMarker[0];
+}
+
+//============================================================================================================
+// Adds up the current frame's statistics
+//============================================================================================================
+
+void FrameBench::Accumulate()
+{
+	for (uint i = 0; i < Stage::Count; ++i)
+		mTotal[i] += mMarker[i+1] - mMarker[i];
+
+	const FrameStats& stats = mGraphics->GetFrameStats();
+	mStats[0] += stats.mTriangles;
+	mStats[1] += stats.mDrawCalls;
+	mStats[2] += stats.mMatSwitches;
+	mStats[3] += stats.mTexSwitches;
+	mStats[4] += stats.mBufferBinds;
+	mStats[5] += stats.mShaderSwitches;
+	mStats[6] += stats.mLightSwitches;
+	mStats[7] += stats.mTechSwitches;
+
+	const NullGraphics::Commands& commands = mGraphics->GetCommands();
+	for (uint i = 0; i < commands.GetSize(); ++i) ++mCommands[commands[i].mType];
+}
+
+//============================================================================================================
+// Generates a random hierarchy of the specified number of objects. Each object's parent is picked among the
+// objects created before it, giving a tree around 10 levels deep. Every 64th object keeps rotating, which
+// moves its entire subtree every frame.
+//============================================================================================================
+
+void FrameBench::Generate (uint count)
+{
+	Random random (12345);
+	Array<Object*> objects;
+	objects.Reserve(count + 1);
+	objects.Expand() = mCore->GetRoot();
+
+	mCore->Lock();
+	{
+		for (uint i = 0; i < count; ++i)
+		{
+			uint size = objects.GetSize();
+			uint first = size / 6;
+			Object* parent = objects[first + random.GenerateUint() % (size / 2 - first + 1)];
+			Object* obj = parent->AddObject<Object>( String("Object %u", i) );
+
+			obj->SetRelativePosition( Vector3f(random.GenerateRangeFloat(), random.GenerateRangeFloat(),
+				random.GenerateRangeFloat()) * 10.0f );
+			obj->SetRelativeRotation( Quaternion(random.GenerateRangeFloat(), random.GenerateRangeFloat(),
+				random.GenerateRangeFloat()) );
+
+			Bounds bounds;
+			bounds.Set(Vector3f(-1.0f), Vector3f(1.0f));
+			obj->SetRelativeBounds(bounds);
+
+			if ((i & 63) == 0)
+			{
+				OSRotate* rotate = obj->AddScript<OSRotate>();
+				rotate->SetAxis( Vector3f(random.GenerateRangeFloat(), random.GenerateRangeFloat(), 1.0f) );
+				rotate->SetRate(0.1f);
+			}
+			objects.Expand() = obj;
+		}
+	}
+	mCore->Unlock();
+}
+
+//============================================================================================================
+// Generates a 4 km terrain with rolling hills and a few ridges, split into the specified number of nodes per
+// side. Each node is a 33x33 mesh, giving every node 6 levels of detail. A camera drawing the scene using
+// forward rendering is added as well.
+//============================================================================================================
+
+Terrain* FrameBench::GenerateTerrain (uint nodes)
+{
+	const uint size = 513;
+	Array<float> heights;
+	heights.ExpandTo(size * size);
+
+	Random random (12345);
+	float phase[8];
+	for (uint i = 0; i < 8; ++i) phase[i] = random.GenerateFloat() * TWOPI;
+
+	for (uint y = 0; y < size; ++y)
+	{
+		for (uint x = 0; x < size; ++x)
+		{
+			float fx = (float)x / (size - 1);
+			float fy = (float)y / (size - 1);
+
+			float h = 0.0f;
+			h += 0.30f * Float::Sin(fx * 3.0f  + phase[0]) * Float::Cos(fy * 2.0f  + phase[1]);
+			h += 0.15f * Float::Sin(fx * 11.0f + phase[2]) * Float::Sin(fy * 13.0f + phase[3]);
+			h += 0.05f * Float::Cos(fx * 37.0f + phase[4]) * Float::Sin(fy * 31.0f + phase[5]);
+			h += 0.15f * Float::Abs(Float::Sin(fx * 7.0f + fy * 5.0f + phase[6]));
+			heights[y * size + x] = 0.5f + 0.5f * h + 0.01f * random.GenerateRangeFloat();
+		}
+	}
+
+	Terrain::Heightmap hm (heights.GetBuffer(), size, size);
+	hm.mMeshSize.Set(33, 33);
+	hm.mTerrainScale.Set(4096.0f, 4096.0f, 300.0f);
+	hm.mTerrainOffset.Set(-2048.0f, -2048.0f, 0.0f);
+
+	IMaterial* mat = mGraphics->GetMaterial("Terrain");
+	mat->SetDiffuse( Color4ub(255, 255, 255, 255) );
+	mat->GetDrawMethod(mGraphics->GetTechnique("Opaque"), true);
+
+	mCore->Lock();
+	Terrain* terrain = mCore->GetRoot()->AddObject<Terrain>("Terrain");
+	terrain->PartitionInto(nodes, nodes);
+	terrain->Generate(hm);
+	terrain->SetMaterial(mat);
+
+	Camera* cam = mCore->GetRoot()->AddObject<Camera>("Camera");
+	cam->SetRelativeRange( Vector3f(1.0f, 10000.0f, 90.0f) );
+	cam->AddScript<OSDrawForward>();
+	mCore->Unlock();
+	return terrain;
+}
+
+//============================================================================================================
+// Adds the specified number of emitters scattered around the origin. The random number generator is reset
+// first, so every set of emitters spawns the same particles.
+//============================================================================================================
+
+template <typename Type>
+Object* FrameBench::GenerateEmitters (const String& name, uint count, uint particles)
+{
+	Random random (12345);
+	g_random.SetSeed(54321);
+	ITexture* tex = mGraphics->GetTexture("Particle");
+
+	mCore->Lock();
+	Object* parent = mCore->GetRoot()->AddObject<Object>(name);
+
+	for (uint i = 0; i < count; ++i)
+	{
+		Type* emitter = parent->AddObject<Type>( String("Emitter %u", i) );
+		emitter->SetRelativePosition( Vector3f(random.GenerateRangeFloat(), random.GenerateRangeFloat(), 0.0f) * 50.0f );
+		emitter->SetMaxParticles(particles);
+		emitter->SetTexture(tex);
+	}
+	mCore->Unlock();
+	return parent;
+}
+
+//============================================================================================================
+// Adds the specified number of billboards scattered in front of the camera. Textures are assigned in turn,
+// so billboards sorted by distance rarely share a texture with their neighbours.
+//============================================================================================================
+
+template <typename Type>
+Object* FrameBench::GenerateBillboards (const String& name, uint count, const String& tech)
+{
+	Random random (12345);
+	ITechnique* technique = mGraphics->GetTechnique(tech);
+	ITexture* tex[4];
+	for (uint i = 0; i < 4; ++i) tex[i] = mGraphics->GetTexture( String("Billboard %u", i) );
+
+	mCore->Lock();
+	Object* parent = mCore->GetRoot()->AddObject<Object>(name);
+
+	for (uint i = 0; i < count; ++i)
+	{
+		Type* bb = parent->AddObject<Type>( String("Billboard %u", i) );
+		// Billboards stay well inside the camera's field of view
+		float dist = 150.0f + random.GenerateRangeFloat() * 100.0f;
+		bb->SetRelativePosition( Vector3f(random.GenerateRangeFloat() * 0.4f * dist, dist,
+			random.GenerateRangeFloat() * 0.3f * dist) );
+		bb->SetRelativeScale( Vector3f(0.5f + random.GenerateFloat()) );
+		bb->SetColor( Color4ub(255, 255, 255, 128) );
+		bb->SetTexture(tex[i & 3]);
+		bb->SetTechnique(technique);
+	}
+	mCore->Unlock();
+	return parent;
+}
+
+//============================================================================================================
+// Adds the specified number of delayed pre-update callbacks, spread out over the next minute
+//============================================================================================================
+
+void FrameBench::AddTimers (uint count)
+{
+	Random random (54321);
+
+	for (uint i = 0; i < count; ++i)
+	{
+		mCore->AddOnPreUpdate( bind(&FrameBench::OnTimer, this), 0.001f * (1 + random.GenerateUint() % 60000) );
+	}
+}
+
+//============================================================================================================
+// Loads the scene and runs the specified number of frames
+//============================================================================================================
+
+bool FrameBench::Run (const String& file, uint nodes, uint frames, uint warmup, bool log, bool profile, const String& trace)
+{
+	if (file.IsValid())
+	{
+		if (!(*mCore << file.GetBuffer()))
+		{
+			printf("ERROR: Unable to load '%s'\n", file.GetBuffer());
+			return false;
+		}
+		printf("Loaded '%s'\n", file.GetBuffer());
+	}
+	else
+	{
+		Generate(nodes);
+		printf("Generated %u objects\n", nodes);
+	}
+
+	// The configuration file may not have created the window
+	if (!mWin->IsValid()) mWin->Create("FrameBench", 100, 100, 1024, 768);
+
+	for (uint i = 0; i < warmup; ++i) RunFrame();
+
+	for (uint i = 0; i < Stage::Count; ++i) mTotal[i] = 0.0;
+	for (uint i = 0; i < 8; ++i) mStats[i] = 0;
+	mFired = 0;
+	mCommands.ExpandTo(NullGraphics::Command::Count, true);
+	mGraphics->SetRecording(log);
+
+	Array<Profiler::ZoneStats> zones;
+	Array<double> zoneTime;
+
+	if (trace.IsValid())	Profiler::StartCapture();
+	else if (profile)		Profiler::SetEnabled(true);
+
+	for (uint i = 0; i < frames; ++i)
+	{
+		double duration = RunFrame();
+
+		if (i == 0 || duration < mMin) mMin = duration;
+		if (i == 0 || duration > mMax) mMax = duration;
+
+		Accumulate();
+
+		if (profile)
+		{
+			Profiler::GetAllZones(zones);
+			zoneTime.ExpandTo(zones.GetSize(), true);
+			FOREACH(b, zones) zoneTime[b] += zones[b].mTime;
+		}
+	}
+
+	if (trace.IsValid())
+	{
+		if (Profiler::StopCapture(trace)) printf("Saved the trace to '%s'\n", trace.GetBuffer());
+		else printf("ERROR: Unable to save the trace to '%s'\n", trace.GetBuffer());
+	}
+
+	double scale = 1000.0 / frames;
+	double total = 0.0;
+	for (uint i = 0; i < Stage::Count; ++i) total += mTotal[i];
+
+	printf("\nFrames: %u (after %u warm-up frames)\n", frames, warmup);
+	printf("Average frame: %.4f ms (min %.4f, max %.4f)\n\n", total * scale, mMin * 1000.0, mMax * 1000.0);
+
+	for (uint i = 0; i < Stage::Count; ++i)
+	{
+		printf("  %-20s %10.4f ms  %5.1f%%\n", g_stageNames[i], mTotal[i] * scale,
+			(total > 0.0) ? 100.0 * mTotal[i] / total : 0.0);
+	}
+
+	printf("\nPer frame:\n");
+	printf("  Triangles:        %10.1f\n", (double)mStats[0] / frames);
+	printf("  Draw calls:       %10.1f\n", (double)mStats[1] / frames);
+	printf("  Matrix switches:  %10.1f\n", (double)mStats[2] / frames);
+	printf("  Texture switches: %10.1f\n", (double)mStats[3] / frames);
+	printf("  Buffer binds:     %10.1f\n", (double)mStats[4] / frames);
+	printf("  Shader switches:  %10.1f\n", (double)mStats[5] / frames);
+	printf("  Light switches:   %10.1f\n", (double)mStats[6] / frames);
+	printf("  Technique changes:%10.1f\n", (double)mStats[7] / frames);
+	printf("  Timers fired:     %10.1f\n", (double)mFired / frames);
+
+	if (nodes > 0)
+	{
+		// Bounds of the entire scene, useful for comparing the results of the two update methods
+		const Bounds& bounds = mCore->GetRoot()->GetCompleteBounds();
+		const Vector3f& min = bounds.GetMin();
+		const Vector3f& max = bounds.GetMax();
+		printf("  Scene bounds:     (%.3f %.3f %.3f) - (%.3f %.3f %.3f)\n", min.x, min.y, min.z, max.x, max.y, max.z);
+	}
+
+	if (log)
+	{
+		printf("\nRecorded commands per frame:\n");
+
+		for (uint i = 0; i < mCommands.GetSize(); ++i)
+		{
+			if (mCommands[i] > 0)
+			{
+				printf("  %-18s %10.1f\n", NullGraphics::GetCommandName(i), (double)mCommands[i] / frames);
+			}
+		}
+	}
+
+	if (profile)
+	{
+		printf("\nProfiler zones per frame:\n");
+
+		FOREACH(i, zones)
+		{
+			printf("  %-32s %10.4f ms\n", zones[i].mName, zoneTime[i] / frames);
+		}
+	}
+	return true;
+}
+
+//============================================================================================================
+// Views the generated terrain from several distances, starting in the middle of it and moving outward. The camera
+// always stays above the ground and looks at the terrain's center, so the entire terrain ends up in view.
+//============================================================================================================
+
+bool FrameBench::RunTerrain (uint nodes, uint frames, uint warmup)
+{
+	Terrain* terrain = GenerateTerrain(nodes);
+	Camera* cam = mCore->GetRoot()->FindObject<Camera>("Camera", false);
+	printf("Generated a terrain of %ux%u nodes with %u levels of detail\n", nodes, nodes, terrain->GetLODCount());
+
+	if (!mWin->IsValid()) mWin->Create("FrameBench", 100, 100, 1024, 768);
+
+	const float distances[] = { 0.0f, 250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f, 8000.0f };
+	const uint count = sizeof(distances) / sizeof(distances[0]);
+
+	printf("\n  %-9s %12s %12s %12s %12s %12s %10s\n", "Distance", "Vertices", "Triangles",
+		"Draw calls", "Full detail", "Reduction", "Frame ms");
+
+	for (uint i = 0; i < count; ++i)
+	{
+		// Stay above the terrain, looking down at its center
+		Vector3f pos (0.0f, -distances[i], 0.0f);
+		float ground = (distances[i] < 2048.0f) ? terrain->GetHeight(pos.x, pos.y) : 0.0f;
+		pos.z = Max(ground, terrain->GetHeight(0.0f, 0.0f)) + 50.0f + distances[i] * 0.1f;
+
+		Vector3f target (0.0f, distances[i] < 1.0f ? 1000.0f : 0.0f, terrain->GetHeight(0.0f, 0.0f));
+		cam->SetRelativePosition(pos);
+		cam->SetRelativeRotation( Quaternion(target - pos) );
+
+		ulong vertices[2] = { 0, 0 }, triangles[2] = { 0, 0 }, drawCalls = 0;
+		double total = 0.0;
+
+		// The first pass uses the terrain's levels of detail, the second one draws everything at full detail
+		for (uint pass = 0; pass < 2; ++pass)
+		{
+			float maxError = terrain->GetMaxError();
+			if (pass == 1) terrain->SetMaxError(0.0f);
+
+			for (uint f = 0; f < warmup; ++f) RunFrame();
+
+			for (uint f = 0; f < frames; ++f)
+			{
+				double duration = RunFrame();
+				vertices[pass]	+= terrain->GetVertexCount();
+				triangles[pass] += mGraphics->GetFrameStats().mTriangles;
+
+				if (pass == 0)
+				{
+					total += duration;
+					drawCalls += mGraphics->GetFrameStats().mDrawCalls;
+				}
+			}
+			terrain->SetMaxError(maxError);
+		}
+
+		printf("  %-9.0f %12.0f %12.0f %12.1f %12.0f %11.1fx %10.4f\n", distances[i],
+			(double)vertices[0] / frames,
+			(double)triangles[0] / frames,
+			(double)drawCalls / frames,
+			(double)triangles[1] / frames,
+			(triangles[0] > 0) ? (double)triangles[1] / triangles[0] : 0.0,
+			total * 1000.0 / frames);
+	}
+	return true;
+}
+
+//============================================================================================================
+// Simulates the emitters using both paths. All particles get spawned on the first frame and live for the
+// entire run, so every frame simulates the same number of particles.
+//============================================================================================================
+
+bool FrameBench::RunEmitters (uint count, uint particles, uint frames, uint warmup)
+{
+	Object::Register<BenchEmitter>();
+	Object::Register<CustomEmitter>();
+
+	if (!mWin->IsValid()) mWin->Create("FrameBench", 100, 100, 1024, 768);
+
+#ifdef R5_SSE
+	printf("SIMD: SSE\n");
+#else
+	printf("SIMD: none\n");
+#endif
+	printf("\n  %-10s %10s %12s %10s %14s\n", "Path", "Emitters", "Particles", "Frame ms", "Particles/ms");
+
+	const char* names[] = { "Built-in", "Custom" };
+	double perMs[2] = { 0.0, 0.0 };
+
+	for (uint pass = 0; pass < 2; ++pass)
+	{
+		Object* parent = (pass == 0) ?
+			GenerateEmitters<BenchEmitter> (names[pass], count, particles) :
+			GenerateEmitters<CustomEmitter>(names[pass], count, particles);
+
+		for (uint f = 0; f < warmup; ++f) RunFrame();
+
+		double total = 0.0;
+		for (uint f = 0; f < frames; ++f) total += RunFrame();
+
+		ulong active = 0;
+		const Object::Children& children = parent->GetChildren();
+		FOREACH(i, children) active += ((Emitter*)children[i])->GetActiveParticles();
+
+		double ms = total * 1000.0 / frames;
+		perMs[pass] = (ms > 0.0) ? active / ms : 0.0;
+		printf("  %-10s %10u %12lu %10.4f %14.1f\n", names[pass], children.GetSize(), active, ms, perMs[pass]);
+
+		// Only one set of emitters should be updated at a time
+		mCore->Lock();
+		parent->SetFlag(Object::Flag::Enabled, false);
+		mCore->Unlock();
+	}
+
+	if (perMs[1] > 0.0) printf("\nBuilt-in behaviours are %.1fx faster\n", perMs[0] / perMs[1]);
+	return true;
+}
+
+//============================================================================================================
+// Draws each set of billboards in turn, looking at them from the origin
+//============================================================================================================
+
+bool FrameBench::RunBillboards (uint count, uint frames, uint warmup)
+{
+	mCore->Lock();
+	Camera* cam = mCore->GetRoot()->AddObject<Camera>("Camera");
+	cam->SetRelativeRange( Vector3f(1.0f, 1000.0f, 90.0f) );
+	cam->SetRelativeRotation( Quaternion(Vector3f(0.0f, 1.0f, 0.0f)) );
+	cam->AddScript<OSDrawForward>();
+	mCore->Unlock();
+
+	mGraphics->SetOnQuery( bind(&FrameBench::OnQuery, this) );
+	if (!mWin->IsValid()) mWin->Create("FrameBench", 100, 100, 1024, 768);
+
+	printf("\n  %-12s %10s %12s %12s %10s\n", "Set", "Objects", "Draw calls", "Objects/call", "Frame ms");
+
+	const char* names[] = { "Additive", "Alpha", "Glare" };
+
+	for (uint pass = 0; pass < 3; ++pass)
+	{
+		Object* parent =
+			(pass == 0) ? GenerateBillboards<Billboard>(names[pass], count, "Glow") :
+			(pass == 1) ? GenerateBillboards<Billboard>(names[pass], count, "Particle") :
+						  GenerateBillboards<Glare>	   (names[pass], count, "Glare");
+
+		// Glares fade in over a few frames once their visibility tests come back
+		for (uint f = 0; f < warmup; ++f) RunFrame();
+
+		double total = 0.0;
+		ulong drawCalls = 0;
+
+		for (uint f = 0; f < frames; ++f)
+		{
+			total += RunFrame();
+			drawCalls += mGraphics->GetFrameStats().mDrawCalls;
+		}
+
+		double calls = (double)drawCalls / frames;
+		printf("  %-12s %10u %12.1f %12.1f %10.4f\n", names[pass], count, calls,
+			(calls > 0.0) ? count / calls : 0.0, total * 1000.0 / frames);
+
+		mCore->Lock();
+		parent->SetFlag(Object::Flag::Enabled, false);
+		mCore->Unlock();
+	}
+	return true;
+}
+
+//============================================================================================================
+// Objects added to the draw queue by the sorting benchmark. Each object is visible with a single technique,
+// as that's the only way the order of the added objects can match the sorted order.
+//============================================================================================================
+
+struct QueueItem
+{
+	uint	mTech;		// Technique index
+	uint	mGroup;		// Material the object belongs to
+	float	mDist;		// Squared distance to the camera
+};
+
+//============================================================================================================
+// Fills the draw queue with the specified items and sorts it, returning the time it took in seconds
+//============================================================================================================
+
+double FillQueue (DrawQueue& queue, const Array<QueueItem>& items)
+{
+	double start = Time::GetSystemSeconds();
+	queue.Clear();
+
+	// The queue never touches the objects until they get drawn, so their addresses don't need to be valid
+	FOREACH(i, items)
+	{
+		const QueueItem& item = items[i];
+		queue.Add(0, (Object*)(size_t)(i + 1), 0, 1 << item.mTech, item.mGroup, item.mDist);
+	}
+
+	queue.Sort();
+	return Time::GetSystemSeconds() - start;
+}
+
+//============================================================================================================
+// Measures adding and sorting the specified number of objects: 90% opaque ones using 64 different materials
+// and 10% transparent ones, added in random order, in already sorted order, and in sorted order with 1% of
+// the objects swapped with random others -- as happens when a few objects change their materials.
+//============================================================================================================
+
+bool RunQueue (uint count, uint frames)
+{
+	Random random (12345);
+	Array<QueueItem> items[3];
+	items[0].ExpandTo(count);
+
+	FOREACH(i, items[0])
+	{
+		QueueItem& item = items[0][i];
+		item.mTech	= (random.GenerateUint() % 10 == 0) ? 5 : 0;
+		item.mGroup	= (item.mTech == 0) ? 1 + random.GenerateUint() % 64 : 0;
+		item.mDist	= random.GenerateFloat() * 1000000.0f;
+	}
+
+	// Same order as the draw queue's keys: by technique, then by the inverted group, keeping the order of
+	// the objects within each group
+	for (uint tech = 0; tech < 6; tech += 5)
+	{
+		for (uint group = 65; group > 0; --group)
+		{
+			FOREACH(i, items[0])
+			{
+				const QueueItem& item = items[0][i];
+				if (item.mTech == tech && item.mGroup == group - 1) items[1].Expand() = item;
+			}
+		}
+	}
+	items[2] = items[1];
+
+	for (uint i = 0, imax = count / 100; i < imax; ++i)
+	{
+		Swap(items[2][random.GenerateUint() % count], items[2][random.GenerateUint() % count]);
+	}
+
+	const char* names[] = { "Random", "Presorted", "Nearly sorted" };
+	printf("\n  %-14s %10s %12s %14s\n", "Order", "Objects", "Best ms", "Objects/ms");
+
+	DrawQueue queue;
+
+	for (uint pass = 0; pass < 3; ++pass)
+	{
+		FillQueue(queue, items[pass]);
+		double best = 0.0;
+
+		for (uint f = 0; f < frames; ++f)
+		{
+			double duration = FillQueue(queue, items[pass]);
+			if (f == 0 || duration < best) best = duration;
+		}
+
+		double ms = best * 1000.0;
+		printf("  %-14s %10u %12.4f %14.1f\n", names[pass], count, ms, (ms > 0.0) ? count / ms : 0.0);
+	}
+	return true;
+}
+
+//============================================================================================================
+// Application entry point
+//============================================================================================================
+
+int main (int argc, char* argv[])
+{
+#ifdef _MACOS
+	String path ( System::GetPathFromFilename(argv[0]) );
+	System::SetCurrentPath(path.GetBuffer());
+	System::SetCurrentPath("../../../");
+#endif
+
+	String	file;
+	uint	frames	= 500;
+	uint	warmup	= 10;
+	bool	log		= false;
+	bool	profile	= false;
+	String	trace;
+	uint	threads	= 0;
+	uint	nodes	= 0;
+	bool	flat	= false;
+	uint	timers	= 0;
+	uint	terrain	= 0;
+	uint	emitters	= 0;
+	uint	particles	= 1000;
+	uint	billboards	= 0;
+	uint	queue	= 0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		String arg (argv[i]);
+
+		if		(arg == "-frames" && i + 1 < argc)	frames = atoi(argv[++i]);
+		else if (arg == "-warmup" && i + 1 < argc)	warmup = atoi(argv[++i]);
+		else if (arg == "-log")						log = true;
+		else if (arg == "-profile")					profile = true;
+		else if (arg == "-trace" && i + 1 < argc)	{ trace = argv[++i]; profile = true; }
+		else if (arg == "-threads" && i + 1 < argc)	threads = atoi(argv[++i]);
+		else if (arg == "-nodes" && i + 1 < argc)	nodes = atoi(argv[++i]);
+		else if (arg == "-flat")					flat = true;
+		else if (arg == "-timers" && i + 1 < argc)	timers = atoi(argv[++i]);
+		else if (arg == "-terrain" && i + 1 < argc)	terrain = atoi(argv[++i]);
+		else if (arg == "-emitters" && i + 1 < argc)	emitters = atoi(argv[++i]);
+		else if (arg == "-particles" && i + 1 < argc)	particles = atoi(argv[++i]);
+		else if (arg == "-billboards" && i + 1 < argc)	billboards = atoi(argv[++i]);
+		else if (arg == "-queue" && i + 1 < argc)	queue = atoi(argv[++i]);
+		else if (arg == "-path" && i + 1 < argc)	System::SetCurrentPath(argv[++i]);
+		else										file = arg;
+	}
+
+	if ((file.IsEmpty() && nodes == 0 && terrain == 0 && emitters == 0 && billboards == 0 && queue == 0) || frames == 0)
+	{
+		printf("Usage: FrameBench [-path <resources>] [-frames N] [-warmup N] [-threads N] [-timers N] [-flat] [-log] [-profile] [-trace <file>] <scene file>\n");
+		printf("       FrameBench [-frames N] [-warmup N] [-threads N] [-timers N] [-flat] [-profile] -nodes <count>\n");
+		printf("       FrameBench [-frames N] [-warmup N] [-threads N] -terrain <nodes per side>\n");
+		printf("       FrameBench [-frames N] [-warmup N] [-threads N] [-particles N] -emitters <count>\n");
+		printf("       FrameBench [-frames N] [-warmup N] [-threads N] -billboards <count>\n");
+		printf("       FrameBench [-frames N] -queue <count>\n");
+		printf("Example: FrameBench -path ../../Resources -frames 1000 Config/Dev4.txt\n");
+		return 0;
+	}
+
+	// The draw queue can be measured on its own
+	if (queue > 0) return RunQueue(queue, frames) ? 0 : 1;
+
+	// Draw calls can be recorded on multiple threads and replayed on the main thread
+	DrawQueue::SetRecordingThreads(threads);
+
+	FrameBench bench;
+	bench.SetFlatUpdate(flat, threads);
+	bench.AddTimers(timers);
+	if (terrain > 0) return bench.RunTerrain(terrain, frames, warmup) ? 0 : 1;
+	if (emitters > 0) return bench.RunEmitters(emitters, particles, frames, warmup) ? 0 : 1;
+	if (billboards > 0) return bench.RunBillboards(billboards, frames, warmup) ? 0 : 1;
+	return bench.Run(file, nodes, frames, warmup, log, profile, trace) ? 0 : 1;
+}
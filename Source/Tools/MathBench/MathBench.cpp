@@ -0,0 +1,469 @@
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// MathBench measures the math functions that get called the most every frame -- matrix multiplication and
+// inversion, vertex transforms, quaternion combination and interpolation, and bounding box transforms.
+// Each function is compared against the original scalar code kept below, reporting both the time taken
+// and the largest difference between the two results. Growing arrays is measured the same way, comparing
+// the heap, pool and arena allocators against the way arrays used to grow.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+#include "../../Engine/Math/Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Original scalar implementations used as reference
+//============================================================================================================
+
+namespace Reference
+{
+	void Multiply (Matrix43& m, const Matrix43& mat)
+	{
+		const float* f = mat.mF;
+		float* mF = m.mF;
+		float a, b, c;
+
+		for (uint i = 0; i < 16; i += 4)
+		{
+			a = f[0] * mF[i] + f[4] * mF[i+1] + f[8]  * mF[i+2];
+			b = f[1] * mF[i] + f[5] * mF[i+1] + f[9]  * mF[i+2];
+			c = f[2] * mF[i] + f[6] * mF[i+1] + f[10] * mF[i+2];
+
+			if (i == 12)
+			{
+				a += f[12];
+				b += f[13];
+				c += f[14];
+			}
+
+			mF[i]	= a;
+			mF[i+1] = b;
+			mF[i+2] = c;
+		}
+	}
+
+	//--------------------------------------------------------------------------------------------------------
+
+	float GetDeterminant (const float mat[16])
+	{
+		return	mat[12] * mat[9]  * mat[6]  * mat[3] -	mat[8]  * mat[13] * mat[6]  * mat[3] -
+				mat[12] * mat[5]  * mat[10] * mat[3] +	mat[4]  * mat[13] * mat[10] * mat[3] +
+				mat[8]  * mat[5]  * mat[14] * mat[3] -	mat[4]  * mat[9]  * mat[14] * mat[3] -
+				mat[12] * mat[9]  * mat[2]  * mat[7] +	mat[8]  * mat[13] * mat[2]  * mat[7] +
+				mat[12] * mat[1]  * mat[10] * mat[7] -	mat[0]  * mat[13] * mat[10] * mat[7] -
+				mat[8]  * mat[1]  * mat[14] * mat[7] +	mat[0]  * mat[9]  * mat[14] * mat[7] +
+				mat[12] * mat[5]  * mat[2]  * mat[11] -	mat[4]  * mat[13] * mat[2]  * mat[11] -
+				mat[12] * mat[1]  * mat[6]  * mat[11] +	mat[0]  * mat[13] * mat[6]  * mat[11] +
+				mat[4]  * mat[1]  * mat[14] * mat[11] -	mat[0]  * mat[5]  * mat[14] * mat[11] -
+				mat[8]  * mat[5]  * mat[2]  * mat[15] +	mat[4]  * mat[9]  * mat[2]  * mat[15] +
+				mat[8]  * mat[1]  * mat[6]  * mat[15] -	mat[0]  * mat[9]  * mat[6]  * mat[15] -
+				mat[4]  * mat[1]  * mat[10] * mat[15] +	mat[0]  * mat[5]  * mat[10] * mat[15];
+	}
+
+	//--------------------------------------------------------------------------------------------------------
+
+	void Invert (Matrix44& m)
+	{
+		float* mF = m.mF;
+		float fDet = GetDeterminant(mF), out[16];
+		if (fDet == 0.0f) return;
+		fDet = 1.0f / fDet;
+
+		out[0]  = (-mF[13] * mF[10] * mF[7 ] + mF[9 ] * mF[14] * mF[7 ] + mF[13] * mF[6 ] * mF[11] - mF[5 ] * mF[14] * mF[11] - mF[9 ] * mF[6 ] * mF[15] + mF[5 ] * mF[10] * mF[15]) * fDet;
+		out[1]  = ( mF[13] * mF[10] * mF[3 ] - mF[9 ] * mF[14] * mF[3 ] - mF[13] * mF[2 ] * mF[11] + mF[1 ] * mF[14] * mF[11] + mF[9 ] * mF[2 ] * mF[15] - mF[1 ] * mF[10] * mF[15]) * fDet;
+		out[2]  = (-mF[13] * mF[6 ] * mF[3 ] + mF[5 ] * mF[14] * mF[3 ] + mF[13] * mF[2 ] * mF[7 ] - mF[1 ] * mF[14] * mF[7 ] - mF[5 ] * mF[2 ] * mF[15] + mF[1 ] * mF[6 ] * mF[15]) * fDet;
+		out[3]  = ( mF[9 ] * mF[6 ] * mF[3 ] - mF[5 ] * mF[10] * mF[3 ] - mF[9 ] * mF[2 ] * mF[7 ] + mF[1 ] * mF[10] * mF[7 ] + mF[5 ] * mF[2 ] * mF[11] - mF[1 ] * mF[6 ] * mF[11]) * fDet;
+		out[4]  = ( mF[12] * mF[10] * mF[7 ] - mF[8 ] * mF[14] * mF[7 ] - mF[12] * mF[6 ] * mF[11] + mF[4 ] * mF[14] * mF[11] + mF[8 ] * mF[6 ] * mF[15] - mF[4 ] * mF[10] * mF[15]) * fDet;
+		out[5]  = (-mF[12] * mF[10] * mF[3 ] + mF[8 ] * mF[14] * mF[3 ] + mF[12] * mF[2 ] * mF[11] - mF[0 ] * mF[14] * mF[11] - mF[8 ] * mF[2 ] * mF[15] + mF[0 ] * mF[10] * mF[15]) * fDet;
+		out[6]  = ( mF[12] * mF[6 ] * mF[3 ] - mF[4 ] * mF[14] * mF[3 ] - mF[12] * mF[2 ] * mF[7 ] + mF[0 ] * mF[14] * mF[7 ] + mF[4 ] * mF[2 ] * mF[15] - mF[0 ] * mF[6 ] * mF[15]) * fDet;
+		out[7]  = (-mF[8 ] * mF[6 ] * mF[3 ] + mF[4 ] * mF[10] * mF[3 ] + mF[8 ] * mF[2 ] * mF[7 ] - mF[0 ] * mF[10] * mF[7 ] - mF[4 ] * mF[2 ] * mF[11] + mF[0 ] * mF[6 ] * mF[11]) * fDet;
+		out[8]  = (-mF[12] * mF[9 ] * mF[7 ] + mF[8 ] * mF[13] * mF[7 ] + mF[12] * mF[5 ] * mF[11] - mF[4 ] * mF[13] * mF[11] - mF[8 ] * mF[5 ] * mF[15] + mF[4 ] * mF[9 ] * mF[15]) * fDet;
+		out[9]  = ( mF[12] * mF[9 ] * mF[3 ] - mF[8 ] * mF[13] * mF[3 ] - mF[12] * mF[1 ] * mF[11] + mF[0 ] * mF[13] * mF[11] + mF[8 ] * mF[1 ] * mF[15] - mF[0 ] * mF[9 ] * mF[15]) * fDet;
+		out[10] = (-mF[12] * mF[5 ] * mF[3 ] + mF[4 ] * mF[13] * mF[3 ] + mF[12] * mF[1 ] * mF[7 ] - mF[0 ] * mF[13] * mF[7 ] - mF[4 ] * mF[1 ] * mF[15] + mF[0 ] * mF[5 ] * mF[15]) * fDet;
+		out[11] = ( mF[8 ] * mF[5 ] * mF[3 ] - mF[4 ] * mF[9 ] * mF[3 ] - mF[8 ] * mF[1 ] * mF[7 ] + mF[0 ] * mF[9 ] * mF[7 ] + mF[4 ] * mF[1 ] * mF[11] - mF[0 ] * mF[5 ] * mF[11]) * fDet;
+		out[12] = ( mF[12] * mF[9 ] * mF[6 ] - mF[8 ] * mF[13] * mF[6 ] - mF[12] * mF[5 ] * mF[10] + mF[4 ] * mF[13] * mF[10] + mF[8 ] * mF[5 ] * mF[14] - mF[4 ] * mF[9 ] * mF[14]) * fDet;
+		out[13] = (-mF[12] * mF[9 ] * mF[2 ] + mF[8 ] * mF[13] * mF[2 ] + mF[12] * mF[1 ] * mF[10] - mF[0 ] * mF[13] * mF[10] - mF[8 ] * mF[1 ] * mF[14] + mF[0 ] * mF[9 ] * mF[14]) * fDet;
+		out[14] = ( mF[12] * mF[5 ] * mF[2 ] - mF[4 ] * mF[13] * mF[2 ] - mF[12] * mF[1 ] * mF[6 ] + mF[0 ] * mF[13] * mF[6 ] + mF[4 ] * mF[1 ] * mF[14] - mF[0 ] * mF[5 ] * mF[14]) * fDet;
+		out[15] = (-mF[8 ] * mF[5 ] * mF[2 ] + mF[4 ] * mF[9 ] * mF[2 ] + mF[8 ] * mF[1 ] * mF[6 ] - mF[0 ] * mF[9 ] * mF[6 ] - mF[4 ] * mF[1 ] * mF[10] + mF[0 ] * mF[5 ] * mF[10]) * fDet;
+
+		memcpy(mF, out, 64);
+	}
+
+	//--------------------------------------------------------------------------------------------------------
+	// Transforms all 8 corners of the box, including each one into the new bounds
+	//--------------------------------------------------------------------------------------------------------
+
+	void Transform (Bounds& b, const Vector3f& pos, const Quaternion& rot, const Vector3f& scale)
+	{
+		Vector3f min (b.GetMin()), max (b.GetMax());
+		Vector3f dir0 ((max - min) * 0.5f);
+		Vector3f dir1 ( dir0.x, dir0.y, -dir0.z);
+		Vector3f dir2 (-dir0.x, dir0.y,  dir0.z);
+		Vector3f dir3 (-dir0.x, dir0.y, -dir0.z);
+
+		dir0 *= rot;	dir1 *= rot;	dir2 *= rot;	dir3 *= rot;
+		dir0 *= scale;	dir1 *= scale;	dir2 *= scale;	dir3 *= scale;
+
+		Vector3f center ((max + min) * 0.5f);
+		center *= rot;
+		center *= scale;
+		center += pos;
+
+		b.Clear();
+		b.Include(center + dir0);
+		b.Include(center + dir1);
+		b.Include(center + dir2);
+		b.Include(center + dir3);
+		b.Include(center - dir0);
+		b.Include(center - dir1);
+		b.Include(center - dir2);
+		b.Include(center - dir3);
+	}
+
+	//--------------------------------------------------------------------------------------------------------
+	// Array growth the way BaseArray used to do it: the new buffer is allocated with new[], constructing
+	// every entry, then the old entries are copied over and the old buffer gets cleared before it's deleted.
+	//--------------------------------------------------------------------------------------------------------
+
+	template <typename Type>
+	class OldArray
+	{
+		Type*	mArray;
+		uint	mSize;
+		uint	mAllocated;
+
+	public:
+
+		OldArray() : mArray(0), mSize(0), mAllocated(0) {}
+		~OldArray() { if (mArray != 0) delete [] mArray; }
+
+		const Type* GetBuffer() const { return mArray; }
+
+		Type& Expand()
+		{
+			if (mSize == mAllocated) Reserve(mSize + 8);
+			return mArray[mSize++];
+		}
+
+		void Reserve (uint count)
+		{
+			if (count > mAllocated)
+			{
+				mAllocated = ((mAllocated << 1) > count) ? (mAllocated << 1) : count;
+				if (mAllocated < 8) mAllocated = 8;
+
+				if (mArray == 0)
+				{
+					mArray = new Type[mAllocated];
+				}
+				else
+				{
+					Type* newArray = new Type[mAllocated];
+					uint current = mSize * sizeof(Type);
+					memcpy(newArray, mArray, current);
+					memset(mArray, 0, current);
+					delete [] mArray;
+					mArray = newArray;
+				}
+			}
+		}
+	};
+};
+
+//============================================================================================================
+// Benchmark data
+//============================================================================================================
+
+Random				g_random (12345);
+Array<Matrix43>		g_mat43;
+Array<Matrix44>		g_mat44;
+Array<Vector3f>		g_vertices;
+Array<Quaternion>	g_quat0;
+Array<Quaternion>	g_quat1;
+Array<Bounds>		g_bounds;
+Array<Vector3f>		g_scale;
+
+//============================================================================================================
+
+inline Vector3f RandomVector (float range) { return Vector3f(g_random.GenerateRangeFloat() * range,
+	g_random.GenerateRangeFloat() * range, g_random.GenerateRangeFloat() * range); }
+
+//============================================================================================================
+
+inline Quaternion RandomQuaternion()
+{
+	Quaternion q (g_random.GenerateRangeFloat(), g_random.GenerateRangeFloat(),
+		g_random.GenerateRangeFloat(), g_random.GenerateRangeFloat());
+	q.Normalize();
+	return q;
+}
+
+//============================================================================================================
+// Largest difference between two arrays of floats
+//============================================================================================================
+
+float GetError (const float* a, const float* b, uint count)
+{
+	float error = 0.0f;
+
+	for (uint i = 0; i < count; ++i)
+	{
+		float diff = Float::Abs(a[i] - b[i]);
+		if (diff > error) error = diff;
+	}
+	return error;
+}
+
+//============================================================================================================
+// Prints a single line of the report
+//============================================================================================================
+
+void Report (const char* name, double reference, double current, float error)
+{
+	printf("  %-30s %9.3f ms %9.3f ms %7.2fx   %g\n", name, reference * 1000.0,
+		current * 1000.0, (current > 0.0) ? reference / current : 0.0, error);
+}
+
+//============================================================================================================
+// Fills the specified number of small arrays with 16 vertices each, the way most of the engine's arrays are
+// used. Arrays are constructed with the specified allocator, or use the heap if there is none.
+//============================================================================================================
+
+void FillSmallArrays (uint count, Allocator* allocator)
+{
+	Array<Vector3f>* arrays = (Array<Vector3f>*)::operator new(count * sizeof(Array<Vector3f>));
+
+	for (uint i = 0; i < count; ++i)
+	{
+		if (allocator != 0) new (arrays + i) Array<Vector3f>(*allocator);
+		else new (arrays + i) Array<Vector3f>();
+
+		for (uint b = 0; b < 16; ++b) arrays[i].Expand() = g_vertices[(i * 16 + b) % g_vertices.GetSize()];
+	}
+
+	for (uint i = 0; i < count; ++i) arrays[i].~Array<Vector3f>();
+	::operator delete(arrays);
+}
+
+//============================================================================================================
+// Same as above, using the original array growth
+//============================================================================================================
+
+void FillSmallOldArrays (uint count)
+{
+	Reference::OldArray<Vector3f>* arrays = new Reference::OldArray<Vector3f>[count];
+
+	for (uint i = 0; i < count; ++i)
+		for (uint b = 0; b < 16; ++b) arrays[i].Expand() = g_vertices[(i * 16 + b) % g_vertices.GetSize()];
+
+	delete [] arrays;
+}
+
+//============================================================================================================
+// Each test runs the same amount of work multiple times, keeping the fastest run
+//============================================================================================================
+
+#define BENCH(result, repeat, code)						\
+{														\
+	result = 0.0;										\
+	for (uint r = 0; r < repeat; ++r)					\
+	{													\
+		double start = Time::GetSystemSeconds();		\
+		code;											\
+		double time = Time::GetSystemSeconds() - start;	\
+		if (r == 0 || time < result) result = time;		\
+	}													\
+}
+
+//============================================================================================================
+// Application entry point
+//============================================================================================================
+
+int main (int argc, char* argv[])
+{
+	uint count	= (argc > 1) ? atoi(argv[1]) : 100000;
+	uint repeat	= (argc > 2) ? atoi(argv[2]) : 10;
+
+	if (count < 4 || repeat == 0)
+	{
+		printf("Usage: MathBench [elements] [repeat]\n");
+		return 0;
+	}
+
+	g_mat43.ExpandTo(count);
+	g_mat44.ExpandTo(count);
+	g_vertices.ExpandTo(count);
+	g_quat0.ExpandTo(count);
+	g_quat1.ExpandTo(count);
+	g_bounds.ExpandTo(count);
+	g_scale.ExpandTo(count);
+
+	for (uint i = 0; i < count; ++i)
+	{
+		g_mat43[i].SetToTransform(RandomVector(100.0f), RandomQuaternion(), RandomVector(1.0f) + 1.5f);
+		g_mat44[i].SetToProjection(60.0f + g_random.GenerateFloat() * 30.0f, 1.333f, 0.1f, 100.0f + i % 100);
+		g_mat44[i] *= g_mat43[i];
+		g_vertices[i] = RandomVector(10.0f);
+		g_quat0[i] = RandomQuaternion();
+		g_quat1[i] = RandomQuaternion();
+		g_scale[i] = RandomVector(1.0f) + 1.5f;
+
+		Vector3f center (RandomVector(100.0f));
+		g_bounds[i].Set(center - g_scale[i], center + g_scale[i] * 2.0f);
+	}
+
+	// Every 4th pair is nearly identical, exercising the linear interpolation path of Slerp
+	for (uint i = 0; i < count; i += 4) g_quat1[i] = g_quat0[i];
+
+	Matrix43 mat (g_mat43[0]);
+	Quaternion rot (g_quat0[0]);
+
+#ifdef R5_SSE
+	printf("SIMD: SSE\n");
+#elif defined(R5_NEON)
+	printf("SIMD: NEON\n");
+#else
+	printf("SIMD: none\n");
+#endif
+	printf("%u elements, best of %u runs\n\n", count, repeat);
+	printf("  %-30s %12s %12s %8s   %s\n", "Function", "Reference", "Current", "Speedup", "Max error");
+
+	double reference, current;
+
+	// Matrix43 *= Matrix43
+	{
+		Array<Matrix43> a, b;
+		BENCH(reference, repeat, a = g_mat43; for (uint i = 0; i < count; ++i) Reference::Multiply(a[i], mat));
+		BENCH(current,   repeat, b = g_mat43; for (uint i = 0; i < count; ++i) b[i] *= mat);
+		Report("Matrix43 *= Matrix43", reference, current, GetError(a[0].mF, b[0].mF, count * 16));
+
+		BENCH(current, repeat, b = g_mat43; Batch::Multiply(b.GetBuffer(), mat, b.GetBuffer(), count));
+		Report("Batch::Multiply", reference, current, GetError(a[0].mF, b[0].mF, count * 16));
+
+		// Pairs of matrices, as done with the bone matrices
+		Array<Matrix43> pairs;
+		pairs.ExpandTo(count);
+		for (uint i = 0; i < count; ++i) pairs[i] = g_mat43[count - 1 - i];
+
+		BENCH(reference, repeat, a = g_mat43; for (uint i = 0; i < count; ++i) Reference::Multiply(a[i], pairs[i]));
+		BENCH(current,   repeat, b = g_mat43; Batch::Multiply(b.GetBuffer(), pairs.GetBuffer(), b.GetBuffer(), count));
+		Report("Batch::Multiply (pairs)", reference, current, GetError(a[0].mF, b[0].mF, count * 16));
+	}
+
+	// Matrix44::Invert
+	{
+		Array<Matrix44> a, b;
+		BENCH(reference, repeat, a = g_mat44; for (uint i = 0; i < count; ++i) Reference::Invert(a[i]));
+		BENCH(current,   repeat, b = g_mat44; for (uint i = 0; i < count; ++i) b[i].Invert());
+
+		// The inversion is done differently, so the error is relative to the size of the values
+		float error = 0.0f;
+
+		for (uint i = 0; i < count * 16; ++i)
+		{
+			float diff = Float::Abs(a[0].mF[i] - b[0].mF[i]) / Max(1.0f, Float::Abs(a[0].mF[i]));
+			if (diff > error) error = diff;
+		}
+		Report("Matrix44::Invert", reference, current, error);
+	}
+
+	// Vector3f * Matrix43
+	{
+		Array<Vector3f> a, b;
+		a.ExpandTo(count);
+		b.ExpandTo(count);
+		BENCH(reference, repeat, for (uint i = 0; i < count; ++i) a[i] = g_vertices[i] * mat);
+		BENCH(current,   repeat, Batch::Transform(mat, g_vertices.GetBuffer(), b.GetBuffer(), count));
+		Report("Batch::Transform", reference, current, GetError(&a[0].x, &b[0].x, count * 3));
+
+		BENCH(reference, repeat, for (uint i = 0; i < count; ++i) a[i] = g_vertices[i] % mat);
+		BENCH(current,   repeat, Batch::Rotate(mat, g_vertices.GetBuffer(), b.GetBuffer(), count));
+		Report("Batch::Rotate", reference, current, GetError(&a[0].x, &b[0].x, count * 3));
+
+		// Same vertices stored as separate aligned components
+		Batch::Vector3fSoA in, out;
+		in.Resize(count);
+		out.Resize(count);
+		for (uint i = 0; i < count; ++i) in.Set(i, g_vertices[i]);
+
+		BENCH(reference, repeat, for (uint i = 0; i < count; ++i) a[i] = g_vertices[i] * mat);
+		BENCH(current,   repeat, Batch::Transform(mat, in, out, 0, count));
+		for (uint i = 0; i < count; ++i) b[i] = out.Get(i);
+		Report("Batch::Transform (SoA)", reference, current, GetError(&a[0].x, &b[0].x, count * 3));
+	}
+
+	// Quaternion::Combine
+	{
+		Array<Quaternion> a, b;
+		a.ExpandTo(count);
+		b.ExpandTo(count);
+		BENCH(reference, repeat, for (uint i = 0; i < count; ++i) a[i].Combine(g_quat0[i], g_quat1[i]));
+		BENCH(current,   repeat, Batch::Combine(g_quat0.GetBuffer(), g_quat1.GetBuffer(), b.GetBuffer(), count));
+		Report("Batch::Combine", reference, current, GetError(&a[0].x, &b[0].x, count * 4));
+	}
+
+	// Interpolation::Slerp
+	{
+		Array<Quaternion> a, b;
+		a.ExpandTo(count);
+		b.ExpandTo(count);
+		BENCH(reference, repeat, for (uint i = 0; i < count; ++i) a[i] = Interpolation::Slerp(g_quat0[i], g_quat1[i], 0.3f));
+		BENCH(current,   repeat, Batch::Slerp(g_quat0.GetBuffer(), g_quat1.GetBuffer(), 0.3f, b.GetBuffer(), count));
+		Report("Batch::Slerp", reference, current, GetError(&a[0].x, &b[0].x, count * 4));
+	}
+
+	// Bounds::Transform
+	{
+		Array<Bounds> a, b;
+		Array<Vector3f> va, vb;
+		BENCH(reference, repeat, a = g_bounds; for (uint i = 0; i < count; ++i) Reference::Transform(a[i], g_vertices[i], g_quat0[i], g_scale[i]));
+		BENCH(current,   repeat, b = g_bounds; for (uint i = 0; i < count; ++i) b[i].Transform(g_vertices[i], g_quat0[i], g_scale[i]));
+
+		for (uint i = 0; i < count; ++i)
+		{
+			va.Expand() = a[i].GetMin();
+			va.Expand() = a[i].GetMax();
+			vb.Expand() = b[i].GetMin();
+			vb.Expand() = b[i].GetMax();
+		}
+		Report("Bounds::Transform", reference, current, GetError(&va[0].x, &vb[0].x, va.GetSize() * 3));
+	}
+
+	// Growing a single large array one entry at a time, then with the space reserved up front
+	{
+		float error = 0.0f;
+
+		BENCH(reference, repeat, Reference::OldArray<Vector3f> a; for (uint i = 0; i < count; ++i) a.Expand() = g_vertices[i]);
+		BENCH(current,   repeat, Array<Vector3f> b; for (uint i = 0; i < count; ++i) b.Expand() = g_vertices[i]);
+		Report("Array<Vector3f>::Expand", reference, current, error);
+
+		BENCH(reference, repeat, Reference::OldArray<Vector3f> a; a.Reserve(count); for (uint i = 0; i < count; ++i) a.Expand() = g_vertices[i]);
+		BENCH(current,   repeat, Array<Vector3f> b; b.Reserve(count); for (uint i = 0; i < count; ++i) b.Expand() = g_vertices[i]);
+		Report("Array<Vector3f>::Reserve", reference, current, error);
+
+		// Strings have constructors and destructors, so unused capacity used to be expensive
+		BENCH(reference, repeat, Reference::OldArray<String> a; for (uint i = 0; i < count; ++i) a.Expand() = "Test");
+		BENCH(current,   repeat, Array<String> b; for (uint i = 0; i < count; ++i) b.Expand() = "Test");
+		Report("Array<String>::Expand", reference, current, error);
+	}
+
+	// Lots of small arrays, each allocated using the heap, a pool and an arena
+	{
+		uint arrays = count / 16;
+		Pool pool (sizeof(Vector3f) * 16, 256);
+		Arena arena;
+
+		BENCH(reference, repeat, FillSmallOldArrays(arrays));
+		BENCH(current,   repeat, FillSmallArrays(arrays, 0));
+		Report("Small arrays (heap)", reference, current, 0.0f);
+
+		BENCH(current, repeat, FillSmallArrays(arrays, &pool));
+		Report("Small arrays (pool)", reference, current, 0.0f);
+
+		BENCH(current, repeat, FillSmallArrays(arrays, &arena); arena.Reset());
+		Report("Small arrays (arena)", reference, current, 0.0f);
+	}
+	return 0;
+}
@@ -0,0 +1,264 @@
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// ShaderBench measures the shader preprocessor without a videocard. Every surface shader found in the
+// specified folder gets preprocessed into all the variations the draw techniques may request, first using
+// the preprocessor alone, then through the shader cache: while filling it, with all variations in memory,
+// and after the cache has been saved and reloaded from its file as it would be on the next launch.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+#include "../../Engine/OpenGL/Include/_All.h"
+#include "../../Engine/OpenGL/Include/_OpenGL.h"
+using namespace R5;
+
+extern Flags GLPreprocessShader (const String& surface, String& code, const Flags& desired);
+extern void GLInitShaderPreprocessor();
+
+//============================================================================================================
+// Single variation of a shader
+//============================================================================================================
+
+struct Variation
+{
+	const CodeNode*	mCode;		// Shader's code
+	Flags			mFlags;		// Desired flags
+	Flags			mFinal;		// Flags of the preprocessed code
+	String			mOut;		// Preprocessed code
+};
+
+Array<CodeNode>		g_code;
+Array<Variation>	g_variations;
+bool				g_useCache = false;
+
+//============================================================================================================
+// Preprocesses a single variation the same way GLSurfaceShader does
+//============================================================================================================
+
+void Preprocess (Variation& var)
+{
+	const Flags& flags = var.mFlags;
+	Array<String> defines;
+
+	if (flags.Get(IShader::Flag::Vertex))		defines.Expand() = "Vertex";
+	if (flags.Get(IShader::Flag::Fragment))		defines.Expand() = "Fragment";
+	if (flags.Get(IShader::Flag::Shadowed))		defines.Expand() = "Shadowed";
+	if (flags.Get(IShader::Flag::Fog))			defines.Expand() = "Fog";
+	if (flags.Get(IShader::Flag::Deferred))		defines.Expand() = "Deferred";
+	if (flags.Get(IShader::Flag::DirLight))		defines.Expand() = "DirLight";
+	if (flags.Get(IShader::Flag::PointLight))	defines.Expand() = "PointLight";
+	if (flags.Get(IShader::Flag::DepthOnly))	defines.Expand() = "DepthOnly";
+
+	String full;
+	var.mOut.Clear();
+	var.mCode->SerializeTo(var.mOut, defines);
+	var.mCode->SerializeTo(full);
+
+	if (g_useCache)
+	{
+		GLShaderCache::Key key = GLShaderCache::GetKey(full, var.mOut, flags);
+
+		if (!GLShaderCache::Get(key, var.mOut, var.mFinal))
+		{
+			var.mFinal = GLPreprocessShader(full, var.mOut, flags);
+			GLShaderCache::Set(key, var.mOut, var.mFinal);
+		}
+	}
+	else
+	{
+		var.mFinal = GLPreprocessShader(full, var.mOut, flags);
+	}
+}
+
+//============================================================================================================
+// Preprocesses all variations, returning the time it took in milliseconds
+//============================================================================================================
+
+struct PreprocessJob
+{
+	void Run (uint index) { Preprocess(g_variations[index]); }
+};
+
+double Run (uint threads)
+{
+	PreprocessJob job;
+	double start = Time::GetSystemSeconds();
+
+	if (threads > 1) Thread::ParallelFor(g_variations.GetSize(), bind(&PreprocessJob::Run, &job), threads - 1);
+	else FOREACH(i, g_variations) job.Run(i);
+
+	return (Time::GetSystemSeconds() - start) * 1000.0;
+}
+
+//============================================================================================================
+// Returns the average time of 'repeat' runs
+//============================================================================================================
+
+double Run (uint threads, uint repeat)
+{
+	double total = 0.0;
+	for (uint i = 0; i < repeat; ++i) total += Run(threads);
+	return total / repeat;
+}
+
+//============================================================================================================
+// Counts the variations whose preprocessed code doesn't match the reference
+//============================================================================================================
+
+uint CountMismatches (const Array<String>& reference)
+{
+	uint count = 0;
+	FOREACH(i, g_variations) if (g_variations[i].mOut != reference[i]) ++count;
+	return count;
+}
+
+//============================================================================================================
+// Prints a single result line
+//============================================================================================================
+
+void Report (const char* name, double ms, uint mismatches, uint misses)
+{
+	printf("  %-24s %10.3f ms %10.2f us %12u %8u\n", name, ms, ms * 1000.0 / g_variations.GetSize(),
+		mismatches, misses);
+}
+
+//============================================================================================================
+// Application entry point
+//============================================================================================================
+
+int main (int argc, char* argv[])
+{
+#ifdef _MACOS
+	String path ( System::GetPathFromFilename(argv[0]) );
+	System::SetCurrentPath(path.GetBuffer());
+	System::SetCurrentPath("../../../");
+#endif
+
+	String	folder	("Shaders/");
+	String	cache	("ShaderBench.bin");
+	uint	threads	= 4;
+	uint	repeat	= 5;
+	uint	version	= 330;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		String arg (argv[i]);
+
+		if		(arg == "-threads" && i + 1 < argc)	threads = atoi(argv[++i]);
+		else if (arg == "-repeat" && i + 1 < argc)	repeat = atoi(argv[++i]);
+		else if (arg == "-version" && i + 1 < argc)	version = atoi(argv[++i]);
+		else if (arg == "-cache" && i + 1 < argc)	cache = argv[++i];
+		else if (arg == "-path" && i + 1 < argc)	System::SetCurrentPath(argv[++i]);
+		else if (arg.BeginsWith("-"))				{ repeat = 0; break; }
+		else										folder = arg;
+	}
+
+	if (repeat == 0 || cache.IsEmpty())
+	{
+		printf("Usage: ShaderBench [-threads N] [-repeat N] [-version N] [-cache <file>] [-path <resources>] [shader folder]\n");
+		printf("Example: ShaderBench -path ../../Resources Shaders/\n");
+		return 0;
+	}
+
+	// Surface shaders are preprocessed into all variations the forward and deferred techniques may request
+	Array<String> files;
+	System::FindFiles(folder, "*", ".shader", files, true);
+	g_code.ExpandTo(files.GetSize());
+
+	const uint desired[] =
+	{
+		IShader::Flag::Deferred,
+		IShader::Flag::DepthOnly,
+		0,
+		IShader::Flag::DirLight,
+		IShader::Flag::DirLight | IShader::Flag::Shadowed,
+		IShader::Flag::PointLight,
+	};
+
+	FOREACH(i, files)
+	{
+		String code;
+		code.Load(files[i]);
+		g_code[i].SerializeFrom(code);
+
+		for (uint b = 0; b < 10; ++b)
+		{
+			// The last 4 are the forward rendering ones with fog
+			uint flags = (b < 6) ? desired[b] : (desired[b - 4] | IShader::Flag::Fog);
+			flags |= IShader::Flag::Surface;
+
+			Variation& vertex = g_variations.Expand();
+			vertex.mCode	= &g_code[i];
+			vertex.mFlags	= flags | IShader::Flag::Vertex;
+
+			Variation& fragment = g_variations.Expand();
+			fragment.mCode	= &g_code[i];
+			fragment.mFlags	= flags | IShader::Flag::Fragment;
+		}
+	}
+
+	if (g_variations.IsEmpty())
+	{
+		printf("ERROR: No shaders found in '%s'\n", folder.GetBuffer());
+		return 1;
+	}
+
+	g_caps.mVersion = version;
+	GLInitShaderPreprocessor();
+	printf("%u variations of %u shaders, GL version %u\n\n", g_variations.GetSize(), files.GetSize(), version);
+	printf("  %-24s %13s %13s %12s %8s\n", "Mode", "Time", "Variation", "Mismatches", "Misses");
+
+	// The first run produces the reference code
+	Run(1);
+	Array<String> reference;
+	FOREACH(i, g_variations) reference.Expand() = g_variations[i].mOut;
+
+	Report("Preprocessor", Run(1, repeat), CountMismatches(reference), 0);
+
+	if (threads > 1)
+	{
+		String name ("Preprocessor, %u threads", threads);
+		Report(name.GetBuffer(), Run(threads, repeat), CountMismatches(reference), 0);
+	}
+
+	// The cache starts out empty, and fills up during the first run
+	remove(cache.GetBuffer());
+	GLShaderCache::SetFilename(cache);
+	g_useCache = true;
+
+	uint misses = GLShaderCache::GetMisses();
+	double ms = Run(1);
+	Report("Cold cache", ms, CountMismatches(reference), GLShaderCache::GetMisses() - misses);
+
+	misses = GLShaderCache::GetMisses();
+	ms = Run(1, repeat);
+	Report("Warm cache", ms, CountMismatches(reference), GLShaderCache::GetMisses() - misses);
+
+	// Save the cache and forget everything about it, as if the application was launched again
+	if (!GLShaderCache::Save())
+	{
+		printf("ERROR: Unable to save '%s'\n", cache.GetBuffer());
+		return 1;
+	}
+
+	GLShaderCache::Clear();
+	GLShaderCache::SetFilename("");
+	GLShaderCache::SetFilename(cache);
+
+	misses = GLShaderCache::GetMisses();
+	ms = Run(1);
+	Report("Reloaded cache", ms, CountMismatches(reference), GLShaderCache::GetMisses() - misses);
+
+	// Different OpenGL versions preprocess differently, so none of the entries should be reused
+	g_caps.mVersion = (version == 330) ? 210 : 330;
+	misses = GLShaderCache::GetMisses();
+	ms = Run(1);
+	String name ("Other GL version (%u)", g_caps.mVersion);
+	Report(name.GetBuffer(), ms, 0, GLShaderCache::GetMisses() - misses);
+
+	Memory mem;
+	if (mem.Load(cache.GetBuffer())) printf("\nCache file: %u bytes\n", mem.GetSize());
+	remove(cache.GetBuffer());
+	return 0;
+}
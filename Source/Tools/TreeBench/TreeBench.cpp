@@ -0,0 +1,431 @@
+//============================================================================================================
+//			R5 Game Engine, individual file copyright belongs to their respective authors.
+//									http://r5ge.googlecode.com/
+//============================================================================================================
+// TreeBench measures loading of the text (R5A) format. TreeParser is compared against the original parser
+// kept below, which copied the file into a string and extracted each phrase and bracketed segment from it.
+// Both the time taken and the number of heap allocations are reported, and the trees produced by the two
+// parsers are saved back to text to make sure they match. By default a file resembling exported models is
+// generated -- mesh arrays along with lots of small nodes -- but any R5A file can be passed instead.
+// Author: Michael Lyashenko
+//============================================================================================================
+
+#include "../../Engine/Serialization/Include/_All.h"
+using namespace R5;
+
+//============================================================================================================
+// Every heap allocation goes through the global operators, so counting them there covers strings, arrays
+// and variables alike
+//============================================================================================================
+
+uint g_allocations	= 0;
+uint g_bytes		= 0;
+
+void* operator new		(size_t size)	{ ++g_allocations; g_bytes += (uint)size; return malloc(size); }
+void* operator new[]	(size_t size)	{ ++g_allocations; g_bytes += (uint)size; return malloc(size); }
+void  operator delete	(void* ptr)		{ free(ptr); }
+void  operator delete[]	(void* ptr)		{ free(ptr); }
+
+//============================================================================================================
+// Original text parser used as reference
+//============================================================================================================
+
+namespace Reference
+{
+	bool SkipComment (const String& s, uint& from, uint to)
+	{
+		if ((from + 1 < to) && (s[from] == '/') && (s[from+1] == '/'))
+		{
+			char ch;
+
+			for (from += 2; from < to; ++from)
+			{
+				ch = s[from];
+				if (ch == '\n' || ch == '\r') break;
+			}
+			return true;
+		}
+		return false;
+	}
+
+	//--------------------------------------------------------------------------------------------------------
+
+	bool GetPhrase (const String& s, uint& from, uint to, String& out)
+	{
+		if (from < to)
+		{
+			while (from < to && (s[from] < 33 || SkipComment(s, from, to))) ++from;
+
+			char ch = s[from];
+
+			if ( (from != to) && (ch <= '~') && (ch != '{') && (ch != '}') && (ch != '=') )
+			{
+				uint phraseEnd = from;
+				uint lastChar = from;
+				bool inQuotes = false;
+
+				while (phraseEnd < to)
+				{
+					ch = s[phraseEnd];
+
+					if (ch == ' ' || ch == '\t')
+					{
+						++phraseEnd;
+					}
+					else
+					{
+						if (ch == '"') inQuotes = !inQuotes;
+
+						if (!inQuotes)
+						{
+							if (SkipComment(s, phraseEnd, to)) break;
+							if (ch < ' ' || ch == '=' || ch > '~' || ch == '{' || ch == '}') break;
+						}
+
+						lastChar = phraseEnd;
+						++phraseEnd;
+					}
+				}
+
+				if ( s.GetString(out, from, lastChar + 1) )
+				{
+					from = phraseEnd;
+					while (from < to && s[from] < 33) ++from;
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	//--------------------------------------------------------------------------------------------------------
+
+	bool GetSegment (const String& s, uint& from, uint to, String& out)
+	{
+		if (from < to)
+		{
+			while (from < to && s[from] < 33) ++from;
+
+			out.Clear();
+			int brackets = 0;
+			bool inQuotes = false;
+
+			for (uint i = from; i < to; )
+			{
+				char ch = s[i];
+
+				if (ch == '"')
+				{
+					inQuotes = !inQuotes;
+				}
+				else if (inQuotes)
+				{
+					out.Expand() = ch;
+				}
+				else if (ch == '/' && (i + 1 < to) && s[i+1] == '/')
+				{
+					for (i += 2; i < to; ++i)
+					{
+						if (s[i] < ' ') break;
+					}
+					continue;
+				}
+				else
+				{
+					out.Expand() = ch;
+
+					if (ch == '{')
+					{
+						++brackets;
+					}
+					else if (ch == '}')
+					{
+						if (--brackets < 1)
+						{
+							from = i + 1;
+							while (from < to && s[from] < 33) ++from;
+							return true;
+						}
+					}
+				}
+				++i;
+			}
+		}
+		return false;
+	}
+
+	//--------------------------------------------------------------------------------------------------------
+
+	bool ParseProperties (TreeNode& node, const String& s, uint& from, uint to)
+	{
+		if (from < to)
+		{
+			String temp;
+
+			if (s[from] == '=')
+			{
+				uint wordStart = ++from;
+
+				if (s.GetWord(temp, wordStart, to))
+				{
+					if (temp.EndsWith("[]"))
+					{
+						if (GetSegment(s, from, to, temp))
+						{
+							if (!node.mValue.SerializeFrom(temp)) return false;
+						}
+					}
+					else if (GetPhrase(s, from, to, temp))
+					{
+						if (!node.mValue.SerializeFrom(temp)) return false;
+					}
+				}
+			}
+
+			if (from < to && s[from] == '{')
+			{
+				uint closingBracket = from++, counter = 1;
+
+				while (counter)
+				{
+					if (++closingBracket < to)
+					{
+						if		(s[closingBracket] == '}')  --counter;
+						else if (s[closingBracket] == '{')  ++counter;
+					}
+					else return false;
+				}
+
+				while (from < closingBracket)
+				{
+					if (!GetPhrase(s, from, to, temp)) break;
+
+					TreeNode& child = node.mChildren.Expand();
+					child.mTag = temp;
+
+					if (!ParseProperties(child, s, from, closingBracket))
+					{
+						node.mChildren.Shrink();
+						break;
+					}
+				}
+				from = closingBracket + 1;
+			}
+		}
+		return true;
+	}
+
+	//--------------------------------------------------------------------------------------------------------
+
+	bool Load (TreeNode& root, const byte* buffer, uint size)
+	{
+		if (size < 6 || buffer[0] != '/' || buffer[1] != '/' || buffer[2] != 'R' ||
+			buffer[3] != '5' || buffer[4] != 'A') return false;
+
+		size   -= 5;
+		buffer += 5;
+
+		String s;
+		memcpy(s.Resize(size), buffer, size);
+		s[size] = 0;
+
+		root.Release();
+		uint from = 0, to = s.GetLength();
+		return GetPhrase(s, from, to, root.mTag) && ParseProperties(root, s, from, to);
+	}
+};
+
+//============================================================================================================
+// Generates a tree resembling exported models: meshes with their arrays, materials, and a skeleton
+//============================================================================================================
+
+void GenerateTree (TreeNode& root, uint meshes, uint vertices)
+{
+	// References to children are only valid until the next child is added, so nodes are filled in last
+	Random random (12345);
+	root.AddChild("Graphics");
+	root.AddChild("Core");
+	root.mChildren[1].AddChild("Skeleton", "Generated");
+
+	TreeNode& graphics	= root.mChildren[0];
+	TreeNode& core		= root.mChildren[1];
+
+	for (uint i = 0; i < meshes; ++i)
+	{
+		TreeNode& mat = graphics.AddChild("Material", String("Material %u", i));
+		mat.AddChild("Color", Color4f(random.GenerateFloat(), random.GenerateFloat(), random.GenerateFloat(), 1.0f));
+		mat.AddChild("Specularity", random.GenerateFloat());
+		mat.AddChild("Shininess", random.GenerateFloat());
+		mat.AddChild("Technique", "Opaque").AddChild("Shader", "Surface/Simple");
+		mat.AddChild("Technique", "Deferred").AddChild("Shader", "Surface/Simple");
+
+		TreeNode& mesh = core.AddChild("Mesh", String("Mesh %u", i));
+		mesh.AddChild("Vertices");
+		mesh.AddChild("Normals");
+		mesh.AddChild("TexCoords 0");
+		mesh.AddChild("Triangles");
+
+		Array<Vector3f>& v	= mesh.mChildren[0].mValue.ToVector3fArray();
+		Array<Vector3f>& n	= mesh.mChildren[1].mValue.ToVector3fArray();
+		Array<Vector2f>& tc	= mesh.mChildren[2].mValue.ToVector2fArray();
+		Array<ushort>& ind	= mesh.mChildren[3].mValue.ToUShortArray();
+
+		for (uint b = 0; b < vertices; ++b)
+		{
+			Vector3f normal (random.GenerateRangeFloat(), random.GenerateRangeFloat(), random.GenerateRangeFloat());
+			normal.Normalize();
+
+			v.Expand()	= Vector3f(random.GenerateRangeFloat(), random.GenerateRangeFloat(), random.GenerateRangeFloat()) * 10.0f;
+			n.Expand()	= normal;
+			tc.Expand()	= Vector2f(random.GenerateFloat(), random.GenerateFloat());
+		}
+
+		for (uint b = 0; b + 2 < vertices; ++b)
+		{
+			ind.Expand() = (ushort)b;
+			ind.Expand() = (ushort)(b + 1);
+			ind.Expand() = (ushort)(b + 2);
+		}
+	}
+
+	TreeNode& skeleton = core.mChildren[0];
+
+	for (uint i = 0; i < 64; ++i)
+	{
+		TreeNode& bone = skeleton.AddChild("Bone", String("Bone %u", i));
+		if (i > 0) bone.AddChild("Parent", String("Bone %u", i / 2));
+		bone.AddChild("Position", Vector3f(random.GenerateRangeFloat(), random.GenerateRangeFloat(), random.GenerateRangeFloat()));
+		bone.AddChild("Rotation", Quaternion(random.GenerateRangeFloat(), random.GenerateRangeFloat(),
+			random.GenerateRangeFloat(), random.GenerateRangeFloat()));
+
+	}
+
+	for (uint i = 0; i < 64; ++i)
+	{
+		TreeNode& anim = skeleton.AddChild("Animation", String("Animation %u", i));
+		anim.AddChild("Duration", Vector2i(0, 60));
+		anim.AddChild("Loop", true);
+	}
+}
+
+//============================================================================================================
+// Loads the buffer 'repeat' times, keeping the fastest run along with the allocations made by a single load
+//============================================================================================================
+
+struct Result
+{
+	double	mTime;
+	uint	mAllocations;
+	uint	mBytes;
+	bool	mSuccess;
+};
+
+Result Measure (const Memory& mem, uint repeat, bool reference, String& text)
+{
+	Result result;
+	result.mTime		= 0.0;
+	result.mAllocations	= 0;
+	result.mBytes		= 0;
+	result.mSuccess		= true;
+
+	for (uint r = 0; r < repeat; ++r)
+	{
+		TreeNode root;
+		uint allocations = g_allocations;
+		uint bytes = g_bytes;
+		double start = Time::GetSystemSeconds();
+
+		bool success = reference ? Reference::Load(root, mem.GetBuffer(), mem.GetSize()) : root.Load(mem);
+
+		double time = Time::GetSystemSeconds() - start;
+		if (r == 0 || time < result.mTime) result.mTime = time;
+		result.mAllocations	= g_allocations - allocations;
+		result.mBytes		= g_bytes - bytes;
+		result.mSuccess		= result.mSuccess && success;
+
+		if (r == 0)
+		{
+			text.Clear();
+			root.SerializeTo(text);
+		}
+	}
+	return result;
+}
+
+//============================================================================================================
+// Prints a single line of the report
+//============================================================================================================
+
+void Report (const char* name, const Result& result, const Result& reference)
+{
+	printf("  %-12s %9.3f ms %7.2fx %12u %12s%s\n", name, result.mTime * 1000.0,
+		(result.mTime > 0.0) ? reference.mTime / result.mTime : 0.0, result.mAllocations,
+		String::GetFormattedSize(result.mBytes).GetBuffer(), result.mSuccess ? "" : " (failed)");
+}
+
+//============================================================================================================
+// Application entry point
+//============================================================================================================
+
+int main (int argc, char* argv[])
+{
+	String	file;
+	String	save;
+	uint	meshes		= 100;
+	uint	vertices	= 2000;
+	uint	repeat		= 5;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		String arg (argv[i]);
+
+		if		(arg == "-meshes" && i + 1 < argc)		meshes = atoi(argv[++i]);
+		else if (arg == "-vertices" && i + 1 < argc)	vertices = atoi(argv[++i]);
+		else if (arg == "-repeat" && i + 1 < argc)		repeat = atoi(argv[++i]);
+		else if (arg == "-save" && i + 1 < argc)		save = argv[++i];
+		else if (arg.BeginsWith("-"))					{ repeat = 0; break; }
+		else											file = arg;
+	}
+
+	if (repeat == 0 || vertices > 65536)
+	{
+		printf("Usage: TreeBench [-meshes N] [-vertices N] [-repeat N] [-save <generated file>] [R5A file]\n");
+		return 0;
+	}
+
+	Memory mem;
+
+	if (file.IsValid())
+	{
+		if (!mem.Load(file))
+		{
+			printf("ERROR: Unable to load '%s'\n", file.GetBuffer());
+			return 1;
+		}
+		printf("Loaded '%s'\n", file.GetBuffer());
+	}
+	else
+	{
+		TreeNode root;
+		GenerateTree(root, meshes, vertices);
+
+		String s ("//R5A\n\n");
+		root.SerializeTo(s);
+		mem.Append(s.GetBuffer(), s.GetLength());
+		if (save.IsValid()) s.Save(save);
+		printf("Generated %u meshes with %u vertices each\n", meshes, vertices);
+	}
+
+	printf("%s of text, best of %u runs\n\n", String::GetFormattedSize(mem.GetSize()).GetBuffer(), repeat);
+	printf("  %-12s %12s %8s %12s %12s\n", "Parser", "Time", "Speedup", "Allocations", "Allocated");
+
+	String before, after;
+	Result reference	= Measure(mem, repeat, true, before);
+	Result current		= Measure(mem, repeat, false, after);
+
+	Report("Reference", reference, reference);
+	Report("TreeParser", current, reference);
+
+	printf("\nSaved trees %s\n", (before == after) ? "match" : "DIFFER");
+	return (before == after) ? 0 : 1;
+}